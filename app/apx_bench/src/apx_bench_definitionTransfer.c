@@ -0,0 +1,200 @@
+/*****************************************************************************
+* \file      apx_bench_definitionTransfer.c
+* \author    Conny Gustafsson
+* \date      2026-10-18
+* \brief     Benchmark of definition file compression and its effect on connect time
+*
+* Copyright (c) 2026 Conny Gustafsson
+* Permission is hereby granted, free of charge, to any person obtaining a copy of
+* this software and associated documentation files (the "Software"), to deal in
+* the Software without restriction, including without limitation the rights to
+* use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+* the Software, and to permit persons to whom the Software is furnished to do so,
+* subject to the following conditions:
+
+* The above copyright notice and this permission notice shall be included in all
+* copies or substantial portions of the Software.
+
+* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+* IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+* FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+* COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+* IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+* CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+*
+******************************************************************************/
+//////////////////////////////////////////////////////////////////////////////
+// INCLUDES
+//////////////////////////////////////////////////////////////////////////////
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "apx_bench.h"
+#include "apx_cfg.h"
+#include "apx_lz.h"
+#include "apx_fileManagerReceiver.h"
+#ifdef MEM_LEAK_CHECK
+#include "CMemLeak.h"
+#endif
+
+//////////////////////////////////////////////////////////////////////////////
+// PRIVATE CONSTANTS AND DATA TYPES
+//////////////////////////////////////////////////////////////////////////////
+#define NUM_DEFINITION_SIZES 6u
+#define NUM_RUNS 20u
+#define DEFINITION_START_ADDRESS 0x4000000u
+#if (APX_WORKER_FRAGMENT_SIZE > 0)
+# define FRAGMENT_SIZE APX_WORKER_FRAGMENT_SIZE
+#else
+# define FRAGMENT_SIZE 8192
+#endif
+
+//////////////////////////////////////////////////////////////////////////////
+// PRIVATE FUNCTION PROTOTYPES
+//////////////////////////////////////////////////////////////////////////////
+static apx_size_t generate_definition(char *buf, apx_size_t bufSize);
+static int run_definitionTransfer(apx_size_t definitionSize);
+static double transfer_time_ms(apx_size_t numBytes, uint32_t megabitPerSecond);
+
+//////////////////////////////////////////////////////////////////////////////
+// PUBLIC FUNCTIONS
+//////////////////////////////////////////////////////////////////////////////
+/**
+ * Compresses generated definition files of increasing size, decodes them fragment by fragment through
+ * apx_fileManagerReceiver (as the server does) and estimates the time the transfer adds to node connect
+ * on 10 and 100 Mbit/s links.
+ */
+int apx_bench_definitionTransfer(void)
+{
+   static const apx_size_t definitionSizes[NUM_DEFINITION_SIZES] = {1024u, 4096u, 16384u, 65536u, 262144u, 1048576u};
+   uint32_t i;
+   printf("%-10s %-10s %-7s %-12s %-12s %-20s %-20s\n", "size", "compressed", "ratio", "compress(us)", "decode(us)",
+      "10Mbit/s raw/lz(ms)", "100Mbit/s raw/lz(ms)");
+   for (i = 0u; i < NUM_DEFINITION_SIZES; i++)
+   {
+      if (run_definitionTransfer(definitionSizes[i]) != 0)
+      {
+         return 1;
+      }
+   }
+   return 0;
+}
+
+//////////////////////////////////////////////////////////////////////////////
+// PRIVATE FUNCTIONS
+//////////////////////////////////////////////////////////////////////////////
+/**
+ * Generates APX text resembling a large ECU node: a handful of type declarations followed by many ports
+ */
+static apx_size_t generate_definition(char *buf, apx_size_t bufSize)
+{
+   static const char *portTypes[4] = {"C(0,3):=3", "S:=65535", "T[0]:=3", "a[16]:=\"\""};
+   static const char *portPrefixes[3] = {"Vehicle", "Body", "Chassis"};
+   apx_size_t len;
+   uint32_t portId = 0u;
+   len = (apx_size_t) sprintf(buf, "APX/1.2\nN\"BenchNode\"\nT\"OnOff_T\"C(0,3)\nT\"VehicleSpeed_T\"S\n");
+   while (len < bufSize)
+   {
+      char line[128];
+      apx_size_t lineLen = (apx_size_t) sprintf(line, "%c\"%sSignal%u\"%s\n", (portId & 1u)? 'R' : 'P',
+         portPrefixes[portId % 3u], (unsigned int) portId, portTypes[portId % 4u]);
+      if (len + lineLen > bufSize)
+      {
+         lineLen = bufSize - len;
+      }
+      memcpy(&buf[len], line, lineLen);
+      len += lineLen;
+      portId++;
+   }
+   return len;
+}
+
+static int run_definitionTransfer(apx_size_t definitionSize)
+{
+   apx_fileManagerReceiver_t receiver;
+   apx_fileManagerReception_t reception;
+   uint8_t *definition;
+   uint8_t *compressed;
+   apx_size_t compressedLen = 0u;
+   apx_size_t compressedCapacity = apx_lz_compressBound(definitionSize);
+   uint64_t t0;
+   uint64_t compressNs;
+   uint64_t decodeNs;
+   uint32_t run;
+   int retval = 0;
+
+   definition = (uint8_t*) malloc(definitionSize);
+   compressed = (uint8_t*) malloc(compressedCapacity);
+   if ( (definition == 0) || (compressed == 0) )
+   {
+      free(definition);
+      free(compressed);
+      return 1;
+   }
+   generate_definition((char*) definition, definitionSize);
+
+   t0 = apx_bench_timestampNs();
+   for (run = 0u; run < NUM_RUNS; run++)
+   {
+      if (apx_lz_compress(definition, definitionSize, compressed, compressedCapacity, &compressedLen) != APX_NO_ERROR)
+      {
+         retval = 1;
+         break;
+      }
+   }
+   compressNs = (apx_bench_timestampNs() - t0) / NUM_RUNS;
+
+   apx_fileManagerReceiver_create(&receiver);
+   t0 = apx_bench_timestampNs();
+   for (run = 0u; (run < NUM_RUNS) && (retval == 0); run++)
+   {
+      apx_size_t offset = 0u;
+      apx_fileManagerReceiver_startDecompression(&receiver, definitionSize);
+      while (offset < compressedLen)
+      {
+         apx_size_t fragmentLen = compressedLen - offset;
+         bool moreBit = false;
+         if (fragmentLen > FRAGMENT_SIZE)
+         {
+            fragmentLen = FRAGMENT_SIZE;
+            moreBit = true;
+         }
+         if (apx_fileManagerReceiver_write(&receiver, DEFINITION_START_ADDRESS + offset, &compressed[offset], fragmentLen, moreBit) != APX_NO_ERROR)
+         {
+            retval = 1;
+            break;
+         }
+         offset += fragmentLen;
+      }
+      if ( (retval == 0) && (apx_fileManagerReceiver_checkComplete(&receiver, &reception) != APX_NO_ERROR) )
+      {
+         retval = 1;
+      }
+   }
+   decodeNs = (apx_bench_timestampNs() - t0) / NUM_RUNS;
+   if ( (retval == 0) && ( (reception.msgSize != definitionSize) || (memcmp(reception.msgBuf, definition, definitionSize) != 0) ) )
+   {
+      printf("Decompressed definition does not match original\n");
+      retval = 1;
+   }
+   apx_fileManagerReceiver_destroy(&receiver);
+
+   if (retval == 0)
+   {
+      printf("%-10u %-10u %-7.2f %-12.1f %-12.1f %8.2f / %-9.2f %8.2f / %-9.2f\n", (unsigned int) definitionSize, (unsigned int) compressedLen,
+         (double) definitionSize / (double) compressedLen, compressNs / 1000.0, decodeNs / 1000.0,
+         transfer_time_ms(definitionSize, 10u), transfer_time_ms(compressedLen, 10u) + (compressNs + decodeNs) / 1000000.0,
+         transfer_time_ms(definitionSize, 100u), transfer_time_ms(compressedLen, 100u) + (compressNs + decodeNs) / 1000000.0);
+   }
+   free(definition);
+   free(compressed);
+   return retval;
+}
+
+/**
+ * Wire time only, header overhead of the fragments is ignored
+ */
+static double transfer_time_ms(apx_size_t numBytes, uint32_t megabitPerSecond)
+{
+   return ((double) numBytes * 8.0) / (megabitPerSecond * 1000.0);
+}
@@ -0,0 +1,198 @@
+/*****************************************************************************
+* \file      apx_bench_fileMap.c
+* \author    Conny Gustafsson
+* \date      2026-10-18
+* \brief     Benchmark of apx_fileMap address lookup and insertion
+*
+* Copyright (c) 2026 Conny Gustafsson
+* Permission is hereby granted, free of charge, to any person obtaining a copy of
+* this software and associated documentation files (the "Software"), to deal in
+* the Software without restriction, including without limitation the rights to
+* use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+* the Software, and to permit persons to whom the Software is furnished to do so,
+* subject to the following conditions:
+
+* The above copyright notice and this permission notice shall be included in all
+* copies or substantial portions of the Software.
+
+* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+* IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+* FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+* COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+* IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+* CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+*
+******************************************************************************/
+//////////////////////////////////////////////////////////////////////////////
+// INCLUDES
+//////////////////////////////////////////////////////////////////////////////
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "apx_bench.h"
+#include "apx_fileMap.h"
+#ifdef MEM_LEAK_CHECK
+#include "CMemLeak.h"
+#endif
+
+//////////////////////////////////////////////////////////////////////////////
+// PRIVATE CONSTANTS AND DATA TYPES
+//////////////////////////////////////////////////////////////////////////////
+#define NUM_NODES 200u
+#define NUM_FILES_PER_NODE 3u
+#define NUM_FILES (NUM_NODES * NUM_FILES_PER_NODE)
+#define NUM_LOOKUPS 2000000u
+#define NUM_INSERT_RUNS 100u
+#define FILE_NAME_SIZE 32
+
+//////////////////////////////////////////////////////////////////////////////
+// PRIVATE FUNCTION PROTOTYPES
+//////////////////////////////////////////////////////////////////////////////
+static int build_fileMap(apx_fileMap_t *fileMap, apx_file_t **files);
+static apx_file_t* legacy_findByAddress(apx_fileMap_t *self, apx_file_t **lastFile, uint32_t address);
+
+//////////////////////////////////////////////////////////////////////////////
+// PUBLIC FUNCTIONS
+//////////////////////////////////////////////////////////////////////////////
+int apx_bench_fileMap(void)
+{
+   apx_fileMap_t fileMap;
+   apx_file_t *files[NUM_FILES];
+   apx_file_t *lastFile = (apx_file_t*) 0;
+   uint32_t *addresses;
+   uint64_t t0;
+   uint32_t i;
+   uint32_t state = 12345u;
+   int retval = 0;
+
+   t0 = apx_bench_timestampNs();
+   for (i = 0u; i < NUM_INSERT_RUNS; i++)
+   {
+      if (build_fileMap(&fileMap, files) != 0)
+      {
+         printf("Failed to build file map\n");
+         return 1;
+      }
+      apx_fileMap_destroy(&fileMap);
+   }
+   apx_bench_report("apx_fileMap_insertFile (600 files)", i * NUM_FILES, apx_bench_timestampNs() - t0);
+
+   if (build_fileMap(&fileMap, files) != 0)
+   {
+      printf("Failed to build file map\n");
+      return 1;
+   }
+   //Writes interleaved across nodes: every lookup hits a random byte of a random file
+   addresses = (uint32_t*) malloc(NUM_LOOKUPS * sizeof(uint32_t));
+   if (addresses == 0)
+   {
+      apx_fileMap_destroy(&fileMap);
+      return 1;
+   }
+   for (i = 0u; i < NUM_LOOKUPS; i++)
+   {
+      apx_file_t *file;
+      state = state * 1664525u + 1013904223u;
+      file = files[(state >> 8) % NUM_FILES];
+      state = state * 1664525u + 1013904223u;
+      addresses[i] = file->fileInfo.addressWithoutFlags + (state >> 8) % file->fileInfo.length;
+   }
+   for (i = 0u; i < NUM_LOOKUPS; i++)
+   {
+      if (legacy_findByAddress(&fileMap, &lastFile, addresses[i]) != apx_fileMap_findByAddress(&fileMap, addresses[i]))
+      {
+         printf("Lookup results disagree at address %u\n", (unsigned int) addresses[i]);
+         retval = 1;
+         break;
+      }
+   }
+
+   t0 = apx_bench_timestampNs();
+   for (i = 0u; i < NUM_LOOKUPS; i++)
+   {
+      if (legacy_findByAddress(&fileMap, &lastFile, addresses[i]) == 0)
+      {
+         retval = 1;
+      }
+   }
+   apx_bench_report("legacy findByAddress (600 files)", i, apx_bench_timestampNs() - t0);
+
+   t0 = apx_bench_timestampNs();
+   for (i = 0u; i < NUM_LOOKUPS; i++)
+   {
+      if (apx_fileMap_findByAddress(&fileMap, addresses[i]) == 0)
+      {
+         retval = 1;
+      }
+   }
+   apx_bench_report("apx_fileMap_findByAddress (600 files)", i, apx_bench_timestampNs() - t0);
+
+   free(addresses);
+   apx_fileMap_destroy(&fileMap);
+   return retval;
+}
+
+//////////////////////////////////////////////////////////////////////////////
+// PRIVATE FUNCTIONS
+//////////////////////////////////////////////////////////////////////////////
+/**
+ * Creates one .out, .in and .apx file per node, inserted in node order which interleaves the address regions
+ */
+static int build_fileMap(apx_fileMap_t *fileMap, apx_file_t **files)
+{
+   static const char *extensions[NUM_FILES_PER_NODE] = {".out", ".in", ".apx"};
+   uint32_t node;
+   apx_fileMap_create(fileMap);
+   for (node = 0u; node < NUM_NODES; node++)
+   {
+      uint32_t j;
+      for (j = 0u; j < NUM_FILES_PER_NODE; j++)
+      {
+         char name[FILE_NAME_SIZE];
+         apx_fileInfo_t fileInfo;
+         apx_file_t *file;
+         sprintf(name, "Node%u%s", (unsigned int) node, extensions[j]);
+         if (apx_fileInfo_create(&fileInfo, RMF_INVALID_ADDRESS, 64u + (node % 16u) * 32u, name, RMF_FILE_TYPE_FIXED, RMF_DIGEST_TYPE_NONE, NULL) != APX_NO_ERROR)
+         {
+            return 1;
+         }
+         file = apx_file_new(&fileInfo);
+         apx_fileInfo_destroy(&fileInfo);
+         if ( (file == 0) || (apx_fileMap_insertFile(fileMap, file) != 0) )
+         {
+            return 1;
+         }
+         files[node * NUM_FILES_PER_NODE + j] = file;
+      }
+   }
+   return 0;
+}
+
+/**
+ * apx_fileMap_findByAddress as implemented before the address index: check last accessed file, then walk the list
+ */
+static apx_file_t* legacy_findByAddress(apx_fileMap_t *self, apx_file_t **lastFile, uint32_t address)
+{
+   adt_list_elem_t *pIter;
+   if (*lastFile != 0)
+   {
+      uint32_t startAddress = (*lastFile)->fileInfo.address & RMF_ADDRESS_MASK_INTERNAL;
+      if ( (address >= startAddress) && (address < startAddress + (*lastFile)->fileInfo.length) )
+      {
+         return *lastFile;
+      }
+   }
+   pIter = adt_list_iter_first(&self->fileList);
+   while(pIter != 0)
+   {
+      apx_file_t *pFile = (apx_file_t*) pIter->pItem;
+      uint32_t startAddress = pFile->fileInfo.address & RMF_ADDRESS_MASK_INTERNAL;
+      if ( (address >= startAddress) && (address < startAddress + pFile->fileInfo.length) )
+      {
+         *lastFile = pFile;
+         return pFile;
+      }
+      pIter = adt_list_iter_next(pIter);
+   }
+   return (apx_file_t*) 0;
+}
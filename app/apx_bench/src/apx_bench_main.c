@@ -0,0 +1,82 @@
+/*****************************************************************************
+* \file      apx_bench_main.c
+* \author    Conny Gustafsson
+* \date      2026-10-18
+* \brief     apx_bench console application
+*
+* Copyright (c) 2026 Conny Gustafsson
+* Permission is hereby granted, free of charge, to any person obtaining a copy of
+* this software and associated documentation files (the "Software"), to deal in
+* the Software without restriction, including without limitation the rights to
+* use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+* the Software, and to permit persons to whom the Software is furnished to do so,
+* subject to the following conditions:
+
+* The above copyright notice and this permission notice shall be included in all
+* copies or substantial portions of the Software.
+
+* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+* IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+* FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+* COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+* IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+* CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+*
+******************************************************************************/
+//////////////////////////////////////////////////////////////////////////////
+// INCLUDES
+//////////////////////////////////////////////////////////////////////////////
+#include <stdio.h>
+#include <string.h>
+#include "apx_bench.h"
+#ifdef MEM_LEAK_CHECK
+#include "CMemLeak.h"
+#endif
+
+//////////////////////////////////////////////////////////////////////////////
+// PRIVATE CONSTANTS AND DATA TYPES
+//////////////////////////////////////////////////////////////////////////////
+#define APP_NAME "apx_bench"
+
+typedef struct apx_bench_entry_tag
+{
+   const char *name;
+   apx_bench_func_t *func;
+} apx_bench_entry_t;
+
+//////////////////////////////////////////////////////////////////////////////
+// PRIVATE VARIABLES
+//////////////////////////////////////////////////////////////////////////////
+static const apx_bench_entry_t m_benchmarks[] =
+{
+   {"vm", apx_bench_vm},
+   {"queue", apx_bench_queue},
+   {"portMap", apx_bench_portMap},
+   {"fileMap", apx_bench_fileMap},
+   {"queuedPort", apx_bench_queuedPort},
+   {"definitionTransfer", apx_bench_definitionTransfer},
+};
+
+#define NUM_BENCHMARKS (sizeof(m_benchmarks) / sizeof(m_benchmarks[0]))
+
+//////////////////////////////////////////////////////////////////////////////
+// PUBLIC FUNCTIONS
+//////////////////////////////////////////////////////////////////////////////
+int main(int argc, char **argv)
+{
+   size_t i;
+   int retval = 0;
+   const char *selected = (argc > 1)? argv[1] : (const char*) 0;
+   for (i = 0; i < NUM_BENCHMARKS; i++)
+   {
+      if ( (selected == 0) || (strcmp(selected, m_benchmarks[i].name) == 0) )
+      {
+         printf("[%s] %s\n", APP_NAME, m_benchmarks[i].name);
+         if (m_benchmarks[i].func() != 0)
+         {
+            retval = 1;
+         }
+      }
+   }
+   return retval;
+}
@@ -0,0 +1,215 @@
+/*****************************************************************************
+* \file      apx_bench_portMap.c
+* \author    Conny Gustafsson
+* \date      2026-10-18
+* \brief     Benchmark of byte offset to port ID lookup
+*
+* Copyright (c) 2026 Conny Gustafsson
+* Permission is hereby granted, free of charge, to any person obtaining a copy of
+* this software and associated documentation files (the "Software"), to deal in
+* the Software without restriction, including without limitation the rights to
+* use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+* the Software, and to permit persons to whom the Software is furnished to do so,
+* subject to the following conditions:
+
+* The above copyright notice and this permission notice shall be included in all
+* copies or substantial portions of the Software.
+
+* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+* IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+* FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+* COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+* IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+* CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+*
+******************************************************************************/
+//////////////////////////////////////////////////////////////////////////////
+// INCLUDES
+//////////////////////////////////////////////////////////////////////////////
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "apx_bench.h"
+#include "apx_bytePortMap.h"
+#ifdef MEM_LEAK_CHECK
+#include "CMemLeak.h"
+#endif
+
+//////////////////////////////////////////////////////////////////////////////
+// PRIVATE CONSTANTS AND DATA TYPES
+//////////////////////////////////////////////////////////////////////////////
+#define NUM_LOOKUPS 4000000u
+#define MAX_PORT_DATA_SIZE 40u
+
+//Byte port map as implemented before the range index: one port ID for every byte of port data
+typedef struct legacyPortMap_tag
+{
+   apx_portId_t *mapData;
+   int32_t mapLen;
+} legacyPortMap_t;
+
+//////////////////////////////////////////////////////////////////////////////
+// PRIVATE FUNCTION PROTOTYPES
+//////////////////////////////////////////////////////////////////////////////
+static int run_portMap(apx_portCount_t numPorts);
+static apx_portDataProps_t* create_props(apx_portCount_t numPorts, int32_t *totalLen);
+static int legacyPortMap_create(legacyPortMap_t *self, const apx_portDataProps_t *props, apx_portCount_t numPorts, int32_t totalLen);
+static apx_portId_t legacyPortMap_lookup(const legacyPortMap_t *self, int32_t offset);
+static int32_t* create_offsets(int32_t totalLen);
+
+//////////////////////////////////////////////////////////////////////////////
+// PRIVATE VARIABLES
+//////////////////////////////////////////////////////////////////////////////
+static const apx_portCount_t m_numPorts[3] = {10, 1000, 100000};
+
+//////////////////////////////////////////////////////////////////////////////
+// PUBLIC FUNCTIONS
+//////////////////////////////////////////////////////////////////////////////
+int apx_bench_portMap(void)
+{
+   size_t i;
+   for (i = 0u; i < (sizeof(m_numPorts) / sizeof(m_numPorts[0])); i++)
+   {
+      if (run_portMap(m_numPorts[i]) != 0)
+      {
+         return 1;
+      }
+   }
+   return 0;
+}
+
+//////////////////////////////////////////////////////////////////////////////
+// PRIVATE FUNCTIONS
+//////////////////////////////////////////////////////////////////////////////
+static int run_portMap(apx_portCount_t numPorts)
+{
+   char name[64];
+   int32_t totalLen = 0;
+   apx_portDataProps_t *props = create_props(numPorts, &totalLen);
+   int32_t *offsets = (props != 0)? create_offsets(totalLen) : (int32_t*) 0;
+   legacyPortMap_t legacyMap;
+   apx_bytePortMap_t rangeMap;
+   uint64_t t0;
+   uint32_t i;
+   apx_portId_t checksum = 0;
+   int retval = 0;
+
+   if ( (props == 0) || (offsets == 0) )
+   {
+      printf("Failed to prepare benchmark\n");
+      return 1;
+   }
+   if ( (legacyPortMap_create(&legacyMap, props, numPorts, totalLen) != 0) ||
+        (apx_bytePortMap_create(&rangeMap, props, numPorts) != APX_NO_ERROR) )
+   {
+      printf("Failed to create port maps\n");
+      return 1;
+   }
+   printf("%d ports, %d bytes of port data: legacy map %u bytes, range map %u bytes\n", (int) numPorts, (int) totalLen,
+         (unsigned int) (legacyMap.mapLen * sizeof(apx_portId_t)), (unsigned int) apx_bytePortMap_memoryUsage(&rangeMap));
+
+   for (i = 0u; i < NUM_LOOKUPS; i++)
+   {
+      if (legacyPortMap_lookup(&legacyMap, offsets[i]) != apx_bytePortMap_lookup(&rangeMap, offsets[i]))
+      {
+         printf("Port maps disagree at offset %d\n", (int) offsets[i]);
+         retval = 1;
+         break;
+      }
+   }
+
+   t0 = apx_bench_timestampNs();
+   for (i = 0u; i < NUM_LOOKUPS; i++)
+   {
+      checksum += legacyPortMap_lookup(&legacyMap, offsets[i]);
+   }
+   sprintf(name, "legacyPortMap_lookup (%d ports)", (int) numPorts);
+   apx_bench_report(name, i, apx_bench_timestampNs() - t0);
+
+   t0 = apx_bench_timestampNs();
+   for (i = 0u; i < NUM_LOOKUPS; i++)
+   {
+      checksum -= apx_bytePortMap_lookup(&rangeMap, offsets[i]);
+   }
+   sprintf(name, "apx_bytePortMap_lookup (%d ports)", (int) numPorts);
+   apx_bench_report(name, i, apx_bench_timestampNs() - t0);
+
+   if (checksum != 0)
+   {
+      retval = 1;
+   }
+   apx_bytePortMap_destroy(&rangeMap);
+   free(legacyMap.mapData);
+   free(offsets);
+   free(props);
+   return retval;
+}
+
+static apx_portDataProps_t* create_props(apx_portCount_t numPorts, int32_t *totalLen)
+{
+   apx_portDataProps_t *props = (apx_portDataProps_t*) malloc(numPorts * sizeof(apx_portDataProps_t));
+   if (props != 0)
+   {
+      apx_portId_t portId;
+      apx_offset_t offset = 0;
+      for (portId = 0; portId < numPorts; portId++)
+      {
+         apx_size_t dataSize = ((apx_size_t) portId * 7u) % MAX_PORT_DATA_SIZE + 1u;
+         apx_portDataProps_create(&props[portId], APX_PROVIDE_PORT, portId, offset, dataSize);
+         offset += (apx_offset_t) dataSize;
+      }
+      *totalLen = offset;
+   }
+   return props;
+}
+
+static int legacyPortMap_create(legacyPortMap_t *self, const apx_portDataProps_t *props, apx_portCount_t numPorts, int32_t totalLen)
+{
+   apx_portId_t portId;
+   apx_portId_t *pNext;
+   self->mapData = (apx_portId_t*) malloc(totalLen * sizeof(apx_portId_t));
+   if (self->mapData == 0)
+   {
+      return 1;
+   }
+   self->mapLen = totalLen;
+   pNext = self->mapData;
+   for (portId = 0; portId < numPorts; portId++)
+   {
+      apx_size_t j;
+      for (j = 0u; j < props[portId].dataSize; j++)
+      {
+         pNext[j] = portId;
+      }
+      pNext += props[portId].dataSize;
+   }
+   return 0;
+}
+
+static apx_portId_t legacyPortMap_lookup(const legacyPortMap_t *self, int32_t offset)
+{
+   if ( (offset >= 0) && (offset < self->mapLen) )
+   {
+      return self->mapData[offset];
+   }
+   return -1;
+}
+
+/**
+ * Pseudo-random lookup offsets, generated up front so the generator is not part of the measurement
+ */
+static int32_t* create_offsets(int32_t totalLen)
+{
+   int32_t *offsets = (int32_t*) malloc(NUM_LOOKUPS * sizeof(int32_t));
+   if (offsets != 0)
+   {
+      uint32_t i;
+      uint32_t state = 12345u;
+      for (i = 0u; i < NUM_LOOKUPS; i++)
+      {
+         state = state * 1664525u + 1013904223u;
+         offsets[i] = (int32_t) ((state >> 8) % (uint32_t) totalLen);
+      }
+   }
+   return offsets;
+}
@@ -0,0 +1,269 @@
+/*****************************************************************************
+* \file      apx_bench_queue.c
+* \author    Conny Gustafsson
+* \date      2026-10-18
+* \brief     Contention benchmark for the worker message queue
+*
+* Copyright (c) 2026 Conny Gustafsson
+* Permission is hereby granted, free of charge, to any person obtaining a copy of
+* this software and associated documentation files (the "Software"), to deal in
+* the Software without restriction, including without limitation the rights to
+* use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+* the Software, and to permit persons to whom the Software is furnished to do so,
+* subject to the following conditions:
+
+* The above copyright notice and this permission notice shall be included in all
+* copies or substantial portions of the Software.
+
+* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+* IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+* FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+* COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+* IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+* CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+*
+******************************************************************************/
+//////////////////////////////////////////////////////////////////////////////
+// INCLUDES
+//////////////////////////////////////////////////////////////////////////////
+#include <stdio.h>
+#include <string.h>
+#ifdef _WIN32
+# ifndef WIN32_LEAN_AND_MEAN
+# define WIN32_LEAN_AND_MEAN
+# endif
+# include <Windows.h>
+# include <process.h>
+#else
+# include <pthread.h>
+# include <semaphore.h>
+# include <unistd.h>
+#endif
+#include "apx_bench.h"
+#include "apx_cfg.h"
+#include "apx_msg.h"
+#include "apx_mpscQueue.h"
+#include "osmacro.h"
+#ifndef ADT_RBFH_ENABLE
+#define ADT_RBFH_ENABLE 1
+#endif
+#include "adt_ringbuf.h"
+#ifdef MEM_LEAK_CHECK
+#include "CMemLeak.h"
+#endif
+
+//////////////////////////////////////////////////////////////////////////////
+// PRIVATE CONSTANTS AND DATA TYPES
+//////////////////////////////////////////////////////////////////////////////
+#define NUM_MESSAGES_PER_RUN 400000u
+#define MAX_NUM_PRODUCERS 8u
+#define QUEUE_SIZE 1024u
+
+//Message queue as implemented before apx_mpscQueue: spinlock protected ring buffer, semaphore posted for every message
+typedef struct lockedQueue_tag
+{
+   SPINLOCK_T lock;
+   SEMAPHORE_T semaphore;
+   adt_rbfh_t messages;
+} lockedQueue_t;
+
+typedef struct producer_tag
+{
+   lockedQueue_t *lockedQueue; //set when benchmarking the old queue
+   apx_mpscQueue_t *mpscQueue; //set when benchmarking the new queue
+   uint32_t numMessages;
+   THREAD_T thread;
+#ifdef _WIN32
+   unsigned int threadId;
+#endif
+} producer_t;
+
+//////////////////////////////////////////////////////////////////////////////
+// PRIVATE FUNCTION PROTOTYPES
+//////////////////////////////////////////////////////////////////////////////
+static int run_lockedQueue(uint32_t numProducers);
+static int run_mpscQueue(uint32_t numProducers);
+static int start_producers(producer_t *producers, uint32_t numProducers);
+static void join_producers(producer_t *producers, uint32_t numProducers);
+static THREAD_PROTO(producerThread, arg);
+
+//////////////////////////////////////////////////////////////////////////////
+// PUBLIC FUNCTIONS
+//////////////////////////////////////////////////////////////////////////////
+int apx_bench_queue(void)
+{
+   uint32_t numProducers;
+   int retval = 0;
+   for (numProducers = 1u; numProducers <= MAX_NUM_PRODUCERS; numProducers *= 2u)
+   {
+      if ( (run_lockedQueue(numProducers) != 0) || (run_mpscQueue(numProducers) != 0) )
+      {
+         retval = 1;
+      }
+   }
+   return retval;
+}
+
+//////////////////////////////////////////////////////////////////////////////
+// PRIVATE FUNCTIONS
+//////////////////////////////////////////////////////////////////////////////
+static int run_lockedQueue(uint32_t numProducers)
+{
+   lockedQueue_t queue;
+   producer_t producers[MAX_NUM_PRODUCERS];
+   uint32_t numMessages = (NUM_MESSAGES_PER_RUN / numProducers) * numProducers;
+   uint32_t numReceived = 0u;
+   uint64_t t0;
+   char name[64];
+   uint32_t i;
+
+   if (adt_rbfh_create(&queue.messages, (uint8_t) RMF_MSG_SIZE) != BUF_E_OK)
+   {
+      printf("Failed to create ring buffer\n");
+      return 1;
+   }
+   SPINLOCK_INIT(queue.lock);
+   SEMAPHORE_CREATE(queue.semaphore);
+   for (i = 0u; i < numProducers; i++)
+   {
+      producers[i].lockedQueue = &queue;
+      producers[i].mpscQueue = (apx_mpscQueue_t*) 0;
+      producers[i].numMessages = numMessages / numProducers;
+   }
+   t0 = apx_bench_timestampNs();
+   if (start_producers(producers, numProducers) != 0)
+   {
+      return 1;
+   }
+   while (numReceived < numMessages)
+   {
+      apx_msg_t msg;
+#ifdef _MSC_VER
+      if (WaitForSingleObject(queue.semaphore, INFINITE) == WAIT_OBJECT_0)
+#else
+      if (sem_wait(&queue.semaphore) == 0)
+#endif
+      {
+         SPINLOCK_ENTER(queue.lock);
+         adt_rbfh_remove(&queue.messages, (uint8_t*) &msg);
+         SPINLOCK_LEAVE(queue.lock);
+         numReceived++;
+      }
+   }
+   join_producers(producers, numProducers);
+   sprintf(name, "queue_spinlockRingbuf (%u producers)", (unsigned int) numProducers);
+   apx_bench_report(name, numReceived, apx_bench_timestampNs() - t0);
+   SPINLOCK_DESTROY(queue.lock);
+   SEMAPHORE_DESTROY(queue.semaphore);
+   adt_rbfh_destroy(&queue.messages);
+   return 0;
+}
+
+static int run_mpscQueue(uint32_t numProducers)
+{
+   apx_mpscQueue_t queue;
+   producer_t producers[MAX_NUM_PRODUCERS];
+   uint32_t numMessages = (NUM_MESSAGES_PER_RUN / numProducers) * numProducers;
+   uint32_t numReceived = 0u;
+   uint64_t t0;
+   char name[64];
+   uint32_t i;
+
+   if (apx_mpscQueue_create(&queue, (uint32_t) RMF_MSG_SIZE, QUEUE_SIZE) != APX_NO_ERROR)
+   {
+      printf("Failed to create queue\n");
+      return 1;
+   }
+   for (i = 0u; i < numProducers; i++)
+   {
+      producers[i].lockedQueue = (lockedQueue_t*) 0;
+      producers[i].mpscQueue = &queue;
+      producers[i].numMessages = numMessages / numProducers;
+   }
+   t0 = apx_bench_timestampNs();
+   if (start_producers(producers, numProducers) != 0)
+   {
+      return 1;
+   }
+   while (numReceived < numMessages)
+   {
+      apx_msg_t msg;
+      if (apx_mpscQueue_pop(&queue, &msg))
+      {
+         numReceived++;
+      }
+      else
+      {
+         apx_mpscQueue_wait(&queue, APX_MPSC_QUEUE_WAIT_INFINITE);
+      }
+   }
+   join_producers(producers, numProducers);
+   sprintf(name, "queue_mpscQueue (%u producers)", (unsigned int) numProducers);
+   apx_bench_report(name, numReceived, apx_bench_timestampNs() - t0);
+   printf("%-40s %10u wakeups\n", "", (unsigned int) apx_mpscQueue_getNumWakeups(&queue));
+   apx_mpscQueue_destroy(&queue);
+   return 0;
+}
+
+static int start_producers(producer_t *producers, uint32_t numProducers)
+{
+   uint32_t i;
+   for (i = 0u; i < numProducers; i++)
+   {
+#ifdef _MSC_VER
+      THREAD_CREATE(producers[i].thread, producerThread, &producers[i], producers[i].threadId);
+      if (producers[i].thread == INVALID_HANDLE_VALUE)
+#else
+      if (THREAD_CREATE(producers[i].thread, producerThread, &producers[i]) != 0)
+#endif
+      {
+         printf("Failed to start producer thread\n");
+         return 1;
+      }
+   }
+   return 0;
+}
+
+static void join_producers(producer_t *producers, uint32_t numProducers)
+{
+   uint32_t i;
+   for (i = 0u; i < numProducers; i++)
+   {
+#ifdef _MSC_VER
+      WaitForSingleObject(producers[i].thread, INFINITE);
+      CloseHandle(producers[i].thread);
+#else
+      void *status;
+      pthread_join(producers[i].thread, &status);
+#endif
+   }
+}
+
+static THREAD_PROTO(producerThread, arg)
+{
+   producer_t *self = (producer_t*) arg;
+   if (self != 0)
+   {
+      uint32_t i;
+      apx_msg_t msg = {APX_MSG_SEND_FILE_DYN_DATA, 0, 0, {0}, 0};
+      for (i = 0u; i < self->numMessages; i++)
+      {
+         msg.msgData1 = i;
+         if (self->lockedQueue != 0)
+         {
+            SPINLOCK_ENTER(self->lockedQueue->lock);
+            adt_rbfh_insert(&self->lockedQueue->messages, (const uint8_t*) &msg);
+            SPINLOCK_LEAVE(self->lockedQueue->lock);
+            SEMAPHORE_POST(self->lockedQueue->semaphore);
+         }
+         else
+         {
+            while (apx_mpscQueue_push(self->mpscQueue, &msg) == APX_BUFFER_FULL_ERROR)
+            {
+               SLEEP(0);
+            }
+         }
+      }
+   }
+   THREAD_RETURN(0);
+}
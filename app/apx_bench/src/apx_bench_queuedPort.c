@@ -0,0 +1,233 @@
+/*****************************************************************************
+* \file      apx_bench_queuedPort.c
+* \author    Conny Gustafsson
+* \date      2026-10-18
+* \brief     Throughput benchmark for queued port transfers
+*
+* Copyright (c) 2026 Conny Gustafsson
+* Permission is hereby granted, free of charge, to any person obtaining a copy of
+* this software and associated documentation files (the "Software"), to deal in
+* the Software without restriction, including without limitation the rights to
+* use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+* the Software, and to permit persons to whom the Software is furnished to do so,
+* subject to the following conditions:
+
+* The above copyright notice and this permission notice shall be included in all
+* copies or substantial portions of the Software.
+
+* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+* IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+* FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+* COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+* IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+* CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+*
+******************************************************************************/
+//////////////////////////////////////////////////////////////////////////////
+// INCLUDES
+//////////////////////////////////////////////////////////////////////////////
+#include <assert.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#ifdef _WIN32
+# ifndef WIN32_LEAN_AND_MEAN
+# define WIN32_LEAN_AND_MEAN
+# endif
+# include <Windows.h>
+# include <process.h>
+#else
+# include <pthread.h>
+# include <unistd.h>
+#endif
+#include "apx_bench.h"
+#include "apx_cfg.h"
+#include "apx_atomic.h"
+#include "apx_portDataProps.h"
+#include "apx_portQueue.h"
+#include "osmacro.h"
+#include "pack.h"
+#ifdef MEM_LEAK_CHECK
+#include "CMemLeak.h"
+#endif
+
+//////////////////////////////////////////////////////////////////////////////
+// PRIVATE CONSTANTS AND DATA TYPES
+//////////////////////////////////////////////////////////////////////////////
+#define NUM_EVENTS_PER_RUN 200000u
+#define PACED_EVENTS_PER_SECOND 100000u
+#define ELEMENT_SIZE 16u //CAN frame: 4 byte id, 1 byte dlc, 8 byte data, padding
+#define MAX_QUE_LEN 32u
+
+//The producer plays the role of the application thread calling apx_client_writePortData,
+//the main thread plays the role of the file manager worker packing transfers.
+typedef struct producer_tag
+{
+   apx_portQueue_t *queue;
+   uint32_t numEvents;
+   uint32_t eventsPerSecond; //0 means unthrottled
+   volatile uint32_t isDone;
+   THREAD_T thread;
+#ifdef _WIN32
+   unsigned int threadId;
+#endif
+} producer_t;
+
+//////////////////////////////////////////////////////////////////////////////
+// PRIVATE FUNCTION PROTOTYPES
+//////////////////////////////////////////////////////////////////////////////
+static int run_queuedPort(uint32_t eventsPerSecond);
+static THREAD_PROTO(producerThread, arg);
+
+//////////////////////////////////////////////////////////////////////////////
+// PUBLIC FUNCTIONS
+//////////////////////////////////////////////////////////////////////////////
+int apx_bench_queuedPort(void)
+{
+   int retval = 0;
+   if ( (run_queuedPort(PACED_EVENTS_PER_SECOND) != 0) || (run_queuedPort(0u) != 0) )
+   {
+      retval = 1;
+   }
+   return retval;
+}
+
+//////////////////////////////////////////////////////////////////////////////
+// PRIVATE FUNCTIONS
+//////////////////////////////////////////////////////////////////////////////
+static int run_queuedPort(uint32_t eventsPerSecond)
+{
+   apx_portDataProps_t props;
+   apx_portQueue_t queue;
+   producer_t producer;
+   uint8_t *transferBuffer;
+   apx_size_t maxTransferSize;
+   uint32_t numReceived = 0u;
+   uint32_t numTransfers = 0u;
+   uint64_t elapsedNs;
+   uint64_t t0;
+   char name[64];
+
+   apx_portDataProps_create(&props, APX_PROVIDE_PORT, 0, 0u, ELEMENT_SIZE);
+   apx_portDataProps_setQueued(&props, MAX_QUE_LEN);
+   if (apx_portQueue_create(&queue, &props, APX_PORT_QUEUE_DEPTH_FACTOR) != APX_NO_ERROR)
+   {
+      printf("Failed to create port queue\n");
+      return 1;
+   }
+   maxTransferSize = props.dataSize;
+   transferBuffer = (uint8_t*) malloc(maxTransferSize);
+   if (transferBuffer == 0)
+   {
+      apx_portQueue_destroy(&queue);
+      return 1;
+   }
+   producer.queue = &queue;
+   producer.numEvents = NUM_EVENTS_PER_RUN;
+   producer.eventsPerSecond = eventsPerSecond;
+   producer.isDone = 0u;
+   t0 = apx_bench_timestampNs();
+#ifdef _MSC_VER
+   THREAD_CREATE(producer.thread, producerThread, &producer, producer.threadId);
+   if (producer.thread == INVALID_HANDLE_VALUE)
+#else
+   if (THREAD_CREATE(producer.thread, producerThread, &producer) != 0)
+#endif
+   {
+      printf("Failed to start producer thread\n");
+      free(transferBuffer);
+      apx_portQueue_destroy(&queue);
+      return 1;
+   }
+   for (;;)
+   {
+      if (apx_atomic_load32(&queue.isTransferPending) != 0u)
+      {
+         //Same sequence as the begin transfer and read data handlers in apx_nodeInstance
+         apx_size_t transferSize;
+         apx_portQueue_completeTransfer(&queue);
+         transferSize = apx_portQueue_getTransferSize(&queue);
+         if (transferSize > 0u)
+         {
+            apx_size_t packedSize = apx_portQueue_packTransfer(&queue, transferBuffer, maxTransferSize);
+            assert(packedSize == transferSize);
+            numReceived += (uint32_t) unpackLE(transferBuffer, (uint8_t) apx_portDataProps_getQueLenSize(&props));
+            numTransfers++;
+            if (apx_portQueue_length(&queue) > 0u)
+            {
+               (void) apx_portQueue_requestTransfer(&queue);
+            }
+         }
+      }
+      else if (apx_atomic_load32(&producer.isDone) != 0u)
+      {
+         if (apx_atomic_load32(&queue.isTransferPending) == 0u)
+         {
+            break;
+         }
+      }
+      else
+      {
+         SLEEP(0);
+      }
+   }
+   elapsedNs = apx_bench_timestampNs() - t0;
+#ifdef _MSC_VER
+   WaitForSingleObject(producer.thread, INFINITE);
+   CloseHandle(producer.thread);
+#else
+   {
+      void *status;
+      pthread_join(producer.thread, &status);
+   }
+#endif
+   if (eventsPerSecond > 0u)
+   {
+      sprintf(name, "queuedPort (%u events/s)", (unsigned int) eventsPerSecond);
+   }
+   else
+   {
+      sprintf(name, "queuedPort (unthrottled)");
+   }
+   apx_bench_report(name, numReceived, elapsedNs);
+   printf("%-40s %10.0f events/s %8u transfers %6.2f elements/transfer %8u dropped\n", "",
+      (elapsedNs > 0u)? ((double) numReceived * 1000000000.0) / (double) elapsedNs : 0.0,
+      (unsigned int) numTransfers,
+      (numTransfers > 0u)? (double) numReceived / (double) numTransfers : 0.0,
+      (unsigned int) apx_portQueue_getNumDroppedElements(&queue));
+   free(transferBuffer);
+   apx_portQueue_destroy(&queue);
+   return 0;
+}
+
+static THREAD_PROTO(producerThread, arg)
+{
+   producer_t *self = (producer_t*) arg;
+   if (self != 0)
+   {
+      uint32_t i;
+      uint8_t element[ELEMENT_SIZE];
+      uint64_t t0 = apx_bench_timestampNs();
+      uint64_t periodNs = (self->eventsPerSecond > 0u)? (1000000000u / self->eventsPerSecond) : 0u;
+      memset(&element[0], 0, sizeof(element));
+      for (i = 0u; i < self->numEvents; i++)
+      {
+         if (periodNs > 0u)
+         {
+            uint64_t deadline = t0 + periodNs * i;
+            while (apx_bench_timestampNs() < deadline)
+            {
+               //busy-wait, sleeping has too coarse granularity for 10us periods
+            }
+         }
+         packLE(&element[0], i, UINT32_SIZE);
+         //Same sequence as apx_nodeInstance_writeQueuedProvidePortData, overflow is counted by the queue
+         if (apx_portQueue_push(self->queue, &element[0]) == APX_NO_ERROR)
+         {
+            (void) apx_portQueue_requestTransfer(self->queue);
+         }
+      }
+      apx_atomic_store32(&self->isDone, 1u);
+   }
+   THREAD_RETURN(0);
+}
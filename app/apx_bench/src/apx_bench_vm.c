@@ -0,0 +1,252 @@
+/*****************************************************************************
+* \file      apx_bench_vm.c
+* \author    Conny Gustafsson
+* \date      2026-10-18
+* \brief     Compares dtl-based and native-struct execution of APX VM programs
+*
+* Copyright (c) 2026 Conny Gustafsson
+* Permission is hereby granted, free of charge, to any person obtaining a copy of
+* this software and associated documentation files (the "Software"), to deal in
+* the Software without restriction, including without limitation the rights to
+* use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+* the Software, and to permit persons to whom the Software is furnished to do so,
+* subject to the following conditions:
+
+* The above copyright notice and this permission notice shall be included in all
+* copies or substantial portions of the Software.
+
+* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+* IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+* FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+* COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+* IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+* CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+*
+******************************************************************************/
+//////////////////////////////////////////////////////////////////////////////
+// INCLUDES
+//////////////////////////////////////////////////////////////////////////////
+#include <stdio.h>
+#include <string.h>
+#include "apx_bench.h"
+#include "apx_compiler.h"
+#include "apx_vm.h"
+#ifdef MEM_LEAK_CHECK
+#include "CMemLeak.h"
+#endif
+
+//////////////////////////////////////////////////////////////////////////////
+// PRIVATE CONSTANTS AND DATA TYPES
+//////////////////////////////////////////////////////////////////////////////
+#define NUM_ITERATIONS 1000000u
+
+typedef struct bench_record_tag
+{
+   uint16_t vehicleSpeed;
+   uint8_t gear;
+   uint8_t status;
+   uint32_t odometer;
+   int16_t torque[4];
+} bench_record_t;
+
+#define BENCH_RECORD_DATA_SIZE (UINT16_SIZE + UINT8_SIZE + UINT8_SIZE + UINT32_SIZE + 4*UINT16_SIZE)
+
+//////////////////////////////////////////////////////////////////////////////
+// PRIVATE FUNCTION PROTOTYPES
+//////////////////////////////////////////////////////////////////////////////
+static apx_dataElement_t* create_bench_record(void);
+static adt_bytes_t* compile_program(apx_dataElement_t *element, bool isPack);
+static dtl_hv_t* create_bench_value(void);
+
+//////////////////////////////////////////////////////////////////////////////
+// PRIVATE VARIABLES
+//////////////////////////////////////////////////////////////////////////////
+static const apx_vmNativeElement_t m_bench_record_elements[5] =
+{
+   APX_VM_NATIVE_ELEMENT(bench_record_t, vehicleSpeed),
+   APX_VM_NATIVE_ELEMENT(bench_record_t, gear),
+   APX_VM_NATIVE_ELEMENT(bench_record_t, status),
+   APX_VM_NATIVE_ELEMENT(bench_record_t, odometer),
+   APX_VM_NATIVE_ELEMENT(bench_record_t, torque)
+};
+static const apx_vmNativeLayout_t m_bench_record_layout = {&m_bench_record_elements[0], 5u};
+
+//////////////////////////////////////////////////////////////////////////////
+// PUBLIC FUNCTIONS
+//////////////////////////////////////////////////////////////////////////////
+int apx_bench_vm(void)
+{
+   uint8_t dataBuffer[BENCH_RECORD_DATA_SIZE];
+   apx_dataElement_t *element = create_bench_record();
+   adt_bytes_t *packProgram = compile_program(element, true);
+   adt_bytes_t *unpackProgram = compile_program(element, false);
+   dtl_hv_t *hv = create_bench_value();
+   apx_copyPlan_t *packPlan = (apx_copyPlan_t*) 0;
+   apx_copyPlan_t *unpackPlan = (apx_copyPlan_t*) 0;
+   bench_record_t nativeData = {1234u, 3u, 1u, 123456u, {-100, 100, -200, 200}};
+   apx_vm_t vm;
+   uint64_t t0;
+   uint32_t i;
+   apx_error_t rc = APX_NO_ERROR;
+
+   if ( (packProgram == 0) || (unpackProgram == 0) || (hv == 0) )
+   {
+      printf("Failed to prepare benchmark\n");
+      return 1;
+   }
+   if ( (apx_compiler_lowerToCopyPlan(packProgram, &packPlan) != APX_NO_ERROR) ||
+        (apx_compiler_lowerToCopyPlan(unpackProgram, &unpackPlan) != APX_NO_ERROR) )
+   {
+      printf("Failed to lower programs into copy plans\n");
+      return 1;
+   }
+   apx_vm_create(&vm);
+
+   apx_vm_selectProgram(&vm, packProgram);
+   t0 = apx_bench_timestampNs();
+   for (i = 0u; (i < NUM_ITERATIONS) && (rc == APX_NO_ERROR); i++)
+   {
+      rc = apx_vm_setWriteBuffer(&vm, dataBuffer, (uint32_t) sizeof(dataBuffer));
+      if (rc == APX_NO_ERROR)
+      {
+         rc = apx_vm_packValue(&vm, (dtl_dv_t*) hv);
+      }
+   }
+   apx_bench_report("vm_packValue (dtl)", i, apx_bench_timestampNs() - t0);
+
+   t0 = apx_bench_timestampNs();
+   for (i = 0u; (i < NUM_ITERATIONS) && (rc == APX_NO_ERROR); i++)
+   {
+      rc = apx_vm_packNative(&vm, dataBuffer, (apx_size_t) sizeof(dataBuffer), &nativeData, &m_bench_record_layout);
+   }
+   apx_bench_report("vm_packNative", i, apx_bench_timestampNs() - t0);
+
+   t0 = apx_bench_timestampNs();
+   for (i = 0u; (i < NUM_ITERATIONS) && (rc == APX_NO_ERROR); i++)
+   {
+      rc = apx_vm_packCopyPlan(packPlan, dataBuffer, (apx_size_t) sizeof(dataBuffer), &nativeData, &m_bench_record_layout);
+   }
+   apx_bench_report("vm_packCopyPlan", i, apx_bench_timestampNs() - t0);
+
+   apx_vm_selectProgram(&vm, unpackProgram);
+   t0 = apx_bench_timestampNs();
+   for (i = 0u; (i < NUM_ITERATIONS) && (rc == APX_NO_ERROR); i++)
+   {
+      dtl_dv_t *dv = (dtl_dv_t*) 0;
+      rc = apx_vm_setReadBuffer(&vm, dataBuffer, (uint32_t) sizeof(dataBuffer));
+      if (rc == APX_NO_ERROR)
+      {
+         rc = apx_vm_unpackValue(&vm, &dv);
+      }
+      if (dv != 0)
+      {
+         dtl_dec_ref(dv);
+      }
+   }
+   apx_bench_report("vm_unpackValue (dtl)", i, apx_bench_timestampNs() - t0);
+
+   t0 = apx_bench_timestampNs();
+   for (i = 0u; (i < NUM_ITERATIONS) && (rc == APX_NO_ERROR); i++)
+   {
+      rc = apx_vm_unpackNative(&vm, dataBuffer, (apx_size_t) sizeof(dataBuffer), &nativeData, &m_bench_record_layout);
+   }
+   apx_bench_report("vm_unpackNative", i, apx_bench_timestampNs() - t0);
+
+   t0 = apx_bench_timestampNs();
+   for (i = 0u; (i < NUM_ITERATIONS) && (rc == APX_NO_ERROR); i++)
+   {
+      rc = apx_vm_unpackCopyPlan(unpackPlan, dataBuffer, (apx_size_t) sizeof(dataBuffer), &nativeData, &m_bench_record_layout);
+   }
+   apx_bench_report("vm_unpackCopyPlan", i, apx_bench_timestampNs() - t0);
+
+   if (rc != APX_NO_ERROR)
+   {
+      printf("Benchmark failed with error %d\n", (int) rc);
+   }
+   apx_vm_destroy(&vm);
+   dtl_dec_ref(hv);
+   apx_copyPlan_delete(packPlan);
+   apx_copyPlan_delete(unpackPlan);
+   adt_bytes_delete(packProgram);
+   adt_bytes_delete(unpackProgram);
+   apx_dataElement_delete(element);
+   return (rc == APX_NO_ERROR)? 0 : 1;
+}
+
+//////////////////////////////////////////////////////////////////////////////
+// PRIVATE FUNCTIONS
+//////////////////////////////////////////////////////////////////////////////
+static apx_dataElement_t* create_bench_record(void)
+{
+   apx_dataElement_t *element = apx_dataElement_new(APX_BASE_TYPE_RECORD, 0);
+   apx_dataElement_t *childElement;
+   apx_dataElement_appendChild(element, apx_dataElement_new(APX_BASE_TYPE_UINT16, "VehicleSpeed"));
+   apx_dataElement_appendChild(element, apx_dataElement_new(APX_BASE_TYPE_UINT8, "Gear"));
+   apx_dataElement_appendChild(element, apx_dataElement_new(APX_BASE_TYPE_UINT8, "Status"));
+   apx_dataElement_appendChild(element, apx_dataElement_new(APX_BASE_TYPE_UINT32, "Odometer"));
+   childElement = apx_dataElement_new(APX_BASE_TYPE_SINT16, "Torque");
+   apx_dataElement_setArrayLen(childElement, 4);
+   apx_dataElement_appendChild(element, childElement);
+   return element;
+}
+
+static adt_bytes_t* compile_program(apx_dataElement_t *element, bool isPack)
+{
+   adt_bytes_t *program = (adt_bytes_t*) 0;
+   apx_compiler_t *compiler = apx_compiler_new();
+   adt_bytearray_t *compiledProgram = adt_bytearray_new(APX_PROGRAM_GROW_SIZE);
+   if ( (compiler != 0) && (compiledProgram != 0) )
+   {
+      apx_error_t rc;
+      if (isPack)
+      {
+         rc = apx_compiler_begin_packProgram(compiler, compiledProgram);
+         if (rc == APX_NO_ERROR)
+         {
+            rc = apx_compiler_compilePackDataElement(compiler, element);
+         }
+      }
+      else
+      {
+         rc = apx_compiler_begin_unpackProgram(compiler, compiledProgram);
+         if (rc == APX_NO_ERROR)
+         {
+            rc = apx_compiler_compileUnpackDataElement(compiler, element);
+         }
+      }
+      apx_compiler_end(compiler);
+      if (rc == APX_NO_ERROR)
+      {
+         program = adt_bytearray_bytes(compiledProgram);
+      }
+   }
+   if (compiler != 0)
+   {
+      apx_compiler_delete(compiler);
+   }
+   if (compiledProgram != 0)
+   {
+      adt_bytearray_delete(compiledProgram);
+   }
+   return program;
+}
+
+static dtl_hv_t* create_bench_value(void)
+{
+   dtl_hv_t *hv = dtl_hv_new();
+   dtl_av_t *av = dtl_av_new();
+   if ( (hv == 0) || (av == 0) )
+   {
+      return (dtl_hv_t*) 0;
+   }
+   dtl_hv_set_cstr(hv, "VehicleSpeed", (dtl_dv_t*) dtl_sv_make_u32(1234u), false);
+   dtl_hv_set_cstr(hv, "Gear", (dtl_dv_t*) dtl_sv_make_u32(3u), false);
+   dtl_hv_set_cstr(hv, "Status", (dtl_dv_t*) dtl_sv_make_u32(1u), false);
+   dtl_hv_set_cstr(hv, "Odometer", (dtl_dv_t*) dtl_sv_make_u32(123456u), false);
+   dtl_av_push(av, (dtl_dv_t*) dtl_sv_make_i32(-100), false);
+   dtl_av_push(av, (dtl_dv_t*) dtl_sv_make_i32(100), false);
+   dtl_av_push(av, (dtl_dv_t*) dtl_sv_make_i32(-200), false);
+   dtl_av_push(av, (dtl_dv_t*) dtl_sv_make_i32(200), false);
+   dtl_hv_set_cstr(hv, "Torque", (dtl_dv_t*) av, false);
+   return hv;
+}
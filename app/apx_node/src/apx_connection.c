@@ -38,7 +38,8 @@
 //////////////////////////////////////////////////////////////////////////////
 static void apx_connection_onConnect(void *arg, apx_clientConnectionBase_t *clientConnection);
 static void apx_connection_onDisconnect(void *arg, apx_clientConnectionBase_t *clientConnection);
-static void apx_connection_onRequirePortWrite(void *arg, apx_nodeInstance_t *nodeInstance, apx_portId_t requirePortId, void *portHandle);
+static void apx_connection_onRequirePortsWrite(void *arg, apx_nodeInstance_t *nodeInstance, const apx_portId_t *requirePortIds, int32_t numPorts);
+static void apx_connection_printRequirePortValue(apx_connection_t *self, apx_nodeInstance_t *nodeInstance, apx_portId_t requirePortId);
 static apx_error_t apx_connection_prepareProvidePorts(apx_connection_t *self, apx_nodeInstance_t *nodeInstance);
 static apx_error_t apx_connection_prepareRequirePorts(apx_connection_t *self, apx_nodeInstance_t *nodeInstance);
 
@@ -67,7 +68,7 @@ apx_error_t apx_connection_create(apx_connection_t *self)
       listener.arg = (void*) self;
       listener.clientConnect1 = apx_connection_onConnect;
       listener.clientDisconnect1 = apx_connection_onDisconnect;
-      listener.requirePortWrite1 = apx_connection_onRequirePortWrite;
+      listener.requirePortsWrite1 = apx_connection_onRequirePortsWrite;
       apx_client_registerEventListener(self->client, &listener);
       adt_hash_create(&self->providePortLookupTable, (void (*)(void*)) 0);
       adt_ary_create(&self->requirePortLookupTable, (void (*)(void*)) 0);
@@ -226,42 +227,57 @@ static void apx_connection_onDisconnect(void *arg, apx_clientConnectionBase_t *c
    printf("[APX-CONNECTION] Disconnected from APX server\n");
 }
 
-static void apx_connection_onRequirePortWrite(void *arg, apx_nodeInstance_t *nodeInstance, apx_portId_t requirePortId, void *portHandle)
+static void apx_connection_onRequirePortsWrite(void *arg, apx_nodeInstance_t *nodeInstance, const apx_portId_t *requirePortIds, int32_t numPorts)
 {
    apx_connection_t *self = (apx_connection_t*) arg;
-   if (self != 0)
+   if ( (self != 0) && (requirePortIds != 0) )
    {
-      apx_error_t result;
-      adt_str_t *port_name;
-      dtl_dv_t *dv = 0;
-      MUTEX_LOCK(self->mutex);
-      result = apx_client_readPortData(self->client, portHandle, &dv);
-      if (result != APX_NO_ERROR)
+      int32_t i;
+      for (i = 0; i < numPorts; i++)
       {
-         printf("apx_client_readPortData failed with error code %d\n", (int) result);
-         return;
+         apx_connection_printRequirePortValue(self, nodeInstance, requirePortIds[i]);
       }
-      port_name = apx_nodeInstance_getRequirePortName(nodeInstance, requirePortId);
+      fflush(stdout);
+   }
+}
+
+static void apx_connection_printRequirePortValue(apx_connection_t *self, apx_nodeInstance_t *nodeInstance, apx_portId_t requirePortId)
+{
+   apx_error_t result;
+   adt_str_t *port_name;
+   dtl_dv_t *dv = 0;
+   void *portHandle = apx_nodeInstance_getRequirePortHandle(nodeInstance, requirePortId);
+   if (portHandle == 0)
+   {
+      return;
+   }
+   MUTEX_LOCK(self->mutex);
+   result = apx_client_readPortData(self->client, portHandle, &dv);
+   if (result != APX_NO_ERROR)
+   {
       MUTEX_UNLOCK(self->mutex);
-      if ( (dv != 0) && (port_name != 0) )
-      {
-         adt_str_t *value = dtl_json_dumps(dv, 0, false);
-         if (value != 0)
-         {
-            printf("\"%s\": %s\n", adt_str_cstr(port_name), adt_str_cstr(value));
-            fflush(stdout);
-            adt_str_delete(value);
-         }
-      }
-      if (dv != 0)
-      {
-         dtl_dec_ref(dv);
-      }
-      if (port_name != 0)
+      printf("apx_client_readPortData failed with error code %d\n", (int) result);
+      return;
+   }
+   port_name = apx_nodeInstance_getRequirePortName(nodeInstance, requirePortId);
+   MUTEX_UNLOCK(self->mutex);
+   if ( (dv != 0) && (port_name != 0) )
+   {
+      adt_str_t *value = dtl_json_dumps(dv, 0, false);
+      if (value != 0)
       {
-         adt_str_delete(port_name);
+         printf("\"%s\": %s\n", adt_str_cstr(port_name), adt_str_cstr(value));
+         adt_str_delete(value);
       }
    }
+   if (dv != 0)
+   {
+      dtl_dec_ref(dv);
+   }
+   if (port_name != 0)
+   {
+      adt_str_delete(port_name);
+   }
 }
 
 static apx_error_t apx_connection_prepareProvidePorts(apx_connection_t *self, apx_nodeInstance_t *nodeInstance)
@@ -30,6 +30,7 @@
 // INCLUDES
 //////////////////////////////////////////////////////////////////////////////
 #include "apx_socketServerExtension.h"
+#include "apx_serverStatsExtension.h"
 //#include "apx_serverTextLogExtension.h"
 
 
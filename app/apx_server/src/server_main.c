@@ -74,6 +74,10 @@ int main(int argc, char **argv)
 {
    apx_error_t result;
    dtl_hv_t *server_config = (dtl_hv_t*) 0;
+   apx_serverExecutionModel_t executionModel = APX_SERVER_THREAD_PER_CONNECTION;
+   uint32_t numWorkerThreads = 0u;
+   uint32_t numCompileThreads = 0u;
+   bool isConflationEnabled = (APX_CONFLATION_ENABLE_DEFAULT != 0)? true : false;
 
    m_shutdownTimer = SHUTDOWN_TIMER_INIT;
    g_debug = 0;
@@ -110,6 +114,38 @@ int main(int argc, char **argv)
                m_shutdownTimer = i32;
             }
          }
+         dtl_sv_t *svExecutionModel = (dtl_sv_t*) dtl_hv_get_cstr(serverCfg, "execution-model");
+         if (svExecutionModel != 0)
+         {
+            const char *cstr = dtl_sv_to_cstr(svExecutionModel);
+            if ( (cstr != 0) && (strcmp(cstr, "worker-pool") == 0) )
+            {
+               executionModel = APX_SERVER_WORKER_POOL;
+            }
+         }
+         dtl_sv_t *svWorkerThreads = (dtl_sv_t*) dtl_hv_get_cstr(serverCfg, "worker-threads");
+         if (svWorkerThreads != 0)
+         {
+            i32 = dtl_sv_to_i32(svWorkerThreads, &ok);
+            if (ok && (i32 > 0) )
+            {
+               numWorkerThreads = (uint32_t) i32;
+            }
+         }
+         dtl_sv_t *svConflation = (dtl_sv_t*) dtl_hv_get_cstr(serverCfg, "conflation-enabled");
+         if (svConflation != 0)
+         {
+            isConflationEnabled = dtl_sv_to_bool(svConflation);
+         }
+         dtl_sv_t *svCompileThreads = (dtl_sv_t*) dtl_hv_get_cstr(serverCfg, "compile-threads");
+         if (svCompileThreads != 0)
+         {
+            i32 = dtl_sv_to_i32(svCompileThreads, &ok);
+            if (ok && (i32 >= 0) )
+            {
+               numCompileThreads = (uint32_t) i32;
+            }
+         }
       }
    }
 
@@ -124,6 +160,17 @@ int main(int argc, char **argv)
    signal_handler_setup();
 #endif
    apx_server_create(&m_server);
+   result = apx_server_setExecutionModel(&m_server, executionModel, numWorkerThreads);
+   if (result != APX_NO_ERROR)
+   {
+      printf("Failed to set server execution model, error %d\n", (int) result);
+   }
+   apx_server_setConflationEnabled(&m_server, isConflationEnabled);
+   result = apx_server_setCompileThreads(&m_server, numCompileThreads);
+   if (result != APX_NO_ERROR)
+   {
+      printf("Failed to create compile pool, error %d\n", (int) result);
+   }
    if (server_config != 0)
    {
       dtl_dv_t *extension_config = (dtl_dv_t*) 0;
@@ -244,6 +291,11 @@ static apx_error_t register_extensions(apx_server_t *server, dtl_hv_t *config)
    {
       return result;
    }
+   result = apx_serverStatsExtension_register(server, dtl_hv_get_cstr(config, APX_SERVER_STATS_EXT_CFG_KEY));
+   if (result != APX_NO_ERROR)
+   {
+      return result;
+   }
    return APX_NO_ERROR;
 }
 
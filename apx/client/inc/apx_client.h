@@ -32,8 +32,10 @@
 #include <stdint.h>
 #include <stdbool.h>
 #include "apx_error.h"
+#include "apx_cfg.h"
 #include "apx_clientConnectionBase.h"
 #include "apx_nodeInstance.h"
+#include "adt_ary.h"
 
 
 //////////////////////////////////////////////////////////////////////////////
@@ -48,6 +50,7 @@ struct apx_clientEventListener_tag;
 struct apx_fileManager_tag;
 struct apx_nodeManager_tag;
 struct apx_vm_tag;
+struct apx_vmNativeLayout_tag;
 
 #ifndef APX_EMBEDDED
 # ifdef _WIN32
@@ -70,10 +73,13 @@ typedef struct apx_client_tag
    apx_clientConnectionBase_t *connection; //message connection
    struct adt_list_tag *eventListeners; //weak references to apx_clientEventListener_t
    struct apx_nodeManager_tag *nodeManager;
-   struct apx_vm_tag *vm;
+   struct apx_vm_tag * volatile vmPool[APX_CLIENT_VM_POOL_SIZE]; //idle VMs. A thread takes a VM out of a slot (leaving it NULL) for the duration of one pack/unpack.
    SPINLOCK_T lock;
    SPINLOCK_T eventListenerLock;
+   adt_ary_t transactionNodes; //weak references to apx_nodeInstance_t. Nodes with provide port data written during the active transaction.
    bool isConnected;
+   bool isDefinitionCompressionEnabled; //When true the client offers LZ4 compressed definition files to the server
+   volatile uint32_t inTransaction; //read without holding lock by port data writers, only changed while holding lock
 } apx_client_t;
 
 //////////////////////////////////////////////////////////////////////////////
@@ -107,6 +113,7 @@ int32_t apx_client_getNumAttachedNodes(apx_client_t *self);
 int32_t apx_client_getNumEventListeners(apx_client_t *self);
 void apx_client_attachConnection(apx_client_t *self, apx_clientConnectionBase_t *connection);
 apx_clientConnectionBase_t *apx_client_getConnection(apx_client_t *self);
+void apx_client_setDefinitionCompression(apx_client_t *self, bool enabled);
 
 apx_error_t apx_client_buildNode_cstr(apx_client_t *self, const char *definition_text);
 int32_t apx_client_getLastErrorLine(apx_client_t *self);
@@ -116,20 +123,31 @@ struct apx_nodeManager_tag *apx_client_getNodeManager(apx_client_t *self);
 
 /*** Port Handle API ***/
 void *apx_client_getPortHandle(apx_client_t *self, const char *nodeName, const char *portName);
+int32_t apx_client_getPortHandles(apx_client_t *self, const char *nodeName, const char * const *portNames, void **portHandles, int32_t numPorts);
 void *apx_client_getProvidePortHandleById(apx_client_t *self, const char *nodeName, apx_portId_t providePortId);
 void *apx_client_getRequirePortHandleById(apx_client_t *self, const char *nodeName, apx_portId_t requirePortId);
 
 /*** Port Data Write API ***/
+/* On queued ports (Q[N]) every write appends one element. Writers and readers of a queued port may run on any thread,
+ * each end of the port queue is serialized internally. An element accepted by a write (APX_NO_ERROR) is read exactly
+ * once, in the order it was written relative to other elements from the same thread. */
 apx_error_t apx_client_writePortData(apx_client_t *self, void *portHandle, const dtl_dv_t *value);
 apx_error_t apx_client_writePortData_u8(apx_client_t *self, void *portHandle, uint8_t value);
 apx_error_t apx_client_writePortData_u16(apx_client_t *self, void *portHandle, uint16_t value);
 apx_error_t apx_client_writePortData_u32(apx_client_t *self, void *portHandle, uint32_t value);
+apx_error_t apx_client_writePortDataNative(apx_client_t *self, void *portHandle, const void *nativeData, const struct apx_vmNativeLayout_tag *layout);
+apx_error_t apx_client_beginTransaction(apx_client_t *self);
+apx_error_t apx_client_commitTransaction(apx_client_t *self);
+bool apx_client_isTransactionActive(apx_client_t *self);
 
 /*** Port Data Read API ***/
 apx_error_t apx_client_readPortData(apx_client_t *self, void *portHandle, dtl_dv_t **dv);
 apx_error_t apx_client_readPortData_u8(apx_client_t *self, void *portHandle, uint8_t *value);
 apx_error_t apx_client_readPortData_u16(apx_client_t *self, void *portHandle, uint16_t *value);
 apx_error_t apx_client_readPortData_u32(apx_client_t *self, void *portHandle, uint32_t *value);
+apx_error_t apx_client_readPortDataNative(apx_client_t *self, void *portHandle, void *nativeData, const struct apx_vmNativeLayout_tag *layout);
+int32_t apx_client_readQueuedPortData(apx_client_t *self, void *portHandle, uint8_t *elements, int32_t maxNumElements);
+int32_t apx_client_pollChangedRequirePorts(apx_client_t *self, const char *nodeName, apx_portId_t *requirePortIds, int32_t maxNumPorts);
 
 #ifdef UNIT_TEST
 void apx_client_run(apx_client_t *self);
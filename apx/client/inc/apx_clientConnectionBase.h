@@ -60,6 +60,8 @@ void apx_clientConnectionBase_defaultEventHandler(void *arg, apx_event_t *event)
 void apx_clientConnectionBase_close(apx_clientConnectionBase_t *self);
 uint32_t apx_clientConnectionBase_getTotalBytesReceived(apx_clientConnectionBase_t *self);
 uint32_t apx_clientConnectionBase_getTotalBytesSent(apx_clientConnectionBase_t *self);
+apx_error_t apx_clientConnectionBase_sendPing(apx_clientConnectionBase_t *self);
+void apx_clientConnectionBase_getLatencySummary(apx_clientConnectionBase_t *self, apx_latencySummary_t *summary);
 void* apx_clientConnectionBase_registerEventListener(apx_clientConnectionBase_t *self, apx_connectionEventListener_t *listener);
 void apx_clientConnectionBase_unregisterEventListener(apx_clientConnectionBase_t *self, void *handle);
 void apx_clientConnectionBase_attachNodeInstance(apx_clientConnectionBase_t *self, struct apx_nodeInstance_tag *nodeInstance);
@@ -76,6 +76,7 @@ void apx_clientTestConnection_clearTransmitLog(apx_clientTestConnection_t *self)
 
 apx_error_t apx_clientTestConnection_onFileOpenMsgReceived(apx_clientTestConnection_t *self, const rmf_cmdOpenFile_t *openFileCmd);
 apx_error_t apx_clientTestConnection_onFileInfoMsgReceived(apx_clientTestConnection_t *self, const rmf_fileInfo_t *remoteFileInfo);
+apx_error_t apx_clientTestConnection_onSerializedMsgReceived(apx_clientTestConnection_t *self, const uint8_t *msgBuf, int32_t msgLen);
 
 
 #endif //APX_CLIENT_TEST_CONNECTION_H
@@ -47,6 +47,8 @@
 #include "apx_compiler.h"
 #include "pack.h"
 #include "apx_vm.h"
+#include "apx_atomic.h"
+#include "rmf.h"
 
 #ifdef UNIT_TEST
 #include "testsocket.h"
@@ -61,15 +63,24 @@
 // CONSTANTS AND DATA TYPES
 //////////////////////////////////////////////////////////////////////////////
 #define MAX_STACK_BUFFER_SIZE 256u
+#define STACK_PORT_ID_BUFFER_SIZE 64
 //////////////////////////////////////////////////////////////////////////////
 // LOCAL FUNCTION PROTOTYPES
 //////////////////////////////////////////////////////////////////////////////
 static void apx_client_triggerConnectedEventOnListeners(apx_client_t *self, apx_clientConnectionBase_t *connection);
 static void apx_client_triggerDisconnectedEventOnListeners(apx_client_t *self, apx_clientConnectionBase_t *connection);
-static void apx_client_triggerRequirePortDataWriteEventOnListeners(apx_client_t *self, apx_nodeInstance_t *nodeInstance, apx_portId_t requirePortId, void *portHandle);
+static void apx_client_triggerRequirePortDataWriteEventOnListeners(apx_client_t *self, apx_nodeInstance_t *nodeInstance, const apx_portId_t *requirePortIds, int32_t numPorts);
 static void apx_client_attachLocalNodesToConnection(apx_client_t *self);
 static apx_error_t apx_client_verifySingleInstructionProgramFromPortRef(apx_portRef_t *portRef, uint8_t opcode, uint8_t variant);
 static apx_error_t apx_client_verifySingleInstructionProgram(const adt_bytes_t *program, uint8_t opcode, uint8_t variant);
+static apx_error_t apx_client_writeProvidePortData(apx_client_t *self, apx_nodeInstance_t *nodeInstance, const uint8_t *src, uint32_t offset, apx_size_t len);
+static apx_error_t apx_client_writeProvidePortElement(apx_client_t *self, apx_portRef_t *portRef, const uint8_t *src, apx_size_t len);
+static apx_error_t apx_client_readRequirePortElement(apx_portRef_t *portRef, uint8_t *dest, apx_size_t len);
+static apx_nodeInstance_t *apx_client_findNodeInstance(apx_client_t *self, const char *nodeName);
+static void *apx_client_getPortHandleInternal(apx_nodeInstance_t *nodeInstance, apx_nodeInfo_t *nodeInfo, const char *portName);
+static apx_vm_t *apx_client_acquireVm(apx_client_t *self);
+static void apx_client_releaseVm(apx_client_t *self, apx_vm_t *vm);
+static apx_error_t apx_client_execNativeProgram(apx_client_t *self, const adt_bytes_t *program, uint8_t *buffer, apx_size_t bufSize, void *nativeData, const apx_vmNativeLayout_t *layout);
 
 //////////////////////////////////////////////////////////////////////////////
 // GLOBAL VARIABLES
@@ -93,10 +104,13 @@ apx_error_t apx_client_create(apx_client_t *self)
          return APX_MEM_ERROR;
       }
       self->connection = (apx_clientConnectionBase_t*) 0;
-      self->vm = (apx_vm_t*) 0;
+      memset((void*) &self->vmPool[0], 0, sizeof(self->vmPool));
       //The node manager in this class is the true manager of the nodeInstances. Therefore we set useWeakRef argument to false.
       self->nodeManager = apx_nodeManager_new(APX_CLIENT_MODE, false);
       self->isConnected = false;
+      self->isDefinitionCompressionEnabled = (APX_CLIENT_DEFINITION_COMPRESSION_DEFAULT != 0);
+      self->inTransaction = 0u;
+      adt_ary_create(&self->transactionNodes, (void(*)(void*)) 0);
       SPINLOCK_INIT(self->lock);
       SPINLOCK_INIT(self->eventListenerLock);
       return APX_NO_ERROR;
@@ -108,6 +122,7 @@ void apx_client_destroy(apx_client_t *self)
 {
    if (self != 0)
    {
+      int32_t i;
       bool isConnected;
       SPINLOCK_ENTER(self->lock);
       isConnected = self->isConnected;
@@ -125,10 +140,14 @@ void apx_client_destroy(apx_client_t *self)
       {
          apx_nodeManager_delete(self->nodeManager);
       }
-      if (self->vm != 0)
+      for (i = 0; i < APX_CLIENT_VM_POOL_SIZE; i++)
       {
-         apx_vm_delete(self->vm);
+         if (self->vmPool[i] != 0)
+         {
+            apx_vm_delete(self->vmPool[i]);
+         }
       }
+      adt_ary_destroy(&self->transactionNodes);
       SPINLOCK_DESTROY(self->lock);
       SPINLOCK_DESTROY(self->eventListenerLock);
    }
@@ -327,10 +346,23 @@ void apx_client_attachConnection(apx_client_t *self, apx_clientConnectionBase_t
       {
          connection->client = self;
       }
+      apx_connectionBase_setCompressionType(&connection->base, self->isDefinitionCompressionEnabled? RMF_COMPRESSION_LZ4 : RMF_COMPRESSION_NONE);
       apx_client_attachLocalNodesToConnection(self);
    }
 }
 
+/**
+ * Must be called before the client connects. Only enable this when the server is known to understand the
+ * Compression greeting header, older servers are unable to receive compressed definition files.
+ */
+void apx_client_setDefinitionCompression(apx_client_t *self, bool enabled)
+{
+   if (self != 0)
+   {
+      self->isDefinitionCompressionEnabled = enabled;
+   }
+}
+
 apx_clientConnectionBase_t *apx_client_getConnection(apx_client_t *self)
 {
    if (self != 0)
@@ -390,38 +422,49 @@ void *apx_client_getPortHandle(apx_client_t *self, const char *nodeName, const c
 {
    if ( (self != 0) && (portName != 0))
    {
-      apx_nodeInstance_t *nodeInstance = 0;
-      if (nodeName == 0)
-      {
-         nodeInstance = apx_client_getLastAttachedNode(self);
-      }
-      else
+      apx_nodeInstance_t *nodeInstance = apx_client_findNodeInstance(self, nodeName);
+      if (nodeInstance != 0)
       {
-         nodeInstance = apx_nodeManager_find(self->nodeManager, nodeName);
+         apx_nodeInfo_t *nodeInfo = apx_nodeInstance_getNodeInfo(nodeInstance);
+         assert(nodeInfo != 0);
+         return apx_client_getPortHandleInternal(nodeInstance, nodeInfo, portName);
       }
+   }
+   return (void*) 0;
+}
+
+/**
+ * Resolves numPorts port names in one call. portHandles[i] is set to the handle of portNames[i], or NULL if no such port exists.
+ * Returns the number of names that were resolved or -1 on error.
+ */
+int32_t apx_client_getPortHandles(apx_client_t *self, const char *nodeName, const char * const *portNames, void **portHandles, int32_t numPorts)
+{
+   if ( (self != 0) && (portNames != 0) && (portHandles != 0) && (numPorts >= 0) )
+   {
+      int32_t i;
+      int32_t numResolved = 0;
+      apx_nodeInfo_t *nodeInfo = (apx_nodeInfo_t*) 0;
+      apx_nodeInstance_t *nodeInstance = apx_client_findNodeInstance(self, nodeName);
       if (nodeInstance != 0)
       {
-         apx_uniquePortId_t uniquePortId;
-         apx_nodeInfo_t *nodeInfo = apx_nodeInstance_getNodeInfo(nodeInstance);
+         nodeInfo = apx_nodeInstance_getNodeInfo(nodeInstance);
          assert(nodeInfo != 0);
-         uniquePortId = apx_nodeInfo_findPortIdByName(nodeInfo, portName);
-         if (uniquePortId != APX_INVALID_PORT_ID)
+      }
+      for (i = 0; i < numPorts; i++)
+      {
+         portHandles[i] = (void*) 0;
+         if ( (nodeInfo != 0) && (portNames[i] != 0) )
          {
-            apx_portId_t portId;
-            if ((uniquePortId & APX_PORT_ID_PROVIDE_PORT) != 0)
+            portHandles[i] = apx_client_getPortHandleInternal(nodeInstance, nodeInfo, portNames[i]);
+            if (portHandles[i] != 0)
             {
-               portId = uniquePortId & APX_PORT_ID_MASK;
-               return (void*) apx_nodeInstance_getProvidePortRef(nodeInstance, portId);
-            }
-            else
-            {
-               portId = uniquePortId;
-               return (void*) apx_nodeInstance_getRequirePortRef(nodeInstance, portId);
+               numResolved++;
             }
          }
       }
+      return numResolved;
    }
-   return (void*) 0;
+   return -1;
 }
 
 void *apx_client_getProvidePortHandleById(apx_client_t *self, const char *nodeName, apx_portId_t providePortId)
@@ -479,19 +522,15 @@ apx_error_t apx_client_writePortData(apx_client_t *self, void *portHandle, const
       const apx_portDataProps_t *portDataProps;
       apx_portRef_t *portRef = (apx_portRef_t*) portHandle;
       const adt_bytes_t *portProgram;
+      apx_vm_t *vm;
       if (!apx_portRef_isProvidePort(portRef))
       {
          return APX_INVALID_PORT_HANDLE_ERROR;
       }
       portDataProps = portRef->portDataProps;
-      if (!apx_portDataProps_isPlainOldData(portDataProps))
+      if (portDataProps->elementSize > MAX_STACK_BUFFER_SIZE)
       {
-         printf("Not plain old data\n");
-         return APX_NOT_IMPLEMENTED_ERROR; ///TODO: Implement dynamic array and queued signals later
-      }
-      if (portDataProps->dataSize > MAX_STACK_BUFFER_SIZE)
-      {
-         writeBuffer = (uint8_t*) malloc(portDataProps->dataSize);
+         writeBuffer = (uint8_t*) malloc(portDataProps->elementSize);
          if (writeBuffer == 0)
          {
             return APX_MEM_ERROR;
@@ -502,48 +541,32 @@ apx_error_t apx_client_writePortData(apx_client_t *self, void *portHandle, const
       {
          writeBuffer = &stackBuffer[0];
       }
-      SPINLOCK_ENTER(self->lock);
-      if (self->vm == 0)
-      {
-         self->vm = apx_vm_new();
-         if (self->vm == 0)
-         {
-            SPINLOCK_LEAVE(self->lock);
-            if (isHeapAllocated) free(writeBuffer);
-            return APX_MEM_ERROR;
-         }
-      }
-      assert(self->vm != 0);
       portProgram = apx_nodeInstance_getProvidePortPackProgram(portRef->nodeInstance, apx_portRef_getPortId(portRef));
       if (portProgram == 0)
       {
-         SPINLOCK_LEAVE(self->lock);
          if (isHeapAllocated) free(writeBuffer);
          return APX_INVALID_PROGRAM_ERROR;
       }
-      result = apx_vm_selectProgram(self->vm, portProgram);
-      if (result != APX_NO_ERROR)
+      vm = apx_client_acquireVm(self);
+      if (vm == 0)
       {
-         SPINLOCK_LEAVE(self->lock);
          if (isHeapAllocated) free(writeBuffer);
-         return result;
+         return APX_MEM_ERROR;
       }
-      result = apx_vm_setWriteBuffer(self->vm, writeBuffer, portDataProps->dataSize);
-      if (result != APX_NO_ERROR)
+      result = apx_vm_selectProgram(vm, portProgram);
+      if (result == APX_NO_ERROR)
       {
-         SPINLOCK_LEAVE(self->lock);
-         if (isHeapAllocated) free(writeBuffer);
-         return result;
+         result = apx_vm_setWriteBuffer(vm, writeBuffer, portDataProps->elementSize);
       }
-      result = apx_vm_packValue(self->vm, value);
-      if (result != APX_NO_ERROR)
+      if (result == APX_NO_ERROR)
       {
-         SPINLOCK_LEAVE(self->lock);
-         if (isHeapAllocated) free(writeBuffer);
-         return result;
+         result = apx_vm_packValue(vm, value);
+      }
+      apx_client_releaseVm(self, vm);
+      if (result == APX_NO_ERROR)
+      {
+         result = apx_client_writeProvidePortElement(self, portRef, writeBuffer, portDataProps->elementSize);
       }
-      SPINLOCK_LEAVE(self->lock);
-      result = apx_nodeInstance_writeProvidePortData(portRef->nodeInstance, writeBuffer, portDataProps->offset, portDataProps->dataSize);
       if (isHeapAllocated) free(writeBuffer);
       return result;
    }
@@ -560,9 +583,7 @@ apx_error_t apx_client_writePortData_u8(apx_client_t *self, void *portHandle, ui
       if (rc == APX_NO_ERROR)
       {
          apx_error_t result;
-         SPINLOCK_ENTER(self->lock);
-         result = apx_nodeInstance_writeProvidePortData(portRef->nodeInstance, &value, portRef->portDataProps->offset, UINT8_SIZE);
-         SPINLOCK_LEAVE(self->lock);
+         result = apx_client_writeProvidePortElement(self, portRef, &value, UINT8_SIZE);
          return result;
       }
       else
@@ -585,9 +606,7 @@ apx_error_t apx_client_writePortData_u16(apx_client_t *self, void *portHandle, u
          apx_error_t result;
          uint8_t packedData[UINT16_SIZE];
          packLE(&packedData[0], value, UINT16_SIZE);
-         SPINLOCK_ENTER(self->lock);
-         result = apx_nodeInstance_writeProvidePortData(portRef->nodeInstance, &packedData[0], portRef->portDataProps->offset, UINT16_SIZE);
-         SPINLOCK_LEAVE(self->lock);
+         result = apx_client_writeProvidePortElement(self, portRef, &packedData[0], UINT16_SIZE);
          return result;
       }
       else
@@ -610,9 +629,7 @@ apx_error_t apx_client_writePortData_u32(apx_client_t *self, void *portHandle, u
          apx_error_t result;
          uint8_t packedData[UINT32_SIZE];
          packLE(&packedData[0], value, UINT32_SIZE);
-         SPINLOCK_ENTER(self->lock);
-         result = apx_nodeInstance_writeProvidePortData(portRef->nodeInstance, &packedData[0], portRef->portDataProps->offset, UINT32_SIZE);
-         SPINLOCK_LEAVE(self->lock);
+         result = apx_client_writeProvidePortElement(self, portRef, &packedData[0], UINT32_SIZE);
          return result;
       }
       else
@@ -623,6 +640,134 @@ apx_error_t apx_client_writePortData_u32(apx_client_t *self, void *portHandle, u
    return APX_INVALID_ARGUMENT_ERROR;
 }
 
+/**
+ * Packs a native C struct (described by layout) into the provide port without going through dtl_dv_t.
+ * Ports with a flat data type are packed using the copy plan cached in the node info, other ports are
+ * packed by the VM in native mode.
+ */
+apx_error_t apx_client_writePortDataNative(apx_client_t *self, void *portHandle, const void *nativeData, const apx_vmNativeLayout_t *layout)
+{
+   if ( (self != 0) && (portHandle != 0) && (nativeData != 0) && (layout != 0) )
+   {
+      uint8_t stackBuffer[MAX_STACK_BUFFER_SIZE];
+      apx_error_t result;
+      uint8_t *writeBuffer;
+      bool isHeapAllocated = false;
+      const apx_portDataProps_t *portDataProps;
+      const apx_copyPlan_t *plan;
+      apx_portRef_t *portRef = (apx_portRef_t*) portHandle;
+      if (!apx_portRef_isProvidePort(portRef))
+      {
+         return APX_INVALID_PORT_HANDLE_ERROR;
+      }
+      portDataProps = portRef->portDataProps;
+      if (portDataProps->elementSize > MAX_STACK_BUFFER_SIZE)
+      {
+         writeBuffer = (uint8_t*) malloc(portDataProps->elementSize);
+         if (writeBuffer == 0)
+         {
+            return APX_MEM_ERROR;
+         }
+         isHeapAllocated = true;
+      }
+      else
+      {
+         writeBuffer = &stackBuffer[0];
+      }
+      plan = apx_nodeInstance_getProvidePortPackPlan(portRef->nodeInstance, apx_portRef_getPortId(portRef));
+      if (plan != 0)
+      {
+         result = apx_vm_packCopyPlan(plan, writeBuffer, portDataProps->elementSize, nativeData, layout);
+      }
+      else
+      {
+         result = apx_client_execNativeProgram(self, apx_nodeInstance_getProvidePortPackProgram(portRef->nodeInstance, apx_portRef_getPortId(portRef)),
+               writeBuffer, portDataProps->elementSize, (void*) nativeData, layout);
+      }
+      if (result == APX_NO_ERROR)
+      {
+         result = apx_client_writeProvidePortElement(self, portRef, writeBuffer, portDataProps->elementSize);
+      }
+      if (isHeapAllocated) free(writeBuffer);
+      return result;
+   }
+   return APX_INVALID_ARGUMENT_ERROR;
+}
+
+/**
+ * Starts a write transaction. Until apx_client_commitTransaction is called, port data written using the
+ * apx_client_writePortData family of functions is only stored locally in the node's provide port data buffer.
+ */
+apx_error_t apx_client_beginTransaction(apx_client_t *self)
+{
+   if (self != 0)
+   {
+      apx_error_t retval = APX_NO_ERROR;
+      SPINLOCK_ENTER(self->lock);
+      if (self->inTransaction)
+      {
+         retval = APX_INVALID_STATE_ERROR;
+      }
+      else
+      {
+         apx_atomic_store32(&self->inTransaction, 1u);
+      }
+      SPINLOCK_LEAVE(self->lock);
+      return retval;
+   }
+   return APX_INVALID_ARGUMENT_ERROR;
+}
+
+/**
+ * Ends the active write transaction and sends all data written during it to the remote side.
+ * Dirty byte ranges are coalesced per node such that adjacent ports are transmitted in a single write.
+ * The list of nodes is moved out under the lock, the flush itself is done without holding it.
+ */
+apx_error_t apx_client_commitTransaction(apx_client_t *self)
+{
+   if (self != 0)
+   {
+      apx_error_t retval = APX_NO_ERROR;
+      adt_ary_t nodes;
+      int32_t i;
+      int32_t numNodes;
+      SPINLOCK_ENTER(self->lock);
+      if (!self->inTransaction)
+      {
+         SPINLOCK_LEAVE(self->lock);
+         return APX_INVALID_STATE_ERROR;
+      }
+      memcpy(&nodes, &self->transactionNodes, sizeof(adt_ary_t));
+      adt_ary_create(&self->transactionNodes, (void(*)(void*)) 0);
+      apx_atomic_store32(&self->inTransaction, 0u);
+      SPINLOCK_LEAVE(self->lock);
+      numNodes = adt_ary_length(&nodes);
+      for (i = 0; i < numNodes; i++)
+      {
+         apx_error_t rc;
+         apx_nodeInstance_t *nodeInstance = (apx_nodeInstance_t*) adt_ary_value(&nodes, i);
+         assert(nodeInstance != 0);
+         rc = apx_nodeInstance_flushProvidePortData(nodeInstance);
+         if ( (rc != APX_NO_ERROR) && (retval == APX_NO_ERROR) )
+         {
+            retval = rc;
+         }
+      }
+      adt_ary_destroy(&nodes);
+      return retval;
+   }
+   return APX_INVALID_ARGUMENT_ERROR;
+}
+
+bool apx_client_isTransactionActive(apx_client_t *self)
+{
+   if (self != 0)
+   {
+      return (apx_atomic_load32(&self->inTransaction) != 0u)? true : false;
+   }
+   return false;
+}
+
 /*** Port Data Read API ***/
 
 apx_error_t apx_client_readPortData(apx_client_t *self, void *portHandle, dtl_dv_t **dv)
@@ -636,19 +781,15 @@ apx_error_t apx_client_readPortData(apx_client_t *self, void *portHandle, dtl_dv
       const apx_portDataProps_t *portDataProps;
       apx_portRef_t *portRef = (apx_portRef_t*) portHandle;
       const adt_bytes_t *portProgram;
+      apx_vm_t *vm;
       if (apx_portRef_isProvidePort(portRef))
       {
          return APX_INVALID_PORT_HANDLE_ERROR;
       }
       portDataProps = portRef->portDataProps;
-      if (!apx_portDataProps_isPlainOldData(portDataProps))
+      if (portDataProps->elementSize > MAX_STACK_BUFFER_SIZE)
       {
-         printf("Not plain old data\n");
-         return APX_NOT_IMPLEMENTED_ERROR; ///TODO: Implement dynamic array and queued signals later
-      }
-      if (portDataProps->dataSize > MAX_STACK_BUFFER_SIZE)
-      {
-         readBuffer = (uint8_t*) malloc(portDataProps->dataSize);
+         readBuffer = (uint8_t*) malloc(portDataProps->elementSize);
          if (readBuffer == 0)
          {
             return APX_MEM_ERROR;
@@ -660,46 +801,34 @@ apx_error_t apx_client_readPortData(apx_client_t *self, void *portHandle, dtl_dv
          readBuffer = &stackBuffer[0];
       }
       assert(readBuffer != 0);
-      result = apx_nodeInstance_readRequirePortData(portRef->nodeInstance, readBuffer, portDataProps->offset, portDataProps->dataSize);
+      result = apx_client_readRequirePortElement(portRef, readBuffer, portDataProps->elementSize);
       if (result != APX_NO_ERROR)
       {
+         if (isHeapAllocated) free(readBuffer);
          return result;
       }
-      SPINLOCK_ENTER(self->lock);
-      if (self->vm == 0)
-      {
-         self->vm = apx_vm_new();
-         if (self->vm == 0)
-         {
-            SPINLOCK_LEAVE(self->lock);
-            if (isHeapAllocated) free(readBuffer);
-            return APX_MEM_ERROR;
-         }
-      }
-      assert(self->vm != 0);
       portProgram = apx_nodeInstance_getRequirePortUnpackProgram(portRef->nodeInstance, apx_portRef_getPortId(portRef));
       if (portProgram == 0)
       {
-         SPINLOCK_LEAVE(self->lock);
          if (isHeapAllocated) free(readBuffer);
          return APX_INVALID_PROGRAM_ERROR;
       }
-      result = apx_vm_selectProgram(self->vm, portProgram);
-      if (result != APX_NO_ERROR)
+      vm = apx_client_acquireVm(self);
+      if (vm == 0)
       {
-         SPINLOCK_LEAVE(self->lock);
          if (isHeapAllocated) free(readBuffer);
-         return result;
+         return APX_MEM_ERROR;
       }
-      result = apx_vm_setReadBuffer(self->vm, readBuffer, portDataProps->dataSize);
-      if (result != APX_NO_ERROR)
+      result = apx_vm_selectProgram(vm, portProgram);
+      if (result == APX_NO_ERROR)
       {
-         SPINLOCK_LEAVE(self->lock);
-         if (isHeapAllocated) free(readBuffer);
-         return result;
+         result = apx_vm_setReadBuffer(vm, readBuffer, portDataProps->elementSize);
       }
-      result = apx_vm_unpackValue(self->vm, dv);
-      SPINLOCK_LEAVE(self->lock);
+      if (result == APX_NO_ERROR)
+      {
+         result = apx_vm_unpackValue(vm, dv);
+      }
+      apx_client_releaseVm(self, vm);
       if (isHeapAllocated) free(readBuffer);
       return result;
    }
@@ -715,9 +844,7 @@ apx_error_t apx_client_readPortData_u8(apx_client_t *self, void *portHandle, uin
       rc = apx_client_verifySingleInstructionProgramFromPortRef(portRef, APX_OPCODE_UNPACK, APX_VARIANT_U8);
       if (rc == APX_NO_ERROR)
       {
-         SPINLOCK_ENTER(self->lock);
-         rc = apx_nodeInstance_readRequirePortData(portRef->nodeInstance, value, portRef->portDataProps->offset, UINT8_SIZE);
-         SPINLOCK_LEAVE(self->lock);
+         rc = apx_client_readRequirePortElement(portRef, value, UINT8_SIZE);
          return rc;
       }
       else
@@ -738,9 +865,7 @@ apx_error_t apx_client_readPortData_u16(apx_client_t *self, void *portHandle, ui
       if (rc == APX_NO_ERROR)
       {
          uint8_t packedData[UINT16_SIZE];
-         SPINLOCK_ENTER(self->lock);
-         rc = apx_nodeInstance_readRequirePortData(portRef->nodeInstance, &packedData[0], portRef->portDataProps->offset, UINT16_SIZE);
-         SPINLOCK_LEAVE(self->lock);
+         rc = apx_client_readRequirePortElement(portRef, &packedData[0], UINT16_SIZE);
          if (rc == APX_NO_ERROR)
          {
             *value = (uint16_t) unpackLE(&packedData[0], UINT16_SIZE);
@@ -765,9 +890,7 @@ apx_error_t apx_client_readPortData_u32(apx_client_t *self, void *portHandle, ui
       if (rc == APX_NO_ERROR)
       {
          uint8_t packedData[UINT32_SIZE];
-         SPINLOCK_ENTER(self->lock);
-         rc = apx_nodeInstance_readRequirePortData(portRef->nodeInstance, &packedData[0], portRef->portDataProps->offset, UINT32_SIZE);
-         SPINLOCK_LEAVE(self->lock);
+         rc = apx_client_readRequirePortElement(portRef, &packedData[0], UINT32_SIZE);
          if (rc == APX_NO_ERROR)
          {
             *value = unpackLE(&packedData[0], UINT32_SIZE);
@@ -782,6 +905,97 @@ apx_error_t apx_client_readPortData_u32(apx_client_t *self, void *portHandle, ui
    return APX_INVALID_ARGUMENT_ERROR;
 }
 
+/**
+ * Unpacks require port data directly into a native C struct (described by layout).
+ * Ports with a flat data type are unpacked using the copy plan cached in the node info, other ports are
+ * unpacked by the VM in native mode.
+ */
+apx_error_t apx_client_readPortDataNative(apx_client_t *self, void *portHandle, void *nativeData, const apx_vmNativeLayout_t *layout)
+{
+   if ( (self != 0) && (portHandle != 0) && (nativeData != 0) && (layout != 0) )
+   {
+      uint8_t stackBuffer[MAX_STACK_BUFFER_SIZE];
+      apx_error_t result;
+      uint8_t *readBuffer;
+      bool isHeapAllocated = false;
+      const apx_portDataProps_t *portDataProps;
+      const apx_copyPlan_t *plan;
+      apx_portRef_t *portRef = (apx_portRef_t*) portHandle;
+      if (apx_portRef_isProvidePort(portRef))
+      {
+         return APX_INVALID_PORT_HANDLE_ERROR;
+      }
+      portDataProps = portRef->portDataProps;
+      if (portDataProps->elementSize > MAX_STACK_BUFFER_SIZE)
+      {
+         readBuffer = (uint8_t*) malloc(portDataProps->elementSize);
+         if (readBuffer == 0)
+         {
+            return APX_MEM_ERROR;
+         }
+         isHeapAllocated = true;
+      }
+      else
+      {
+         readBuffer = &stackBuffer[0];
+      }
+      result = apx_client_readRequirePortElement(portRef, readBuffer, portDataProps->elementSize);
+      if (result == APX_NO_ERROR)
+      {
+         plan = apx_nodeInstance_getRequirePortUnpackPlan(portRef->nodeInstance, apx_portRef_getPortId(portRef));
+         if (plan != 0)
+         {
+            result = apx_vm_unpackCopyPlan(plan, readBuffer, portDataProps->elementSize, nativeData, layout);
+         }
+         else
+         {
+            result = apx_client_execNativeProgram(self, apx_nodeInstance_getRequirePortUnpackProgram(portRef->nodeInstance, apx_portRef_getPortId(portRef)),
+                  readBuffer, portDataProps->elementSize, nativeData, layout);
+         }
+      }
+      if (isHeapAllocated) free(readBuffer);
+      return result;
+   }
+   return APX_INVALID_ARGUMENT_ERROR;
+}
+
+/**
+ * Non-blocking. Moves up to maxNumElements received elements of a queued require port into elements, oldest first.
+ * Elements are returned in packed form, each one taking portDataProps->elementSize bytes.
+ * Any thread may call this. Readers of the same port are serialized, so each received element is returned
+ * to exactly one caller. Returns the number of elements read or -1 on error (including ports that are not queued).
+ */
+int32_t apx_client_readQueuedPortData(apx_client_t *self, void *portHandle, uint8_t *elements, int32_t maxNumElements)
+{
+   if ( (self != 0) && (portHandle != 0) && (elements != 0) )
+   {
+      apx_portRef_t *portRef = (apx_portRef_t*) portHandle;
+      if (apx_portRef_isProvidePort(portRef) || !apx_portDataProps_isQueued(portRef->portDataProps))
+      {
+         return -1;
+      }
+      return apx_nodeInstance_readQueuedRequirePortData(portRef->nodeInstance, apx_portRef_getPortId(portRef), elements, maxNumElements);
+   }
+   return -1;
+}
+
+/**
+ * Non-blocking. Returns the IDs of require ports in the node that received new data since the previous poll.
+ * Each changed port is reported once no matter how many times it was written, intermediate values are not queued.
+ * Returns the number of port IDs written to requirePortIds or -1 on error.
+ */
+int32_t apx_client_pollChangedRequirePorts(apx_client_t *self, const char *nodeName, apx_portId_t *requirePortIds, int32_t maxNumPorts)
+{
+   if ( (self != 0) && (requirePortIds != 0) && (maxNumPorts >= 0) )
+   {
+      apx_nodeInstance_t *nodeInstance = apx_client_findNodeInstance(self, nodeName);
+      if (nodeInstance != 0)
+      {
+         return apx_nodeInstance_pollDirtyRequirePorts(nodeInstance, requirePortIds, maxNumPorts);
+      }
+   }
+   return -1;
+}
 
 /////////////////////// BEGIN CLIENT INTERNAL API /////////////////////
 void apx_clientInternal_onConnect(apx_client_t *self, apx_clientConnectionBase_t *connection)
@@ -800,32 +1014,65 @@ void apx_clientInternal_onDisconnect(apx_client_t *self, apx_clientConnectionBas
    }
 }
 
+/**
+ * Marks all require ports touched by the write as dirty and notifies listeners once for the whole write.
+ */
 void apx_clientInternal_requirePortDataWriteNotify(apx_client_t *self, apx_clientConnectionBase_t *connection, apx_nodeInstance_t *nodeInstance, uint32_t offset, const uint8_t *data, uint32_t len)
 {
    (void) connection;
+   (void) data;
    if ( (self != 0) && (nodeInstance != 0) )
    {
-      apx_portId_t requirePortId = 0;
-      void *portHandle = 0;
+      apx_portId_t stackPortIds[STACK_PORT_ID_BUFFER_SIZE];
+      apx_portId_t *requirePortIds = &stackPortIds[0];
+      int32_t maxNumPorts = STACK_PORT_ID_BUFFER_SIZE;
+      int32_t numPorts = 0;
       uint32_t endOffset = offset + len;
       apx_nodeInfo_t *nodeInfo = apx_nodeInstance_getNodeInfo(nodeInstance);
       assert(nodeInfo != 0);
       while(offset < endOffset)
       {
          apx_portDataProps_t *portDataProps;
-         requirePortId = apx_nodeInfo_findRequirePortIdFromByteOffset(nodeInfo, offset);
+         apx_portId_t requirePortId = apx_nodeInfo_findRequirePortIdFromByteOffset(nodeInfo, offset);
          if (requirePortId < 0)
          {
             printf("[APX-CLIENT] Write at invalid offset %d\n", (int) offset);
-            return;
+            break;
          }
          portDataProps = apx_nodeInfo_getRequirePortDataProps(nodeInfo, requirePortId);
          assert(portDataProps != 0);
-         portHandle = (void*) apx_nodeInstance_getRequirePortRef(nodeInstance, requirePortId);
-         assert(portHandle != 0);
-         apx_client_triggerRequirePortDataWriteEventOnListeners(self, nodeInstance, requirePortId, portHandle);
+         if (numPorts == maxNumPorts)
+         {
+            apx_portId_t *newPortIds = (apx_portId_t*) malloc(sizeof(apx_portId_t) * (size_t) maxNumPorts * 2u);
+            if (newPortIds != 0)
+            {
+               memcpy(newPortIds, requirePortIds, sizeof(apx_portId_t) * (size_t) numPorts);
+               if (requirePortIds != &stackPortIds[0])
+               {
+                  free(requirePortIds);
+               }
+               requirePortIds = newPortIds;
+               maxNumPorts *= 2;
+            }
+            else
+            {
+               //Out of memory, deliver what we have so far and continue with an empty buffer
+               apx_client_triggerRequirePortDataWriteEventOnListeners(self, nodeInstance, requirePortIds, numPorts);
+               numPorts = 0;
+            }
+         }
+         requirePortIds[numPorts++] = requirePortId;
+         (void) apx_nodeInstance_markRequirePortDirty(nodeInstance, requirePortId);
          offset += portDataProps->dataSize;
       }
+      if (numPorts > 0)
+      {
+         apx_client_triggerRequirePortDataWriteEventOnListeners(self, nodeInstance, requirePortIds, numPorts);
+      }
+      if (requirePortIds != &stackPortIds[0])
+      {
+         free(requirePortIds);
+      }
    }
 }
 
@@ -888,16 +1135,29 @@ static void apx_client_triggerDisconnectedEventOnListeners(apx_client_t *self, a
    SPINLOCK_LEAVE(self->eventListenerLock);
 }
 
-static void apx_client_triggerRequirePortDataWriteEventOnListeners(apx_client_t *self, apx_nodeInstance_t *nodeInstance, apx_portId_t requirePortId, void *portHandle)
+static void apx_client_triggerRequirePortDataWriteEventOnListeners(apx_client_t *self, apx_nodeInstance_t *nodeInstance, const apx_portId_t *requirePortIds, int32_t numPorts)
 {
    SPINLOCK_ENTER(self->eventListenerLock);
    adt_list_elem_t *iter = adt_list_iter_first(self->eventListeners);
    while(iter != 0)
    {
       apx_clientEventListener_t *listener = (apx_clientEventListener_t*) iter->pItem;
-      if ( (listener != 0) && (listener->requirePortWrite1 != 0))
+      if (listener != 0)
       {
-         listener->requirePortWrite1(listener->arg, nodeInstance, requirePortId, portHandle);
+         if (listener->requirePortsWrite1 != 0)
+         {
+            listener->requirePortsWrite1(listener->arg, nodeInstance, requirePortIds, numPorts);
+         }
+         else if (listener->requirePortWrite1 != 0)
+         {
+            int32_t i;
+            for (i = 0; i < numPorts; i++)
+            {
+               void *portHandle = (void*) apx_nodeInstance_getRequirePortRef(nodeInstance, requirePortIds[i]);
+               assert(portHandle != 0);
+               listener->requirePortWrite1(listener->arg, nodeInstance, requirePortIds[i], portHandle);
+            }
+         }
       }
       iter = adt_list_iter_next(iter);
    }
@@ -988,4 +1248,172 @@ static apx_error_t apx_client_verifySingleInstructionProgram(const adt_bytes_t *
    return APX_INVALID_ARGUMENT_ERROR;
 }
 
+/**
+ * Commits packed port data to the node.
+ * Outside of transactions this does not take self->lock, the node data has its own lock for the provide port data buffer.
+ */
+static apx_error_t apx_client_writeProvidePortData(apx_client_t *self, apx_nodeInstance_t *nodeInstance, const uint8_t *src, uint32_t offset, apx_size_t len)
+{
+   if (apx_atomic_load32(&self->inTransaction) != 0u)
+   {
+      apx_error_t retval;
+      SPINLOCK_ENTER(self->lock);
+      if (self->inTransaction != 0u)
+      {
+         adt_error_t rc = adt_ary_push_unique(&self->transactionNodes, (void*) nodeInstance);
+         if (rc == ADT_MEM_ERROR)
+         {
+            retval = APX_MEM_ERROR;
+         }
+         else
+         {
+            retval = apx_nodeInstance_writeProvidePortDataDeferred(nodeInstance, src, offset, len);
+         }
+         SPINLOCK_LEAVE(self->lock);
+         return retval;
+      }
+      //Transaction was committed while we were waiting for the lock
+      SPINLOCK_LEAVE(self->lock);
+   }
+   return apx_nodeInstance_writeProvidePortData(nodeInstance, src, offset, len);
+}
+
+/**
+ * Writes one packed element to a provide port. Queued ports append the element to the port queue, it is never
+ * deferred by transactions since each element is an event of its own. Several threads may write the same queued port,
+ * the elements of each thread are delivered in the order they were written. Other ports overwrite the port value.
+ * Dynamic array ports only write (and transmit) the array length and the used elements.
+ */
+static apx_error_t apx_client_writeProvidePortElement(apx_client_t *self, apx_portRef_t *portRef, const uint8_t *src, apx_size_t len)
+{
+   const apx_portDataProps_t *portDataProps = portRef->portDataProps;
+   if (apx_portDataProps_isQueued(portDataProps))
+   {
+      assert(len == portDataProps->elementSize);
+      return apx_nodeInstance_writeQueuedProvidePortData(portRef->nodeInstance, apx_portRef_getPortId(portRef), src);
+   }
+   if (portDataProps->isDynamicArray)
+   {
+      len = apx_portDataProps_getUsedDataSize(portDataProps, src, len);
+   }
+   return apx_client_writeProvidePortData(self, portRef->nodeInstance, src, portDataProps->offset, len);
+}
+
+/**
+ * Reads one packed element from a require port. Queued ports remove the oldest received element from the port queue
+ * and return APX_QUEUE_EMPTY_ERROR when there is none.
+ */
+static apx_error_t apx_client_readRequirePortElement(apx_portRef_t *portRef, uint8_t *dest, apx_size_t len)
+{
+   const apx_portDataProps_t *portDataProps = portRef->portDataProps;
+   if (apx_portDataProps_isQueued(portDataProps))
+   {
+      int32_t numElements;
+      assert(len == portDataProps->elementSize);
+      numElements = apx_nodeInstance_readQueuedRequirePortData(portRef->nodeInstance, apx_portRef_getPortId(portRef), dest, 1);
+      if (numElements < 0)
+      {
+         return APX_INVALID_ARGUMENT_ERROR;
+      }
+      return (numElements == 0)? APX_QUEUE_EMPTY_ERROR : APX_NO_ERROR;
+   }
+   return apx_nodeInstance_readRequirePortData(portRef->nodeInstance, dest, portDataProps->offset, len);
+}
+
+static apx_nodeInstance_t *apx_client_findNodeInstance(apx_client_t *self, const char *nodeName)
+{
+   if (nodeName == 0)
+   {
+      return apx_client_getLastAttachedNode(self);
+   }
+   return apx_nodeManager_find(self->nodeManager, nodeName);
+}
+
+static void *apx_client_getPortHandleInternal(apx_nodeInstance_t *nodeInstance, apx_nodeInfo_t *nodeInfo, const char *portName)
+{
+   apx_uniquePortId_t uniquePortId = apx_nodeInfo_findPortIdByName(nodeInfo, portName);
+   if (uniquePortId != APX_INVALID_PORT_ID)
+   {
+      apx_portId_t portId;
+      if ((uniquePortId & APX_PORT_ID_PROVIDE_PORT) != 0)
+      {
+         portId = uniquePortId & APX_PORT_ID_MASK;
+         return (void*) apx_nodeInstance_getProvidePortRef(nodeInstance, portId);
+      }
+      else
+      {
+         portId = uniquePortId;
+         return (void*) apx_nodeInstance_getRequirePortRef(nodeInstance, portId);
+      }
+   }
+   return (void*) 0;
+}
+
+/**
+ * Takes an idle VM out of the pool, creating a new one when all pooled VMs are in use.
+ * Each slot is claimed with a single atomic exchange so concurrent callers never share a VM.
+ */
+static apx_vm_t *apx_client_acquireVm(apx_client_t *self)
+{
+   int32_t i;
+   for (i = 0; i < APX_CLIENT_VM_POOL_SIZE; i++)
+   {
+      if (apx_atomic_loadPtr((void * volatile *) &self->vmPool[i]) != 0)
+      {
+         apx_vm_t *vm = (apx_vm_t*) apx_atomic_exchangePtr((void * volatile *) &self->vmPool[i], (void*) 0);
+         if (vm != 0)
+         {
+            return vm;
+         }
+      }
+   }
+   return apx_vm_new();
+}
+
+/**
+ * Returns a VM to the first empty pool slot. If the pool is full the VM is deleted.
+ */
+static void apx_client_releaseVm(apx_client_t *self, apx_vm_t *vm)
+{
+   int32_t i;
+   for (i = 0; i < APX_CLIENT_VM_POOL_SIZE; i++)
+   {
+      if (apx_atomic_compareExchangePtr((void * volatile *) &self->vmPool[i], (void*) 0, (void*) vm))
+      {
+         return;
+      }
+   }
+   apx_vm_delete(vm);
+}
 
+/**
+ * Fallback for ports where no copy plan could be created. The direction is given by the program type.
+ */
+static apx_error_t apx_client_execNativeProgram(apx_client_t *self, const adt_bytes_t *program, uint8_t *buffer, apx_size_t bufSize, void *nativeData, const apx_vmNativeLayout_t *layout)
+{
+   apx_error_t result;
+   apx_vm_t *vm;
+   if (program == 0)
+   {
+      return APX_INVALID_PROGRAM_ERROR;
+   }
+   vm = apx_client_acquireVm(self);
+   if (vm == 0)
+   {
+      return APX_MEM_ERROR;
+   }
+   result = apx_vm_selectProgram(vm, program);
+   if (result == APX_NO_ERROR)
+   {
+      if (apx_vm_getProgType(vm) == APX_VM_HEADER_PACK_PROG)
+      {
+         result = apx_vm_packNative(vm, buffer, bufSize, nativeData, layout);
+      }
+      else
+      {
+         result = apx_vm_unpackNative(vm, buffer, bufSize, nativeData, layout);
+      }
+   }
+   apx_client_releaseVm(self, vm);
+   return result;
+}
@@ -238,6 +238,26 @@ uint32_t apx_clientConnectionBase_getTotalBytesSent(apx_clientConnectionBase_t *
    return 0;
 }
 
+/**
+ * The client has no timer of its own. Applications that want latency statistics call this periodically.
+ */
+apx_error_t apx_clientConnectionBase_sendPing(apx_clientConnectionBase_t *self)
+{
+   if (self != 0)
+   {
+      return apx_connectionBase_sendPing(&self->base);
+   }
+   return APX_INVALID_ARGUMENT_ERROR;
+}
+
+void apx_clientConnectionBase_getLatencySummary(apx_clientConnectionBase_t *self, apx_latencySummary_t *summary)
+{
+   if (self != 0)
+   {
+      apx_connectionBase_getLatencySummary(&self->base, summary);
+   }
+}
+
 void* apx_clientConnectionBase_registerEventListener(apx_clientConnectionBase_t *self, apx_connectionEventListener_t *listener)
 {
    if (self != 0)
@@ -386,7 +406,13 @@ static void apx_clientConnectionBase_sendGreeting(apx_clientConnectionBase_t *se
    char *p = &greeting[0];
    strcpy(greeting, RMF_GREETING_START);
    p += strlen(greeting);
-   p += sprintf(p, "%s%d\n\n", RMF_NUMHEADER_FORMAT_HDR, numheaderFormat);
+   p += sprintf(p, "%s%d\n", RMF_NUMHEADER_FORMAT_HDR, numheaderFormat);
+   if (apx_connectionBase_getCompressionType(&self->base) == RMF_COMPRESSION_LZ4)
+   {
+      p += sprintf(p, "%s%s\n", RMF_COMPRESSION_HDR, RMF_COMPRESSION_LZ4_NAME);
+   }
+   p += sprintf(p, "%s1\n", RMF_FRAGMENT_INTERLEAVE_HDR);
+   p += sprintf(p, "\n");
    greetingLen = (uint32_t) (p-greeting);
    apx_connectionBase_getTransmitHandler(&self->base, &transmitHandler);
    if ( (transmitHandler.getSendBuffer != 0) && (transmitHandler.send != 0) )
@@ -257,6 +257,18 @@ apx_error_t apx_clientTestConnection_onFileInfoMsgReceived(apx_clientTestConnect
    return APX_INVALID_ARGUMENT_ERROR;
 }
 
+/**
+ * Processes one message (RMF address header followed by payload) as if it was received from the server.
+ */
+apx_error_t apx_clientTestConnection_onSerializedMsgReceived(apx_clientTestConnection_t *self, const uint8_t *msgBuf, int32_t msgLen)
+{
+   if (self != 0)
+   {
+      return apx_connectionBase_processMessage(&self->base.base, msgBuf, msgLen);
+   }
+   return APX_INVALID_ARGUMENT_ERROR;
+}
+
 
 //////////////////////////////////////////////////////////////////////////////
 // PRIVATE FUNCTIONS
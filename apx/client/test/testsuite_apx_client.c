@@ -28,10 +28,12 @@
 //////////////////////////////////////////////////////////////////////////////
 #include <string.h>
 #include "apx_client.h"
+#include "apx_clientInternal.h"
 #include "apx_clientEventListenerSpy.h"
 #include "CuTest.h"
 #include "pack.h"
 #include "apx_util.h"
+#include "apx_vm.h"
 #ifdef MEM_LEAK_CHECK
 #include "CMemLeak.h"
 #endif
@@ -119,10 +121,22 @@ static const char *m_apx_definition12 = "APX/1.2\n"
       "R\"String8\"a[8]:=\"\342\204\203\"\n" //degrees Centigrade symbol U+2103
       "\n";
 
+static const char *m_apx_definition13 = "APX/1.2\n"
+      "N\"TestNode13\"\n"
+      "P\"U8DynArray\"C[8*]\n"
+      "\n";
+
 
 #define UNSIGNED_ARRAY_LEN 3
 #define SIGNED_ARRAY_LEN   4
 
+typedef struct requirePortsWriteSpy_tag
+{
+   int32_t callCount;
+   int32_t numPorts;
+   apx_portId_t requirePortIds[8];
+} requirePortsWriteSpy_t;
+
 //////////////////////////////////////////////////////////////////////////////
 // PRIVATE FUNCTION PROTOTYPES
 //////////////////////////////////////////////////////////////////////////////
@@ -132,6 +146,10 @@ static void test_apx_client_buildNodeFromString2(CuTest* tc);
 static void test_apx_client_registerEventHandler(CuTest* tc);
 static void test_apx_client_portHandleWithoutDefiningNodeName1(CuTest* tc);
 static void test_apx_client_portHandleWithoutDefiningNodeName2(CuTest* tc);
+static void test_apx_client_getPortHandlesInBulk(CuTest* tc);
+static void test_apx_client_portDataVmIsReturnedToPool(CuTest* tc);
+static void test_apx_client_requirePortWritesAreBatchedAndPolled(CuTest* tc);
+static void requirePortsWriteSpy_onRequirePortsWrite(void *arg, apx_nodeInstance_t *nodeInstance, const apx_portId_t *requirePortIds, int32_t numPorts);
 
 static void test_apx_client_writePortData_dtl_u8(CuTest* tc);
 static void test_apx_client_readPortData_dtl_u8(CuTest* tc);
@@ -151,6 +169,8 @@ static void test_apx_client_readPortData_direct_u32(CuTest* tc);
 static void test_apx_client_writePortData_dtl_u8_fix_array(CuTest* tc);
 static void test_apx_client_readPortData_dtl_u8_fix_array(CuTest* tc);
 static void test_apx_client_writePortData_dtl_u16_fix_array(CuTest* tc);
+static void test_apx_client_writePortDataNative_u16_fix_array(CuTest* tc);
+static void test_apx_client_readPortDataNative_u16_fix_array(CuTest* tc);
 static void test_apx_client_readPortData_dtl_u16_fix_array(CuTest* tc);
 static void test_apx_client_writePortData_dtl_u32_fix_array(CuTest* tc);
 static void test_apx_client_readPortData_dtl_u32_fix_array(CuTest* tc);
@@ -176,6 +196,7 @@ static void test_apx_client_readPortData_dtl_string(CuTest* tc);
 static void test_apx_client_readPortData_dtl_string_unicode_init(CuTest* tc);
 static void test_apx_client_writePortData_dtl_string_inside_record(CuTest* tc);
 static void test_apx_client_readPortData_dtl_string_inside_record(CuTest* tc);
+static void test_apx_client_writePortData_dtl_u8_dyn_array(CuTest* tc);
 
 
 
@@ -196,6 +217,9 @@ CuSuite* testSuite_apx_client(void)
    SUITE_ADD_TEST(suite, test_apx_client_registerEventHandler);
    SUITE_ADD_TEST(suite, test_apx_client_portHandleWithoutDefiningNodeName1);
    SUITE_ADD_TEST(suite, test_apx_client_portHandleWithoutDefiningNodeName2);
+   SUITE_ADD_TEST(suite, test_apx_client_getPortHandlesInBulk);
+   SUITE_ADD_TEST(suite, test_apx_client_portDataVmIsReturnedToPool);
+   SUITE_ADD_TEST(suite, test_apx_client_requirePortWritesAreBatchedAndPolled);
    SUITE_ADD_TEST(suite, test_apx_client_writePortData_dtl_u8);
    SUITE_ADD_TEST(suite, test_apx_client_readPortData_dtl_u8);
    SUITE_ADD_TEST(suite, test_apx_client_writePortData_direct_u8);
@@ -211,6 +235,8 @@ CuSuite* testSuite_apx_client(void)
    SUITE_ADD_TEST(suite, test_apx_client_writePortData_dtl_u8_fix_array);
    SUITE_ADD_TEST(suite, test_apx_client_readPortData_dtl_u8_fix_array);
    SUITE_ADD_TEST(suite, test_apx_client_writePortData_dtl_u16_fix_array);
+   SUITE_ADD_TEST(suite, test_apx_client_writePortDataNative_u16_fix_array);
+   SUITE_ADD_TEST(suite, test_apx_client_readPortDataNative_u16_fix_array);
    SUITE_ADD_TEST(suite, test_apx_client_readPortData_dtl_u16_fix_array);
    SUITE_ADD_TEST(suite, test_apx_client_writePortData_dtl_u32_fix_array);
    SUITE_ADD_TEST(suite, test_apx_client_readPortData_dtl_u32_fix_array);
@@ -233,6 +259,7 @@ CuSuite* testSuite_apx_client(void)
    SUITE_ADD_TEST(suite, test_apx_client_readPortData_dtl_string_unicode_init);
    SUITE_ADD_TEST(suite, test_apx_client_writePortData_dtl_string_inside_record);
    SUITE_ADD_TEST(suite, test_apx_client_readPortData_dtl_string_inside_record);
+   SUITE_ADD_TEST(suite, test_apx_client_writePortData_dtl_u8_dyn_array);
 
 
 
@@ -340,6 +367,27 @@ static void test_apx_client_portHandleWithoutDefiningNodeName2(CuTest* tc)
 
 }
 
+static void test_apx_client_getPortHandlesInBulk(CuTest* tc)
+{
+   const char *portNames[4] = {"U32Value", "DoesNotExist", "U8Value", "U16Value"};
+   void *portHandles[4];
+   apx_nodeInstance_t *node;
+   apx_client_t *client = apx_client_new();
+   CuAssertIntEquals(tc, APX_NO_ERROR, apx_client_buildNode_cstr(client, m_apx_definition1));
+   node = apx_client_getLastAttachedNode(client);
+   CuAssertPtrNotNull(tc, node);
+
+   CuAssertIntEquals(tc, 3, apx_client_getPortHandles(client, NULL, portNames, portHandles, 4));
+   CuAssertPtrEquals(tc, apx_nodeInstance_getProvidePortRef(node, 2), portHandles[0]);
+   CuAssertPtrEquals(tc, NULL, portHandles[1]);
+   CuAssertPtrEquals(tc, apx_nodeInstance_getProvidePortRef(node, 0), portHandles[2]);
+   CuAssertPtrEquals(tc, apx_nodeInstance_getProvidePortRef(node, 1), portHandles[3]);
+   CuAssertIntEquals(tc, 0, apx_client_getPortHandles(client, "UnknownNode", portNames, portHandles, 4));
+   CuAssertPtrEquals(tc, NULL, portHandles[0]);
+
+   apx_client_delete(client);
+}
+
 static void test_apx_client_writePortData_dtl_u8(CuTest* tc)
 {
    const uint32_t offset = 0;
@@ -866,6 +914,67 @@ static void test_apx_client_readPortData_dtl_u8_fix_array(CuTest* tc)
 
 }
 
+typedef struct u16ArrayNative_tag
+{
+   uint8_t padding;
+   uint16_t values[UNSIGNED_ARRAY_LEN];
+} u16ArrayNative_t;
+
+static const apx_vmNativeElement_t m_u16ArrayNativeElements[1] = {APX_VM_NATIVE_ELEMENT(u16ArrayNative_t, values)};
+static const apx_vmNativeLayout_t m_u16ArrayNativeLayout = {&m_u16ArrayNativeElements[0], 1u};
+
+static void test_apx_client_writePortDataNative_u16_fix_array(CuTest* tc)
+{
+   const uint32_t offset = UINT8_SIZE*UNSIGNED_ARRAY_LEN;
+   apx_nodeInstance_t *nodeInstance;
+   void *u16ArrayHandle;
+   uint8_t rawData[UINT16_SIZE*UNSIGNED_ARRAY_LEN];
+   u16ArrayNative_t native = {0u, {0x0000, 0x1234, 0xFFFF}};
+   apx_client_t *client = apx_client_new();
+
+   CuAssertIntEquals(tc, APX_NO_ERROR, apx_client_buildNode_cstr(client, m_apx_definition3));
+   u16ArrayHandle = apx_client_getProvidePortHandleById(client, NULL, 1u);
+   CuAssertPtrNotNull(tc, u16ArrayHandle);
+   nodeInstance = apx_client_getLastAttachedNode(client);
+   CuAssertPtrNotNull(tc, apx_nodeInstance_getProvidePortPackPlan(nodeInstance, 1u));
+   CuAssertIntEquals(tc, APX_NO_ERROR, apx_client_writePortDataNative(client, u16ArrayHandle, &native, &m_u16ArrayNativeLayout));
+   CuAssertIntEquals(tc, APX_NO_ERROR, apx_nodeInstance_readProvidePortData(nodeInstance, &rawData[0], offset, UINT16_SIZE*UNSIGNED_ARRAY_LEN));
+   CuAssertUIntEquals(tc, 0x0000, unpackLE(&rawData[0], UINT16_SIZE));
+   CuAssertUIntEquals(tc, 0x1234, unpackLE(&rawData[UINT16_SIZE], UINT16_SIZE));
+   CuAssertUIntEquals(tc, 0xFFFF, unpackLE(&rawData[UINT16_SIZE*2], UINT16_SIZE));
+   CuAssertIntEquals(tc, APX_INVALID_PORT_HANDLE_ERROR, apx_client_readPortDataNative(client, u16ArrayHandle, &native, &m_u16ArrayNativeLayout));
+
+   apx_client_delete(client);
+}
+
+static void test_apx_client_readPortDataNative_u16_fix_array(CuTest* tc)
+{
+   const uint32_t offset = UINT8_SIZE*UNSIGNED_ARRAY_LEN;
+   apx_nodeInstance_t *nodeInstance;
+   void *u16ArrayHandle;
+   uint8_t rawData[UINT16_SIZE*UNSIGNED_ARRAY_LEN];
+   u16ArrayNative_t native;
+   apx_client_t *client = apx_client_new();
+
+   CuAssertIntEquals(tc, APX_NO_ERROR, apx_client_buildNode_cstr(client, m_apx_definition4));
+   u16ArrayHandle = apx_client_getRequirePortHandleById(client, NULL, 1u);
+   CuAssertPtrNotNull(tc, u16ArrayHandle);
+   nodeInstance = apx_client_getLastAttachedNode(client);
+   CuAssertPtrNotNull(tc, apx_nodeInstance_getRequirePortUnpackPlan(nodeInstance, 1u));
+   packLE(&rawData[0], 0x0000, UINT16_SIZE);
+   packLE(&rawData[UINT16_SIZE], 0x1234, UINT16_SIZE);
+   packLE(&rawData[UINT16_SIZE*2], 0xFFFF, UINT16_SIZE);
+   CuAssertIntEquals(tc, APX_NO_ERROR, apx_nodeInstance_writeRequirePortData(nodeInstance, &rawData[0], offset, UINT16_SIZE*UNSIGNED_ARRAY_LEN));
+   memset(&native, 0xAA, sizeof(native));
+   CuAssertIntEquals(tc, APX_NO_ERROR, apx_client_readPortDataNative(client, u16ArrayHandle, &native, &m_u16ArrayNativeLayout));
+   CuAssertUIntEquals(tc, 0xAA, native.padding);
+   CuAssertUIntEquals(tc, 0x0000, native.values[0]);
+   CuAssertUIntEquals(tc, 0x1234, native.values[1]);
+   CuAssertUIntEquals(tc, 0xFFFF, native.values[2]);
+
+   apx_client_delete(client);
+}
+
 static void test_apx_client_writePortData_dtl_u16_fix_array(CuTest* tc)
 {
    const uint32_t offset = UINT8_SIZE*UNSIGNED_ARRAY_LEN;
@@ -2011,3 +2120,133 @@ static void test_apx_client_readPortData_dtl_string_inside_record(CuTest* tc)
 
    apx_client_delete(client);
 }
+
+/**
+ * Only the array length and the used elements of a dynamic array are written, the rest of the port data is left as is
+ */
+static void test_apx_client_writePortData_dtl_u8_dyn_array(CuTest* tc)
+{
+   const uint32_t offset = 0u;
+   const uint8_t fillData[UINT8_SIZE + 8u] = {0xEE, 0xEE, 0xEE, 0xEE, 0xEE, 0xEE, 0xEE, 0xEE, 0xEE};
+   uint8_t rawData[UINT8_SIZE + 8u];
+   apx_nodeInstance_t *nodeInstance;
+   void *u8DynArrayHandle;
+   apx_client_t *client = apx_client_new();
+   dtl_av_t *av = dtl_av_new();
+   dtl_av_t *shortAv = dtl_av_new();
+
+   CuAssertIntEquals(tc, APX_NO_ERROR, apx_client_buildNode_cstr(client, m_apx_definition13));
+   u8DynArrayHandle = apx_client_getProvidePortHandleById(client, NULL, 0u);
+   CuAssertPtrNotNull(tc, u8DynArrayHandle);
+   nodeInstance = apx_client_getLastAttachedNode(client);
+   CuAssertIntEquals(tc, APX_NO_ERROR, apx_nodeInstance_writeProvidePortData(nodeInstance, &fillData[0], offset, sizeof(fillData)));
+
+   dtl_av_push(av, (dtl_dv_t*) dtl_sv_make_u32(0x11), false);
+   dtl_av_push(av, (dtl_dv_t*) dtl_sv_make_u32(0x22), false);
+   CuAssertIntEquals(tc, APX_NO_ERROR, apx_client_writePortData(client, u8DynArrayHandle, (dtl_dv_t*) av));
+   CuAssertIntEquals(tc, APX_NO_ERROR, apx_nodeInstance_readProvidePortData(nodeInstance, &rawData[0], offset, sizeof(rawData)));
+   CuAssertUIntEquals(tc, 2u, rawData[0]);
+   CuAssertUIntEquals(tc, 0x11, rawData[1]);
+   CuAssertUIntEquals(tc, 0x22, rawData[2]);
+   CuAssertIntEquals(tc, 0, memcmp(&fillData[3], &rawData[3], sizeof(rawData) - 3u));
+
+   //A shorter array only overwrites its own elements
+   dtl_av_push(shortAv, (dtl_dv_t*) dtl_sv_make_u32(0x33), false);
+   CuAssertIntEquals(tc, APX_NO_ERROR, apx_client_writePortData(client, u8DynArrayHandle, (dtl_dv_t*) shortAv));
+   CuAssertIntEquals(tc, APX_NO_ERROR, apx_nodeInstance_readProvidePortData(nodeInstance, &rawData[0], offset, sizeof(rawData)));
+   CuAssertUIntEquals(tc, 1u, rawData[0]);
+   CuAssertUIntEquals(tc, 0x33, rawData[1]);
+   CuAssertUIntEquals(tc, 0x22, rawData[2]);
+   CuAssertIntEquals(tc, 0, memcmp(&fillData[3], &rawData[3], sizeof(rawData) - 3u));
+
+   apx_client_delete(client);
+   dtl_dv_dec_ref((dtl_dv_t*) av);
+   dtl_dv_dec_ref((dtl_dv_t*) shortAv);
+}
+
+static void test_apx_client_portDataVmIsReturnedToPool(CuTest* tc)
+{
+   int32_t i;
+   void *U8ValueHandle;
+   uint8_t rawData[UINT8_SIZE] = {0};
+   apx_nodeInstance_t *nodeInstance;
+   apx_client_t *client = apx_client_new();
+   dtl_sv_t *sv = dtl_sv_new();
+   CuAssertIntEquals(tc, APX_NO_ERROR, apx_client_buildNode_cstr(client, m_apx_definition1));
+   U8ValueHandle = apx_client_getPortHandle(client, NULL, "U8Value");
+   nodeInstance = apx_client_getLastAttachedNode(client);
+   for (i = 0; i < APX_CLIENT_VM_POOL_SIZE; i++)
+   {
+      CuAssertPtrEquals(tc, NULL, client->vmPool[i]);
+   }
+
+   dtl_sv_set_u32(sv, 0x12);
+   CuAssertIntEquals(tc, APX_NO_ERROR, apx_client_writePortData(client, U8ValueHandle, (dtl_dv_t*) sv));
+   CuAssertPtrNotNull(tc, client->vmPool[0]);
+   dtl_sv_set_u32(sv, 0x34);
+   CuAssertIntEquals(tc, APX_NO_ERROR, apx_client_writePortData(client, U8ValueHandle, (dtl_dv_t*) sv));
+   CuAssertIntEquals(tc, APX_NO_ERROR, apx_nodeInstance_readProvidePortData(nodeInstance, &rawData[0], 0u, UINT8_SIZE));
+   CuAssertUIntEquals(tc, 0x34, rawData[0]);
+   //Sequential calls keep reusing the same VM
+   CuAssertPtrNotNull(tc, client->vmPool[0]);
+   for (i = 1; i < APX_CLIENT_VM_POOL_SIZE; i++)
+   {
+      CuAssertPtrEquals(tc, NULL, client->vmPool[i]);
+   }
+
+   apx_client_delete(client);
+   dtl_dec_ref((dtl_dv_t*) sv);
+}
+
+static void test_apx_client_requirePortWritesAreBatchedAndPolled(CuTest* tc)
+{
+   const uint8_t data[UINT8_SIZE + UINT16_SIZE + UINT32_SIZE] = {0};
+   apx_portId_t changedPorts[3];
+   requirePortsWriteSpy_t spy;
+   apx_clientEventListener_t listener;
+   apx_nodeInstance_t *nodeInstance;
+   apx_client_t *client = apx_client_new();
+   memset(&spy, 0, sizeof(spy));
+   memset(&listener, 0, sizeof(listener));
+   listener.arg = (void*) &spy;
+   listener.requirePortsWrite1 = requirePortsWriteSpy_onRequirePortsWrite;
+   CuAssertPtrNotNull(tc, apx_client_registerEventListener(client, &listener));
+   CuAssertIntEquals(tc, APX_NO_ERROR, apx_client_buildNode_cstr(client, m_apx_definition2));
+   nodeInstance = apx_client_getLastAttachedNode(client);
+   CuAssertIntEquals(tc, 0, apx_client_pollChangedRequirePorts(client, NULL, &changedPorts[0], 3));
+
+   //One write covering all three ports gives one callback
+   apx_clientInternal_requirePortDataWriteNotify(client, NULL, nodeInstance, 0u, &data[0], (uint32_t) sizeof(data));
+   CuAssertIntEquals(tc, 1, spy.callCount);
+   CuAssertIntEquals(tc, 3, spy.numPorts);
+   CuAssertIntEquals(tc, 0, spy.requirePortIds[0]);
+   CuAssertIntEquals(tc, 1, spy.requirePortIds[1]);
+   CuAssertIntEquals(tc, 2, spy.requirePortIds[2]);
+   apx_clientInternal_requirePortDataWriteNotify(client, NULL, nodeInstance, UINT8_SIZE, &data[0], UINT16_SIZE);
+   CuAssertIntEquals(tc, 2, spy.callCount);
+   CuAssertIntEquals(tc, 1, spy.numPorts);
+   CuAssertIntEquals(tc, 1, spy.requirePortIds[0]);
+
+   //U16Value was written twice but is only reported once
+   CuAssertIntEquals(tc, 1, apx_client_pollChangedRequirePorts(client, NULL, &changedPorts[0], 1));
+   CuAssertIntEquals(tc, 0, changedPorts[0]);
+   CuAssertIntEquals(tc, 2, apx_client_pollChangedRequirePorts(client, "TestNode2", &changedPorts[0], 3));
+   CuAssertIntEquals(tc, 1, changedPorts[0]);
+   CuAssertIntEquals(tc, 2, changedPorts[1]);
+   CuAssertIntEquals(tc, 0, apx_client_pollChangedRequirePorts(client, NULL, &changedPorts[0], 3));
+   CuAssertIntEquals(tc, -1, apx_client_pollChangedRequirePorts(client, "UnknownNode", &changedPorts[0], 3));
+
+   apx_client_delete(client);
+}
+
+static void requirePortsWriteSpy_onRequirePortsWrite(void *arg, apx_nodeInstance_t *nodeInstance, const apx_portId_t *requirePortIds, int32_t numPorts)
+{
+   requirePortsWriteSpy_t *spy = (requirePortsWriteSpy_t*) arg;
+   (void) nodeInstance;
+   spy->callCount++;
+   spy->numPorts = numPorts;
+   if (numPorts <= 8)
+   {
+      memcpy(&spy->requirePortIds[0], requirePortIds, sizeof(apx_portId_t) * (size_t) numPorts);
+   }
+}
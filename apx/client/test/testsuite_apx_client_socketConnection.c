@@ -88,7 +88,7 @@ static void test_apx_clientSocketConnection_sendGreetingOnConnect(CuTest* tc)
    testsocket_t *sock;
    uint32_t len;
    adt_str_t *str;
-   const char *expectedGreeting = "RMFP/1.0\nNumHeader-Format:32\n\n";
+   const char *expectedGreeting = "RMFP/1.0\nNumHeader-Format:32\nFragment-Interleave:1\n\n";
    const char *data;
    testsocket_spy_create();
    client = apx_client_new();
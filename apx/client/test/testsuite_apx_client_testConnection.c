@@ -32,6 +32,7 @@
 #include "apx_client.h"
 #include "apx_clientTestConnection.h"
 #include "apx_clientEventListenerSpy.h"
+#include "osmacro.h"
 #include "CuTest.h"
 #ifdef MEM_LEAK_CHECK
 #include "CMemLeak.h"
@@ -55,6 +56,26 @@ static const char *m_apx_definition3 = "APX/1.2\n"
       "R\"VehicleSpeed\"S:=65535\n"
       "\n";
 
+static const char *m_apx_definition4 = "APX/1.2\n"
+      "N\"TestNode4\"\n"
+      "P\"U8Value\"C:=0\n"
+      "P\"U16Value\"S:=0\n"
+      "P\"U32Value\"L:=0\n"
+      "P\"Padding\"C[16]\n"
+      "P\"LastValue\"C:=0\n"
+      "\n";
+
+#define NUM_CONCURRENT_TRANSACTIONS 2000
+#define DEFINITION4_PROVIDE_DATA_SIZE 24u
+
+typedef struct transactionWriter_tag
+{
+   apx_client_t *client;
+   void *U8ValueHandle;
+   void *U32ValueHandle;
+   apx_error_t lastError;
+} transactionWriter_t;
+
 
 //////////////////////////////////////////////////////////////////////////////
 // LOCAL FUNCTION PROTOTYPES
@@ -71,6 +92,9 @@ static void test_localFileInfoShallBeSentAfterHeaderAcknowledge(CuTest* tc);
 static void test_definitionFileIsSentWhenServerSendsFileOpenRequest(CuTest* tc);
 static void test_providePortDataFileIsSentWhenServerSendsFileOpenRequest(CuTest* tc);
 static void test_openFileRequestIsSentWhenServerSendsRequirePortDataFileInfo(CuTest* tc);
+static void test_transactionCoalescesProvidePortWrites(CuTest* tc);
+static void test_transactionCommitRacingWritesFromOtherThread(CuTest* tc);
+static THREAD_PROTO(transactionWriterThread, arg);
 
 //////////////////////////////////////////////////////////////////////////////
 // LOCAL VARIABLES
@@ -97,6 +121,8 @@ CuSuite* testSuite_apx_client_testConnection(void)
    SUITE_ADD_TEST(suite, test_definitionFileIsSentWhenServerSendsFileOpenRequest);
    SUITE_ADD_TEST(suite, test_providePortDataFileIsSentWhenServerSendsFileOpenRequest);
    SUITE_ADD_TEST(suite, test_openFileRequestIsSentWhenServerSendsRequirePortDataFileInfo);
+   SUITE_ADD_TEST(suite, test_transactionCoalescesProvidePortWrites);
+   SUITE_ADD_TEST(suite, test_transactionCommitRacingWritesFromOtherThread);
 
 
    return suite;
@@ -196,7 +222,7 @@ static void test_headerSentOnConnect(CuTest* tc)
 {
    apx_clientTestConnection_t *connection;
    apx_client_t *client;
-   const char *expectedGreeting = "RMFP/1.0\nNumHeader-Format:32\n\n";
+   const char *expectedGreeting = "RMFP/1.0\nNumHeader-Format:32\nFragment-Interleave:1\n\n";
    adt_bytearray_t *expectedMsg = adt_bytearray_make((const uint8_t*) expectedGreeting, strlen(expectedGreeting), 0u);
    client = apx_client_new();
 
@@ -442,3 +468,196 @@ static void test_openFileRequestIsSentWhenServerSendsRequirePortDataFileInfo(CuT
    apx_client_delete(client);
 
 }
+
+static void test_transactionCoalescesProvidePortWrites(CuTest* tc)
+{
+   apx_clientTestConnection_t *connection;
+   apx_client_t *client;
+   rmf_cmdOpenFile_t fileOpenCmd;
+   adt_bytearray_t *transmittedMsg;
+   const uint8_t *msgData;
+   uint32_t msgSize;
+   void *U8ValueHandle;
+   void *U16ValueHandle;
+   void *U32ValueHandle;
+   void *LastValueHandle;
+
+   //Init
+   client = apx_client_new();
+   CuAssertPtrNotNull(tc, client);
+   CuAssertIntEquals(tc, APX_NO_ERROR, apx_client_buildNode_cstr(client, m_apx_definition4));
+   U8ValueHandle = apx_client_getPortHandle(client, NULL, "U8Value");
+   U16ValueHandle = apx_client_getPortHandle(client, NULL, "U16Value");
+   U32ValueHandle = apx_client_getPortHandle(client, NULL, "U32Value");
+   LastValueHandle = apx_client_getPortHandle(client, NULL, "LastValue");
+   connection = apx_clientTestConnection_new();
+   CuAssertPtrNotNull(tc, connection);
+   apx_client_attachConnection(client, (apx_clientConnectionBase_t*) connection);
+   apx_clientTestConnection_connect(connection);
+   fileOpenCmd.address = 0u;
+   CuAssertIntEquals(tc, APX_NO_ERROR, apx_clientTestConnection_onFileOpenMsgReceived(connection, &fileOpenCmd));
+   apx_client_run(client);
+   apx_clientTestConnection_clearTransmitLog(connection);
+
+   //Writes inside transaction are not transmitted until commit
+   CuAssertIntEquals(tc, APX_INVALID_STATE_ERROR, apx_client_commitTransaction(client));
+   CuAssertIntEquals(tc, APX_NO_ERROR, apx_client_beginTransaction(client));
+   CuAssertTrue(tc, apx_client_isTransactionActive(client));
+   CuAssertIntEquals(tc, APX_INVALID_STATE_ERROR, apx_client_beginTransaction(client));
+   CuAssertIntEquals(tc, APX_NO_ERROR, apx_client_writePortData_u32(client, U32ValueHandle, 0x12345678));
+   CuAssertIntEquals(tc, APX_NO_ERROR, apx_client_writePortData_u8(client, U8ValueHandle, 0x01));
+   CuAssertIntEquals(tc, APX_NO_ERROR, apx_client_writePortData_u16(client, U16ValueHandle, 0x0302));
+   CuAssertIntEquals(tc, APX_NO_ERROR, apx_client_writePortData_u8(client, LastValueHandle, 0x09));
+   CuAssertIntEquals(tc, APX_NO_ERROR, apx_client_writePortData_u8(client, LastValueHandle, 0x0A));
+   apx_client_run(client);
+   CuAssertIntEquals(tc, 0, apx_clientTestConnection_getTransmitLogLen(connection));
+
+   //Commit merges the three adjacent ports into one write, LastValue is too far away to be merged
+   CuAssertIntEquals(tc, APX_NO_ERROR, apx_client_commitTransaction(client));
+   CuAssertTrue(tc, !apx_client_isTransactionActive(client));
+   apx_client_run(client);
+   CuAssertIntEquals(tc, 2, apx_clientTestConnection_getTransmitLogLen(connection));
+
+   transmittedMsg = apx_clientTestConnection_getTransmitLogMsg(connection, 0);
+   CuAssertPtrNotNull(tc, transmittedMsg);
+   msgData = (const uint8_t*) adt_bytearray_data(transmittedMsg);
+   msgSize = adt_bytearray_length(transmittedMsg);
+   CuAssertUIntEquals(tc, RMF_LOW_ADDRESS_SIZE + UINT8_SIZE + UINT16_SIZE + UINT32_SIZE, msgSize);
+   CuAssertUIntEquals(tc, 0u, rmf_unpackAddress(msgData, RMF_LOW_ADDRESS_SIZE));
+   CuAssertUIntEquals(tc, 0x01, msgData[RMF_LOW_ADDRESS_SIZE]);
+   CuAssertUIntEquals(tc, 0x0302, unpackLE(&msgData[RMF_LOW_ADDRESS_SIZE + 1], UINT16_SIZE));
+   CuAssertUIntEquals(tc, 0x12345678, unpackLE(&msgData[RMF_LOW_ADDRESS_SIZE + 3], UINT32_SIZE));
+
+   transmittedMsg = apx_clientTestConnection_getTransmitLogMsg(connection, 1);
+   CuAssertPtrNotNull(tc, transmittedMsg);
+   msgData = (const uint8_t*) adt_bytearray_data(transmittedMsg);
+   msgSize = adt_bytearray_length(transmittedMsg);
+   CuAssertUIntEquals(tc, RMF_LOW_ADDRESS_SIZE + UINT8_SIZE, msgSize);
+   CuAssertUIntEquals(tc, 23u, rmf_unpackAddress(msgData, RMF_LOW_ADDRESS_SIZE));
+   CuAssertUIntEquals(tc, 0x0A, msgData[RMF_LOW_ADDRESS_SIZE]);
+
+   //Writes outside of a transaction are transmitted immediately
+   apx_clientTestConnection_clearTransmitLog(connection);
+   CuAssertIntEquals(tc, APX_NO_ERROR, apx_client_writePortData_u8(client, U8ValueHandle, 0x02));
+   apx_client_run(client);
+   CuAssertIntEquals(tc, 1, apx_clientTestConnection_getTransmitLogLen(connection));
+
+   apx_client_delete(client);
+}
+
+/**
+ * Two threads run transactions on the same node. A transaction started by one thread writes while the other thread
+ * is still flushing its commit. Replaying everything transmitted must yield the same data as the local buffer.
+ */
+static void test_transactionCommitRacingWritesFromOtherThread(CuTest* tc)
+{
+   apx_clientTestConnection_t *connection;
+   apx_client_t *client;
+   apx_nodeInstance_t *nodeInstance;
+   rmf_cmdOpenFile_t fileOpenCmd;
+   transactionWriter_t writer;
+   THREAD_T thread;
+   void *U16ValueHandle;
+   void *LastValueHandle;
+   uint8_t remoteData[DEFINITION4_PROVIDE_DATA_SIZE];
+   uint8_t localData[DEFINITION4_PROVIDE_DATA_SIZE];
+   int32_t numMsg;
+   int32_t i;
+#ifdef _WIN32
+   unsigned int threadId;
+#endif
+
+   //Init
+   client = apx_client_new();
+   CuAssertPtrNotNull(tc, client);
+   CuAssertIntEquals(tc, APX_NO_ERROR, apx_client_buildNode_cstr(client, m_apx_definition4));
+   nodeInstance = apx_client_getLastAttachedNode(client);
+   CuAssertPtrNotNull(tc, nodeInstance);
+   writer.client = client;
+   writer.U8ValueHandle = apx_client_getPortHandle(client, NULL, "U8Value");
+   writer.U32ValueHandle = apx_client_getPortHandle(client, NULL, "U32Value");
+   writer.lastError = APX_NO_ERROR;
+   U16ValueHandle = apx_client_getPortHandle(client, NULL, "U16Value");
+   LastValueHandle = apx_client_getPortHandle(client, NULL, "LastValue");
+   connection = apx_clientTestConnection_new();
+   CuAssertPtrNotNull(tc, connection);
+   apx_client_attachConnection(client, (apx_clientConnectionBase_t*) connection);
+   apx_clientTestConnection_connect(connection);
+   fileOpenCmd.address = 0u;
+   CuAssertIntEquals(tc, APX_NO_ERROR, apx_clientTestConnection_onFileOpenMsgReceived(connection, &fileOpenCmd));
+   apx_client_run(client);
+   apx_clientTestConnection_clearTransmitLog(connection);
+   memset(remoteData, 0, sizeof(remoteData));
+
+   //Run transactions from two threads
+#ifdef _WIN32
+   THREAD_CREATE(thread, transactionWriterThread, &writer, threadId);
+#else
+   CuAssertIntEquals(tc, 0, THREAD_CREATE(thread, transactionWriterThread, &writer));
+#endif
+   for (i = 1; i <= NUM_CONCURRENT_TRANSACTIONS; i++)
+   {
+      while (apx_client_beginTransaction(client) != APX_NO_ERROR)
+      {
+         SLEEP(0);
+      }
+      CuAssertIntEquals(tc, APX_NO_ERROR, apx_client_writePortData_u16(client, U16ValueHandle, (uint16_t) i));
+      CuAssertIntEquals(tc, APX_NO_ERROR, apx_client_writePortData_u8(client, LastValueHandle, (uint8_t) i));
+      CuAssertIntEquals(tc, APX_NO_ERROR, apx_client_commitTransaction(client));
+   }
+   THREAD_JOIN(thread);
+   CuAssertIntEquals(tc, APX_NO_ERROR, writer.lastError);
+   CuAssertTrue(tc, !apx_nodeInstance_hasPendingProvidePortData(nodeInstance));
+
+   //Verify that no write got lost
+   apx_client_run(client);
+   numMsg = apx_clientTestConnection_getTransmitLogLen(connection);
+   CuAssertTrue(tc, numMsg > 0);
+   for (i = 0; i < numMsg; i++)
+   {
+      adt_bytearray_t *transmittedMsg = apx_clientTestConnection_getTransmitLogMsg(connection, i);
+      const uint8_t *msgData = (const uint8_t*) adt_bytearray_data(transmittedMsg);
+      uint32_t msgSize = adt_bytearray_length(transmittedMsg);
+      uint32_t address;
+      CuAssertTrue(tc, msgSize > RMF_LOW_ADDRESS_SIZE);
+      address = rmf_unpackAddress(msgData, RMF_LOW_ADDRESS_SIZE);
+      CuAssertTrue(tc, address + msgSize - RMF_LOW_ADDRESS_SIZE <= DEFINITION4_PROVIDE_DATA_SIZE);
+      memcpy(&remoteData[address], &msgData[RMF_LOW_ADDRESS_SIZE], msgSize - RMF_LOW_ADDRESS_SIZE);
+   }
+   CuAssertIntEquals(tc, APX_NO_ERROR, apx_nodeData_readProvidePortData(apx_nodeInstance_getNodeData(nodeInstance), localData, 0u, DEFINITION4_PROVIDE_DATA_SIZE));
+   CuAssertIntEquals(tc, NUM_CONCURRENT_TRANSACTIONS & 0xFF, localData[0]);
+   CuAssertUIntEquals(tc, NUM_CONCURRENT_TRANSACTIONS, unpackLE(&localData[1], UINT16_SIZE));
+   CuAssertUIntEquals(tc, NUM_CONCURRENT_TRANSACTIONS, unpackLE(&localData[3], UINT32_SIZE));
+   CuAssertIntEquals(tc, NUM_CONCURRENT_TRANSACTIONS & 0xFF, localData[23]);
+   CuAssertTrue(tc, memcmp(remoteData, localData, DEFINITION4_PROVIDE_DATA_SIZE) == 0);
+
+   apx_client_delete(client);
+}
+
+static THREAD_PROTO(transactionWriterThread, arg)
+{
+   transactionWriter_t *writer = (transactionWriter_t*) arg;
+   uint32_t i;
+   for (i = 1u; i <= NUM_CONCURRENT_TRANSACTIONS; i++)
+   {
+      apx_error_t rc;
+      while (apx_client_beginTransaction(writer->client) != APX_NO_ERROR)
+      {
+         SLEEP(0);
+      }
+      rc = apx_client_writePortData_u32(writer->client, writer->U32ValueHandle, i);
+      if (rc == APX_NO_ERROR)
+      {
+         rc = apx_client_writePortData_u8(writer->client, writer->U8ValueHandle, (uint8_t) i);
+      }
+      if (rc == APX_NO_ERROR)
+      {
+         rc = apx_client_commitTransaction(writer->client);
+      }
+      if (rc != APX_NO_ERROR)
+      {
+         writer->lastError = rc;
+      }
+   }
+   THREAD_RETURN(0);
+}
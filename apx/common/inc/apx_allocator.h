@@ -6,6 +6,7 @@
 //////////////////////////////////////////////////////////////////////////////
 #include "apx_types.h"
 #include "apx_error.h"
+#include "apx_cfg.h"
 
 #ifdef _WIN32
 # ifndef WIN32_LEAN_AND_MEAN
@@ -14,42 +15,51 @@
 #include <Windows.h>
 #else
 #include <pthread.h>
-#include <semaphore.h>
 #endif
 #include "osmacro.h"
-#include "adt_ringbuf.h"
-#include "soa.h"
 
 //////////////////////////////////////////////////////////////////////////////
 // CONSTANTS AND DATA TYPES
 //////////////////////////////////////////////////////////////////////////////
+#define APX_ALLOCATOR_MIN_BLOCK_SIZE 8u
+#define APX_ALLOCATOR_MAX_BLOCK_SIZE (APX_ALLOCATOR_MIN_BLOCK_SIZE << (APX_ALLOCATOR_NUM_SIZE_CLASSES - 1))
 
-/**
- * this is a simple small object allocator with built-in garbage collector thread
- */
-typedef struct apx_allocator_tag
+typedef struct apx_allocatorBlock_tag
 {
-   THREAD_T workerThread; //local worker thread
-   SPINLOCK_T lock;  //variable lock
-   SEMAPHORE_T semaphore; //thread semaphore
+   struct apx_allocatorBlock_tag *next;
+} apx_allocatorBlock_t;
 
-   //data object, all read/write accesses to these must be protected by the lock variable above
-   adt_rbfh_t messages; //pending cleanup messages (ringbuffer)
-   bool isRunning; //when false it's time do shut down
-   bool workerThreadValid; //true if workerThread is a valid variable
-   soa_t soa;
+typedef struct apx_allocatorSizeClass_tag
+{
+   apx_allocatorBlock_t *freeList; //blocks ready for reuse by apx_allocator_alloc (protected by lock)
+   void * volatile returnedBlocks; //lock-free stack of blocks released by apx_allocator_free. Swapped into freeList when it runs empty
+   uint8_t *slabNext; //next unused byte in the most recent slab of this size class
+   uint8_t *slabEnd;
+   uint32_t blockSize;
+} apx_allocatorSizeClass_t;
 
-#ifdef _MSC_VER
-   unsigned int threadId;
-#endif
-}apx_allocator_t;
+typedef struct apx_allocatorStats_tag
+{
+   uint32_t numAllocs; //number of successful calls to apx_allocator_alloc
+   uint32_t numCacheHits; //allocations served by a block that had been freed earlier
+   uint32_t numLargeAllocs; //allocations larger than APX_ALLOCATOR_MAX_BLOCK_SIZE (served by malloc)
+   uint32_t liveBytes; //bytes currently handed out (sum of requested sizes)
+   uint32_t highWaterMark; //largest value liveBytes has had
+   uint32_t reservedBytes; //bytes reserved by slabs
+} apx_allocatorStats_t;
 
-//this data structure is used as elements in the ring buffer
-typedef struct rbf_data_tag
+/**
+ * Size-class slab allocator. Memory is carved from slabs owned by the allocator and never returned to the system before destruction.
+ * apx_allocator_free can be called from any thread and never blocks or wakes up other threads.
+ */
+typedef struct apx_allocator_tag
 {
-   uint8_t *ptr;
-   uint32_t size;
-}rbf_data_t;
+   SPINLOCK_T lock; //protects freeLists, slabs and stats (except liveBytes)
+   apx_allocatorSizeClass_t sizeClasses[APX_ALLOCATOR_NUM_SIZE_CLASSES];
+   apx_allocatorBlock_t *slabs; //linked list of all slabs, released in apx_allocator_destroy
+   volatile uint32_t liveBytes; //updated without taking lock
+   apx_allocatorStats_t stats;
+}apx_allocator_t;
 
 //////////////////////////////////////////////////////////////////////////////
 // GLOBAL VARIABLES
@@ -59,17 +69,11 @@ typedef struct rbf_data_tag
 //////////////////////////////////////////////////////////////////////////////
 // GLOBAL FUNCTION PROTOTYPES
 //////////////////////////////////////////////////////////////////////////////
-apx_error_t apx_allocator_create(apx_allocator_t *self, uint16_t maxPendingMessages);
+apx_error_t apx_allocator_create(apx_allocator_t *self);
 void apx_allocator_destroy(apx_allocator_t *self);
-
-void apx_allocator_start(apx_allocator_t *self);
-void apx_allocator_stop(apx_allocator_t *self);
 uint8_t *apx_allocator_alloc(apx_allocator_t *self, size_t size);
 void apx_allocator_free(apx_allocator_t *self, uint8_t *ptr, size_t size);
-bool apx_allocator_isRunning(apx_allocator_t *self);
-#ifdef UNIT_TEST
-void apx_allocator_processAll(apx_allocator_t *self);
-int32_t apx_allocator_numPendingMessages(apx_allocator_t *self);
-#endif
+void apx_allocator_getStats(apx_allocator_t *self, apx_allocatorStats_t *stats);
+void apx_allocatorStats_add(apx_allocatorStats_t *self, const apx_allocatorStats_t *other);
 
 #endif //APX_ALLOCATOR_H
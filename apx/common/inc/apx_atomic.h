@@ -0,0 +1,54 @@
+/*****************************************************************************
+* \file      apx_atomic.h
+* \author    Conny Gustafsson
+* \date      2026-10-18
+* \brief     Portable atomic operations
+*
+* Copyright (c) 2026 Conny Gustafsson
+* Permission is hereby granted, free of charge, to any person obtaining a copy of
+* this software and associated documentation files (the "Software"), to deal in
+* the Software without restriction, including without limitation the rights to
+* use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+* the Software, and to permit persons to whom the Software is furnished to do so,
+* subject to the following conditions:
+
+* The above copyright notice and this permission notice shall be included in all
+* copies or substantial portions of the Software.
+
+* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+* IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+* FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+* COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+* IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+* CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+*
+******************************************************************************/
+#ifndef APX_ATOMIC_H
+#define APX_ATOMIC_H
+
+//////////////////////////////////////////////////////////////////////////////
+// INCLUDES
+//////////////////////////////////////////////////////////////////////////////
+#include "apx_types.h"
+
+//////////////////////////////////////////////////////////////////////////////
+// PUBLIC FUNCTION PROTOTYPES
+//////////////////////////////////////////////////////////////////////////////
+/**
+ * Loads have acquire semantics, stores have release semantics. Exchange, compare-exchange and fence are sequentially consistent.
+ */
+uint32_t apx_atomic_load32(volatile uint32_t *ptr);
+void apx_atomic_store32(volatile uint32_t *ptr, uint32_t value);
+uint32_t apx_atomic_exchange32(volatile uint32_t *ptr, uint32_t value);
+bool apx_atomic_compareExchange32(volatile uint32_t *ptr, uint32_t expected, uint32_t desired);
+uint32_t apx_atomic_add32(volatile uint32_t *ptr, uint32_t value);
+uint32_t apx_atomic_sub32(volatile uint32_t *ptr, uint32_t value);
+uint32_t apx_atomic_or32(volatile uint32_t *ptr, uint32_t value); //returns the previous value
+uint64_t apx_atomic_load64(volatile uint64_t *ptr);
+uint64_t apx_atomic_add64(volatile uint64_t *ptr, uint64_t value);
+void *apx_atomic_loadPtr(void * volatile *ptr);
+void *apx_atomic_exchangePtr(void * volatile *ptr, void *value);
+bool apx_atomic_compareExchangePtr(void * volatile *ptr, void *expected, void *desired);
+void apx_atomic_fence(void);
+
+#endif //APX_ATOMIC_H
@@ -30,6 +30,7 @@
 // INCLUDES
 //////////////////////////////////////////////////////////////////////////////
 #include "apx_types.h"
+#include "apx_cfg.h"
 #include "apx_portDataProps.h"
 #include "apx_error.h"
 
@@ -37,10 +38,18 @@
 //////////////////////////////////////////////////////////////////////////////
 // PUBLIC CONSTANTS AND DATA TYPES
 //////////////////////////////////////////////////////////////////////////////
+/**
+ * Maps a byte offset in a port data file back to the port ID owning that byte.
+ * Only the start offset of each port is stored (sorted ascending). A coarse block table, one entry per
+ * 2^APX_BYTE_PORT_MAP_BLOCK_SHIFT bytes, narrows the range before the final binary search.
+ */
 typedef struct apx_bytePortMap_tag
 {
-   apx_portId_t *mapData;
-   int32_t mapLen;
+   apx_offset_t *startOffsets; //startOffsets[portId] is the first byte of that port
+   apx_portId_t *blockFirstPort; //blockFirstPort[i] is the port containing byte (i << APX_BYTE_PORT_MAP_BLOCK_SHIFT)
+   apx_portCount_t numPorts;
+   int32_t numBlocks;
+   int32_t mapLen; //total number of bytes covered by the map
 }apx_bytePortMap_t;
 
 //////////////////////////////////////////////////////////////////////////////
@@ -53,5 +62,6 @@ void apx_bytePortMap_delete(apx_bytePortMap_t *self);
 
 apx_portId_t apx_bytePortMap_lookup(const apx_bytePortMap_t *self, int32_t offset);
 apx_size_t apx_bytePortMap_length(const apx_bytePortMap_t *self);
+apx_size_t apx_bytePortMap_memoryUsage(const apx_bytePortMap_t *self);
 
 #endif //APX_BYTE_PORT_MAP_H
@@ -0,0 +1,69 @@
+/*****************************************************************************
+* \file      apx_byteRangeSet.h
+* \author    Conny Gustafsson
+* \date      2026-10-18
+* \brief     Sorted set of non-overlapping byte ranges
+*
+* Copyright (c) 2026 Conny Gustafsson
+* Permission is hereby granted, free of charge, to any person obtaining a copy of
+* this software and associated documentation files (the "Software"), to deal in
+* the Software without restriction, including without limitation the rights to
+* use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+* the Software, and to permit persons to whom the Software is furnished to do so,
+* subject to the following conditions:
+
+* The above copyright notice and this permission notice shall be included in all
+* copies or substantial portions of the Software.
+
+* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+* IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+* FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+* COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+* IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+* CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+*
+******************************************************************************/
+#ifndef APX_BYTE_RANGE_SET_H
+#define APX_BYTE_RANGE_SET_H
+
+//////////////////////////////////////////////////////////////////////////////
+// INCLUDES
+//////////////////////////////////////////////////////////////////////////////
+#include "apx_types.h"
+#include "apx_error.h"
+
+//////////////////////////////////////////////////////////////////////////////
+// PUBLIC CONSTANTS AND DATA TYPES
+//////////////////////////////////////////////////////////////////////////////
+typedef struct apx_byteRange_tag
+{
+   uint32_t offset;
+   uint32_t len;
+} apx_byteRange_t;
+
+/**
+ * Ranges are kept sorted by offset. Ranges that overlap, touch or are separated by at most mergeGap bytes
+ * are merged into a single range when inserted.
+ */
+typedef struct apx_byteRangeSet_tag
+{
+   apx_byteRange_t *ranges; //strong reference
+   uint32_t numRanges;
+   uint32_t allocLen;
+   uint32_t mergeGap;
+} apx_byteRangeSet_t;
+
+//////////////////////////////////////////////////////////////////////////////
+// PUBLIC FUNCTION PROTOTYPES
+//////////////////////////////////////////////////////////////////////////////
+void apx_byteRangeSet_create(apx_byteRangeSet_t *self, uint32_t mergeGap);
+void apx_byteRangeSet_destroy(apx_byteRangeSet_t *self);
+apx_byteRangeSet_t *apx_byteRangeSet_new(uint32_t mergeGap);
+void apx_byteRangeSet_delete(apx_byteRangeSet_t *self);
+void apx_byteRangeSet_vdelete(void *arg);
+apx_error_t apx_byteRangeSet_insert(apx_byteRangeSet_t *self, uint32_t offset, uint32_t len);
+void apx_byteRangeSet_clear(apx_byteRangeSet_t *self);
+uint32_t apx_byteRangeSet_length(const apx_byteRangeSet_t *self);
+const apx_byteRange_t *apx_byteRangeSet_get(const apx_byteRangeSet_t *self, uint32_t index);
+
+#endif //APX_BYTE_RANGE_SET_H
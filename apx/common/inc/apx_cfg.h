@@ -55,4 +55,98 @@
 
 #define APX_SMALL_DATA_SIZE  8u
 
+#ifndef APX_BYTE_PORT_MAP_BLOCK_SHIFT
+# define APX_BYTE_PORT_MAP_BLOCK_SHIFT 8u //apx_bytePortMap keeps one first-port entry per 2^N bytes of port data
+#endif
+
+#ifndef APX_PROVIDE_PORT_DATA_MERGE_GAP
+# define APX_PROVIDE_PORT_DATA_MERGE_GAP 8u //Dirty ranges this close to each other are sent as a single write during transaction commit
+#endif
+
+#ifndef APX_CONFLATION_ENABLE_DEFAULT
+# define APX_CONFLATION_ENABLE_DEFAULT 0 //Server connections send the latest value of dirty require ports instead of queueing every routed write
+#endif
+
+#ifndef APX_WORKER_MAX_BATCH_SIZE
+# define APX_WORKER_MAX_BATCH_SIZE 16384 //Max number of bytes the fileManager worker stages before transmitting them in one call (0 disables batching)
+#endif
+
+#ifndef APX_WORKER_MAX_BATCH_MESSAGES
+# define APX_WORKER_MAX_BATCH_MESSAGES 64 //Max number of messages the fileManager worker stages before transmitting them in one call
+#endif
+
+#ifndef APX_WORKER_GATHER_THRESHOLD
+# define APX_WORKER_GATHER_THRESHOLD 512 //Shared payloads of at least this many bytes are transmitted straight from the payload (scatter-gather) instead of being copied into the send buffer
+#endif
+
+#ifndef APX_WORKER_FRAGMENT_SIZE
+# define APX_WORKER_FRAGMENT_SIZE 8192 //Towards peers which announced Fragment-Interleave in their greeting, file writes larger than this are transmitted in fragments of this size, interleaved with other messages (0 disables fragmentation)
+#endif
+
+#ifndef APX_WORKER_MAX_BULK_TRANSFERS
+# define APX_WORKER_MAX_BULK_TRANSFERS 8 //Max number of fragmented writes the fileManager worker has in progress. When exceeded, the oldest one is completed in one go
+#endif
+
+#ifndef APX_PORT_QUEUE_DEPTH_FACTOR
+# define APX_PORT_QUEUE_DEPTH_FACTOR 4 //Each queued port Q[N] buffers up to N times this value elements while earlier transfers are in flight
+#endif
+
+#ifndef APX_WORKER_BATCH_DEADLINE_MS
+# define APX_WORKER_BATCH_DEADLINE_MS 0 //Max time (ms) the fileManager worker waits for more messages before transmitting a partially filled batch
+#endif
+
+#ifndef APX_EXECUTOR_MAX_WORK_PER_TASK
+# define APX_EXECUTOR_MAX_WORK_PER_TASK 32 //Max number of events (or messages) a connection processes on an executor thread before yielding to other connections
+#endif
+
+#ifndef APX_CLIENT_VM_POOL_SIZE
+# define APX_CLIENT_VM_POOL_SIZE 16 //Max number of idle VMs kept by apx_client_t for concurrent port reads and writes
+#endif
+
+#ifndef APX_LATENCY_STATS_WINDOW_SIZE
+# define APX_LATENCY_STATS_WINDOW_SIZE 128u //Number of round-trip samples each connection keeps for min/avg/p99/max
+#endif
+
+#ifndef APX_SERVER_PING_INTERVAL_MS
+# define APX_SERVER_PING_INTERVAL_MS 1000 //How often the server pings its connections to measure round-trip latency (0 disables)
+#endif
+
+#ifndef APX_SERVER_DEFAULT_WORKER_THREADS
+# define APX_SERVER_DEFAULT_WORKER_THREADS 4
+#endif
+
+#ifndef APX_SERVER_COMPILE_POOL_MAX_PENDING
+# define APX_SERVER_COMPILE_POOL_MAX_PENDING 256 //Definitions queued for compilation beyond this limit are compiled on the connection thread instead
+#endif
+
+#ifndef APX_SERVER_NODE_INFO_CACHE_SIZE
+# define APX_SERVER_NODE_INFO_CACHE_SIZE 256 //Max number of distinct node definitions the server keeps compiled for reconnecting nodes, unused ones are evicted LRU (0 disables the cache)
+#endif
+
+#ifndef APX_ALLOCATOR_NUM_SIZE_CLASSES
+# define APX_ALLOCATOR_NUM_SIZE_CLASSES 8 //Size classes are 8, 16, 32, ... bytes. Larger allocations go directly to malloc
+#endif
+
+#ifndef APX_ALLOCATOR_SLAB_SIZE
+# define APX_ALLOCATOR_SLAB_SIZE 16384 //Number of bytes the connection allocator reserves from malloc each time a size class runs empty
+#endif
+
+#ifndef APX_CLIENT_DEFINITION_COMPRESSION_DEFAULT
+# define APX_CLIENT_DEFINITION_COMPRESSION_DEFAULT 0 //Set to 1 to make clients send LZ4 compressed definition files (requires a server which understands RMF_FILE_TYPE_COMPRESSED_FIXED)
+#endif
+
+#ifndef APX_DEFINITION_COMPRESSION_MIN_SIZE
+# define APX_DEFINITION_COMPRESSION_MIN_SIZE 256 //Definition files smaller than this are always sent uncompressed
+#endif
+
+#ifndef APX_HOST_LITTLE_ENDIAN
+# if defined(__BYTE_ORDER__) && defined(__ORDER_LITTLE_ENDIAN__)
+#  define APX_HOST_LITTLE_ENDIAN (__BYTE_ORDER__ == __ORDER_LITTLE_ENDIAN__)
+# elif defined(_WIN32)
+#  define APX_HOST_LITTLE_ENDIAN 1
+# else
+#  define APX_HOST_LITTLE_ENDIAN 0 //unknown byte order, always convert
+# endif
+#endif
+
 #endif //APX_CFG_H
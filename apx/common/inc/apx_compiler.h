@@ -36,6 +36,7 @@
 #include "adt_bytearray.h"
 #include "adt_stack.h"
 #include "apx_vmdefs.h"
+#include "apx_copyPlan.h"
 
 //////////////////////////////////////////////////////////////////////////////
 // PUBLIC CONSTANTS AND DATA TYPES
@@ -71,6 +72,7 @@ apx_error_t apx_compiler_compileUnpackDataElement(apx_compiler_t *self, apx_data
 apx_error_t apx_compiler_encodePackProgramHeader(apx_compiler_t *self, uint8_t majorVersion, uint8_t minorVersion, apx_size_t dataSize);
 apx_error_t apx_compiler_encodeUnpackProgramHeader(apx_compiler_t *self, uint8_t majorVersion, uint8_t minorVersion, apx_size_t dataSize);
 uint8_t apx_compiler_encodeInstruction(uint8_t opCode, uint8_t variant, uint8_t flags);
+apx_error_t apx_compiler_lowerToCopyPlan(const adt_bytes_t *program, apx_copyPlan_t **plan);
 
 
 #endif //APX_COMPILER_H
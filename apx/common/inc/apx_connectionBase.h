@@ -44,6 +44,7 @@
 #include "apx_nodeManager.h"
 #include "apx_eventLoop.h"
 #include "apx_allocator.h"
+#include "apx_latencyStats.h"
 #include "osmacro.h"
 
 //////////////////////////////////////////////////////////////////////////////
@@ -91,14 +92,37 @@ typedef struct apx_connectionBase_tag
    bool workerThreadValid;
    apx_eventHandlerFunc_t *eventHandler;
    void *eventHandlerArg;
+   apx_executor_t *executor; //weak reference. When set, events and transmits run on the executor instead of connection-owned threads
    uint32_t totalBytesReceived;
    uint32_t totalBytesSent;
+   uint32_t totalMessagesReceived; //number of RMF messages processed. Only written by the receiving thread.
    apx_mode_t mode;
+   bool isConflationEnabled; //Server mode only. Routed require port data is sent as dirty ranges (last value wins) instead of one message per write
+   uint16_t compressionType; //Definition file compression announced in the greeting (RMF_COMPRESSION_NONE or RMF_COMPRESSION_LZ4)
+   SPINLOCK_T latencyLock; //protects latencyStats and nextPingSequence
+   apx_latencyStats_t latencyStats; //round-trip times measured with RMF ping
+   uint32_t nextPingSequence;
 #ifdef _WIN32
    unsigned int threadId;
 #endif
 } apx_connectionBase_t;
 
+/**
+ * Point-in-time copy of the counters of a connection. Each counter is owned by a single thread and is only aggregated when requested.
+ */
+typedef struct apx_connectionStats_tag
+{
+   uint32_t connectionId;
+   int32_t numNodes;
+   uint32_t totalBytesReceived;
+   uint32_t totalMessagesReceived;
+   uint16_t numPendingWorkerMessages;
+   uint16_t numPendingEvents;
+   apx_fileManagerWorkerStats_t workerStats; //transmit side counters
+   apx_allocatorStats_t allocatorStats;
+   apx_latencySummary_t latency;
+} apx_connectionStats_t;
+
 
 //////////////////////////////////////////////////////////////////////////////
 // PUBLIC FUNCTION PROTOTYPES
@@ -110,6 +134,12 @@ void apx_connectionBase_delete(apx_connectionBase_t *self);
 void apx_connectionBase_vdelete(void *arg);
 apx_fileManager_t *apx_connectionBase_getFileManager(apx_connectionBase_t *self);
 void apx_connectionBase_setEventHandler(apx_connectionBase_t *self, apx_eventHandlerFunc_t *eventHandler, void *eventHandlerArg);
+void apx_connectionBase_setExecutor(apx_connectionBase_t *self, apx_executor_t *executor);
+void apx_connectionBase_setConflationEnabled(apx_connectionBase_t *self, bool enabled);
+bool apx_connectionBase_isConflationEnabled(const apx_connectionBase_t *self);
+void apx_connectionBase_setCompressionType(apx_connectionBase_t *self, uint16_t compressionType);
+uint16_t apx_connectionBase_getCompressionType(const apx_connectionBase_t *self);
+void apx_connectionBase_setFragmentInterleaveEnabled(apx_connectionBase_t *self, bool enabled);
 void apx_connectionBase_start(apx_connectionBase_t *self);
 void apx_connectionBase_stop(apx_connectionBase_t *self);
 void apx_connectionBase_close(apx_connectionBase_t *self);
@@ -117,21 +147,30 @@ void apx_connectionBase_attachNodeInstance(apx_connectionBase_t *self, apx_nodeI
 apx_error_t apx_connectionBase_processMessage(apx_connectionBase_t *self, const uint8_t *msgBuf, int32_t msgLen);
 uint8_t *apx_connectionBase_alloc(apx_connectionBase_t *self, size_t size);
 void apx_connectionBase_free(apx_connectionBase_t *self, uint8_t *ptr, size_t size);
+void apx_connectionBase_getAllocatorStats(apx_connectionBase_t *self, apx_allocatorStats_t *stats);
+apx_error_t apx_connectionBase_sendPing(apx_connectionBase_t *self);
+void apx_connectionBase_getLatencySummary(apx_connectionBase_t *self, apx_latencySummary_t *summary);
+void apx_connectionBase_getStats(apx_connectionBase_t *self, apx_connectionStats_t *stats);
 
 
 /*** Internal Callback API ***/
 
 //Callbacks triggered due to events happening remotely
 apx_error_t apx_connectionBase_fileInfoNotify(apx_connectionBase_t *self, const rmf_fileInfo_t *remoteFileInfo);
+apx_error_t apx_connectionBase_compressedFileInfoNotify(apx_connectionBase_t *self, const rmf_fileInfo_t *remoteFileInfo, const rmf_cmdCompressInfo_t *compressInfo);
 apx_error_t apx_connectionBase_fileOpenNotify(apx_connectionBase_t *self, uint32_t address);
 apx_error_t apx_connectionBase_fileWriteNotify(apx_connectionBase_t *self, apx_file_t *file, uint32_t offset, const uint8_t *data, uint32_t len);
 apx_error_t apx_connectionBase_nodeInstanceFileWriteNotify(apx_connectionBase_t *self, apx_nodeInstance_t *nodeInstance, apx_fileType_t fileType, uint32_t offset, const uint8_t *data, uint32_t len);
 apx_error_t apx_connectionBase_nodeInstanceFileOpenNotify(apx_connectionBase_t *self, apx_nodeInstance_t *nodeInstance, apx_fileType_t fileType);
+void apx_connectionBase_pingResponseNotify(apx_connectionBase_t *self, const rmf_cmdPing_t *cmdPing);
 
 
 //Callbacks triggered due to events happening locally
 apx_error_t apx_connectionBase_updateProvidePortDataDirect(apx_connectionBase_t *self, apx_file_t *file, const uint8_t *data, uint32_t offset, uint32_t len);
 apx_error_t apx_connectionBase_updateRequirePortDataDirect(apx_connectionBase_t *self, apx_file_t *file, const uint8_t *data, uint32_t offset, uint32_t len);
+apx_error_t apx_connectionBase_updateRequirePortDataPayload(apx_connectionBase_t *self, apx_file_t *file, apx_payload_t *payload, uint32_t payloadOffset, uint32_t offset, uint32_t len);
+apx_error_t apx_connectionBase_updateRequirePortDataConflated(apx_connectionBase_t *self, apx_file_t *file, apx_fileConflationHandler_t *handler);
+apx_error_t apx_connectionBase_updatePortDataQueued(apx_connectionBase_t *self, apx_file_t *file, uint32_t offset, uint32_t maxLen, apx_fileQueueHandler_t *handler);
 void apx_connectionBase_disconnectNotify(apx_connectionBase_t *self);
 void apx_connectionBase_triggerRemoteFileHeaderCompleteEvent(apx_connectionBase_t *self);
 void apx_connectionBase_portConnectorChangeCreateNotify(apx_connectionBase_t *self, apx_nodeInstance_t *nodeInstance, apx_portType_t portType);
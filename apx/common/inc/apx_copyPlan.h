@@ -0,0 +1,77 @@
+/*****************************************************************************
+* \file      apx_copyPlan.h
+* \author    Conny Gustafsson
+* \date      2026-10-18
+* \brief     Copy plan lowered from flat APX VM programs
+*
+* Copyright (c) 2026 Conny Gustafsson
+* Permission is hereby granted, free of charge, to any person obtaining a copy of
+* this software and associated documentation files (the "Software"), to deal in
+* the Software without restriction, including without limitation the rights to
+* use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+* the Software, and to permit persons to whom the Software is furnished to do so,
+* subject to the following conditions:
+
+* The above copyright notice and this permission notice shall be included in all
+* copies or substantial portions of the Software.
+
+* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+* IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+* FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+* COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+* IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+* CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+*
+******************************************************************************/
+#ifndef APX_COPY_PLAN_H
+#define APX_COPY_PLAN_H
+
+//////////////////////////////////////////////////////////////////////////////
+// INCLUDES
+//////////////////////////////////////////////////////////////////////////////
+#include "apx_types.h"
+#include "apx_error.h"
+
+//////////////////////////////////////////////////////////////////////////////
+// PUBLIC CONSTANTS AND DATA TYPES
+//////////////////////////////////////////////////////////////////////////////
+#define APX_COPY_RUN_FLAG_NONE       0x00u
+#define APX_COPY_RUN_FLAG_MEMCPY     0x01u //Native and packed representation are identical (width is 1 or host is little endian)
+#define APX_COPY_RUN_FLAG_STRING     0x02u //Fixed-length string, bytes after the null-terminator are zero-filled when packing
+
+/**
+ * One run copies count elements of width bytes between the packed port data (at dataOffset)
+ * and the native struct member described by element number elementIndex in the native layout.
+ */
+typedef struct apx_copyRun_tag
+{
+   apx_size_t dataOffset; //byte offset in packed port data
+   uint32_t elementIndex; //index into apx_vmNativeLayout_t
+   uint32_t count; //number of elements
+   uint8_t width; //element width in bytes (1, 2 or 4)
+   uint8_t flags;
+} apx_copyRun_t;
+
+typedef struct apx_copyPlan_tag
+{
+   apx_copyRun_t *runs; //strong reference
+   uint32_t numRuns;
+   uint32_t allocLen;
+   apx_size_t dataSize; //Total size of packed data
+   uint8_t progType; //APX_VM_HEADER_PACK_PROG or APX_VM_HEADER_UNPACK_PROG
+} apx_copyPlan_t;
+
+//////////////////////////////////////////////////////////////////////////////
+// PUBLIC FUNCTION PROTOTYPES
+//////////////////////////////////////////////////////////////////////////////
+void apx_copyPlan_create(apx_copyPlan_t *self, uint8_t progType);
+void apx_copyPlan_destroy(apx_copyPlan_t *self);
+apx_copyPlan_t *apx_copyPlan_new(uint8_t progType);
+void apx_copyPlan_delete(apx_copyPlan_t *self);
+void apx_copyPlan_vdelete(void *arg);
+apx_error_t apx_copyPlan_appendRun(apx_copyPlan_t *self, apx_size_t dataOffset, uint8_t width, uint32_t count, uint8_t flags);
+uint32_t apx_copyPlan_length(const apx_copyPlan_t *self);
+const apx_copyRun_t *apx_copyPlan_getRun(const apx_copyPlan_t *self, uint32_t index);
+apx_size_t apx_copyPlan_getDataSize(const apx_copyPlan_t *self);
+
+#endif //APX_COPY_PLAN_H
@@ -71,6 +71,8 @@
 #define APX_NOT_CONNECTED_ERROR         58
 #define APX_INVALID_NAME_ERROR          59
 #define APX_INVALID_PORT_HANDLE_ERROR   60
+#define APX_QUEUE_EMPTY_ERROR           61
+#define APX_DECOMPRESSION_ERROR         62
 
 #define RMF_APX_NO_ERROR                    500
 #define RMF_APX_INVALID_ARGUMENT_ERROR      (RMF_APX_NO_ERROR+APX_INVALID_ARGUMENT_ERROR)
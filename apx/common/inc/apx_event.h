@@ -78,6 +78,8 @@ typedef struct apx_event_tag
 #define APX_EVENT_NODE_DEFINITION_WRITE    18 //evFlag: APX_EVENT_FLAG_REMOTE_ADDRESS?, evData1:*arg, evData2:*nodeData, evData4: offset, evData5: len
 #define APX_EVENT_NODE_INDATA_WRITE        19 //evFlag: APX_EVENT_FLAG_REMOTE_ADDRESS?, evData1:*arg, evData2:*nodeData, evData4: offset, evData5: len
 #define APX_EVENT_NODE_OUTATA_WRITE        20 //evFlag: APX_EVENT_FLAG_REMOTE_ADDRESS?, evData1:*arg, evData2:*nodeData, evData4: offset, evData5: len
+#define APX_EVENT_NODE_COMPILE_COMPLETE    21 //evData1: apx_compileJob_t *job
+#define APX_EVENT_CONNECTION_LATENCY       22 //evData1: connectionBase_t *connection, evData4: rtt (microseconds) of the latest ping
 
 
 
@@ -98,5 +100,6 @@ void apx_event_create_clientDisconnected(apx_event_t *event, struct apx_clientCo
 void apx_event_fillRemoteFileHeaderComplete(apx_event_t *event, struct apx_connectionBase_tag *connection);
 void apx_event_fillFileCreatedEvent(apx_event_t *event, struct apx_connectionBase_tag *connection, struct apx_fileInfo_tag *fileInfo);
 void apx_event_createHeaderAccepted(apx_event_t *event, struct apx_connectionBase_tag *connection);
+void apx_event_fillConnectionLatency(apx_event_t *event, struct apx_connectionBase_tag *connection, uint32_t rttUs);
 
 #endif //APX_EVENT_H
@@ -40,6 +40,7 @@ struct apx_fileInfo_tag;
 struct apx_file_tag;
 struct apx_connectionBase_tag;
 struct apx_nodeInstance_tag;
+struct apx_latencySummary_tag;
 
 
 
@@ -52,6 +53,7 @@ typedef void (apx_eventListener2_fileEvent_t)(void *arg, struct apx_connectionBa
 typedef void (*remoteFilePreWriteFuncType1)(void *arg, struct apx_file_tag *remoteFile, uint32_t offset, const uint8_t *data, uint32_t len, bool moreBit);
 typedef void (*remoteFileWriteFuncType1)(void *arg, struct apx_file_tag *remoteFile, uint32_t offset, const uint8_t *data, uint32_t len);
 typedef void (clientRequirePortWriteFuncType1)(void *arg, struct apx_nodeInstance_tag *nodeInstance, apx_portId_t requirePortId, void *portHandle);
+typedef void (clientRequirePortsWriteFuncType1)(void *arg, struct apx_nodeInstance_tag *nodeInstance, const apx_portId_t *requirePortIds, int32_t numPorts);
 
 typedef struct apx_clientEventListener_tag
 {
@@ -59,6 +61,7 @@ typedef struct apx_clientEventListener_tag
    void (*clientConnect1)(void *arg, struct apx_clientConnectionBase_tag *clientConnection);
    void (*clientDisconnect1)(void *arg, struct apx_clientConnectionBase_tag *clientConnection);
    clientRequirePortWriteFuncType1 *requirePortWrite1;
+   clientRequirePortsWriteFuncType1 *requirePortsWrite1; //Called once per received write with all require ports it updated. Listeners setting this do not receive requirePortWrite1.
 } apx_clientEventListener_t;
 
 typedef struct apx_serverEventListener_tag
@@ -66,6 +69,7 @@ typedef struct apx_serverEventListener_tag
    void *arg;
    void (*serverConnect1)(void *arg, struct apx_serverConnectionBase_tag *connection);
    void (*serverDisconnect1)(void *arg, struct apx_serverConnectionBase_tag *connection);
+   void (*connectionLatency1)(void *arg, struct apx_serverConnectionBase_tag *connection, const struct apx_latencySummary_tag *summary); //called each time a ping response arrives
 } apx_serverEventListener_t;
 
 typedef struct apx_connectionEventListener_tag
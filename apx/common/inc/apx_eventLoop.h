@@ -33,6 +33,8 @@
 #include "apx_error.h"
 #include "apx_eventListener.h"
 #include "apx_event.h"
+#include "apx_executor.h"
+#include "apx_mpscQueue.h"
 #ifdef _WIN32
 # ifndef WIN32_LEAN_AND_MEAN
 # define WIN32_LEAN_AND_MEAN
@@ -43,20 +45,27 @@
 # include <semaphore.h>
 #endif
 #include "osmacro.h"
-#include "adt_ringbuf.h"
 
 
 //////////////////////////////////////////////////////////////////////////////
 // PUBLIC CONSTANTS AND DATA TYPES
 //////////////////////////////////////////////////////////////////////////////
 //forward declarations
+struct apx_eventOverflowNode_tag;
 
 typedef struct apx_eventLoop_tag
 {
-   SPINLOCK_T lock;
-   SEMAPHORE_T semaphore;
-   adt_rbfh_t pendingEvents;
+   SPINLOCK_T lock; //protects exitFlag and the executor fields
+   SPINLOCK_T overflowLock; //protects overflowHead and overflowTail
+   apx_mpscQueue_t pendingEvents; //events are appended by any thread and removed by the thread running the loop
+   struct apx_eventOverflowNode_tag *overflowHead; //events appended while pendingEvents was full, processed after pendingEvents
+   struct apx_eventOverflowNode_tag *overflowTail;
+   volatile uint32_t numOverflowEvents; //while non-zero all new events go to the overflow list to keep them in order
    bool exitFlag;
+   apx_executor_t * volatile executor; //weak reference. When set, events are processed by executor threads instead of apx_eventLoop_run
+   apx_executorTask_t executorTask;
+   apx_eventHandlerFunc_t *eventHandler; //used in executor mode
+   void *eventHandlerArg;
 } apx_eventLoop_t;
 
 
@@ -73,6 +82,8 @@ void apx_eventLoop_append(apx_eventLoop_t *self, apx_event_t *event);
 void apx_eventLoop_run(apx_eventLoop_t *self, apx_eventHandlerFunc_t *eventHandler, void *eventHandlerArg);
 void apx_eventLoop_exit(apx_eventLoop_t *self);
 uint16_t apx_eventLoop_numPendingEvents(apx_eventLoop_t *self);
+void apx_eventLoop_attachExecutor(apx_eventLoop_t *self, apx_executor_t *executor, apx_eventHandlerFunc_t *eventHandler, void *eventHandlerArg);
+void apx_eventLoop_detachExecutor(apx_eventLoop_t *self);
 #ifdef UNIT_TEST
 void apx_eventLoop_runAll(apx_eventLoop_t *self, apx_eventHandlerFunc_t *eventHandler, void *eventHandlerArg);
 #endif
@@ -0,0 +1,106 @@
+/*****************************************************************************
+* \file      apx_executor.h
+* \author    Conny Gustafsson
+* \date      2026-10-18
+* \brief     Fixed-size worker pool that runs connection tasks
+*
+* Copyright (c) 2026 Conny Gustafsson
+* Permission is hereby granted, free of charge, to any person obtaining a copy of
+* this software and associated documentation files (the "Software"), to deal in
+* the Software without restriction, including without limitation the rights to
+* use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+* the Software, and to permit persons to whom the Software is furnished to do so,
+* subject to the following conditions:
+
+* The above copyright notice and this permission notice shall be included in all
+* copies or substantial portions of the Software.
+
+* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+* IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+* FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+* COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+* IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+* CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+*
+******************************************************************************/
+#ifndef APX_EXECUTOR_H
+#define APX_EXECUTOR_H
+
+//////////////////////////////////////////////////////////////////////////////
+// INCLUDES
+//////////////////////////////////////////////////////////////////////////////
+#ifdef _WIN32
+# ifndef WIN32_LEAN_AND_MEAN
+# define WIN32_LEAN_AND_MEAN
+# endif
+# include <Windows.h>
+#else
+# include <pthread.h>
+# include <semaphore.h>
+#endif
+#include "apx_types.h"
+#include "apx_error.h"
+#include "osmacro.h"
+
+//////////////////////////////////////////////////////////////////////////////
+// PUBLIC CONSTANTS AND DATA TYPES
+//////////////////////////////////////////////////////////////////////////////
+typedef bool (apx_executorTaskFunc)(void *arg); //Runs a slice of work. Returns true when more work is pending.
+
+/**
+ * A task is run by at most one executor thread at a time. Calling apx_executor_schedule on a task that is already
+ * queued has no effect, calling it while the task is running makes the task run again once it finishes.
+ */
+typedef struct apx_executorTask_tag
+{
+   apx_executorTaskFunc *run;
+   void *arg;
+   struct apx_executorTask_tag *next; //link in the executor run queue
+   bool isQueued;
+   bool isRunning;
+   bool isRescheduled; //schedule was requested while task was running
+   bool isCancelled;
+#ifdef _WIN32
+   DWORD runningThreadId;
+#else
+   pthread_t runningThread;
+#endif
+} apx_executorTask_t;
+
+typedef struct apx_executor_tag
+{
+   SPINLOCK_T lock; //protects the run queue and the state of all tasks
+   SEMAPHORE_T semaphore; //posted once for every task added to the run queue
+   apx_executorTask_t *queueHead;
+   apx_executorTask_t *queueTail;
+   THREAD_T *threads;
+   uint32_t numThreads;
+   uint32_t numThreadsStarted;
+   bool exitFlag;
+   uint32_t numTaskRuns; //number of times any task has been run (statistics)
+#ifdef _WIN32
+   unsigned int *threadIds;
+#endif
+} apx_executor_t;
+
+//////////////////////////////////////////////////////////////////////////////
+// PUBLIC FUNCTION PROTOTYPES
+//////////////////////////////////////////////////////////////////////////////
+apx_error_t apx_executor_create(apx_executor_t *self, uint32_t numThreads);
+void apx_executor_destroy(apx_executor_t *self);
+apx_executor_t *apx_executor_new(uint32_t numThreads);
+void apx_executor_delete(apx_executor_t *self);
+apx_error_t apx_executor_start(apx_executor_t *self);
+void apx_executor_stop(apx_executor_t *self);
+uint32_t apx_executor_getNumThreads(const apx_executor_t *self);
+uint32_t apx_executor_getNumTaskRuns(apx_executor_t *self);
+void apx_executor_schedule(apx_executor_t *self, apx_executorTask_t *task);
+void apx_executor_cancel(apx_executor_t *self, apx_executorTask_t *task);
+
+void apx_executorTask_create(apx_executorTask_t *self, apx_executorTaskFunc *run, void *arg);
+
+#ifdef UNIT_TEST
+bool apx_executor_run(apx_executor_t *self);
+#endif
+
+#endif //APX_EXECUTOR_H
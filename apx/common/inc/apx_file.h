@@ -54,10 +54,14 @@
 //forward declarations
 struct apx_file_tag;
 struct apx_fileManager_tag;
+struct apx_byteRangeSet_tag;
 
 typedef apx_error_t (apx_file_open_notify_func)(void *arg, struct apx_file_tag *file);
 typedef apx_error_t (apx_file_write_notify_func)(void *arg, struct apx_file_tag *file, uint32_t offset, const uint8_t *src, uint32_t len);
 typedef apx_error_t (apx_file_read_const_data_func)(void *arg, struct apx_file_tag *file, uint32_t offset, uint8_t *dest, uint32_t len);
+typedef apx_error_t (apx_file_take_dirty_ranges_func)(void *arg, struct apx_file_tag *file, struct apx_byteRangeSet_tag *ranges);
+typedef apx_error_t (apx_file_mark_dirty_func)(void *arg, struct apx_file_tag *file, uint32_t offset, uint32_t len);
+typedef uint32_t (apx_file_begin_transfer_func)(void *arg, struct apx_file_tag *file, uint32_t offset);
 
 typedef struct apx_fileNotificationHandler_tag
 {
@@ -66,6 +70,21 @@ typedef struct apx_fileNotificationHandler_tag
    apx_file_write_notify_func *writeNotify; //Notifies file owner that his file has just been written to (use with remote files)
 } apx_fileNotificationHandler_t;
 
+typedef struct apx_fileConflationHandler_tag
+{
+   void *arg;
+   apx_file_take_dirty_ranges_func *takeDirtyRanges; //Moves all ranges written since the previous call into ranges
+   apx_file_read_const_data_func *readData; //Reads the current content of a dirty range
+   apx_file_mark_dirty_func *markDirty; //Gives back a taken range that could not be sent, it must be part of a later transfer (optional)
+} apx_fileConflationHandler_t;
+
+typedef struct apx_fileQueueHandler_tag
+{
+   void *arg;
+   apx_file_begin_transfer_func *beginTransfer; //Returns number of bytes the queued port at offset wants to send right now (0 if nothing)
+   apx_file_read_const_data_func *readData; //Moves queued elements (preceded by element count) into dest
+} apx_fileQueueHandler_t;
+
 typedef struct apx_file_tag
 {
    bool isFileOpen;
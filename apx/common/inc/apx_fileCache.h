@@ -2,7 +2,7 @@
 * \file      apx_fileCache.h
 * \author    Conny Gustafsson
 * \date      2018-08-03
-* \brief     Handles locally cached .apx files
+* \brief     Cache of built node definitions, keyed by SHA-256 digest of the .apx file
 *
 * Copyright (c) 2018 Conny Gustafsson
 * Permission is hereby granted, free of charge, to any person obtaining a copy of
@@ -29,10 +29,53 @@
 //////////////////////////////////////////////////////////////////////////////
 // INCLUDES
 //////////////////////////////////////////////////////////////////////////////
+#ifdef _WIN32
+# ifndef WIN32_LEAN_AND_MEAN
+# define WIN32_LEAN_AND_MEAN
+# endif
+# include <Windows.h>
+#else
+# include <pthread.h>
+#endif
+#include "apx_types.h"
+#include "apx_error.h"
+#include "apx_nodeInfo.h"
+#include "apx_sha256.h"
+#include "adt_hash.h"
+#include "osmacro.h"
 
 //////////////////////////////////////////////////////////////////////////////
 // PUBLIC CONSTANTS AND DATA TYPES
 //////////////////////////////////////////////////////////////////////////////
+typedef struct apx_fileCacheStats_tag
+{
+   uint32_t numHits; //number of lookups that found an already built nodeInfo
+   uint32_t numMisses; //number of lookups where the definition had to be parsed and compiled
+   uint32_t numEntries; //number of nodeInfo objects currently held by the cache
+   uint32_t numEvictions; //number of entries removed to make room for new ones
+} apx_fileCacheStats_t;
+
+typedef struct apx_fileCacheEntry_tag
+{
+   apx_nodeInfo_t *nodeInfo; //strong reference, NULL when the slot is unused
+   uint32_t lastUsed; //value of useCounter when the entry was last inserted or found
+   uint8_t digest[APX_SHA256_DIGEST_SIZE];
+} apx_fileCacheEntry_t;
+
+/**
+ * Maps the SHA-256 digest of an APX definition file to the apx_nodeInfo_t built from it.
+ * Cached nodeInfo objects are immutable and shared (reference counted) between all node instances using them.
+ * When the cache is full, the least recently used entry that is not referenced outside the cache is evicted.
+ */
+typedef struct apx_fileCache_tag
+{
+   adt_hash_t nodeInfoMap; //key: hex string of digest, value: weak reference to entry in entries
+   apx_fileCacheEntry_t *entries; //strong reference, array of maxEntries slots
+   uint32_t maxEntries;
+   uint32_t useCounter;
+   apx_fileCacheStats_t stats; //protected by lock
+   MUTEX_T lock;
+} apx_fileCache_t;
 
 //////////////////////////////////////////////////////////////////////////////
 // PUBLIC VARIABLES
@@ -41,6 +84,13 @@
 //////////////////////////////////////////////////////////////////////////////
 // PUBLIC FUNCTION PROTOTYPES
 //////////////////////////////////////////////////////////////////////////////
+void apx_fileCache_create(apx_fileCache_t *self, uint32_t maxEntries);
+void apx_fileCache_destroy(apx_fileCache_t *self);
+apx_fileCache_t *apx_fileCache_new(uint32_t maxEntries);
+void apx_fileCache_delete(apx_fileCache_t *self);
+apx_nodeInfo_t *apx_fileCache_findNodeInfo(apx_fileCache_t *self, const uint8_t *digest);
+apx_error_t apx_fileCache_insertNodeInfo(apx_fileCache_t *self, const uint8_t *digest, apx_nodeInfo_t *nodeInfo);
+void apx_fileCache_getStats(apx_fileCache_t *self, apx_fileCacheStats_t *stats);
 
 
 #endif //APX_FILE_CACHE_H
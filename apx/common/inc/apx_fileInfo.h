@@ -40,7 +40,9 @@ typedef struct apx_fileInfo_tag
 {
    uint32_t address;
    uint32_t addressWithoutFlags;
-   uint32_t length;
+   uint32_t length; //number of bytes in the file as transmitted (compressed length of RMF_FILE_TYPE_COMPRESSED_FIXED files)
+   uint32_t uncompressedLength; //same as length for all other file types
+   uint16_t compressionType;
    uint16_t fileType;
    uint16_t digestType;
    uint8_t *digestData;
@@ -61,6 +63,8 @@ apx_error_t apx_fileInfo_assign(apx_fileInfo_t *self, const apx_fileInfo_t *othe
 apx_fileInfo_t* apx_fileInfo_clone(const apx_fileInfo_t *other);
 void apx_fileInfo_setAddress(apx_fileInfo_t *self, uint32_t address);
 void apx_fileInfo_fillRmfInfo(const apx_fileInfo_t *self, rmf_fileInfo_t *rmfInfo);
+void apx_fileInfo_setCompression(apx_fileInfo_t *self, uint16_t compressionType, uint32_t uncompressedLength);
+void apx_fileInfo_fillRmfCompressInfo(const apx_fileInfo_t *self, rmf_cmdCompressInfo_t *compressInfo);
 bool apx_fileInfo_isRemoteAddress(apx_fileInfo_t *self);
 bool apx_fileInfo_nameEndsWith(const apx_fileInfo_t *self, const char* suffix);
 char *apx_fileInfo_getBaseName(const apx_fileInfo_t *self);
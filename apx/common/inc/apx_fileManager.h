@@ -51,6 +51,9 @@ typedef struct apx_fileManager_tag
    apx_fileManagerWorker_t worker;
    apx_fileManagerReceiver_t receiver;
    struct apx_connectionBase_tag *parentConnection;
+   rmf_fileInfo_t pendingFileInfo; //compressed file info waiting for its RMF_CMD_COMPRESS_INFO
+   bool hasPendingFileInfo;
+   uint32_t numPendingDecompressions; //compressed remote files whose data has not yet started to arrive
 }apx_fileManager_t;
 
 //////////////////////////////////////////////////////////////////////////////
@@ -65,6 +68,8 @@ void apx_fileManager_destroy(apx_fileManager_t *self);
 
 void apx_fileManager_start(apx_fileManager_t *self);
 void apx_fileManager_stop(apx_fileManager_t *self);
+void apx_fileManager_setExecutor(apx_fileManager_t *self, apx_executor_t *executor);
+void apx_fileManager_setFragmentSize(apx_fileManager_t *self, uint32_t fragmentSize);
 
 
 apx_file_t* apx_fileManager_findFileByAddress(apx_fileManager_t *self, uint32_t address);
@@ -78,6 +83,7 @@ void apx_fileManager_setConnectionId(apx_fileManager_t *self, uint32_t connectio
 int32_t apx_fileManager_getNumLocalFiles(apx_fileManager_t *self);
 int32_t apx_fileManager_getNumRemoteFiles(apx_fileManager_t *self);
 uint16_t apx_fileManager_getNumPendingWorkerMessages(apx_fileManager_t *self);
+void apx_fileManager_getWorkerStats(apx_fileManager_t *self, apx_fileManagerWorkerStats_t *stats);
 
 //Actions triggered by remote side
 apx_error_t apx_fileManager_messageReceived(apx_fileManager_t *self, const uint8_t *msgBuf, int32_t msgLen);
@@ -86,8 +92,12 @@ apx_file_t *apx_fileManager_fileInfoNotify(apx_fileManager_t *self, const apx_fi
 //Actions triggered on local side
 apx_error_t apx_fileManager_writeConstData(apx_fileManager_t *self, uint32_t address, uint32_t len, apx_file_read_const_data_func *readFunc, void *arg);
 apx_error_t apx_fileManager_writeDynamicData(apx_fileManager_t *self, uint32_t address, apx_size_t len, uint8_t *data);
+apx_error_t apx_fileManager_writePayload(apx_fileManager_t *self, uint32_t address, apx_payload_t *payload, uint32_t payloadOffset, apx_size_t len);
+apx_error_t apx_fileManager_writeConflatedData(apx_fileManager_t *self, uint32_t address, apx_fileConflationHandler_t *handler);
+apx_error_t apx_fileManager_writeQueuedData(apx_fileManager_t *self, uint32_t address, uint32_t maxLen, apx_fileQueueHandler_t *handler);
 apx_file_t *apx_fileManager_createLocalFile(apx_fileManager_t *self, const apx_fileInfo_t *fileInfo);
 apx_error_t apx_fileManager_sendFileInfo(apx_fileManager_t *self, apx_fileInfo_t *fileInfo);
+apx_error_t apx_fileManager_sendPing(apx_fileManager_t *self, uint32_t sequence);
 void apx_fileManager_disconnectNotify(apx_fileManager_t *self);
 
 #ifdef UNIT_TEST
@@ -31,6 +31,7 @@
 //////////////////////////////////////////////////////////////////////////////
 #include "apx_types.h"
 #include "apx_error.h"
+#include "apx_lz.h"
 #include "rmf.h"
 
 //////////////////////////////////////////////////////////////////////////////
@@ -43,6 +44,9 @@ typedef struct apx_fileManagerReceiver_tag
    apx_size_t receiveBufPos;   //current write position (and length) of receive buffer
    uint32_t startAddress;      //StartAddress of write, When value is RMF_INVALID_ADDRESS it means no reception is currently taking place
    bool isFragmentedWrite;     //True as long as moreBit is true
+   bool isCompressedWrite;     //True when received bytes are decoded into receiveBuf instead of being copied
+   apx_size_t compressedPos;   //Number of compressed bytes received (only used when isCompressedWrite is true)
+   apx_lzDecoder_t decoder;
 } apx_fileManagerReceiver_t;
 
 typedef struct apx_fileManagerReception_tag
@@ -61,6 +65,8 @@ void apx_fileManagerReceiver_destroy(apx_fileManagerReceiver_t *self);
 void apx_fileManagerReceiver_reset(apx_fileManagerReceiver_t *self);
 apx_error_t apx_fileManagerReceiver_reserve(apx_fileManagerReceiver_t *self, apx_size_t size);
 bool apx_fileManagerReceiver_isOngoing(apx_fileManagerReceiver_t *self);
+bool apx_fileManagerReceiver_isInterleavedWrite(apx_fileManagerReceiver_t *self, uint32_t address, bool moreBit);
+apx_error_t apx_fileManagerReceiver_startDecompression(apx_fileManagerReceiver_t *self, apx_size_t uncompressedSize);
 apx_error_t apx_fileManagerReceiver_write(apx_fileManagerReceiver_t *self, uint32_t address, const uint8_t *data, apx_size_t size, bool moreBit);
 uint32_t apx_fileManagerReceiver_getAddress(apx_fileManagerReceiver_t *self);
 apx_size_t apx_fileManagerReceiver_getSize(apx_fileManagerReceiver_t *self, apx_size_t *size);
@@ -36,32 +36,51 @@
 #include "apx_file.h"
 #include "apx_event.h"
 #include "apx_msg.h"
-#ifndef ADT_RBFS_ENABLE
-#define ADT_RBFS_ENABLE 1
-#endif
-#include "adt_ringbuf.h"
+#include "apx_executor.h"
+#include "apx_mpscQueue.h"
+#include "apx_payload.h"
+#include "apx_byteRangeSet.h"
 #include "rmf.h"
-#ifndef _WIN32
-#include <semaphore.h>
-#endif
 
 //////////////////////////////////////////////////////////////////////////////
 // PUBLIC CONSTANTS AND DATA TYPES
 //////////////////////////////////////////////////////////////////////////////
 //forward declaration
 
+typedef struct apx_fileManagerWorkerStats_tag
+{
+   uint32_t numMessagesSent; //number of RMF messages handed over to the transmit handler
+   uint32_t numTransmitCalls; //number of calls made into the transmit handler
+   uint32_t numGatherCalls; //number of messages transmitted directly from a shared payload without copying it first
+   uint64_t numBytesSent; //number of bytes handed over to the transmit handler (excluding numHeaders added by the transmit handler itself)
+   uint32_t numFragmentsSent; //number of RMF messages carrying a fragment of a write larger than the fragment size
+} apx_fileManagerWorkerStats_t;
+
 typedef struct apx_fileManagerWorker_tag
 {
    apx_fileManagerShared_t *shared; //weak reference (do not delete on destruction)
    MUTEX_T mutex; //for locking variables in this object
-   SPINLOCK_T lock; //used exclusively by workerThread message queue
+   SPINLOCK_T lock; //protects transmitHandler and stats
    THREAD_T workerThread; //local transmit thread
-   SEMAPHORE_T semaphore; //thread semaphore
-   adt_rbfh_t messages; //pending actions
+   apx_mpscQueue_t messages; //pending actions. Written by any thread, read by workerThread (or the executor task)
    bool workerThreadValid; //Differences in Linux and Windows doesn't make it obvious if workerThread is valid without this flag
    apx_transmitHandler_t transmitHandler;
    int8_t numHeaderSize; //Number of bits used in numHeader (16 or 32)
    apx_mode_t mode; //server or client mode?
+   uint8_t *batchBuf; //staging area where messages (including numHeader) are collected before being transmitted in one call
+   int32_t batchBufSize;
+   int32_t batchLen; //number of bytes currently staged in batchBuf
+   uint32_t batchNumMessages; //number of messages currently staged in batchBuf
+   bool isBatchMsgPending; //true when the last buffer returned to a message serializer points into batchBuf
+   apx_fileManagerWorkerStats_t stats; //protected by lock
+   apx_executor_t *executor; //weak reference. When set, messages are processed by executor threads instead of workerThread
+   apx_executorTask_t executorTask;
+   apx_byteRangeSet_t conflatedRanges; //scratch set filled by apx_fileConflationHandler_t. Only used by the thread processing messages
+   uint32_t fragmentSize; //0 (no fragmentation) until the peer has announced that it accepts interleaved fragments
+   apx_msg_t bulkTransfers[APX_WORKER_MAX_BULK_TRANSFERS]; //FIFO of writes larger than fragmentSize. Only used by the thread processing messages
+   uint32_t bulkHead; //index of the bulk transfer currently being transmitted
+   uint32_t numBulkTransfers;
+   uint32_t bulkPos; //number of bytes of the current bulk transfer already transmitted
 #ifdef _WIN32
    unsigned int threadId;
 #endif
@@ -83,7 +102,10 @@ void apx_fileManagerWorker_stop(apx_fileManagerWorker_t *self);
 void apx_fileManagerWorker_setTransmitHandler(apx_fileManagerWorker_t *self, apx_transmitHandler_t *handler);
 void apx_fileManagerWorker_copyTransmitHandler(apx_fileManagerWorker_t *self, apx_transmitHandler_t *handler);
 void apx_fileManagerWorker_setNumHeaderSize(apx_fileManagerWorker_t *self, uint8_t bits);
+void apx_fileManagerWorker_setExecutor(apx_fileManagerWorker_t *self, apx_executor_t *executor);
+void apx_fileManagerWorker_setFragmentSize(apx_fileManagerWorker_t *self, uint32_t fragmentSize);
 uint16_t apx_fileManagerWorker_getNumPendingMessages(apx_fileManagerWorker_t *self);
+void apx_fileManagerWorker_getStats(apx_fileManagerWorker_t *self, apx_fileManagerWorkerStats_t *stats);
 
 //Message API
 void apx_fileManagerWorker_sendFileInfoMsg(apx_fileManagerWorker_t *self, apx_fileInfo_t *fileInfo);
@@ -91,11 +113,18 @@ void apx_fileManagerWorker_sendFileOpenMsg(apx_fileManagerWorker_t *self, uint32
 apx_error_t apx_fileManagerWorker_sendHeaderAckMsg(apx_fileManagerWorker_t *self);
 apx_error_t apx_fileManagerWorker_sendConstData(apx_fileManagerWorker_t *self, uint32_t address, uint32_t len, apx_file_read_const_data_func *readFunc, void *arg);
 apx_error_t apx_fileManagerWorker_sendDynamicData(apx_fileManagerWorker_t *self, uint32_t address, uint32_t len, uint8_t *data);
+apx_error_t apx_fileManagerWorker_sendPayload(apx_fileManagerWorker_t *self, uint32_t address, apx_payload_t *payload, uint32_t payloadOffset, uint32_t len);
+apx_error_t apx_fileManagerWorker_sendConflatedData(apx_fileManagerWorker_t *self, uint32_t address, apx_fileConflationHandler_t *handler);
+apx_error_t apx_fileManagerWorker_sendQueuedData(apx_fileManagerWorker_t *self, uint32_t address, uint32_t maxLen, apx_fileQueueHandler_t *handler);
+apx_error_t apx_fileManagerWorker_sendPingRequest(apx_fileManagerWorker_t *self, uint32_t sequence);
+apx_error_t apx_fileManagerWorker_sendPingResponse(apx_fileManagerWorker_t *self, const rmf_cmdPing_t *request);
+apx_error_t apx_fileManagerWorker_sendHeartbeatResponse(apx_fileManagerWorker_t *self);
 
 //UNIT TEST API
 #ifdef UNIT_TEST
 bool apx_fileManagerWorker_run(apx_fileManagerWorker_t *self);
 int32_t apx_fileManagerWorker_numPendingMessages(apx_fileManagerWorker_t *self);
+uint32_t apx_fileManagerWorker_numBulkTransfers(apx_fileManagerWorker_t *self);
 #endif
 
 #endif //APX_FILE_MANAGER_WORKER_H
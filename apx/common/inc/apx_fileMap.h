@@ -12,10 +12,19 @@
 //////////////////////////////////////////////////////////////////////////////
 // CONSTANTS AND DATA TYPES
 //////////////////////////////////////////////////////////////////////////////
+typedef struct apx_fileMapEntry_tag
+{
+   uint32_t startAddress;
+   uint32_t endAddress;
+   apx_file_t *file; //weak reference
+} apx_fileMapEntry_t;
+
 typedef struct apx_fileMap_tag
 {
    adt_list_t fileList; //list of apx_file_t automatically sorted by address
-   apx_file_t *lastFile; //Last accessed file (for caching repeated access requests)
+   apx_fileMapEntry_t *fileIndex; //address ranges of the same files, sorted by address. Used for binary search.
+   int32_t indexLen;
+   int32_t indexCapacity;
 } apx_fileMap_t;
 
 
@@ -0,0 +1,74 @@
+/*****************************************************************************
+* \file      apx_latencyStats.h
+* \author    Conny Gustafsson
+* \date      2026-10-18
+* \brief     Rolling round-trip latency statistics for a connection
+*
+* Copyright (c) 2026 Conny Gustafsson
+* Permission is hereby granted, free of charge, to any person obtaining a copy of
+* this software and associated documentation files (the "Software"), to deal in
+* the Software without restriction, including without limitation the rights to
+* use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+* the Software, and to permit persons to whom the Software is furnished to do so,
+* subject to the following conditions:
+
+* The above copyright notice and this permission notice shall be included in all
+* copies or substantial portions of the Software.
+
+* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+* IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+* FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+* COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+* IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+* CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+*
+******************************************************************************/
+#ifndef APX_LATENCY_STATS_H
+#define APX_LATENCY_STATS_H
+
+//////////////////////////////////////////////////////////////////////////////
+// INCLUDES
+//////////////////////////////////////////////////////////////////////////////
+#include "apx_types.h"
+#include "apx_cfg.h"
+
+//////////////////////////////////////////////////////////////////////////////
+// PUBLIC CONSTANTS AND DATA TYPES
+//////////////////////////////////////////////////////////////////////////////
+
+/**
+ * Keeps the last APX_LATENCY_STATS_WINDOW_SIZE round-trip samples (in microseconds).
+ * This object has no lock of its own, the owner is responsible for serializing access to it.
+ */
+typedef struct apx_latencyStats_tag
+{
+   uint32_t samples[APX_LATENCY_STATS_WINDOW_SIZE];
+   uint32_t nextIndex; //where the next sample is written
+   uint32_t numSamples; //number of valid samples in the window
+   uint32_t totalSamples; //number of samples added since creation
+   uint32_t lastRttUs;
+} apx_latencyStats_t;
+
+typedef struct apx_latencySummary_tag
+{
+   uint32_t numSamples; //number of samples the statistics below are based on
+   uint32_t totalSamples;
+   uint32_t lastRttUs;
+   uint32_t minRttUs;
+   uint32_t avgRttUs;
+   uint32_t p99RttUs;
+   uint32_t maxRttUs;
+   uint32_t oneWayDelayUs; //estimated as avgRttUs/2 since the peers don't share a clock
+} apx_latencySummary_t;
+
+//////////////////////////////////////////////////////////////////////////////
+// PUBLIC FUNCTION PROTOTYPES
+//////////////////////////////////////////////////////////////////////////////
+void apx_latencyStats_create(apx_latencyStats_t *self);
+void apx_latencyStats_destroy(apx_latencyStats_t *self);
+void apx_latencyStats_reset(apx_latencyStats_t *self);
+void apx_latencyStats_addSample(apx_latencyStats_t *self, uint32_t rttUs);
+void apx_latencyStats_getSummary(const apx_latencyStats_t *self, apx_latencySummary_t *summary);
+uint64_t apx_latencyStats_timestampUs(void);
+
+#endif //APX_LATENCY_STATS_H
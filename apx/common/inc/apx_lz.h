@@ -0,0 +1,72 @@
+/*****************************************************************************
+* \file      apx_lz.h
+* \author    Conny Gustafsson
+* \date      2026-10-18
+* \brief     LZ4 block format compressor and incremental decompressor
+*
+* Copyright (c) 2026 Conny Gustafsson
+* Permission is hereby granted, free of charge, to any person obtaining a copy of
+* this software and associated documentation files (the "Software"), to deal in
+* the Software without restriction, including without limitation the rights to
+* use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+* the Software, and to permit persons to whom the Software is furnished to do so,
+* subject to the following conditions:
+
+* The above copyright notice and this permission notice shall be included in all
+* copies or substantial portions of the Software.
+
+* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+* IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+* FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+* COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+* IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+* CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+*
+******************************************************************************/
+#ifndef APX_LZ_H
+#define APX_LZ_H
+
+//////////////////////////////////////////////////////////////////////////////
+// INCLUDES
+//////////////////////////////////////////////////////////////////////////////
+#include "apx_types.h"
+#include "apx_error.h"
+
+//////////////////////////////////////////////////////////////////////////////
+// PUBLIC CONSTANTS AND DATA TYPES
+//////////////////////////////////////////////////////////////////////////////
+#define APX_LZ_MIN_MATCH      4u
+#define APX_LZ_LAST_LITERALS  5u  //The last 5 bytes of a block are always literals
+#define APX_LZ_MF_LIMIT       12u //The last match must start at least 12 bytes before end of block
+#define APX_LZ_MAX_OFFSET     65535u
+#define APX_LZ_HASH_LOG       12u
+
+/**
+ * Decodes a compressed block which arrives in arbitrary sized pieces (e.g. RMF message fragments).
+ * Sequences may be split anywhere, the decoder keeps the partially parsed sequence in its state.
+ * Match offsets refer to already decoded data in dest, which therefore must hold the entire uncompressed block.
+ */
+typedef struct apx_lzDecoder_tag
+{
+   uint8_t *dest;
+   apx_size_t destSize;
+   apx_size_t destPos;
+   uint32_t literalLen;
+   uint32_t matchLen;
+   uint32_t matchOffset;
+   uint8_t state;
+} apx_lzDecoder_t;
+
+//////////////////////////////////////////////////////////////////////////////
+// PUBLIC FUNCTION PROTOTYPES
+//////////////////////////////////////////////////////////////////////////////
+apx_size_t apx_lz_compressBound(apx_size_t srcLen);
+apx_error_t apx_lz_compress(const uint8_t *src, apx_size_t srcLen, uint8_t *dest, apx_size_t destCapacity, apx_size_t *destLen);
+apx_error_t apx_lz_decompress(const uint8_t *src, apx_size_t srcLen, uint8_t *dest, apx_size_t destSize);
+
+void apx_lzDecoder_create(apx_lzDecoder_t *self, uint8_t *dest, apx_size_t destSize);
+apx_error_t apx_lzDecoder_write(apx_lzDecoder_t *self, const uint8_t *src, apx_size_t srcLen);
+bool apx_lzDecoder_isComplete(const apx_lzDecoder_t *self);
+apx_size_t apx_lzDecoder_getSize(const apx_lzDecoder_t *self);
+
+#endif //APX_LZ_H
@@ -0,0 +1,88 @@
+/*****************************************************************************
+* \file      apx_mpscQueue.h
+* \author    Conny Gustafsson
+* \date      2026-10-18
+* \brief     Bounded lock-free multi-producer/single-consumer queue
+*
+* Copyright (c) 2026 Conny Gustafsson
+* Permission is hereby granted, free of charge, to any person obtaining a copy of
+* this software and associated documentation files (the "Software"), to deal in
+* the Software without restriction, including without limitation the rights to
+* use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+* the Software, and to permit persons to whom the Software is furnished to do so,
+* subject to the following conditions:
+
+* The above copyright notice and this permission notice shall be included in all
+* copies or substantial portions of the Software.
+
+* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+* IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+* FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+* COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+* IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+* CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+*
+******************************************************************************/
+#ifndef APX_MPSC_QUEUE_H
+#define APX_MPSC_QUEUE_H
+
+//////////////////////////////////////////////////////////////////////////////
+// INCLUDES
+//////////////////////////////////////////////////////////////////////////////
+#ifdef _WIN32
+# ifndef WIN32_LEAN_AND_MEAN
+# define WIN32_LEAN_AND_MEAN
+# endif
+# include <Windows.h>
+#else
+# include <pthread.h>
+# include <semaphore.h>
+#endif
+#include "apx_types.h"
+#include "apx_error.h"
+#include "osmacro.h"
+
+//////////////////////////////////////////////////////////////////////////////
+// PUBLIC CONSTANTS AND DATA TYPES
+//////////////////////////////////////////////////////////////////////////////
+#define APX_MPSC_QUEUE_WAIT_INFINITE 0xFFFFFFFFu
+#define APX_MPSC_QUEUE_CACHE_LINE_SIZE 64
+
+/**
+ * Fixed-size ring of equally sized elements. Any number of threads may push, only one thread may pop.
+ * Each slot carries a sequence number which tells producers and the consumer whose turn it is to use the slot.
+ * Producers only touch the semaphore when the consumer has announced that it is about to sleep in apx_mpscQueue_wait.
+ */
+typedef struct apx_mpscQueue_tag
+{
+   uint8_t *slots;
+   uint32_t numSlots; //always a power of two
+   uint32_t mask;
+   uint32_t elemSize;
+   uint32_t slotSize;
+   SEMAPHORE_T semaphore;
+   uint8_t padding1[APX_MPSC_QUEUE_CACHE_LINE_SIZE];
+   volatile uint32_t enqueuePos; //written by producers
+   uint8_t padding2[APX_MPSC_QUEUE_CACHE_LINE_SIZE];
+   volatile uint32_t dequeuePos; //written by consumer
+   volatile uint32_t isConsumerParked;
+   volatile uint32_t isWakeupRequested;
+   volatile uint32_t numWakeups; //number of times a producer had to post the semaphore (statistics)
+} apx_mpscQueue_t;
+
+//////////////////////////////////////////////////////////////////////////////
+// PUBLIC FUNCTION PROTOTYPES
+//////////////////////////////////////////////////////////////////////////////
+apx_error_t apx_mpscQueue_create(apx_mpscQueue_t *self, uint32_t elemSize, uint32_t minNumElems);
+void apx_mpscQueue_destroy(apx_mpscQueue_t *self);
+apx_mpscQueue_t *apx_mpscQueue_new(uint32_t elemSize, uint32_t minNumElems);
+void apx_mpscQueue_delete(apx_mpscQueue_t *self);
+apx_error_t apx_mpscQueue_push(apx_mpscQueue_t *self, const void *elem);
+bool apx_mpscQueue_pop(apx_mpscQueue_t *self, void *elem);
+void apx_mpscQueue_wait(apx_mpscQueue_t *self, uint32_t timeoutMs);
+void apx_mpscQueue_wakeup(apx_mpscQueue_t *self);
+uint32_t apx_mpscQueue_length(apx_mpscQueue_t *self);
+uint32_t apx_mpscQueue_capacity(const apx_mpscQueue_t *self);
+uint32_t apx_mpscQueue_getNumWakeups(apx_mpscQueue_t *self);
+
+#endif //APX_MPSC_QUEUE_H
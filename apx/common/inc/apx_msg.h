@@ -33,6 +33,12 @@ typedef struct apx_msg_tag
 #define APX_MSG_SEND_FILE_DYN_DATA         6 //msgData1=address, msgData2=length, msgData3.ptr=data (allocated through SOA, needs to be freed)
 #define APX_MSG_SEND_FILE_DATA_DIRECT      7 //msgData1=address, msgData2=length, msgData3.data=data (buffer memory)
 #define APX_MSG_SEND_ERROR_CODE            8 //msgData1=errorCode
+#define APX_MSG_SEND_FILE_PAYLOAD          9 //msgData1=address, msgData2=length, msgData3.ptr=apx_payload_t (reference owned by message), msgData4=pointer to first byte inside payload
+#define APX_MSG_SEND_PING_REQUEST          10 //msgData1=sequence (timestamp is taken by the worker when the request is serialized)
+#define APX_MSG_SEND_PING_RESPONSE         11 //msgData1=sequence, msgData3.data=uint64_t timestamp from the request (echoed back unmodified)
+#define APX_MSG_SEND_HEARTBEAT_RESPONSE    12 //no extra info
+#define APX_MSG_SEND_FILE_CONFLATED_DATA   13 //msgData1=startAddress, msgData3.ptr=apx_fileConflationHandler_t (owned by the file owner)
+#define APX_MSG_SEND_FILE_QUEUED_DATA      14 //msgData1=address, msgData2=max length, msgData3.ptr=apx_fileQueueHandler_t (owned by the file owner)
 
 
 /*
@@ -115,6 +115,7 @@ const uint8_t* apx_nodeData_getDefinitionChecksumData(apx_nodeData_t *self);
 apx_error_t apx_nodeData_writeDefinitionData(apx_nodeData_t *self, const uint8_t *src, uint32_t offset, uint32_t len);
 apx_error_t apx_nodeData_readDefinitionData(apx_nodeData_t *self, uint8_t *dest, uint32_t offset, uint32_t len);
 apx_error_t apx_nodeData_setDefinitionChecksumData(apx_nodeData_t *self, uint8_t checksumType, uint8_t *checksumData);
+apx_error_t apx_nodeData_calcDefinitionChecksum(apx_nodeData_t *self);
 
 #ifndef APX_EMBEDDED
 apx_error_t apx_nodeData_createRequirePortBuffer(apx_nodeData_t *self, apx_size_t bufferLen);
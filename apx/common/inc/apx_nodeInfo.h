@@ -42,6 +42,7 @@
 //////////////////////////////////////////////////////////////////////////////
 //forward declaration
 struct apx_node_tag;
+struct apx_portNameIndex_tag;
 
 typedef struct apx_nodeInfo_tag
 {
@@ -54,6 +55,8 @@ typedef struct apx_nodeInfo_tag
    adt_bytes_t **providePortPackPrograms; //Strong reference to adt_bytes_t*;length of array: numProvidePorts
    adt_bytes_t **requirePortUnpackPrograms; //Strong reference to adt_bytes_t*;length of array: numRequirePorts
    adt_bytes_t **providePortUnpackPrograms; //Strong reference to adt_bytes_t*;length of array: numProvidePorts
+   apx_copyPlan_t **providePortPackPlans; //Strong references to apx_copyPlan_t* (client mode only), NULL entry when program is not flat; length of array: numProvidePorts
+   apx_copyPlan_t **requirePortUnpackPlans; //Strong references to apx_copyPlan_t* (client mode only), NULL entry when program is not flat; length of array: numRequirePorts
    adt_bytes_t *requirePortInitData; //Calculated init data for requirePorts
    adt_bytes_t *providePortInitData; //Calculated init data for providePorts
    char **requirePortSignatures; //array of derived port signatures strings (used in server mode); length of array: numRequirePorts
@@ -63,6 +66,9 @@ typedef struct apx_nodeInfo_tag
    apx_size_t requirePortDataLen; //Cached result from apx_nodeInfo_calcRequirePortDataLen
    apx_size_t providePortDataLen; //Cached result from apx_nodeInfo_calcProvidePortDataLen
    apx_mode_t mode; //The mode this nodeInfo was built for
+   volatile uint32_t refCount; //Set to 1 by apx_nodeInfo_new. A nodeInfo is never modified after being built, which makes it safe to share.
+   struct apx_portNameIndex_tag * volatile portNameIndex; //Hash index from port name to port ID. Built by the first call to apx_nodeInfo_findPortIdByName
+                                                          //and published atomically, which is the only exception to the rule above.
 } apx_nodeInfo_t;
 
 //////////////////////////////////////////////////////////////////////////////
@@ -76,6 +82,9 @@ void apx_nodeInfo_create(apx_nodeInfo_t *self);
 void apx_nodeInfo_destroy(apx_nodeInfo_t *self);
 apx_nodeInfo_t *apx_nodeInfo_new(void);
 void apx_nodeInfo_delete(apx_nodeInfo_t *self);
+void apx_nodeInfo_retain(apx_nodeInfo_t *self);
+void apx_nodeInfo_release(apx_nodeInfo_t *self);
+void apx_nodeInfo_vrelease(void *arg);
 
 apx_error_t apx_nodeInfo_build(apx_nodeInfo_t *self, const struct apx_node_tag *parseTree, apx_compiler_t *compiler, apx_mode_t mode, apx_programType_t *errProgramType, apx_uniquePortId_t *errPortId);
 apx_nodeInfo_t *apx_nodeInfo_make_from_cstr(const char *apx_definition, apx_mode_t mode); //Utility function only meant for unit testing
@@ -88,6 +97,8 @@ const adt_bytes_t* apx_nodeInfo_getRequirePortPackProgram(const apx_nodeInfo_t *
 const adt_bytes_t* apx_nodeInfo_getProvidePortPackProgram(const apx_nodeInfo_t *self, apx_portId_t portId);
 const adt_bytes_t* apx_nodeInfo_getRequirePortUnpackProgram(const apx_nodeInfo_t *self, apx_portId_t portId);
 const adt_bytes_t* apx_nodeInfo_getProvidePortUnpackProgram(const apx_nodeInfo_t *self, apx_portId_t portId);
+const apx_copyPlan_t* apx_nodeInfo_getProvidePortPackPlan(const apx_nodeInfo_t *self, apx_portId_t portId);
+const apx_copyPlan_t* apx_nodeInfo_getRequirePortUnpackPlan(const apx_nodeInfo_t *self, apx_portId_t portId);
 apx_portId_t apx_nodeInfo_findProvidePortIdFromByteOffset(const apx_nodeInfo_t *self, apx_offset_t offset);
 apx_portId_t apx_nodeInfo_findRequirePortIdFromByteOffset(const apx_nodeInfo_t *self, apx_offset_t offset);
 apx_uniquePortId_t apx_nodeInfo_findPortIdByName(const apx_nodeInfo_t *self, const char *name);
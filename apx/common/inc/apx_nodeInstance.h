@@ -40,6 +40,9 @@
 #include "apx_error.h"
 #include "apx_parser.h"
 #include "apx_portConnectorChangeTable.h"
+#include "apx_byteRangeSet.h"
+#include "apx_routingPlan.h"
+#include "apx_portQueue.h"
 #ifdef _WIN32
 # ifndef WIN32_LEAN_AND_MEAN
 # define WIN32_LEAN_AND_MEAN
@@ -67,14 +70,31 @@ typedef struct apx_nodeInstance_tag
    apx_portConnectorList_t *connectorTable; //Array of apx_portConnectorList_t; Length of array: info->numProvidePorts. Created using a single malloc. Only used in server mode.
    struct apx_connectionBase_tag *connection; //Weak reference
    apx_file_t *definitionFile;       //pointer to file in file manager
+   uint8_t *compressedDefinitionData; //Definition data as sent to remote side when compression is used. Only used in client mode.
+   apx_size_t compressedDefinitionDataLen;
    apx_file_t *providePortDataFile;  //pointer to file in file manager
    apx_file_t *requirePortDataFile;  //pointer to file in file manager
    apx_portConnectorChangeTable_t *requirePortChanges; //temporary data structure used for tracking port connector changes to requirePorts
    apx_portConnectorChangeTable_t *providePortChanges; //temporary data structure used for tracking port connector changes to providePorts
+   apx_routingPlan_t * volatile routingPlan; //Immutable snapshot of connectorTable used when routing provide port data. Only used in server mode.
+   apx_byteRangeSet_t *providePortDirtyRanges; //provide port data written locally but not yet sent to remote side. Only used in client mode.
+   SPINLOCK_T providePortDirtyLock; //protects providePortDirtyRanges (the pointer as well as the set it points to)
+   MUTEX_T providePortFlushLock; //serializes flushes such that data read later from nodeData is also sent later
+   volatile uint32_t *requirePortDirtyFlags; //One bit per require port. Client mode: set when the remote side writes new data to it. Server mode: set while new data waits for a conflated transfer.
+   volatile uint32_t isConflatedTransferPending; //Non-zero while the file manager worker has a conflated transfer of requirePortDirtyFlags queued. Only used in server mode.
+   apx_fileConflationHandler_t requirePortConflationHandler; //Lets the file manager worker take and read dirty require port data. Only used in server mode.
+   apx_portQueue_t **providePortQueues; //One entry per provide port, NULL for ports that are not queued (or when no port is). Only used in client mode.
+   apx_portQueue_t **requirePortQueues; //One entry per require port, NULL for ports that are not queued (or when no port is). Client mode: received elements. Server mode: elements waiting to be sent.
+   apx_fileQueueHandler_t providePortQueueHandler; //Lets the file manager worker take elements from providePortQueues
+   apx_fileQueueHandler_t requirePortQueueHandler; //Lets the file manager worker take elements from requirePortQueues
    apx_mode_t mode;
    apx_requirePortDataState_t requirePortDataState;
    apx_providePortDataState_t providePortDataState;
+   apx_routingStats_t routingStats; //Only updated using atomic operations
+   bool isRoutingPlanStale; //connectorTable was modified since routingPlan was built
    MUTEX_T connectorTableLock;
+   volatile uint32_t routingEpoch; //Selects which element of numRoutingReaders new readers of routingPlan are counted in
+   volatile uint32_t numRoutingReaders[2]; //Threads currently routing data, per epoch. A replaced routingPlan is deleted when its epoch has no readers left
 } apx_nodeInstance_t;
 
 //////////////////////////////////////////////////////////////////////////////
@@ -98,6 +118,7 @@ apx_error_t apx_nodeInstance_createDefinitionBuffer(apx_nodeInstance_t *self, ap
 apx_error_t apx_nodeInstance_createPortDataBuffers(apx_nodeInstance_t *self);
 
 apx_error_t apx_nodeInstance_buildNodeInfo(apx_nodeInstance_t *self, apx_programType_t *errProgramType, apx_uniquePortId_t *errPortId);
+apx_error_t apx_nodeInstance_attachNodeInfo(apx_nodeInstance_t *self, apx_nodeInfo_t *nodeInfo);
 apx_nodeInfo_t *apx_nodeInstane_getNodeInfo(apx_nodeInstance_t *self);
 apx_error_t apx_nodeInstance_buildPortRefs(apx_nodeInstance_t *self);
 apx_portRef_t *apx_nodeInstance_getPortRef(apx_nodeInstance_t *self, apx_uniquePortId_t portId);
@@ -114,7 +135,7 @@ apx_nodeInfo_t *apx_nodeInstance_getNodeInfo(apx_nodeInstance_t *self);
 apx_portCount_t apx_nodeInstance_getNumProvidePorts(apx_nodeInstance_t *self);
 apx_portCount_t apx_nodeInstance_getNumRequirePorts(apx_nodeInstance_t *self);
 apx_error_t apx_nodeInstance_fillProvidePortDataFileInfo(apx_nodeInstance_t *self, apx_fileInfo_t *fileInfo);
-apx_error_t apx_nodeInstance_fillDefinitionFileInfo(apx_nodeInstance_t *self, apx_fileInfo_t *fileInfo);
+apx_error_t apx_nodeInstance_fillDefinitionFileInfo(apx_nodeInstance_t *self, apx_fileInfo_t *fileInfo, uint16_t compressionType);
 void apx_nodeInstance_setProvidePortDataState(apx_nodeInstance_t *self, apx_providePortDataState_t state);
 apx_providePortDataState_t apx_nodeInstance_getProvidePortDataState(apx_nodeInstance_t *self);
 void apx_nodeInstance_setRequirePortDataState(apx_nodeInstance_t *self, apx_requirePortDataState_t state);
@@ -132,8 +153,17 @@ apx_error_t apx_nodeInstance_writeDefinitionData(apx_nodeInstance_t *self, const
 apx_error_t apx_nodeInstance_readDefinitionData(apx_nodeInstance_t *self, uint8_t *dest, uint32_t offset, uint32_t len);
 apx_error_t apx_nodeInstance_writeProvidePortData(apx_nodeInstance_t *self, const uint8_t *src, uint32_t offset, apx_size_t len);
 apx_error_t apx_nodeInstance_readProvidePortData(apx_nodeInstance_t *self, uint8_t *dest, uint32_t offset, apx_size_t len);
+apx_error_t apx_nodeInstance_writeProvidePortDataDeferred(apx_nodeInstance_t *self, const uint8_t *src, uint32_t offset, apx_size_t len);
+apx_error_t apx_nodeInstance_flushProvidePortData(apx_nodeInstance_t *self);
+bool apx_nodeInstance_hasPendingProvidePortData(apx_nodeInstance_t *self);
+bool apx_nodeInstance_markRequirePortDirty(apx_nodeInstance_t *self, apx_portId_t requirePortId);
+int32_t apx_nodeInstance_pollDirtyRequirePorts(apx_nodeInstance_t *self, apx_portId_t *requirePortIds, int32_t maxNumPorts);
 apx_error_t apx_nodeInstance_readRequirePortData(apx_nodeInstance_t *self, uint8_t *dest, uint32_t offset, uint32_t len);
 apx_error_t apx_nodeInstance_writeRequirePortData(apx_nodeInstance_t *self, const uint8_t *src, uint32_t offset, apx_size_t len);
+apx_error_t apx_nodeInstance_writeQueuedProvidePortData(apx_nodeInstance_t *self, apx_portId_t providePortId, const uint8_t *element);
+int32_t apx_nodeInstance_readQueuedRequirePortData(apx_nodeInstance_t *self, apx_portId_t requirePortId, uint8_t *elements, int32_t maxNumElements);
+apx_portQueue_t *apx_nodeInstance_getProvidePortQueue(apx_nodeInstance_t *self, apx_portId_t providePortId);
+apx_portQueue_t *apx_nodeInstance_getRequirePortQueue(apx_nodeInstance_t *self, apx_portId_t requirePortId);
 
 /********** ConnectorTable API  ************/
 apx_error_t apx_nodeInstance_buildConnectorTable(apx_nodeInstance_t *self);
@@ -158,9 +188,13 @@ apx_error_t apx_nodeInstance_handleRequirePortWasDisconnectedFromProvidePort(apx
 apx_error_t apx_nodeInstance_sendRequirePortDataToFileManager(apx_nodeInstance_t *self);
 apx_error_t apx_nodeInstance_routeProvidePortDataToReceivers(apx_nodeInstance_t *self, const uint8_t *src, uint32_t offset, apx_size_t len);
 void apx_nodeInstance_clearConnectorTable(apx_nodeInstance_t *self);
+const apx_routingPlan_t *apx_nodeInstance_getRoutingPlan(apx_nodeInstance_t *self);
+void apx_nodeInstance_getRoutingStats(apx_nodeInstance_t *self, apx_routingStats_t *stats);
 
 /********** Port Program API ***************/
 const adt_bytes_t *apx_nodeInstance_getProvidePortPackProgram(apx_nodeInstance_t *self, apx_portId_t providePortId);
 const adt_bytes_t *apx_nodeInstance_getRequirePortUnpackProgram(apx_nodeInstance_t *self, apx_portId_t requirePortId);
+const apx_copyPlan_t *apx_nodeInstance_getProvidePortPackPlan(apx_nodeInstance_t *self, apx_portId_t providePortId);
+const apx_copyPlan_t *apx_nodeInstance_getRequirePortUnpackPlan(apx_nodeInstance_t *self, apx_portId_t requirePortId);
 
 #endif //APX_NODE_INSTANCE_H
@@ -0,0 +1,59 @@
+/*****************************************************************************
+* \file      apx_payload.h
+* \author    Conny Gustafsson
+* \date      2026-10-18
+* \brief     Reference counted immutable data buffer
+*
+* Copyright (c) 2026 Conny Gustafsson
+* Permission is hereby granted, free of charge, to any person obtaining a copy of
+* this software and associated documentation files (the "Software"), to deal in
+* the Software without restriction, including without limitation the rights to
+* use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+* the Software, and to permit persons to whom the Software is furnished to do so,
+* subject to the following conditions:
+
+* The above copyright notice and this permission notice shall be included in all
+* copies or substantial portions of the Software.
+
+* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+* IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+* FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+* COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+* IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+* CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+*
+******************************************************************************/
+#ifndef APX_PAYLOAD_H
+#define APX_PAYLOAD_H
+
+//////////////////////////////////////////////////////////////////////////////
+// INCLUDES
+//////////////////////////////////////////////////////////////////////////////
+#include "apx_types.h"
+
+//////////////////////////////////////////////////////////////////////////////
+// PUBLIC CONSTANTS AND DATA TYPES
+//////////////////////////////////////////////////////////////////////////////
+
+/**
+ * A payload is a copy of routed port data that is shared between all connections it is sent to.
+ * The data is never modified after creation. The payload is freed when the last reference is released.
+ */
+typedef struct apx_payload_tag
+{
+   volatile uint32_t refCount;
+   uint32_t dataLen;
+   uint8_t *data; //points into the same memory block as the payload itself
+} apx_payload_t;
+
+//////////////////////////////////////////////////////////////////////////////
+// PUBLIC FUNCTION PROTOTYPES
+//////////////////////////////////////////////////////////////////////////////
+apx_payload_t *apx_payload_new(const uint8_t *data, uint32_t dataLen);
+void apx_payload_retain(apx_payload_t *self);
+void apx_payload_release(apx_payload_t *self);
+const uint8_t *apx_payload_getData(const apx_payload_t *self);
+uint32_t apx_payload_getDataLen(const apx_payload_t *self);
+uint32_t apx_payload_getRefCount(apx_payload_t *self);
+
+#endif //APX_PAYLOAD_H
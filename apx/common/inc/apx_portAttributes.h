@@ -17,6 +17,7 @@ typedef struct apx_portAttributes_tag
    bool isQueued;
    bool isParameter;
    bool isDynamic;
+   bool isEvent; //E attribute: every write is forwarded, conflating connections must not merge writes to this port
    bool isFinalized; //internal variable
    uint32_t queueLen;
    uint32_t dynLen;
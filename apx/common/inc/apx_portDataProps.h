@@ -39,11 +39,15 @@ typedef struct apx_portDataProps_tag
 {
    apx_portId_t portId;
    apx_size_t dataSize; //Size of the data portion on the port data
+   apx_size_t elementSize; //Size of one element. Same as dataSize unless the port is queued
+   apx_size_t arrayElementSize; //Size of one array element of a dynamic array port
    apx_offset_t offset; //offset in file
    apx_portType_t portType; //Is this a provide or require port?
    apx_queLenType_t queLenType; //Is this a queued port?
-   bool isDynamicArray; //True if elementSize can vary from element to element
+   bool isDynamicArray; //True if the port data is a dynamic array. Only its length header and used elements need to be transferred
+   apx_dynLenType_t dynLenType; //Type of the array length header in front of dynamic array data
    apx_size_t maxQueLen; //What is the maximum length of the queue?
+   bool isEvent; //True if every write to the port must reach the receiver (E attribute)
 } apx_portDataProps_t;
 
 //////////////////////////////////////////////////////////////////////////////
@@ -55,6 +59,14 @@ void apx_portDataProps_delete(apx_portDataProps_t *self);
 void apx_portDataProps_vdelete(void *arg);
 
 bool apx_portDataProps_isPlainOldData(const apx_portDataProps_t *self);
+void apx_portDataProps_setQueued(apx_portDataProps_t *self, apx_size_t maxQueLen);
+bool apx_portDataProps_isQueued(const apx_portDataProps_t *self);
+bool apx_portDataProps_isConflatable(const apx_portDataProps_t *self);
+apx_size_t apx_portDataProps_getQueLenSize(const apx_portDataProps_t *self);
+void apx_portDataProps_setDynamicArray(apx_portDataProps_t *self, apx_dynLenType_t dynLenType, uint32_t maxArrayLen);
+apx_size_t apx_portDataProps_getDynLenSize(const apx_portDataProps_t *self);
+apx_size_t apx_portDataProps_getUsedDataSize(const apx_portDataProps_t *self, const uint8_t *data, apx_size_t len);
+apx_size_t apx_portDataProps_calcDynArrayDataSize(apx_dynLenType_t dynLenType, apx_size_t arrayElementSize, apx_size_t maxDataSize, const uint8_t *data, apx_size_t len);
 
 apx_size_t apx_portDataProps_sumDataSize(const apx_portDataProps_t *propsArray, apx_portCount_t numPorts);
 
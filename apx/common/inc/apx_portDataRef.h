@@ -45,6 +45,7 @@ typedef struct apx_portRef_tag
    struct apx_nodeInstance_tag *nodeInstance; //weak reference to parent nodeInstance
    const apx_portDataProps_t *portDataProps; //weak reference to port data properties
    apx_uniquePortId_t portId; //This is a provide-port ID if APX_PORT_ID_PROVIDE_PORT is set, otherwise it's a require-port ID.
+   apx_signatureId_t signatureId; //Set by apx_portSignatureMap when the port is connected, APX_INVALID_SIGNATURE_ID before that.
 } apx_portRef_t;
 
 //////////////////////////////////////////////////////////////////////////////
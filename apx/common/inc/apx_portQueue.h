@@ -0,0 +1,90 @@
+/*****************************************************************************
+* \file      apx_portQueue.h
+* \author    Conny Gustafsson
+* \date      2026-10-18
+* \brief     Element queue and transfer state of a queued (Q[N]) port
+*
+* Copyright (c) 2026 Conny Gustafsson
+* Permission is hereby granted, free of charge, to any person obtaining a copy of
+* this software and associated documentation files (the "Software"), to deal in
+* the Software without restriction, including without limitation the rights to
+* use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+* the Software, and to permit persons to whom the Software is furnished to do so,
+* subject to the following conditions:
+
+* The above copyright notice and this permission notice shall be included in all
+* copies or substantial portions of the Software.
+
+* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+* IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+* FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+* COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+* IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+* CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+*
+******************************************************************************/
+#ifndef APX_PORT_QUEUE_H
+#define APX_PORT_QUEUE_H
+
+//////////////////////////////////////////////////////////////////////////////
+// INCLUDES
+//////////////////////////////////////////////////////////////////////////////
+#include "apx_types.h"
+#include "apx_error.h"
+#include "apx_spscRing.h"
+#include "apx_portDataProps.h"
+#ifdef _WIN32
+# ifndef WIN32_LEAN_AND_MEAN
+# define WIN32_LEAN_AND_MEAN
+# endif
+# include <Windows.h>
+#else
+# include <pthread.h>
+#endif
+#include "osmacro.h"
+
+//////////////////////////////////////////////////////////////////////////////
+// PUBLIC CONSTANTS AND DATA TYPES
+//////////////////////////////////////////////////////////////////////////////
+
+/**
+ * Buffers elements written to (or received on) a queued port until they can be transferred or read.
+ * On the wire a queued port carries a little-endian element count (queLenSize bytes) followed by up to maxQueLen
+ * packed elements. Every element pushed into the queue is delivered exactly once, elements that do not fit
+ * into one transfer are sent in the next one.
+ * The element ring is single-producer/single-consumer. Any number of threads may push or read: producerLock
+ * serializes the producing side (push, unpackTransfer) and consumerLock the consuming side (read, packTransfer),
+ * so the ring itself only ever sees one thread at each end. isTransferPending makes sure that at most
+ * one transfer per port is waiting in the file manager worker at any time.
+ */
+typedef struct apx_portQueue_tag
+{
+   apx_spscRing_t elements;
+   apx_size_t maxQueLen; //maximum number of elements in one transfer
+   apx_size_t queLenSize; //size of element count in front of the elements
+   volatile uint32_t isTransferPending;
+   volatile uint32_t numDroppedElements; //elements lost because the ring was full
+   SPINLOCK_T producerLock;
+   SPINLOCK_T consumerLock;
+} apx_portQueue_t;
+
+//////////////////////////////////////////////////////////////////////////////
+// PUBLIC FUNCTION PROTOTYPES
+//////////////////////////////////////////////////////////////////////////////
+apx_error_t apx_portQueue_create(apx_portQueue_t *self, const apx_portDataProps_t *props, uint32_t depthFactor);
+void apx_portQueue_destroy(apx_portQueue_t *self);
+apx_portQueue_t *apx_portQueue_new(const apx_portDataProps_t *props, uint32_t depthFactor);
+void apx_portQueue_delete(apx_portQueue_t *self);
+apx_error_t apx_portQueue_push(apx_portQueue_t *self, const uint8_t *element);
+uint32_t apx_portQueue_read(apx_portQueue_t *self, uint8_t *dest, uint32_t maxNumElements);
+uint32_t apx_portQueue_length(apx_portQueue_t *self);
+uint32_t apx_portQueue_capacity(const apx_portQueue_t *self);
+apx_size_t apx_portQueue_elementSize(const apx_portQueue_t *self);
+apx_size_t apx_portQueue_getTransferSize(apx_portQueue_t *self);
+apx_size_t apx_portQueue_packTransfer(apx_portQueue_t *self, uint8_t *dest, apx_size_t destLen);
+apx_error_t apx_portQueue_unpackTransfer(apx_portQueue_t *self, const uint8_t *src, apx_size_t len);
+bool apx_portQueue_requestTransfer(apx_portQueue_t *self);
+void apx_portQueue_completeTransfer(apx_portQueue_t *self);
+uint32_t apx_portQueue_getNumDroppedElements(apx_portQueue_t *self);
+
+#endif //APX_PORT_QUEUE_H
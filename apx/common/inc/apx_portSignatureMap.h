@@ -29,10 +29,10 @@
 //////////////////////////////////////////////////////////////////////////////
 // INCLUDES
 //////////////////////////////////////////////////////////////////////////////
-#include "adt_hash.h"
 #include "apx_types.h"
 #include "apx_error.h"
 #include "apx_portSignatureMapEntry.h"
+#include "apx_signatureTable.h"
 //////////////////////////////////////////////////////////////////////////////
 // PUBLIC CONSTANTS AND DATA TYPES
 //////////////////////////////////////////////////////////////////////////////
@@ -41,7 +41,10 @@ struct apx_nodeInstance_tag;
 
 typedef struct apx_portSignatureMap_tag
 {
-   adt_hash_t internalMap; //strong references to apx_portSignatureMapEntry_t. The hash key is the portSignature string.
+   apx_signatureTable_t signatureTable; //Port signatures seen by this map. The ID of each signature is stored in the apx_portRef_t of connected ports.
+   apx_portSignatureMapEntry_t **entries; //strong references to apx_portSignatureMapEntry_t, indexed by apx_signatureId_t. NULL when no port uses the signature.
+   uint32_t entriesLen; //allocated length of entries
+   int32_t numEntries; //number of non-NULL elements in entries
 } apx_portSignatureMap_t;
 
 //////////////////////////////////////////////////////////////////////////////
@@ -53,7 +56,9 @@ apx_portSignatureMap_t *apx_portSignatureMap_new(void);
 void apx_portSignatureMap_delete(apx_portSignatureMap_t *self);
 
 apx_portSignatureMapEntry_t *apx_portSignatureMap_find(apx_portSignatureMap_t *self, const char *portSignature);
+apx_portSignatureMapEntry_t *apx_portSignatureMap_findById(apx_portSignatureMap_t *self, apx_signatureId_t signatureId);
 int32_t apx_portSignatureMap_length(apx_portSignatureMap_t *self);
+void apx_portSignatureMap_getSignatureTableStats(apx_portSignatureMap_t *self, apx_signatureTableStats_t *stats);
 apx_error_t apx_portSignatureMap_connectProvidePorts(apx_portSignatureMap_t *self, struct apx_nodeInstance_tag *nodeInstance);
 apx_error_t apx_portSignatureMap_connectRequirePorts(apx_portSignatureMap_t *self, struct apx_nodeInstance_tag *nodeInstance);
 apx_error_t apx_portSignatureMap_disconnectProvidePorts(apx_portSignatureMap_t *self, struct apx_nodeInstance_tag *nodeInstance);
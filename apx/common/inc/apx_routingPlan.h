@@ -0,0 +1,110 @@
+/*****************************************************************************
+* \file      apx_routingPlan.h
+* \author    Conny Gustafsson
+* \date      2026-10-18
+* \brief     Immutable data routing plan for the provide ports of one node
+*
+* Copyright (c) 2026 Conny Gustafsson
+* Permission is hereby granted, free of charge, to any person obtaining a copy of
+* this software and associated documentation files (the "Software"), to deal in
+* the Software without restriction, including without limitation the rights to
+* use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+* the Software, and to permit persons to whom the Software is furnished to do so,
+* subject to the following conditions:
+
+* The above copyright notice and this permission notice shall be included in all
+* copies or substantial portions of the Software.
+
+* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+* IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+* FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+* COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+* IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+* CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+*
+******************************************************************************/
+#ifndef APX_ROUTING_PLAN_H
+#define APX_ROUTING_PLAN_H
+
+//////////////////////////////////////////////////////////////////////////////
+// INCLUDES
+//////////////////////////////////////////////////////////////////////////////
+#include "apx_types.h"
+#include "apx_error.h"
+#include "apx_nodeInfo.h"
+#include "apx_portConnectorList.h"
+
+//////////////////////////////////////////////////////////////////////////////
+// PUBLIC CONSTANTS AND DATA TYPES
+//////////////////////////////////////////////////////////////////////////////
+struct apx_nodeInstance_tag;
+
+#define APX_ROUTING_WRITE_NO_SRC_OFFSET 0xFFFFFFFFu //write no longer maps to one contiguous range of the routed data
+
+typedef struct apx_routingPlanEntry_tag
+{
+   struct apx_nodeInstance_tag *destNodeInstance; //weak reference
+   uint32_t destOffset; //byte offset in require port data of destNodeInstance
+   apx_portId_t destPortId; //require port ID in destNodeInstance
+} apx_routingPlanEntry_t;
+
+typedef struct apx_routingPlanPort_tag
+{
+   uint32_t srcOffset; //byte offset in provide port data
+   uint32_t dataSize;
+   uint32_t firstEntry; //index of first apx_routingPlanEntry_t
+   uint32_t numEntries;
+   apx_queLenType_t queLenType; //APX_QUE_LEN_NONE unless this is a queued port. Queued elements are routed through port queues instead of require port data
+   apx_dynLenType_t dynLenType; //APX_DYN_LEN_NONE unless this is a dynamic array port. Only the used part of the array is routed
+   uint32_t arrayElementSize; //size of one array element when dynLenType is set
+} apx_routingPlanPort_t;
+
+/**
+ * One write to require port data generated while routing provide port data
+ */
+typedef struct apx_routingWrite_tag
+{
+   struct apx_nodeInstance_tag *destNodeInstance; //weak reference
+   uint32_t destOffset;
+   uint32_t len;
+   uint32_t srcOffset; //byte offset in the routed data where this write begins (or APX_ROUTING_WRITE_NO_SRC_OFFSET)
+} apx_routingWrite_t;
+
+typedef struct apx_routingStats_tag
+{
+   uint32_t numRoutedWrites; //number of require port writes before coalescing
+   uint32_t numTransmittedWrites; //number of writes actually sent to receivers after coalescing
+   uint32_t numSourceWrites; //number of provide port data writes seen by the router (while at least one receiver is connected)
+   uint64_t numSourceBytes; //number of provide port data bytes seen by the router
+   uint64_t numRoutedBytes; //number of bytes written into require port data of receivers
+   uint32_t maxFanOut; //largest number of require port writes generated by a single provide port data write
+} apx_routingStats_t;
+
+/**
+ * Snapshot of the port connector table of a provide node, optimized for routing.
+ * Only provide ports having at least one receiver with identical data layout (plain old data or same queue) are part of the plan. These are sorted by srcOffset.
+ * A plan is never modified after it has been built, instead a new plan is built and swapped in by the node instance.
+ */
+typedef struct apx_routingPlan_tag
+{
+   apx_routingPlanPort_t *ports; //strong reference
+   apx_routingPlanEntry_t *entries; //strong reference
+   uint32_t numPorts;
+   uint32_t numEntries;
+} apx_routingPlan_t;
+
+//////////////////////////////////////////////////////////////////////////////
+// PUBLIC FUNCTION PROTOTYPES
+//////////////////////////////////////////////////////////////////////////////
+void apx_routingPlan_create(apx_routingPlan_t *self);
+void apx_routingPlan_destroy(apx_routingPlan_t *self);
+apx_routingPlan_t *apx_routingPlan_new(void);
+void apx_routingPlan_delete(apx_routingPlan_t *self);
+void apx_routingPlan_vdelete(void *arg);
+apx_error_t apx_routingPlan_build(apx_routingPlan_t *self, const apx_nodeInfo_t *nodeInfo, apx_portConnectorList_t *connectorTable);
+uint32_t apx_routingPlan_findFirstPort(const apx_routingPlan_t *self, uint32_t offset);
+uint32_t apx_routingPlan_getNumPorts(const apx_routingPlan_t *self);
+uint32_t apx_routingPlan_getNumEntries(const apx_routingPlan_t *self);
+uint32_t apx_routingPlan_coalesceWrites(apx_routingWrite_t *writes, uint32_t numWrites);
+
+#endif //APX_ROUTING_PLAN_H
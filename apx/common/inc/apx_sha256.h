@@ -0,0 +1,56 @@
+/*****************************************************************************
+* \file      apx_sha256.h
+* \author    Conny Gustafsson
+* \date      2026-10-18
+* \brief     SHA-256 message digest
+*
+* Copyright (c) 2026 Conny Gustafsson
+* Permission is hereby granted, free of charge, to any person obtaining a copy of
+* this software and associated documentation files (the "Software"), to deal in
+* the Software without restriction, including without limitation the rights to
+* use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+* the Software, and to permit persons to whom the Software is furnished to do so,
+* subject to the following conditions:
+
+* The above copyright notice and this permission notice shall be included in all
+* copies or substantial portions of the Software.
+
+* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+* IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+* FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+* COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+* IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+* CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+*
+******************************************************************************/
+#ifndef APX_SHA256_H
+#define APX_SHA256_H
+
+//////////////////////////////////////////////////////////////////////////////
+// INCLUDES
+//////////////////////////////////////////////////////////////////////////////
+#include "apx_types.h"
+
+//////////////////////////////////////////////////////////////////////////////
+// PUBLIC CONSTANTS AND DATA TYPES
+//////////////////////////////////////////////////////////////////////////////
+#define APX_SHA256_BLOCK_SIZE 64u
+#define APX_SHA256_DIGEST_SIZE 32u
+
+typedef struct apx_sha256_tag
+{
+   uint32_t state[8];
+   uint64_t totalLen; //number of bytes processed so far
+   uint8_t block[APX_SHA256_BLOCK_SIZE];
+   uint32_t blockLen; //number of bytes currently in block
+} apx_sha256_t;
+
+//////////////////////////////////////////////////////////////////////////////
+// PUBLIC FUNCTION PROTOTYPES
+//////////////////////////////////////////////////////////////////////////////
+void apx_sha256_init(apx_sha256_t *self);
+void apx_sha256_update(apx_sha256_t *self, const uint8_t *data, uint32_t dataLen);
+void apx_sha256_final(apx_sha256_t *self, uint8_t *digest);
+void apx_sha256_calc(const uint8_t *data, uint32_t dataLen, uint8_t *digest);
+
+#endif //APX_SHA256_H
@@ -0,0 +1,89 @@
+/*****************************************************************************
+* \file      apx_signatureTable.h
+* \author    Conny Gustafsson
+* \date      2026-10-18
+* \brief     Interns port signature strings as compact integer IDs
+*
+* Copyright (c) 2026 Conny Gustafsson
+* Permission is hereby granted, free of charge, to any person obtaining a copy of
+* this software and associated documentation files (the "Software"), to deal in
+* the Software without restriction, including without limitation the rights to
+* use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+* the Software, and to permit persons to whom the Software is furnished to do so,
+* subject to the following conditions:
+
+* The above copyright notice and this permission notice shall be included in all
+* copies or substantial portions of the Software.
+
+* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+* IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+* FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+* COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+* IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+* CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+*
+******************************************************************************/
+#ifndef APX_SIGNATURE_TABLE_H
+#define APX_SIGNATURE_TABLE_H
+
+//////////////////////////////////////////////////////////////////////////////
+// INCLUDES
+//////////////////////////////////////////////////////////////////////////////
+#include <stddef.h>
+#include "apx_types.h"
+#include "apx_error.h"
+
+//////////////////////////////////////////////////////////////////////////////
+// PUBLIC CONSTANTS AND DATA TYPES
+//////////////////////////////////////////////////////////////////////////////
+typedef struct apx_signatureTableStats_tag
+{
+   uint32_t numSignatures; //number of interned signatures currently in use
+   uint32_t numBuckets;
+   size_t memoryUsage; //bytes used by the table, including the signature strings
+   uint32_t numLookups; //calls to apx_signatureTable_intern and apx_signatureTable_find
+   uint32_t numProbes; //hash buckets visited by all lookups, numProbes/numLookups is the average lookup cost
+   uint32_t numStringCompares; //full string compares, only done when the 64-bit hashes are equal
+} apx_signatureTableStats_t;
+
+/**
+ * Symbol table for port signatures. Each distinct signature string is stored once and is given
+ * an ID in the range 0..numIds-1. Signatures are reference counted, each call to apx_signatureTable_intern
+ * must be matched by a call to apx_signatureTable_release. The ID of a released signature is reused.
+ * Lookups compare 64-bit hashes and only fall back to comparing strings when the hashes are equal.
+ * This class is not thread-safe, the server protects it with its globalLock.
+ */
+typedef struct apx_signatureTable_tag
+{
+   uint32_t *buckets; //open addressing (linear probing), each bucket holds signatureId+1 or 0 when unused
+   uint32_t numBuckets; //always a power of two
+   char **signatures; //strong references, indexed by apx_signatureId_t. NULL for released IDs.
+   uint64_t *hashes; //indexed by apx_signatureId_t
+   uint32_t *refCounts; //indexed by apx_signatureId_t
+   apx_signatureId_t *freeIds; //stack of released IDs
+   uint32_t numFreeIds;
+   uint32_t numIds; //number of IDs handed out so far, including released ones
+   uint32_t numSignatures; //numIds - numFreeIds
+   uint32_t capacity; //allocated length of signatures, hashes, refCounts and freeIds
+   size_t stringBytes;
+   uint32_t numLookups;
+   uint32_t numProbes;
+   uint32_t numStringCompares;
+} apx_signatureTable_t;
+
+//////////////////////////////////////////////////////////////////////////////
+// PUBLIC FUNCTION PROTOTYPES
+//////////////////////////////////////////////////////////////////////////////
+void apx_signatureTable_create(apx_signatureTable_t *self);
+void apx_signatureTable_destroy(apx_signatureTable_t *self);
+apx_signatureTable_t *apx_signatureTable_new(void);
+void apx_signatureTable_delete(apx_signatureTable_t *self);
+apx_error_t apx_signatureTable_intern(apx_signatureTable_t *self, const char *signature, apx_signatureId_t *signatureId);
+void apx_signatureTable_release(apx_signatureTable_t *self, apx_signatureId_t signatureId);
+apx_signatureId_t apx_signatureTable_find(apx_signatureTable_t *self, const char *signature);
+const char *apx_signatureTable_getSignature(const apx_signatureTable_t *self, apx_signatureId_t signatureId);
+int32_t apx_signatureTable_length(const apx_signatureTable_t *self);
+void apx_signatureTable_getStats(const apx_signatureTable_t *self, apx_signatureTableStats_t *stats);
+uint64_t apx_signatureTable_hash(const char *signature);
+
+#endif //APX_SIGNATURE_TABLE_H
@@ -0,0 +1,71 @@
+/*****************************************************************************
+* \file      apx_spscRing.h
+* \author    Conny Gustafsson
+* \date      2026-10-18
+* \brief     Bounded lock-free single-producer/single-consumer ring buffer
+*
+* Copyright (c) 2026 Conny Gustafsson
+* Permission is hereby granted, free of charge, to any person obtaining a copy of
+* this software and associated documentation files (the "Software"), to deal in
+* the Software without restriction, including without limitation the rights to
+* use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+* the Software, and to permit persons to whom the Software is furnished to do so,
+* subject to the following conditions:
+
+* The above copyright notice and this permission notice shall be included in all
+* copies or substantial portions of the Software.
+
+* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+* IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+* FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+* COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+* IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+* CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+*
+******************************************************************************/
+#ifndef APX_SPSC_RING_H
+#define APX_SPSC_RING_H
+
+//////////////////////////////////////////////////////////////////////////////
+// INCLUDES
+//////////////////////////////////////////////////////////////////////////////
+#include "apx_types.h"
+#include "apx_error.h"
+
+//////////////////////////////////////////////////////////////////////////////
+// PUBLIC CONSTANTS AND DATA TYPES
+//////////////////////////////////////////////////////////////////////////////
+#define APX_SPSC_RING_CACHE_LINE_SIZE 64
+
+/**
+ * Fixed-size ring of equally sized elements where exactly one thread pushes and exactly one thread reads.
+ * Elements are stored back-to-back without per-slot headers, which makes it possible to copy a batch of
+ * elements in (at most) two memcpy calls. Read and write positions are free running counters.
+ */
+typedef struct apx_spscRing_tag
+{
+   uint8_t *elements;
+   uint32_t numSlots; //always a power of two
+   uint32_t mask;
+   uint32_t elemSize;
+   uint8_t padding1[APX_SPSC_RING_CACHE_LINE_SIZE];
+   volatile uint32_t writePos; //written by producer
+   uint8_t padding2[APX_SPSC_RING_CACHE_LINE_SIZE];
+   volatile uint32_t readPos; //written by consumer
+} apx_spscRing_t;
+
+//////////////////////////////////////////////////////////////////////////////
+// PUBLIC FUNCTION PROTOTYPES
+//////////////////////////////////////////////////////////////////////////////
+apx_error_t apx_spscRing_create(apx_spscRing_t *self, uint32_t elemSize, uint32_t minNumElems);
+void apx_spscRing_destroy(apx_spscRing_t *self);
+apx_spscRing_t *apx_spscRing_new(uint32_t elemSize, uint32_t minNumElems);
+void apx_spscRing_delete(apx_spscRing_t *self);
+apx_error_t apx_spscRing_push(apx_spscRing_t *self, const void *elem);
+uint32_t apx_spscRing_pushMany(apx_spscRing_t *self, const uint8_t *elems, uint32_t numElems);
+uint32_t apx_spscRing_read(apx_spscRing_t *self, uint8_t *dest, uint32_t maxNumElems);
+uint32_t apx_spscRing_length(apx_spscRing_t *self);
+uint32_t apx_spscRing_capacity(const apx_spscRing_t *self);
+uint32_t apx_spscRing_elementSize(const apx_spscRing_t *self);
+
+#endif //APX_SPSC_RING_H
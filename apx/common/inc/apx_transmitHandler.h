@@ -14,6 +14,12 @@
 // CONSTANTS AND DATA TYPES
 //////////////////////////////////////////////////////////////////////////////
 
+typedef struct apx_transmitSegment_tag
+{
+   const uint8_t *data;
+   int32_t dataLen;
+} apx_transmitSegment_t;
+
 typedef struct apx_transmitHandler_tag
 {
    void *arg; //user argument
@@ -27,6 +33,12 @@ typedef struct apx_transmitHandler_tag
    //New API
    uint8_t* (*getMsgBuffer)(void *arg, int32_t *maxMsgLen, int32_t *sendAvail); //Returns a pointer to a message buffer, maxMsgLen is the maximum allowed message length, sendAvail is the number of bytes free in the underlying send buffer
    int32_t (*sendMsg)(void *arg, int32_t offset, int32_t msgLen); //Sends one message. Returns number of bytes consumed from underlying send buffer. MsgBuffer is free to use again after this call.
+
+   //Batch API (optional)
+   int32_t (*sendFramed)(void *arg, const uint8_t *data, int32_t dataLen); //Transmits one or more messages that are already prefixed with numHeader. Returns number of bytes sent or -1 on failure.
+
+   //Gather API (optional)
+   int32_t (*sendGather)(void *arg, const apx_transmitSegment_t *segments, int32_t numSegments); //Transmits the segments back-to-back as one contiguous byte stream (already prefixed with numHeader). Returns total number of bytes sent or -1 on failure.
 } apx_transmitHandler_t;
 //////////////////////////////////////////////////////////////////////////////
 // GLOBAL VARIABLES
@@ -27,6 +27,7 @@ typedef uint8_t apx_mode_t; //APX_NO_MODE, APX_CLIENT_MODE, APX_SERVER_MODE
 typedef uint16_t apx_eventId_t;
 typedef uint8_t apx_programType_t; //APX_PACK_PROGRAM, APX_UNPACK_PROGRAM
 typedef uint8_t apx_fileType_t;
+typedef uint32_t apx_signatureId_t; //compact ID of an interned port signature, see apx_signatureTable_t
 
 typedef struct apx_dataWriteCmd_tag
 {
@@ -36,6 +37,8 @@ typedef struct apx_dataWriteCmd_tag
 
 #define APX_DATA_WRITE_CMD_SIZE sizeof(apx_dataWriteCmd_t)
 
+#define APX_INVALID_SIGNATURE_ID ((apx_signatureId_t) 0xFFFFFFFFu)
+
 #define APX_CONNECTION_TYPE_TEST_SOCKET       0
 #define APX_CONNECTION_TYPE_TCP_SOCKET        1
 #define APX_CONNECTION_TYPE_LOCAL_SOCKET      2
@@ -35,7 +35,9 @@
 #include "apx_error.h"
 #include "apx_vmSerializer.h"
 #include "apx_vmDeserializer.h"
+#include "apx_copyPlan.h"
 #include "dtl_type.h"
+#include <stddef.h>
 
 //////////////////////////////////////////////////////////////////////////////
 // PUBLIC CONSTANTS AND DATA TYPES
@@ -56,6 +58,24 @@ typedef struct apx_vm_tag
    apx_dynLenType_t dynLenType;
 } apx_vm_t;
 
+/**
+ * Describes where one leaf (non-record) data element of a program is located inside a native C struct.
+ * Layout tables list elements in the same order as they appear in the program (depth-first for records).
+ */
+typedef struct apx_vmNativeElement_tag
+{
+   apx_size_t offset; //byte offset of member in native struct
+   apx_size_t size; //byte size of member in native struct (element size times array length)
+} apx_vmNativeElement_t;
+
+typedef struct apx_vmNativeLayout_tag
+{
+   const apx_vmNativeElement_t *elements; //weak reference
+   uint32_t numElements;
+} apx_vmNativeLayout_t;
+
+#define APX_VM_NATIVE_ELEMENT(type, member) { (apx_size_t) offsetof(type, member), (apx_size_t) sizeof(((type*)0)->member) }
+
 //////////////////////////////////////////////////////////////////////////////
 // PUBLIC FUNCTION PROTOTYPES
 //////////////////////////////////////////////////////////////////////////////
@@ -71,6 +91,8 @@ apx_error_t apx_vm_setReadBuffer(apx_vm_t *self, const uint8_t *buffer, uint32_t
 apx_error_t apx_vm_packValue(apx_vm_t *self, const dtl_dv_t *dv);
 apx_error_t apx_vm_unpackValue(apx_vm_t *self, dtl_dv_t **dv);
 apx_error_t apx_vm_writeNullValue(apx_vm_t *self);
+apx_error_t apx_vm_packNative(apx_vm_t *self, uint8_t *buffer, apx_size_t bufSize, const void *nativeData, const apx_vmNativeLayout_t *layout);
+apx_error_t apx_vm_unpackNative(apx_vm_t *self, const uint8_t *buffer, apx_size_t bufSize, void *nativeData, const apx_vmNativeLayout_t *layout);
 #ifdef UNIT_TEST
 apx_size_t apx_vm_getBytesWritten(apx_vm_t *self);
 apx_size_t apx_vm_getBytesRead(apx_vm_t *self);
@@ -79,6 +101,9 @@ apx_size_t apx_vm_getBytesRead(apx_vm_t *self);
 //state-less functions
 apx_error_t apx_vm_decodeProgramHeader(const adt_bytes_t *program, uint8_t *majorVersion, uint8_t *minorVersion, uint8_t *progType, apx_size_t *maxDataSize);
 apx_error_t apx_vm_decodeProgramDataProps(const adt_bytes_t *program, apx_size_t *dataSize, uint8_t *dataFlags);
+apx_error_t apx_vm_decodeDynArrayProps(const adt_bytes_t *program, apx_dynLenType_t *dynLenType, uint32_t *maxArrayLen);
 apx_error_t apx_vm_decodeInstruction(uint8_t instruction, uint8_t *opcode, uint8_t *variant, uint8_t *flags);
+apx_error_t apx_vm_packCopyPlan(const apx_copyPlan_t *plan, uint8_t *buffer, apx_size_t bufSize, const void *nativeData, const apx_vmNativeLayout_t *layout);
+apx_error_t apx_vm_unpackCopyPlan(const apx_copyPlan_t *plan, const uint8_t *buffer, apx_size_t bufSize, void *nativeData, const apx_vmNativeLayout_t *layout);
 
 #endif //APX_VM_H
@@ -1,16 +1,11 @@
 //////////////////////////////////////////////////////////////////////////////
 // INCLUDES
 //////////////////////////////////////////////////////////////////////////////
-#include <errno.h>
 #include <malloc.h>
 #include <assert.h>
 #include <string.h>
-#include <stdio.h>
-#ifdef _MSC_VER
-#include <process.h>
-#endif
 #include "apx_allocator.h"
-#include "apx_logging.h"
+#include "apx_atomic.h"
 #ifdef MEM_LEAK_CHECK
 #include "CMemLeak.h"
 #endif
@@ -19,16 +14,15 @@
 //////////////////////////////////////////////////////////////////////////////
 // CONSTANTS AND DATA TYPES
 //////////////////////////////////////////////////////////////////////////////
+#define SLAB_HEADER_SIZE 16u //room for the slab list link while keeping blocks 16-byte aligned
 
 //////////////////////////////////////////////////////////////////////////////
 // LOCAL FUNCTION PROTOTYPES
 //////////////////////////////////////////////////////////////////////////////
-#ifndef UNIT_TEST
-static int8_t apx_allocator_startThread(apx_allocator_t *self);
-static THREAD_PROTO(threadTask,arg);
-#endif
-static bool apx_allocator_processEvent(apx_allocator_t *self);
-
+static int32_t apx_allocator_getSizeClassIndex(size_t size);
+static uint8_t *apx_allocator_allocBlock(apx_allocator_t *self, apx_allocatorSizeClass_t *sizeClass);
+static bool apx_allocator_addSlab(apx_allocator_t *self, apx_allocatorSizeClass_t *sizeClass);
+static void apx_allocator_updateStats(apx_allocator_t *self, uint32_t size);
 
 //////////////////////////////////////////////////////////////////////////////
 // GLOBAL VARIABLES
@@ -42,31 +36,17 @@ static bool apx_allocator_processEvent(apx_allocator_t *self);
 //////////////////////////////////////////////////////////////////////////////
 // GLOBAL FUNCTIONS
 //////////////////////////////////////////////////////////////////////////////
-apx_error_t apx_allocator_create(apx_allocator_t *self, uint16_t maxPendingMessages)
+apx_error_t apx_allocator_create(apx_allocator_t *self)
 {
    if (self != 0)
    {
-      size_t elemSize = sizeof(rbf_data_t);
-      adt_buf_err_t bufResult;
-
-      bufResult = adt_rbfh_createEx(&self->messages, (uint8_t) elemSize, ADT_RBFSH_MIN_NUM_ELEMS_DEFAULT, maxPendingMessages);
-      if (bufResult != BUF_E_OK)
+      int32_t i;
+      memset(self, 0, sizeof(apx_allocator_t));
+      for (i = 0; i < APX_ALLOCATOR_NUM_SIZE_CLASSES; i++)
       {
-         return APX_MEM_ERROR;
+         self->sizeClasses[i].blockSize = APX_ALLOCATOR_MIN_BLOCK_SIZE << i;
       }
-
-#ifdef _WIN32
-      self->workerThread = INVALID_HANDLE_VALUE;
-#else
-      self->workerThread = 0;
-#endif
-      self->workerThreadValid=false;
       SPINLOCK_INIT(self->lock);
-#ifndef UNIT_TEST
-      SEMAPHORE_CREATE(self->semaphore);
-#endif
-      self->isRunning = false;
-      soa_init(&self->soa);
       return APX_NO_ERROR;
    }
    return APX_INVALID_ARGUMENT_ERROR;
@@ -76,70 +56,15 @@ void apx_allocator_destroy(apx_allocator_t *self)
 {
    if (self != 0)
    {
-      adt_rbfh_destroy(&self->messages);
-      soa_destroy(&self->soa);
-#ifndef UNIT_TEST
-      SEMAPHORE_DESTROY(self->semaphore);
-#endif
-      SPINLOCK_DESTROY(self->lock);
-   }
-}
-
-void apx_allocator_start(apx_allocator_t *self)
-{
-#ifndef UNIT_TEST
-   if( (self != 0) && (self->workerThreadValid == false) )
-   {
-      apx_allocator_startThread(self);
-   }
-#endif
-}
-
-void apx_allocator_stop(apx_allocator_t *self)
-{
-   if( (self != 0) && (self->workerThreadValid == true) )
-   {
-#ifdef _MSC_VER
-      DWORD result;
-#endif
-      rbf_data_t data = {0,0}; //sending a null-pointer with size 0 should wake up the workerThread
-      //1. enqueue message
-      SPINLOCK_ENTER(self->lock);
-      self->isRunning = false;
-      adt_rbfh_insert(&self->messages,(const uint8_t*) &data);
-      SPINLOCK_LEAVE(self->lock);
-      //2. wake workerThread
-#ifndef UNIT_TEST
-      SEMAPHORE_POST(self->semaphore);
-#endif
-#ifdef _MSC_VER
-      result = WaitForSingleObject(self->workerThread, 5000);
-      if (result == WAIT_TIMEOUT)
+      apx_allocatorBlock_t *slab = self->slabs;
+      while (slab != 0)
       {
-         APX_LOG_ERROR("[APX_ALLOCATOR] timeout while joining workerThread");
+         apx_allocatorBlock_t *next = slab->next;
+         free(slab);
+         slab = next;
       }
-      else if (result == WAIT_FAILED)
-      {
-         DWORD lastError = GetLastError();
-         APX_LOG_ERROR("[APX_ALLOCATOR]  joining workerThread failed with %d", (int)lastError);         
-      }
-      CloseHandle(self->workerThread);
-      self->workerThread = INVALID_HANDLE_VALUE;
-#else
-      if(pthread_equal(pthread_self(),self->workerThread) == 0)
-      {
-         void *status;
-         int s = pthread_join(self->workerThread, &status);
-         if (s != 0)
-         {
-            APX_LOG_ERROR("[APX_ALLOCATOR] pthread_join error %d\n",s);
-         }
-      }
-      else
-      {
-         APX_LOG_ERROR("[APX_ALLOCATOR] pthread_join attempted on pthread_self()\n");
-      }
-#endif
+      self->slabs = (apx_allocatorBlock_t*) 0;
+      SPINLOCK_DESTROY(self->lock);
    }
 }
 
@@ -148,187 +73,167 @@ uint8_t *apx_allocator_alloc(apx_allocator_t *self, size_t size)
    uint8_t *data = 0;
    if ( (self != 0) && (size > 0) )
    {
-      if (size <= SOA_SMALL_OBJECT_MAX_SIZE)
+      int32_t index = apx_allocator_getSizeClassIndex(size);
+      if (index >= 0)
       {
-         //use the small object allocator
          SPINLOCK_ENTER(self->lock);
-         data = (uint8_t*) soa_alloc(&self->soa, size);
+         data = apx_allocator_allocBlock(self, &self->sizeClasses[index]);
+         if (data != 0)
+         {
+            apx_allocator_updateStats(self, (uint32_t) size);
+         }
          SPINLOCK_LEAVE(self->lock);
       }
       else
       {
          //use the default allocator
          data = (uint8_t*) malloc(size);
+         if (data != 0)
+         {
+            SPINLOCK_ENTER(self->lock);
+            self->stats.numLargeAllocs++;
+            apx_allocator_updateStats(self, (uint32_t) size);
+            SPINLOCK_LEAVE(self->lock);
+         }
       }
    }
    return data;
 }
 
+/**
+ * Releases memory previously returned by apx_allocator_alloc. size must be the same value as was given to apx_allocator_alloc.
+ * Small blocks are pushed to a lock-free stack owned by their size class, the next allocation of the same size class reclaims them.
+ */
 void apx_allocator_free(apx_allocator_t *self, uint8_t *ptr, size_t size)
 {
-   if (self != 0)
-   {
-      rbf_data_t data;
-      data.ptr=ptr;
-      data.size=(uint32_t) size;
-      //1. enqueue message
-      SPINLOCK_ENTER(self->lock);
-      adt_rbfh_insert(&self->messages,(const uint8_t*) &data);
-      SPINLOCK_LEAVE(self->lock);
-#ifndef UNIT_TEST
-      //2. wake worker thread
-      SEMAPHORE_POST(self->semaphore);
-#endif
-   }
-}
-
-bool apx_allocator_isRunning(apx_allocator_t *self)
-{
-   if ( self != 0)
+   if ( (self != 0) && (ptr != 0) )
    {
-      return self->isRunning;
+      int32_t index = apx_allocator_getSizeClassIndex(size);
+      if (index >= 0)
+      {
+         apx_allocatorSizeClass_t *sizeClass = &self->sizeClasses[index];
+         apx_allocatorBlock_t *block = (apx_allocatorBlock_t*) ptr;
+         void *head;
+         do
+         {
+            head = apx_atomic_loadPtr(&sizeClass->returnedBlocks);
+            block->next = (apx_allocatorBlock_t*) head;
+         } while (apx_atomic_compareExchangePtr(&sizeClass->returnedBlocks, head, (void*) block) == false);
+      }
+      else
+      {
+         free(ptr);
+      }
+      (void) apx_atomic_sub32(&self->liveBytes, (uint32_t) size);
    }
-   return false;
 }
 
-#ifdef UNIT_TEST
-void apx_allocator_processAll(apx_allocator_t *self)
+void apx_allocator_getStats(apx_allocator_t *self, apx_allocatorStats_t *stats)
 {
-   bool result = true;
-   while(result)
+   if ( (self != 0) && (stats != 0) )
    {
-      result = apx_allocator_processEvent(self);
+      SPINLOCK_ENTER(self->lock);
+      memcpy(stats, &self->stats, sizeof(apx_allocatorStats_t));
+      SPINLOCK_LEAVE(self->lock);
+      stats->liveBytes = apx_atomic_load32(&self->liveBytes);
    }
 }
 
-int32_t apx_allocator_numPendingMessages(apx_allocator_t *self)
+/**
+ * Accumulates other into self. Used when reporting statistics for several allocators at once.
+ */
+void apx_allocatorStats_add(apx_allocatorStats_t *self, const apx_allocatorStats_t *other)
 {
-   if (self != 0)
+   if ( (self != 0) && (other != 0) )
    {
-      return adt_rbfh_length(&self->messages);
+      self->numAllocs += other->numAllocs;
+      self->numCacheHits += other->numCacheHits;
+      self->numLargeAllocs += other->numLargeAllocs;
+      self->liveBytes += other->liveBytes;
+      self->highWaterMark += other->highWaterMark;
+      self->reservedBytes += other->reservedBytes;
    }
-   return -1;
 }
-#endif
 
 //////////////////////////////////////////////////////////////////////////////
 // LOCAL FUNCTIONS
 //////////////////////////////////////////////////////////////////////////////
-#ifndef UNIT_TEST
-static int8_t apx_allocator_startThread(apx_allocator_t *self)
+static int32_t apx_allocator_getSizeClassIndex(size_t size)
 {
-   if( self != 0){
-   self->isRunning = true;
-   self->workerThreadValid = true;
-#ifdef _WIN32
-      THREAD_CREATE(self->workerThread,threadTask,self,self->threadId);
-      if(self->workerThread == INVALID_HANDLE_VALUE){
-         self->workerThreadValid = false;
-         return -1;
-      }
-#else
-      int rc = THREAD_CREATE(self->workerThread,threadTask,self);
-      if(rc != 0){
-         self->workerThreadValid = false;
+   int32_t index = 0;
+   size_t blockSize = APX_ALLOCATOR_MIN_BLOCK_SIZE;
+   while (blockSize < size)
+   {
+      if (++index >= APX_ALLOCATOR_NUM_SIZE_CLASSES)
+      {
          return -1;
       }
-#endif
-      //from this point forward all access to self must be protected by spin lock
-      return 0;
+      blockSize <<= 1;
    }
-   errno = EINVAL;
-   return -1;
+   return index;
 }
 
-static THREAD_PROTO(threadTask,arg)
+/**
+ * Must be called while holding self->lock.
+ */
+static uint8_t *apx_allocator_allocBlock(apx_allocator_t *self, apx_allocatorSizeClass_t *sizeClass)
 {
-   if(arg!=0)
+   apx_allocatorBlock_t *block = sizeClass->freeList;
+   if (block == 0)
    {
-
-      apx_allocator_t *self;
-      uint32_t messages_processed=0;
-      self = (apx_allocator_t*) arg;
-      for(;;)
+      //take every block freed since last time in one operation
+      block = (apx_allocatorBlock_t*) apx_atomic_exchangePtr(&sizeClass->returnedBlocks, (void*) 0);
+   }
+   if (block != 0)
+   {
+      sizeClass->freeList = block->next;
+      self->stats.numCacheHits++;
+   }
+   else
+   {
+      if ( (sizeClass->slabNext == 0) || ( (sizeClass->slabNext + sizeClass->blockSize) > sizeClass->slabEnd) )
       {
-#ifdef _MSC_VER
-         DWORD result = WaitForSingleObject(self->semaphore, INFINITE);
-         if (result == WAIT_OBJECT_0)
-#else
-         int result = sem_wait(&self->semaphore);
-         if (result == 0)
-#endif
+         if (apx_allocator_addSlab(self, sizeClass) == false)
          {
-            bool result;
-            messages_processed++;
-            result = apx_allocator_processEvent(self);
-            if (!result)
-            {
-               break;
-            }
-         }
-         else
-         {
-#ifdef _MSC_VER
-            DWORD lastError = GetLastError();
-            APX_LOG_ERROR("[APX_ALLOCATOR]: failure while waiting for semaphore, lastError=%d", lastError);
-#else
-            APX_LOG_ERROR("[APX_ALLOCATOR]: failure while waiting for semaphore, errno=%d", errno);
-#endif
-            break;
+            return (uint8_t*) 0;
          }
       }
-      //APX_LOG_DEBUG("[APX_ALLOCATOR]: messages_processed: %u\n", messages_processed);
+      block = (apx_allocatorBlock_t*) sizeClass->slabNext;
+      sizeClass->slabNext += sizeClass->blockSize;
    }
-   THREAD_RETURN(0);
+   return (uint8_t*) block;
 }
-#endif //UNIT_TEST
 
-static bool apx_allocator_processEvent(apx_allocator_t *self)
+static bool apx_allocator_addSlab(apx_allocator_t *self, apx_allocatorSizeClass_t *sizeClass)
 {
-   bool retval = true;
-   uint8_t rc;
-   rbf_data_t data;
-   bool delayedFree = false;
-   SPINLOCK_ENTER(self->lock);
-   rc = adt_rbfh_remove(&self->messages,(uint8_t*) &data);
-   if (rc == BUF_E_OK)
+   uint32_t slabSize = APX_ALLOCATOR_SLAB_SIZE;
+   uint8_t *slab;
+   if (slabSize < (SLAB_HEADER_SIZE + sizeClass->blockSize))
    {
-      if (data.ptr != 0)
-      {
-         if (data.size<=SOA_SMALL_OBJECT_MAX_SIZE)
-         {
-            soa_free(&self->soa,data.ptr,data.size);
-         }
-         else
-         {
-            delayedFree = true;
-         }
-      }
-      else
-      {
-         retval = false;
-      }
+      slabSize = SLAB_HEADER_SIZE + sizeClass->blockSize;
    }
-   else
+   slab = (uint8_t*) malloc(slabSize);
+   if (slab == 0)
    {
-      retval = false;
-   }
-   SPINLOCK_LEAVE(self->lock);
+      return false;
+   }
+   ( (apx_allocatorBlock_t*) slab)->next = self->slabs;
+   self->slabs = (apx_allocatorBlock_t*) slab;
+   sizeClass->slabNext = slab + SLAB_HEADER_SIZE;
+   sizeClass->slabEnd = slab + slabSize;
+   self->stats.reservedBytes += slabSize;
+   return true;
+}
 
-   if (delayedFree == true)
-   {
-      free(data.ptr);
-   }
-   else if ( (rc == BUF_E_OK) && (data.ptr == 0) )
-   {
-      retval = false; //NULL data pointer is a valid exit message
-   }
-   else
+/**
+ * Must be called while holding self->lock.
+ */
+static void apx_allocator_updateStats(apx_allocator_t *self, uint32_t size)
+{
+   uint32_t liveBytes = apx_atomic_add32(&self->liveBytes, size);
+   self->stats.numAllocs++;
+   if (liveBytes > self->stats.highWaterMark)
    {
-      //Already handled by soa_free or bufResult != E_BUF_OK
+      self->stats.highWaterMark = liveBytes;
    }
-   return retval;
 }
-
-
-
@@ -0,0 +1,173 @@
+/*****************************************************************************
+* \file      apx_atomic.c
+* \author    Conny Gustafsson
+* \date      2026-10-18
+* \brief     Portable atomic operations
+*
+* Copyright (c) 2026 Conny Gustafsson
+* Permission is hereby granted, free of charge, to any person obtaining a copy of
+* this software and associated documentation files (the "Software"), to deal in
+* the Software without restriction, including without limitation the rights to
+* use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+* the Software, and to permit persons to whom the Software is furnished to do so,
+* subject to the following conditions:
+
+* The above copyright notice and this permission notice shall be included in all
+* copies or substantial portions of the Software.
+
+* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+* IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+* FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+* COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+* IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+* CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+*
+******************************************************************************/
+//////////////////////////////////////////////////////////////////////////////
+// INCLUDES
+//////////////////////////////////////////////////////////////////////////////
+#ifdef _MSC_VER
+# ifndef WIN32_LEAN_AND_MEAN
+# define WIN32_LEAN_AND_MEAN
+# endif
+# include <Windows.h>
+#endif
+#include "apx_atomic.h"
+#ifdef MEM_LEAK_CHECK
+#include "CMemLeak.h"
+#endif
+
+//////////////////////////////////////////////////////////////////////////////
+// PUBLIC FUNCTIONS
+//////////////////////////////////////////////////////////////////////////////
+#ifdef _MSC_VER
+uint32_t apx_atomic_load32(volatile uint32_t *ptr)
+{
+   return (uint32_t) InterlockedCompareExchange( (volatile LONG*) ptr, 0, 0);
+}
+
+void apx_atomic_store32(volatile uint32_t *ptr, uint32_t value)
+{
+   (void) InterlockedExchange( (volatile LONG*) ptr, (LONG) value);
+}
+
+uint32_t apx_atomic_exchange32(volatile uint32_t *ptr, uint32_t value)
+{
+   return (uint32_t) InterlockedExchange( (volatile LONG*) ptr, (LONG) value);
+}
+
+bool apx_atomic_compareExchange32(volatile uint32_t *ptr, uint32_t expected, uint32_t desired)
+{
+   return ( (uint32_t) InterlockedCompareExchange( (volatile LONG*) ptr, (LONG) desired, (LONG) expected) == expected)? true : false;
+}
+
+uint32_t apx_atomic_add32(volatile uint32_t *ptr, uint32_t value)
+{
+   return (uint32_t) InterlockedExchangeAdd( (volatile LONG*) ptr, (LONG) value) + value;
+}
+
+uint32_t apx_atomic_sub32(volatile uint32_t *ptr, uint32_t value)
+{
+   return (uint32_t) InterlockedExchangeAdd( (volatile LONG*) ptr, -( (LONG) value) ) - value;
+}
+
+uint32_t apx_atomic_or32(volatile uint32_t *ptr, uint32_t value)
+{
+   return (uint32_t) InterlockedOr( (volatile LONG*) ptr, (LONG) value);
+}
+
+uint64_t apx_atomic_load64(volatile uint64_t *ptr)
+{
+   return (uint64_t) InterlockedCompareExchange64( (volatile LONG64*) ptr, 0, 0);
+}
+
+uint64_t apx_atomic_add64(volatile uint64_t *ptr, uint64_t value)
+{
+   return (uint64_t) InterlockedExchangeAdd64( (volatile LONG64*) ptr, (LONG64) value) + value;
+}
+
+void *apx_atomic_loadPtr(void * volatile *ptr)
+{
+   return InterlockedCompareExchangePointer(ptr, (void*) 0, (void*) 0);
+}
+
+void *apx_atomic_exchangePtr(void * volatile *ptr, void *value)
+{
+   return InterlockedExchangePointer(ptr, value);
+}
+
+bool apx_atomic_compareExchangePtr(void * volatile *ptr, void *expected, void *desired)
+{
+   return (InterlockedCompareExchangePointer(ptr, desired, expected) == expected)? true : false;
+}
+
+void apx_atomic_fence(void)
+{
+   MemoryBarrier();
+}
+#else
+uint32_t apx_atomic_load32(volatile uint32_t *ptr)
+{
+   return __atomic_load_n(ptr, __ATOMIC_ACQUIRE);
+}
+
+void apx_atomic_store32(volatile uint32_t *ptr, uint32_t value)
+{
+   __atomic_store_n(ptr, value, __ATOMIC_RELEASE);
+}
+
+uint32_t apx_atomic_exchange32(volatile uint32_t *ptr, uint32_t value)
+{
+   return __atomic_exchange_n(ptr, value, __ATOMIC_SEQ_CST);
+}
+
+bool apx_atomic_compareExchange32(volatile uint32_t *ptr, uint32_t expected, uint32_t desired)
+{
+   return __atomic_compare_exchange_n(ptr, &expected, desired, false, __ATOMIC_SEQ_CST, __ATOMIC_RELAXED);
+}
+
+uint32_t apx_atomic_add32(volatile uint32_t *ptr, uint32_t value)
+{
+   return __atomic_add_fetch(ptr, value, __ATOMIC_SEQ_CST);
+}
+
+uint32_t apx_atomic_sub32(volatile uint32_t *ptr, uint32_t value)
+{
+   return __atomic_sub_fetch(ptr, value, __ATOMIC_SEQ_CST);
+}
+
+uint32_t apx_atomic_or32(volatile uint32_t *ptr, uint32_t value)
+{
+   return __atomic_fetch_or(ptr, value, __ATOMIC_SEQ_CST);
+}
+
+uint64_t apx_atomic_load64(volatile uint64_t *ptr)
+{
+   return __atomic_load_n(ptr, __ATOMIC_ACQUIRE);
+}
+
+uint64_t apx_atomic_add64(volatile uint64_t *ptr, uint64_t value)
+{
+   return __atomic_add_fetch(ptr, value, __ATOMIC_SEQ_CST);
+}
+
+void *apx_atomic_loadPtr(void * volatile *ptr)
+{
+   return __atomic_load_n(ptr, __ATOMIC_ACQUIRE);
+}
+
+void *apx_atomic_exchangePtr(void * volatile *ptr, void *value)
+{
+   return __atomic_exchange_n(ptr, value, __ATOMIC_SEQ_CST);
+}
+
+bool apx_atomic_compareExchangePtr(void * volatile *ptr, void *expected, void *desired)
+{
+   return __atomic_compare_exchange_n(ptr, &expected, desired, false, __ATOMIC_SEQ_CST, __ATOMIC_RELAXED);
+}
+
+void apx_atomic_fence(void)
+{
+   __atomic_thread_fence(__ATOMIC_SEQ_CST);
+}
+#endif
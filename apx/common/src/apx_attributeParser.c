@@ -23,6 +23,7 @@
 #define APX_ATTRIB_PARAM   2
 #define APX_ATTRIB_QUEUE   3
 #define APX_ATTRIB_DYNAMIC 4
+#define APX_ATTRIB_EVENT   5
 //////////////////////////////////////////////////////////////////////////////
 // LOCAL FUNCTION PROTOTYPES
 //////////////////////////////////////////////////////////////////////////////
@@ -159,6 +160,8 @@ apx_error_t apx_attributeParser_getLastError(apx_attributeParser_t *self, const
  * An equals sign (=): denotes the start of an init value
  * Letter P: Applies the parameter property to the port
  * Letter Q: Applies the queued property to the port
+ * Letter D: Applies the dynamic array property to the port (APX/1.3)
+ * Letter E: Applies the event property to the port, every write must reach the receiver (APX/1.3)
  */
 DYN_STATIC const uint8_t* apx_attributeParser_parseSingleAttribute(apx_attributeParser_t *self, const uint8_t *pBegin, const uint8_t *pEnd, apx_portAttributes_t *attr)
 {
@@ -186,6 +189,12 @@ DYN_STATIC const uint8_t* apx_attributeParser_parseSingleAttribute(apx_attribute
       case 'Q':
          attribType = APX_ATTRIB_QUEUE;
          break;
+      case 'E':
+         if ( (self->majorVersion == 1) && (self->minorVersion >= 3) )
+         {
+            attribType = APX_ATTRIB_EVENT;
+         }
+         break;
       default:
          attribType = APX_ATTRIB_NONE;
          break;
@@ -209,6 +218,9 @@ DYN_STATIC const uint8_t* apx_attributeParser_parseSingleAttribute(apx_attribute
          case APX_ATTRIB_PARAM:
             attr->isParameter = true;
             break;
+         case APX_ATTRIB_EVENT:
+            attr->isEvent = true;
+            break;
          case APX_ATTRIB_DYNAMIC:
             attr->isDynamic = true;
             pResult = apx_attributeParser_parseArrayLength(self, pNext, pEnd, &attr->dynLen);
@@ -58,7 +58,10 @@ apx_error_t apx_bytePortMap_create(apx_bytePortMap_t *self, const apx_portDataPr
    if ( (self != 0) && (props != 0) && (numPorts > 0))
    {
       retval = APX_NO_ERROR;
-      self->mapData = (apx_portId_t*) 0;
+      self->startOffsets = (apx_offset_t*) 0;
+      self->blockFirstPort = (apx_portId_t*) 0;
+      self->numPorts = 0;
+      self->numBlocks = 0;
       self->mapLen = 0;
       apx_size_t mapLen = apx_portDataProps_sumDataSize(props, numPorts);
       if (mapLen > 0)
@@ -75,9 +78,16 @@ apx_error_t apx_bytePortMap_create(apx_bytePortMap_t *self, const apx_portDataPr
 
 void apx_bytePortMap_destroy(apx_bytePortMap_t *self)
 {
-   if ( (self != 0) && (self->mapData != 0) )
+   if (self != 0)
    {
-      free(self->mapData);
+      if (self->startOffsets != 0)
+      {
+         free(self->startOffsets);
+      }
+      if (self->blockFirstPort != 0)
+      {
+         free(self->blockFirstPort);
+      }
    }
 }
 
@@ -110,11 +120,26 @@ void apx_bytePortMap_delete(apx_bytePortMap_t *self)
 }
 
 
+/**
+ * Returns the ID of the port containing the byte at offset, or -1 if offset is outside the map.
+ * The search loop has no data-dependent branches, the comparison is expected to compile into a conditional move.
+ */
 apx_portId_t apx_bytePortMap_lookup(const apx_bytePortMap_t *self, int32_t offset)
 {
    if ( (self != 0) && (offset >= 0) && (offset < self->mapLen) )
    {
-      return self->mapData[offset];
+      int32_t block = offset >> APX_BYTE_PORT_MAP_BLOCK_SHIFT;
+      apx_portId_t first = self->blockFirstPort[block];
+      apx_portId_t last = (block + 1 < self->numBlocks)? self->blockFirstPort[block + 1] : (apx_portId_t) (self->numPorts - 1);
+      const apx_offset_t *base = self->startOffsets + first;
+      apx_portCount_t n = (apx_portCount_t) (last - first + 1);
+      while (n > 1)
+      {
+         apx_portCount_t half = n / 2;
+         base = (base[half] <= offset)? base + half : base;
+         n -= half;
+      }
+      return (apx_portId_t) (base - self->startOffsets);
    }
    return -1;
 }
@@ -129,6 +154,18 @@ apx_size_t apx_bytePortMap_length(const apx_bytePortMap_t *self)
    return 0;
 }
 
+/**
+ * Returns number of bytes allocated for the map tables
+ */
+apx_size_t apx_bytePortMap_memoryUsage(const apx_bytePortMap_t *self)
+{
+   if (self != 0)
+   {
+      return (apx_size_t) (self->numPorts * sizeof(apx_offset_t) + self->numBlocks * sizeof(apx_portId_t));
+   }
+   return 0;
+}
+
 //////////////////////////////////////////////////////////////////////////////
 // LOCAL FUNCTIONS
 //////////////////////////////////////////////////////////////////////////////
@@ -138,28 +175,32 @@ static apx_error_t apx_bytePortMap_build(apx_bytePortMap_t *self, const apx_port
    if ( (self != 0) && (propsArray != 0) && (numPorts > 0) && (mapLen > 0u) )
    {
       apx_portId_t portId;
-      apx_portId_t *pNext;
-      apx_portId_t *pEnd;
-      self->mapData = (apx_portId_t*) malloc(mapLen*sizeof(apx_portId_t));
-      if (self->mapData == 0)
+      int32_t block = 0;
+      apx_size_t offset = 0u;
+      self->numBlocks = (int32_t) ((mapLen + (1u << APX_BYTE_PORT_MAP_BLOCK_SHIFT) - 1u) >> APX_BYTE_PORT_MAP_BLOCK_SHIFT);
+      self->startOffsets = (apx_offset_t*) malloc(numPorts*sizeof(apx_offset_t));
+      self->blockFirstPort = (apx_portId_t*) malloc(self->numBlocks*sizeof(apx_portId_t));
+      if ( (self->startOffsets == 0) || (self->blockFirstPort == 0) )
       {
+         apx_bytePortMap_destroy(self);
          return APX_MEM_ERROR;
       }
-      self->mapLen = mapLen;
-      pNext = self->mapData;
-      pEnd = pNext + self->mapLen;
+      self->numPorts = numPorts;
+      self->mapLen = (int32_t) mapLen;
       for (portId=0; portId < numPorts; portId++)
       {
-         apx_size_t i;
-         apx_size_t packLen = propsArray[portId].dataSize;
-         for(i=0u; i < packLen; i++)
+         //Ports with zero data size get the same start offset as the next port. Lookup always resolves to the last of them.
+         apx_size_t endOffset = offset + propsArray[portId].dataSize;
+         self->startOffsets[portId] = (apx_offset_t) offset;
+         while ( (block < self->numBlocks) && (((apx_size_t) block << APX_BYTE_PORT_MAP_BLOCK_SHIFT) < endOffset) )
          {
-            pNext[i] = portId;
+            self->blockFirstPort[block++] = portId;
          }
-         pNext+=packLen;
-         assert(pNext<=pEnd);
+         offset = endOffset;
+         assert(offset<=mapLen);
       }
-      assert(pNext==pEnd);
+      assert(offset==mapLen);
+      assert(block==self->numBlocks);
       return APX_NO_ERROR;
    }
    return APX_INVALID_ARGUMENT_ERROR;
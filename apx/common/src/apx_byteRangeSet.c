@@ -0,0 +1,223 @@
+/*****************************************************************************
+* \file      apx_byteRangeSet.c
+* \author    Conny Gustafsson
+* \date      2026-10-18
+* \brief     Sorted set of non-overlapping byte ranges
+*
+* Copyright (c) 2026 Conny Gustafsson
+* Permission is hereby granted, free of charge, to any person obtaining a copy of
+* this software and associated documentation files (the "Software"), to deal in
+* the Software without restriction, including without limitation the rights to
+* use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+* the Software, and to permit persons to whom the Software is furnished to do so,
+* subject to the following conditions:
+
+* The above copyright notice and this permission notice shall be included in all
+* copies or substantial portions of the Software.
+
+* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+* IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+* FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+* COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+* IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+* CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+*
+******************************************************************************/
+//////////////////////////////////////////////////////////////////////////////
+// INCLUDES
+//////////////////////////////////////////////////////////////////////////////
+#include <malloc.h>
+#include <string.h>
+#include "apx_byteRangeSet.h"
+#ifdef MEM_LEAK_CHECK
+#include "CMemLeak.h"
+#endif
+
+//////////////////////////////////////////////////////////////////////////////
+// PRIVATE CONSTANTS AND DATA TYPES
+//////////////////////////////////////////////////////////////////////////////
+#define APX_BYTE_RANGE_SET_GROW_SIZE 16u
+
+//////////////////////////////////////////////////////////////////////////////
+// PRIVATE FUNCTION PROTOTYPES
+//////////////////////////////////////////////////////////////////////////////
+static uint32_t apx_byteRangeSet_lowerBound(const apx_byteRangeSet_t *self, uint32_t offset);
+static apx_error_t apx_byteRangeSet_grow(apx_byteRangeSet_t *self);
+
+//////////////////////////////////////////////////////////////////////////////
+// PRIVATE VARIABLES
+//////////////////////////////////////////////////////////////////////////////
+
+//////////////////////////////////////////////////////////////////////////////
+// PUBLIC FUNCTIONS
+//////////////////////////////////////////////////////////////////////////////
+void apx_byteRangeSet_create(apx_byteRangeSet_t *self, uint32_t mergeGap)
+{
+   if (self != 0)
+   {
+      self->ranges = (apx_byteRange_t*) 0;
+      self->numRanges = 0u;
+      self->allocLen = 0u;
+      self->mergeGap = mergeGap;
+   }
+}
+
+void apx_byteRangeSet_destroy(apx_byteRangeSet_t *self)
+{
+   if ( (self != 0) && (self->ranges != 0) )
+   {
+      free(self->ranges);
+      self->ranges = (apx_byteRange_t*) 0;
+      self->numRanges = 0u;
+      self->allocLen = 0u;
+   }
+}
+
+apx_byteRangeSet_t *apx_byteRangeSet_new(uint32_t mergeGap)
+{
+   apx_byteRangeSet_t *self = (apx_byteRangeSet_t*) malloc(sizeof(apx_byteRangeSet_t));
+   if (self != 0)
+   {
+      apx_byteRangeSet_create(self, mergeGap);
+   }
+   return self;
+}
+
+void apx_byteRangeSet_delete(apx_byteRangeSet_t *self)
+{
+   if (self != 0)
+   {
+      apx_byteRangeSet_destroy(self);
+      free(self);
+   }
+}
+
+void apx_byteRangeSet_vdelete(void *arg)
+{
+   apx_byteRangeSet_delete((apx_byteRangeSet_t*) arg);
+}
+
+/**
+ * Inserts the range [offset, offset+len) into the set, merging it with all existing ranges it overlaps or is within mergeGap bytes of.
+ */
+apx_error_t apx_byteRangeSet_insert(apx_byteRangeSet_t *self, uint32_t offset, uint32_t len)
+{
+   if ( (self != 0) && (len > 0u) )
+   {
+      uint32_t first;
+      uint32_t last;
+      uint32_t endOffset = offset + len;
+      first = apx_byteRangeSet_lowerBound(self, offset);
+      last = first;
+      while ( (last < self->numRanges) && (self->ranges[last].offset <= (endOffset + self->mergeGap)) )
+      {
+         uint32_t rangeEnd = self->ranges[last].offset + self->ranges[last].len;
+         if (self->ranges[last].offset < offset)
+         {
+            offset = self->ranges[last].offset;
+         }
+         if (rangeEnd > endOffset)
+         {
+            endOffset = rangeEnd;
+         }
+         last++;
+      }
+      if (last == first)
+      {
+         //no merge possible, insert new range at position first
+         if (self->numRanges == self->allocLen)
+         {
+            apx_error_t rc = apx_byteRangeSet_grow(self);
+            if (rc != APX_NO_ERROR)
+            {
+               return rc;
+            }
+         }
+         if (first < self->numRanges)
+         {
+            memmove(&self->ranges[first + 1], &self->ranges[first], sizeof(apx_byteRange_t) * (self->numRanges - first));
+         }
+         self->numRanges++;
+      }
+      else if (last > (first + 1))
+      {
+         //ranges [first+1, last) were absorbed into range at position first
+         if (last < self->numRanges)
+         {
+            memmove(&self->ranges[first + 1], &self->ranges[last], sizeof(apx_byteRange_t) * (self->numRanges - last));
+         }
+         self->numRanges -= (last - first - 1);
+      }
+      self->ranges[first].offset = offset;
+      self->ranges[first].len = endOffset - offset;
+      return APX_NO_ERROR;
+   }
+   return APX_INVALID_ARGUMENT_ERROR;
+}
+
+void apx_byteRangeSet_clear(apx_byteRangeSet_t *self)
+{
+   if (self != 0)
+   {
+      self->numRanges = 0u;
+   }
+}
+
+uint32_t apx_byteRangeSet_length(const apx_byteRangeSet_t *self)
+{
+   if (self != 0)
+   {
+      return self->numRanges;
+   }
+   return 0u;
+}
+
+const apx_byteRange_t *apx_byteRangeSet_get(const apx_byteRangeSet_t *self, uint32_t index)
+{
+   if ( (self != 0) && (index < self->numRanges) )
+   {
+      return &self->ranges[index];
+   }
+   return (const apx_byteRange_t*) 0;
+}
+
+//////////////////////////////////////////////////////////////////////////////
+// PRIVATE FUNCTIONS
+//////////////////////////////////////////////////////////////////////////////
+
+/**
+ * Returns index of first range whose end (plus mergeGap) reaches offset.
+ * Since ranges never overlap their end offsets are sorted in the same order as their start offsets.
+ */
+static uint32_t apx_byteRangeSet_lowerBound(const apx_byteRangeSet_t *self, uint32_t offset)
+{
+   uint32_t low = 0u;
+   uint32_t high = self->numRanges;
+   while (low < high)
+   {
+      uint32_t mid = low + (high - low) / 2u;
+      const apx_byteRange_t *range = &self->ranges[mid];
+      if ( (range->offset + range->len + self->mergeGap) < offset)
+      {
+         low = mid + 1u;
+      }
+      else
+      {
+         high = mid;
+      }
+   }
+   return low;
+}
+
+static apx_error_t apx_byteRangeSet_grow(apx_byteRangeSet_t *self)
+{
+   uint32_t allocLen = (self->allocLen == 0u)? APX_BYTE_RANGE_SET_GROW_SIZE : self->allocLen * 2u;
+   apx_byteRange_t *ranges = (apx_byteRange_t*) realloc(self->ranges, sizeof(apx_byteRange_t) * allocLen);
+   if (ranges == 0)
+   {
+      return APX_MEM_ERROR;
+   }
+   self->ranges = ranges;
+   self->allocLen = allocLen;
+   return APX_NO_ERROR;
+}
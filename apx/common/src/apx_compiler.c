@@ -51,6 +51,7 @@ static uint8_t apx_compiler_encodeArrayInstruction(apx_compiler_t *self,  uint32
 static uint8_t apx_compiler_encodeRecordSelectInstruction(bool isLastField);
 static apx_error_t apx_compiler_encodeProgramHeader(apx_compiler_t *self, uint8_t majorVersion, uint8_t minorVersion, apx_size_t dataSize, uint8_t programType);
 static apx_error_t apx_compiler_compileDataElement(apx_compiler_t *self, apx_dataElement_t *dataElement, uint8_t opcode);
+static apx_error_t apx_compiler_lowerInstructions(const uint8_t *pNext, const uint8_t *pEnd, uint8_t expectedOpcode, apx_copyPlan_t *plan);
 
 //////////////////////////////////////////////////////////////////////////////
 // PUBLIC FUNCTIONS
@@ -182,6 +183,61 @@ apx_error_t apx_compiler_encodeUnpackProgramHeader(apx_compiler_t *self, uint8_t
    return apx_compiler_encodeProgramHeader(self, majorVersion, minorVersion, dataSize, APX_VM_HEADER_UNPACK_PROG);
 }
 
+/**
+ * Lowers a flat program into a copy plan. A program is flat when it only contains scalars, strings and fixed arrays
+ * of U8/U16/U32/S8/S16/S32, optionally grouped inside (non-array) records.
+ * Returns APX_UNSUPPORTED_ERROR when the program is not flat. In that case the program must be executed by the VM.
+ */
+apx_error_t apx_compiler_lowerToCopyPlan(const adt_bytes_t *program, apx_copyPlan_t **plan)
+{
+   if ( (program != 0) && (plan != 0) )
+   {
+      apx_error_t rc;
+      apx_copyPlan_t *tmp;
+      uint8_t progType;
+      uint8_t expectedOpcode;
+      const uint8_t *pBegin = adt_bytes_constData(program);
+      const uint8_t *pEnd = pBegin + adt_bytes_length(program);
+      if ( (adt_bytes_length(program) < APX_VM_HEADER_SIZE) || (pBegin[0] != APX_VM_MAGIC_NUMBER) )
+      {
+         return APX_INVALID_PROGRAM_ERROR;
+      }
+      progType = pBegin[3];
+      if (progType == APX_VM_HEADER_PACK_PROG)
+      {
+         expectedOpcode = APX_OPCODE_PACK;
+      }
+      else if (progType == APX_VM_HEADER_UNPACK_PROG)
+      {
+         expectedOpcode = APX_OPCODE_UNPACK;
+      }
+      else
+      {
+         return APX_INVALID_PROGRAM_ERROR;
+      }
+      tmp = apx_copyPlan_new(progType);
+      if (tmp == 0)
+      {
+         return APX_MEM_ERROR;
+      }
+      rc = apx_compiler_lowerInstructions(pBegin + APX_VM_HEADER_SIZE, pEnd, expectedOpcode, tmp);
+      if ( (rc == APX_NO_ERROR) && (apx_copyPlan_getDataSize(tmp) != (apx_size_t) unpackLE(&pBegin[APX_VM_HEADER_DATA_OFFSET], UINT32_SIZE)) )
+      {
+         rc = APX_LENGTH_ERROR;
+      }
+      if (rc == APX_NO_ERROR)
+      {
+         *plan = tmp;
+      }
+      else
+      {
+         apx_copyPlan_delete(tmp);
+      }
+      return rc;
+   }
+   return APX_INVALID_ARGUMENT_ERROR;
+}
+
 //////////////////////////////////////////////////////////////////////////////
 // PRIVATE FUNCTIONS
 //////////////////////////////////////////////////////////////////////////////
@@ -405,3 +461,119 @@ static apx_error_t apx_compiler_compileDataElement(apx_compiler_t *self, apx_dat
    }
    return APX_INVALID_ARGUMENT_ERROR;
 }
+
+static apx_error_t apx_compiler_lowerInstructions(const uint8_t *pNext, const uint8_t *pEnd, uint8_t expectedOpcode, apx_copyPlan_t *plan)
+{
+   apx_size_t dataOffset = 0u;
+   if (pNext >= pEnd)
+   {
+      return APX_INVALID_PROGRAM_ERROR;
+   }
+   while (pNext < pEnd)
+   {
+      apx_error_t rc;
+      uint8_t instruction = *pNext++;
+      uint8_t opcode = instruction & APX_INST_OPCODE_MASK;
+      uint8_t variant = (instruction >> APX_INST_VARIANT_SHIFT) & APX_INST_VARIANT_MASK;
+      uint8_t flags = (instruction >> APX_INST_FLAG_SHIFT) & APX_INST_FLAG_MASK;
+      uint32_t arrayLen = 0u;
+      uint8_t width;
+      uint8_t runFlags = APX_COPY_RUN_FLAG_NONE;
+
+      if (opcode == APX_OPCODE_DATA_CTRL)
+      {
+         const uint8_t *pNullTerminator;
+         if (variant != APX_VARIANT_RECORD_SELECT)
+         {
+            return APX_INVALID_INSTRUCTION_ERROR;
+         }
+         pNullTerminator = (const uint8_t*) memchr(pNext, 0, (size_t) (pEnd - pNext));
+         if (pNullTerminator == 0)
+         {
+            return APX_INVALID_INSTRUCTION_ERROR;
+         }
+         pNext = pNullTerminator + 1;
+         continue;
+      }
+      else if (opcode != expectedOpcode)
+      {
+         return APX_UNSUPPORTED_ERROR;
+      }
+      if (flags & APX_ARRAY_FLAG)
+      {
+         uint8_t arrayInstruction;
+         uint8_t lenSize;
+         if (pNext >= pEnd)
+         {
+            return APX_INVALID_PROGRAM_ERROR;
+         }
+         arrayInstruction = *pNext++;
+         if ( (arrayInstruction & APX_INST_OPCODE_MASK) != APX_OPCODE_ARRAY)
+         {
+            return APX_INVALID_INSTRUCTION_ERROR;
+         }
+         if ( ( (arrayInstruction >> APX_INST_FLAG_SHIFT) & APX_INST_FLAG_MASK) != 0u)
+         {
+            return APX_UNSUPPORTED_ERROR; //dynamic array
+         }
+         switch( (arrayInstruction >> APX_INST_VARIANT_SHIFT) & APX_INST_VARIANT_MASK )
+         {
+         case APX_VARIANT_U8:
+            lenSize = UINT8_SIZE;
+            break;
+         case APX_VARIANT_U16:
+            lenSize = UINT16_SIZE;
+            break;
+         case APX_VARIANT_U32:
+            lenSize = UINT32_SIZE;
+            break;
+         default:
+            return APX_INVALID_INSTRUCTION_ERROR;
+         }
+         if (pNext + lenSize > pEnd)
+         {
+            return APX_INVALID_PROGRAM_ERROR;
+         }
+         arrayLen = unpackLE(pNext, lenSize);
+         pNext += lenSize;
+      }
+      switch(variant)
+      {
+      case APX_VARIANT_U8:
+      case APX_VARIANT_S8:
+         width = UINT8_SIZE;
+         break;
+      case APX_VARIANT_STR:
+         width = UINT8_SIZE;
+         runFlags = APX_COPY_RUN_FLAG_STRING;
+         break;
+      case APX_VARIANT_U16:
+      case APX_VARIANT_S16:
+         width = UINT16_SIZE;
+         break;
+      case APX_VARIANT_U32:
+      case APX_VARIANT_S32:
+         width = UINT32_SIZE;
+         break;
+      case APX_VARIANT_RECORD:
+         if (arrayLen > 0u)
+         {
+            return APX_UNSUPPORTED_ERROR; //array of records
+         }
+         continue;
+      default:
+         return APX_UNSUPPORTED_ERROR;
+      }
+      if ( (width == UINT8_SIZE) || (APX_HOST_LITTLE_ENDIAN != 0) )
+      {
+         runFlags |= APX_COPY_RUN_FLAG_MEMCPY;
+      }
+      rc = apx_copyPlan_appendRun(plan, dataOffset, width, (arrayLen > 0u)? arrayLen : 1u, runFlags);
+      if (rc != APX_NO_ERROR)
+      {
+         return rc;
+      }
+      dataOffset += width * ( (arrayLen > 0u)? arrayLen : 1u);
+   }
+   return APX_NO_ERROR;
+}
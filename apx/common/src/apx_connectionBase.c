@@ -107,8 +107,13 @@ apx_error_t apx_connectionBase_create(apx_connectionBase_t *self, apx_mode_t mod
       self->eventHandlerArg = (void*) 0;
       self->totalBytesReceived = 0u;
       self->totalBytesSent = 0u;
+      self->totalMessagesReceived = 0u;
       self->mode = mode;
-      rc = apx_allocator_create(&self->allocator, APX_MAX_NUM_MESSAGES);
+      self->isConflationEnabled = (APX_CONFLATION_ENABLE_DEFAULT != 0)? true : false;
+      self->compressionType = RMF_COMPRESSION_NONE;
+      self->nextPingSequence = 0u;
+      apx_latencyStats_create(&self->latencyStats);
+      rc = apx_allocator_create(&self->allocator);
       if (rc != APX_NO_ERROR)
       {
          return rc;
@@ -120,6 +125,7 @@ apx_error_t apx_connectionBase_create(apx_connectionBase_t *self, apx_mode_t mod
       self->workerThread = 0;
 #endif
       self->workerThreadValid=false;
+      self->executor = (apx_executor_t*) 0;
       bufResult = apx_eventLoop_create(&self->eventLoop);
       if (bufResult != BUF_E_OK)
       {
@@ -146,7 +152,7 @@ apx_error_t apx_connectionBase_create(apx_connectionBase_t *self, apx_mode_t mod
       }
       adt_list_create(&self->connectionEventListeners, apx_connectionEventListener_vdelete);
       MUTEX_INIT(self->eventListenerMutex);
-      apx_allocator_start(&self->allocator);
+      SPINLOCK_INIT(self->latencyLock);
       return rc;
    }
    return APX_INVALID_ARGUMENT_ERROR;
@@ -161,8 +167,9 @@ void apx_connectionBase_destroy(apx_connectionBase_t *self)
       apx_nodeManager_destroy(&self->nodeManager);
       MUTEX_DESTROY(self->eventListenerMutex);
       adt_list_destroy(&self->connectionEventListeners);
-      apx_allocator_stop(&self->allocator);
       apx_allocator_destroy(&self->allocator);
+      SPINLOCK_DESTROY(self->latencyLock);
+      apx_latencyStats_destroy(&self->latencyStats);
    }
 }
 
@@ -201,11 +208,88 @@ void apx_connectionBase_setEventHandler(apx_connectionBase_t *self, apx_eventHan
    }
 }
 
+/**
+ * Runs the event handler and file manager transmits on the threads of executor instead of starting threads for this connection.
+ * Must be called before apx_connectionBase_start.
+ */
+void apx_connectionBase_setExecutor(apx_connectionBase_t *self, apx_executor_t *executor)
+{
+   if (self != 0)
+   {
+      self->executor = executor;
+      apx_fileManager_setExecutor(&self->fileManager, executor);
+   }
+}
+
+/**
+ * When enabled, require port data routed to this (server) connection only marks the written ports as dirty.
+ * The worker sends the current value of all dirty ports once it gets to it, so a slow receiver gets the latest values
+ * instead of a growing backlog of writes. Queued ports are never conflated.
+ * Require ports that carry events can opt out with the E attribute in the node definition (APX/1.3), e.g. R"Event"C:=0,E.
+ * Every write to such a port is sent to the receiver.
+ */
+void apx_connectionBase_setConflationEnabled(apx_connectionBase_t *self, bool enabled)
+{
+   if (self != 0)
+   {
+      self->isConflationEnabled = enabled;
+   }
+}
+
+bool apx_connectionBase_isConflationEnabled(const apx_connectionBase_t *self)
+{
+   if ( (self != 0) && (self->mode == APX_SERVER_MODE) )
+   {
+      return self->isConflationEnabled;
+   }
+   return false;
+}
+
+/**
+ * Client mode: definition files of nodes attached after this call are compressed using this algorithm.
+ * Server mode: the algorithm the client announced in its greeting. Compressed files using any other algorithm are rejected.
+ */
+void apx_connectionBase_setCompressionType(apx_connectionBase_t *self, uint16_t compressionType)
+{
+   if (self != 0)
+   {
+      self->compressionType = compressionType;
+   }
+}
+
+uint16_t apx_connectionBase_getCompressionType(const apx_connectionBase_t *self)
+{
+   if (self != 0)
+   {
+      return self->compressionType;
+   }
+   return RMF_COMPRESSION_NONE;
+}
+
+/**
+ * Server mode: called when the client announced Fragment-Interleave in its greeting.
+ * Large writes towards this connection are then transmitted in fragments of APX_WORKER_FRAGMENT_SIZE bytes.
+ */
+void apx_connectionBase_setFragmentInterleaveEnabled(apx_connectionBase_t *self, bool enabled)
+{
+   if (self != 0)
+   {
+      apx_fileManager_setFragmentSize(&self->fileManager, enabled? (uint32_t) APX_WORKER_FRAGMENT_SIZE : 0u);
+   }
+}
+
 void apx_connectionBase_start(apx_connectionBase_t *self)
 {
    if ( self != 0 )
    {
-      apx_connectionBase_startWorkerThread(self);
+      if (self->executor != 0)
+      {
+         apx_eventLoop_attachExecutor(&self->eventLoop, self->executor, self->eventHandler, self->eventHandlerArg);
+      }
+      else
+      {
+         apx_connectionBase_startWorkerThread(self);
+      }
       apx_fileManager_start(&self->fileManager);
       if ( self->vtable.start != 0 )
       {
@@ -219,7 +303,14 @@ void apx_connectionBase_stop(apx_connectionBase_t *self)
    if ( self != 0 )
    {
       apx_fileManager_stop(&self->fileManager);
-      apx_connectionBase_stopWorkerThread(self);
+      if (self->executor != 0)
+      {
+         apx_eventLoop_detachExecutor(&self->eventLoop);
+      }
+      else
+      {
+         apx_connectionBase_stopWorkerThread(self);
+      }
    }
 }
 
@@ -260,7 +351,7 @@ void apx_connectionBase_attachNodeInstance(apx_connectionBase_t *self, apx_nodeI
       {
          apx_nodeInstance_setRequirePortDataState(nodeInstance, APX_REQUIRE_PORT_DATA_STATE_WAITING_FILE_INFO);
       }
-      rc = apx_nodeInstance_fillDefinitionFileInfo(nodeInstance, &fileInfo);
+      rc = apx_nodeInstance_fillDefinitionFileInfo(nodeInstance, &fileInfo, self->compressionType);
       if (rc == APX_NO_ERROR)
       {
          apx_file_t *localFile = apx_fileManager_createLocalFile(&self->fileManager, &fileInfo);
@@ -277,6 +368,7 @@ apx_error_t apx_connectionBase_processMessage(apx_connectionBase_t *self, const
 {
    if (self != 0)
    {
+      self->totalMessagesReceived++;
       return apx_fileManager_messageReceived(&self->fileManager, msgBuf, msgLen);
    }
    return APX_INVALID_ARGUMENT_ERROR;
@@ -299,6 +391,60 @@ void apx_connectionBase_free(apx_connectionBase_t *self, uint8_t *ptr, size_t si
    }
 }
 
+void apx_connectionBase_getAllocatorStats(apx_connectionBase_t *self, apx_allocatorStats_t *stats)
+{
+   if (self != 0)
+   {
+      apx_allocator_getStats(&self->allocator, stats);
+   }
+}
+
+/**
+ * Sends a timestamped ping to the remote side. The round-trip time is recorded when the echoed response arrives.
+ */
+apx_error_t apx_connectionBase_sendPing(apx_connectionBase_t *self)
+{
+   if (self != 0)
+   {
+      uint32_t sequence;
+      SPINLOCK_ENTER(self->latencyLock);
+      sequence = ++self->nextPingSequence;
+      SPINLOCK_LEAVE(self->latencyLock);
+      return apx_fileManager_sendPing(&self->fileManager, sequence);
+   }
+   return APX_INVALID_ARGUMENT_ERROR;
+}
+
+void apx_connectionBase_getLatencySummary(apx_connectionBase_t *self, apx_latencySummary_t *summary)
+{
+   if ( (self != 0) && (summary != 0) )
+   {
+      SPINLOCK_ENTER(self->latencyLock);
+      apx_latencyStats_getSummary(&self->latencyStats, summary);
+      SPINLOCK_LEAVE(self->latencyLock);
+   }
+}
+
+/**
+ * Collects the counters of this connection into stats.
+ * Receive counters are read without locking, they are only written by the receiving thread and may lag behind by one message.
+ */
+void apx_connectionBase_getStats(apx_connectionBase_t *self, apx_connectionStats_t *stats)
+{
+   if ( (self != 0) && (stats != 0) )
+   {
+      stats->connectionId = self->connectionId;
+      stats->numNodes = apx_nodeManager_length(&self->nodeManager);
+      stats->totalBytesReceived = self->totalBytesReceived;
+      stats->totalMessagesReceived = self->totalMessagesReceived;
+      stats->numPendingWorkerMessages = apx_connectionBase_getNumPendingWorkerMessages(self);
+      stats->numPendingEvents = apx_connectionBase_getNumPendingEvents(self);
+      apx_fileManager_getWorkerStats(&self->fileManager, &stats->workerStats);
+      apx_allocator_getStats(&self->allocator, &stats->allocatorStats);
+      apx_connectionBase_getLatencySummary(self, &stats->latency);
+   }
+}
+
 
 /*** Internal Callback API ***/
 //Callbacks triggered due to events happening remotely
@@ -307,6 +453,15 @@ void apx_connectionBase_free(apx_connectionBase_t *self, uint8_t *ptr, size_t si
  * New fileInfo has been received
  */
 apx_error_t apx_connectionBase_fileInfoNotify(apx_connectionBase_t *self, const rmf_fileInfo_t *remoteFileInfo)
+{
+   return apx_connectionBase_compressedFileInfoNotify(self, remoteFileInfo, (const rmf_cmdCompressInfo_t*) 0);
+}
+
+/**
+ * Same as apx_connectionBase_fileInfoNotify but for RMF_FILE_TYPE_COMPRESSED_FIXED files.
+ * The file manager takes care of decompression, file handlers receive the uncompressed data.
+ */
+apx_error_t apx_connectionBase_compressedFileInfoNotify(apx_connectionBase_t *self, const rmf_fileInfo_t *remoteFileInfo, const rmf_cmdCompressInfo_t *compressInfo)
 {
    if ( (self != 0) && (remoteFileInfo != 0) )
    {
@@ -314,6 +469,10 @@ apx_error_t apx_connectionBase_fileInfoNotify(apx_connectionBase_t *self, const
       apx_error_t rc = apx_fileInfo_create_rmf(&fileInfo, remoteFileInfo, true);
       if (rc == APX_NO_ERROR)
       {
+         if (compressInfo != 0)
+         {
+            apx_fileInfo_setCompression(&fileInfo, compressInfo->compressionType, compressInfo->uncompressedLength);
+         }
          apx_file_t *file = apx_fileManager_fileInfoNotify(&self->fileManager, &fileInfo);
          if (file == 0)
          {
@@ -423,6 +582,7 @@ apx_error_t apx_connectionBase_updateProvidePortDataDirect(apx_connectionBase_t
          isFileOpen = apx_file_isOpen(file);
          if (isFileOpen)
          {
+            apx_error_t result;
             uint8_t *dataBuf;
             uint32_t address;
             uint32_t startAddress = apx_file_getStartAddress(file);
@@ -433,7 +593,13 @@ apx_error_t apx_connectionBase_updateProvidePortDataDirect(apx_connectionBase_t
                return APX_MEM_ERROR;
             }
             memcpy(dataBuf, data, len);
-            return apx_fileManager_writeDynamicData(&self->fileManager, address, len, dataBuf);
+            result = apx_fileManager_writeDynamicData(&self->fileManager, address, len, dataBuf);
+            if (result != APX_NO_ERROR)
+            {
+               //the worker only takes ownership of dataBuf when the message was accepted
+               apx_allocator_free(&self->allocator, dataBuf, len);
+            }
+            return result;
          }
          else
          {
@@ -468,6 +634,7 @@ apx_error_t apx_connectionBase_updateRequirePortDataDirect(apx_connectionBase_t
          isFileOpen = apx_file_isOpen(file);
          if (isFileOpen)
          {
+            apx_error_t result;
             uint8_t *dataBuf;
             uint32_t address;
             uint32_t startAddress = apx_file_getStartAddress(file);
@@ -478,7 +645,13 @@ apx_error_t apx_connectionBase_updateRequirePortDataDirect(apx_connectionBase_t
                return APX_MEM_ERROR;
             }
             memcpy(dataBuf, data, len);
-            return apx_fileManager_writeDynamicData(&self->fileManager, address, len, dataBuf);
+            result = apx_fileManager_writeDynamicData(&self->fileManager, address, len, dataBuf);
+            if (result != APX_NO_ERROR)
+            {
+               //the worker only takes ownership of dataBuf when the message was accepted
+               apx_allocator_free(&self->allocator, dataBuf, len);
+            }
+            return result;
          }
          else
          {
@@ -490,6 +663,96 @@ apx_error_t apx_connectionBase_updateRequirePortDataDirect(apx_connectionBase_t
    return APX_INVALID_ARGUMENT_ERROR;
 }
 
+/**
+ * Server mode only. Transmits len bytes starting at payloadOffset in payload to require port data at offset in file.
+ * Unlike apx_connectionBase_updateRequirePortDataDirect, no per-connection copy of the data is made.
+ */
+apx_error_t apx_connectionBase_updateRequirePortDataPayload(apx_connectionBase_t *self, apx_file_t *file, apx_payload_t *payload, uint32_t payloadOffset, uint32_t offset, uint32_t len)
+{
+   if ( (self != 0) && (file != 0) && (payload != 0) )
+   {
+      if (self->mode == APX_CLIENT_MODE)
+      {
+         return APX_NOT_IMPLEMENTED_ERROR;
+      }
+      else
+      {
+         if (apx_file_isOpen(file))
+         {
+            uint32_t address = apx_file_getStartAddress(file) + offset;
+            return apx_fileManager_writePayload(&self->fileManager, address, payload, payloadOffset, len);
+         }
+         return APX_NO_ERROR;
+      }
+   }
+   return APX_INVALID_ARGUMENT_ERROR;
+}
+
+/**
+ * Server mode only. Schedules transmission of the dirty ranges reported by handler for require port data in file.
+ * Returns APX_FILE_NOT_OPEN_ERROR if the file has not yet been opened by the remote side.
+ */
+apx_error_t apx_connectionBase_updateRequirePortDataConflated(apx_connectionBase_t *self, apx_file_t *file, apx_fileConflationHandler_t *handler)
+{
+   if ( (self != 0) && (file != 0) && (handler != 0) )
+   {
+      if (self->mode == APX_CLIENT_MODE)
+      {
+         return APX_NOT_IMPLEMENTED_ERROR;
+      }
+      if (apx_file_isOpen(file) == false)
+      {
+         return APX_FILE_NOT_OPEN_ERROR;
+      }
+      return apx_fileManager_writeConflatedData(&self->fileManager, apx_file_getStartAddress(file), handler);
+   }
+   return APX_INVALID_ARGUMENT_ERROR;
+}
+
+/**
+ * Schedules transmission of the elements waiting in the queued port at offset in file.
+ * Used for provide port data in client mode and for require port data in server mode.
+ * Returns APX_FILE_NOT_OPEN_ERROR if the file has not yet been opened by the remote side.
+ */
+apx_error_t apx_connectionBase_updatePortDataQueued(apx_connectionBase_t *self, apx_file_t *file, uint32_t offset, uint32_t maxLen, apx_fileQueueHandler_t *handler)
+{
+   if ( (self != 0) && (file != 0) && (handler != 0) )
+   {
+      if (apx_file_isOpen(file) == false)
+      {
+         return APX_FILE_NOT_OPEN_ERROR;
+      }
+      return apx_fileManager_writeQueuedData(&self->fileManager, apx_file_getStartAddress(file) + offset, maxLen, handler);
+   }
+   return APX_INVALID_ARGUMENT_ERROR;
+}
+
+/**
+ * The timestamp in the response is the one we put in the request, so the round-trip time is measured against our own clock only.
+ * A new sample is reported to the event handler as APX_EVENT_CONNECTION_LATENCY.
+ */
+void apx_connectionBase_pingResponseNotify(apx_connectionBase_t *self, const rmf_cmdPing_t *cmdPing)
+{
+   if ( (self != 0) && (cmdPing != 0) )
+   {
+      apx_event_t event;
+      uint64_t now = apx_latencyStats_timestampUs();
+      uint64_t elapsed;
+      uint32_t rttUs;
+      if (cmdPing->timestamp > now)
+      {
+         return; //not a timestamp we generated
+      }
+      elapsed = now - cmdPing->timestamp;
+      rttUs = (elapsed > (uint64_t) UINT32_MAX)? UINT32_MAX : (uint32_t) elapsed;
+      SPINLOCK_ENTER(self->latencyLock);
+      apx_latencyStats_addSample(&self->latencyStats, rttUs);
+      SPINLOCK_LEAVE(self->latencyLock);
+      apx_event_fillConnectionLatency(&event, self, rttUs);
+      apx_eventLoop_append(&self->eventLoop, &event);
+   }
+}
+
 void apx_connectionBase_disconnectNotify(apx_connectionBase_t *self)
 {
    if (self != 0)
@@ -988,6 +1251,7 @@ static void apx_connectionBase_stopWorkerThread(apx_connectionBase_t *self)
 static apx_error_t apx_connectionBase_initTransmitHandler(apx_connectionBase_t *self)
 {
    apx_transmitHandler_t handler;
+   memset(&handler, 0, sizeof(handler)); //optional callbacks not set by the connection stay NULL
    if (self->vtable.fillTransmitHandler != 0)
    {
       apx_error_t rc = self->vtable.fillTransmitHandler((void*) self, &handler);
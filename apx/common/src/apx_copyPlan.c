@@ -0,0 +1,160 @@
+/*****************************************************************************
+* \file      apx_copyPlan.c
+* \author    Conny Gustafsson
+* \date      2026-10-18
+* \brief     Copy plan lowered from flat APX VM programs
+*
+* Copyright (c) 2026 Conny Gustafsson
+* Permission is hereby granted, free of charge, to any person obtaining a copy of
+* this software and associated documentation files (the "Software"), to deal in
+* the Software without restriction, including without limitation the rights to
+* use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+* the Software, and to permit persons to whom the Software is furnished to do so,
+* subject to the following conditions:
+
+* The above copyright notice and this permission notice shall be included in all
+* copies or substantial portions of the Software.
+
+* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+* IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+* FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+* COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+* IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+* CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+*
+******************************************************************************/
+//////////////////////////////////////////////////////////////////////////////
+// INCLUDES
+//////////////////////////////////////////////////////////////////////////////
+#include <malloc.h>
+#include <string.h>
+#include "apx_copyPlan.h"
+#ifdef MEM_LEAK_CHECK
+#include "CMemLeak.h"
+#endif
+
+//////////////////////////////////////////////////////////////////////////////
+// PRIVATE CONSTANTS AND DATA TYPES
+//////////////////////////////////////////////////////////////////////////////
+#define APX_COPY_PLAN_GROW_SIZE 8u
+
+//////////////////////////////////////////////////////////////////////////////
+// PRIVATE FUNCTION PROTOTYPES
+//////////////////////////////////////////////////////////////////////////////
+
+//////////////////////////////////////////////////////////////////////////////
+// PRIVATE VARIABLES
+//////////////////////////////////////////////////////////////////////////////
+
+//////////////////////////////////////////////////////////////////////////////
+// PUBLIC FUNCTIONS
+//////////////////////////////////////////////////////////////////////////////
+void apx_copyPlan_create(apx_copyPlan_t *self, uint8_t progType)
+{
+   if (self != 0)
+   {
+      self->runs = (apx_copyRun_t*) 0;
+      self->numRuns = 0u;
+      self->allocLen = 0u;
+      self->dataSize = 0u;
+      self->progType = progType;
+   }
+}
+
+void apx_copyPlan_destroy(apx_copyPlan_t *self)
+{
+   if ( (self != 0) && (self->runs != 0) )
+   {
+      free(self->runs);
+      self->runs = (apx_copyRun_t*) 0;
+      self->numRuns = 0u;
+      self->allocLen = 0u;
+   }
+}
+
+apx_copyPlan_t *apx_copyPlan_new(uint8_t progType)
+{
+   apx_copyPlan_t *self = (apx_copyPlan_t*) malloc(sizeof(apx_copyPlan_t));
+   if (self != 0)
+   {
+      apx_copyPlan_create(self, progType);
+   }
+   return self;
+}
+
+void apx_copyPlan_delete(apx_copyPlan_t *self)
+{
+   if (self != 0)
+   {
+      apx_copyPlan_destroy(self);
+      free(self);
+   }
+}
+
+void apx_copyPlan_vdelete(void *arg)
+{
+   apx_copyPlan_delete((apx_copyPlan_t*) arg);
+}
+
+apx_error_t apx_copyPlan_appendRun(apx_copyPlan_t *self, apx_size_t dataOffset, uint8_t width, uint32_t count, uint8_t flags)
+{
+   if ( (self != 0) && (width > 0u) && (count > 0u) )
+   {
+      apx_copyRun_t *run;
+      if (self->numRuns == self->allocLen)
+      {
+         uint32_t allocLen = self->allocLen + APX_COPY_PLAN_GROW_SIZE;
+         apx_copyRun_t *runs = (apx_copyRun_t*) realloc(self->runs, sizeof(apx_copyRun_t) * allocLen);
+         if (runs == 0)
+         {
+            return APX_MEM_ERROR;
+         }
+         self->runs = runs;
+         self->allocLen = allocLen;
+      }
+      run = &self->runs[self->numRuns];
+      run->dataOffset = dataOffset;
+      run->elementIndex = self->numRuns;
+      run->count = count;
+      run->width = width;
+      run->flags = flags;
+      self->numRuns++;
+      if ( (dataOffset + width * count) > self->dataSize)
+      {
+         self->dataSize = dataOffset + width * count;
+      }
+      return APX_NO_ERROR;
+   }
+   return APX_INVALID_ARGUMENT_ERROR;
+}
+
+uint32_t apx_copyPlan_length(const apx_copyPlan_t *self)
+{
+   if (self != 0)
+   {
+      return self->numRuns;
+   }
+   return 0u;
+}
+
+const apx_copyRun_t *apx_copyPlan_getRun(const apx_copyPlan_t *self, uint32_t index)
+{
+   if ( (self != 0) && (index < self->numRuns) )
+   {
+      return &self->runs[index];
+   }
+   return (const apx_copyRun_t*) 0;
+}
+
+apx_size_t apx_copyPlan_getDataSize(const apx_copyPlan_t *self)
+{
+   if (self != 0)
+   {
+      return self->dataSize;
+   }
+   return 0u;
+}
+
+//////////////////////////////////////////////////////////////////////////////
+// PRIVATE FUNCTIONS
+//////////////////////////////////////////////////////////////////////////////
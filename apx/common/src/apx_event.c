@@ -107,6 +107,17 @@ void apx_event_createHeaderAccepted(apx_event_t *event, struct apx_connectionBas
    }
 }
 
+void apx_event_fillConnectionLatency(apx_event_t *event, struct apx_connectionBase_tag *connection, uint32_t rttUs)
+{
+   if (event != 0)
+   {
+      memset(event, 0, APX_EVENT_SIZE);
+      event->evType = APX_EVENT_CONNECTION_LATENCY;
+      event->evData1 = (void*) connection;
+      event->evData4 = rttUs;
+   }
+}
+
 //////////////////////////////////////////////////////////////////////////////
 // PRIVATE FUNCTIONS
 //////////////////////////////////////////////////////////////////////////////
@@ -28,10 +28,15 @@
 //////////////////////////////////////////////////////////////////////////////
 #include <malloc.h>
 #include <assert.h>
+#include <string.h>
+#ifndef _WIN32
+#include <unistd.h> //needed for SLEEP macro
+#endif
 #include "apx_eventLoop.h"
 #include "apx_event.h"
 #include "apx_logging.h"
 #include "apx_fileManager.h"
+#include "apx_atomic.h"
 #ifdef MEM_LEAK_CHECK
 #include "CMemLeak.h"
 #endif
@@ -40,11 +45,20 @@
 //////////////////////////////////////////////////////////////////////////////
 // PRIVATE CONSTANTS AND DATA TYPES
 //////////////////////////////////////////////////////////////////////////////
+typedef struct apx_eventOverflowNode_tag
+{
+   struct apx_eventOverflowNode_tag *next;
+   apx_event_t event;
+} apx_eventOverflowNode_t;
 
 //////////////////////////////////////////////////////////////////////////////
 // PRIVATE FUNCTION PROTOTYPES
 //////////////////////////////////////////////////////////////////////////////
 static void apx_eventLoop_processEvent(apx_eventLoop_t *self, apx_event_t *event, apx_eventHandlerFunc_t *eventHandler, void *eventHandlerArg);
+static bool apx_eventLoop_runExecutorTask(void *arg);
+static bool apx_eventLoop_appendOverflow(apx_eventLoop_t *self, apx_event_t *event);
+static bool apx_eventLoop_popEvent(apx_eventLoop_t *self, apx_event_t *event);
+static bool apx_eventLoop_hasPendingEvents(apx_eventLoop_t *self);
 
 //////////////////////////////////////////////////////////////////////////////
 // PUBLIC FUNCTIONS
@@ -53,14 +67,21 @@ apx_error_t apx_eventLoop_create(apx_eventLoop_t *self)
 {
    if (self != 0)
    {
-      adt_buf_err_t result = adt_rbfh_create(&self->pendingEvents, (uint8_t) APX_EVENT_SIZE);
-      if (result != BUF_E_OK)
+      apx_error_t result = apx_mpscQueue_create(&self->pendingEvents, (uint32_t) APX_EVENT_SIZE, APX_MAX_NUM_EVENTS);
+      if (result != APX_NO_ERROR)
       {
-         return APX_MEM_ERROR;
+         return result;
       }
+      self->overflowHead = (apx_eventOverflowNode_t*) 0;
+      self->overflowTail = (apx_eventOverflowNode_t*) 0;
+      self->numOverflowEvents = 0u;
       self->exitFlag = false;
+      self->executor = (apx_executor_t*) 0;
+      self->eventHandler = (apx_eventHandlerFunc_t*) 0;
+      self->eventHandlerArg = (void*) 0;
+      apx_executorTask_create(&self->executorTask, apx_eventLoop_runExecutorTask, (void*) self);
       SPINLOCK_INIT(self->lock);
-      SEMAPHORE_CREATE(self->semaphore);
+      SPINLOCK_INIT(self->overflowLock);
       return APX_NO_ERROR;
    }
    return APX_INVALID_ARGUMENT_ERROR;
@@ -70,8 +91,15 @@ void apx_eventLoop_destroy(apx_eventLoop_t *self)
 {
    if (self != 0)
    {
+      while (self->overflowHead != 0)
+      {
+         apx_eventOverflowNode_t *node = self->overflowHead;
+         self->overflowHead = node->next;
+         free(node);
+      }
       SPINLOCK_DESTROY(self->lock);
-      adt_rbfh_destroy(&self->pendingEvents);
+      SPINLOCK_DESTROY(self->overflowLock);
+      apx_mpscQueue_destroy(&self->pendingEvents);
    }
 }
 
@@ -99,14 +127,36 @@ void apx_eventLoop_delete(apx_eventLoop_t *self)
    }
 }
 
+/**
+ * Never drops events. Events normally go into the lock-free pendingEvents queue. When it is full they are
+ * kept in an overflow list which the consumer processes once pendingEvents has been emptied.
+ */
 void apx_eventLoop_append(apx_eventLoop_t *self, apx_event_t *event)
 {
-   SPINLOCK_ENTER(self->lock);
-   adt_rbfh_insert(&self->pendingEvents, (const uint8_t*) event);
-   SPINLOCK_LEAVE(self->lock);
-#ifndef UNIT_TEST
-   SEMAPHORE_POST(self->semaphore);
-#endif
+   apx_executor_t *executor;
+   bool isAppended = false;
+   if (apx_atomic_load32(&self->numOverflowEvents) == 0u)
+   {
+      isAppended = (apx_mpscQueue_push(&self->pendingEvents, (const void*) event) == APX_NO_ERROR)? true : false;
+   }
+   if (!isAppended)
+   {
+      while (!apx_eventLoop_appendOverflow(self, event))
+      {
+         //Out of memory, wait for the consumer to make room in pendingEvents
+         if (apx_mpscQueue_push(&self->pendingEvents, (const void*) event) == APX_NO_ERROR)
+         {
+            break;
+         }
+         SLEEP(1);
+      }
+      apx_mpscQueue_wakeup(&self->pendingEvents);
+   }
+   executor = (apx_executor_t*) apx_atomic_loadPtr((void * volatile *) &self->executor);
+   if (executor != 0)
+   {
+      apx_executor_schedule(executor, &self->executorTask);
+   }
 }
 
 void apx_eventLoop_exit(apx_eventLoop_t *self)
@@ -116,7 +166,7 @@ void apx_eventLoop_exit(apx_eventLoop_t *self)
       SPINLOCK_ENTER(self->lock);
       self->exitFlag = true;
       SPINLOCK_LEAVE(self->lock);
-      SEMAPHORE_POST(self->semaphore);
+      apx_mpscQueue_wakeup(&self->pendingEvents);
    }
 }
 
@@ -129,24 +179,19 @@ void apx_eventLoop_run(apx_eventLoop_t *self, apx_eventHandlerFunc_t *eventHandl
    while(exitFlag == false)
    {
       apx_event_t event;
-#ifdef _MSC_VER
-      DWORD result = WaitForSingleObject(self->semaphore, INFINITE);
-      if (result == WAIT_OBJECT_0)
-#else
-      int result = sem_wait(&self->semaphore);
-      if (result == 0)
-#endif
+      bool hasEvent = apx_eventLoop_popEvent(self, &event);
+      SPINLOCK_ENTER(self->lock);
+      exitFlag = self->exitFlag;
+      SPINLOCK_LEAVE(self->lock);
+      if (exitFlag == false)
       {
-         SPINLOCK_ENTER(self->lock);
-         exitFlag = self->exitFlag;
-         if (exitFlag == false)
+         if (hasEvent)
          {
-            adt_rbfh_remove(&self->pendingEvents,(uint8_t*) &event);
+            apx_eventLoop_processEvent(self, &event, eventHandler, eventHandlerArg);
          }
-         SPINLOCK_LEAVE(self->lock);
-         if (exitFlag == false)
+         else
          {
-            apx_eventLoop_processEvent(self, &event, eventHandler, eventHandlerArg);
+            apx_mpscQueue_wait(&self->pendingEvents, APX_MPSC_QUEUE_WAIT_INFINITE);
          }
       }
    }
@@ -156,11 +201,52 @@ uint16_t apx_eventLoop_numPendingEvents(apx_eventLoop_t *self)
 {
    if (self != 0)
    {
-      return adt_rbfh_length(&self->pendingEvents);
+      return (uint16_t) (apx_mpscQueue_length(&self->pendingEvents) + apx_atomic_load32(&self->numOverflowEvents));
    }
    return 0;
 }
 
+/**
+ * Lets the threads of executor process events instead of a dedicated thread calling apx_eventLoop_run.
+ * Events are still processed in order, by at most one thread at a time.
+ */
+void apx_eventLoop_attachExecutor(apx_eventLoop_t *self, apx_executor_t *executor, apx_eventHandlerFunc_t *eventHandler, void *eventHandlerArg)
+{
+   if ( (self != 0) && (executor != 0) )
+   {
+      bool hasPendingEvents;
+      apx_executorTask_create(&self->executorTask, apx_eventLoop_runExecutorTask, (void*) self);
+      SPINLOCK_ENTER(self->lock);
+      self->eventHandler = eventHandler;
+      self->eventHandlerArg = eventHandlerArg;
+      (void) apx_atomic_exchangePtr((void * volatile *) &self->executor, (void*) executor);
+      SPINLOCK_LEAVE(self->lock);
+      hasPendingEvents = apx_eventLoop_hasPendingEvents(self);
+      if (hasPendingEvents)
+      {
+         apx_executor_schedule(executor, &self->executorTask);
+      }
+   }
+}
+
+/**
+ * Detaches event loop from its executor. Blocks until the executor is no longer processing events from this event loop.
+ */
+void apx_eventLoop_detachExecutor(apx_eventLoop_t *self)
+{
+   if (self != 0)
+   {
+      apx_executor_t *executor;
+      SPINLOCK_ENTER(self->lock);
+      executor = (apx_executor_t*) apx_atomic_exchangePtr((void * volatile *) &self->executor, (void*) 0);
+      SPINLOCK_LEAVE(self->lock);
+      if (executor != 0)
+      {
+         apx_executor_cancel(executor, &self->executorTask);
+      }
+   }
+}
+
 
 
 #ifdef UNIT_TEST
@@ -172,8 +258,7 @@ void apx_eventLoop_runAll(apx_eventLoop_t *self, apx_eventHandlerFunc_t *eventHa
    while(true)
    {
       apx_event_t event;
-      uint8_t rc = adt_rbfh_remove(&self->pendingEvents,(uint8_t*) &event);
-      if (rc == BUF_E_OK)
+      if (apx_eventLoop_popEvent(self, &event))
       {
          apx_eventLoop_processEvent(self, &event, eventHandler, eventHandlerArg);
       }
@@ -197,3 +282,96 @@ static void apx_eventLoop_processEvent(apx_eventLoop_t *self, apx_event_t *event
       eventHandler(eventHandlerArg, event);
    }
 }
+
+/**
+ * Executor task. Processes at most APX_EXECUTOR_MAX_WORK_PER_TASK events so that other connections sharing the executor get their turn.
+ */
+static bool apx_eventLoop_runExecutorTask(void *arg)
+{
+   apx_eventLoop_t *self = (apx_eventLoop_t*) arg;
+   if (self != 0)
+   {
+      int32_t numProcessed = 0;
+      bool hasMoreEvents = false;
+      while (numProcessed < APX_EXECUTOR_MAX_WORK_PER_TASK)
+      {
+         apx_event_t event;
+         if (apx_eventLoop_popEvent(self, &event) == false)
+         {
+            break;
+         }
+         apx_eventLoop_processEvent(self, &event, self->eventHandler, self->eventHandlerArg);
+         numProcessed++;
+      }
+      hasMoreEvents = apx_eventLoop_hasPendingEvents(self);
+      return hasMoreEvents;
+   }
+   return false;
+}
+
+/**
+ * Returns false when memory for the overflow node could not be allocated
+ */
+static bool apx_eventLoop_appendOverflow(apx_eventLoop_t *self, apx_event_t *event)
+{
+   apx_eventOverflowNode_t *node = (apx_eventOverflowNode_t*) malloc(sizeof(apx_eventOverflowNode_t));
+   if (node == 0)
+   {
+      return false;
+   }
+   node->next = (apx_eventOverflowNode_t*) 0;
+   memcpy(&node->event, event, sizeof(apx_event_t));
+   SPINLOCK_ENTER(self->overflowLock);
+   if (self->overflowTail == 0)
+   {
+      self->overflowHead = node;
+   }
+   else
+   {
+      self->overflowTail->next = node;
+   }
+   self->overflowTail = node;
+   apx_atomic_add32(&self->numOverflowEvents, 1u);
+   SPINLOCK_LEAVE(self->overflowLock);
+   return true;
+}
+
+/**
+ * Overflow events were appended after everything currently in pendingEvents, they are therefore taken last.
+ */
+static bool apx_eventLoop_popEvent(apx_eventLoop_t *self, apx_event_t *event)
+{
+   apx_eventOverflowNode_t *node = (apx_eventOverflowNode_t*) 0;
+   if (apx_mpscQueue_pop(&self->pendingEvents, (void*) event))
+   {
+      return true;
+   }
+   if (apx_atomic_load32(&self->numOverflowEvents) == 0u)
+   {
+      return false;
+   }
+   SPINLOCK_ENTER(self->overflowLock);
+   node = self->overflowHead;
+   if (node != 0)
+   {
+      self->overflowHead = node->next;
+      if (self->overflowHead == 0)
+      {
+         self->overflowTail = (apx_eventOverflowNode_t*) 0;
+      }
+      apx_atomic_sub32(&self->numOverflowEvents, 1u);
+   }
+   SPINLOCK_LEAVE(self->overflowLock);
+   if (node == 0)
+   {
+      return false;
+   }
+   memcpy(event, &node->event, sizeof(apx_event_t));
+   free(node);
+   return true;
+}
+
+static bool apx_eventLoop_hasPendingEvents(apx_eventLoop_t *self)
+{
+   return ( (apx_mpscQueue_length(&self->pendingEvents) > 0u) || (apx_atomic_load32(&self->numOverflowEvents) > 0u) )? true : false;
+}
@@ -0,0 +1,465 @@
+/*****************************************************************************
+* \file      apx_executor.c
+* \author    Conny Gustafsson
+* \date      2026-10-18
+* \brief     Fixed-size worker pool that runs connection tasks
+*
+* Copyright (c) 2026 Conny Gustafsson
+* Permission is hereby granted, free of charge, to any person obtaining a copy of
+* this software and associated documentation files (the "Software"), to deal in
+* the Software without restriction, including without limitation the rights to
+* use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+* the Software, and to permit persons to whom the Software is furnished to do so,
+* subject to the following conditions:
+
+* The above copyright notice and this permission notice shall be included in all
+* copies or substantial portions of the Software.
+
+* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+* IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+* FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+* COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+* IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+* CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+*
+******************************************************************************/
+//////////////////////////////////////////////////////////////////////////////
+// INCLUDES
+//////////////////////////////////////////////////////////////////////////////
+#include <malloc.h>
+#include <assert.h>
+#include <stdio.h>
+#include "apx_executor.h"
+#ifndef _WIN32
+#include <unistd.h> //needed for SLEEP macro
+#endif
+#ifdef MEM_LEAK_CHECK
+#include "CMemLeak.h"
+#endif
+
+//////////////////////////////////////////////////////////////////////////////
+// PRIVATE CONSTANTS AND DATA TYPES
+//////////////////////////////////////////////////////////////////////////////
+
+//////////////////////////////////////////////////////////////////////////////
+// PRIVATE FUNCTION PROTOTYPES
+//////////////////////////////////////////////////////////////////////////////
+static void apx_executor_enqueue(apx_executor_t *self, apx_executorTask_t *task);
+static apx_executorTask_t *apx_executor_dequeue(apx_executor_t *self);
+static void apx_executor_remove(apx_executor_t *self, apx_executorTask_t *task);
+static void apx_executor_runTask(apx_executor_t *self, apx_executorTask_t *task);
+static bool apx_executor_isRunningOnCurrentThread(apx_executorTask_t *task);
+#ifndef UNIT_TEST
+static THREAD_PROTO(executorThread,arg);
+#endif
+
+//////////////////////////////////////////////////////////////////////////////
+// PRIVATE VARIABLES
+//////////////////////////////////////////////////////////////////////////////
+
+//////////////////////////////////////////////////////////////////////////////
+// PUBLIC FUNCTIONS
+//////////////////////////////////////////////////////////////////////////////
+apx_error_t apx_executor_create(apx_executor_t *self, uint32_t numThreads)
+{
+   if ( (self != 0) && (numThreads > 0u) )
+   {
+      self->threads = (THREAD_T*) malloc(sizeof(THREAD_T) * numThreads);
+      if (self->threads == 0)
+      {
+         return APX_MEM_ERROR;
+      }
+#ifdef _WIN32
+      self->threadIds = (unsigned int*) malloc(sizeof(unsigned int) * numThreads);
+      if (self->threadIds == 0)
+      {
+         free(self->threads);
+         return APX_MEM_ERROR;
+      }
+#endif
+      self->numThreads = numThreads;
+      self->numThreadsStarted = 0u;
+      self->queueHead = (apx_executorTask_t*) 0;
+      self->queueTail = (apx_executorTask_t*) 0;
+      self->exitFlag = false;
+      self->numTaskRuns = 0u;
+      SPINLOCK_INIT(self->lock);
+      SEMAPHORE_CREATE(self->semaphore);
+      return APX_NO_ERROR;
+   }
+   return APX_INVALID_ARGUMENT_ERROR;
+}
+
+void apx_executor_destroy(apx_executor_t *self)
+{
+   if (self != 0)
+   {
+      apx_executor_stop(self);
+      SPINLOCK_DESTROY(self->lock);
+      SEMAPHORE_DESTROY(self->semaphore);
+      free(self->threads);
+#ifdef _WIN32
+      free(self->threadIds);
+#endif
+   }
+}
+
+apx_executor_t *apx_executor_new(uint32_t numThreads)
+{
+   apx_executor_t *self = (apx_executor_t*) malloc(sizeof(apx_executor_t));
+   if (self != 0)
+   {
+      apx_error_t result = apx_executor_create(self, numThreads);
+      if (result != APX_NO_ERROR)
+      {
+         free(self);
+         self = (apx_executor_t*) 0;
+      }
+   }
+   return self;
+}
+
+void apx_executor_delete(apx_executor_t *self)
+{
+   if (self != 0)
+   {
+      apx_executor_destroy(self);
+      free(self);
+   }
+}
+
+apx_error_t apx_executor_start(apx_executor_t *self)
+{
+   if (self != 0)
+   {
+#ifndef UNIT_TEST
+      self->exitFlag = false;
+      while (self->numThreadsStarted < self->numThreads)
+      {
+         uint32_t i = self->numThreadsStarted;
+# ifdef _MSC_VER
+         THREAD_CREATE(self->threads[i], executorThread, self, self->threadIds[i]);
+         if (self->threads[i] == INVALID_HANDLE_VALUE)
+         {
+            return APX_THREAD_CREATE_ERROR;
+         }
+# else
+         int rc = THREAD_CREATE(self->threads[i], executorThread, self);
+         if (rc != 0)
+         {
+            return APX_THREAD_CREATE_ERROR;
+         }
+# endif
+         self->numThreadsStarted++;
+      }
+#endif
+      return APX_NO_ERROR;
+   }
+   return APX_INVALID_ARGUMENT_ERROR;
+}
+
+void apx_executor_stop(apx_executor_t *self)
+{
+   if ( (self != 0) && (self->numThreadsStarted > 0u) )
+   {
+      uint32_t i;
+      SPINLOCK_ENTER(self->lock);
+      self->exitFlag = true;
+      SPINLOCK_LEAVE(self->lock);
+      for (i = 0u; i < self->numThreadsStarted; i++)
+      {
+         SEMAPHORE_POST(self->semaphore);
+      }
+      for (i = 0u; i < self->numThreadsStarted; i++)
+      {
+#ifdef _MSC_VER
+         DWORD result = WaitForSingleObject(self->threads[i], 5000);
+         if (result == WAIT_TIMEOUT)
+         {
+            fprintf(stderr, "[APX_EXECUTOR] timeout while joining executor thread\n");
+         }
+         CloseHandle(self->threads[i]);
+         self->threads[i] = INVALID_HANDLE_VALUE;
+#else
+         if (pthread_equal(pthread_self(), self->threads[i]) == 0)
+         {
+            void *status;
+            int s = pthread_join(self->threads[i], &status);
+            if (s != 0)
+            {
+               printf("[APX_EXECUTOR] pthread_join error %d\n", s);
+            }
+         }
+         else
+         {
+            printf("[APX_EXECUTOR] pthread_join attempted on pthread_self()\n");
+         }
+#endif
+      }
+      self->numThreadsStarted = 0u;
+   }
+}
+
+uint32_t apx_executor_getNumThreads(const apx_executor_t *self)
+{
+   if (self != 0)
+   {
+      return self->numThreads;
+   }
+   return 0u;
+}
+
+uint32_t apx_executor_getNumTaskRuns(apx_executor_t *self)
+{
+   uint32_t retval = 0u;
+   if (self != 0)
+   {
+      SPINLOCK_ENTER(self->lock);
+      retval = self->numTaskRuns;
+      SPINLOCK_LEAVE(self->lock);
+   }
+   return retval;
+}
+
+/**
+ * Requests that task is run by one of the executor threads.
+ */
+void apx_executor_schedule(apx_executor_t *self, apx_executorTask_t *task)
+{
+   if ( (self != 0) && (task != 0) )
+   {
+      bool isEnqueued = false;
+      SPINLOCK_ENTER(self->lock);
+      if (task->isCancelled == false)
+      {
+         if (task->isRunning)
+         {
+            task->isRescheduled = true;
+         }
+         else if (task->isQueued == false)
+         {
+            apx_executor_enqueue(self, task);
+            isEnqueued = true;
+         }
+      }
+      SPINLOCK_LEAVE(self->lock);
+      if (isEnqueued)
+      {
+         SEMAPHORE_POST(self->semaphore);
+      }
+   }
+}
+
+/**
+ * Removes task from the executor. If the task is currently running on another thread this function blocks until it has finished.
+ * The task will not run again until apx_executorTask_create is called on it.
+ */
+void apx_executor_cancel(apx_executor_t *self, apx_executorTask_t *task)
+{
+   if ( (self != 0) && (task != 0) )
+   {
+      SPINLOCK_ENTER(self->lock);
+      task->isCancelled = true;
+      if (task->isQueued)
+      {
+         apx_executor_remove(self, task);
+      }
+      while ( (task->isRunning) && (apx_executor_isRunningOnCurrentThread(task) == false) )
+      {
+         SPINLOCK_LEAVE(self->lock);
+         SLEEP(0);
+         SPINLOCK_ENTER(self->lock);
+      }
+      SPINLOCK_LEAVE(self->lock);
+   }
+}
+
+void apx_executorTask_create(apx_executorTask_t *self, apx_executorTaskFunc *run, void *arg)
+{
+   if (self != 0)
+   {
+      self->run = run;
+      self->arg = arg;
+      self->next = (apx_executorTask_t*) 0;
+      self->isQueued = false;
+      self->isRunning = false;
+      self->isRescheduled = false;
+      self->isCancelled = false;
+#ifdef _WIN32
+      self->runningThreadId = 0u;
+#endif
+   }
+}
+
+#ifdef UNIT_TEST
+/**
+ * Runs the first task in the run queue on the calling thread. Returns false when the run queue is empty.
+ */
+bool apx_executor_run(apx_executor_t *self)
+{
+   if (self != 0)
+   {
+      apx_executorTask_t *task;
+      SPINLOCK_ENTER(self->lock);
+      task = apx_executor_dequeue(self);
+      SPINLOCK_LEAVE(self->lock);
+      if (task != 0)
+      {
+         apx_executor_runTask(self, task);
+         return true;
+      }
+   }
+   return false;
+}
+#endif
+
+//////////////////////////////////////////////////////////////////////////////
+// PRIVATE FUNCTIONS
+//////////////////////////////////////////////////////////////////////////////
+
+static void apx_executor_enqueue(apx_executor_t *self, apx_executorTask_t *task)
+{
+   task->next = (apx_executorTask_t*) 0;
+   task->isQueued = true;
+   if (self->queueTail == 0)
+   {
+      self->queueHead = task;
+   }
+   else
+   {
+      self->queueTail->next = task;
+   }
+   self->queueTail = task;
+}
+
+/**
+ * Removes first task from run queue and marks it as running. Caller must hold the lock.
+ */
+static apx_executorTask_t *apx_executor_dequeue(apx_executor_t *self)
+{
+   apx_executorTask_t *task = self->queueHead;
+   if (task != 0)
+   {
+      self->queueHead = task->next;
+      if (self->queueHead == 0)
+      {
+         self->queueTail = (apx_executorTask_t*) 0;
+      }
+      task->next = (apx_executorTask_t*) 0;
+      task->isQueued = false;
+      task->isRunning = true;
+#ifdef _WIN32
+      task->runningThreadId = GetCurrentThreadId();
+#else
+      task->runningThread = pthread_self();
+#endif
+   }
+   return task;
+}
+
+static void apx_executor_remove(apx_executor_t *self, apx_executorTask_t *task)
+{
+   apx_executorTask_t *prev = (apx_executorTask_t*) 0;
+   apx_executorTask_t *iter = self->queueHead;
+   while (iter != 0)
+   {
+      if (iter == task)
+      {
+         if (prev == 0)
+         {
+            self->queueHead = iter->next;
+         }
+         else
+         {
+            prev->next = iter->next;
+         }
+         if (self->queueTail == iter)
+         {
+            self->queueTail = prev;
+         }
+         break;
+      }
+      prev = iter;
+      iter = iter->next;
+   }
+   task->next = (apx_executorTask_t*) 0;
+   task->isQueued = false;
+}
+
+/**
+ * Runs a task previously returned by apx_executor_dequeue. The task is put back into the run queue if it reported more work
+ * or if it was scheduled again while running.
+ */
+static void apx_executor_runTask(apx_executor_t *self, apx_executorTask_t *task)
+{
+   bool hasMoreWork = false;
+   bool isEnqueued = false;
+   assert(task->run != 0);
+   hasMoreWork = task->run(task->arg);
+   SPINLOCK_ENTER(self->lock);
+   task->isRunning = false;
+   self->numTaskRuns++;
+   if ( (task->isCancelled == false) && ( hasMoreWork || task->isRescheduled ) )
+   {
+      apx_executor_enqueue(self, task);
+      isEnqueued = true;
+   }
+   task->isRescheduled = false;
+   SPINLOCK_LEAVE(self->lock);
+   if (isEnqueued)
+   {
+#ifndef UNIT_TEST
+      SEMAPHORE_POST(self->semaphore);
+#endif
+   }
+}
+
+static bool apx_executor_isRunningOnCurrentThread(apx_executorTask_t *task)
+{
+#ifdef _WIN32
+   return (task->runningThreadId == GetCurrentThreadId())? true : false;
+#else
+   return (pthread_equal(task->runningThread, pthread_self()) != 0)? true : false;
+#endif
+}
+
+#ifndef UNIT_TEST
+static THREAD_PROTO(executorThread,arg)
+{
+   apx_executor_t *self = (apx_executor_t*) arg;
+   if (self != 0)
+   {
+      for(;;)
+      {
+         apx_executorTask_t *task = (apx_executorTask_t*) 0;
+         bool exitFlag;
+#ifdef _MSC_VER
+         DWORD result = WaitForSingleObject(self->semaphore, INFINITE);
+         if (result != WAIT_OBJECT_0)
+#else
+         int result = sem_wait(&self->semaphore);
+         if (result != 0)
+#endif
+         {
+            continue;
+         }
+         SPINLOCK_ENTER(self->lock);
+         exitFlag = self->exitFlag;
+         if (exitFlag == false)
+         {
+            task = apx_executor_dequeue(self); //can be NULL when a queued task was cancelled
+         }
+         SPINLOCK_LEAVE(self->lock);
+         if (exitFlag)
+         {
+            break;
+         }
+         if (task != 0)
+         {
+            apx_executor_runTask(self, task);
+         }
+      }
+   }
+   THREAD_RETURN(0);
+}
+#endif
@@ -2,7 +2,7 @@
 * \file      apx_fileCache.c
 * \author    Conny Gustafsson
 * \date      2018-08-03
-* \brief     Handles locally cached .apx files
+* \brief     Cache of built node definitions, keyed by SHA-256 digest of the .apx file
 *
 * Copyright (c) 2018 Conny Gustafsson
 * Permission is hereby granted, free of charge, to any person obtaining a copy of
@@ -26,15 +26,24 @@
 //////////////////////////////////////////////////////////////////////////////
 // INCLUDES
 //////////////////////////////////////////////////////////////////////////////
+#include <stdlib.h>
+#include <string.h>
 #include "apx_fileCache.h"
+#include "apx_atomic.h"
+#ifdef MEM_LEAK_CHECK
+#include "CMemLeak.h"
+#endif
 
 //////////////////////////////////////////////////////////////////////////////
 // PRIVATE CONSTANTS AND DATA TYPES
 //////////////////////////////////////////////////////////////////////////////
+#define DIGEST_KEY_SIZE (APX_SHA256_DIGEST_SIZE * 2u + 1u) //hex string including null terminator
 
 //////////////////////////////////////////////////////////////////////////////
 // PRIVATE FUNCTION PROTOTYPES
 //////////////////////////////////////////////////////////////////////////////
+static void apx_fileCache_digestToKey(const uint8_t *digest, char *key);
+static apx_fileCacheEntry_t *apx_fileCache_allocEntry(apx_fileCache_t *self);
 
 //////////////////////////////////////////////////////////////////////////////
 // PUBLIC VARIABLES
@@ -47,9 +56,184 @@
 //////////////////////////////////////////////////////////////////////////////
 // PUBLIC FUNCTIONS
 //////////////////////////////////////////////////////////////////////////////
+void apx_fileCache_create(apx_fileCache_t *self, uint32_t maxEntries)
+{
+   if (self != 0)
+   {
+      adt_hash_create(&self->nodeInfoMap, (void (*)(void*)) 0);
+      self->entries = (apx_fileCacheEntry_t*) 0;
+      self->maxEntries = 0u;
+      self->useCounter = 0u;
+      if (maxEntries > 0u)
+      {
+         self->entries = (apx_fileCacheEntry_t*) calloc(maxEntries, sizeof(apx_fileCacheEntry_t));
+         if (self->entries != 0)
+         {
+            self->maxEntries = maxEntries;
+         }
+      }
+      memset(&self->stats, 0, sizeof(apx_fileCacheStats_t));
+      MUTEX_INIT(self->lock);
+   }
+}
+
+void apx_fileCache_destroy(apx_fileCache_t *self)
+{
+   if (self != 0)
+   {
+      uint32_t i;
+      adt_hash_destroy(&self->nodeInfoMap);
+      for (i = 0u; i < self->maxEntries; i++)
+      {
+         apx_nodeInfo_release(self->entries[i].nodeInfo);
+      }
+      if (self->entries != 0)
+      {
+         free(self->entries);
+      }
+      MUTEX_DESTROY(self->lock);
+   }
+}
+
+apx_fileCache_t *apx_fileCache_new(uint32_t maxEntries)
+{
+   apx_fileCache_t *self = (apx_fileCache_t*) malloc(sizeof(apx_fileCache_t));
+   if (self != 0)
+   {
+      apx_fileCache_create(self, maxEntries);
+   }
+   return self;
+}
+
+void apx_fileCache_delete(apx_fileCache_t *self)
+{
+   if (self != 0)
+   {
+      apx_fileCache_destroy(self);
+      free(self);
+   }
+}
+
+/**
+ * Returns a new reference to the nodeInfo built from the definition file with the given SHA-256 digest
+ * (the caller must release it), or NULL when no such nodeInfo is cached.
+ */
+apx_nodeInfo_t *apx_fileCache_findNodeInfo(apx_fileCache_t *self, const uint8_t *digest)
+{
+   if ( (self != 0) && (digest != 0) )
+   {
+      char key[DIGEST_KEY_SIZE];
+      void **ppVal;
+      apx_nodeInfo_t *nodeInfo = (apx_nodeInfo_t*) 0;
+      apx_fileCache_digestToKey(digest, &key[0]);
+      MUTEX_LOCK(self->lock);
+      ppVal = adt_hash_get(&self->nodeInfoMap, &key[0]);
+      if (ppVal != 0)
+      {
+         apx_fileCacheEntry_t *entry = (apx_fileCacheEntry_t*) *ppVal;
+         entry->lastUsed = ++self->useCounter;
+         nodeInfo = entry->nodeInfo;
+         apx_nodeInfo_retain(nodeInfo);
+         self->stats.numHits++;
+      }
+      else
+      {
+         self->stats.numMisses++;
+      }
+      MUTEX_UNLOCK(self->lock);
+      return nodeInfo;
+   }
+   return (apx_nodeInfo_t*) 0;
+}
+
+/**
+ * Adds nodeInfo to the cache, taking a new reference to it. nodeInfo must not be modified after this call.
+ * Returns APX_NO_ERROR without doing anything if the digest is already known, or if the cache is full and
+ * every cached nodeInfo is still in use by a node instance.
+ */
+apx_error_t apx_fileCache_insertNodeInfo(apx_fileCache_t *self, const uint8_t *digest, apx_nodeInfo_t *nodeInfo)
+{
+   if ( (self != 0) && (digest != 0) && (nodeInfo != 0) )
+   {
+      char key[DIGEST_KEY_SIZE];
+      apx_fileCache_digestToKey(digest, &key[0]);
+      MUTEX_LOCK(self->lock);
+      if (adt_hash_get(&self->nodeInfoMap, &key[0]) == 0)
+      {
+         apx_fileCacheEntry_t *entry = apx_fileCache_allocEntry(self);
+         if (entry != 0)
+         {
+            apx_nodeInfo_retain(nodeInfo);
+            entry->nodeInfo = nodeInfo;
+            entry->lastUsed = ++self->useCounter;
+            memcpy(&entry->digest[0], digest, APX_SHA256_DIGEST_SIZE);
+            adt_hash_set(&self->nodeInfoMap, &key[0], (void*) entry);
+            self->stats.numEntries++;
+         }
+      }
+      MUTEX_UNLOCK(self->lock);
+      return APX_NO_ERROR;
+   }
+   return APX_INVALID_ARGUMENT_ERROR;
+}
+
+void apx_fileCache_getStats(apx_fileCache_t *self, apx_fileCacheStats_t *stats)
+{
+   if ( (self != 0) && (stats != 0) )
+   {
+      MUTEX_LOCK(self->lock);
+      memcpy(stats, &self->stats, sizeof(apx_fileCacheStats_t));
+      MUTEX_UNLOCK(self->lock);
+   }
+}
 
 //////////////////////////////////////////////////////////////////////////////
 // PRIVATE FUNCTIONS
 //////////////////////////////////////////////////////////////////////////////
+static void apx_fileCache_digestToKey(const uint8_t *digest, char *key)
+{
+   static const char hexDigits[] = "0123456789abcdef";
+   uint32_t i;
+   for (i = 0u; i < APX_SHA256_DIGEST_SIZE; i++)
+   {
+      key[i * 2u] = hexDigits[digest[i] >> 4];
+      key[i * 2u + 1u] = hexDigits[digest[i] & 0x0Fu];
+   }
+   key[APX_SHA256_DIGEST_SIZE * 2u] = '\0';
+}
+
+/**
+ * Returns an unused slot. When there is none, the least recently used entry whose nodeInfo is only referenced by
+ * the cache is evicted. No new references can be taken while lock is held, which makes the refCount check safe.
+ */
+static apx_fileCacheEntry_t *apx_fileCache_allocEntry(apx_fileCache_t *self)
+{
+   uint32_t i;
+   apx_fileCacheEntry_t *victim = (apx_fileCacheEntry_t*) 0;
+   for (i = 0u; i < self->maxEntries; i++)
+   {
+      apx_fileCacheEntry_t *entry = &self->entries[i];
+      if (entry->nodeInfo == 0)
+      {
+         return entry;
+      }
+      if ( (apx_atomic_load32(&entry->nodeInfo->refCount) == 1u) &&
+           ( (victim == 0) || ( (self->useCounter - entry->lastUsed) > (self->useCounter - victim->lastUsed) ) ) )
+      {
+         victim = entry;
+      }
+   }
+   if (victim != 0)
+   {
+      char key[DIGEST_KEY_SIZE];
+      apx_fileCache_digestToKey(&victim->digest[0], &key[0]);
+      (void) adt_hash_remove(&self->nodeInfoMap, &key[0]);
+      apx_nodeInfo_release(victim->nodeInfo);
+      victim->nodeInfo = (apx_nodeInfo_t*) 0;
+      self->stats.numEntries--;
+      self->stats.numEvictions++;
+   }
+   return victim;
+}
 
 
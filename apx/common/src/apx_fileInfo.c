@@ -59,6 +59,8 @@ apx_error_t apx_fileInfo_create(apx_fileInfo_t *self, uint32_t address, uint32_t
    {
       apx_fileInfo_setAddress(self, address);
       self->length = length;
+      self->uncompressedLength = length;
+      self->compressionType = RMF_COMPRESSION_NONE;
       self->fileType = fileType;
       self->digestType = digestType;
       self->name = STRDUP(name);
@@ -157,6 +159,8 @@ apx_error_t apx_fileInfo_assign(apx_fileInfo_t *self, const apx_fileInfo_t *othe
    {
       apx_fileInfo_setAddress(self, other->address);
       self->length = other->length;
+      self->uncompressedLength = other->uncompressedLength;
+      self->compressionType = other->compressionType;
       self->fileType = other->fileType;
       self->digestType = other->digestType;
       self->name = (char*) 0;
@@ -196,6 +200,10 @@ apx_fileInfo_t* apx_fileInfo_clone(const apx_fileInfo_t *other)
             free(self);
             self = (apx_fileInfo_t*) 0;
          }
+         else
+         {
+            apx_fileInfo_setCompression(self, other->compressionType, other->uncompressedLength);
+         }
       }
       return self;
    }
@@ -249,6 +257,28 @@ void apx_fileInfo_fillRmfInfo(const apx_fileInfo_t *self, rmf_fileInfo_t *rmfInf
    }
 }
 
+/**
+ * Used with RMF_FILE_TYPE_COMPRESSED_FIXED files where the length attribute is the compressed length
+ */
+void apx_fileInfo_setCompression(apx_fileInfo_t *self, uint16_t compressionType, uint32_t uncompressedLength)
+{
+   if (self != 0)
+   {
+      self->compressionType = compressionType;
+      self->uncompressedLength = uncompressedLength;
+   }
+}
+
+void apx_fileInfo_fillRmfCompressInfo(const apx_fileInfo_t *self, rmf_cmdCompressInfo_t *compressInfo)
+{
+   if ( (self != 0) && (compressInfo != 0) )
+   {
+      compressInfo->address = self->address;
+      compressInfo->compressionType = self->compressionType;
+      compressInfo->uncompressedLength = self->uncompressedLength;
+   }
+}
+
 bool apx_fileInfo_isRemoteAddress(apx_fileInfo_t *self)
 {
    if (self != 0)
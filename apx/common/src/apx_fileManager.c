@@ -44,10 +44,14 @@
 //////////////////////////////////////////////////////////////////////////////
 // PRIVATE FUNCTION PROTOTYPES
 //////////////////////////////////////////////////////////////////////////////
+static apx_error_t apx_fileManager_processCompleteMsg(apx_fileManager_t *self, uint32_t address, const uint8_t *msgBuf, apx_size_t msgSize);
 static apx_error_t apx_fileManager_processCmdMsg(apx_fileManager_t *self, const uint8_t *msgBuf, int32_t msgLen);
 static apx_error_t apx_fileManager_processDataMsg(apx_fileManager_t *self, uint32_t address, const uint8_t *msgBuf, int32_t msgLen);
 static apx_error_t apx_fileManager_processFileInfoMsg(apx_fileManager_t *self, const uint8_t *msgBuf, int32_t msgLen);
 static apx_error_t apx_fileManager_processFileOpenMsg(apx_fileManager_t *self, const uint8_t *msgBuf, int32_t msgLen);
+static apx_error_t apx_fileManager_processPingMsg(apx_fileManager_t *self, uint32_t cmdType, const uint8_t *msgBuf, int32_t msgLen);
+static apx_error_t apx_fileManager_processCompressInfoMsg(apx_fileManager_t *self, const uint8_t *msgBuf, int32_t msgLen);
+static apx_error_t apx_fileManager_prepareDecompression(apx_fileManager_t *self, uint32_t address);
 static void apx_fileManager_freeAllocatedMemory(void *arg, uint8_t *ptr, uint32_t size);
 //////////////////////////////////////////////////////////////////////////////
 // PRIVATE VARIABLES
@@ -62,6 +66,8 @@ apx_error_t apx_fileManager_create(apx_fileManager_t *self, uint8_t mode, struct
    {
       apx_error_t result;
       self->parentConnection = parentConnection;
+      self->hasPendingFileInfo = false;
+      self->numPendingDecompressions = 0u;
       apx_fileManagerReceiver_create(&self->receiver);
       result = apx_fileManagerReceiver_reserve(&self->receiver, RMF_MAX_CMD_BUF_SIZE); //reserve minimum of 1KB in the receive buffer
       if (result == APX_NO_ERROR)
@@ -133,6 +139,26 @@ apx_file_t* apx_fileManager_findRemoteFileByName(apx_fileManager_t *self, const
    return (apx_file_t*) 0;
 }
 
+/**
+ * When executor is set the worker uses the executor threads for transmit instead of its own thread.
+ * Must be called before apx_fileManager_start.
+ */
+void apx_fileManager_setExecutor(apx_fileManager_t *self, apx_executor_t *executor)
+{
+   if (self != 0)
+   {
+      apx_fileManagerWorker_setExecutor(&self->worker, executor);
+   }
+}
+
+void apx_fileManager_setFragmentSize(apx_fileManager_t *self, uint32_t fragmentSize)
+{
+   if (self != 0)
+   {
+      apx_fileManagerWorker_setFragmentSize(&self->worker, fragmentSize);
+   }
+}
+
 void apx_fileManager_setTransmitHandler(apx_fileManager_t *self, apx_transmitHandler_t *handler)
 {
    if (self != 0)
@@ -236,6 +262,14 @@ uint16_t apx_fileManager_getNumPendingWorkerMessages(apx_fileManager_t *self)
    return 0u;
 }
 
+void apx_fileManager_getWorkerStats(apx_fileManager_t *self, apx_fileManagerWorkerStats_t *stats)
+{
+   if ( (self != 0) && (stats != 0) )
+   {
+      apx_fileManagerWorker_getStats(&self->worker, stats);
+   }
+}
+
 apx_file_t *apx_fileManager_fileInfoNotify(apx_fileManager_t *self, const apx_fileInfo_t *fileInfo)
 {
    if (self != 0)
@@ -245,12 +279,16 @@ apx_file_t *apx_fileManager_fileInfoNotify(apx_fileManager_t *self, const apx_fi
       {
          apx_error_t rc;
          apx_file_setFileManager(file, self);
-         rc = apx_fileManagerReceiver_reserve(&self->receiver, fileInfo->length);
+         rc = apx_fileManagerReceiver_reserve(&self->receiver, fileInfo->uncompressedLength);
          if (rc != APX_NO_ERROR)
          {
             printf("[FILE-MANAGER] Failed to reserve memory for receive buffer, error code: %d\n", (int) rc);
             return (apx_file_t*) 0;
          }
+         if (fileInfo->fileType == RMF_FILE_TYPE_COMPRESSED_FIXED)
+         {
+            self->numPendingDecompressions++;
+         }
       }
       return file;
    }
@@ -265,31 +303,28 @@ apx_error_t apx_fileManager_messageReceived(apx_fileManager_t *self, const uint8
       int32_t result = rmf_unpackMsg(msgBuf, msgLen, &msg);
       if (result > 0)
       {
-         apx_error_t retval = apx_fileManagerReceiver_write(&self->receiver, msg.address, msg.data, msg.dataLen, msg.more_bit);
+         apx_error_t retval;
+         if (apx_fileManagerReceiver_isInterleavedWrite(&self->receiver, msg.address, msg.more_bit))
+         {
+            //Small write transmitted in between the fragments of a large write
+            return apx_fileManager_processCompleteMsg(self, msg.address, msg.data, (apx_size_t) msg.dataLen);
+         }
+         if ( (self->numPendingDecompressions > 0u) && (msg.address < RMF_CMD_START_ADDR) && (!apx_fileManagerReceiver_isOngoing(&self->receiver)) )
+         {
+            retval = apx_fileManager_prepareDecompression(self, msg.address);
+            if (retval != APX_NO_ERROR)
+            {
+               return retval;
+            }
+         }
+         retval = apx_fileManagerReceiver_write(&self->receiver, msg.address, msg.data, msg.dataLen, msg.more_bit);
          if (retval == APX_NO_ERROR)
          {
             apx_fileManagerReception_t completeMsg;
             result = apx_fileManagerReceiver_checkComplete(&self->receiver, &completeMsg);
             if (result == APX_NO_ERROR)
             {
-               if (completeMsg.startAddress == RMF_CMD_START_ADDR)
-               {
-#if APX_DEBUG_ENABLE
-                  printf("[FILE-MANAGER] APX Command: len=%u\n", (unsigned int) completeMsg.msgSize);
-#endif
-                  retval = apx_fileManager_processCmdMsg(self, completeMsg.msgBuf, completeMsg.msgSize);
-               }
-               else if (msg.address < RMF_CMD_START_ADDR)
-               {
-#if APX_DEBUG_ENABLE
-                  printf("[FILE-MANAGER] Data Write: addr=0x%08X; len=%u\n", (unsigned int) completeMsg.startAddress, (unsigned int) completeMsg.msgSize);
-#endif
-                  retval = apx_fileManager_processDataMsg(self, completeMsg.startAddress, completeMsg.msgBuf, completeMsg.msgSize);
-               }
-               else
-               {
-                  retval = APX_INVALID_ADDRESS_ERROR;
-               }
+               retval = apx_fileManager_processCompleteMsg(self, completeMsg.startAddress, completeMsg.msgBuf, completeMsg.msgSize);
             }
          }
          return retval;
@@ -362,6 +397,70 @@ apx_error_t apx_fileManager_writeDynamicData(apx_fileManager_t *self, uint32_t a
    return APX_INVALID_ARGUMENT_ERROR;
 }
 
+/**
+ * Same as apx_fileManager_writeDynamicData but data is taken from a payload shared with other connections
+ */
+apx_error_t apx_fileManager_writePayload(apx_fileManager_t *self, uint32_t address, apx_payload_t *payload, uint32_t payloadOffset, apx_size_t len)
+{
+   if ( (self != 0) && (payload != 0) && (len <= APX_MAX_FILE_SIZE) )
+   {
+      if (address >= RMF_CMD_START_ADDR)
+      {
+         return APX_INVALID_ADDRESS_ERROR;
+      }
+      return apx_fileManagerWorker_sendPayload(&self->worker, address, payload, payloadOffset, len);
+   }
+   return APX_INVALID_ARGUMENT_ERROR;
+}
+
+/**
+ * Asks the worker to transmit the dirty ranges of the file starting at address. See apx_fileManagerWorker_sendConflatedData.
+ */
+apx_error_t apx_fileManager_writeConflatedData(apx_fileManager_t *self, uint32_t address, apx_fileConflationHandler_t *handler)
+{
+   if ( (self != 0) && (handler != 0) )
+   {
+      if (address >= RMF_CMD_START_ADDR)
+      {
+         return APX_INVALID_ADDRESS_ERROR;
+      }
+      return apx_fileManagerWorker_sendConflatedData(&self->worker, address, handler);
+   }
+   return APX_INVALID_ARGUMENT_ERROR;
+}
+
+/**
+ * Asks the worker to transmit the elements waiting in the queued port at address. See apx_fileManagerWorker_sendQueuedData.
+ */
+apx_error_t apx_fileManager_writeQueuedData(apx_fileManager_t *self, uint32_t address, uint32_t maxLen, apx_fileQueueHandler_t *handler)
+{
+   if ( (self != 0) && (handler != 0) && (maxLen <= APX_MAX_FILE_SIZE) )
+   {
+      if (address >= RMF_CMD_START_ADDR)
+      {
+         return APX_INVALID_ADDRESS_ERROR;
+      }
+      return apx_fileManagerWorker_sendQueuedData(&self->worker, address, maxLen, handler);
+   }
+   return APX_INVALID_ARGUMENT_ERROR;
+}
+
+/**
+ * Sends a timestamped ping request. The response is reported through apx_connectionBase_pingResponseNotify.
+ */
+apx_error_t apx_fileManager_sendPing(apx_fileManager_t *self, uint32_t sequence)
+{
+   if (self != 0)
+   {
+      if (apx_fileManagerShared_isConnected(&self->shared) == false)
+      {
+         return APX_NOT_CONNECTED_ERROR;
+      }
+      return apx_fileManagerWorker_sendPingRequest(&self->worker, sequence);
+   }
+   return APX_INVALID_ARGUMENT_ERROR;
+}
+
 void apx_fileManager_disconnectNotify(apx_fileManager_t *self)
 {
    if (self != 0)
@@ -393,6 +492,25 @@ int32_t apx_fileManager_numPendingMessages(apx_fileManager_t *self)
 // PRIVATE FUNCTIONS
 //////////////////////////////////////////////////////////////////////////////
 
+static apx_error_t apx_fileManager_processCompleteMsg(apx_fileManager_t *self, uint32_t address, const uint8_t *msgBuf, apx_size_t msgSize)
+{
+   if (address == RMF_CMD_START_ADDR)
+   {
+#if APX_DEBUG_ENABLE
+      printf("[FILE-MANAGER] APX Command: len=%u\n", (unsigned int) msgSize);
+#endif
+      return apx_fileManager_processCmdMsg(self, msgBuf, (int32_t) msgSize);
+   }
+   else if (address < RMF_CMD_START_ADDR)
+   {
+#if APX_DEBUG_ENABLE
+      printf("[FILE-MANAGER] Data Write: addr=0x%08X; len=%u\n", (unsigned int) address, (unsigned int) msgSize);
+#endif
+      return apx_fileManager_processDataMsg(self, address, msgBuf, (int32_t) msgSize);
+   }
+   return APX_INVALID_ADDRESS_ERROR;
+}
+
 static apx_error_t apx_fileManager_processCmdMsg(apx_fileManager_t *self, const uint8_t *msgBuf, int32_t msgLen)
 {
    assert(self != 0);
@@ -413,16 +531,16 @@ static apx_error_t apx_fileManager_processCmdMsg(apx_fileManager_t *self, const
          retval = apx_fileManager_processFileOpenMsg(self, msgBuf, msgLen);
       break;
       case RMF_CMD_HEARTBEAT_RQST:
-         ///TODO: implement
+         retval = apx_fileManagerWorker_sendHeartbeatResponse(&self->worker);
          break;
       case RMF_CMD_HEARTBEAT_RSP:
-         ///TODO: implement
-         break;
-      case RMF_CMD_PING_RQST:
-         ///TODO: implement
          break;
+      case RMF_CMD_PING_RQST: //fall-through
       case RMF_CMD_PING_RSP:
-         ///TODO: implement
+         retval = apx_fileManager_processPingMsg(self, cmdType, msgBuf, msgLen);
+         break;
+      case RMF_CMD_COMPRESS_INFO:
+         retval = apx_fileManager_processCompressInfoMsg(self, msgBuf, msgLen);
          break;
 
       default:
@@ -466,6 +584,13 @@ static apx_error_t apx_fileManager_processFileInfoMsg(apx_fileManager_t *self, c
    if (result > 0)
    {
       assert(self->parentConnection != 0);
+      if (cmdFileInfo.fileType == RMF_FILE_TYPE_COMPRESSED_FIXED)
+      {
+         //The file cannot be created until we know its uncompressed length
+         memcpy(&self->pendingFileInfo, &cmdFileInfo, sizeof(rmf_fileInfo_t));
+         self->hasPendingFileInfo = true;
+         return APX_NO_ERROR;
+      }
       return apx_connectionBase_fileInfoNotify(self->parentConnection, &cmdFileInfo);
    }
    else
@@ -497,6 +622,77 @@ static apx_error_t apx_fileManager_processFileOpenMsg(apx_fileManager_t *self, c
    return APX_NO_ERROR;
 }
 
+/**
+ * Requests are echoed back to the sender. Responses carry our own timestamp and are handed to the parent connection.
+ */
+static apx_error_t apx_fileManager_processPingMsg(apx_fileManager_t *self, uint32_t cmdType, const uint8_t *msgBuf, int32_t msgLen)
+{
+   rmf_cmdPing_t cmdPing;
+   int32_t result = rmf_deserialize_cmdPing(msgBuf, msgLen, &cmdPing);
+   if (result > 0)
+   {
+      if (cmdType == RMF_CMD_PING_RQST)
+      {
+         return apx_fileManagerWorker_sendPingResponse(&self->worker, &cmdPing);
+      }
+      if (self->parentConnection != 0)
+      {
+         apx_connectionBase_pingResponseNotify(self->parentConnection, &cmdPing);
+         return APX_NO_ERROR;
+      }
+      return APX_NULL_PTR_ERROR;
+   }
+   return APX_INVALID_MSG_ERROR;
+}
+
+/**
+ * RMF_CMD_COMPRESS_INFO completes the RMF_CMD_FILE_INFO which was sent directly before it
+ */
+static apx_error_t apx_fileManager_processCompressInfoMsg(apx_fileManager_t *self, const uint8_t *msgBuf, int32_t msgLen)
+{
+   rmf_cmdCompressInfo_t cmdCompressInfo;
+   int32_t result = rmf_deserialize_cmdCompressInfo(msgBuf, msgLen, &cmdCompressInfo);
+   if (result > 0)
+   {
+      assert(self->parentConnection != 0);
+      if ( (!self->hasPendingFileInfo) || (self->pendingFileInfo.address != cmdCompressInfo.address) )
+      {
+         return APX_INVALID_MSG_ERROR;
+      }
+      self->hasPendingFileInfo = false;
+      if ( (cmdCompressInfo.compressionType == RMF_COMPRESSION_NONE) ||
+           (cmdCompressInfo.compressionType != apx_connectionBase_getCompressionType(self->parentConnection)) )
+      {
+         return APX_UNSUPPORTED_ERROR;
+      }
+      if (cmdCompressInfo.uncompressedLength > APX_MAX_FILE_SIZE)
+      {
+         return APX_FILE_TOO_LARGE_ERROR;
+      }
+      return apx_connectionBase_compressedFileInfoNotify(self->parentConnection, &self->pendingFileInfo, &cmdCompressInfo);
+   }
+   return APX_INVALID_MSG_ERROR;
+}
+
+/**
+ * Prepares the receiver for decompression when a write starts at the beginning of a compressed file
+ */
+static apx_error_t apx_fileManager_prepareDecompression(apx_fileManager_t *self, uint32_t address)
+{
+   apx_file_t *file = apx_fileManager_findFileByAddress(self, (address | RMF_REMOTE_ADDRESS_BIT) );
+   if ( (file != 0) && (apx_file_getRmfFileType(file) == RMF_FILE_TYPE_COMPRESSED_FIXED) )
+   {
+      uint32_t startAddress = apx_file_getStartAddress(file) & RMF_ADDRESS_MASK_INTERNAL;
+      if (address == startAddress)
+      {
+         const apx_fileInfo_t *fileInfo = apx_file_getFileInfo(file);
+         self->numPendingDecompressions--;
+         return apx_fileManagerReceiver_startDecompression(&self->receiver, fileInfo->uncompressedLength);
+      }
+   }
+   return APX_NO_ERROR;
+}
+
 static void apx_fileManager_freeAllocatedMemory(void *arg, uint8_t *ptr, uint32_t size)
 {
    apx_fileManager_t *self = (apx_fileManager_t*) arg;
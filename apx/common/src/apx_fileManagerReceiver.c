@@ -44,6 +44,8 @@
 //////////////////////////////////////////////////////////////////////////////
 static apx_error_t apx_fileManagerReceiver_startReception(apx_fileManagerReceiver_t *self, uint32_t address, const uint8_t *data, apx_size_t size, bool moreBit);
 static apx_error_t apx_fileManagerReceiver_continueReception(apx_fileManagerReceiver_t *self, uint32_t address, const uint8_t *data, apx_size_t size, bool moreBit);
+static uint32_t apx_fileManagerReceiver_getNextAddress(apx_fileManagerReceiver_t *self);
+static apx_error_t apx_fileManagerReceiver_decode(apx_fileManagerReceiver_t *self, const uint8_t *data, apx_size_t size, bool moreBit);
 //////////////////////////////////////////////////////////////////////////////
 // PUBLIC VARIABLES
 //////////////////////////////////////////////////////////////////////////////
@@ -65,6 +67,8 @@ void apx_fileManagerReceiver_create(apx_fileManagerReceiver_t *self)
       self->receiveBufPos = 0u;
       self->startAddress = RMF_INVALID_ADDRESS;
       self->isFragmentedWrite = false;
+      self->isCompressedWrite = false;
+      self->compressedPos = 0u;
    }
 }
 
@@ -86,6 +90,8 @@ void apx_fileManagerReceiver_reset(apx_fileManagerReceiver_t *self)
       self->startAddress = RMF_INVALID_ADDRESS;
       self->receiveBufPos = 0u;
       self->isFragmentedWrite = false;
+      self->isCompressedWrite = false;
+      self->compressedPos = 0u;
    }
 }
 
@@ -126,6 +132,49 @@ bool apx_fileManagerReceiver_isOngoing(apx_fileManagerReceiver_t *self)
    return false;
 }
 
+/**
+ * Returns true when a complete (non-fragmented) write arrives while a fragmented write is ongoing.
+ * The sender transmits such writes in between the fragments of a large write, they must be processed directly
+ * without disturbing the ongoing reception.
+ */
+bool apx_fileManagerReceiver_isInterleavedWrite(apx_fileManagerReceiver_t *self, uint32_t address, bool moreBit)
+{
+   if ( (self != 0) && (self->isFragmentedWrite) && (!moreBit) )
+   {
+      return (address != apx_fileManagerReceiver_getNextAddress(self))? true : false;
+   }
+   return false;
+}
+
+/**
+ * Makes the next write a compressed one. The data of that write (and its fragments) is decoded into the
+ * receive buffer which must be able to hold uncompressedSize bytes.
+ * Decoding happens as the fragments arrive, there is no intermediate buffer for the compressed data.
+ */
+apx_error_t apx_fileManagerReceiver_startDecompression(apx_fileManagerReceiver_t *self, apx_size_t uncompressedSize)
+{
+   if (self != 0)
+   {
+      apx_error_t result;
+      if (self->startAddress != RMF_INVALID_ADDRESS)
+      {
+         return APX_DATA_NOT_COMPLETE_ERROR; //A write is already ongoing
+      }
+      if (uncompressedSize > 0u)
+      {
+         result = apx_fileManagerReceiver_reserve(self, uncompressedSize);
+         if (result != APX_NO_ERROR)
+         {
+            return result;
+         }
+      }
+      apx_lzDecoder_create(&self->decoder, self->receiveBuf, uncompressedSize);
+      self->isCompressedWrite = true;
+      return APX_NO_ERROR;
+   }
+   return APX_INVALID_ARGUMENT_ERROR;
+}
+
 apx_error_t apx_fileManagerReceiver_write(apx_fileManagerReceiver_t *self, uint32_t address, const uint8_t *data, apx_size_t size, bool moreBit)
 {
    if ( (self != 0) && (data != 0) && (address < RMF_INVALID_ADDRESS) )
@@ -202,6 +251,11 @@ static apx_error_t apx_fileManagerReceiver_startReception(apx_fileManagerReceive
 {
    if (self != 0)
    {
+      if (self->isCompressedWrite)
+      {
+         self->startAddress = address;
+         return apx_fileManagerReceiver_decode(self, data, size, moreBit);
+      }
       if (self->receiveBufSize == 0)
       {
          return APX_MISSING_BUFFER_ERROR;
@@ -227,11 +281,15 @@ static apx_error_t apx_fileManagerReceiver_continueReception(apx_fileManagerRece
    if (self != 0)
    {
       assert(self->startAddress != RMF_INVALID_ADDRESS);
-      uint32_t expectedAddress = (self->startAddress + self->receiveBufPos);
+      uint32_t expectedAddress = apx_fileManagerReceiver_getNextAddress(self);
       if (expectedAddress != address)
       {
          return APX_INVALID_ADDRESS_ERROR; //Not the address we expected to resume writing
       }
+      if (self->isCompressedWrite)
+      {
+         return apx_fileManagerReceiver_decode(self, data, size, moreBit);
+      }
       if (self->receiveBufSize == 0)
       {
          return APX_MISSING_BUFFER_ERROR;
@@ -251,5 +309,35 @@ static apx_error_t apx_fileManagerReceiver_continueReception(apx_fileManagerRece
    return APX_INVALID_ARGUMENT_ERROR;
 }
 
+/**
+ * Address where the next fragment is expected. For compressed writes addresses refer to the compressed data.
+ */
+static uint32_t apx_fileManagerReceiver_getNextAddress(apx_fileManagerReceiver_t *self)
+{
+   if (self->isCompressedWrite)
+   {
+      return self->startAddress + self->compressedPos;
+   }
+   return self->startAddress + self->receiveBufPos;
+}
+
+static apx_error_t apx_fileManagerReceiver_decode(apx_fileManagerReceiver_t *self, const uint8_t *data, apx_size_t size, bool moreBit)
+{
+   apx_error_t result = apx_lzDecoder_write(&self->decoder, data, size);
+   if ( (result == APX_NO_ERROR) && (!moreBit) && (!apx_lzDecoder_isComplete(&self->decoder)) )
+   {
+      result = APX_DECOMPRESSION_ERROR; //Compressed data ended before the block was complete
+   }
+   if (result != APX_NO_ERROR)
+   {
+      apx_fileManagerReceiver_reset(self);
+      return result;
+   }
+   self->compressedPos += size;
+   self->receiveBufPos = apx_lzDecoder_getSize(&self->decoder);
+   self->isFragmentedWrite = moreBit;
+   return APX_NO_ERROR;
+}
+
 
 
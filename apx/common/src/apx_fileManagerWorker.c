@@ -28,14 +28,20 @@
 //////////////////////////////////////////////////////////////////////////////
 #include <assert.h>
 #include <string.h>
+#include <stdlib.h>
 #ifdef _WIN32
 #include <process.h>
+#else
+#include <time.h>
+#include <unistd.h> //needed for SLEEP macro
 #endif
 #include "apx_types.h"
 //BEGIN TEMPORARY INCLUDES
 #include <stdio.h>
 //END TEMPORARY INCLUDES
 #include "apx_fileManagerWorker.h"
+#include "numheader.h"
+#include "apx_latencyStats.h"
 #ifdef MEM_LEAK_CHECK
 #include "CMemLeak.h"
 #endif
@@ -60,14 +66,39 @@ static apx_error_t apx_fileManagerWorker_starThread(apx_fileManagerWorker_t *sel
 
 static void apx_fileManagerWorker_stopThread(apx_fileManagerWorker_t *self);
 static THREAD_PROTO(workerThread,arg);
+static bool workerThread_drainMessages(apx_fileManagerWorker_t *self);
+static uint32_t workerThread_getTimeMs(void);
 #endif
+static apx_error_t apx_fileManagerWorker_postMessage(apx_fileManagerWorker_t *self, const apx_msg_t *msg);
+static bool workerThread_runExecutorTask(void *arg);
 static bool workerThread_processMessage(apx_fileManagerWorker_t *self, apx_msg_t *msg);
+static bool workerThread_isBatchEnabled(apx_fileManagerWorker_t *self);
+static uint8_t *workerThread_getMsgBuffer(apx_fileManagerWorker_t *self, int32_t msgLen);
+static int32_t workerThread_sendMsg(apx_fileManagerWorker_t *self, int32_t msgLen);
+static apx_error_t workerThread_flushBatch(apx_fileManagerWorker_t *self);
 static void workerThread_sendFileInfo(apx_fileManagerWorker_t *self, apx_msg_t *msg);
+static void workerThread_sendCompressInfo(apx_fileManagerWorker_t *self, const apx_fileInfo_t *fileInfo);
 static void workerThread_sendFileOpen(apx_fileManagerWorker_t *self, apx_msg_t *msg);
 static void workerThread_sendAcknowledge(apx_fileManagerWorker_t *self);
+static void workerThread_sendPing(apx_fileManagerWorker_t *self, apx_msg_t *msg);
+static void workerThread_sendHeartbeatResponse(apx_fileManagerWorker_t *self);
 static apx_error_t workerThread_sendFileConstData(apx_fileManagerWorker_t *self, apx_msg_t *msg);
 static apx_error_t workerThread_sendFileDynData(apx_fileManagerWorker_t *self, apx_msg_t *msg);
-static apx_error_t apx_fileManagerWorker_processRingBufErrorCode(adt_buf_err_t errorCode);
+static apx_error_t workerThread_sendFilePayload(apx_fileManagerWorker_t *self, apx_msg_t *msg);
+static apx_error_t workerThread_sendFileConflatedData(apx_fileManagerWorker_t *self, apx_msg_t *msg);
+static void workerThread_restoreConflatedRanges(apx_fileManagerWorker_t *self, apx_fileConflationHandler_t *handler, apx_file_t *file, uint32_t firstUnsent);
+static apx_error_t workerThread_sendFileQueuedData(apx_fileManagerWorker_t *self, apx_msg_t *msg);
+static bool workerThread_isGatherEnabled(apx_fileManagerWorker_t *self);
+static apx_error_t workerThread_sendGather(apx_fileManagerWorker_t *self, uint32_t address, const uint8_t *data, uint32_t dataSize, bool moreBit);
+static void workerThread_releaseMessage(apx_msg_t *msg);
+static bool workerThread_isBulkMessage(apx_fileManagerWorker_t *self, const apx_msg_t *msg);
+static bool workerThread_getWriteRange(apx_fileManagerWorker_t *self, const apx_msg_t *msg, uint32_t *beginAddress, uint32_t *endAddress);
+static void workerThread_queueBulkTransfer(apx_fileManagerWorker_t *self, const apx_msg_t *msg);
+static void workerThread_completeOverlappingBulkTransfers(apx_fileManagerWorker_t *self, const apx_msg_t *msg);
+static void workerThread_completeBulkTransfer(apx_fileManagerWorker_t *self);
+static apx_error_t workerThread_sendBulkFragment(apx_fileManagerWorker_t *self);
+static apx_error_t workerThread_sendFragment(apx_fileManagerWorker_t *self, const apx_msg_t *msg, uint32_t pos, uint32_t dataSize, bool moreBit);
+static void workerThread_releaseBulkTransfer(apx_fileManagerWorker_t *self);
 
 //////////////////////////////////////////////////////////////////////////////
 // PRIVATE VARIABLES
@@ -80,20 +111,16 @@ apx_error_t apx_fileManagerWorker_create(apx_fileManagerWorker_t *self, apx_file
 {
    if (self != 0)
    {
-      adt_buf_err_t bufResult;
-
-      bufResult = adt_rbfh_create(&self->messages, (uint8_t) RMF_MSG_SIZE);
-
-      if (bufResult != BUF_E_OK)
+      apx_error_t result = apx_mpscQueue_create(&self->messages, (uint32_t) RMF_MSG_SIZE, APX_MAX_NUM_MESSAGES);
+      if (result != APX_NO_ERROR)
       {
-         return APX_MEM_ERROR;
+         return result;
       }
 
       self->mode = mode;
       self->shared = shared;
       MUTEX_INIT(self->mutex);
       SPINLOCK_INIT(self->lock);
-      SEMAPHORE_CREATE(self->semaphore);
 #ifdef _WIN32
       self->workerThread = INVALID_HANDLE_VALUE;
 #else
@@ -101,6 +128,32 @@ apx_error_t apx_fileManagerWorker_create(apx_fileManagerWorker_t *self, apx_file
 #endif
       self->workerThreadValid=false;
       self->numHeaderSize = 0u;
+      self->batchBuf = (uint8_t*) 0;
+      self->batchBufSize = 0;
+      self->batchLen = 0;
+      self->batchNumMessages = 0u;
+      self->isBatchMsgPending = false;
+      memset(&self->stats, 0, sizeof(apx_fileManagerWorkerStats_t));
+      self->executor = (apx_executor_t*) 0;
+      apx_executorTask_create(&self->executorTask, workerThread_runExecutorTask, (void*) self);
+      apx_byteRangeSet_create(&self->conflatedRanges, 0u);
+      self->fragmentSize = 0u;
+      self->bulkHead = 0u;
+      self->numBulkTransfers = 0u;
+      self->bulkPos = 0u;
+      if (APX_WORKER_MAX_BATCH_SIZE > 0)
+      {
+         self->batchBuf = (uint8_t*) malloc(APX_WORKER_MAX_BATCH_SIZE);
+         if (self->batchBuf == 0)
+         {
+            MUTEX_DESTROY(self->mutex);
+            SPINLOCK_DESTROY(self->lock);
+            apx_mpscQueue_destroy(&self->messages);
+            apx_byteRangeSet_destroy(&self->conflatedRanges);
+            return APX_MEM_ERROR;
+         }
+         self->batchBufSize = (int32_t) APX_WORKER_MAX_BATCH_SIZE;
+      }
 
       apx_fileManagerWorker_setTransmitHandler(self, 0);
       return APX_NO_ERROR;
@@ -116,10 +169,23 @@ void apx_fileManagerWorker_destroy(apx_fileManagerWorker_t *self)
       {
          //apx_fileManagerWorker_stop(self);
       }
+      apx_msg_t msg;
+      while (apx_mpscQueue_pop(&self->messages, (void*) &msg))
+      {
+         workerThread_releaseMessage(&msg);
+      }
+      while (self->numBulkTransfers > 0u)
+      {
+         workerThread_releaseBulkTransfer(self);
+      }
       MUTEX_DESTROY(self->mutex);
       SPINLOCK_DESTROY(self->lock);
-      SEMAPHORE_DESTROY(self->semaphore);
-      adt_rbfh_destroy(&self->messages);
+      apx_mpscQueue_destroy(&self->messages);
+      apx_byteRangeSet_destroy(&self->conflatedRanges);
+      if (self->batchBuf != 0)
+      {
+         free(self->batchBuf);
+      }
    }
 }
 
@@ -127,6 +193,15 @@ apx_error_t apx_fileManagerWorker_start(apx_fileManagerWorker_t *self)
 {
    if (self != 0)
    {
+      if (self->executor != 0)
+      {
+         apx_executorTask_create(&self->executorTask, workerThread_runExecutorTask, (void*) self);
+         if (apx_fileManagerWorker_getNumPendingMessages(self) > 0u)
+         {
+            apx_executor_schedule(self->executor, &self->executorTask);
+         }
+         return APX_NO_ERROR;
+      }
 #ifndef UNIT_TEST
       return apx_fileManagerWorker_starThread(self);
 #else
@@ -140,6 +215,11 @@ void apx_fileManagerWorker_stop(apx_fileManagerWorker_t *self)
 {
    if (self != 0)
    {
+      if (self->executor != 0)
+      {
+         apx_executor_cancel(self->executor, &self->executorTask);
+         return;
+      }
 #ifndef UNIT_TEST
       apx_fileManagerWorker_stopThread(self);
 #endif
@@ -185,17 +265,48 @@ void apx_fileManagerWorker_setNumHeaderSize(apx_fileManagerWorker_t *self, uint8
    }
 }
 
+/**
+ * Lets the threads of executor transmit messages instead of starting a dedicated transmit thread.
+ * Must be called before apx_fileManagerWorker_start.
+ */
+void apx_fileManagerWorker_setExecutor(apx_fileManagerWorker_t *self, apx_executor_t *executor)
+{
+   if (self != 0)
+   {
+      self->executor = executor;
+   }
+}
+
+/**
+ * Writes larger than fragmentSize are transmitted in fragments, interleaved with other messages. 0 disables fragmentation.
+ * Only enable this when the peer has announced Fragment-Interleave in its greeting, older receivers are unable to
+ * handle complete writes arriving in between fragments. Must be called before any file data is sent.
+ */
+void apx_fileManagerWorker_setFragmentSize(apx_fileManagerWorker_t *self, uint32_t fragmentSize)
+{
+   if (self != 0)
+   {
+      self->fragmentSize = fragmentSize;
+   }
+}
+
 uint16_t apx_fileManagerWorker_getNumPendingMessages(apx_fileManagerWorker_t *self)
 {
    if (self != 0)
    {
-      uint16_t retval;
+      return (uint16_t) apx_mpscQueue_length(&self->messages);
+   }
+   return 0u;
+}
+
+void apx_fileManagerWorker_getStats(apx_fileManagerWorker_t *self, apx_fileManagerWorkerStats_t *stats)
+{
+   if ( (self != 0) && (stats != 0) )
+   {
       SPINLOCK_ENTER(self->lock);
-      retval = adt_rbfh_length(&self->messages);
+      memcpy(stats, &self->stats, sizeof(apx_fileManagerWorkerStats_t));
       SPINLOCK_LEAVE(self->lock);
-      return retval;
    }
-   return 0u;
 }
 
 //Message API
@@ -209,12 +320,7 @@ void apx_fileManagerWorker_sendFileInfoMsg(apx_fileManagerWorker_t *self, apx_fi
    {
       apx_msg_t msg = {APX_MSG_SEND_FILEINFO, 0, 0, {0}, 0};
       msg.msgData3.ptr = (void*) fileInfo;
-      SPINLOCK_ENTER(self->lock);
-      adt_rbfh_insert(&self->messages, (const uint8_t*) &msg);
-      SPINLOCK_LEAVE(self->lock);
-   #ifndef UNIT_TEST
-      SEMAPHORE_POST(self->semaphore);
-   #endif
+      (void) apx_fileManagerWorker_postMessage(self, &msg);
    }
 }
 
@@ -224,12 +330,7 @@ void apx_fileManagerWorker_sendFileOpenMsg(apx_fileManagerWorker_t *self, uint32
    {
       apx_msg_t msg = {APX_MSG_SEND_FILE_OPEN, 0, 0, {0}, 0};
       msg.msgData1 = address;
-      SPINLOCK_ENTER(self->lock);
-      adt_rbfh_insert(&self->messages, (const uint8_t*) &msg);
-      SPINLOCK_LEAVE(self->lock);
-   #ifndef UNIT_TEST
-      SEMAPHORE_POST(self->semaphore);
-   #endif
+      (void) apx_fileManagerWorker_postMessage(self, &msg);
    }
 }
 
@@ -242,13 +343,7 @@ apx_error_t apx_fileManagerWorker_sendConstData(apx_fileManagerWorker_t *self, u
       msg.msgData2 = len;
       msg.msgData3.ptr = readFunc;
       msg.msgData4 = arg;
-      SPINLOCK_ENTER(self->lock);
-      adt_rbfh_insert(&self->messages, (const uint8_t*) &msg);
-      SPINLOCK_LEAVE(self->lock);
-   #ifndef UNIT_TEST
-      SEMAPHORE_POST(self->semaphore);
-   #endif
-      return APX_NO_ERROR;
+      return apx_fileManagerWorker_postMessage(self, &msg);
    }
    return APX_INVALID_ARGUMENT_ERROR;
 }
@@ -257,25 +352,72 @@ apx_error_t apx_fileManagerWorker_sendDynamicData(apx_fileManagerWorker_t *self,
 {
    if ( (self != 0) && (data != 0) )
    {
-      adt_buf_err_t result;
       apx_msg_t msg = {APX_MSG_SEND_FILE_DYN_DATA, 0, 0, {0}, 0};
       msg.msgData1 = address;
       msg.msgData2 = len;
       msg.msgData3.ptr = data;
-      SPINLOCK_ENTER(self->lock);
-      result = adt_rbfh_insert(&self->messages, (const uint8_t*) &msg);
-      SPINLOCK_LEAVE(self->lock);
-      if (result == BUF_E_OK)
-      {
-#ifndef UNIT_TEST
-         SEMAPHORE_POST(self->semaphore);
-#endif
-      }
-      else
+      return apx_fileManagerWorker_postMessage(self, &msg);
+   }
+   return APX_INVALID_ARGUMENT_ERROR;
+}
+
+/**
+ * Sends len bytes starting at payloadOffset inside payload. The worker takes its own reference to payload,
+ * the caller keeps (and eventually releases) the reference it already holds.
+ */
+apx_error_t apx_fileManagerWorker_sendPayload(apx_fileManagerWorker_t *self, uint32_t address, apx_payload_t *payload, uint32_t payloadOffset, uint32_t len)
+{
+   if ( (self != 0) && (payload != 0) && (payloadOffset + len <= apx_payload_getDataLen(payload)) )
+   {
+      apx_error_t result;
+      apx_msg_t msg = {APX_MSG_SEND_FILE_PAYLOAD, 0, 0, {0}, 0};
+      msg.msgData1 = address;
+      msg.msgData2 = len;
+      msg.msgData3.ptr = (void*) payload;
+      msg.msgData4 = (void*) (apx_payload_getData(payload) + payloadOffset);
+      apx_payload_retain(payload);
+      result = apx_fileManagerWorker_postMessage(self, &msg);
+      if (result != APX_NO_ERROR)
       {
-         return apx_fileManagerWorker_processRingBufErrorCode(result);
+         apx_payload_release(payload);
       }
-      return APX_NO_ERROR;
+      return result;
+   }
+   return APX_INVALID_ARGUMENT_ERROR;
+}
+
+/**
+ * Requests transmission of everything the file owner has marked as dirty in the file starting at address.
+ * The data is read from the file when the message is processed, writes made before that are conflated into a single transfer.
+ * handler must stay valid until the message has been processed.
+ */
+apx_error_t apx_fileManagerWorker_sendConflatedData(apx_fileManagerWorker_t *self, uint32_t address, apx_fileConflationHandler_t *handler)
+{
+   if ( (self != 0) && (handler != 0) && (handler->takeDirtyRanges != 0) && (handler->readData != 0) )
+   {
+      apx_msg_t msg = {APX_MSG_SEND_FILE_CONFLATED_DATA, 0, 0, {0}, 0};
+      msg.msgData1 = address;
+      msg.msgData3.ptr = (void*) handler;
+      return apx_fileManagerWorker_postMessage(self, &msg);
+   }
+   return APX_INVALID_ARGUMENT_ERROR;
+}
+
+/**
+ * Requests transmission of the elements waiting in a queued port. address is the address of the port itself,
+ * maxLen the size of the port (count header plus all element slots).
+ * The elements are taken from the port when the message is processed, all elements queued up to that point go out in a single write.
+ * handler must stay valid until the message has been processed.
+ */
+apx_error_t apx_fileManagerWorker_sendQueuedData(apx_fileManagerWorker_t *self, uint32_t address, uint32_t maxLen, apx_fileQueueHandler_t *handler)
+{
+   if ( (self != 0) && (handler != 0) && (handler->beginTransfer != 0) && (handler->readData != 0) )
+   {
+      apx_msg_t msg = {APX_MSG_SEND_FILE_QUEUED_DATA, 0, 0, {0}, 0};
+      msg.msgData1 = address;
+      msg.msgData2 = maxLen;
+      msg.msgData3.ptr = (void*) handler;
+      return apx_fileManagerWorker_postMessage(self, &msg);
    }
    return APX_INVALID_ARGUMENT_ERROR;
 }
@@ -284,22 +426,44 @@ apx_error_t apx_fileManagerWorker_sendHeaderAckMsg(apx_fileManagerWorker_t *self
 {
    if ( (self != 0) )
    {
-      adt_buf_err_t result;
       apx_msg_t msg = {APX_MSG_SEND_ACKNOWLEDGE, 0, 0, {0}, 0};
-      SPINLOCK_ENTER(self->lock);
-      result = adt_rbfh_insert(&self->messages, (const uint8_t*) &msg);
-      SPINLOCK_LEAVE(self->lock);
-      if (result == BUF_E_OK)
-      {
-#ifndef UNIT_TEST
-         SEMAPHORE_POST(self->semaphore);
-#endif
-      }
-      else
-      {
-         return apx_fileManagerWorker_processRingBufErrorCode(result);
-      }
-      return APX_NO_ERROR;
+      return apx_fileManagerWorker_postMessage(self, &msg);
+   }
+   return APX_INVALID_ARGUMENT_ERROR;
+}
+
+/**
+ * The request is timestamped when it is serialized, not when it is queued, so queueing delay in front of the worker is not counted as network latency.
+ */
+apx_error_t apx_fileManagerWorker_sendPingRequest(apx_fileManagerWorker_t *self, uint32_t sequence)
+{
+   if ( (self != 0) )
+   {
+      apx_msg_t msg = {APX_MSG_SEND_PING_REQUEST, 0, 0, {0}, 0};
+      msg.msgData1 = sequence;
+      return apx_fileManagerWorker_postMessage(self, &msg);
+   }
+   return APX_INVALID_ARGUMENT_ERROR;
+}
+
+apx_error_t apx_fileManagerWorker_sendPingResponse(apx_fileManagerWorker_t *self, const rmf_cmdPing_t *request)
+{
+   if ( (self != 0) && (request != 0) )
+   {
+      apx_msg_t msg = {APX_MSG_SEND_PING_RESPONSE, 0, 0, {0}, 0};
+      msg.msgData1 = request->sequence;
+      memcpy(&msg.msgData3.data[0], &request->timestamp, sizeof(uint64_t));
+      return apx_fileManagerWorker_postMessage(self, &msg);
+   }
+   return APX_INVALID_ARGUMENT_ERROR;
+}
+
+apx_error_t apx_fileManagerWorker_sendHeartbeatResponse(apx_fileManagerWorker_t *self)
+{
+   if ( (self != 0) )
+   {
+      apx_msg_t msg = {APX_MSG_SEND_HEARTBEAT_RESPONSE, 0, 0, {0}, 0};
+      return apx_fileManagerWorker_postMessage(self, &msg);
    }
    return APX_INVALID_ARGUMENT_ERROR;
 }
@@ -312,11 +476,30 @@ bool apx_fileManagerWorker_run(apx_fileManagerWorker_t *self)
 {
    if (self != 0)
    {
-      while (adt_rbfh_length(&self->messages) > 0)
+      apx_msg_t msg;
+      if (apx_mpscQueue_pop(&self->messages, (void*) &msg))
       {
-         apx_msg_t msg;
-         adt_rbfh_remove(&self->messages,(uint8_t*) &msg);
-         return workerThread_processMessage(self, &msg);
+         bool retval;
+         retval = workerThread_processMessage(self, &msg);
+         if (workerThread_isBatchEnabled(self))
+         {
+            while ( (retval == true) && (apx_mpscQueue_pop(&self->messages, (void*) &msg)) )
+            {
+               retval = workerThread_processMessage(self, &msg);
+            }
+         }
+         if ( (retval == true) && (self->numBulkTransfers > 0u) )
+         {
+            (void) workerThread_sendBulkFragment(self);
+         }
+         (void) workerThread_flushBatch(self);
+         return retval;
+      }
+      else if (self->numBulkTransfers > 0u)
+      {
+         (void) workerThread_sendBulkFragment(self);
+         (void) workerThread_flushBatch(self);
+         return true;
       }
    }
    return false;
@@ -326,10 +509,19 @@ int32_t apx_fileManagerWorker_numPendingMessages(apx_fileManagerWorker_t *self)
 {
    if (self != 0)
    {
-      return (int32_t) adt_rbfh_length(&self->messages);
+      return (int32_t) apx_mpscQueue_length(&self->messages);
    }
    return -1;
 }
+
+uint32_t apx_fileManagerWorker_numBulkTransfers(apx_fileManagerWorker_t *self)
+{
+   if (self != 0)
+   {
+      return self->numBulkTransfers;
+   }
+   return 0u;
+}
 #endif
 
 
@@ -408,10 +600,10 @@ static void apx_fileManagerWorker_stopThread(apx_fileManagerWorker_t *self)
          DWORD result;
    #endif
          apx_msg_t msg = {APX_MSG_EXIT,0,0,{0}}; //{msgType, sender, msgData1, msgData2, msgData3}
-         SPINLOCK_ENTER(self->lock);
-         adt_rbfh_insert(&self->messages,(const uint8_t*) &msg);
-         SPINLOCK_LEAVE(self->lock);
-         SEMAPHORE_POST(self->semaphore);
+         while (apx_mpscQueue_push(&self->messages, (const void*) &msg) == APX_BUFFER_FULL_ERROR)
+         {
+            SLEEP(1); //queue is full, give workerThread a chance to catch up
+         }
    #ifdef _MSC_VER
          result = WaitForSingleObject(self->workerThread, 5000);
          if (result == WAIT_TIMEOUT)
@@ -457,37 +649,138 @@ static THREAD_PROTO(workerThread,arg)
 
       while(isRunning == true)
       {
-         //printf("[%u] Waiting for semaphore\n", fmid);
-#ifdef _MSC_VER
-         DWORD result = WaitForSingleObject(self->semaphore, INFINITE);
-         if (result == WAIT_OBJECT_0)
-#else
-
-         int result = sem_wait(&self->semaphore);
-         if (result == 0)
-#endif
+         bool hasMessage = apx_mpscQueue_pop(&self->messages, (void*) &msg);
+         if (hasMessage)
          {
-            //printf("[%u] Semaphore wait success\n", fmid);
-            SPINLOCK_ENTER(self->lock);
-            adt_rbfh_remove(&self->messages,(uint8_t*) &msg);
-            SPINLOCK_LEAVE(self->lock);
             if (!workerThread_processMessage(self, &msg))
             {
                isRunning = false;
             }
+            else if (workerThread_isBatchEnabled(self))
+            {
+               //Collect whatever else is queued into the same batch before transmitting
+               isRunning = workerThread_drainMessages(self);
+            }
             messages_processed++;
          }
-         else
+         //Everything that was queued went out first, bulk transfers only get one fragment per round
+         if ( (isRunning == true) && (self->numBulkTransfers > 0u) )
          {
-            printf("Failed to wait for semaphore\n");
+            (void) workerThread_sendBulkFragment(self);
          }
+         else if (hasMessage == false)
+         {
+            apx_mpscQueue_wait(&self->messages, APX_MPSC_QUEUE_WAIT_INFINITE);
+         }
+         (void) workerThread_flushBatch(self);
       }
       //printf("[%u]: messages_processed: %u\n",fmid, messages_processed);
    }
    THREAD_RETURN(0);
 }
+
+/**
+ * Processes messages already waiting in the queue without blocking.
+ * When APX_WORKER_BATCH_DEADLINE_MS is non-zero the worker waits up to that long for more messages while a batch is partially filled.
+ * Returns false when the exit message was processed.
+ */
+static bool workerThread_drainMessages(apx_fileManagerWorker_t *self)
+{
+   uint32_t batchStartTime = 0u;
+   if (APX_WORKER_BATCH_DEADLINE_MS > 0)
+   {
+      batchStartTime = workerThread_getTimeMs();
+   }
+   for(;;)
+   {
+      apx_msg_t msg;
+      uint32_t timeoutMs = 0u;
+      if ( (APX_WORKER_BATCH_DEADLINE_MS > 0) && (self->batchLen > 0) )
+      {
+         uint32_t elapsed = workerThread_getTimeMs() - batchStartTime;
+         if (elapsed < (uint32_t) APX_WORKER_BATCH_DEADLINE_MS)
+         {
+            timeoutMs = (uint32_t) APX_WORKER_BATCH_DEADLINE_MS - elapsed;
+         }
+      }
+      if (apx_mpscQueue_pop(&self->messages, (void*) &msg) == false)
+      {
+         if (timeoutMs == 0u)
+         {
+            break;
+         }
+         apx_mpscQueue_wait(&self->messages, timeoutMs);
+         continue;
+      }
+      if (self->batchLen == 0)
+      {
+         //previous batch was transmitted while serializing, restart the deadline
+         batchStartTime = (APX_WORKER_BATCH_DEADLINE_MS > 0)? workerThread_getTimeMs() : 0u;
+      }
+      if (!workerThread_processMessage(self, &msg))
+      {
+         return false;
+      }
+   }
+   return true;
+}
+
+static uint32_t workerThread_getTimeMs(void)
+{
+#ifdef _MSC_VER
+   return (uint32_t) GetTickCount();
+#else
+   struct timespec ts;
+   clock_gettime(CLOCK_MONOTONIC, &ts);
+   return (uint32_t) ( ( (uint64_t) ts.tv_sec * 1000u) + ( (uint64_t) ts.tv_nsec / 1000000u) );
+#endif
+}
 #endif //UNIT_TEST
 
+/**
+ * Appends msg to the message queue. workerThread is woken up by the queue itself, executor tasks need to be scheduled.
+ */
+static apx_error_t apx_fileManagerWorker_postMessage(apx_fileManagerWorker_t *self, const apx_msg_t *msg)
+{
+   apx_error_t result = apx_mpscQueue_push(&self->messages, (const void*) msg);
+   if ( (result == APX_NO_ERROR) && (self->executor != 0) )
+   {
+      apx_executor_schedule(self->executor, &self->executorTask);
+   }
+   return result;
+}
+
+/**
+ * Executor task. Transmits at most APX_EXECUTOR_MAX_WORK_PER_TASK messages (as one batch when possible) before yielding.
+ */
+static bool workerThread_runExecutorTask(void *arg)
+{
+   apx_fileManagerWorker_t *self = (apx_fileManagerWorker_t*) arg;
+   if (self != 0)
+   {
+      int32_t numProcessed = 0;
+      bool hasMoreMessages;
+      while (numProcessed < APX_EXECUTOR_MAX_WORK_PER_TASK)
+      {
+         apx_msg_t msg;
+         if (apx_mpscQueue_pop(&self->messages, (void*) &msg) == false)
+         {
+            break;
+         }
+         (void) workerThread_processMessage(self, &msg);
+         numProcessed++;
+      }
+      if (self->numBulkTransfers > 0u)
+      {
+         (void) workerThread_sendBulkFragment(self);
+      }
+      (void) workerThread_flushBatch(self);
+      hasMoreMessages = ( (apx_mpscQueue_length(&self->messages) > 0u) || (self->numBulkTransfers > 0u) )? true : false;
+      return hasMoreMessages;
+   }
+   return false;
+}
+
 static bool workerThread_processMessage(apx_fileManagerWorker_t *self, apx_msg_t *msg)
 {
    bool retval = true;
@@ -495,6 +788,15 @@ static bool workerThread_processMessage(apx_fileManagerWorker_t *self, apx_msg_t
    if (self->transmitHandler.send != 0)
    {
       apx_error_t rc;
+      if (workerThread_isBulkMessage(self, msg))
+      {
+         workerThread_queueBulkTransfer(self, msg);
+         return true;
+      }
+      if (self->numBulkTransfers > 0u)
+      {
+         workerThread_completeOverlappingBulkTransfers(self, msg);
+      }
       switch(msg->msgType)
       {
       case APX_MSG_EXIT:
@@ -525,15 +827,47 @@ static bool workerThread_processMessage(apx_fileManagerWorker_t *self, apx_msg_t
             printf("[WORKER] workerThread_sendFileDyntData failed with error: %d\n", (int) rc);
          }
          break;
+      case APX_MSG_SEND_FILE_PAYLOAD:
+         rc = workerThread_sendFilePayload(self, msg);
+         if (rc != APX_NO_ERROR)
+         {
+            printf("[WORKER] workerThread_sendFilePayload failed with error: %d\n", (int) rc);
+         }
+         break;
+      case APX_MSG_SEND_FILE_CONFLATED_DATA:
+         rc = workerThread_sendFileConflatedData(self, msg);
+         if (rc != APX_NO_ERROR)
+         {
+            printf("[WORKER] workerThread_sendFileConflatedData failed with error: %d\n", (int) rc);
+         }
+         break;
+      case APX_MSG_SEND_FILE_QUEUED_DATA:
+         rc = workerThread_sendFileQueuedData(self, msg);
+         if (rc != APX_NO_ERROR)
+         {
+            printf("[WORKER] workerThread_sendFileQueuedData failed with error: %d\n", (int) rc);
+         }
+         break;
       case APX_MSG_SEND_FILE_DATA_DIRECT:
          break;
       case APX_MSG_SEND_ERROR_CODE:
          break;
+      case APX_MSG_SEND_PING_REQUEST: //fall-through
+      case APX_MSG_SEND_PING_RESPONSE:
+         workerThread_sendPing(self, msg);
+         break;
+      case APX_MSG_SEND_HEARTBEAT_RESPONSE:
+         workerThread_sendHeartbeatResponse(self);
+         break;
       default:
          printf("[APX_FILE_MANAGER_WORKER(%u)]: Unknown message type: %u\n", connectionId, msg->msgType);
          assert(0);
       }
    }
+   else
+   {
+      workerThread_releaseMessage(msg);
+   }
    return retval;
 }
 
@@ -548,19 +882,48 @@ static void workerThread_sendFileInfo(apx_fileManagerWorker_t *self, apx_msg_t *
    assert(self->transmitHandler.send != 0);
    if (apx_fileManagerShared_isConnected(self->shared) )
    {
-      msgBuf = self->transmitHandler.getSendBuffer(self->transmitHandler.arg, msgSize);
+      msgBuf = workerThread_getMsgBuffer(self, msgSize);
       if (msgBuf != 0)
       {
          int32_t result = apx_fileManagerWorker_serializeFileInfo(msgBuf, msgSize, fileInfo);
          if (result > 0)
          {
-            self->transmitHandler.send(self->transmitHandler.arg, 0, result);
+            workerThread_sendMsg(self, result);
+            if (fileInfo->fileType == RMF_FILE_TYPE_COMPRESSED_FIXED)
+            {
+               workerThread_sendCompressInfo(self, fileInfo);
+            }
          }
       }
    }
    apx_fileInfo_delete(fileInfo);
 }
 
+/**
+ * RMF_CMD_COMPRESS_INFO must immediately follow the RMF_CMD_FILE_INFO of a compressed file
+ */
+static void workerThread_sendCompressInfo(apx_fileManagerWorker_t *self, const apx_fileInfo_t *fileInfo)
+{
+   const int32_t msgSize = RMF_CMD_ADDRESS_LEN+RMF_CMD_FILE_COMPRESS_INFO_LEN;
+   uint8_t *msgBuf = workerThread_getMsgBuffer(self, msgSize);
+   if (msgBuf != 0)
+   {
+      int32_t result = rmf_packHeader(msgBuf, msgSize, RMF_CMD_START_ADDR, false);
+      if (result == RMF_CMD_ADDRESS_LEN)
+      {
+         rmf_cmdCompressInfo_t cmd;
+         msgBuf+=RMF_CMD_ADDRESS_LEN;
+         apx_fileInfo_fillRmfCompressInfo(fileInfo, &cmd);
+         cmd.address &= RMF_ADDRESS_MASK_INTERNAL;
+         result = rmf_serialize_cmdCompressInfo(msgBuf, RMF_CMD_FILE_COMPRESS_INFO_LEN, &cmd);
+         if (result == RMF_CMD_FILE_COMPRESS_INFO_LEN)
+         {
+            workerThread_sendMsg(self, msgSize);
+         }
+      }
+   }
+}
+
 static void workerThread_sendFileOpen(apx_fileManagerWorker_t *self, apx_msg_t *msg)
 {
    const int32_t msgSize = RMF_CMD_ADDRESS_LEN+RMF_CMD_FILE_OPEN_LEN;
@@ -575,7 +938,7 @@ static void workerThread_sendFileOpen(apx_fileManagerWorker_t *self, apx_msg_t *
       assert(self->transmitHandler.send != 0);
       if (apx_fileManagerShared_isConnected(self->shared) )
       {
-         msgBuf = self->transmitHandler.getSendBuffer(self->transmitHandler.arg, msgSize);
+         msgBuf = workerThread_getMsgBuffer(self, msgSize);
          if (msgBuf != 0)
          {
             int32_t result = rmf_packHeader(msgBuf, msgSize, RMF_CMD_START_ADDR, false);
@@ -587,7 +950,7 @@ static void workerThread_sendFileOpen(apx_fileManagerWorker_t *self, apx_msg_t *
                result = rmf_serialize_cmdOpenFile(msgBuf, RMF_CMD_FILE_OPEN_LEN, &cmd);
                if (result == RMF_CMD_FILE_OPEN_LEN)
                {
-                  self->transmitHandler.send(self->transmitHandler.arg, 0, msgSize);
+                  workerThread_sendMsg(self, msgSize);
                }
             }
          }
@@ -629,7 +992,7 @@ static apx_error_t workerThread_sendFileConstData(apx_fileManagerWorker_t *self,
       msgSize = headerSize + dataSize;
       if (apx_fileManagerShared_isConnected(self->shared) )
       {
-         msgBuf = self->transmitHandler.getSendBuffer(self->transmitHandler.arg, msgSize);
+         msgBuf = workerThread_getMsgBuffer(self, msgSize);
          if (msgBuf != 0)
          {
             int32_t result = rmf_packHeader(msgBuf, msgSize, address, false);
@@ -639,7 +1002,7 @@ static apx_error_t workerThread_sendFileConstData(apx_fileManagerWorker_t *self,
                apx_error_t rc = readFunc(arg, file, offset, &msgBuf[headerSize], dataSize);
                if (rc == APX_NO_ERROR)
                {
-                  result = self->transmitHandler.send(self->transmitHandler.arg, 0, msgSize);
+                  result = workerThread_sendMsg(self, msgSize);
    #if APX_DEBUG_ENABLE
                   printf("[WORKER] Bytes transmitted: %d\n", result);
    #endif
@@ -679,7 +1042,7 @@ static apx_error_t workerThread_sendFileDynData(apx_fileManagerWorker_t *self, a
       assert(self->shared != 0);
       if (apx_fileManagerShared_isConnected(self->shared) )
       {
-         msgBuf = self->transmitHandler.getSendBuffer(self->transmitHandler.arg, msgSize);
+         msgBuf = workerThread_getMsgBuffer(self, msgSize);
          if (msgBuf != 0)
          {
             int32_t result = rmf_packHeader(msgBuf, msgSize, address, false);
@@ -688,7 +1051,7 @@ static apx_error_t workerThread_sendFileDynData(apx_fileManagerWorker_t *self, a
                memcpy(&msgBuf[headerSize], dataPtr, dataSize);
                assert(self->shared != 0);
                apx_fileManagerShared_freeAllocatedMemory(self->shared, dataPtr, dataSize);
-               result = self->transmitHandler.send(self->transmitHandler.arg, 0, msgSize);
+               result = workerThread_sendMsg(self, msgSize);
    #if APX_DEBUG_ENABLE
 //               printf("[WORKER] Bytes transmitted: %d/%d \n", result, msgSize);
    #endif
@@ -712,6 +1075,184 @@ static apx_error_t workerThread_sendFileDynData(apx_fileManagerWorker_t *self, a
    return APX_INVALID_ARGUMENT_ERROR;
 }
 
+/**
+ * Transmits data that is shared with other connections. Large payloads are handed to the transmit handler as a
+ * separate segment (no copy), small ones are copied into the batch like any other message.
+ */
+static apx_error_t workerThread_sendFilePayload(apx_fileManagerWorker_t *self, apx_msg_t *msg)
+{
+   apx_error_t retval = APX_NO_ERROR;
+   uint32_t address = msg->msgData1;
+   uint32_t dataSize = msg->msgData2;
+   apx_payload_t *payload = (apx_payload_t*) msg->msgData3.ptr;
+   const uint8_t *dataPtr = (const uint8_t*) msg->msgData4;
+   assert(self->shared != 0);
+   if (apx_fileManagerShared_isConnected(self->shared) )
+   {
+      if ( (dataSize >= (uint32_t) APX_WORKER_GATHER_THRESHOLD) && workerThread_isGatherEnabled(self) )
+      {
+         retval = workerThread_sendGather(self, address, dataPtr, dataSize, false);
+      }
+      else
+      {
+         int32_t headerSize = (address <= RMF_DATA_LOW_MAX_ADDR)? RMF_LOW_ADDRESS_SIZE : RMF_HIGH_ADDRESS_SIZE;
+         int32_t msgSize = headerSize + (int32_t) dataSize;
+         uint8_t *msgBuf = workerThread_getMsgBuffer(self, msgSize);
+         if (msgBuf != 0)
+         {
+            int32_t result = rmf_packHeader(msgBuf, msgSize, address, false);
+            if (result == headerSize)
+            {
+               memcpy(&msgBuf[headerSize], dataPtr, dataSize);
+               result = workerThread_sendMsg(self, msgSize);
+               if (result != msgSize)
+               {
+                  retval = APX_TRANSMIT_ERROR;
+               }
+            }
+         }
+         else
+         {
+            retval = APX_MISSING_BUFFER_ERROR;
+         }
+      }
+   }
+   apx_payload_release(payload);
+   return retval;
+}
+
+/**
+ * Transmits the current content of all dirty ranges of a file, one RMF write per range.
+ * The ranges are taken from the file owner right before being sent, so only the latest value of each range goes out.
+ * When a range can't be sent, it and all ranges after it are given back to the file owner before returning the error.
+ */
+static apx_error_t workerThread_sendFileConflatedData(apx_fileManagerWorker_t *self, apx_msg_t *msg)
+{
+   apx_error_t retval;
+   apx_file_t *file;
+   uint32_t startAddress = msg->msgData1;
+   apx_fileConflationHandler_t *handler = (apx_fileConflationHandler_t*) msg->msgData3.ptr;
+   uint32_t numRanges;
+   uint32_t i;
+   assert(self->shared != 0);
+   assert(handler != 0);
+   file = apx_fileManagerShared_findFileByAddress(self->shared, startAddress & RMF_ADDRESS_MASK_INTERNAL);
+   if (file == 0)
+   {
+      return APX_FILE_NOT_FOUND_ERROR;
+   }
+   apx_byteRangeSet_clear(&self->conflatedRanges);
+   retval = handler->takeDirtyRanges(handler->arg, file, &self->conflatedRanges);
+   if ( (retval != APX_NO_ERROR) || (apx_fileManagerShared_isConnected(self->shared) == false) )
+   {
+      return retval;
+   }
+   numRanges = apx_byteRangeSet_length(&self->conflatedRanges);
+   for (i = 0u; i < numRanges; i++)
+   {
+      int32_t headerSize;
+      int32_t msgSize;
+      uint8_t *msgBuf;
+      const apx_byteRange_t *range = apx_byteRangeSet_get(&self->conflatedRanges, i);
+      uint32_t address = startAddress + range->offset;
+      assert(range->offset + range->len <= apx_file_getFileSize(file));
+      headerSize = (address <= RMF_DATA_LOW_MAX_ADDR)? RMF_LOW_ADDRESS_SIZE : RMF_HIGH_ADDRESS_SIZE;
+      msgSize = headerSize + (int32_t) range->len;
+      msgBuf = workerThread_getMsgBuffer(self, msgSize);
+      if (msgBuf == 0)
+      {
+         retval = APX_MISSING_BUFFER_ERROR;
+      }
+      else if (rmf_packHeader(msgBuf, msgSize, address, false) == headerSize)
+      {
+         retval = handler->readData(handler->arg, file, range->offset, &msgBuf[headerSize], range->len);
+         if ( (retval == APX_NO_ERROR) && (workerThread_sendMsg(self, msgSize) != msgSize) )
+         {
+            retval = APX_TRANSMIT_ERROR;
+         }
+      }
+      if (retval != APX_NO_ERROR)
+      {
+         workerThread_restoreConflatedRanges(self, handler, file, i);
+         return retval;
+      }
+   }
+   return APX_NO_ERROR;
+}
+
+/**
+ * Marks conflated ranges starting at index firstUnsent as dirty again.
+ * With batching enabled the ranges before firstUnsent may have been lost together with the failed batch, all ranges are given back then.
+ * Sending a range twice is harmless since conflated ranges always carry the latest value.
+ */
+static void workerThread_restoreConflatedRanges(apx_fileManagerWorker_t *self, apx_fileConflationHandler_t *handler, apx_file_t *file, uint32_t firstUnsent)
+{
+   if (handler->markDirty != 0)
+   {
+      uint32_t i;
+      uint32_t numRanges = apx_byteRangeSet_length(&self->conflatedRanges);
+      for (i = workerThread_isBatchEnabled(self)? 0u : firstUnsent; i < numRanges; i++)
+      {
+         const apx_byteRange_t *range = apx_byteRangeSet_get(&self->conflatedRanges, i);
+         (void) handler->markDirty(handler->arg, file, range->offset, range->len);
+      }
+   }
+}
+
+/**
+ * Transmits the elements waiting in a queued port as one RMF write: element count followed by the packed elements.
+ * The handler is always asked to begin the transfer, even when disconnected, so that the port can accept new transfer requests.
+ */
+static apx_error_t workerThread_sendFileQueuedData(apx_fileManagerWorker_t *self, apx_msg_t *msg)
+{
+   apx_file_t *file;
+   uint32_t address = msg->msgData1 & RMF_ADDRESS_MASK_INTERNAL;
+   apx_fileQueueHandler_t *handler = (apx_fileQueueHandler_t*) msg->msgData3.ptr;
+   uint32_t offset;
+   uint32_t len;
+   int32_t headerSize;
+   int32_t msgSize;
+   uint8_t *msgBuf;
+   assert(self->shared != 0);
+   assert(handler != 0);
+   file = apx_fileManagerShared_findFileByAddress(self->shared, address);
+   if (file == 0)
+   {
+      return APX_FILE_NOT_FOUND_ERROR;
+   }
+   offset = address - (apx_file_getStartAddress(file) & RMF_ADDRESS_MASK_INTERNAL);
+   len = handler->beginTransfer(handler->arg, file, offset);
+   if ( (len == 0u) || (apx_fileManagerShared_isConnected(self->shared) == false) )
+   {
+      return APX_NO_ERROR;
+   }
+   if (len > msg->msgData2)
+   {
+      len = msg->msgData2;
+   }
+   assert(offset + len <= apx_file_getFileSize(file));
+   headerSize = (msg->msgData1 <= RMF_DATA_LOW_MAX_ADDR)? RMF_LOW_ADDRESS_SIZE : RMF_HIGH_ADDRESS_SIZE;
+   msgSize = headerSize + (int32_t) len;
+   msgBuf = workerThread_getMsgBuffer(self, msgSize);
+   if (msgBuf == 0)
+   {
+      return APX_MISSING_BUFFER_ERROR;
+   }
+   if (rmf_packHeader(msgBuf, msgSize, msg->msgData1, false) == headerSize)
+   {
+      apx_error_t retval = handler->readData(handler->arg, file, offset, &msgBuf[headerSize], len);
+      if (retval != APX_NO_ERROR)
+      {
+         return retval;
+      }
+      if (workerThread_sendMsg(self, msgSize) != msgSize)
+      {
+         return APX_TRANSMIT_ERROR;
+      }
+   }
+   return APX_NO_ERROR;
+}
+
 static void workerThread_sendAcknowledge(apx_fileManagerWorker_t *self)
 {
    const int32_t msgSize = RMF_CMD_ADDRESS_LEN+RMF_CMD_ACK_LEN;
@@ -720,7 +1261,7 @@ static void workerThread_sendAcknowledge(apx_fileManagerWorker_t *self)
    assert(self->transmitHandler.send != 0);
    if (apx_fileManagerShared_isConnected(self->shared) )
    {
-      msgBuf = self->transmitHandler.getSendBuffer(self->transmitHandler.arg, msgSize);
+      msgBuf = workerThread_getMsgBuffer(self, msgSize);
       if (msgBuf != 0)
       {
          int32_t result = rmf_packHeader(msgBuf, msgSize, RMF_CMD_START_ADDR, false);
@@ -729,18 +1270,486 @@ static void workerThread_sendAcknowledge(apx_fileManagerWorker_t *self)
             result = rmf_serialize_acknowledge(msgBuf+RMF_CMD_ADDRESS_LEN, RMF_CMD_ACK_LEN);
             if (result == RMF_CMD_ACK_LEN)
             {
-               self->transmitHandler.send(self->transmitHandler.arg, 0, msgSize);
+               workerThread_sendMsg(self, msgSize);
             }
          }
       }
    }
 }
 
-static apx_error_t apx_fileManagerWorker_processRingBufErrorCode(adt_buf_err_t errorCode)
+static void workerThread_sendPing(apx_fileManagerWorker_t *self, apx_msg_t *msg)
 {
-   if (errorCode == BUF_E_OVERFLOW)
+   const int32_t msgSize = RMF_CMD_ADDRESS_LEN+RMF_CMD_PING_LEN;
+   uint8_t *msgBuf;
+   assert(self->transmitHandler.getSendBuffer != 0);
+   assert(self->transmitHandler.send != 0);
+   if (apx_fileManagerShared_isConnected(self->shared) )
    {
-      return APX_BUFFER_FULL_ERROR;
+      msgBuf = workerThread_getMsgBuffer(self, msgSize);
+      if (msgBuf != 0)
+      {
+         int32_t result = rmf_packHeader(msgBuf, msgSize, RMF_CMD_START_ADDR, false);
+         if (result == RMF_CMD_ADDRESS_LEN)
+         {
+            rmf_cmdPing_t cmd;
+            uint32_t cmdType;
+            cmd.sequence = msg->msgData1;
+            if (msg->msgType == APX_MSG_SEND_PING_REQUEST)
+            {
+               cmdType = RMF_CMD_PING_RQST;
+               cmd.timestamp = apx_latencyStats_timestampUs();
+            }
+            else
+            {
+               cmdType = RMF_CMD_PING_RSP;
+               memcpy(&cmd.timestamp, &msg->msgData3.data[0], sizeof(uint64_t));
+            }
+            result = rmf_serialize_cmdPing(msgBuf+RMF_CMD_ADDRESS_LEN, RMF_CMD_PING_LEN, cmdType, &cmd);
+            if (result == RMF_CMD_PING_LEN)
+            {
+               workerThread_sendMsg(self, msgSize);
+            }
+         }
+      }
    }
-   return APX_MEM_ERROR;
+}
+
+static void workerThread_sendHeartbeatResponse(apx_fileManagerWorker_t *self)
+{
+   const int32_t msgSize = RMF_CMD_ADDRESS_LEN+RMF_CMD_HEARTBEAT_LEN;
+   uint8_t *msgBuf;
+   assert(self->transmitHandler.getSendBuffer != 0);
+   assert(self->transmitHandler.send != 0);
+   if (apx_fileManagerShared_isConnected(self->shared) )
+   {
+      msgBuf = workerThread_getMsgBuffer(self, msgSize);
+      if (msgBuf != 0)
+      {
+         int32_t result = rmf_packHeader(msgBuf, msgSize, RMF_CMD_START_ADDR, false);
+         if (result == RMF_CMD_ADDRESS_LEN)
+         {
+            result = rmf_serialize_cmdHeartbeat(msgBuf+RMF_CMD_ADDRESS_LEN, RMF_CMD_HEARTBEAT_LEN, RMF_CMD_HEARTBEAT_RSP);
+            if (result == RMF_CMD_HEARTBEAT_LEN)
+            {
+               workerThread_sendMsg(self, msgSize);
+            }
+         }
+      }
+   }
+}
+
+static bool workerThread_isBatchEnabled(apx_fileManagerWorker_t *self)
+{
+   return ( (self->batchBuf != 0) && (self->numHeaderSize != 0) && (self->transmitHandler.sendFramed != 0) )? true : false;
+}
+
+static bool workerThread_isGatherEnabled(apx_fileManagerWorker_t *self)
+{
+   return ( (self->numHeaderSize != 0) && (self->transmitHandler.sendGather != 0) )? true : false;
+}
+
+/**
+ * Transmits numHeader and RMF header from a small stack buffer followed by data, which is never copied by the worker.
+ * Anything staged in the batch buffer goes out as the first segment of the same call in order to keep messages in order.
+ */
+static apx_error_t workerThread_sendGather(apx_fileManagerWorker_t *self, uint32_t address, const uint8_t *data, uint32_t dataSize, bool moreBit)
+{
+   uint8_t header[sizeof(uint32_t) + RMF_HIGH_ADDRESS_SIZE];
+   apx_transmitSegment_t segments[3];
+   int32_t numSegments = 0;
+   int32_t headerLen;
+   int32_t totalLen;
+   int32_t result;
+   uint32_t numBatchMessages = 0u;
+   int32_t rmfHeaderSize = (address <= RMF_DATA_LOW_MAX_ADDR)? RMF_LOW_ADDRESS_SIZE : RMF_HIGH_ADDRESS_SIZE;
+   int32_t msgSize = rmfHeaderSize + (int32_t) dataSize;
+   if (self->numHeaderSize == 16u)
+   {
+      headerLen = numheader_encode16(header, (int32_t) sizeof(header), (uint16_t) msgSize);
+   }
+   else
+   {
+      headerLen = numheader_encode32(header, (int32_t) sizeof(header), (uint32_t) msgSize);
+   }
+   if (headerLen <= 0)
+   {
+      return APX_LENGTH_ERROR;
+   }
+   result = rmf_packHeader(&header[headerLen], (int32_t) sizeof(header) - headerLen, address, moreBit);
+   if (result != rmfHeaderSize)
+   {
+      return APX_LENGTH_ERROR;
+   }
+   headerLen += result;
+   totalLen = headerLen + (int32_t) dataSize;
+   if (self->batchLen > 0)
+   {
+      segments[numSegments].data = self->batchBuf;
+      segments[numSegments].dataLen = self->batchLen;
+      numSegments++;
+      totalLen += self->batchLen;
+      numBatchMessages = self->batchNumMessages;
+      self->batchLen = 0;
+      self->batchNumMessages = 0u;
+   }
+   segments[numSegments].data = &header[0];
+   segments[numSegments].dataLen = headerLen;
+   numSegments++;
+   segments[numSegments].data = data;
+   segments[numSegments].dataLen = (int32_t) dataSize;
+   numSegments++;
+   result = self->transmitHandler.sendGather(self->transmitHandler.arg, &segments[0], numSegments);
+   SPINLOCK_ENTER(self->lock);
+   self->stats.numMessagesSent += numBatchMessages + 1u;
+   self->stats.numTransmitCalls++;
+   self->stats.numGatherCalls++;
+   self->stats.numBytesSent += (uint64_t) totalLen;
+   SPINLOCK_LEAVE(self->lock);
+   if (result != totalLen)
+   {
+      return APX_TRANSMIT_ERROR;
+   }
+   return APX_NO_ERROR;
+}
+
+/**
+ * Releases resources owned by a message that will never be processed
+ */
+static void workerThread_releaseMessage(apx_msg_t *msg)
+{
+   if (msg->msgType == APX_MSG_SEND_FILE_PAYLOAD)
+   {
+      apx_payload_release( (apx_payload_t*) msg->msgData3.ptr);
+   }
+}
+
+/**
+ * Data writes larger than the fragment size belong to the bulk class. They are transmitted one fragment at a time,
+ * all other messages (port data, commands) are latency critical and are transmitted in between fragments.
+ */
+static bool workerThread_isBulkMessage(apx_fileManagerWorker_t *self, const apx_msg_t *msg)
+{
+   if ( (self->fragmentSize > 0u) && (msg->msgData2 > self->fragmentSize) )
+   {
+      switch(msg->msgType)
+      {
+      case APX_MSG_SEND_FILE_CONST_DATA: //fall-through
+      case APX_MSG_SEND_FILE_DYN_DATA: //fall-through
+      case APX_MSG_SEND_FILE_PAYLOAD:
+         return true;
+      default:
+         break;
+      }
+   }
+   return false;
+}
+
+/**
+ * Returns the address range written by msg. Conflated transfers may cover any part of their file.
+ * Returns false for messages that don't write file data.
+ */
+static bool workerThread_getWriteRange(apx_fileManagerWorker_t *self, const apx_msg_t *msg, uint32_t *beginAddress, uint32_t *endAddress)
+{
+   switch(msg->msgType)
+   {
+   case APX_MSG_SEND_FILE_CONST_DATA: //fall-through
+   case APX_MSG_SEND_FILE_DYN_DATA: //fall-through
+   case APX_MSG_SEND_FILE_PAYLOAD: //fall-through
+   case APX_MSG_SEND_FILE_QUEUED_DATA:
+      *beginAddress = msg->msgData1 & RMF_ADDRESS_MASK_INTERNAL;
+      *endAddress = *beginAddress + msg->msgData2;
+      return true;
+   case APX_MSG_SEND_FILE_CONFLATED_DATA:
+      {
+         apx_file_t *file = apx_fileManagerShared_findFileByAddress(self->shared, msg->msgData1 & RMF_ADDRESS_MASK_INTERNAL);
+         if (file != 0)
+         {
+            *beginAddress = apx_file_getStartAddress(file) & RMF_ADDRESS_MASK_INTERNAL;
+            *endAddress = *beginAddress + apx_file_getFileSize(file);
+            return true;
+         }
+      }
+      break;
+   default:
+      break;
+   }
+   return false;
+}
+
+static void workerThread_queueBulkTransfer(apx_fileManagerWorker_t *self, const apx_msg_t *msg)
+{
+   if (self->numBulkTransfers == (uint32_t) APX_WORKER_MAX_BULK_TRANSFERS)
+   {
+      workerThread_completeBulkTransfer(self);
+   }
+   self->bulkTransfers[(self->bulkHead + self->numBulkTransfers) % (uint32_t) APX_WORKER_MAX_BULK_TRANSFERS] = *msg;
+   self->numBulkTransfers++;
+}
+
+/**
+ * A write must never be overtaken by older data. Before msg is transmitted, all bulk transfers up to the last one that still has
+ * untransmitted bytes in the range written by msg are completed.
+ */
+static void workerThread_completeOverlappingBulkTransfers(apx_fileManagerWorker_t *self, const apx_msg_t *msg)
+{
+   uint32_t beginAddress;
+   uint32_t endAddress;
+   if (workerThread_getWriteRange(self, msg, &beginAddress, &endAddress))
+   {
+      uint32_t i;
+      uint32_t numToComplete = 0u;
+      for (i = 0u; i < self->numBulkTransfers; i++)
+      {
+         const apx_msg_t *bulkMsg = &self->bulkTransfers[(self->bulkHead + i) % (uint32_t) APX_WORKER_MAX_BULK_TRANSFERS];
+         uint32_t bulkBegin = bulkMsg->msgData1 & RMF_ADDRESS_MASK_INTERNAL;
+         uint32_t bulkEnd = bulkBegin + bulkMsg->msgData2;
+         if (i == 0u)
+         {
+            bulkBegin += self->bulkPos;
+         }
+         if ( (beginAddress < bulkEnd) && (bulkBegin < endAddress) )
+         {
+            numToComplete = i + 1u;
+         }
+      }
+      while (numToComplete > 0u)
+      {
+         workerThread_completeBulkTransfer(self);
+         numToComplete--;
+      }
+   }
+}
+
+/**
+ * Transmits all remaining fragments of the current bulk transfer
+ */
+static void workerThread_completeBulkTransfer(apx_fileManagerWorker_t *self)
+{
+   uint32_t numBulkTransfers = self->numBulkTransfers;
+   while ( (numBulkTransfers > 0u) && (self->numBulkTransfers == numBulkTransfers) )
+   {
+      (void) workerThread_sendBulkFragment(self);
+   }
+}
+
+/**
+ * Transmits the next fragment of the current bulk transfer. All fragments except the last one have the RMF more bit set.
+ * The transfer is released after its last fragment (or on the first error).
+ */
+static apx_error_t workerThread_sendBulkFragment(apx_fileManagerWorker_t *self)
+{
+   apx_error_t retval = APX_NO_ERROR;
+   const apx_msg_t *msg;
+   uint32_t dataSize;
+   bool moreBit;
+   assert(self->numBulkTransfers > 0u);
+   msg = &self->bulkTransfers[self->bulkHead];
+   dataSize = msg->msgData2 - self->bulkPos;
+   if ( (self->fragmentSize > 0u) && (dataSize > self->fragmentSize) )
+   {
+      dataSize = self->fragmentSize;
+   }
+   moreBit = (self->bulkPos + dataSize < msg->msgData2)? true : false;
+   if (apx_fileManagerShared_isConnected(self->shared))
+   {
+      retval = workerThread_sendFragment(self, msg, self->bulkPos, dataSize, moreBit);
+      if (retval == APX_NO_ERROR)
+      {
+         SPINLOCK_ENTER(self->lock);
+         self->stats.numFragmentsSent++;
+         SPINLOCK_LEAVE(self->lock);
+      }
+      else
+      {
+         printf("[WORKER] workerThread_sendFragment failed with error: %d\n", (int) retval);
+      }
+   }
+   else
+   {
+      moreBit = false;
+   }
+   self->bulkPos += dataSize;
+   if ( (moreBit == false) || (retval != APX_NO_ERROR) )
+   {
+      workerThread_releaseBulkTransfer(self);
+   }
+   return retval;
+}
+
+static apx_error_t workerThread_sendFragment(apx_fileManagerWorker_t *self, const apx_msg_t *msg, uint32_t pos, uint32_t dataSize, bool moreBit)
+{
+   apx_error_t retval = APX_NO_ERROR;
+   uint32_t address = msg->msgData1 + pos;
+   int32_t headerSize = (address <= RMF_DATA_LOW_MAX_ADDR)? RMF_LOW_ADDRESS_SIZE : RMF_HIGH_ADDRESS_SIZE;
+   int32_t msgSize = headerSize + (int32_t) dataSize;
+   uint8_t *msgBuf;
+   if (msg->msgType == APX_MSG_SEND_FILE_PAYLOAD)
+   {
+      const uint8_t *dataPtr = ( (const uint8_t*) msg->msgData4) + pos;
+      if ( (dataSize >= (uint32_t) APX_WORKER_GATHER_THRESHOLD) && workerThread_isGatherEnabled(self) )
+      {
+         return workerThread_sendGather(self, address, dataPtr, dataSize, moreBit);
+      }
+   }
+   msgBuf = workerThread_getMsgBuffer(self, msgSize);
+   if (msgBuf == 0)
+   {
+      return APX_MISSING_BUFFER_ERROR;
+   }
+   if (rmf_packHeader(msgBuf, msgSize, address, moreBit) != headerSize)
+   {
+      return APX_LENGTH_ERROR;
+   }
+   switch(msg->msgType)
+   {
+   case APX_MSG_SEND_FILE_CONST_DATA:
+      {
+         apx_file_read_const_data_func *readFunc = (apx_file_read_const_data_func*) msg->msgData3.ptr;
+         apx_file_t *file = apx_fileManagerShared_findFileByAddress(self->shared, address & RMF_ADDRESS_MASK_INTERNAL);
+         if (file == 0)
+         {
+            return APX_FILE_NOT_FOUND_ERROR;
+         }
+         retval = readFunc(msg->msgData4, file, address - apx_file_getStartAddress(file), &msgBuf[headerSize], dataSize);
+      }
+      break;
+   case APX_MSG_SEND_FILE_DYN_DATA:
+      memcpy(&msgBuf[headerSize], ( (const uint8_t*) msg->msgData3.ptr) + pos, dataSize);
+      break;
+   case APX_MSG_SEND_FILE_PAYLOAD:
+      memcpy(&msgBuf[headerSize], ( (const uint8_t*) msg->msgData4) + pos, dataSize);
+      break;
+   default:
+      return APX_INVALID_ARGUMENT_ERROR;
+   }
+   if (retval == APX_NO_ERROR)
+   {
+      if (workerThread_sendMsg(self, msgSize) != msgSize)
+      {
+         retval = APX_TRANSMIT_ERROR;
+      }
+   }
+   return retval;
+}
+
+/**
+ * Removes the current bulk transfer from the FIFO and releases the memory owned by its message
+ */
+static void workerThread_releaseBulkTransfer(apx_fileManagerWorker_t *self)
+{
+   apx_msg_t *msg = &self->bulkTransfers[self->bulkHead];
+   assert(self->numBulkTransfers > 0u);
+   if (msg->msgType == APX_MSG_SEND_FILE_DYN_DATA)
+   {
+      apx_fileManagerShared_freeAllocatedMemory(self->shared, (uint8_t*) msg->msgData3.ptr, msg->msgData2);
+   }
+   else
+   {
+      workerThread_releaseMessage(msg);
+   }
+   self->bulkHead = (self->bulkHead + 1u) % (uint32_t) APX_WORKER_MAX_BULK_TRANSFERS;
+   self->numBulkTransfers--;
+   self->bulkPos = 0u;
+}
+
+/**
+ * Returns a buffer where the caller serializes a message of msgLen bytes. The message is transmitted (or staged) by workerThread_sendMsg.
+ * Messages that fit are placed in the batch buffer, leaving room for the numHeader in front of them.
+ */
+static uint8_t *workerThread_getMsgBuffer(apx_fileManagerWorker_t *self, int32_t msgLen)
+{
+   self->isBatchMsgPending = false;
+   if (workerThread_isBatchEnabled(self))
+   {
+      int32_t maxHeaderLen = (int32_t) (self->numHeaderSize / 8);
+      if (maxHeaderLen + msgLen <= self->batchBufSize)
+      {
+         if ( (self->batchLen + maxHeaderLen + msgLen > self->batchBufSize) || (self->batchNumMessages >= APX_WORKER_MAX_BATCH_MESSAGES) )
+         {
+            if (workerThread_flushBatch(self) != APX_NO_ERROR)
+            {
+               return (uint8_t*) 0;
+            }
+         }
+         self->isBatchMsgPending = true;
+         return &self->batchBuf[self->batchLen + maxHeaderLen];
+      }
+      //Message is larger than the batch buffer. Transmit what is already staged first in order to keep messages in order.
+      if (workerThread_flushBatch(self) != APX_NO_ERROR)
+      {
+         return (uint8_t*) 0;
+      }
+   }
+   return self->transmitHandler.getSendBuffer(self->transmitHandler.arg, msgLen);
+}
+
+static int32_t workerThread_sendMsg(apx_fileManagerWorker_t *self, int32_t msgLen)
+{
+   int32_t result;
+   if (self->isBatchMsgPending)
+   {
+      uint8_t header[sizeof(uint32_t)];
+      int32_t headerLen;
+      int32_t maxHeaderLen = (int32_t) (self->numHeaderSize / 8);
+      uint8_t *pBegin = &self->batchBuf[self->batchLen];
+      self->isBatchMsgPending = false;
+      if (self->numHeaderSize == 16u)
+      {
+         headerLen = numheader_encode16(header, (int32_t) sizeof(header), (uint16_t) msgLen);
+      }
+      else
+      {
+         headerLen = numheader_encode32(header, (int32_t) sizeof(header), (uint32_t) msgLen);
+      }
+      if ( (headerLen <= 0) || (headerLen > maxHeaderLen) )
+      {
+         return -1;
+      }
+      if (headerLen < maxHeaderLen)
+      {
+         //short numHeader, move message data so that it directly follows the header
+         memmove(pBegin + headerLen, pBegin + maxHeaderLen, (size_t) msgLen);
+      }
+      memcpy(pBegin, header, (size_t) headerLen);
+      self->batchLen += headerLen + msgLen;
+      self->batchNumMessages++;
+      return msgLen;
+   }
+   result = self->transmitHandler.send(self->transmitHandler.arg, 0, msgLen);
+   SPINLOCK_ENTER(self->lock);
+   self->stats.numMessagesSent++;
+   self->stats.numTransmitCalls++;
+   self->stats.numBytesSent += (uint64_t) msgLen;
+   SPINLOCK_LEAVE(self->lock);
+   return result;
+}
+
+/**
+ * Transmits all messages staged in the batch buffer using a single call to the transmit handler
+ */
+static apx_error_t workerThread_flushBatch(apx_fileManagerWorker_t *self)
+{
+   apx_error_t retval = APX_NO_ERROR;
+   if (self->batchLen > 0)
+   {
+      if ( (self->transmitHandler.sendFramed != 0) && apx_fileManagerShared_isConnected(self->shared) )
+      {
+         int32_t result = self->transmitHandler.sendFramed(self->transmitHandler.arg, self->batchBuf, self->batchLen);
+#if APX_DEBUG_ENABLE
+         printf("[WORKER] Batch of %u messages transmitted: %d/%d\n", (unsigned int) self->batchNumMessages, (int) result, (int) self->batchLen);
+#endif
+         SPINLOCK_ENTER(self->lock);
+         self->stats.numMessagesSent += self->batchNumMessages;
+         self->stats.numTransmitCalls++;
+         self->stats.numBytesSent += (uint64_t) self->batchLen;
+         SPINLOCK_LEAVE(self->lock);
+         if (result != self->batchLen)
+         {
+            retval = APX_TRANSMIT_ERROR;
+         }
+      }
+      self->batchLen = 0;
+      self->batchNumMessages = 0u;
+   }
+   return retval;
 }
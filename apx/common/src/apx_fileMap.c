@@ -25,12 +25,17 @@
 #define USER_DATA_START      0x20000000 //512MB, this must be a power of 2
 #define USER_DATA_END        0x3FFFFC00 //Start of remote file cmd message area
 #define USER_DATA_BOUNDARY   0x100000u //1MB, this must be a power of 2
+#define FILE_INDEX_GROW_SIZE 16
 
 //////////////////////////////////////////////////////////////////////////////
 // LOCAL FUNCTION PROTOTYPES
 //////////////////////////////////////////////////////////////////////////////
 static int8_t apx_fileMap_autoInsertFile(apx_fileMap_t *self, apx_file_t *pFile, uint32_t start_address, uint32_t end_address, uint32_t address_boundary);
 static int8_t apx_fileMap_insertFileInternal(apx_fileMap_t *self, apx_file_t *pFile);
+static int32_t apx_fileMap_upperBound(const apx_fileMap_t *self, uint32_t address);
+static int8_t apx_fileMap_insertIndex(apx_fileMap_t *self, int32_t index, apx_file_t *pFile);
+static void apx_fileMap_removeIndex(apx_fileMap_t *self, apx_file_t *pFile);
+static uint32_t apx_fileMap_fileEndAddress(const apx_file_t *pFile);
 
 //////////////////////////////////////////////////////////////////////////////
 // GLOBAL VARIABLES
@@ -49,7 +54,9 @@ void apx_fileMap_create(apx_fileMap_t *self)
    if (self != 0)
    {
       adt_list_create(&self->fileList, apx_file_vdelete);
-      self->lastFile = (apx_file_t*) 0;
+      self->fileIndex = (apx_fileMapEntry_t*) 0;
+      self->indexLen = 0;
+      self->indexCapacity = 0;
    }
 }
 void apx_fileMap_destroy(apx_fileMap_t *self)
@@ -57,6 +64,10 @@ void apx_fileMap_destroy(apx_fileMap_t *self)
    if (self !=0)
    {
       adt_list_destroy(&self->fileList);
+      if (self->fileIndex != 0)
+      {
+         free(self->fileIndex);
+      }
    }
 }
 
@@ -98,54 +109,27 @@ int8_t apx_fileMap_removeFile(apx_fileMap_t *self, apx_file_t *pFile)
    if ( (self != 0) && (pFile != 0) )
    {
       //TODO: fix adt_list_remove so that it returns success/failure
-      self->lastFile = (apx_file_t*) 0;
+      apx_fileMap_removeIndex(self, pFile);
       adt_list_remove(&self->fileList, pFile);
       return 0;
    }
    return -1;
 }
 
+/**
+ * Returns the file containing address or NULL if no such file exists. Runs in O(log n).
+ */
 apx_file_t *apx_fileMap_findByAddress(apx_fileMap_t *self, uint32_t address)
 {
-   apx_file_t *retval=0;
    if (self != 0)
    {
-      if (self->lastFile != 0)
-      {
-         uint32_t startAddress;
-         uint32_t endAddress;
-         startAddress = self->lastFile->fileInfo.address & RMF_ADDRESS_MASK_INTERNAL;
-         endAddress = startAddress + self->lastFile->fileInfo.length;
-         if ( (address >= startAddress) && (address < endAddress) )
-         {
-            retval = self->lastFile;
-         }
-      }
-      if (retval == 0)
+      int32_t index = apx_fileMap_upperBound(self, address) - 1;
+      if ( (index >= 0) && (address < self->fileIndex[index].endAddress) )
       {
-         adt_list_elem_t *pIter = adt_list_iter_first(&self->fileList);
-         while(pIter != 0)
-         {
-            uint32_t startAddress;
-            uint32_t endAddress;
-            apx_file_t *pFile = (apx_file_t*) pIter->pItem;
-            assert(pFile != 0);
-            startAddress = pFile->fileInfo.address & RMF_ADDRESS_MASK_INTERNAL;
-            endAddress = startAddress + pFile->fileInfo.length;
-            if ( (address>=startAddress) && (address<endAddress) )
-            {
-               retval = pFile;
-               break;
-            }
-            pIter = adt_list_iter_next(pIter);
-         }
-         if (retval != 0)
-         {
-            self->lastFile = retval;
-         }
+         return self->fileIndex[index].file;
       }
    }
-   return retval;
+   return (apx_file_t*) 0;
 }
 
 apx_file_t *apx_fileMap_findByName(apx_fileMap_t *self, const char *name)
@@ -198,6 +182,7 @@ void  apx_fileMap_clear_weak(apx_fileMap_t *self)
       adt_list_destructor_enable(&self->fileList, false);
       adt_list_clear(&self->fileList);
       adt_list_destructor_enable(&self->fileList, true);
+      self->indexLen = 0;
    }
 }
 
@@ -255,130 +240,130 @@ adt_ary_t *apx_fileMap_makeFileInfoArray(apx_fileMap_t *self)
  */
 static int8_t apx_fileMap_autoInsertFile(apx_fileMap_t *self, apx_file_t *pFile, uint32_t start_address, uint32_t end_address, uint32_t address_boundary)
 {
-   if (adt_list_is_empty(&self->fileList))
-   {
-      apx_fileInfo_setAddress(&pFile->fileInfo, start_address);
-   }
-   else
+   uint32_t placement_address = start_address;
+   int32_t index = apx_fileMap_upperBound(self, end_address - 1u) - 1; //last file starting before end_address
+   assert(address_boundary != 0);
+   //check if address_boundary is a power of two. If not, we need to use another slower method to calculate new placement_address
+   assert((address_boundary & (address_boundary-1)) == 0); ///TODO: implement support for other boundaries
+   if (index >= 0)
    {
-      adt_list_elem_t *pIter=0;
-      adt_list_elem_t *pFound=0;
-      uint32_t placement_address = start_address;
-      pIter = adt_list_iter_first(&self->fileList);
-      while(pIter != 0)
+      uint32_t other_end_address = self->fileIndex[index].endAddress;
+      if (other_end_address > start_address)
       {
-         apx_file_t *pOther;
-         pOther = (apx_file_t*) pIter->pItem;
-         assert(pOther != 0);
-
-         if( pOther->fileInfo.addressWithoutFlags >= end_address)
-         {
-            break; //we have passed into the next area, break and use latest seen value of pFound
-         }
-         else if(pOther->fileInfo.addressWithoutFlags >= start_address)
-         {
-            pFound = pIter; //update pFound
-         }
-         else
-         {
-            //MISRA
-         }
-         pIter = adt_list_iter_next(pIter);
-      }
-      if (pFound != 0)
-      {
-         uint32_t other_end_address;
-         uint32_t other_start_address;
-         apx_file_t *pOther = (apx_file_t*) pFound->pItem;
-         assert(pOther != 0);
-         other_start_address=pOther->fileInfo.addressWithoutFlags;
-         other_end_address=other_start_address + pOther->fileInfo.length;
-         //check if address_boundary is a power of two. If not, we need to use another slower method to calculate new placement_address
-         assert(address_boundary != 0);
-         if ((address_boundary & (address_boundary-1)) == 0)
-         {
-            //address_boundary is a power of 2, use faster method
-            placement_address  = (other_end_address + (address_boundary-1)) & (~(address_boundary-1)); //note that address_boundary must be a power of 2 for this code to work
-         }
-         else
-         {
-            //use slower method
-            assert(0); ///TODO: implement this
-         }
-
-         if (placement_address >= end_address)
-         {
-            //memory map full, cannot fit any more files into this region
-            errno = ENOMEM;
-            return -1;
-         }
+         placement_address  = (other_end_address + (address_boundary-1)) & (~(address_boundary-1)); //note that address_boundary must be a power of 2 for this code to work
       }
-      apx_fileInfo_setAddress(&pFile->fileInfo, placement_address);
    }
+   if ( (placement_address >= end_address) || (pFile->fileInfo.length > (end_address - placement_address)) )
+   {
+      //memory map full, cannot fit any more files into this region
+      errno = ENOMEM;
+      return -1;
+   }
+   apx_fileInfo_setAddress(&pFile->fileInfo, placement_address);
    assert(pFile->fileInfo.addressWithoutFlags<RMF_CMD_START_ADDR);
    return apx_fileMap_insertFileInternal(self, pFile);
 }
 
+/**
+ * Inserts pFile into the sorted file list and the address index.
+ * Insertion is rejected if the address range of pFile overlaps any file already in the map.
+ */
 static int8_t apx_fileMap_insertFileInternal(apx_fileMap_t *self, apx_file_t *pFile)
 {
-   self->lastFile = (apx_file_t*) 0;
-   if (adt_list_is_empty(&self->fileList))
+   uint32_t start_address = pFile->fileInfo.addressWithoutFlags;
+   uint32_t end_address = apx_fileMap_fileEndAddress(pFile);
+   int32_t index = apx_fileMap_upperBound(self, start_address); //pFile goes in before this index
+   if (index > 0)
    {
-      adt_list_insert(&self->fileList, pFile);
+      if (self->fileIndex[index-1].endAddress > start_address)
+      {
+         //address collision between pLast and pFile, reject insertion of pFile
+         errno = EADDRINUSE; /* Address already in use */
+         return -1;
+      }
    }
-   else
+   if (index < self->indexLen)
    {
-      apx_file_t *pLast=0;
-      apx_file_t *pCurrent=0;
-      adt_list_elem_t *pIter = adt_list_iter_first(&self->fileList);
-      while(pIter != 0)
+      if (end_address > self->fileIndex[index].startAddress)
       {
-         pCurrent = (apx_file_t*) pIter->pItem;
-         assert(pCurrent != 0);
-         if( pCurrent->fileInfo.addressWithoutFlags > pFile->fileInfo.addressWithoutFlags)
-         {
-            //try to fit pFile in before pCurrent;
-            break;
-         }
-         pLast = pCurrent;
-         pIter = adt_list_iter_next(pIter);
+         //address collision between pNext and pFile, reject insertion of pFile
+         errno = EFBIG; /* File too large */
+         return -1;
       }
-      if (pIter != 0)
+   }
+   if (apx_fileMap_insertIndex(self, index, pFile) != 0)
+   {
+      return -1;
+   }
+   if (index+1 < self->indexLen)
+   {
+      apx_file_t *pNext = self->fileIndex[index+1].file;
+      adt_list_elem_t *pIter = adt_list_iter_first(&self->fileList);
+      while( (pIter != 0) && (pIter->pItem != pNext) )
       {
-         uint32_t start_address;
-         uint32_t end_address;
-         assert(pCurrent != 0);
-         assert( ((apx_file_t*) pIter->pItem) == pCurrent);
-         if (pLast != 0)
-         {
-            //check if there is room to fit this file between pLast and pFile
-            uint32_t start_address;
-            uint32_t end_address;
-            start_address = pLast->fileInfo.addressWithoutFlags;
-            end_address = start_address+pLast->fileInfo.length;
-            if (end_address > pFile->fileInfo.addressWithoutFlags)
-            {
-               //address collision between pLast and pFile, reject insertion of pFile
-               errno = EADDRINUSE; /* Address already in use */
-               return -1;
-            }
-         }
-         start_address = pFile->fileInfo.addressWithoutFlags;
-         end_address = start_address+pFile->fileInfo.length;
-         if (end_address > pCurrent->fileInfo.addressWithoutFlags)
-         {
-            //address collision between pCurrent and pFile, reject insertion of pFile
-            errno = EFBIG; /* File too large */
-            return -1;
-         }
-         //it should now be safe to insert the file before pIter
-         adt_list_insert_before(&self->fileList, pIter, pFile);
+         pIter = adt_list_iter_next(pIter);
       }
-      else
+      assert(pIter != 0);
+      adt_list_insert_before(&self->fileList, pIter, pFile);
+   }
+   else
+   {
+      //insert pFile at end of list
+      adt_list_insert(&self->fileList, pFile);
+   }
+   return 0;
+}
+
+/**
+ * Returns index of the first file in fileIndex whose start address is greater than address (branch-free binary search)
+ */
+static int32_t apx_fileMap_upperBound(const apx_fileMap_t *self, uint32_t address)
+{
+   int32_t first = 0;
+   int32_t n = self->indexLen;
+   while (n > 0)
+   {
+      int32_t half = n / 2;
+      bool isLess = (self->fileIndex[first + half].startAddress <= address);
+      first = isLess? first + half + 1 : first;
+      n = isLess? n - half - 1 : half;
+   }
+   return first;
+}
+
+static int8_t apx_fileMap_insertIndex(apx_fileMap_t *self, int32_t index, apx_file_t *pFile)
+{
+   if (self->indexLen == self->indexCapacity)
+   {
+      int32_t newCapacity = self->indexCapacity + FILE_INDEX_GROW_SIZE;
+      apx_fileMapEntry_t *newIndex = (apx_fileMapEntry_t*) realloc(self->fileIndex, newCapacity * sizeof(apx_fileMapEntry_t));
+      if (newIndex == 0)
       {
-         //insert pFile at end of list
-         adt_list_insert(&self->fileList, pFile);
+         errno = ENOMEM;
+         return -1;
       }
+      self->fileIndex = newIndex;
+      self->indexCapacity = newCapacity;
    }
+   memmove(&self->fileIndex[index+1], &self->fileIndex[index], (self->indexLen - index) * sizeof(apx_fileMapEntry_t));
+   self->fileIndex[index].startAddress = pFile->fileInfo.addressWithoutFlags;
+   self->fileIndex[index].endAddress = apx_fileMap_fileEndAddress(pFile);
+   self->fileIndex[index].file = pFile;
+   self->indexLen++;
    return 0;
 }
+
+static void apx_fileMap_removeIndex(apx_fileMap_t *self, apx_file_t *pFile)
+{
+   int32_t index = apx_fileMap_upperBound(self, pFile->fileInfo.addressWithoutFlags) - 1;
+   if ( (index >= 0) && (self->fileIndex[index].file == pFile) )
+   {
+      self->indexLen--;
+      memmove(&self->fileIndex[index], &self->fileIndex[index+1], (self->indexLen - index) * sizeof(apx_fileMapEntry_t));
+   }
+}
+
+static uint32_t apx_fileMap_fileEndAddress(const apx_file_t *pFile)
+{
+   return pFile->fileInfo.addressWithoutFlags + pFile->fileInfo.length;
+}
@@ -0,0 +1,165 @@
+/*****************************************************************************
+* \file      apx_latencyStats.c
+* \author    Conny Gustafsson
+* \date      2026-10-18
+* \brief     Rolling round-trip latency statistics for a connection
+*
+* Copyright (c) 2026 Conny Gustafsson
+* Permission is hereby granted, free of charge, to any person obtaining a copy of
+* this software and associated documentation files (the "Software"), to deal in
+* the Software without restriction, including without limitation the rights to
+* use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+* the Software, and to permit persons to whom the Software is furnished to do so,
+* subject to the following conditions:
+
+* The above copyright notice and this permission notice shall be included in all
+* copies or substantial portions of the Software.
+
+* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+* IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+* FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+* COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+* IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+* CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+*
+******************************************************************************/
+//////////////////////////////////////////////////////////////////////////////
+// INCLUDES
+//////////////////////////////////////////////////////////////////////////////
+#include <string.h>
+#ifdef _MSC_VER
+# ifndef WIN32_LEAN_AND_MEAN
+# define WIN32_LEAN_AND_MEAN
+# endif
+# include <Windows.h>
+#else
+# include <time.h>
+#endif
+#include "apx_latencyStats.h"
+#ifdef MEM_LEAK_CHECK
+#include "CMemLeak.h"
+#endif
+
+//////////////////////////////////////////////////////////////////////////////
+// PRIVATE CONSTANTS AND DATA TYPES
+//////////////////////////////////////////////////////////////////////////////
+
+//////////////////////////////////////////////////////////////////////////////
+// PRIVATE FUNCTION PROTOTYPES
+//////////////////////////////////////////////////////////////////////////////
+static void apx_latencyStats_sort(uint32_t *values, uint32_t numValues);
+
+//////////////////////////////////////////////////////////////////////////////
+// PRIVATE VARIABLES
+//////////////////////////////////////////////////////////////////////////////
+
+//////////////////////////////////////////////////////////////////////////////
+// PUBLIC FUNCTIONS
+//////////////////////////////////////////////////////////////////////////////
+void apx_latencyStats_create(apx_latencyStats_t *self)
+{
+   apx_latencyStats_reset(self);
+}
+
+void apx_latencyStats_destroy(apx_latencyStats_t *self)
+{
+   (void) self;
+}
+
+void apx_latencyStats_reset(apx_latencyStats_t *self)
+{
+   if (self != 0)
+   {
+      memset(self, 0, sizeof(apx_latencyStats_t));
+   }
+}
+
+void apx_latencyStats_addSample(apx_latencyStats_t *self, uint32_t rttUs)
+{
+   if (self != 0)
+   {
+      self->samples[self->nextIndex] = rttUs;
+      self->nextIndex = (self->nextIndex + 1u) % APX_LATENCY_STATS_WINDOW_SIZE;
+      if (self->numSamples < APX_LATENCY_STATS_WINDOW_SIZE)
+      {
+         self->numSamples++;
+      }
+      self->totalSamples++;
+      self->lastRttUs = rttUs;
+   }
+}
+
+/**
+ * Calculates min/avg/p99/max over the samples currently in the window. p99 uses the nearest-rank method.
+ * All values are zero when no samples have been added yet.
+ */
+void apx_latencyStats_getSummary(const apx_latencyStats_t *self, apx_latencySummary_t *summary)
+{
+   if ( (self != 0) && (summary != 0) )
+   {
+      memset(summary, 0, sizeof(apx_latencySummary_t));
+      summary->totalSamples = self->totalSamples;
+      if (self->numSamples > 0u)
+      {
+         uint32_t sorted[APX_LATENCY_STATS_WINDOW_SIZE];
+         uint64_t sum = 0u;
+         uint32_t rank;
+         uint32_t i;
+         for (i = 0u; i < self->numSamples; i++)
+         {
+            sorted[i] = self->samples[i];
+            sum += self->samples[i];
+         }
+         apx_latencyStats_sort(sorted, self->numSamples);
+         rank = (self->numSamples * 99u + 99u) / 100u; //ceil(0.99*n)
+         summary->numSamples = self->numSamples;
+         summary->lastRttUs = self->lastRttUs;
+         summary->minRttUs = sorted[0];
+         summary->maxRttUs = sorted[self->numSamples - 1u];
+         summary->p99RttUs = sorted[rank - 1u];
+         summary->avgRttUs = (uint32_t) (sum / self->numSamples);
+         summary->oneWayDelayUs = summary->avgRttUs / 2u;
+      }
+   }
+}
+
+/**
+ * Monotonic time in microseconds. Used for stamping outgoing ping requests.
+ */
+uint64_t apx_latencyStats_timestampUs(void)
+{
+#ifdef _MSC_VER
+   LARGE_INTEGER frequency;
+   LARGE_INTEGER counter;
+   QueryPerformanceFrequency(&frequency);
+   QueryPerformanceCounter(&counter);
+   return (uint64_t) ( (counter.QuadPart * 1000000) / frequency.QuadPart );
+#else
+   struct timespec ts;
+   clock_gettime(CLOCK_MONOTONIC, &ts);
+   return ( (uint64_t) ts.tv_sec * 1000000u) + ( (uint64_t) ts.tv_nsec / 1000u);
+#endif
+}
+
+//////////////////////////////////////////////////////////////////////////////
+// PRIVATE FUNCTIONS
+//////////////////////////////////////////////////////////////////////////////
+
+/**
+ * Insertion sort, the window is small enough that this beats qsort.
+ */
+static void apx_latencyStats_sort(uint32_t *values, uint32_t numValues)
+{
+   uint32_t i;
+   for (i = 1u; i < numValues; i++)
+   {
+      uint32_t value = values[i];
+      uint32_t j = i;
+      while ( (j > 0u) && (values[j - 1u] > value) )
+      {
+         values[j] = values[j - 1u];
+         j--;
+      }
+      values[j] = value;
+   }
+}
@@ -0,0 +1,406 @@
+/*****************************************************************************
+* \file      apx_lz.c
+* \author    Conny Gustafsson
+* \date      2026-10-18
+* \brief     LZ4 block format compressor and incremental decompressor
+*
+* Copyright (c) 2026 Conny Gustafsson
+* Permission is hereby granted, free of charge, to any person obtaining a copy of
+* this software and associated documentation files (the "Software"), to deal in
+* the Software without restriction, including without limitation the rights to
+* use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+* the Software, and to permit persons to whom the Software is furnished to do so,
+* subject to the following conditions:
+
+* The above copyright notice and this permission notice shall be included in all
+* copies or substantial portions of the Software.
+
+* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+* IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+* FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+* COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+* IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+* CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+*
+******************************************************************************/
+//////////////////////////////////////////////////////////////////////////////
+// INCLUDES
+//////////////////////////////////////////////////////////////////////////////
+#include <malloc.h>
+#include <string.h>
+#include "apx_lz.h"
+#ifdef MEM_LEAK_CHECK
+#include "CMemLeak.h"
+#endif
+
+//////////////////////////////////////////////////////////////////////////////
+// PRIVATE CONSTANTS AND DATA TYPES
+//////////////////////////////////////////////////////////////////////////////
+#define APX_LZ_HASH_SIZE          (1u << APX_LZ_HASH_LOG)
+#define APX_LZ_RUN_MASK           15u
+#define APX_LZ_ML_MASK            15u
+
+#define APX_LZ_STATE_TOKEN        0u
+#define APX_LZ_STATE_LITERAL_LEN  1u
+#define APX_LZ_STATE_LITERALS     2u
+#define APX_LZ_STATE_OFFSET_LOW   3u
+#define APX_LZ_STATE_OFFSET_HIGH  4u
+#define APX_LZ_STATE_MATCH_LEN    5u
+#define APX_LZ_STATE_DONE         6u
+
+//////////////////////////////////////////////////////////////////////////////
+// PRIVATE FUNCTION PROTOTYPES
+//////////////////////////////////////////////////////////////////////////////
+static uint32_t apx_lz_read32(const uint8_t *p);
+static uint32_t apx_lz_hash(uint32_t sequence);
+static apx_size_t apx_lz_lengthSize(uint32_t length);
+static uint8_t *apx_lz_writeLength(uint8_t *p, uint32_t length);
+static uint8_t *apx_lz_writeSequence(uint8_t *p, const uint8_t *pEnd, const uint8_t *literals, uint32_t literalLen, uint32_t offset, uint32_t matchLen);
+static void apx_lzDecoder_literalsDone(apx_lzDecoder_t *self);
+static apx_error_t apx_lzDecoder_copyMatch(apx_lzDecoder_t *self);
+
+//////////////////////////////////////////////////////////////////////////////
+// PUBLIC VARIABLES
+//////////////////////////////////////////////////////////////////////////////
+
+//////////////////////////////////////////////////////////////////////////////
+// PRIVATE VARIABLES
+//////////////////////////////////////////////////////////////////////////////
+
+//////////////////////////////////////////////////////////////////////////////
+// PUBLIC FUNCTIONS
+//////////////////////////////////////////////////////////////////////////////
+
+/**
+ * Returns the size of the largest block apx_lz_compress can produce from srcLen bytes of input
+ */
+apx_size_t apx_lz_compressBound(apx_size_t srcLen)
+{
+   return srcLen + (srcLen / 255u) + 16u;
+}
+
+/**
+ * Greedy single-pass compressor producing one LZ4 block.
+ * Returns APX_BUFFER_FULL_ERROR when the result does not fit in destCapacity bytes. Callers who only want
+ * to use compression when it pays off can pass srcLen as destCapacity.
+ */
+apx_error_t apx_lz_compress(const uint8_t *src, apx_size_t srcLen, uint8_t *dest, apx_size_t destCapacity, apx_size_t *destLen)
+{
+   if ( (src != 0) && (dest != 0) && (destLen != 0) )
+   {
+      uint8_t *p = dest;
+      const uint8_t *pEnd = dest + destCapacity;
+      apx_size_t anchor = 0u;
+      if (srcLen > APX_LZ_MF_LIMIT)
+      {
+         apx_size_t pos = 0u;
+         const apx_size_t posLimit = srcLen - APX_LZ_MF_LIMIT;
+         const apx_size_t matchLimit = srcLen - APX_LZ_LAST_LITERALS;
+         uint32_t *hashTable = (uint32_t*) malloc(APX_LZ_HASH_SIZE * sizeof(uint32_t));
+         if (hashTable == 0)
+         {
+            return APX_MEM_ERROR;
+         }
+         memset(hashTable, 0, APX_LZ_HASH_SIZE * sizeof(uint32_t));
+         while (pos < posLimit)
+         {
+            uint32_t sequence = apx_lz_read32(&src[pos]);
+            uint32_t hash = apx_lz_hash(sequence);
+            apx_size_t candidate = (apx_size_t) hashTable[hash];
+            hashTable[hash] = (uint32_t) pos;
+            if ( (candidate < pos) && ( (pos - candidate) <= APX_LZ_MAX_OFFSET) && (apx_lz_read32(&src[candidate]) == sequence) )
+            {
+               uint32_t matchLen = APX_LZ_MIN_MATCH;
+               while ( ( (pos + matchLen) < matchLimit) && (src[candidate + matchLen] == src[pos + matchLen]) )
+               {
+                  matchLen++;
+               }
+               p = apx_lz_writeSequence(p, pEnd, &src[anchor], (uint32_t) (pos - anchor), (uint32_t) (pos - candidate), matchLen);
+               if (p == 0)
+               {
+                  free(hashTable);
+                  return APX_BUFFER_FULL_ERROR;
+               }
+               pos += matchLen;
+               anchor = pos;
+            }
+            else
+            {
+               pos++;
+            }
+         }
+         free(hashTable);
+      }
+      //Last sequence only contains literals
+      p = apx_lz_writeSequence(p, pEnd, &src[anchor], (uint32_t) (srcLen - anchor), 0u, 0u);
+      if (p == 0)
+      {
+         return APX_BUFFER_FULL_ERROR;
+      }
+      *destLen = (apx_size_t) (p - dest);
+      return APX_NO_ERROR;
+   }
+   return APX_INVALID_ARGUMENT_ERROR;
+}
+
+/**
+ * Decompresses an entire block in one call. destSize must be the exact uncompressed size.
+ */
+apx_error_t apx_lz_decompress(const uint8_t *src, apx_size_t srcLen, uint8_t *dest, apx_size_t destSize)
+{
+   if ( (src != 0) && ( (dest != 0) || (destSize == 0u) ) )
+   {
+      apx_lzDecoder_t decoder;
+      apx_error_t result;
+      apx_lzDecoder_create(&decoder, dest, destSize);
+      result = apx_lzDecoder_write(&decoder, src, srcLen);
+      if ( (result == APX_NO_ERROR) && (!apx_lzDecoder_isComplete(&decoder)) )
+      {
+         result = APX_DECOMPRESSION_ERROR;
+      }
+      return result;
+   }
+   return APX_INVALID_ARGUMENT_ERROR;
+}
+
+void apx_lzDecoder_create(apx_lzDecoder_t *self, uint8_t *dest, apx_size_t destSize)
+{
+   if (self != 0)
+   {
+      self->dest = dest;
+      self->destSize = destSize;
+      self->destPos = 0u;
+      self->literalLen = 0u;
+      self->matchLen = 0u;
+      self->matchOffset = 0u;
+      self->state = APX_LZ_STATE_TOKEN;
+   }
+}
+
+/**
+ * Feeds the next srcLen bytes of the compressed block into the decoder.
+ * Returns APX_DECOMPRESSION_ERROR if the data is malformed or decodes to more than destSize bytes.
+ */
+apx_error_t apx_lzDecoder_write(apx_lzDecoder_t *self, const uint8_t *src, apx_size_t srcLen)
+{
+   if ( (self != 0) && ( (src != 0) || (srcLen == 0u) ) )
+   {
+      const uint8_t *p = src;
+      const uint8_t *pEnd = src + srcLen;
+      while (p < pEnd)
+      {
+         uint8_t value;
+         apx_size_t numBytes;
+         apx_error_t result;
+         switch (self->state)
+         {
+         case APX_LZ_STATE_TOKEN:
+            value = *p++;
+            self->literalLen = (uint32_t) (value >> 4);
+            self->matchLen = (uint32_t) (value & APX_LZ_ML_MASK);
+            if (self->literalLen == APX_LZ_RUN_MASK)
+            {
+               self->state = APX_LZ_STATE_LITERAL_LEN;
+            }
+            else
+            {
+               self->state = APX_LZ_STATE_LITERALS;
+               if (self->literalLen == 0u)
+               {
+                  apx_lzDecoder_literalsDone(self);
+               }
+            }
+            break;
+         case APX_LZ_STATE_LITERAL_LEN:
+            value = *p++;
+            self->literalLen += (uint32_t) value;
+            if (value != 255u)
+            {
+               self->state = APX_LZ_STATE_LITERALS;
+            }
+            break;
+         case APX_LZ_STATE_LITERALS:
+            numBytes = (apx_size_t) (pEnd - p);
+            if (numBytes > self->literalLen)
+            {
+               numBytes = (apx_size_t) self->literalLen;
+            }
+            if (numBytes > (self->destSize - self->destPos))
+            {
+               return APX_DECOMPRESSION_ERROR;
+            }
+            memcpy(&self->dest[self->destPos], p, numBytes);
+            self->destPos += numBytes;
+            self->literalLen -= (uint32_t) numBytes;
+            p += numBytes;
+            if (self->literalLen == 0u)
+            {
+               apx_lzDecoder_literalsDone(self);
+            }
+            break;
+         case APX_LZ_STATE_OFFSET_LOW:
+            self->matchOffset = (uint32_t) *p++;
+            self->state = APX_LZ_STATE_OFFSET_HIGH;
+            break;
+         case APX_LZ_STATE_OFFSET_HIGH:
+            self->matchOffset |= ( (uint32_t) *p++) << 8;
+            if (self->matchLen == APX_LZ_ML_MASK)
+            {
+               self->state = APX_LZ_STATE_MATCH_LEN;
+            }
+            else
+            {
+               result = apx_lzDecoder_copyMatch(self);
+               if (result != APX_NO_ERROR)
+               {
+                  return result;
+               }
+            }
+            break;
+         case APX_LZ_STATE_MATCH_LEN:
+            value = *p++;
+            self->matchLen += (uint32_t) value;
+            if (value != 255u)
+            {
+               result = apx_lzDecoder_copyMatch(self);
+               if (result != APX_NO_ERROR)
+               {
+                  return result;
+               }
+            }
+            break;
+         default:
+            return APX_DECOMPRESSION_ERROR; //trailing data after end of block
+         }
+      }
+      return APX_NO_ERROR;
+   }
+   return APX_INVALID_ARGUMENT_ERROR;
+}
+
+bool apx_lzDecoder_isComplete(const apx_lzDecoder_t *self)
+{
+   if (self != 0)
+   {
+      return (self->state == APX_LZ_STATE_DONE)? true : false;
+   }
+   return false;
+}
+
+/**
+ * Returns number of bytes decoded so far
+ */
+apx_size_t apx_lzDecoder_getSize(const apx_lzDecoder_t *self)
+{
+   if (self != 0)
+   {
+      return self->destPos;
+   }
+   return 0u;
+}
+
+//////////////////////////////////////////////////////////////////////////////
+// PRIVATE FUNCTIONS
+//////////////////////////////////////////////////////////////////////////////
+static uint32_t apx_lz_read32(const uint8_t *p)
+{
+   return ( (uint32_t) p[0]) | ( (uint32_t) p[1] << 8) | ( (uint32_t) p[2] << 16) | ( (uint32_t) p[3] << 24);
+}
+
+static uint32_t apx_lz_hash(uint32_t sequence)
+{
+   return (sequence * 2654435761u) >> (32u - APX_LZ_HASH_LOG);
+}
+
+/**
+ * Number of extra bytes needed to encode a length which did not fit in its 4-bit token field
+ */
+static apx_size_t apx_lz_lengthSize(uint32_t length)
+{
+   if (length < APX_LZ_RUN_MASK)
+   {
+      return 0u;
+   }
+   return (apx_size_t) ( (length - APX_LZ_RUN_MASK) / 255u) + 1u;
+}
+
+static uint8_t *apx_lz_writeLength(uint8_t *p, uint32_t length)
+{
+   if (length >= APX_LZ_RUN_MASK)
+   {
+      length -= APX_LZ_RUN_MASK;
+      while (length >= 255u)
+      {
+         *p++ = 255u;
+         length -= 255u;
+      }
+      *p++ = (uint8_t) length;
+   }
+   return p;
+}
+
+/**
+ * Writes one sequence. A matchLen of 0 writes a literals-only sequence (only allowed at end of block).
+ * Returns pointer to first byte after the sequence or NULL if it would not fit before pEnd.
+ */
+static uint8_t *apx_lz_writeSequence(uint8_t *p, const uint8_t *pEnd, const uint8_t *literals, uint32_t literalLen, uint32_t offset, uint32_t matchLen)
+{
+   apx_size_t requiredSize = 1u + apx_lz_lengthSize(literalLen) + literalLen;
+   uint32_t tokenMatchLen = 0u;
+   if (matchLen > 0u)
+   {
+      tokenMatchLen = matchLen - APX_LZ_MIN_MATCH;
+      requiredSize += 2u + apx_lz_lengthSize(tokenMatchLen);
+   }
+   if (requiredSize > (apx_size_t) (pEnd - p))
+   {
+      return (uint8_t*) 0;
+   }
+   *p++ = (uint8_t) ( ( (literalLen < APX_LZ_RUN_MASK)? literalLen : APX_LZ_RUN_MASK) << 4) |
+          (uint8_t) ( (tokenMatchLen < APX_LZ_ML_MASK)? tokenMatchLen : APX_LZ_ML_MASK);
+   p = apx_lz_writeLength(p, literalLen);
+   if (literalLen > 0u)
+   {
+      memcpy(p, literals, literalLen);
+      p += literalLen;
+   }
+   if (matchLen > 0u)
+   {
+      *p++ = (uint8_t) (offset & 0xFFu);
+      *p++ = (uint8_t) (offset >> 8);
+      p = apx_lz_writeLength(p, tokenMatchLen);
+   }
+   return p;
+}
+
+/**
+ * A block ends with a literals-only sequence, which is recognized by the output being full after its literals.
+ */
+static void apx_lzDecoder_literalsDone(apx_lzDecoder_t *self)
+{
+   self->state = (self->destPos == self->destSize)? APX_LZ_STATE_DONE : APX_LZ_STATE_OFFSET_LOW;
+}
+
+/**
+ * Copies byte by byte since match and destination may overlap (e.g. offset 1 repeats the previous byte).
+ */
+static apx_error_t apx_lzDecoder_copyMatch(apx_lzDecoder_t *self)
+{
+   uint32_t i;
+   uint32_t matchLen = self->matchLen + APX_LZ_MIN_MATCH;
+   const uint8_t *pSrc;
+   uint8_t *pDest;
+   if ( (self->matchOffset == 0u) || (self->matchOffset > self->destPos) || (matchLen > (self->destSize - self->destPos)) )
+   {
+      return APX_DECOMPRESSION_ERROR;
+   }
+   pDest = &self->dest[self->destPos];
+   pSrc = pDest - self->matchOffset;
+   for (i = 0u; i < matchLen; i++)
+   {
+      pDest[i] = pSrc[i];
+   }
+   self->destPos += matchLen;
+   self->state = APX_LZ_STATE_TOKEN;
+   return APX_NO_ERROR;
+}
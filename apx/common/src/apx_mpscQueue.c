@@ -0,0 +1,326 @@
+/*****************************************************************************
+* \file      apx_mpscQueue.c
+* \author    Conny Gustafsson
+* \date      2026-10-18
+* \brief     Bounded lock-free multi-producer/single-consumer queue
+*
+* Copyright (c) 2026 Conny Gustafsson
+* Permission is hereby granted, free of charge, to any person obtaining a copy of
+* this software and associated documentation files (the "Software"), to deal in
+* the Software without restriction, including without limitation the rights to
+* use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+* the Software, and to permit persons to whom the Software is furnished to do so,
+* subject to the following conditions:
+
+* The above copyright notice and this permission notice shall be included in all
+* copies or substantial portions of the Software.
+
+* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+* IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+* FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+* COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+* IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+* CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+*
+******************************************************************************/
+//////////////////////////////////////////////////////////////////////////////
+// INCLUDES
+//////////////////////////////////////////////////////////////////////////////
+#include <malloc.h>
+#include <string.h>
+#include <assert.h>
+#include "apx_mpscQueue.h"
+#include "apx_atomic.h"
+#ifndef _MSC_VER
+#include <errno.h>
+#include <time.h>
+#endif
+#ifdef MEM_LEAK_CHECK
+#include "CMemLeak.h"
+#endif
+
+//////////////////////////////////////////////////////////////////////////////
+// PRIVATE CONSTANTS AND DATA TYPES
+//////////////////////////////////////////////////////////////////////////////
+#define SLOT_HEADER_SIZE 8u //sequence number, padded so that element data keeps 8-byte alignment
+#define MAX_NUM_SLOTS 0x40000000u
+
+//////////////////////////////////////////////////////////////////////////////
+// PRIVATE FUNCTION PROTOTYPES
+//////////////////////////////////////////////////////////////////////////////
+static volatile uint32_t *apx_mpscQueue_getSlotSequence(apx_mpscQueue_t *self, uint32_t pos);
+static bool apx_mpscQueue_isReadable(apx_mpscQueue_t *self);
+static void apx_mpscQueue_signalConsumer(apx_mpscQueue_t *self);
+static bool apx_mpscQueue_waitSemaphore(apx_mpscQueue_t *self, uint32_t timeoutMs);
+
+//////////////////////////////////////////////////////////////////////////////
+// PRIVATE VARIABLES
+//////////////////////////////////////////////////////////////////////////////
+
+//////////////////////////////////////////////////////////////////////////////
+// PUBLIC FUNCTIONS
+//////////////////////////////////////////////////////////////////////////////
+/**
+ * Creates a queue for elements of size elemSize. The capacity is minNumElems rounded up to the nearest power of two.
+ */
+apx_error_t apx_mpscQueue_create(apx_mpscQueue_t *self, uint32_t elemSize, uint32_t minNumElems)
+{
+   if ( (self != 0) && (elemSize > 0u) && (minNumElems > 0u) && (minNumElems <= MAX_NUM_SLOTS) )
+   {
+      uint32_t i;
+      uint32_t numSlots = 1u;
+      while (numSlots < minNumElems)
+      {
+         numSlots <<= 1;
+      }
+      memset(self, 0, sizeof(apx_mpscQueue_t));
+      self->elemSize = elemSize;
+      self->slotSize = SLOT_HEADER_SIZE + ( (elemSize + 7u) & ~7u);
+      self->numSlots = numSlots;
+      self->mask = numSlots - 1u;
+      self->slots = (uint8_t*) malloc( (size_t) self->slotSize * numSlots);
+      if (self->slots == 0)
+      {
+         return APX_MEM_ERROR;
+      }
+      for (i = 0u; i < numSlots; i++)
+      {
+         *apx_mpscQueue_getSlotSequence(self, i) = i;
+      }
+      SEMAPHORE_CREATE(self->semaphore);
+      return APX_NO_ERROR;
+   }
+   return APX_INVALID_ARGUMENT_ERROR;
+}
+
+void apx_mpscQueue_destroy(apx_mpscQueue_t *self)
+{
+   if ( (self != 0) && (self->slots != 0) )
+   {
+      SEMAPHORE_DESTROY(self->semaphore);
+      free(self->slots);
+      self->slots = (uint8_t*) 0;
+   }
+}
+
+apx_mpscQueue_t *apx_mpscQueue_new(uint32_t elemSize, uint32_t minNumElems)
+{
+   apx_mpscQueue_t *self = (apx_mpscQueue_t*) malloc(sizeof(apx_mpscQueue_t));
+   if (self != 0)
+   {
+      apx_error_t result = apx_mpscQueue_create(self, elemSize, minNumElems);
+      if (result != APX_NO_ERROR)
+      {
+         free(self);
+         self = (apx_mpscQueue_t*) 0;
+      }
+   }
+   return self;
+}
+
+void apx_mpscQueue_delete(apx_mpscQueue_t *self)
+{
+   if (self != 0)
+   {
+      apx_mpscQueue_destroy(self);
+      free(self);
+   }
+}
+
+/**
+ * Copies elem into the queue. Safe to call from any number of threads.
+ * The semaphore is only posted when the consumer is parked (or about to park) in apx_mpscQueue_wait.
+ * Returns APX_BUFFER_FULL_ERROR when all slots are in use.
+ */
+apx_error_t apx_mpscQueue_push(apx_mpscQueue_t *self, const void *elem)
+{
+   if ( (self != 0) && (elem != 0) )
+   {
+      volatile uint32_t *sequence;
+      uint32_t pos = apx_atomic_load32(&self->enqueuePos);
+      for (;;)
+      {
+         int32_t diff;
+         sequence = apx_mpscQueue_getSlotSequence(self, pos);
+         diff = (int32_t) (apx_atomic_load32(sequence) - pos);
+         if (diff == 0)
+         {
+            if (apx_atomic_compareExchange32(&self->enqueuePos, pos, pos + 1u))
+            {
+               break;
+            }
+         }
+         else if (diff < 0)
+         {
+            return APX_BUFFER_FULL_ERROR;
+         }
+         pos = apx_atomic_load32(&self->enqueuePos);
+      }
+      memcpy( ( (uint8_t*) sequence) + SLOT_HEADER_SIZE, elem, self->elemSize);
+      apx_atomic_store32(sequence, pos + 1u);
+      apx_atomic_fence(); //orders the store above with the load of isConsumerParked
+      apx_mpscQueue_signalConsumer(self);
+      return APX_NO_ERROR;
+   }
+   return APX_INVALID_ARGUMENT_ERROR;
+}
+
+/**
+ * Removes the oldest element from the queue and copies it into elem. Must only be called from the consumer thread.
+ * Returns false when the queue is empty.
+ */
+bool apx_mpscQueue_pop(apx_mpscQueue_t *self, void *elem)
+{
+   if ( (self != 0) && (elem != 0) )
+   {
+      uint32_t pos = self->dequeuePos;
+      volatile uint32_t *sequence = apx_mpscQueue_getSlotSequence(self, pos);
+      if (apx_atomic_load32(sequence) == (pos + 1u))
+      {
+         memcpy(elem, ( (uint8_t*) sequence) + SLOT_HEADER_SIZE, self->elemSize);
+         apx_atomic_store32(sequence, pos + self->numSlots);
+         apx_atomic_store32(&self->dequeuePos, pos + 1u);
+         return true;
+      }
+   }
+   return false;
+}
+
+/**
+ * Blocks the consumer thread until an element is available, apx_mpscQueue_wakeup is called or timeoutMs expires.
+ * Use APX_MPSC_QUEUE_WAIT_INFINITE to wait without timeout. Must only be called from the consumer thread.
+ * Spurious returns are possible, callers must check the queue (and any exit condition) after this returns.
+ */
+void apx_mpscQueue_wait(apx_mpscQueue_t *self, uint32_t timeoutMs)
+{
+   if ( (self != 0) && (apx_atomic_exchange32(&self->isWakeupRequested, 0u) == 0u) )
+   {
+      apx_atomic_store32(&self->isConsumerParked, 1u);
+      apx_atomic_fence(); //orders the store above with the loads below, pairs with the fence in push/wakeup
+      if ( (apx_mpscQueue_isReadable(self) == false) && (apx_atomic_load32(&self->isWakeupRequested) == 0u) )
+      {
+         if (apx_mpscQueue_waitSemaphore(self, timeoutMs))
+         {
+            return;
+         }
+      }
+      if (apx_atomic_exchange32(&self->isConsumerParked, 0u) == 0u)
+      {
+         //A producer observed the parked flag and has posted (or is about to post) the semaphore. Consume that post now.
+         (void) apx_mpscQueue_waitSemaphore(self, APX_MPSC_QUEUE_WAIT_INFINITE);
+      }
+   }
+}
+
+/**
+ * Makes the current or next call to apx_mpscQueue_wait return immediately. Safe to call from any thread.
+ */
+void apx_mpscQueue_wakeup(apx_mpscQueue_t *self)
+{
+   if (self != 0)
+   {
+      apx_atomic_store32(&self->isWakeupRequested, 1u);
+      apx_atomic_fence();
+      apx_mpscQueue_signalConsumer(self);
+   }
+}
+
+/**
+ * Returns number of elements currently in the queue. The value is only a snapshot when producers are active.
+ */
+uint32_t apx_mpscQueue_length(apx_mpscQueue_t *self)
+{
+   if (self != 0)
+   {
+      uint32_t dequeuePos = apx_atomic_load32(&self->dequeuePos);
+      uint32_t enqueuePos = apx_atomic_load32(&self->enqueuePos);
+      uint32_t length = enqueuePos - dequeuePos;
+      return (length > self->numSlots)? self->numSlots : length;
+   }
+   return 0u;
+}
+
+uint32_t apx_mpscQueue_capacity(const apx_mpscQueue_t *self)
+{
+   if (self != 0)
+   {
+      return self->numSlots;
+   }
+   return 0u;
+}
+
+/**
+ * Returns number of times a producer had to post the semaphore in order to wake the consumer.
+ */
+uint32_t apx_mpscQueue_getNumWakeups(apx_mpscQueue_t *self)
+{
+   if (self != 0)
+   {
+      return apx_atomic_load32(&self->numWakeups);
+   }
+   return 0u;
+}
+
+//////////////////////////////////////////////////////////////////////////////
+// PRIVATE FUNCTIONS
+//////////////////////////////////////////////////////////////////////////////
+static volatile uint32_t *apx_mpscQueue_getSlotSequence(apx_mpscQueue_t *self, uint32_t pos)
+{
+   return (volatile uint32_t*) (self->slots + ( (size_t) (pos & self->mask) * self->slotSize) );
+}
+
+static bool apx_mpscQueue_isReadable(apx_mpscQueue_t *self)
+{
+   uint32_t pos = self->dequeuePos;
+   return (apx_atomic_load32(apx_mpscQueue_getSlotSequence(self, pos)) == (pos + 1u))? true : false;
+}
+
+/**
+ * Only the producer that manages to clear the parked flag posts the semaphore, all others return without a system call.
+ */
+static void apx_mpscQueue_signalConsumer(apx_mpscQueue_t *self)
+{
+   if ( (apx_atomic_load32(&self->isConsumerParked) != 0u) && (apx_atomic_exchange32(&self->isConsumerParked, 0u) != 0u) )
+   {
+      (void) apx_atomic_add32(&self->numWakeups, 1u);
+      SEMAPHORE_POST(self->semaphore);
+   }
+}
+
+static bool apx_mpscQueue_waitSemaphore(apx_mpscQueue_t *self, uint32_t timeoutMs)
+{
+#ifdef _MSC_VER
+   DWORD waitTime = (timeoutMs == APX_MPSC_QUEUE_WAIT_INFINITE)? INFINITE : (DWORD) timeoutMs;
+   return (WaitForSingleObject(self->semaphore, waitTime) == WAIT_OBJECT_0)? true : false;
+#else
+   int result;
+   if (timeoutMs == APX_MPSC_QUEUE_WAIT_INFINITE)
+   {
+      do
+      {
+         result = sem_wait(&self->semaphore);
+      } while ( (result != 0) && (errno == EINTR) );
+   }
+   else if (timeoutMs == 0u)
+   {
+      result = sem_trywait(&self->semaphore);
+   }
+   else
+   {
+      struct timespec ts;
+      clock_gettime(CLOCK_REALTIME, &ts);
+      ts.tv_sec += (time_t) (timeoutMs / 1000u);
+      ts.tv_nsec += (long) (timeoutMs % 1000u) * 1000000L;
+      if (ts.tv_nsec >= 1000000000L)
+      {
+         ts.tv_sec++;
+         ts.tv_nsec -= 1000000000L;
+      }
+      do
+      {
+         result = sem_timedwait(&self->semaphore, &ts);
+      } while ( (result != 0) && (errno == EINTR) );
+   }
+   return (result == 0)? true : false;
+#endif
+}
@@ -31,6 +31,7 @@
 #include <assert.h>
 #include "apx_nodeData.h"
 #include "apx_nodeInstance.h"
+#include "apx_sha256.h"
 #ifdef MEM_LEAK_CHECK
 #include "CMemLeak.h"
 #endif
@@ -305,6 +306,33 @@ apx_error_t apx_nodeData_setDefinitionChecksumData(apx_nodeData_t *self, uint8_t
    return retval;
 }
 
+/**
+ * Calculates the SHA-256 checksum of the definition data buffer and stores it as the definition checksum
+ */
+apx_error_t apx_nodeData_calcDefinitionChecksum(apx_nodeData_t *self)
+{
+   apx_error_t retval = APX_NO_ERROR;
+   if (self != 0)
+   {
+      apx_nodeData_lockDefinitionData(self);
+      if (self->definitionDataBuf != 0)
+      {
+         apx_sha256_calc(self->definitionDataBuf, (uint32_t) self->definitionDataLen, &self->definitionChecksumData[0]);
+         self->definitionChecksumType = APX_CHECKSUM_SHA256;
+      }
+      else
+      {
+         retval = APX_MISSING_BUFFER_ERROR;
+      }
+      apx_nodeData_unlockDefinitionData(self);
+   }
+   else
+   {
+      retval = APX_INVALID_ARGUMENT_ERROR;
+   }
+   return retval;
+}
+
 #ifndef APX_EMBEDDED
 apx_error_t apx_nodeData_createRequirePortBuffer(apx_nodeData_t *self, apx_size_t bufferLen)
 {
@@ -34,6 +34,7 @@
 #include "apx_parser.h"
 #include "apx_nodeInfo.h"
 #include "apx_vm.h"
+#include "apx_atomic.h"
 #include "bstr.h"
 #include <stdio.h> //DEBUG ONLY
 #ifdef MEM_LEAK_CHECK
@@ -43,22 +44,49 @@
 //////////////////////////////////////////////////////////////////////////////
 // PRIVATE CONSTANTS AND DATA TYPES
 //////////////////////////////////////////////////////////////////////////////
+#define PORT_NAME_INDEX_MIN_SLOTS 8u
+#define FNV_OFFSET_BASIS_32 0x811c9dc5u
+#define FNV_PRIME_32 0x01000193u
+
+typedef struct apx_portNameIndexSlot_tag
+{
+   uint32_t hash; //hash of the port name
+   apx_uniquePortId_t portId; //APX_INVALID_PORT_ID when slot is unused
+} apx_portNameIndexSlot_t;
+
+//Open addressing hash table with linear probing. Load factor is kept at or below 50%.
+typedef struct apx_portNameIndex_tag
+{
+   apx_portNameIndexSlot_t *slots;
+   uint32_t mask; //number of slots - 1
+} apx_portNameIndex_t;
 
 //////////////////////////////////////////////////////////////////////////////
 // PRIVATE FUNCTION PROTOTYPES
 //////////////////////////////////////////////////////////////////////////////
 static apx_error_t apx_nodeInfo_allocateMemory(apx_nodeInfo_t *self);
 static void apx_nodeInfo_freeMemory(apx_nodeInfo_t *self);
-static void apx_nodeInfo_createRequirePortDataProps(apx_nodeInfo_t *self);
-static void apx_nodeInfo_createProvidePortDataProps(apx_nodeInfo_t *self);
+static void apx_nodeInfo_createRequirePortDataProps(apx_nodeInfo_t *self, const apx_node_t *node);
+static void apx_nodeInfo_createProvidePortDataProps(apx_nodeInfo_t *self, const apx_node_t *node);
+static void apx_nodeInfo_applyDynArrayProps(apx_portDataProps_t *props, const adt_bytes_t *program, uint8_t programFlags);
+static void apx_nodeInfo_applyPortAttributes(apx_portDataProps_t *props, const apx_port_t *port);
 static apx_error_t apx_nodeInfo_initClientBytePortMap(apx_nodeInfo_t *self);
 static apx_error_t apx_nodeInfo_initServerBytePortMap(apx_nodeInfo_t *self);
 static apx_error_t apx_nodeInfo_compilePortPrograms(apx_nodeInfo_t *self, apx_compiler_t *compiler, const apx_node_t *node, apx_programType_t *errProgramType, apx_uniquePortId_t *errPortId);
+static apx_error_t apx_nodeInfo_lowerCopyPlans(apx_nodeInfo_t *self);
 static apx_error_t apx_nodeInfo_createRequirePortInitData(apx_nodeInfo_t *self, const apx_node_t *node);
 static apx_error_t apx_nodeInfo_createProvidePortInitData(apx_nodeInfo_t *self, const apx_node_t *node);
-static uint8_t* apx_nodeInfo_createInitDataBuf(apx_size_t dataSize, adt_bytes_t **packPrograms, const adt_ary_t *ports, apx_portCount_t numPorts, apx_error_t *errorCode);
+static uint8_t* apx_nodeInfo_createInitDataBuf(apx_size_t dataSize, adt_bytes_t **packPrograms, const apx_portDataProps_t *propsArray, const adt_ary_t *ports, apx_portCount_t numPorts, apx_error_t *errorCode);
 static apx_error_t apx_nodeInfo_buildRequirePortSignatures(apx_nodeInfo_t *self, const apx_node_t *node);
 static apx_error_t apx_nodeInfo_buildProvidePortSignatures(apx_nodeInfo_t *self, const apx_node_t *node);
+static const char *apx_nodeInfo_getPortSignature(const apx_nodeInfo_t *self, apx_uniquePortId_t portId);
+static bool apx_nodeInfo_matchPortName(const char *portSignature, const char *name);
+static uint32_t apx_nodeInfo_hashPortName(const char *pBegin, const char *pEnd);
+static apx_uniquePortId_t apx_nodeInfo_scanPortIdByName(const apx_nodeInfo_t *self, const char *name);
+static apx_portNameIndex_t *apx_nodeInfo_getPortNameIndex(const apx_nodeInfo_t *self);
+static apx_portNameIndex_t *apx_nodeInfo_buildPortNameIndex(const apx_nodeInfo_t *self);
+static void apx_nodeInfo_insertPortName(const apx_nodeInfo_t *self, apx_portNameIndex_t *index, apx_uniquePortId_t portId);
+static void apx_nodeInfo_deletePortNameIndex(apx_portNameIndex_t *index);
 
 //////////////////////////////////////////////////////////////////////////////
 // PUBLIC FUNCTIONS
@@ -86,6 +114,7 @@ apx_nodeInfo_t *apx_nodeInfo_new(void)
    if (self != 0)
    {
       apx_nodeInfo_create(self);
+      self->refCount = 1u;
    }
    return self;
 }
@@ -99,6 +128,33 @@ void apx_nodeInfo_delete(apx_nodeInfo_t *self)
    }
 }
 
+void apx_nodeInfo_retain(apx_nodeInfo_t *self)
+{
+   if (self != 0)
+   {
+      (void) apx_atomic_add32(&self->refCount, 1u);
+   }
+}
+
+/**
+ * Deletes the object once the last reference is released
+ */
+void apx_nodeInfo_release(apx_nodeInfo_t *self)
+{
+   if (self != 0)
+   {
+      if (apx_atomic_sub32(&self->refCount, 1u) == 0u)
+      {
+         apx_nodeInfo_delete(self);
+      }
+   }
+}
+
+void apx_nodeInfo_vrelease(void *arg)
+{
+   apx_nodeInfo_release((apx_nodeInfo_t*) arg);
+}
+
 apx_error_t apx_nodeInfo_build(apx_nodeInfo_t *self, const struct apx_node_tag *parseTree, apx_compiler_t *compiler, apx_mode_t mode, apx_programType_t *errProgramType, apx_uniquePortId_t *errPortId)
 {
    if ( (self != 0) && (parseTree != 0) && (compiler != 0) && ( (mode == APX_CLIENT_MODE) || (mode == APX_SERVER_MODE) ) )
@@ -125,11 +181,15 @@ apx_error_t apx_nodeInfo_build(apx_nodeInfo_t *self, const struct apx_node_tag *
          apx_nodeInfo_freeMemory(self);
          return errorCode;
       }
-      apx_nodeInfo_createRequirePortDataProps(self);
-      apx_nodeInfo_createProvidePortDataProps(self);
+      apx_nodeInfo_createRequirePortDataProps(self, parseTree);
+      apx_nodeInfo_createProvidePortDataProps(self, parseTree);
       if(mode == APX_CLIENT_MODE)
       {
          errorCode = apx_nodeInfo_initClientBytePortMap(self);
+         if (errorCode == APX_NO_ERROR)
+         {
+            errorCode = apx_nodeInfo_lowerCopyPlans(self);
+         }
       }
       else
       {
@@ -295,6 +355,30 @@ const adt_bytes_t* apx_nodeInfo_getProvidePortUnpackProgram(const apx_nodeInfo_t
    return (const adt_bytes_t*) 0;
 }
 
+/**
+ * Returns the cached copy plan for the provide port pack program or NULL if the program could not be lowered
+ */
+const apx_copyPlan_t* apx_nodeInfo_getProvidePortPackPlan(const apx_nodeInfo_t *self, apx_portId_t portId)
+{
+   if ( (self != 0) && (portId >= 0) && (portId < self->numProvidePorts) && (self->providePortPackPlans != 0) )
+   {
+      return self->providePortPackPlans[portId];
+   }
+   return (const apx_copyPlan_t*) 0;
+}
+
+/**
+ * Returns the cached copy plan for the require port unpack program or NULL if the program could not be lowered
+ */
+const apx_copyPlan_t* apx_nodeInfo_getRequirePortUnpackPlan(const apx_nodeInfo_t *self, apx_portId_t portId)
+{
+   if ( (self != 0) && (portId >= 0) && (portId < self->numRequirePorts) && (self->requirePortUnpackPlans != 0) )
+   {
+      return self->requirePortUnpackPlans[portId];
+   }
+   return (const apx_copyPlan_t*) 0;
+}
+
 apx_portId_t apx_nodeInfo_findProvidePortIdFromByteOffset(const apx_nodeInfo_t *self, apx_offset_t offset)
 {
    if ( (self != 0) && (offset >=0) && (self->serverBytePortMap != 0))
@@ -313,59 +397,32 @@ apx_portId_t apx_nodeInfo_findRequirePortIdFromByteOffset(const apx_nodeInfo_t *
    return (apx_portId_t) -1;
 }
 
+/**
+ * Returns the port ID of the port with the given name. Provide ports take precedence over require ports.
+ * The name index is built on first use, lookups after that cost one hash and (on average) one string compare.
+ */
 apx_uniquePortId_t apx_nodeInfo_findPortIdByName(const apx_nodeInfo_t *self, const char *name)
 {
-   if (self != 0)
+   if ( (self != 0) && (name != 0) )
    {
-      apx_portId_t portId;
-      if (self->numProvidePorts > 0)
-      {
-         assert(self->providePortSignatures != 0);
-         for(portId=0; portId < self->numProvidePorts; portId++)
-         {
-            const uint8_t *pMatch;
-            const uint8_t *pEnd;
-            const uint8_t *pNext;
-            pNext = (const uint8_t*) self->providePortSignatures[portId];
-            pEnd = pNext + strlen(self->providePortSignatures[portId]);
-            if (pNext < pEnd)
-            {
-               assert((char) (*pNext++) == '"');
-               pMatch = bstr_match_cstr(pNext, pEnd, name);
-               if (pMatch > pNext)
-               {
-                  if ((char) (*pMatch) == '"')
-                  {
-                     return (portId | APX_PORT_ID_PROVIDE_PORT);
-                  }
-               }
-            }
-         }
-      }
-      if (self->numRequirePorts > 0)
+      apx_portNameIndex_t *index = apx_nodeInfo_getPortNameIndex(self);
+      if (index != 0)
       {
-         assert(self->requirePortSignatures != 0);
-         for(portId=0; portId < self->numRequirePorts; portId++)
+         uint32_t hash = apx_nodeInfo_hashPortName(name, name + strlen(name));
+         uint32_t i = hash & index->mask;
+         while (index->slots[i].portId != APX_INVALID_PORT_ID)
          {
-            const uint8_t *pMatch;
-            const uint8_t *pEnd;
-            const uint8_t *pNext;
-            pNext = (const uint8_t*) self->requirePortSignatures[portId];
-            pEnd = pNext + strlen(self->requirePortSignatures[portId]);
-            if (pNext < pEnd)
+            if ( (index->slots[i].hash == hash) &&
+                  apx_nodeInfo_matchPortName(apx_nodeInfo_getPortSignature(self, index->slots[i].portId), name) )
             {
-               assert((char) (*pNext++) == '"');
-               pMatch = bstr_match_cstr(pNext, pEnd, name);
-               if (pMatch > pNext)
-               {
-                  if ((char) (*pMatch) == '"')
-                  {
-                     return (portId);
-                  }
-               }
+               return index->slots[i].portId;
             }
+            i = (i + 1u) & index->mask;
          }
+         return APX_INVALID_PORT_ID;
       }
+      //Index could not be allocated
+      return apx_nodeInfo_scanPortIdByName(self, name);
    }
    return APX_INVALID_PORT_ID;
 }
@@ -640,6 +697,26 @@ static void apx_nodeInfo_freeMemory(apx_nodeInfo_t *self)
          free(self->providePortUnpackPrograms);
          self->providePortUnpackPrograms = 0;
       }
+      if (self->providePortPackPlans != 0)
+      {
+         apx_portId_t portId;
+         for(portId = 0; portId<self->numProvidePorts; portId++)
+         {
+            apx_copyPlan_delete(self->providePortPackPlans[portId]);
+         }
+         free(self->providePortPackPlans);
+         self->providePortPackPlans = 0;
+      }
+      if (self->requirePortUnpackPlans != 0)
+      {
+         apx_portId_t portId;
+         for(portId = 0; portId<self->numRequirePorts; portId++)
+         {
+            apx_copyPlan_delete(self->requirePortUnpackPlans[portId]);
+         }
+         free(self->requirePortUnpackPlans);
+         self->requirePortUnpackPlans = 0;
+      }
       if (self->clientBytePortMap != 0)
       {
          apx_bytePortMap_delete(self->clientBytePortMap);
@@ -686,10 +763,15 @@ static void apx_nodeInfo_freeMemory(apx_nodeInfo_t *self)
          free(self->providePortSignatures);
          self->providePortSignatures = 0;
       }
+      if (self->portNameIndex != 0)
+      {
+         apx_nodeInfo_deletePortNameIndex(self->portNameIndex);
+         self->portNameIndex = (apx_portNameIndex_t*) 0;
+      }
    }
 }
 
-static void apx_nodeInfo_createRequirePortDataProps(apx_nodeInfo_t *self)
+static void apx_nodeInfo_createRequirePortDataProps(apx_nodeInfo_t *self, const apx_node_t *node)
 {
    if (self->numRequirePorts > 0)
    {
@@ -700,19 +782,20 @@ static void apx_nodeInfo_createRequirePortDataProps(apx_nodeInfo_t *self)
          apx_portDataProps_t *props = &self->requirePortDataProps[portId];
          apx_size_t dataSize = 0u;
          uint8_t programFlags = 0u;
-         //apx_port_t *port = apx_node_getRequirePort(node, portId);
          const adt_bytes_t *program = apx_nodeInfo_getRequirePortUnpackProgram(self, portId);
          assert(program != 0);
          apx_error_t rc = apx_vm_decodeProgramDataProps(program, &dataSize, &programFlags);
          assert(rc == APX_NO_ERROR);
          assert(dataSize > 0);
          apx_portDataProps_create(props, APX_REQUIRE_PORT, portId, offset, dataSize);
-         offset += dataSize;
+         apx_nodeInfo_applyDynArrayProps(props, program, programFlags);
+         apx_nodeInfo_applyPortAttributes(props, (const apx_port_t*) adt_ary_value(apx_node_getRequirePortList(node), portId));
+         offset += props->dataSize;
       }
    }
 }
 
-static void apx_nodeInfo_createProvidePortDataProps(apx_nodeInfo_t *self)
+static void apx_nodeInfo_createProvidePortDataProps(apx_nodeInfo_t *self, const apx_node_t *node)
 {
    if (self->numProvidePorts > 0)
    {
@@ -723,18 +806,47 @@ static void apx_nodeInfo_createProvidePortDataProps(apx_nodeInfo_t *self)
          apx_portDataProps_t *props = &self->providePortDataProps[portId];
          apx_size_t dataSize = 0u;
          uint8_t programFlags = 0u;
-         //apx_port_t *port = apx_node_getRequirePort(node, portId);
          const adt_bytes_t *program = apx_nodeInfo_getProvidePortPackProgram(self, portId);
          assert(program != 0);
          apx_error_t rc = apx_vm_decodeProgramDataProps(program, &dataSize, &programFlags);
          assert(rc == APX_NO_ERROR);
          assert(dataSize > 0u);
          apx_portDataProps_create(props, APX_PROVIDE_PORT, portId, offset, dataSize);
-         offset += dataSize;
+         apx_nodeInfo_applyDynArrayProps(props, program, programFlags);
+         apx_nodeInfo_applyPortAttributes(props, (const apx_port_t*) adt_ary_value(apx_node_getProvidePortList(node), portId));
+         offset += props->dataSize;
       }
    }
 }
 
+static void apx_nodeInfo_applyDynArrayProps(apx_portDataProps_t *props, const adt_bytes_t *program, uint8_t programFlags)
+{
+   if ( (programFlags & APX_VM_HEADER_FLAG_DYNAMIC) != 0u)
+   {
+      apx_dynLenType_t dynLenType = APX_DYN_LEN_NONE;
+      uint32_t maxArrayLen = 0u;
+      if (apx_vm_decodeDynArrayProps(program, &dynLenType, &maxArrayLen) == APX_NO_ERROR)
+      {
+         apx_portDataProps_setDynamicArray(props, dynLenType, maxArrayLen);
+      }
+   }
+}
+
+/**
+ * The port programs only describe a single element. Port attributes such as Q[N] decide how much room the port needs in the data file.
+ */
+static void apx_nodeInfo_applyPortAttributes(apx_portDataProps_t *props, const apx_port_t *port)
+{
+   if ( (port != 0) && (port->portAttributes != 0) )
+   {
+      if (port->portAttributes->isQueued)
+      {
+         apx_portDataProps_setQueued(props, (apx_size_t) port->portAttributes->queueLen);
+      }
+      props->isEvent = port->portAttributes->isEvent;
+   }
+}
+
 static apx_error_t apx_nodeInfo_initClientBytePortMap(apx_nodeInfo_t *self)
 {
    if (self != 0)
@@ -913,6 +1025,52 @@ static apx_error_t apx_nodeInfo_compilePortPrograms(apx_nodeInfo_t *self, apx_co
    return retval;
 }
 
+/**
+ * Lowers flat provide port pack programs and require port unpack programs into copy plans.
+ * Ports having programs that cannot be lowered get a NULL entry.
+ */
+static apx_error_t apx_nodeInfo_lowerCopyPlans(apx_nodeInfo_t *self)
+{
+   apx_portId_t portId;
+   if (self->numProvidePorts > 0)
+   {
+      size_t numBytes = sizeof(apx_copyPlan_t*) * self->numProvidePorts;
+      self->providePortPackPlans = (apx_copyPlan_t**) malloc(numBytes);
+      if (self->providePortPackPlans == 0)
+      {
+         return APX_MEM_ERROR;
+      }
+      memset(self->providePortPackPlans, 0, numBytes);
+      for(portId = 0; portId < self->numProvidePorts; portId++)
+      {
+         apx_error_t rc = apx_compiler_lowerToCopyPlan(self->providePortPackPrograms[portId], &self->providePortPackPlans[portId]);
+         if (rc == APX_MEM_ERROR)
+         {
+            return rc;
+         }
+      }
+   }
+   if (self->numRequirePorts > 0)
+   {
+      size_t numBytes = sizeof(apx_copyPlan_t*) * self->numRequirePorts;
+      self->requirePortUnpackPlans = (apx_copyPlan_t**) malloc(numBytes);
+      if (self->requirePortUnpackPlans == 0)
+      {
+         return APX_MEM_ERROR;
+      }
+      memset(self->requirePortUnpackPlans, 0, numBytes);
+      for(portId = 0; portId < self->numRequirePorts; portId++)
+      {
+         apx_error_t rc = apx_compiler_lowerToCopyPlan(self->requirePortUnpackPrograms[portId], &self->requirePortUnpackPlans[portId]);
+         if (rc == APX_MEM_ERROR)
+         {
+            return rc;
+         }
+      }
+   }
+   return APX_NO_ERROR;
+}
+
 static apx_error_t apx_nodeInfo_createRequirePortInitData(apx_nodeInfo_t *self, const apx_node_t *node)
 {
    apx_size_t dataSize;
@@ -926,7 +1084,7 @@ static apx_error_t apx_nodeInfo_createRequirePortInitData(apx_nodeInfo_t *self,
    if (dataSize > 0)
    {
       apx_error_t errorCode = APX_NO_ERROR;
-      uint8_t *initData = apx_nodeInfo_createInitDataBuf(dataSize, self->requirePortPackPrograms, apx_node_getRequirePortList(node), self->numRequirePorts, &errorCode);
+      uint8_t *initData = apx_nodeInfo_createInitDataBuf(dataSize, self->requirePortPackPrograms, self->requirePortDataProps, apx_node_getRequirePortList(node), self->numRequirePorts, &errorCode);
       if (initData == 0)
       {
          return errorCode;
@@ -954,7 +1112,7 @@ static apx_error_t apx_nodeInfo_createProvidePortInitData(apx_nodeInfo_t *self,
    if (dataSize > 0)
    {
       apx_error_t errorCode = APX_NO_ERROR;
-      uint8_t *initData = apx_nodeInfo_createInitDataBuf(dataSize, self->providePortPackPrograms, apx_node_getProvidePortList(node), self->numProvidePorts, &errorCode);
+      uint8_t *initData = apx_nodeInfo_createInitDataBuf(dataSize, self->providePortPackPrograms, self->providePortDataProps, apx_node_getProvidePortList(node), self->numProvidePorts, &errorCode);
       if (initData == 0)
       {
          return errorCode;
@@ -969,11 +1127,15 @@ static apx_error_t apx_nodeInfo_createProvidePortInitData(apx_nodeInfo_t *self,
    return APX_NO_ERROR;
 }
 
-static uint8_t* apx_nodeInfo_createInitDataBuf(apx_size_t dataSize, adt_bytes_t **packPrograms, const adt_ary_t *ports, apx_portCount_t numPorts, apx_error_t *errorCode)
+/**
+ * Queued ports start out empty, their length header and element slots are all zero.
+ */
+static uint8_t* apx_nodeInfo_createInitDataBuf(apx_size_t dataSize, adt_bytes_t **packPrograms, const apx_portDataProps_t *propsArray, const adt_ary_t *ports, apx_portCount_t numPorts, apx_error_t *errorCode)
 {
    uint8_t *initData;
    assert(dataSize > 0);
    assert(packPrograms != 0);
+   assert(propsArray != 0);
    assert(ports != 0);
    assert(numPorts > 0);
    assert(errorCode != 0);
@@ -989,16 +1151,22 @@ static uint8_t* apx_nodeInfo_createInitDataBuf(apx_size_t dataSize, adt_bytes_t
       apx_error_t result;
       apx_vm_t vm;
       apx_vm_create(&vm);
-      result = apx_vm_setWriteBuffer(&vm, initData, (uint32_t) dataSize);
-      if (result == APX_NO_ERROR)
+      memset(initData, 0, dataSize);
+      result = APX_NO_ERROR;
+      for(portId = 0; portId < numPorts; portId++)
       {
-         for(portId = 0; portId < numPorts; portId++)
+         const apx_portDataProps_t *props = &propsArray[portId];
+         if (!apx_portDataProps_isQueued(props))
          {
             dtl_dv_t *properInitValue;
             apx_port_t *port = (apx_port_t*) adt_ary_value(ports, portId);
             assert(port != 0);
             properInitValue = apx_port_getProperInitValue(port);
-            result = apx_vm_selectProgram(&vm, packPrograms[portId]);
+            result = apx_vm_setWriteBuffer(&vm, &initData[props->offset], (uint32_t) props->dataSize);
+            if (result == APX_NO_ERROR)
+            {
+               result = apx_vm_selectProgram(&vm, packPrograms[portId]);
+            }
             if (result == APX_NO_ERROR)
             {
                if (properInitValue != 0)
@@ -1106,3 +1274,176 @@ static apx_error_t apx_nodeInfo_buildProvidePortSignatures(apx_nodeInfo_t *self,
    }
    return APX_INVALID_ARGUMENT_ERROR;
 }
+
+static const char *apx_nodeInfo_getPortSignature(const apx_nodeInfo_t *self, apx_uniquePortId_t portId)
+{
+   if ( (portId & APX_PORT_ID_PROVIDE_PORT) != 0u)
+   {
+      return self->providePortSignatures[portId & APX_PORT_ID_MASK];
+   }
+   return self->requirePortSignatures[portId];
+}
+
+/**
+ * Returns true when the port name (the quoted part at the beginning of portSignature) equals name
+ */
+static bool apx_nodeInfo_matchPortName(const char *portSignature, const char *name)
+{
+   const uint8_t *pNext = (const uint8_t*) portSignature;
+   const uint8_t *pEnd = pNext + strlen(portSignature);
+   if (pNext < pEnd)
+   {
+      const uint8_t *pMatch;
+      assert((char) (*pNext) == '"');
+      pNext++;
+      pMatch = bstr_match_cstr(pNext, pEnd, name);
+      if ( (pMatch > pNext) && ((char) (*pMatch) == '"') )
+      {
+         return true;
+      }
+   }
+   return false;
+}
+
+static uint32_t apx_nodeInfo_hashPortName(const char *pBegin, const char *pEnd)
+{
+   uint32_t hash = FNV_OFFSET_BASIS_32;
+   const uint8_t *pNext = (const uint8_t*) pBegin;
+   while (pNext < (const uint8_t*) pEnd)
+   {
+      hash ^= (uint32_t) *pNext++;
+      hash *= FNV_PRIME_32;
+   }
+   return hash;
+}
+
+/**
+ * Linear search, only used when memory for the name index could not be allocated
+ */
+static apx_uniquePortId_t apx_nodeInfo_scanPortIdByName(const apx_nodeInfo_t *self, const char *name)
+{
+   apx_portId_t portId;
+   for(portId=0; portId < self->numProvidePorts; portId++)
+   {
+      if (apx_nodeInfo_matchPortName(self->providePortSignatures[portId], name))
+      {
+         return (portId | APX_PORT_ID_PROVIDE_PORT);
+      }
+   }
+   for(portId=0; portId < self->numRequirePorts; portId++)
+   {
+      if (apx_nodeInfo_matchPortName(self->requirePortSignatures[portId], name))
+      {
+         return (apx_uniquePortId_t) portId;
+      }
+   }
+   return APX_INVALID_PORT_ID;
+}
+
+/**
+ * Returns the name index, building it if needed. Threads racing to build the index each build their own copy,
+ * only the first one to finish gets published.
+ */
+static apx_portNameIndex_t *apx_nodeInfo_getPortNameIndex(const apx_nodeInfo_t *self)
+{
+   void * volatile *ppIndex = (void * volatile *) &((apx_nodeInfo_t*) self)->portNameIndex;
+   apx_portNameIndex_t *index = (apx_portNameIndex_t*) apx_atomic_loadPtr(ppIndex);
+   if (index == 0)
+   {
+      index = apx_nodeInfo_buildPortNameIndex(self);
+      if (index != 0)
+      {
+         if (!apx_atomic_compareExchangePtr(ppIndex, (void*) 0, (void*) index))
+         {
+            apx_nodeInfo_deletePortNameIndex(index);
+            index = (apx_portNameIndex_t*) apx_atomic_loadPtr(ppIndex);
+         }
+      }
+   }
+   return index;
+}
+
+static apx_portNameIndex_t *apx_nodeInfo_buildPortNameIndex(const apx_nodeInfo_t *self)
+{
+   apx_portNameIndex_t *index;
+   uint32_t numPorts = (uint32_t) self->numProvidePorts + (uint32_t) self->numRequirePorts;
+   uint32_t numSlots = PORT_NAME_INDEX_MIN_SLOTS;
+   uint32_t i;
+   apx_portId_t portId;
+   while (numSlots < (numPorts * 2u))
+   {
+      numSlots <<= 1;
+   }
+   index = (apx_portNameIndex_t*) malloc(sizeof(apx_portNameIndex_t));
+   if (index == 0)
+   {
+      return index;
+   }
+   index->slots = (apx_portNameIndexSlot_t*) malloc(numSlots * sizeof(apx_portNameIndexSlot_t));
+   if (index->slots == 0)
+   {
+      free(index);
+      return (apx_portNameIndex_t*) 0;
+   }
+   index->mask = numSlots - 1u;
+   for (i = 0u; i < numSlots; i++)
+   {
+      index->slots[i].hash = 0u;
+      index->slots[i].portId = APX_INVALID_PORT_ID;
+   }
+   //Provide ports are inserted first so they take precedence over require ports with the same name
+   for(portId=0; portId < self->numProvidePorts; portId++)
+   {
+      apx_nodeInfo_insertPortName(self, index, ((apx_uniquePortId_t) portId) | APX_PORT_ID_PROVIDE_PORT);
+   }
+   for(portId=0; portId < self->numRequirePorts; portId++)
+   {
+      apx_nodeInfo_insertPortName(self, index, (apx_uniquePortId_t) portId);
+   }
+   return index;
+}
+
+/**
+ * Inserts portId unless a port with the same name has already been inserted
+ */
+static void apx_nodeInfo_insertPortName(const apx_nodeInfo_t *self, apx_portNameIndex_t *index, apx_uniquePortId_t portId)
+{
+   const char *pBegin = apx_nodeInfo_getPortSignature(self, portId);
+   const char *pEnd;
+   size_t nameLen;
+   uint32_t hash;
+   uint32_t i;
+   assert(pBegin[0] == '"');
+   pBegin++;
+   pEnd = strchr(pBegin, '"');
+   if (pEnd == 0)
+   {
+      return;
+   }
+   nameLen = (size_t) (pEnd - pBegin);
+   hash = apx_nodeInfo_hashPortName(pBegin, pEnd);
+   i = hash & index->mask;
+   while (index->slots[i].portId != APX_INVALID_PORT_ID)
+   {
+      if (index->slots[i].hash == hash)
+      {
+         const char *other = apx_nodeInfo_getPortSignature(self, index->slots[i].portId) + 1;
+         if ( (strncmp(other, pBegin, nameLen) == 0) && (other[nameLen] == '"') )
+         {
+            return;
+         }
+      }
+      i = (i + 1u) & index->mask;
+   }
+   index->slots[i].hash = hash;
+   index->slots[i].portId = portId;
+}
+
+static void apx_nodeInfo_deletePortNameIndex(apx_portNameIndex_t *index)
+{
+   if (index != 0)
+   {
+      free(index->slots);
+      free(index);
+   }
+}
@@ -32,6 +32,8 @@
 #include "apx_nodeInstance.h"
 #include "apx_connectionBase.h"
 #include "apx_util.h"
+#include "apx_atomic.h"
+#include "apx_lz.h"
 #include "rmf.h"
 
 #ifdef MEM_LEAK_CHECK
@@ -43,6 +45,12 @@
 // PRIVATE CONSTANTS AND DATA TYPES
 //////////////////////////////////////////////////////////////////////////////
 #define STACK_DATA_BUF_SIZE 256
+#define STACK_ROUTING_WRITES_SIZE 64
+#define STACK_DIRTY_PORT_IDS_SIZE 64
+#define ROUTING_PLAN_RETIRE_MAX_SLEEP_MS 8u
+#define DIRTY_FLAG_WORD_SHIFT 5u
+#define DIRTY_FLAG_BIT_MASK 31u
+#define DIRTY_FLAG_WORDS(numPorts) ( ( (uint32_t) (numPorts) + DIRTY_FLAG_BIT_MASK) >> DIRTY_FLAG_WORD_SHIFT)
 
 typedef apx_portDataProps_t* (apx_getPortDataPropsFunc)(const apx_nodeInfo_t *self, apx_portId_t portId);
 
@@ -52,13 +60,39 @@ typedef apx_portDataProps_t* (apx_getPortDataPropsFunc)(const apx_nodeInfo_t *se
 static apx_error_t apx_nodeInstance_definitionFileWriteNotify(void *arg, apx_file_t *file, uint32_t offset, const uint8_t *src, uint32_t len);
 static apx_error_t apx_nodeInstance_definitionFileOpenNotify(void *arg, struct apx_file_tag *file);
 static apx_error_t apx_nodeInstance_definitionFileReadData(void *arg, apx_file_t*file, uint32_t offset, uint8_t *dest, uint32_t len);
-static apx_error_t apx_nodeInstance_createFileInfo(apx_nodeInstance_t *self, const char *fileExtension, uint32_t fileSize, apx_fileInfo_t *fileInfo);
+static apx_error_t apx_nodeInstance_createFileInfo(apx_nodeInstance_t *self, const char *fileExtension, uint32_t fileSize, uint16_t fileType, apx_fileInfo_t *fileInfo);
+static apx_error_t apx_nodeInstance_compressDefinitionData(apx_nodeInstance_t *self);
 static apx_error_t apx_nodeInstance_providePortDataFileWriteNotify(void *arg, apx_file_t *file, uint32_t offset, const uint8_t *src, uint32_t len);
 static apx_error_t apx_nodeInstance_providePortDataFileOpenNotify(void *arg, struct apx_file_tag *file);
 static apx_error_t apx_nodeInstance_requirePortDataFileWriteNotify(void *arg, apx_file_t *file, uint32_t offset, const uint8_t *src, uint32_t len);
 static apx_error_t apx_nodeInstance_requirePortDataFileOpenNotify(void *arg, struct apx_file_tag *file);
+static apx_error_t apx_nodeInstance_requirePortDataFileTakeDirtyRanges(void *arg, apx_file_t *file, apx_byteRangeSet_t *ranges);
+static apx_error_t apx_nodeInstance_requirePortDataFileReadData(void *arg, apx_file_t *file, uint32_t offset, uint8_t *dest, uint32_t len);
+static apx_error_t apx_nodeInstance_requirePortDataFileMarkDirty(void *arg, apx_file_t *file, uint32_t offset, uint32_t len);
 static void apx_nodeInstance_initPortRefs(apx_nodeInstance_t *self, apx_portRef_t *portRefs, apx_portCount_t numPorts, uint32_t portIdMask, apx_getPortDataPropsFunc *getPortDataProps);
 static apx_error_t apx_nodeInstance_routeProvidePortDataToRequirePortByRef(apx_portRef_t *providePortRef, apx_portRef_t *requirePortRef);
+static apx_error_t apx_nodeInstance_rebuildRoutingPlan(apx_nodeInstance_t *self, apx_routingPlan_t **retiredRoutingPlan, uint32_t *retiredEpoch);
+static void apx_nodeInstance_deleteRetiredRoutingPlan(apx_nodeInstance_t *self, apx_routingPlan_t *retiredRoutingPlan, uint32_t retiredEpoch);
+static apx_routingPlan_t *apx_nodeInstance_acquireRoutingPlan(apx_nodeInstance_t *self, apx_size_t len, uint32_t *epoch);
+static void apx_nodeInstance_releaseRoutingPlan(apx_nodeInstance_t *self, uint32_t epoch, uint32_t numRoutedWrites, uint32_t numTransmittedWrites, uint64_t numRoutedBytes);
+static apx_error_t apx_nodeInstance_sendRequirePortData(apx_nodeInstance_t *self, uint32_t offset, uint32_t len);
+static bool apx_nodeInstance_isRemoteReceiver(apx_nodeInstance_t *self);
+static bool apx_nodeInstance_isConflatedReceiver(apx_nodeInstance_t *self);
+static apx_portId_t apx_nodeInstance_findRequirePortByOffset(apx_nodeInstance_t *self, uint32_t offset);
+static apx_error_t apx_nodeInstance_conflateRequirePortData(apx_nodeInstance_t *self, uint32_t offset, uint32_t len);
+static apx_error_t apx_nodeInstance_requestConflatedTransfer(apx_nodeInstance_t *self);
+static apx_portId_t apx_nodeInstance_findPortByOffset(apx_nodeInstance_t *self, apx_getPortDataPropsFunc *getPortDataProps, apx_portCount_t numPorts, uint32_t offset);
+static apx_portQueue_t **apx_nodeInstance_createPortQueues(apx_nodeInstance_t *self, apx_getPortDataPropsFunc *getPortDataProps, apx_portCount_t numPorts, apx_error_t *errorCode);
+static void apx_nodeInstance_deletePortQueues(apx_portQueue_t **portQueues, apx_portCount_t numPorts);
+static apx_error_t apx_nodeInstance_scheduleQueuedTransfer(apx_nodeInstance_t *self, apx_portQueue_t *queue, apx_file_t *file, const apx_portDataProps_t *props, apx_fileQueueHandler_t *handler);
+static apx_error_t apx_nodeInstance_flushPortQueues(apx_nodeInstance_t *self, apx_portQueue_t **portQueues, apx_getPortDataPropsFunc *getPortDataProps, apx_portCount_t numPorts, apx_file_t *file, apx_fileQueueHandler_t *handler);
+static apx_error_t apx_nodeInstance_enqueueReceivedElements(apx_nodeInstance_t *self, const uint8_t *src, uint32_t offset, uint32_t len);
+static apx_error_t apx_nodeInstance_enqueueRoutedElements(apx_nodeInstance_t *self, apx_portId_t requirePortId, const uint8_t *src, uint32_t len);
+static uint32_t apx_nodeInstance_providePortQueueBeginTransfer(void *arg, apx_file_t *file, uint32_t offset);
+static apx_error_t apx_nodeInstance_providePortQueueReadData(void *arg, apx_file_t *file, uint32_t offset, uint8_t *dest, uint32_t len);
+static uint32_t apx_nodeInstance_requirePortQueueBeginTransfer(void *arg, apx_file_t *file, uint32_t offset);
+static apx_error_t apx_nodeInstance_requirePortQueueReadData(void *arg, apx_file_t *file, uint32_t offset, uint8_t *dest, uint32_t len);
+static void apx_nodeInstance_restoreProvidePortDirtyRanges(apx_nodeInstance_t *self, apx_byteRangeSet_t *ranges, uint32_t firstUnsent);
 
 
 //////////////////////////////////////////////////////////////////////////////
@@ -77,7 +111,19 @@ void apx_nodeInstance_create(apx_nodeInstance_t *self, apx_mode_t mode)
       self->mode = mode;
       self->requirePortDataState = APX_REQUIRE_PORT_DATA_STATE_INIT;
       self->providePortDataState = APX_PROVIDE_PORT_DATE_STATE_INIT;
+      self->requirePortConflationHandler.arg = (void*) self;
+      self->requirePortConflationHandler.takeDirtyRanges = apx_nodeInstance_requirePortDataFileTakeDirtyRanges;
+      self->requirePortConflationHandler.readData = apx_nodeInstance_requirePortDataFileReadData;
+      self->requirePortConflationHandler.markDirty = apx_nodeInstance_requirePortDataFileMarkDirty;
+      self->providePortQueueHandler.arg = (void*) self;
+      self->providePortQueueHandler.beginTransfer = apx_nodeInstance_providePortQueueBeginTransfer;
+      self->providePortQueueHandler.readData = apx_nodeInstance_providePortQueueReadData;
+      self->requirePortQueueHandler.arg = (void*) self;
+      self->requirePortQueueHandler.beginTransfer = apx_nodeInstance_requirePortQueueBeginTransfer;
+      self->requirePortQueueHandler.readData = apx_nodeInstance_requirePortQueueReadData;
       MUTEX_INIT(self->connectorTableLock);
+      SPINLOCK_INIT(self->providePortDirtyLock);
+      MUTEX_INIT(self->providePortFlushLock);
    }
 }
 
@@ -105,9 +151,19 @@ void apx_nodeInstance_destroy(apx_nodeInstance_t *self)
          self->connectorTable = (apx_portConnectorList_t*) 0;
          MUTEX_UNLOCK(self->connectorTableLock);
       }
+      if (self->providePortQueues != 0)
+      {
+         assert(self->nodeInfo != 0);
+         apx_nodeInstance_deletePortQueues(self->providePortQueues, apx_nodeInfo_getNumProvidePorts(self->nodeInfo));
+      }
+      if (self->requirePortQueues != 0)
+      {
+         assert(self->nodeInfo != 0);
+         apx_nodeInstance_deletePortQueues(self->requirePortQueues, apx_nodeInfo_getNumRequirePorts(self->nodeInfo));
+      }
       if (self->nodeInfo != 0)
       {
-         apx_nodeInfo_delete(self->nodeInfo);
+         apx_nodeInfo_release(self->nodeInfo);
       }
       if (self->nodeData != 0)
       {
@@ -131,7 +187,25 @@ void apx_nodeInstance_destroy(apx_nodeInstance_t *self)
       {
          apx_portConnectorChangeTable_delete(self->providePortChanges);
       }
+      if (self->providePortDirtyRanges != 0)
+      {
+         apx_byteRangeSet_delete(self->providePortDirtyRanges);
+      }
+      if (self->requirePortDirtyFlags != 0)
+      {
+         free((void*) self->requirePortDirtyFlags);
+      }
+      if (self->routingPlan != 0)
+      {
+         apx_routingPlan_delete(self->routingPlan);
+      }
+      if (self->compressedDefinitionData != 0)
+      {
+         free(self->compressedDefinitionData);
+      }
       MUTEX_DESTROY(self->connectorTableLock);
+      SPINLOCK_DESTROY(self->providePortDirtyLock);
+      MUTEX_DESTROY(self->providePortFlushLock);
    }
 }
 
@@ -300,6 +374,14 @@ apx_error_t apx_nodeInstance_createPortDataBuffers(apx_nodeInstance_t *self)
             }
          }
       }
+      if ( (retval == APX_NO_ERROR) && (self->mode == APX_CLIENT_MODE) && (self->providePortQueues == 0) )
+      {
+         self->providePortQueues = apx_nodeInstance_createPortQueues(self, apx_nodeInfo_getProvidePortDataProps, apx_nodeInfo_getNumProvidePorts(nodeInfo), &retval);
+      }
+      if ( (retval == APX_NO_ERROR) && (self->requirePortQueues == 0) )
+      {
+         self->requirePortQueues = apx_nodeInstance_createPortQueues(self, apx_nodeInfo_getRequirePortDataProps, apx_nodeInfo_getNumRequirePorts(nodeInfo), &retval);
+      }
       return retval;
    }
    return APX_INVALID_ARGUMENT_ERROR;
@@ -361,7 +443,7 @@ apx_error_t apx_nodeInstance_buildNodeInfo(apx_nodeInstance_t *self, apx_program
          apx_compiler_destroy(&compiler);
          if (rc != APX_NO_ERROR)
          {
-            apx_nodeInfo_delete(self->nodeInfo);
+            apx_nodeInfo_release(self->nodeInfo);
             self->nodeInfo = 0;
          }
          return rc;
@@ -371,6 +453,29 @@ apx_error_t apx_nodeInstance_buildNodeInfo(apx_nodeInstance_t *self, apx_program
    return APX_INVALID_ARGUMENT_ERROR;
 }
 
+/**
+ * Uses an already built (and possibly shared) nodeInfo instead of calling apx_nodeInstance_buildNodeInfo.
+ * A new reference to nodeInfo is taken, the caller keeps its own reference.
+ */
+apx_error_t apx_nodeInstance_attachNodeInfo(apx_nodeInstance_t *self, apx_nodeInfo_t *nodeInfo)
+{
+   if ( (self != 0) && (nodeInfo != 0) )
+   {
+      if (self->nodeInfo != 0)
+      {
+         return APX_INVALID_STATE_ERROR;
+      }
+      if (nodeInfo->mode != self->mode)
+      {
+         return APX_INVALID_ARGUMENT_ERROR;
+      }
+      apx_nodeInfo_retain(nodeInfo);
+      self->nodeInfo = nodeInfo;
+      return APX_NO_ERROR;
+   }
+   return APX_INVALID_ARGUMENT_ERROR;
+}
+
 apx_nodeInfo_t *apx_nodeInstane_getNodeInfo(apx_nodeInstance_t *self)
 {
    if (self != 0)
@@ -409,6 +514,13 @@ apx_error_t apx_nodeInstance_buildPortRefs(apx_nodeInstance_t *self)
          {
             apx_nodeInstance_initPortRefs(self, self->requirePortReferences, numRequirePorts, 0u, apx_nodeInfo_getRequirePortDataProps);
          }
+         self->requirePortDirtyFlags = (volatile uint32_t*) calloc(DIRTY_FLAG_WORDS(numRequirePorts), sizeof(uint32_t));
+         if (self->requirePortDirtyFlags == 0)
+         {
+            free(self->requirePortReferences);
+            self->requirePortReferences = (apx_portRef_t*) 0;
+            return APX_MEM_ERROR;
+         }
       }
       if (numProvidePorts > 0)
       {
@@ -421,6 +533,11 @@ apx_error_t apx_nodeInstance_buildPortRefs(apx_nodeInstance_t *self)
                free(self->requirePortReferences);
                self->requirePortReferences = (apx_portRef_t*) 0;
             }
+            if (self->requirePortDirtyFlags != 0)
+            {
+               free((void*) self->requirePortDirtyFlags);
+               self->requirePortDirtyFlags = (volatile uint32_t*) 0;
+            }
             return APX_MEM_ERROR;
          }
          else
@@ -584,14 +701,18 @@ apx_error_t apx_nodeInstance_fillProvidePortDataFileInfo(apx_nodeInstance_t *sel
          uint32_t fileSize;
          fileSize = (uint32_t) apx_nodeInfo_getProvidePortInitDataSize(self->nodeInfo);
          assert(fileSize > 0);
-         return apx_nodeInstance_createFileInfo(self, APX_OUTDATA_FILE_EXT, fileSize, fileInfo);
+         return apx_nodeInstance_createFileInfo(self, APX_OUTDATA_FILE_EXT, fileSize, RMF_FILE_TYPE_FIXED, fileInfo);
       }
       return APX_NULL_PTR_ERROR;
    }
    return APX_INVALID_ARGUMENT_ERROR;
 }
 
-apx_error_t apx_nodeInstance_fillDefinitionFileInfo(apx_nodeInstance_t *self, apx_fileInfo_t *fileInfo)
+/**
+ * When compressionType is RMF_COMPRESSION_LZ4 the definition is announced as a RMF_FILE_TYPE_COMPRESSED_FIXED file,
+ * unless it is too small or does not get any smaller by compression.
+ */
+apx_error_t apx_nodeInstance_fillDefinitionFileInfo(apx_nodeInstance_t *self, apx_fileInfo_t *fileInfo, uint16_t compressionType)
 {
    if ( (self != 0) && (fileInfo != 0))
    {
@@ -600,7 +721,25 @@ apx_error_t apx_nodeInstance_fillDefinitionFileInfo(apx_nodeInstance_t *self, ap
          uint32_t fileSize;
          fileSize = (uint32_t) apx_nodeData_getDefinitionDataLen(self->nodeData);
          assert(fileSize > 0);
-         return apx_nodeInstance_createFileInfo(self, APX_DEFINITION_FILE_EXT, fileSize, fileInfo);
+         if ( (compressionType == RMF_COMPRESSION_LZ4) && (fileSize >= APX_DEFINITION_COMPRESSION_MIN_SIZE) )
+         {
+            apx_error_t result = apx_nodeInstance_compressDefinitionData(self);
+            if (result == APX_NO_ERROR)
+            {
+               result = apx_nodeInstance_createFileInfo(self, APX_DEFINITION_FILE_EXT, (uint32_t) self->compressedDefinitionDataLen, RMF_FILE_TYPE_COMPRESSED_FIXED, fileInfo);
+               if (result == APX_NO_ERROR)
+               {
+                  apx_fileInfo_setCompression(fileInfo, compressionType, fileSize);
+               }
+               return result;
+            }
+            else if (result != APX_BUFFER_FULL_ERROR)
+            {
+               return result;
+            }
+            //Not compressible, send it as it is
+         }
+         return apx_nodeInstance_createFileInfo(self, APX_DEFINITION_FILE_EXT, fileSize, RMF_FILE_TYPE_FIXED, fileInfo);
       }
       return APX_NULL_PTR_ERROR;
    }
@@ -807,6 +946,209 @@ apx_error_t apx_nodeInstance_readProvidePortData(apx_nodeInstance_t *self, uint8
    return APX_INVALID_ARGUMENT_ERROR;
 }
 
+/**
+ * Updates ProvidePortData in this node instance without forwarding it to the remote side.
+ * The written byte range is remembered until apx_nodeInstance_flushProvidePortData is called.
+ * May be called while another thread flushes earlier writes, the range then ends up in the next flush.
+ */
+apx_error_t apx_nodeInstance_writeProvidePortDataDeferred(apx_nodeInstance_t *self, const uint8_t *src, uint32_t offset, apx_size_t len)
+{
+   if ( (self != 0) && (src != 0) )
+   {
+      if (self->nodeData != 0)
+      {
+         apx_byteRangeSet_t *newRanges = (apx_byteRangeSet_t*) 0;
+         apx_error_t rc = apx_nodeData_writeProvidePortData(self->nodeData, src, offset, len);
+         if (rc != APX_NO_ERROR)
+         {
+            return rc;
+         }
+         for (;;)
+         {
+            SPINLOCK_ENTER(self->providePortDirtyLock);
+            if ( (self->providePortDirtyRanges == 0) && (newRanges != 0) )
+            {
+               self->providePortDirtyRanges = newRanges;
+               newRanges = (apx_byteRangeSet_t*) 0;
+            }
+            if (self->providePortDirtyRanges != 0)
+            {
+               rc = apx_byteRangeSet_insert(self->providePortDirtyRanges, offset, len);
+               SPINLOCK_LEAVE(self->providePortDirtyLock);
+               break;
+            }
+            SPINLOCK_LEAVE(self->providePortDirtyLock);
+            //The set is allocated without holding the lock, then installed on the next iteration
+            newRanges = apx_byteRangeSet_new(APX_PROVIDE_PORT_DATA_MERGE_GAP);
+            if (newRanges == 0)
+            {
+               return APX_MEM_ERROR;
+            }
+         }
+         if (newRanges != 0)
+         {
+            apx_byteRangeSet_delete(newRanges);
+         }
+         return rc;
+      }
+   }
+   return APX_INVALID_ARGUMENT_ERROR;
+}
+
+/**
+ * Forwards all deferred ProvidePortData writes to the remote side.
+ * Adjacent (or nearly adjacent) ranges have already been merged, each remaining range results in one write.
+ * The dirty set is detached under providePortDirtyLock and flushed without holding it, writes deferred meanwhile
+ * go into a new set. Ranges that could not be sent are merged back into the live set.
+ * Concurrent flushes (commits from different threads) are serialized by providePortFlushLock.
+ */
+apx_error_t apx_nodeInstance_flushProvidePortData(apx_nodeInstance_t *self)
+{
+   if (self != 0)
+   {
+      apx_error_t retval = APX_NO_ERROR;
+      apx_byteRangeSet_t *ranges;
+      uint32_t numRanges;
+      uint32_t i = 0u;
+      MUTEX_LOCK(self->providePortFlushLock);
+      SPINLOCK_ENTER(self->providePortDirtyLock);
+      ranges = self->providePortDirtyRanges;
+      self->providePortDirtyRanges = (apx_byteRangeSet_t*) 0;
+      SPINLOCK_LEAVE(self->providePortDirtyLock);
+      if (ranges == 0)
+      {
+         MUTEX_UNLOCK(self->providePortFlushLock);
+         return APX_NO_ERROR;
+      }
+      numRanges = apx_byteRangeSet_length(ranges);
+      if ( (numRanges > 0u) && (self->connection != 0) )
+      {
+         uint8_t stackBuffer[STACK_DATA_BUF_SIZE];
+         assert(self->providePortDataFile != 0);
+         for (i = 0u; i < numRanges; i++)
+         {
+            uint8_t *dataBuf;
+            const apx_byteRange_t *range = apx_byteRangeSet_get(ranges, i);
+            assert(range != 0);
+            if (range->len > STACK_DATA_BUF_SIZE)
+            {
+               dataBuf = (uint8_t*) malloc(range->len);
+               if (dataBuf == 0)
+               {
+                  retval = APX_MEM_ERROR;
+                  break;
+               }
+            }
+            else
+            {
+               dataBuf = &stackBuffer[0];
+            }
+            retval = apx_nodeData_readProvidePortData(self->nodeData, dataBuf, range->offset, range->len);
+            if (retval == APX_NO_ERROR)
+            {
+               retval = apx_connectionBase_updateProvidePortDataDirect(self->connection, self->providePortDataFile, dataBuf, range->offset, range->len);
+            }
+            if (dataBuf != &stackBuffer[0])
+            {
+               free(dataBuf);
+            }
+            if (retval != APX_NO_ERROR)
+            {
+               break;
+            }
+         }
+      }
+      apx_nodeInstance_restoreProvidePortDirtyRanges(self, ranges, (retval == APX_NO_ERROR)? numRanges : i);
+      MUTEX_UNLOCK(self->providePortFlushLock);
+      return retval;
+   }
+   return APX_INVALID_ARGUMENT_ERROR;
+}
+
+bool apx_nodeInstance_hasPendingProvidePortData(apx_nodeInstance_t *self)
+{
+   if (self != 0)
+   {
+      bool retval;
+      SPINLOCK_ENTER(self->providePortDirtyLock);
+      retval = (apx_byteRangeSet_length(self->providePortDirtyRanges) > 0u)? true : false;
+      SPINLOCK_LEAVE(self->providePortDirtyLock);
+      return retval;
+   }
+   return false;
+}
+
+/**
+ * Marks a require port as changed since the last call to apx_nodeInstance_pollDirtyRequirePorts.
+ * Returns true if the port was not already marked.
+ */
+bool apx_nodeInstance_markRequirePortDirty(apx_nodeInstance_t *self, apx_portId_t requirePortId)
+{
+   if ( (self != 0) && (self->requirePortDirtyFlags != 0) && (requirePortId >= 0) )
+   {
+      uint32_t mask;
+      uint32_t previous;
+      assert(self->nodeInfo != 0);
+      if ( (apx_portCount_t) requirePortId >= apx_nodeInfo_getNumRequirePorts(self->nodeInfo))
+      {
+         return false;
+      }
+      mask = 1u << ( (uint32_t) requirePortId & DIRTY_FLAG_BIT_MASK);
+      previous = apx_atomic_or32(&self->requirePortDirtyFlags[(uint32_t) requirePortId >> DIRTY_FLAG_WORD_SHIFT], mask);
+      return ( (previous & mask) == 0u)? true : false;
+   }
+   return false;
+}
+
+/**
+ * Moves the IDs of all dirty require ports into requirePortIds (in ascending order) and clears their dirty flags.
+ * A port written several times since the previous poll is only reported once.
+ * Ports that do not fit in requirePortIds remain dirty until the next poll.
+ * Returns the number of port IDs written or -1 on error.
+ */
+int32_t apx_nodeInstance_pollDirtyRequirePorts(apx_nodeInstance_t *self, apx_portId_t *requirePortIds, int32_t maxNumPorts)
+{
+   if ( (self != 0) && (requirePortIds != 0) && (maxNumPorts >= 0) )
+   {
+      int32_t numPorts = 0;
+      if (self->requirePortDirtyFlags != 0)
+      {
+         uint32_t wordIndex;
+         uint32_t numWords;
+         assert(self->nodeInfo != 0);
+         numWords = DIRTY_FLAG_WORDS(apx_nodeInfo_getNumRequirePorts(self->nodeInfo));
+         for (wordIndex = 0u; (wordIndex < numWords) && (numPorts < maxNumPorts); wordIndex++)
+         {
+            uint32_t bitIndex;
+            uint32_t bits;
+            volatile uint32_t *word = &self->requirePortDirtyFlags[wordIndex];
+            if (apx_atomic_load32(word) == 0u)
+            {
+               continue;
+            }
+            bits = apx_atomic_exchange32(word, 0u);
+            for (bitIndex = 0u; (bits != 0u) && (bitIndex <= DIRTY_FLAG_BIT_MASK); bitIndex++)
+            {
+               uint32_t mask = 1u << bitIndex;
+               if ( (bits & mask) != 0u)
+               {
+                  if (numPorts == maxNumPorts)
+                  {
+                     //Put back what we could not report
+                     (void) apx_atomic_or32(word, bits);
+                     break;
+                  }
+                  requirePortIds[numPorts++] = (apx_portId_t) ( (wordIndex << DIRTY_FLAG_WORD_SHIFT) | bitIndex);
+                  bits &= ~mask;
+               }
+            }
+         }
+      }
+      return numPorts;
+   }
+   return -1;
+}
+
 /**
  * Reads raw data from requirePortData buffer
  */
@@ -837,10 +1179,22 @@ apx_error_t apx_nodeInstance_writeRequirePortData(apx_nodeInstance_t *self, cons
       {
          return rc;
       }
+      if ( (self->mode == APX_CLIENT_MODE) && (self->requirePortQueues != 0) )
+      {
+         rc = apx_nodeInstance_enqueueReceivedElements(self, src, offset, (uint32_t) len);
+         if (rc != APX_NO_ERROR)
+         {
+            return rc;
+         }
+      }
       if(self->connection != 0)
       {
          assert(self->requirePortDataFile != 0);
-         if (self->mode == APX_SERVER_MODE)
+         if (apx_nodeInstance_isConflatedReceiver(self))
+         {
+            rc = apx_nodeInstance_conflateRequirePortData(self, offset, len);
+         }
+         else if (self->mode == APX_SERVER_MODE)
          {
             rc = apx_connectionBase_updateRequirePortDataDirect(self->connection, self->requirePortDataFile, src, offset, len);
          }
@@ -850,6 +1204,77 @@ apx_error_t apx_nodeInstance_writeRequirePortData(apx_nodeInstance_t *self, cons
    return APX_INVALID_ARGUMENT_ERROR;
 }
 
+/**
+ * Client mode only. Appends one packed element to a queued provide port and makes sure a transfer of the port is scheduled.
+ * Elements written while a transfer is already waiting in the file manager go out together with it.
+ * Safe to call from several threads, writers of the same port are serialized by the port queue and each thread's
+ * elements keep their order. Returns APX_QUEUE_FULL_ERROR when the element had to be dropped.
+ */
+apx_error_t apx_nodeInstance_writeQueuedProvidePortData(apx_nodeInstance_t *self, apx_portId_t providePortId, const uint8_t *element)
+{
+   if ( (self != 0) && (element != 0) )
+   {
+      apx_error_t rc;
+      apx_portQueue_t *queue = apx_nodeInstance_getProvidePortQueue(self, providePortId);
+      if (queue == 0)
+      {
+         return APX_INVALID_ARGUMENT_ERROR;
+      }
+      rc = apx_portQueue_push(queue, element);
+      if (rc == APX_NO_ERROR)
+      {
+         rc = apx_nodeInstance_scheduleQueuedTransfer(self, queue, self->providePortDataFile,
+               apx_nodeInfo_getProvidePortDataProps(self->nodeInfo, providePortId), &self->providePortQueueHandler);
+      }
+      return rc;
+   }
+   return APX_INVALID_ARGUMENT_ERROR;
+}
+
+/**
+ * Client mode only. Moves up to maxNumElements received elements of a queued require port into elements (packed, oldest first).
+ * Safe to call from several threads, concurrent readers of the same port each get a disjoint run of elements.
+ * Returns number of elements read or -1 on error.
+ */
+int32_t apx_nodeInstance_readQueuedRequirePortData(apx_nodeInstance_t *self, apx_portId_t requirePortId, uint8_t *elements, int32_t maxNumElements)
+{
+   if ( (self != 0) && (elements != 0) && (maxNumElements >= 0) )
+   {
+      apx_portQueue_t *queue = apx_nodeInstance_getRequirePortQueue(self, requirePortId);
+      if (queue != 0)
+      {
+         return (int32_t) apx_portQueue_read(queue, elements, (uint32_t) maxNumElements);
+      }
+   }
+   return -1;
+}
+
+apx_portQueue_t *apx_nodeInstance_getProvidePortQueue(apx_nodeInstance_t *self, apx_portId_t providePortId)
+{
+   if ( (self != 0) && (self->providePortQueues != 0) && (providePortId >= 0) )
+   {
+      assert(self->nodeInfo != 0);
+      if ( (apx_portCount_t) providePortId < apx_nodeInfo_getNumProvidePorts(self->nodeInfo) )
+      {
+         return self->providePortQueues[providePortId];
+      }
+   }
+   return (apx_portQueue_t*) 0;
+}
+
+apx_portQueue_t *apx_nodeInstance_getRequirePortQueue(apx_nodeInstance_t *self, apx_portId_t requirePortId)
+{
+   if ( (self != 0) && (self->requirePortQueues != 0) && (requirePortId >= 0) )
+   {
+      assert(self->nodeInfo != 0);
+      if ( (apx_portCount_t) requirePortId < apx_nodeInfo_getNumRequirePorts(self->nodeInfo) )
+      {
+         return self->requirePortQueues[requirePortId];
+      }
+   }
+   return (apx_portQueue_t*) 0;
+}
+
 /********** P-Port connector API  ************/
 apx_error_t apx_nodeInstance_buildConnectorTable(apx_nodeInstance_t *self)
 {
@@ -883,11 +1308,29 @@ void apx_nodeInstance_lockPortConnectorTable(apx_nodeInstance_t *self)
    }
 }
 
+/**
+ * Any changes made to the connector table while it was locked are published to the data routing path before the lock is released.
+ * The replaced routing plan is deleted after the lock has been released, once the threads still routing through it are done.
+ */
 void apx_nodeInstance_unlockPortConnectorTable(apx_nodeInstance_t *self)
 {
    if ( (self != 0) && (self->connectorTable != 0) )
    {
+      apx_routingPlan_t *retiredRoutingPlan = (apx_routingPlan_t*) 0;
+      uint32_t retiredEpoch = 0u;
+      if (self->isRoutingPlanStale)
+      {
+         apx_error_t rc = apx_nodeInstance_rebuildRoutingPlan(self, &retiredRoutingPlan, &retiredEpoch);
+         if (rc != APX_NO_ERROR)
+         {
+            APX_LOG_ERROR("[APX_NODEINSTANCE] failed to rebuild routing plan (%d)", (int) rc);
+         }
+      }
       MUTEX_UNLOCK(self->connectorTableLock);
+      if (retiredRoutingPlan != 0)
+      {
+         apx_nodeInstance_deleteRetiredRoutingPlan(self, retiredRoutingPlan, retiredEpoch);
+      }
    }
 }
 
@@ -924,6 +1367,7 @@ apx_error_t apx_nodeInstance_insertProvidePortConnector(apx_nodeInstance_t *self
          if (self->connectorTable != 0)
          {
             apx_portConnectorList_t *connectors = &self->connectorTable[portId];
+            self->isRoutingPlanStale = true;
             return apx_portConnectorList_insert(connectors, requirePortRef);
          }
          return APX_NULL_PTR_ERROR;
@@ -949,6 +1393,7 @@ apx_error_t apx_nodeInstance_removeProvidePortConnector(apx_nodeInstance_t *self
          if (self->connectorTable != 0)
          {
             apx_portConnectorList_t *connectors = &self->connectorTable[portId];
+            self->isRoutingPlanStale = true;
             apx_portConnectorList_remove(connectors, requirePortRef);
             return APX_NO_ERROR;
          }
@@ -1196,84 +1641,252 @@ apx_error_t apx_nodeInstance_sendRequirePortDataToFileManager(apx_nodeInstance_t
       {
          apx_connectionBase_free(self->connection, dataBuf, bufSize);
       }
-      return apx_fileManager_writeDynamicData(fileManager, fileStartAddress, fileSize, dataBuf);
+      rc = apx_fileManager_writeDynamicData(fileManager, fileStartAddress, fileSize, dataBuf);
+      if ( (rc == APX_NO_ERROR) && (self->requirePortQueues != 0) )
+      {
+         //The snapshot only carries empty queues, elements routed before the file was opened follow right after it
+         rc = apx_nodeInstance_flushPortQueues(self, self->requirePortQueues, apx_nodeInfo_getRequirePortDataProps,
+               apx_nodeInfo_getNumRequirePorts(self->nodeInfo), file, &self->requirePortQueueHandler);
+      }
+      return rc;
    }
    return APX_INVALID_ARGUMENT_ERROR;
 }
 
+/**
+ * Routes a write of len bytes starting at offset in provide port data to all connected require ports.
+ * The write may span several ports. No lock is held while data is being routed, the connector table
+ * is instead read through an immutable routing plan.
+ * Require port data is first updated in all receiving nodes. Writes going to the same receiving node are then
+ * merged into as few contiguous ranges as possible before being sent.
+ * Writes that still map to a contiguous range of src are transmitted from a single shared payload, meaning that
+ * the routed data is copied once no matter how many connections it is sent to.
+ * Receivers on conflating connections only get their written ports marked as dirty, see apx_connectionBase_setConflationEnabled.
+ * Elements written to queued ports are never merged or conflated. They are appended to the port queue of each receiver instead.
+ * Dynamic array ports are only routed up to the end of the used elements, as given by the array length in the write.
+ */
 apx_error_t apx_nodeInstance_routeProvidePortDataToReceivers(apx_nodeInstance_t *self, const uint8_t *src, uint32_t offset, apx_size_t len)
 {
-   if ( (self != 0) )
+   if ( (self != 0) && (src != 0) )
    {
+      apx_routingWrite_t stackWrites[STACK_ROUTING_WRITES_SIZE];
+      apx_routingWrite_t *writes = &stackWrites[0];
+      uint32_t maxWrites = STACK_ROUTING_WRITES_SIZE;
+      uint32_t numWrites = 0u;
+      uint32_t numRoutedWrites;
+      uint32_t numQueuedWrites = 0u;
+      uint64_t numRoutedBytes = 0u;
+      uint32_t i;
+      apx_error_t retval = APX_NO_ERROR;
       uint32_t endOffset;
-      assert(self->nodeInfo != 0);
-      assert(self->connectorTable != 0);
+      uint32_t portIndex;
+      apx_payload_t *payload = (apx_payload_t*) 0;
+      apx_routingPlan_t *routingPlan;
+      uint32_t epoch = 0u;
+      if (self->nodeInfo != 0)
+      {
+         apx_size_t providePortDataSize = apx_nodeInfo_getProvidePortInitDataSize(self->nodeInfo);
+         if ( (len > providePortDataSize) || (offset > (providePortDataSize - len)) )
+         {
+            return APX_LENGTH_ERROR;
+         }
+      }
+      routingPlan = apx_nodeInstance_acquireRoutingPlan(self, len, &epoch);
+      if (routingPlan == 0)
+      {
+         return APX_NO_ERROR; //Nothing is connected to this node
+      }
       endOffset = offset + len;
-      MUTEX_LOCK(self->connectorTableLock);
-      while(offset < endOffset)
+      for (portIndex = apx_routingPlan_findFirstPort(routingPlan, offset); portIndex < routingPlan->numPorts; portIndex++)
       {
-         apx_error_t rc;
-         int32_t numConnectors;
-         int32_t connectorId;
-         apx_portId_t providerPortId;
-         apx_portConnectorList_t *portConnectors;
-         const apx_portDataProps_t *providePortDataProps;
-         providerPortId = apx_nodeInfo_findProvidePortIdFromByteOffset(self->nodeInfo, offset);
-         if (providerPortId < 0)
+         uint32_t entryIndex;
+         uint32_t beginOffset;
+         uint32_t portEndOffset;
+         const apx_routingPlanPort_t *port = &routingPlan->ports[portIndex];
+         if (port->srcOffset >= endOffset)
          {
-            printf("[APX_NODEINSTANCE] detected write on invalid offset %d\n", offset);
             break;
          }
-         providePortDataProps = apx_nodeInfo_getProvidePortDataProps(self->nodeInfo, providerPortId);
-         assert(providePortDataProps != 0);
-         offset += providePortDataProps->dataSize; ///TODO: Verify if this also works for complex data
-         portConnectors = &self->connectorTable[providerPortId];
-         numConnectors = apx_portConnectorList_length(portConnectors);
-         for(connectorId = 0; connectorId < numConnectors; connectorId++)
+         //Only the part of the port overlapping the write is routed
+         beginOffset = (port->srcOffset > offset)? port->srcOffset : offset;
+         portEndOffset = port->srcOffset + port->dataSize;
+         if (portEndOffset > endOffset)
+         {
+            portEndOffset = endOffset;
+         }
+         if (port->queLenType != APX_QUE_LEN_NONE)
+         {
+            if (beginOffset == port->srcOffset)
+            {
+               for (entryIndex = port->firstEntry; entryIndex < (port->firstEntry + port->numEntries); entryIndex++)
+               {
+                  const apx_routingPlanEntry_t *entry = &routingPlan->entries[entryIndex];
+                  retval = apx_nodeInstance_enqueueRoutedElements(entry->destNodeInstance, entry->destPortId, src + (beginOffset - offset), portEndOffset - beginOffset);
+                  if (retval != APX_NO_ERROR)
+                  {
+                     break;
+                  }
+                  numQueuedWrites++;
+                  numRoutedBytes += portEndOffset - beginOffset;
+               }
+               if (retval != APX_NO_ERROR)
+               {
+                  break;
+               }
+            }
+            continue;
+         }
+         if ( (port->dynLenType != APX_DYN_LEN_NONE) && (beginOffset == port->srcOffset) )
          {
-            const apx_portDataProps_t *requireePortDataProps;
-            apx_portRef_t *requirePortRef = apx_portConnectorList_get(portConnectors, connectorId);
-            requireePortDataProps = requirePortRef->portDataProps;
-            if (apx_portDataProps_isPlainOldData(requireePortDataProps))
+            uint32_t usedSize = (uint32_t) apx_portDataProps_calcDynArrayDataSize(port->dynLenType, port->arrayElementSize, port->dataSize,
+                  src + (beginOffset - offset), portEndOffset - beginOffset);
+            if ( (port->srcOffset + usedSize) < portEndOffset)
             {
-               if (requireePortDataProps->dataSize != len)
+               portEndOffset = port->srcOffset + usedSize;
+            }
+         }
+         for (entryIndex = port->firstEntry; entryIndex < (port->firstEntry + port->numEntries); entryIndex++)
+         {
+            apx_routingWrite_t *write;
+            const apx_routingPlanEntry_t *entry = &routingPlan->entries[entryIndex];
+            assert(entry->destNodeInstance->nodeData != 0);
+            if (numWrites == maxWrites)
+            {
+               apx_routingWrite_t *newWrites = (apx_routingWrite_t*) malloc(sizeof(apx_routingWrite_t) * maxWrites * 2u);
+               if (newWrites == 0)
                {
-                  MUTEX_UNLOCK(self->connectorTableLock);
-                  return APX_LENGTH_ERROR;
+                  retval = APX_MEM_ERROR;
+                  break;
                }
-               rc = apx_nodeInstance_writeRequirePortData(requirePortRef->nodeInstance, src, requireePortDataProps->offset, requireePortDataProps->dataSize);
-               if (rc != APX_NO_ERROR)
+               memcpy(newWrites, writes, sizeof(apx_routingWrite_t) * numWrites);
+               if (writes != &stackWrites[0])
                {
-                  MUTEX_UNLOCK(self->connectorTableLock);
-                  return rc;
+                  free(writes);
                }
+               writes = newWrites;
+               maxWrites *= 2u;
             }
+            write = &writes[numWrites++];
+            write->destNodeInstance = entry->destNodeInstance;
+            write->destOffset = entry->destOffset + (beginOffset - port->srcOffset);
+            write->len = portEndOffset - beginOffset;
+            write->srcOffset = beginOffset - offset;
+            retval = apx_nodeData_writeRequirePortData(write->destNodeInstance->nodeData, src + (beginOffset - offset), write->destOffset, write->len);
+            if (retval != APX_NO_ERROR)
+            {
+               break;
+            }
+            numRoutedBytes += write->len;
+         }
+         if (retval != APX_NO_ERROR)
+         {
+            break;
          }
       }
-
-      MUTEX_UNLOCK(self->connectorTableLock);
-      return APX_NO_ERROR;
-   }
-   return APX_INVALID_ARGUMENT_ERROR;
-}
-
-void apx_nodeInstance_clearConnectorTable(apx_nodeInstance_t *self)
-{
-   if (self != 0)
-   {
-      MUTEX_LOCK(self->connectorTableLock);
-      apx_portConnectorList_clear(self->connectorTable);
-      MUTEX_UNLOCK(self->connectorTableLock);
-   }
-}
-
-/********** Port Program API ***************/
-const adt_bytes_t *apx_nodeInstance_getProvidePortPackProgram(apx_nodeInstance_t *self, apx_portId_t providePortId)
-{
-   if (self != 0)
-   {
-      assert(self->nodeInfo != 0);
-      return apx_nodeInfo_getProvidePortPackProgram(self->nodeInfo, providePortId);
+      numRoutedWrites = numWrites + numQueuedWrites;
+      if (retval == APX_NO_ERROR)
+      {
+         numWrites = apx_routingPlan_coalesceWrites(writes, numWrites);
+         for (i = 0u; i < numWrites; i++)
+         {
+            apx_nodeInstance_t *destNodeInstance = writes[i].destNodeInstance;
+            if (apx_nodeInstance_isConflatedReceiver(destNodeInstance))
+            {
+               retval = apx_nodeInstance_conflateRequirePortData(destNodeInstance, writes[i].destOffset, writes[i].len);
+            }
+            else if ( (writes[i].srcOffset != APX_ROUTING_WRITE_NO_SRC_OFFSET) && apx_nodeInstance_isRemoteReceiver(destNodeInstance) )
+            {
+               if (payload == 0)
+               {
+                  payload = apx_payload_new(src, len);
+                  if (payload == 0)
+                  {
+                     retval = APX_MEM_ERROR;
+                     break;
+                  }
+               }
+               retval = apx_connectionBase_updateRequirePortDataPayload(destNodeInstance->connection, destNodeInstance->requirePortDataFile,
+                     payload, writes[i].srcOffset, writes[i].destOffset, writes[i].len);
+            }
+            else
+            {
+               retval = apx_nodeInstance_sendRequirePortData(destNodeInstance, writes[i].destOffset, writes[i].len);
+            }
+            if (retval != APX_NO_ERROR)
+            {
+               break;
+            }
+         }
+         if (payload != 0)
+         {
+            apx_payload_release(payload);
+         }
+      }
+      else
+      {
+         numWrites = 0u;
+         numQueuedWrites = 0u;
+      }
+      apx_nodeInstance_releaseRoutingPlan(self, epoch, numRoutedWrites, numWrites + numQueuedWrites, numRoutedBytes);
+      if (writes != &stackWrites[0])
+      {
+         free(writes);
+      }
+      return retval;
+   }
+   return APX_INVALID_ARGUMENT_ERROR;
+}
+
+void apx_nodeInstance_clearConnectorTable(apx_nodeInstance_t *self)
+{
+   if ( (self != 0) && (self->connectorTable != 0) )
+   {
+      apx_portCount_t numProvidePorts;
+      apx_portId_t portId;
+      assert(self->nodeInfo != 0);
+      numProvidePorts = apx_nodeInfo_getNumProvidePorts(self->nodeInfo);
+      MUTEX_LOCK(self->connectorTableLock);
+      for (portId = 0; portId < numProvidePorts; portId++)
+      {
+         apx_portConnectorList_clear(&self->connectorTable[portId]);
+      }
+      self->isRoutingPlanStale = true;
+      apx_nodeInstance_unlockPortConnectorTable(self);
+   }
+}
+
+void apx_nodeInstance_getRoutingStats(apx_nodeInstance_t *self, apx_routingStats_t *stats)
+{
+   if ( (self != 0) && (stats != 0) )
+   {
+      stats->numRoutedWrites = apx_atomic_load32(&self->routingStats.numRoutedWrites);
+      stats->numTransmittedWrites = apx_atomic_load32(&self->routingStats.numTransmittedWrites);
+      stats->numSourceWrites = apx_atomic_load32(&self->routingStats.numSourceWrites);
+      stats->numSourceBytes = apx_atomic_load64(&self->routingStats.numSourceBytes);
+      stats->numRoutedBytes = apx_atomic_load64(&self->routingStats.numRoutedBytes);
+      stats->maxFanOut = apx_atomic_load32(&self->routingStats.maxFanOut);
+   }
+}
+
+/**
+ * Returns the currently published routing plan (if any). The caller must hold the connector table lock.
+ */
+const apx_routingPlan_t *apx_nodeInstance_getRoutingPlan(apx_nodeInstance_t *self)
+{
+   if (self != 0)
+   {
+      return self->routingPlan;
+   }
+   return (const apx_routingPlan_t*) 0;
+}
+
+/********** Port Program API ***************/
+const adt_bytes_t *apx_nodeInstance_getProvidePortPackProgram(apx_nodeInstance_t *self, apx_portId_t providePortId)
+{
+   if (self != 0)
+   {
+      assert(self->nodeInfo != 0);
+      return apx_nodeInfo_getProvidePortPackProgram(self->nodeInfo, providePortId);
    }
    return (const adt_bytes_t*) 0;
 }
@@ -1288,10 +1901,88 @@ const adt_bytes_t *apx_nodeInstance_getRequirePortUnpackProgram(apx_nodeInstance
    return (const adt_bytes_t*) 0;
 }
 
+const apx_copyPlan_t *apx_nodeInstance_getProvidePortPackPlan(apx_nodeInstance_t *self, apx_portId_t providePortId)
+{
+   if (self != 0)
+   {
+      assert(self->nodeInfo != 0);
+      return apx_nodeInfo_getProvidePortPackPlan(self->nodeInfo, providePortId);
+   }
+   return (const apx_copyPlan_t*) 0;
+}
+
+const apx_copyPlan_t *apx_nodeInstance_getRequirePortUnpackPlan(apx_nodeInstance_t *self, apx_portId_t requirePortId)
+{
+   if (self != 0)
+   {
+      assert(self->nodeInfo != 0);
+      return apx_nodeInfo_getRequirePortUnpackPlan(self->nodeInfo, requirePortId);
+   }
+   return (const apx_copyPlan_t*) 0;
+}
+
 //////////////////////////////////////////////////////////////////////////////
 // PRIVATE FUNCTIONS
 //////////////////////////////////////////////////////////////////////////////
 
+/**
+ * Gives a dirty set detached by apx_nodeInstance_flushProvidePortData back to the node instance.
+ * Ranges before firstUnsent have been sent and are dropped. The remaining ranges are merged into the live set
+ * (which may have been created by a concurrent deferred write in the meantime).
+ * A fully sent set is recycled as the live set when no new set exists yet.
+ */
+static void apx_nodeInstance_restoreProvidePortDirtyRanges(apx_nodeInstance_t *self, apx_byteRangeSet_t *ranges, uint32_t firstUnsent)
+{
+   uint32_t numRanges = apx_byteRangeSet_length(ranges);
+   if ( (firstUnsent > 0u) && (firstUnsent < numRanges) )
+   {
+      apx_byteRangeSet_t *unsent = apx_byteRangeSet_new(APX_PROVIDE_PORT_DATA_MERGE_GAP);
+      if (unsent != 0)
+      {
+         uint32_t i;
+         for (i = firstUnsent; i < numRanges; i++)
+         {
+            const apx_byteRange_t *range = apx_byteRangeSet_get(ranges, i);
+            (void) apx_byteRangeSet_insert(unsent, range->offset, range->len);
+         }
+         apx_byteRangeSet_delete(ranges);
+         ranges = unsent;
+         numRanges = apx_byteRangeSet_length(ranges);
+      }
+      //When out of memory the ranges already sent are kept as well, sending them twice is harmless
+      firstUnsent = 0u;
+   }
+   SPINLOCK_ENTER(self->providePortDirtyLock);
+   if (firstUnsent >= numRanges)
+   {
+      if (self->providePortDirtyRanges == 0)
+      {
+         apx_byteRangeSet_clear(ranges);
+         self->providePortDirtyRanges = ranges;
+         ranges = (apx_byteRangeSet_t*) 0;
+      }
+   }
+   else if (self->providePortDirtyRanges == 0)
+   {
+      self->providePortDirtyRanges = ranges;
+      ranges = (apx_byteRangeSet_t*) 0;
+   }
+   else
+   {
+      uint32_t i;
+      for (i = 0u; i < numRanges; i++)
+      {
+         const apx_byteRange_t *range = apx_byteRangeSet_get(ranges, i);
+         (void) apx_byteRangeSet_insert(self->providePortDirtyRanges, range->offset, range->len);
+      }
+   }
+   SPINLOCK_LEAVE(self->providePortDirtyLock);
+   if (ranges != 0)
+   {
+      apx_byteRangeSet_delete(ranges);
+   }
+}
+
 
 static apx_error_t apx_nodeInstance_definitionFileWriteNotify(void *arg, apx_file_t *file, uint32_t offset, const uint8_t *src, uint32_t len)
 {
@@ -1338,6 +2029,15 @@ static apx_error_t apx_nodeInstance_definitionFileReadData(void *arg, apx_file_t
    if (self != 0)
    {
       apx_nodeData_t *nodeData = apx_nodeInstance_getNodeData(self);
+      if (apx_file_getRmfFileType(file) == RMF_FILE_TYPE_COMPRESSED_FIXED)
+      {
+         if ( (self->compressedDefinitionData == 0) || ( (offset + len) > self->compressedDefinitionDataLen) )
+         {
+            return APX_INVALID_ARGUMENT_ERROR;
+         }
+         memcpy(dest, &self->compressedDefinitionData[offset], len);
+         return APX_NO_ERROR;
+      }
       if (nodeData != 0)
       {
          return apx_nodeData_readDefinitionData(nodeData, dest, offset, len);
@@ -1351,7 +2051,7 @@ static apx_error_t apx_nodeInstance_definitionFileReadData(void *arg, apx_file_t
 }
 
 
-static apx_error_t apx_nodeInstance_createFileInfo(apx_nodeInstance_t *self, const char *fileExtension, uint32_t fileSize, apx_fileInfo_t *fileInfo)
+static apx_error_t apx_nodeInstance_createFileInfo(apx_nodeInstance_t *self, const char *fileExtension, uint32_t fileSize, uint16_t fileType, apx_fileInfo_t *fileInfo)
 {
    if ( (self != 0) && (fileInfo != 0))
    {
@@ -1368,11 +2068,43 @@ static apx_error_t apx_nodeInstance_createFileInfo(apx_nodeInstance_t *self, con
       }
       strcpy(fileName, nodeName);
       strcat(fileName, fileExtension);
-      return apx_fileInfo_create(fileInfo, RMF_INVALID_ADDRESS, fileSize, fileName, RMF_FILE_TYPE_FIXED, RMF_DIGEST_TYPE_NONE, (const uint8_t*) 0);
+      return apx_fileInfo_create(fileInfo, RMF_INVALID_ADDRESS, fileSize, fileName, fileType, RMF_DIGEST_TYPE_NONE, (const uint8_t*) 0);
    }
    return APX_INVALID_ARGUMENT_ERROR;
 }
 
+/**
+ * Definition data never changes once the node is built, the compressed copy is therefore reused on reconnect.
+ * Returns APX_BUFFER_FULL_ERROR when compression would not make the data any smaller.
+ */
+static apx_error_t apx_nodeInstance_compressDefinitionData(apx_nodeInstance_t *self)
+{
+   apx_error_t result;
+   const uint8_t *definitionData;
+   apx_size_t definitionDataLen;
+   if (self->compressedDefinitionData != 0)
+   {
+      return APX_NO_ERROR;
+   }
+   definitionDataLen = apx_nodeData_getDefinitionDataLen(self->nodeData);
+   self->compressedDefinitionData = (uint8_t*) malloc(definitionDataLen);
+   if (self->compressedDefinitionData == 0)
+   {
+      return APX_MEM_ERROR;
+   }
+   apx_nodeData_lockDefinitionData(self->nodeData);
+   definitionData = apx_nodeData_getDefinitionDataBuf(self->nodeData);
+   result = apx_lz_compress(definitionData, definitionDataLen, self->compressedDefinitionData, definitionDataLen - 1u, &self->compressedDefinitionDataLen);
+   apx_nodeData_unlockDefinitionData(self->nodeData);
+   if (result != APX_NO_ERROR)
+   {
+      free(self->compressedDefinitionData);
+      self->compressedDefinitionData = (uint8_t*) 0;
+      self->compressedDefinitionDataLen = 0u;
+   }
+   return result;
+}
+
 static apx_error_t apx_nodeInstance_providePortDataFileWriteNotify(void *arg, apx_file_t *file, uint32_t offset, const uint8_t *src, uint32_t len)
 {
    apx_nodeInstance_t *self = (apx_nodeInstance_t*) arg;
@@ -1442,7 +2174,13 @@ static apx_error_t apx_nodeInstance_providePortDataFileOpenNotify(void *arg, str
       {
          apx_connectionBase_free(self->connection, dataBuf, bufSize);
       }
-      return apx_fileManager_writeDynamicData(fileManager, fileStartAddress, fileSize, dataBuf);
+      rc = apx_fileManager_writeDynamicData(fileManager, fileStartAddress, fileSize, dataBuf);
+      if ( (rc == APX_NO_ERROR) && (self->providePortQueues != 0) )
+      {
+         rc = apx_nodeInstance_flushPortQueues(self, self->providePortQueues, apx_nodeInfo_getProvidePortDataProps,
+               apx_nodeInfo_getNumProvidePorts(self->nodeInfo), file, &self->providePortQueueHandler);
+      }
+      return rc;
    }
    return APX_INVALID_ARGUMENT_ERROR;
 }
@@ -1460,6 +2198,90 @@ static apx_error_t apx_nodeInstance_requirePortDataFileWriteNotify(void *arg, ap
    return APX_INVALID_ARGUMENT_ERROR;
 }
 
+/**
+ * Called by the file manager worker when it processes a conflated transfer. Every dirty require port becomes one range.
+ * For dynamic array ports the range ends after the used elements.
+ * The pending flag is cleared before the dirty flags are read, a port written after that schedules a new transfer.
+ */
+static apx_error_t apx_nodeInstance_requirePortDataFileTakeDirtyRanges(void *arg, apx_file_t *file, apx_byteRangeSet_t *ranges)
+{
+   apx_nodeInstance_t *self = (apx_nodeInstance_t*) arg;
+   (void) file;
+   if ( (self != 0) && (ranges != 0) )
+   {
+      apx_portId_t portIds[STACK_DIRTY_PORT_IDS_SIZE];
+      int32_t numPorts;
+      assert(self->nodeInfo != 0);
+      (void) apx_atomic_exchange32(&self->isConflatedTransferPending, 0u);
+      do
+      {
+         int32_t i;
+         numPorts = apx_nodeInstance_pollDirtyRequirePorts(self, &portIds[0], STACK_DIRTY_PORT_IDS_SIZE);
+         for (i = 0; i < numPorts; i++)
+         {
+            const apx_portDataProps_t *props = apx_nodeInfo_getRequirePortDataProps(self->nodeInfo, portIds[i]);
+            apx_size_t len;
+            apx_error_t rc;
+            assert(props != 0);
+            len = props->dataSize;
+            if (props->isDynamicArray)
+            {
+               uint8_t header[UINT32_SIZE];
+               apx_size_t lenSize = apx_portDataProps_getDynLenSize(props);
+               if (apx_nodeData_readRequirePortData(self->nodeData, &header[0], props->offset, lenSize) == APX_NO_ERROR)
+               {
+                  len = apx_portDataProps_getUsedDataSize(props, &header[0], lenSize);
+               }
+            }
+            rc = apx_byteRangeSet_insert(ranges, props->offset, len);
+            if (rc != APX_NO_ERROR)
+            {
+               return rc;
+            }
+         }
+      } while (numPorts == STACK_DIRTY_PORT_IDS_SIZE);
+      return APX_NO_ERROR;
+   }
+   return APX_INVALID_ARGUMENT_ERROR;
+}
+
+static apx_error_t apx_nodeInstance_requirePortDataFileReadData(void *arg, apx_file_t *file, uint32_t offset, uint8_t *dest, uint32_t len)
+{
+   apx_nodeInstance_t *self = (apx_nodeInstance_t*) arg;
+   (void) file;
+   return apx_nodeInstance_readRequirePortData(self, dest, offset, len);
+}
+
+/**
+ * Called by the file manager worker for a taken range it failed to send.
+ * The require ports in the range are marked dirty again and a new conflated transfer is requested unless one is already pending.
+ */
+static apx_error_t apx_nodeInstance_requirePortDataFileMarkDirty(void *arg, apx_file_t *file, uint32_t offset, uint32_t len)
+{
+   apx_nodeInstance_t *self = (apx_nodeInstance_t*) arg;
+   (void) file;
+   if (self != 0)
+   {
+      apx_portId_t portId;
+      apx_portId_t numRequirePorts;
+      uint32_t endOffset = offset + len;
+      assert(self->nodeInfo != 0);
+      numRequirePorts = (apx_portId_t) apx_nodeInfo_getNumRequirePorts(self->nodeInfo);
+      for (portId = apx_nodeInstance_findRequirePortByOffset(self, offset); portId < numRequirePorts; portId++)
+      {
+         const apx_portDataProps_t *props = apx_nodeInfo_getRequirePortDataProps(self->nodeInfo, portId);
+         assert(props != 0);
+         if (props->offset >= endOffset)
+         {
+            break;
+         }
+         (void) apx_nodeInstance_markRequirePortDirty(self, portId);
+      }
+      return apx_nodeInstance_requestConflatedTransfer(self);
+   }
+   return APX_INVALID_ARGUMENT_ERROR;
+}
+
 static apx_error_t apx_nodeInstance_requirePortDataFileOpenNotify(void *arg, struct apx_file_tag *file)
 {
    apx_nodeInstance_t *self = (apx_nodeInstance_t*) arg;
@@ -1498,7 +2320,11 @@ static apx_error_t apx_nodeInstance_routeProvidePortDataToRequirePortByRef(apx_p
    const apx_portDataProps_t *providePortDataProps;
    requirePortDataProps = requirePortRef->portDataProps;
    providePortDataProps = providePortRef->portDataProps;
-   if ( apx_portDataProps_isPlainOldData(requirePortDataProps) )
+   if (apx_portDataProps_isQueued(requirePortDataProps))
+   {
+      return APX_NO_ERROR; //Queued ports carry events, a new receiver only gets elements written after it was connected
+   }
+   if ( apx_portDataProps_isPlainOldData(requirePortDataProps) || requirePortDataProps->isDynamicArray)
    {
       apx_nodeInstance_t *provideNodeInstance;
       apx_nodeInstance_t *requireNodeInstance;
@@ -1532,7 +2358,7 @@ static apx_error_t apx_nodeInstance_routeProvidePortDataToRequirePortByRef(apx_p
                requireNodeInstance->requirePortDataFile,
                providePortDataBuf,
                requirePortDataProps->offset,
-               requirePortDataProps->dataSize);
+               apx_portDataProps_getUsedDataSize(providePortDataProps, providePortDataBuf, providePortDataProps->dataSize));
          if (rc != APX_NO_ERROR)
          {
             if (isDataBufMalloced) free(providePortDataBuf);
@@ -1551,3 +2377,499 @@ static apx_error_t apx_nodeInstance_routeProvidePortDataToRequirePortByRef(apx_p
    return APX_NO_ERROR;
 }
 
+/**
+ * Builds a new routing plan from the connector table and publishes it. The caller must hold connectorTableLock.
+ * After the new plan is published the epoch is flipped, readers counted in the old epoch may still use the old plan
+ * while readers counted in the new epoch are guaranteed to see the new plan.
+ * The old plan and its epoch are returned in *retiredRoutingPlan and *retiredEpoch, the caller passes them to
+ * apx_nodeInstance_deleteRetiredRoutingPlan after releasing connectorTableLock.
+ */
+static apx_error_t apx_nodeInstance_rebuildRoutingPlan(apx_nodeInstance_t *self, apx_routingPlan_t **retiredRoutingPlan, uint32_t *retiredEpoch)
+{
+   apx_routingPlan_t *oldRoutingPlan;
+   apx_routingPlan_t *newRoutingPlan = apx_routingPlan_new();
+   assert(self != 0);
+   if (newRoutingPlan == 0)
+   {
+      return APX_MEM_ERROR;
+   }
+   else
+   {
+      apx_error_t rc = apx_routingPlan_build(newRoutingPlan, self->nodeInfo, self->connectorTable);
+      if (rc != APX_NO_ERROR)
+      {
+         apx_routingPlan_delete(newRoutingPlan);
+         return rc;
+      }
+   }
+   if (apx_routingPlan_getNumPorts(newRoutingPlan) == 0u)
+   {
+      apx_routingPlan_delete(newRoutingPlan);
+      newRoutingPlan = (apx_routingPlan_t*) 0;
+   }
+   oldRoutingPlan = (apx_routingPlan_t*) apx_atomic_exchangePtr((void * volatile *) &self->routingPlan, (void*) newRoutingPlan);
+   if (oldRoutingPlan != 0)
+   {
+      uint32_t oldEpoch = apx_atomic_load32(&self->routingEpoch);
+      apx_atomic_exchange32(&self->routingEpoch, oldEpoch ^ 1u);
+      *retiredRoutingPlan = oldRoutingPlan;
+      *retiredEpoch = oldEpoch;
+   }
+   self->isRoutingPlanStale = false;
+   return APX_NO_ERROR;
+}
+
+/**
+ * Waits until no reader is counted in retiredEpoch, then deletes the retired plan. Must be called without holding connectorTableLock.
+ * A rebuild by another thread in the meantime may flip the epoch back, new readers then only prolong the wait.
+ * The wait starts with a yield and backs off up to ROUTING_PLAN_RETIRE_MAX_SLEEP_MS between checks.
+ */
+static void apx_nodeInstance_deleteRetiredRoutingPlan(apx_nodeInstance_t *self, apx_routingPlan_t *retiredRoutingPlan, uint32_t retiredEpoch)
+{
+   uint32_t sleepMs = 0u;
+   while (apx_atomic_load32(&self->numRoutingReaders[retiredEpoch]) > 0u)
+   {
+      SLEEP(sleepMs);
+      sleepMs = (sleepMs == 0u)? 1u : sleepMs * 2u;
+      if (sleepMs > ROUTING_PLAN_RETIRE_MAX_SLEEP_MS)
+      {
+         sleepMs = ROUTING_PLAN_RETIRE_MAX_SLEEP_MS;
+      }
+   }
+   apx_routingPlan_delete(retiredRoutingPlan);
+}
+
+/**
+ * Lock-free. Registers the calling thread as a reader in the current epoch before loading the plan.
+ * If the epoch changed in between, the plan may already have been replaced and the registration is retried.
+ * On success *epoch must be passed to apx_nodeInstance_releaseRoutingPlan.
+ */
+static apx_routingPlan_t *apx_nodeInstance_acquireRoutingPlan(apx_nodeInstance_t *self, apx_size_t len, uint32_t *epoch)
+{
+   apx_routingPlan_t *routingPlan;
+   for (;;)
+   {
+      uint32_t currentEpoch = apx_atomic_load32(&self->routingEpoch);
+      apx_atomic_add32(&self->numRoutingReaders[currentEpoch], 1u);
+      if (apx_atomic_load32(&self->routingEpoch) == currentEpoch)
+      {
+         *epoch = currentEpoch;
+         break;
+      }
+      apx_atomic_sub32(&self->numRoutingReaders[currentEpoch], 1u);
+   }
+   routingPlan = (apx_routingPlan_t*) apx_atomic_loadPtr((void * volatile *) &self->routingPlan);
+   if (routingPlan == 0)
+   {
+      apx_atomic_sub32(&self->numRoutingReaders[*epoch], 1u);
+      return routingPlan;
+   }
+   apx_atomic_add32(&self->routingStats.numSourceWrites, 1u);
+   apx_atomic_add64(&self->routingStats.numSourceBytes, (uint64_t) len);
+   return routingPlan;
+}
+
+static void apx_nodeInstance_releaseRoutingPlan(apx_nodeInstance_t *self, uint32_t epoch, uint32_t numRoutedWrites, uint32_t numTransmittedWrites, uint64_t numRoutedBytes)
+{
+   uint32_t maxFanOut;
+   apx_atomic_add32(&self->routingStats.numRoutedWrites, numRoutedWrites);
+   apx_atomic_add32(&self->routingStats.numTransmittedWrites, numTransmittedWrites);
+   apx_atomic_add64(&self->routingStats.numRoutedBytes, numRoutedBytes);
+   maxFanOut = apx_atomic_load32(&self->routingStats.maxFanOut);
+   while ( (numRoutedWrites > maxFanOut) && (!apx_atomic_compareExchange32(&self->routingStats.maxFanOut, maxFanOut, numRoutedWrites)) )
+   {
+      maxFanOut = apx_atomic_load32(&self->routingStats.maxFanOut);
+   }
+   apx_atomic_sub32(&self->numRoutingReaders[epoch], 1u);
+}
+
+/**
+ * Returns true when require port data written to this node needs to be transmitted to a remote client
+ */
+static bool apx_nodeInstance_isRemoteReceiver(apx_nodeInstance_t *self)
+{
+   return ( (self->connection != 0) && (self->mode == APX_SERVER_MODE) && (self->requirePortDataFile != 0) )? true : false;
+}
+
+/**
+ * Returns true when require port data written to this node is sent to the remote client through conflated transfers
+ */
+static bool apx_nodeInstance_isConflatedReceiver(apx_nodeInstance_t *self)
+{
+   return ( apx_nodeInstance_isRemoteReceiver(self) && (self->requirePortDirtyFlags != 0) && apx_connectionBase_isConflationEnabled(self->connection) )? true : false;
+}
+
+/**
+ * Returns the ID of the require port containing offset. Require ports are laid out in port ID order.
+ */
+static apx_portId_t apx_nodeInstance_findRequirePortByOffset(apx_nodeInstance_t *self, uint32_t offset)
+{
+   return apx_nodeInstance_findPortByOffset(self, apx_nodeInfo_getRequirePortDataProps, apx_nodeInfo_getNumRequirePorts(self->nodeInfo), offset);
+}
+
+/**
+ * Returns the ID of the port containing offset (numPorts if offset is beyond the last port). Ports are laid out in port ID order.
+ */
+static apx_portId_t apx_nodeInstance_findPortByOffset(apx_nodeInstance_t *self, apx_getPortDataPropsFunc *getPortDataProps, apx_portCount_t numPorts, uint32_t offset)
+{
+   apx_portId_t low = 0;
+   apx_portId_t high = (apx_portId_t) numPorts;
+   while (low < high)
+   {
+      apx_portId_t mid = low + (high - low) / 2;
+      const apx_portDataProps_t *props = getPortDataProps(self->nodeInfo, mid);
+      assert(props != 0);
+      if ( (props->offset + props->dataSize) <= offset)
+      {
+         low = mid + 1;
+      }
+      else
+      {
+         high = mid;
+      }
+   }
+   return low;
+}
+
+/**
+ * Marks all require ports overlapping len bytes starting at offset as dirty and makes sure a conflated transfer is queued.
+ * Queued ports and ports with the E attribute carry events rather than state and can't be conflated,
+ * their part of the write is sent right away.
+ */
+static apx_error_t apx_nodeInstance_conflateRequirePortData(apx_nodeInstance_t *self, uint32_t offset, uint32_t len)
+{
+   apx_error_t rc = APX_NO_ERROR;
+   apx_portId_t portId;
+   apx_portId_t numRequirePorts;
+   uint32_t endOffset = offset + len;
+   bool isTransferNeeded = false;
+   assert(self->nodeInfo != 0);
+   if (apx_file_isOpen(self->requirePortDataFile) == false)
+   {
+      return APX_NO_ERROR; //All require port data is sent when the remote side opens the file
+   }
+   numRequirePorts = (apx_portId_t) apx_nodeInfo_getNumRequirePorts(self->nodeInfo);
+   for (portId = apx_nodeInstance_findRequirePortByOffset(self, offset); portId < numRequirePorts; portId++)
+   {
+      const apx_portDataProps_t *props = apx_nodeInfo_getRequirePortDataProps(self->nodeInfo, portId);
+      assert(props != 0);
+      if (props->offset >= endOffset)
+      {
+         break;
+      }
+      if (!apx_portDataProps_isConflatable(props))
+      {
+         uint32_t beginOffset = (props->offset > offset)? props->offset : offset;
+         uint32_t portEndOffset = props->offset + props->dataSize;
+         if (portEndOffset > endOffset)
+         {
+            portEndOffset = endOffset;
+         }
+         rc = apx_nodeInstance_sendRequirePortData(self, beginOffset, portEndOffset - beginOffset);
+         if (rc != APX_NO_ERROR)
+         {
+            return rc;
+         }
+      }
+      else
+      {
+         (void) apx_nodeInstance_markRequirePortDirty(self, portId);
+         isTransferNeeded = true;
+      }
+   }
+   if (isTransferNeeded)
+   {
+      rc = apx_nodeInstance_requestConflatedTransfer(self);
+   }
+   return rc;
+}
+
+/**
+ * Queues a conflated transfer of the dirty require ports unless one is already pending.
+ */
+static apx_error_t apx_nodeInstance_requestConflatedTransfer(apx_nodeInstance_t *self)
+{
+   apx_error_t rc = APX_NO_ERROR;
+   if (apx_atomic_exchange32(&self->isConflatedTransferPending, 1u) == 0u)
+   {
+      rc = apx_connectionBase_updateRequirePortDataConflated(self->connection, self->requirePortDataFile, &self->requirePortConflationHandler);
+      if (rc != APX_NO_ERROR)
+      {
+         //Let the next write try again
+         apx_atomic_store32(&self->isConflatedTransferPending, 0u);
+         if (rc == APX_FILE_NOT_OPEN_ERROR)
+         {
+            rc = APX_NO_ERROR;
+         }
+      }
+   }
+   return rc;
+}
+
+/**
+ * Sends len bytes of require port data starting at offset to the remote side (server mode only).
+ * Data is read back from the node's own require port data buffer.
+ */
+static apx_error_t apx_nodeInstance_sendRequirePortData(apx_nodeInstance_t *self, uint32_t offset, uint32_t len)
+{
+   apx_error_t rc;
+   uint8_t stackBuffer[STACK_DATA_BUF_SIZE];
+   uint8_t *dataBuf = &stackBuffer[0];
+   assert(self != 0);
+   if ( (self->connection == 0) || (self->mode != APX_SERVER_MODE) )
+   {
+      return APX_NO_ERROR;
+   }
+   assert(self->requirePortDataFile != 0);
+   if (len > STACK_DATA_BUF_SIZE)
+   {
+      dataBuf = (uint8_t*) malloc(len);
+      if (dataBuf == 0)
+      {
+         return APX_MEM_ERROR;
+      }
+   }
+   rc = apx_nodeData_readRequirePortData(self->nodeData, dataBuf, offset, len);
+   if (rc == APX_NO_ERROR)
+   {
+      rc = apx_connectionBase_updateRequirePortDataDirect(self->connection, self->requirePortDataFile, dataBuf, offset, len);
+   }
+   if (dataBuf != &stackBuffer[0])
+   {
+      free(dataBuf);
+   }
+   return rc;
+}
+
+/**
+ * Creates one apx_portQueue_t for each queued port. Returns NULL (with errorCode set to APX_NO_ERROR) when none of the ports is queued.
+ */
+static apx_portQueue_t **apx_nodeInstance_createPortQueues(apx_nodeInstance_t *self, apx_getPortDataPropsFunc *getPortDataProps, apx_portCount_t numPorts, apx_error_t *errorCode)
+{
+   apx_portQueue_t **portQueues = (apx_portQueue_t**) 0;
+   apx_portId_t portId;
+   *errorCode = APX_NO_ERROR;
+   for (portId = 0; portId < numPorts; portId++)
+   {
+      const apx_portDataProps_t *props = getPortDataProps(self->nodeInfo, portId);
+      assert(props != 0);
+      if (apx_portDataProps_isQueued(props))
+      {
+         if (portQueues == 0)
+         {
+            portQueues = (apx_portQueue_t**) calloc( (size_t) numPorts, sizeof(apx_portQueue_t*));
+            if (portQueues == 0)
+            {
+               *errorCode = APX_MEM_ERROR;
+               return (apx_portQueue_t**) 0;
+            }
+         }
+         portQueues[portId] = apx_portQueue_new(props, APX_PORT_QUEUE_DEPTH_FACTOR);
+         if (portQueues[portId] == 0)
+         {
+            apx_nodeInstance_deletePortQueues(portQueues, numPorts);
+            *errorCode = APX_MEM_ERROR;
+            return (apx_portQueue_t**) 0;
+         }
+      }
+   }
+   return portQueues;
+}
+
+static void apx_nodeInstance_deletePortQueues(apx_portQueue_t **portQueues, apx_portCount_t numPorts)
+{
+   apx_portId_t portId;
+   for (portId = 0; portId < numPorts; portId++)
+   {
+      if (portQueues[portId] != 0)
+      {
+         apx_portQueue_delete(portQueues[portId]);
+      }
+   }
+   free(portQueues);
+}
+
+/**
+ * Makes sure the file manager has a transfer of queue waiting, unless one is already waiting.
+ * When the remote side has not yet opened the file, the elements stay in the queue until apx_nodeInstance_flushPortQueues is called.
+ */
+static apx_error_t apx_nodeInstance_scheduleQueuedTransfer(apx_nodeInstance_t *self, apx_portQueue_t *queue, apx_file_t *file, const apx_portDataProps_t *props, apx_fileQueueHandler_t *handler)
+{
+   apx_error_t rc = APX_NO_ERROR;
+   assert(props != 0);
+   if ( (self->connection != 0) && (file != 0) && apx_portQueue_requestTransfer(queue) )
+   {
+      rc = apx_connectionBase_updatePortDataQueued(self->connection, file, props->offset, props->dataSize, handler);
+      if (rc != APX_NO_ERROR)
+      {
+         apx_portQueue_completeTransfer(queue);
+         if (rc == APX_FILE_NOT_OPEN_ERROR)
+         {
+            rc = APX_NO_ERROR;
+         }
+      }
+   }
+   return rc;
+}
+
+/**
+ * Schedules transfers for all queues holding elements. Called right after the remote side has opened file.
+ */
+static apx_error_t apx_nodeInstance_flushPortQueues(apx_nodeInstance_t *self, apx_portQueue_t **portQueues, apx_getPortDataPropsFunc *getPortDataProps, apx_portCount_t numPorts, apx_file_t *file, apx_fileQueueHandler_t *handler)
+{
+   apx_portId_t portId;
+   for (portId = 0; portId < numPorts; portId++)
+   {
+      apx_portQueue_t *queue = portQueues[portId];
+      if ( (queue != 0) && (apx_portQueue_length(queue) > 0u) )
+      {
+         apx_error_t rc = apx_nodeInstance_scheduleQueuedTransfer(self, queue, file, getPortDataProps(self->nodeInfo, portId), handler);
+         if (rc != APX_NO_ERROR)
+         {
+            return rc;
+         }
+      }
+   }
+   return APX_NO_ERROR;
+}
+
+/**
+ * Client mode. Pushes the elements of every queued port that begins inside the received write into its queue.
+ */
+static apx_error_t apx_nodeInstance_enqueueReceivedElements(apx_nodeInstance_t *self, const uint8_t *src, uint32_t offset, uint32_t len)
+{
+   apx_portId_t portId;
+   apx_portId_t numRequirePorts;
+   uint32_t endOffset = offset + len;
+   assert(self->nodeInfo != 0);
+   numRequirePorts = (apx_portId_t) apx_nodeInfo_getNumRequirePorts(self->nodeInfo);
+   for (portId = apx_nodeInstance_findRequirePortByOffset(self, offset); portId < numRequirePorts; portId++)
+   {
+      const apx_portDataProps_t *props = apx_nodeInfo_getRequirePortDataProps(self->nodeInfo, portId);
+      assert(props != 0);
+      if (props->offset >= endOffset)
+      {
+         break;
+      }
+      if ( (self->requirePortQueues[portId] != 0) && (props->offset >= offset) )
+      {
+         uint32_t availableLen = endOffset - props->offset;
+         if (availableLen > props->dataSize)
+         {
+            availableLen = props->dataSize;
+         }
+         if (availableLen >= apx_portDataProps_getQueLenSize(props))
+         {
+            apx_error_t rc = apx_portQueue_unpackTransfer(self->requirePortQueues[portId], src + (props->offset - offset), availableLen);
+            if (rc != APX_NO_ERROR)
+            {
+               return rc;
+            }
+         }
+      }
+   }
+   return APX_NO_ERROR;
+}
+
+/**
+ * Server mode. Appends routed elements to a queued require port and schedules a transfer to the client.
+ */
+static apx_error_t apx_nodeInstance_enqueueRoutedElements(apx_nodeInstance_t *self, apx_portId_t requirePortId, const uint8_t *src, uint32_t len)
+{
+   apx_error_t rc;
+   apx_portQueue_t *queue = apx_nodeInstance_getRequirePortQueue(self, requirePortId);
+   if (queue == 0)
+   {
+      return APX_NO_ERROR;
+   }
+   rc = apx_portQueue_unpackTransfer(queue, src, len);
+   if ( (rc == APX_NO_ERROR) && apx_nodeInstance_isRemoteReceiver(self) )
+   {
+      rc = apx_nodeInstance_scheduleQueuedTransfer(self, queue, self->requirePortDataFile,
+            apx_nodeInfo_getRequirePortDataProps(self->nodeInfo, requirePortId), &self->requirePortQueueHandler);
+   }
+   return rc;
+}
+
+/**
+ * Called by the file manager worker when it processes a queued transfer of a provide port.
+ * The pending flag is cleared before the queue length is read, an element written after that schedules a new transfer.
+ */
+static uint32_t apx_nodeInstance_providePortQueueBeginTransfer(void *arg, apx_file_t *file, uint32_t offset)
+{
+   apx_nodeInstance_t *self = (apx_nodeInstance_t*) arg;
+   apx_portQueue_t *queue;
+   (void) file;
+   assert(self != 0);
+   queue = apx_nodeInstance_getProvidePortQueue(self, apx_nodeInstance_findPortByOffset(self, apx_nodeInfo_getProvidePortDataProps, apx_nodeInfo_getNumProvidePorts(self->nodeInfo), offset));
+   if (queue != 0)
+   {
+      apx_portQueue_completeTransfer(queue);
+      return (uint32_t) apx_portQueue_getTransferSize(queue);
+   }
+   return 0u;
+}
+
+/**
+ * Elements that did not fit into this transfer (the port holds at most maxQueLen of them) are sent in a new one.
+ */
+static apx_error_t apx_nodeInstance_providePortQueueReadData(void *arg, apx_file_t *file, uint32_t offset, uint8_t *dest, uint32_t len)
+{
+   apx_nodeInstance_t *self = (apx_nodeInstance_t*) arg;
+   apx_portId_t portId;
+   apx_portQueue_t *queue;
+   assert(self != 0);
+   portId = apx_nodeInstance_findPortByOffset(self, apx_nodeInfo_getProvidePortDataProps, apx_nodeInfo_getNumProvidePorts(self->nodeInfo), offset);
+   queue = apx_nodeInstance_getProvidePortQueue(self, portId);
+   if (queue == 0)
+   {
+      return APX_INVALID_ADDRESS_ERROR;
+   }
+   if (apx_portQueue_packTransfer(queue, dest, len) != len)
+   {
+      return APX_LENGTH_ERROR;
+   }
+   if (apx_portQueue_length(queue) > 0u)
+   {
+      return apx_nodeInstance_scheduleQueuedTransfer(self, queue, file, apx_nodeInfo_getProvidePortDataProps(self->nodeInfo, portId), &self->providePortQueueHandler);
+   }
+   return APX_NO_ERROR;
+}
+
+static uint32_t apx_nodeInstance_requirePortQueueBeginTransfer(void *arg, apx_file_t *file, uint32_t offset)
+{
+   apx_nodeInstance_t *self = (apx_nodeInstance_t*) arg;
+   apx_portQueue_t *queue;
+   (void) file;
+   assert(self != 0);
+   queue = apx_nodeInstance_getRequirePortQueue(self, apx_nodeInstance_findRequirePortByOffset(self, offset));
+   if (queue != 0)
+   {
+      apx_portQueue_completeTransfer(queue);
+      return (uint32_t) apx_portQueue_getTransferSize(queue);
+   }
+   return 0u;
+}
+
+static apx_error_t apx_nodeInstance_requirePortQueueReadData(void *arg, apx_file_t *file, uint32_t offset, uint8_t *dest, uint32_t len)
+{
+   apx_nodeInstance_t *self = (apx_nodeInstance_t*) arg;
+   apx_portId_t portId;
+   apx_portQueue_t *queue;
+   assert(self != 0);
+   portId = apx_nodeInstance_findRequirePortByOffset(self, offset);
+   queue = apx_nodeInstance_getRequirePortQueue(self, portId);
+   if (queue == 0)
+   {
+      return APX_INVALID_ADDRESS_ERROR;
+   }
+   if (apx_portQueue_packTransfer(queue, dest, len) != len)
+   {
+      return APX_LENGTH_ERROR;
+   }
+   if (apx_portQueue_length(queue) > 0u)
+   {
+      return apx_nodeInstance_scheduleQueuedTransfer(self, queue, file, apx_nodeInfo_getRequirePortDataProps(self->nodeInfo, portId), &self->requirePortQueueHandler);
+   }
+   return APX_NO_ERROR;
+}
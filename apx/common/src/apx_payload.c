@@ -0,0 +1,108 @@
+/*****************************************************************************
+* \file      apx_payload.c
+* \author    Conny Gustafsson
+* \date      2026-10-18
+* \brief     Reference counted immutable data buffer
+*
+* Copyright (c) 2026 Conny Gustafsson
+* Permission is hereby granted, free of charge, to any person obtaining a copy of
+* this software and associated documentation files (the "Software"), to deal in
+* the Software without restriction, including without limitation the rights to
+* use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+* the Software, and to permit persons to whom the Software is furnished to do so,
+* subject to the following conditions:
+
+* The above copyright notice and this permission notice shall be included in all
+* copies or substantial portions of the Software.
+
+* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+* IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+* FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+* COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+* IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+* CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+*
+******************************************************************************/
+//////////////////////////////////////////////////////////////////////////////
+// INCLUDES
+//////////////////////////////////////////////////////////////////////////////
+#include <stdlib.h>
+#include <string.h>
+#include "apx_payload.h"
+#include "apx_atomic.h"
+#ifdef MEM_LEAK_CHECK
+#include "CMemLeak.h"
+#endif
+
+//////////////////////////////////////////////////////////////////////////////
+// PUBLIC FUNCTIONS
+//////////////////////////////////////////////////////////////////////////////
+
+/**
+ * Copies dataLen bytes from data into a new payload. The caller owns the initial reference.
+ */
+apx_payload_t *apx_payload_new(const uint8_t *data, uint32_t dataLen)
+{
+   if ( (data != 0) || (dataLen == 0u) )
+   {
+      apx_payload_t *self = (apx_payload_t*) malloc(sizeof(apx_payload_t) + dataLen);
+      if (self != 0)
+      {
+         self->refCount = 1u;
+         self->dataLen = dataLen;
+         self->data = (uint8_t*) (self + 1);
+         if (dataLen > 0u)
+         {
+            memcpy(self->data, data, dataLen);
+         }
+      }
+      return self;
+   }
+   return (apx_payload_t*) 0;
+}
+
+void apx_payload_retain(apx_payload_t *self)
+{
+   if (self != 0)
+   {
+      (void) apx_atomic_add32(&self->refCount, 1u);
+   }
+}
+
+void apx_payload_release(apx_payload_t *self)
+{
+   if (self != 0)
+   {
+      if (apx_atomic_sub32(&self->refCount, 1u) == 0u)
+      {
+         free(self);
+      }
+   }
+}
+
+const uint8_t *apx_payload_getData(const apx_payload_t *self)
+{
+   if (self != 0)
+   {
+      return self->data;
+   }
+   return (const uint8_t*) 0;
+}
+
+uint32_t apx_payload_getDataLen(const apx_payload_t *self)
+{
+   if (self != 0)
+   {
+      return self->dataLen;
+   }
+   return 0u;
+}
+
+uint32_t apx_payload_getRefCount(apx_payload_t *self)
+{
+   if (self != 0)
+   {
+      return apx_atomic_load32(&self->refCount);
+   }
+   return 0u;
+}
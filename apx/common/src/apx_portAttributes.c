@@ -41,6 +41,7 @@ apx_error_t apx_portAttributes_create(apx_portAttributes_t *self, const char *at
       self->isParameter = false;
       self->isQueued = false;
       self->isDynamic = false;
+      self->isEvent = false;
       self->dynLen = 0u;
       self->queueLen = 0u;
       self->initValue = (dtl_dv_t*) 0;
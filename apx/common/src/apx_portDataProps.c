@@ -29,6 +29,7 @@
 #include <malloc.h>
 #include "apx_error.h"
 #include "apx_portDataProps.h"
+#include "pack.h"
 #ifdef MEM_LEAK_CHECK
 #include "CMemLeak.h"
 #endif
@@ -56,9 +57,13 @@ void apx_portDataProps_create(apx_portDataProps_t *self, apx_portType_t portType
       self->portId = portId;
       self->offset = offset;
       self->dataSize = dataSize;
+      self->elementSize = dataSize;
       self->queLenType = APX_QUE_LEN_NONE;
       self->isDynamicArray = false;
+      self->dynLenType = APX_DYN_LEN_NONE;
+      self->arrayElementSize = 0u;
       self->maxQueLen = 0;
+      self->isEvent = false;
    }
 }
 
@@ -94,6 +99,162 @@ bool apx_portDataProps_isPlainOldData(const apx_portDataProps_t *self)
    return false;
 }
 
+/**
+ * Turns the port into a queued port holding at most maxQueLen elements.
+ * The port data then consists of a little-endian length header followed by maxQueLen element slots.
+ */
+void apx_portDataProps_setQueued(apx_portDataProps_t *self, apx_size_t maxQueLen)
+{
+   if ( (self != 0) && (maxQueLen > 0u) )
+   {
+      if (maxQueLen <= UINT8_MAX)
+      {
+         self->queLenType = APX_QUE_LEN_U8;
+      }
+      else if (maxQueLen <= UINT16_MAX)
+      {
+         self->queLenType = APX_QUE_LEN_U16;
+      }
+      else
+      {
+         self->queLenType = APX_QUE_LEN_U32;
+      }
+      self->maxQueLen = maxQueLen;
+      self->dataSize = apx_portDataProps_getQueLenSize(self) + maxQueLen * self->elementSize;
+   }
+}
+
+bool apx_portDataProps_isQueued(const apx_portDataProps_t *self)
+{
+   if ( (self != 0) && (self->queLenType != APX_QUE_LEN_NONE) )
+   {
+      return true;
+   }
+   return false;
+}
+
+/**
+ * Returns true if writes to the port may be merged such that the receiver only gets the latest value.
+ * Queued ports and ports with the E (event) attribute carry events rather than state and can't be conflated.
+ */
+bool apx_portDataProps_isConflatable(const apx_portDataProps_t *self)
+{
+   if ( (self != 0) && (!self->isEvent) && (self->queLenType == APX_QUE_LEN_NONE) )
+   {
+      return true;
+   }
+   return false;
+}
+
+/**
+ * Returns size (in bytes) of the length header in front of the queued elements, 0 for ports that are not queued.
+ */
+apx_size_t apx_portDataProps_getQueLenSize(const apx_portDataProps_t *self)
+{
+   if (self != 0)
+   {
+      switch(self->queLenType)
+      {
+      case APX_QUE_LEN_U8:
+         return (apx_size_t) UINT8_SIZE;
+      case APX_QUE_LEN_U16:
+         return (apx_size_t) UINT16_SIZE;
+      case APX_QUE_LEN_U32:
+         return (apx_size_t) UINT32_SIZE;
+      default:
+         break;
+      }
+   }
+   return 0u;
+}
+
+/**
+ * Marks the port data as a dynamic array with room for maxArrayLen elements after its length header.
+ * Must be called before apx_portDataProps_setQueued.
+ */
+void apx_portDataProps_setDynamicArray(apx_portDataProps_t *self, apx_dynLenType_t dynLenType, uint32_t maxArrayLen)
+{
+   if ( (self != 0) && (dynLenType != APX_DYN_LEN_NONE) && (maxArrayLen > 0u) )
+   {
+      self->isDynamicArray = true;
+      self->dynLenType = dynLenType;
+      self->arrayElementSize = (self->elementSize - apx_portDataProps_getDynLenSize(self)) / maxArrayLen;
+   }
+}
+
+/**
+ * Returns size (in bytes) of the array length header in front of dynamic array data, 0 for other ports.
+ */
+apx_size_t apx_portDataProps_getDynLenSize(const apx_portDataProps_t *self)
+{
+   if (self != 0)
+   {
+      switch(self->dynLenType)
+      {
+      case APX_DYN_LEN_U8:
+         return (apx_size_t) UINT8_SIZE;
+      case APX_DYN_LEN_U16:
+         return (apx_size_t) UINT16_SIZE;
+      case APX_DYN_LEN_U32:
+         return (apx_size_t) UINT32_SIZE;
+      default:
+         break;
+      }
+   }
+   return 0u;
+}
+
+/**
+ * Returns number of bytes that needs to be transferred for the port given its packed data (len bytes available in data).
+ * This is dataSize for all ports except (non-queued) dynamic arrays where it is the array length header plus the used elements.
+ */
+apx_size_t apx_portDataProps_getUsedDataSize(const apx_portDataProps_t *self, const uint8_t *data, apx_size_t len)
+{
+   if (self != 0)
+   {
+      if (self->isDynamicArray && (self->queLenType == APX_QUE_LEN_NONE) )
+      {
+         return apx_portDataProps_calcDynArrayDataSize(self->dynLenType, self->arrayElementSize, self->dataSize, data, len);
+      }
+      return self->dataSize;
+   }
+   return 0u;
+}
+
+/**
+ * Same as apx_portDataProps_getUsedDataSize but for callers that only keep the dynamic array properties.
+ * Returns maxDataSize when the length header is not available or exceeds the maximum array length.
+ */
+apx_size_t apx_portDataProps_calcDynArrayDataSize(apx_dynLenType_t dynLenType, apx_size_t arrayElementSize, apx_size_t maxDataSize, const uint8_t *data, apx_size_t len)
+{
+   uint8_t lenSize;
+   uint32_t arrayLen;
+   switch(dynLenType)
+   {
+   case APX_DYN_LEN_U8:
+      lenSize = UINT8_SIZE;
+      break;
+   case APX_DYN_LEN_U16:
+      lenSize = UINT16_SIZE;
+      break;
+   case APX_DYN_LEN_U32:
+      lenSize = UINT32_SIZE;
+      break;
+   default:
+      return maxDataSize;
+   }
+   if ( (data == 0) || (len < lenSize) || (arrayElementSize == 0u) || (maxDataSize < lenSize) )
+   {
+      return maxDataSize;
+   }
+   arrayLen = unpackLE(data, lenSize);
+   if (arrayLen > ( (maxDataSize - lenSize) / arrayElementSize) )
+   {
+      return maxDataSize;
+   }
+   return lenSize + arrayLen * arrayElementSize;
+}
+
 apx_size_t apx_portDataProps_sumDataSize(const apx_portDataProps_t *propsArray, apx_portCount_t numPorts)
 {
    apx_size_t sum = 0u;
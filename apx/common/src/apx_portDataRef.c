@@ -57,6 +57,7 @@ void apx_portRef_create(apx_portRef_t *self, struct apx_nodeInstance_tag *nodeIn
       self->nodeInstance = nodeInstance;
       self->portId = portId;
       self->portDataProps = portDataProps;
+      self->signatureId = APX_INVALID_SIGNATURE_ID;
    }
 }
 
@@ -0,0 +1,296 @@
+/*****************************************************************************
+* \file      apx_portQueue.c
+* \author    Conny Gustafsson
+* \date      2026-10-18
+* \brief     Element queue and transfer state of a queued (Q[N]) port
+*
+* Copyright (c) 2026 Conny Gustafsson
+* Permission is hereby granted, free of charge, to any person obtaining a copy of
+* this software and associated documentation files (the "Software"), to deal in
+* the Software without restriction, including without limitation the rights to
+* use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+* the Software, and to permit persons to whom the Software is furnished to do so,
+* subject to the following conditions:
+
+* The above copyright notice and this permission notice shall be included in all
+* copies or substantial portions of the Software.
+
+* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+* IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+* FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+* COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+* IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+* CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+*
+******************************************************************************/
+//////////////////////////////////////////////////////////////////////////////
+// INCLUDES
+//////////////////////////////////////////////////////////////////////////////
+#include <malloc.h>
+#include <string.h>
+#include <assert.h>
+#include "apx_portQueue.h"
+#include "apx_atomic.h"
+#include "pack.h"
+#ifdef MEM_LEAK_CHECK
+#include "CMemLeak.h"
+#endif
+
+//////////////////////////////////////////////////////////////////////////////
+// PRIVATE CONSTANTS AND DATA TYPES
+//////////////////////////////////////////////////////////////////////////////
+
+//////////////////////////////////////////////////////////////////////////////
+// PRIVATE FUNCTION PROTOTYPES
+//////////////////////////////////////////////////////////////////////////////
+
+//////////////////////////////////////////////////////////////////////////////
+// PRIVATE VARIABLES
+//////////////////////////////////////////////////////////////////////////////
+
+//////////////////////////////////////////////////////////////////////////////
+// PUBLIC FUNCTIONS
+//////////////////////////////////////////////////////////////////////////////
+/**
+ * Creates a queue for the queued port described by props. The element ring holds depthFactor transfers worth of elements
+ * (rounded up to a power of two) which lets the producer keep going while a transfer is in flight.
+ */
+apx_error_t apx_portQueue_create(apx_portQueue_t *self, const apx_portDataProps_t *props, uint32_t depthFactor)
+{
+   if ( (self != 0) && (props != 0) && (apx_portDataProps_isQueued(props)) && (depthFactor > 0u) )
+   {
+      uint64_t numElements = (uint64_t) props->maxQueLen * depthFactor;
+      apx_error_t result;
+      memset(self, 0, sizeof(apx_portQueue_t));
+      if (numElements > UINT32_MAX)
+      {
+         return APX_INVALID_ARGUMENT_ERROR;
+      }
+      self->maxQueLen = props->maxQueLen;
+      self->queLenSize = apx_portDataProps_getQueLenSize(props);
+      result = apx_spscRing_create(&self->elements, (uint32_t) props->elementSize, (uint32_t) numElements);
+      if (result == APX_NO_ERROR)
+      {
+         SPINLOCK_INIT(self->producerLock);
+         SPINLOCK_INIT(self->consumerLock);
+      }
+      return result;
+   }
+   return APX_INVALID_ARGUMENT_ERROR;
+}
+
+void apx_portQueue_destroy(apx_portQueue_t *self)
+{
+   if (self != 0)
+   {
+      apx_spscRing_destroy(&self->elements);
+      SPINLOCK_DESTROY(self->producerLock);
+      SPINLOCK_DESTROY(self->consumerLock);
+   }
+}
+
+apx_portQueue_t *apx_portQueue_new(const apx_portDataProps_t *props, uint32_t depthFactor)
+{
+   apx_portQueue_t *self = (apx_portQueue_t*) malloc(sizeof(apx_portQueue_t));
+   if (self != 0)
+   {
+      apx_error_t result = apx_portQueue_create(self, props, depthFactor);
+      if (result != APX_NO_ERROR)
+      {
+         free(self);
+         self = (apx_portQueue_t*) 0;
+      }
+   }
+   return self;
+}
+
+void apx_portQueue_delete(apx_portQueue_t *self)
+{
+   if (self != 0)
+   {
+      apx_portQueue_destroy(self);
+      free(self);
+   }
+}
+
+/**
+ * Appends one packed element. Concurrent producers are serialized by producerLock.
+ * Returns APX_QUEUE_FULL_ERROR (and counts the element as dropped) when the ring is full.
+ */
+apx_error_t apx_portQueue_push(apx_portQueue_t *self, const uint8_t *element)
+{
+   if ( (self != 0) && (element != 0) )
+   {
+      apx_error_t rc;
+      SPINLOCK_ENTER(self->producerLock);
+      rc = apx_spscRing_push(&self->elements, element);
+      SPINLOCK_LEAVE(self->producerLock);
+      if (rc != APX_NO_ERROR)
+      {
+         (void) apx_atomic_add32(&self->numDroppedElements, 1u);
+         return APX_QUEUE_FULL_ERROR;
+      }
+      return APX_NO_ERROR;
+   }
+   return APX_INVALID_ARGUMENT_ERROR;
+}
+
+/**
+ * Drains up to maxNumElements packed elements into dest. Concurrent consumers are serialized by consumerLock,
+ * each element is handed to exactly one caller.
+ */
+uint32_t apx_portQueue_read(apx_portQueue_t *self, uint8_t *dest, uint32_t maxNumElements)
+{
+   if (self != 0)
+   {
+      uint32_t numElements;
+      SPINLOCK_ENTER(self->consumerLock);
+      numElements = apx_spscRing_read(&self->elements, dest, maxNumElements);
+      SPINLOCK_LEAVE(self->consumerLock);
+      return numElements;
+   }
+   return 0u;
+}
+
+uint32_t apx_portQueue_length(apx_portQueue_t *self)
+{
+   if (self != 0)
+   {
+      return apx_spscRing_length(&self->elements);
+   }
+   return 0u;
+}
+
+uint32_t apx_portQueue_capacity(const apx_portQueue_t *self)
+{
+   if (self != 0)
+   {
+      return apx_spscRing_capacity(&self->elements);
+   }
+   return 0u;
+}
+
+apx_size_t apx_portQueue_elementSize(const apx_portQueue_t *self)
+{
+   if (self != 0)
+   {
+      return (apx_size_t) apx_spscRing_elementSize(&self->elements);
+   }
+   return 0u;
+}
+
+/**
+ * Returns number of bytes the next transfer needs (count header plus elements), 0 when there is nothing to send.
+ */
+apx_size_t apx_portQueue_getTransferSize(apx_portQueue_t *self)
+{
+   if (self != 0)
+   {
+      apx_size_t numElements = (apx_size_t) apx_spscRing_length(&self->elements);
+      if (numElements > 0u)
+      {
+         if (numElements > self->maxQueLen)
+         {
+            numElements = self->maxQueLen;
+         }
+         return self->queLenSize + numElements * (apx_size_t) apx_spscRing_elementSize(&self->elements);
+      }
+   }
+   return 0u;
+}
+
+/**
+ * Moves as many elements as fit in destLen (at most maxQueLen) into dest, preceded by the element count.
+ * Runs on the consuming side (under consumerLock). Returns number of bytes written to dest.
+ */
+apx_size_t apx_portQueue_packTransfer(apx_portQueue_t *self, uint8_t *dest, apx_size_t destLen)
+{
+   if ( (self != 0) && (dest != 0) && (destLen >= self->queLenSize) )
+   {
+      apx_size_t elementSize = (apx_size_t) apx_spscRing_elementSize(&self->elements);
+      apx_size_t maxNumElements = (destLen - self->queLenSize) / elementSize;
+      uint32_t numElements;
+      if (maxNumElements > self->maxQueLen)
+      {
+         maxNumElements = self->maxQueLen;
+      }
+      SPINLOCK_ENTER(self->consumerLock);
+      numElements = apx_spscRing_read(&self->elements, dest + self->queLenSize, (uint32_t) maxNumElements);
+      SPINLOCK_LEAVE(self->consumerLock);
+      packLE(dest, numElements, (uint8_t) self->queLenSize);
+      return self->queLenSize + (apx_size_t) numElements * elementSize;
+   }
+   return 0u;
+}
+
+/**
+ * Parses a transfer (count header followed by elements) and pushes the elements into the queue.
+ * Runs on the producing side (under producerLock), the elements of one transfer stay contiguous in the queue even
+ * when several connections route into the same port. Elements that do not fit are counted as dropped.
+ */
+apx_error_t apx_portQueue_unpackTransfer(apx_portQueue_t *self, const uint8_t *src, apx_size_t len)
+{
+   if ( (self != 0) && (src != 0) )
+   {
+      apx_size_t elementSize;
+      uint32_t numElements;
+      uint32_t numPushed;
+      if (len < self->queLenSize)
+      {
+         return APX_LENGTH_ERROR;
+      }
+      elementSize = (apx_size_t) apx_spscRing_elementSize(&self->elements);
+      numElements = (uint32_t) unpackLE(src, (uint8_t) self->queLenSize);
+      if ( (numElements > self->maxQueLen) || ( (self->queLenSize + (apx_size_t) numElements * elementSize) > len) )
+      {
+         return APX_LENGTH_ERROR;
+      }
+      SPINLOCK_ENTER(self->producerLock);
+      numPushed = apx_spscRing_pushMany(&self->elements, src + self->queLenSize, numElements);
+      SPINLOCK_LEAVE(self->producerLock);
+      if (numPushed < numElements)
+      {
+         (void) apx_atomic_add32(&self->numDroppedElements, numElements - numPushed);
+      }
+      return APX_NO_ERROR;
+   }
+   return APX_INVALID_ARGUMENT_ERROR;
+}
+
+/**
+ * Marks a transfer as pending. Returns true when the caller is responsible for scheduling it,
+ * false when a transfer is already waiting (it will pick up the new elements as well).
+ */
+bool apx_portQueue_requestTransfer(apx_portQueue_t *self)
+{
+   if (self != 0)
+   {
+      return (apx_atomic_exchange32(&self->isTransferPending, 1u) == 0u)? true : false;
+   }
+   return false;
+}
+
+/**
+ * Called by the consumer just before it takes elements for a transfer. Elements pushed after this point need a new transfer.
+ */
+void apx_portQueue_completeTransfer(apx_portQueue_t *self)
+{
+   if (self != 0)
+   {
+      apx_atomic_store32(&self->isTransferPending, 0u);
+      apx_atomic_fence(); //orders the store above with the ring loads that follow, pairs with the exchange in requestTransfer
+   }
+}
+
+uint32_t apx_portQueue_getNumDroppedElements(apx_portQueue_t *self)
+{
+   if (self != 0)
+   {
+      return apx_atomic_load32(&self->numDroppedElements);
+   }
+   return 0u;
+}
+
+//////////////////////////////////////////////////////////////////////////////
+// PRIVATE FUNCTIONS
+//////////////////////////////////////////////////////////////////////////////
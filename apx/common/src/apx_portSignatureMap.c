@@ -38,6 +38,7 @@
 //////////////////////////////////////////////////////////////////////////////
 // CONSTANTS AND DATA TYPES
 //////////////////////////////////////////////////////////////////////////////
+#define ENTRIES_MIN_LEN 64u
 
 //////////////////////////////////////////////////////////////////////////////
 // LOCAL FUNCTION PROTOTYPES
@@ -45,11 +46,11 @@
 static apx_error_t apx_portSignatureMap_connectRequirePortsInternal(apx_portSignatureMap_t *self, apx_nodeInstance_t *nodeInstance, apx_nodeInfo_t *nodeInfo);
 static apx_error_t apx_portSignatureMap_connectProvidePortsInternal(apx_portSignatureMap_t *self, apx_nodeInstance_t *nodeInstance, apx_nodeInfo_t *nodeInfo);
 static apx_error_t apx_portSignatureMap_insert(apx_portSignatureMap_t *self, const char *portSignature, apx_portRef_t *portRef);
-static apx_portSignatureMapEntry_t *apx_portSignatureMap_createNewEntry(apx_portSignatureMap_t *self, const char *portSignature);
+static apx_portSignatureMapEntry_t *apx_portSignatureMap_createNewEntry(apx_portSignatureMap_t *self, apx_signatureId_t signatureId);
 static apx_error_t apx_portSignatureMap_disconnectRequirePortsInternal(apx_portSignatureMap_t *self, apx_nodeInstance_t *nodeInstance, apx_nodeInfo_t *nodeInfo);
 static apx_error_t apx_portSignatureMap_disconnectProvidePortsInternal(apx_portSignatureMap_t *self, apx_nodeInstance_t *nodeInstance, apx_nodeInfo_t *nodeInfo);
 static apx_error_t apx_portSignatureMap_remove(apx_portSignatureMap_t *self, const char *portSignature, apx_portRef_t *portRef);
-static void apx_portSignatureMap_deleteEntry(apx_portSignatureMap_t *self, const char *portSignature);
+static void apx_portSignatureMap_deleteEntry(apx_portSignatureMap_t *self, apx_signatureId_t signatureId);
 
 //////////////////////////////////////////////////////////////////////////////
 // LOCAL VARIABLES
@@ -62,24 +63,47 @@ void apx_portSignatureMap_create(apx_portSignatureMap_t *self)
 {
    if (self != 0)
    {
-      adt_hash_create(&self->internalMap, apx_portSignatureMapEntry_vdelete);
+      apx_signatureTable_create(&self->signatureTable);
+      self->entries = (apx_portSignatureMapEntry_t**) 0;
+      self->entriesLen = 0u;
+      self->numEntries = 0;
    }
 }
 
 void apx_portSignatureMap_destroy(apx_portSignatureMap_t *self)
 {
-   adt_hash_destroy(&self->internalMap);
+   if (self != 0)
+   {
+      if (self->entries != 0)
+      {
+         uint32_t i;
+         for (i = 0u; i < self->entriesLen; i++)
+         {
+            if (self->entries[i] != 0)
+            {
+               apx_portSignatureMapEntry_delete(self->entries[i]);
+            }
+         }
+         free(self->entries);
+      }
+      apx_signatureTable_destroy(&self->signatureTable);
+   }
 }
 
 apx_portSignatureMapEntry_t *apx_portSignatureMap_find(apx_portSignatureMap_t *self, const char *portSignature)
 {
    if ( (self != 0) && (portSignature != 0) )
    {
-      void **ppResult = adt_hash_get(&self->internalMap, portSignature);
-      if (ppResult != 0)
-      {
-         return (apx_portSignatureMapEntry_t*) *ppResult;
-      }
+      return apx_portSignatureMap_findById(self, apx_signatureTable_find(&self->signatureTable, portSignature));
+   }
+   return (apx_portSignatureMapEntry_t*) 0;
+}
+
+apx_portSignatureMapEntry_t *apx_portSignatureMap_findById(apx_portSignatureMap_t *self, apx_signatureId_t signatureId)
+{
+   if ( (self != 0) && (signatureId < self->entriesLen) )
+   {
+      return self->entries[signatureId];
    }
    return (apx_portSignatureMapEntry_t*) 0;
 }
@@ -88,11 +112,19 @@ int32_t apx_portSignatureMap_length(apx_portSignatureMap_t *self)
 {
    if (self != 0)
    {
-      return adt_hash_length(&self->internalMap);
+      return self->numEntries;
    }
    return -1;
 }
 
+void apx_portSignatureMap_getSignatureTableStats(apx_portSignatureMap_t *self, apx_signatureTableStats_t *stats)
+{
+   if (self != 0)
+   {
+      apx_signatureTable_getStats(&self->signatureTable, stats);
+   }
+}
+
 apx_portSignatureMap_t *apx_portSignatureMap_new(void)
 {
    apx_portSignatureMap_t *self = (apx_portSignatureMap_t*) malloc(sizeof(apx_portSignatureMap_t));
@@ -228,19 +260,28 @@ static apx_error_t apx_portSignatureMap_connectProvidePortsInternal(apx_portSign
 static apx_error_t apx_portSignatureMap_insert(apx_portSignatureMap_t *self, const char *portSignature, apx_portRef_t *portRef)
 {
    apx_portSignatureMapEntry_t *entry;
+   apx_signatureId_t signatureId;
+   apx_error_t rc;
    assert(self != 0);
    assert(portSignature != 0);
    assert(strlen(portSignature) > 0);
    assert(portRef != 0);
-   entry = apx_portSignatureMap_find(self, portSignature);
+   rc = apx_signatureTable_intern(&self->signatureTable, portSignature, &signatureId);
+   if (rc != APX_NO_ERROR)
+   {
+      return rc;
+   }
+   entry = apx_portSignatureMap_findById(self, signatureId);
    if (entry == 0)
    {
-      entry = apx_portSignatureMap_createNewEntry(self, portSignature);
+      entry = apx_portSignatureMap_createNewEntry(self, signatureId);
       if (entry == 0)
       {
+         apx_signatureTable_release(&self->signatureTable, signatureId);
          return APX_MEM_ERROR;
       }
    }
+   portRef->signatureId = signatureId;
    assert(entry != 0);
    if (apx_portRef_isProvidePort(portRef))
    {
@@ -255,12 +296,32 @@ static apx_error_t apx_portSignatureMap_insert(apx_portSignatureMap_t *self, con
    return APX_NO_ERROR;
 }
 
-static apx_portSignatureMapEntry_t *apx_portSignatureMap_createNewEntry(apx_portSignatureMap_t *self, const char *portSignature)
+static apx_portSignatureMapEntry_t *apx_portSignatureMap_createNewEntry(apx_portSignatureMap_t *self, apx_signatureId_t signatureId)
 {
-   apx_portSignatureMapEntry_t *entry = apx_portSignatureMapEntry_new();
+   apx_portSignatureMapEntry_t *entry;
+   if (signatureId >= self->entriesLen)
+   {
+      uint32_t newLen = (self->entriesLen < ENTRIES_MIN_LEN)? ENTRIES_MIN_LEN : self->entriesLen * 2u;
+      apx_portSignatureMapEntry_t **entries;
+      if (newLen <= signatureId)
+      {
+         newLen = signatureId + 1u;
+      }
+      entries = (apx_portSignatureMapEntry_t**) realloc(self->entries, newLen * sizeof(apx_portSignatureMapEntry_t*));
+      if (entries == 0)
+      {
+         return (apx_portSignatureMapEntry_t*) 0;
+      }
+      memset(&entries[self->entriesLen], 0, (newLen - self->entriesLen) * sizeof(apx_portSignatureMapEntry_t*));
+      self->entries = entries;
+      self->entriesLen = newLen;
+   }
+   entry = apx_portSignatureMapEntry_new();
    if (entry != 0)
    {
-      adt_hash_set(&self->internalMap, portSignature, entry);
+      assert(self->entries[signatureId] == 0);
+      self->entries[signatureId] = entry;
+      self->numEntries++;
    }
    return entry;
 }
@@ -309,11 +370,18 @@ static apx_error_t apx_portSignatureMap_disconnectProvidePortsInternal(apx_portS
 static apx_error_t apx_portSignatureMap_remove(apx_portSignatureMap_t *self, const char *portSignature, apx_portRef_t *portRef)
 {
    apx_portSignatureMapEntry_t *entry;
+   apx_signatureId_t signatureId;
    assert(self != 0);
    assert(portSignature != 0);
    assert(strlen(portSignature) > 0);
    assert(portRef != 0);
-   entry = apx_portSignatureMap_find(self, portSignature);
+   signatureId = portRef->signatureId;
+   if (signatureId == APX_INVALID_SIGNATURE_ID)
+   {
+      //Port is not connected through this map
+      return APX_NOT_FOUND_ERROR;
+   }
+   entry = apx_portSignatureMap_findById(self, signatureId);
    if (entry == 0)
    {
       return APX_NOT_FOUND_ERROR;
@@ -331,18 +399,23 @@ static apx_error_t apx_portSignatureMap_remove(apx_portSignatureMap_t *self, con
    }
    if (apx_portSignatureMapEntry_isEmpty(entry))
    {
-      apx_portSignatureMap_deleteEntry(self, portSignature);
+      apx_portSignatureMap_deleteEntry(self, signatureId);
    }
+   //The ID can be handed out to another signature once its last reference is released
+   portRef->signatureId = APX_INVALID_SIGNATURE_ID;
+   apx_signatureTable_release(&self->signatureTable, signatureId);
    return APX_NO_ERROR;
 }
 
-static void apx_portSignatureMap_deleteEntry(apx_portSignatureMap_t *self, const char *portSignature)
+static void apx_portSignatureMap_deleteEntry(apx_portSignatureMap_t *self, apx_signatureId_t signatureId)
 {
-   if ( (self != 0) && (portSignature != 0) )
+   if ( (self != 0) && (signatureId < self->entriesLen) )
    {
-      apx_portSignatureMapEntry_t *entry = (apx_portSignatureMapEntry_t*) adt_hash_remove(&self->internalMap, portSignature);
+      apx_portSignatureMapEntry_t *entry = self->entries[signatureId];
       if (entry != 0)
       {
+         self->entries[signatureId] = (apx_portSignatureMapEntry_t*) 0;
+         self->numEntries--;
          apx_portSignatureMapEntry_delete(entry);
       }
    }
@@ -0,0 +1,325 @@
+/*****************************************************************************
+* \file      apx_routingPlan.c
+* \author    Conny Gustafsson
+* \date      2026-10-18
+* \brief     Immutable data routing plan for the provide ports of one node
+*
+* Copyright (c) 2026 Conny Gustafsson
+* Permission is hereby granted, free of charge, to any person obtaining a copy of
+* this software and associated documentation files (the "Software"), to deal in
+* the Software without restriction, including without limitation the rights to
+* use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+* the Software, and to permit persons to whom the Software is furnished to do so,
+* subject to the following conditions:
+
+* The above copyright notice and this permission notice shall be included in all
+* copies or substantial portions of the Software.
+
+* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+* IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+* FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+* COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+* IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+* CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+*
+******************************************************************************/
+//////////////////////////////////////////////////////////////////////////////
+// INCLUDES
+//////////////////////////////////////////////////////////////////////////////
+#include <malloc.h>
+#include <string.h>
+#include <assert.h>
+#include <stdlib.h>
+#include "apx_routingPlan.h"
+#ifdef MEM_LEAK_CHECK
+#include "CMemLeak.h"
+#endif
+
+//////////////////////////////////////////////////////////////////////////////
+// PRIVATE CONSTANTS AND DATA TYPES
+//////////////////////////////////////////////////////////////////////////////
+
+//////////////////////////////////////////////////////////////////////////////
+// PRIVATE FUNCTION PROTOTYPES
+//////////////////////////////////////////////////////////////////////////////
+static int apx_routingPlan_compareWrites(const void *a, const void *b);
+static bool apx_routingPlan_isRoutable(const apx_portDataProps_t *providePortDataProps, const apx_portDataProps_t *requirePortDataProps);
+
+//////////////////////////////////////////////////////////////////////////////
+// PRIVATE VARIABLES
+//////////////////////////////////////////////////////////////////////////////
+
+//////////////////////////////////////////////////////////////////////////////
+// PUBLIC FUNCTIONS
+//////////////////////////////////////////////////////////////////////////////
+void apx_routingPlan_create(apx_routingPlan_t *self)
+{
+   if (self != 0)
+   {
+      self->ports = (apx_routingPlanPort_t*) 0;
+      self->entries = (apx_routingPlanEntry_t*) 0;
+      self->numPorts = 0u;
+      self->numEntries = 0u;
+   }
+}
+
+void apx_routingPlan_destroy(apx_routingPlan_t *self)
+{
+   if (self != 0)
+   {
+      if (self->ports != 0)
+      {
+         free(self->ports);
+         self->ports = (apx_routingPlanPort_t*) 0;
+      }
+      if (self->entries != 0)
+      {
+         free(self->entries);
+         self->entries = (apx_routingPlanEntry_t*) 0;
+      }
+      self->numPorts = 0u;
+      self->numEntries = 0u;
+   }
+}
+
+apx_routingPlan_t *apx_routingPlan_new(void)
+{
+   apx_routingPlan_t *self = (apx_routingPlan_t*) malloc(sizeof(apx_routingPlan_t));
+   if (self != 0)
+   {
+      apx_routingPlan_create(self);
+   }
+   return self;
+}
+
+void apx_routingPlan_delete(apx_routingPlan_t *self)
+{
+   if (self != 0)
+   {
+      apx_routingPlan_destroy(self);
+      free(self);
+   }
+}
+
+void apx_routingPlan_vdelete(void *arg)
+{
+   apx_routingPlan_delete((apx_routingPlan_t*) arg);
+}
+
+/**
+ * Builds plan from connectorTable (array of length numProvidePorts). The caller must hold the connector table lock.
+ */
+apx_error_t apx_routingPlan_build(apx_routingPlan_t *self, const apx_nodeInfo_t *nodeInfo, apx_portConnectorList_t *connectorTable)
+{
+   if ( (self != 0) && (nodeInfo != 0) && (connectorTable != 0) )
+   {
+      apx_portCount_t numProvidePorts;
+      apx_portId_t portId;
+      uint32_t numPorts = 0u;
+      uint32_t numEntries = 0u;
+      apx_routingPlan_destroy(self);
+      numProvidePorts = apx_nodeInfo_getNumProvidePorts(nodeInfo);
+      for (portId = 0; portId < numProvidePorts; portId++)
+      {
+         int32_t i;
+         uint32_t numPortEntries = 0u;
+         int32_t numConnectors = apx_portConnectorList_length(&connectorTable[portId]);
+         for (i = 0; i < numConnectors; i++)
+         {
+            apx_portRef_t *requirePortRef = apx_portConnectorList_get(&connectorTable[portId], i);
+            assert(requirePortRef != 0);
+            if (apx_routingPlan_isRoutable(apx_nodeInfo_getProvidePortDataProps(nodeInfo, portId), requirePortRef->portDataProps))
+            {
+               numPortEntries++;
+            }
+         }
+         if (numPortEntries > 0u)
+         {
+            numPorts++;
+            numEntries += numPortEntries;
+         }
+      }
+      if (numPorts == 0u)
+      {
+         return APX_NO_ERROR;
+      }
+      self->ports = (apx_routingPlanPort_t*) malloc(numPorts * sizeof(apx_routingPlanPort_t));
+      self->entries = (apx_routingPlanEntry_t*) malloc(numEntries * sizeof(apx_routingPlanEntry_t));
+      if ( (self->ports == 0) || (self->entries == 0) )
+      {
+         apx_routingPlan_destroy(self);
+         return APX_MEM_ERROR;
+      }
+      for (portId = 0; portId < numProvidePorts; portId++)
+      {
+         int32_t i;
+         apx_routingPlanPort_t *port = &self->ports[self->numPorts];
+         const apx_portDataProps_t *providePortDataProps = apx_nodeInfo_getProvidePortDataProps(nodeInfo, portId);
+         int32_t numConnectors = apx_portConnectorList_length(&connectorTable[portId]);
+         assert(providePortDataProps != 0);
+         port->srcOffset = providePortDataProps->offset;
+         port->dataSize = providePortDataProps->dataSize;
+         port->queLenType = providePortDataProps->queLenType;
+         port->dynLenType = apx_portDataProps_isQueued(providePortDataProps)? APX_DYN_LEN_NONE : providePortDataProps->dynLenType;
+         port->arrayElementSize = providePortDataProps->arrayElementSize;
+         port->firstEntry = self->numEntries;
+         port->numEntries = 0u;
+         for (i = 0; i < numConnectors; i++)
+         {
+            apx_portRef_t *requirePortRef = apx_portConnectorList_get(&connectorTable[portId], i);
+            if (apx_routingPlan_isRoutable(providePortDataProps, requirePortRef->portDataProps))
+            {
+               apx_routingPlanEntry_t *entry = &self->entries[self->numEntries++];
+               assert(requirePortRef->portDataProps->dataSize == port->dataSize);
+               entry->destNodeInstance = requirePortRef->nodeInstance;
+               entry->destOffset = requirePortRef->portDataProps->offset;
+               entry->destPortId = requirePortRef->portDataProps->portId;
+               port->numEntries++;
+            }
+         }
+         if (port->numEntries > 0u)
+         {
+            //Provide port data offsets are assigned in port ID order, this keeps the ports sorted by srcOffset
+            assert( (self->numPorts == 0u) || (self->ports[self->numPorts - 1].srcOffset < port->srcOffset) );
+            self->numPorts++;
+         }
+      }
+      assert(self->numPorts == numPorts);
+      assert(self->numEntries == numEntries);
+      return APX_NO_ERROR;
+   }
+   return APX_INVALID_ARGUMENT_ERROR;
+}
+
+/**
+ * Returns index of the first port in the plan whose data ends after offset.
+ * Returns numPorts if there is no such port.
+ */
+uint32_t apx_routingPlan_findFirstPort(const apx_routingPlan_t *self, uint32_t offset)
+{
+   if (self != 0)
+   {
+      uint32_t low = 0u;
+      uint32_t high = self->numPorts;
+      while (low < high)
+      {
+         uint32_t mid = low + (high - low) / 2u;
+         const apx_routingPlanPort_t *port = &self->ports[mid];
+         if ( (port->srcOffset + port->dataSize) <= offset)
+         {
+            low = mid + 1u;
+         }
+         else
+         {
+            high = mid;
+         }
+      }
+      return low;
+   }
+   return 0u;
+}
+
+uint32_t apx_routingPlan_getNumPorts(const apx_routingPlan_t *self)
+{
+   if (self != 0)
+   {
+      return self->numPorts;
+   }
+   return 0u;
+}
+
+uint32_t apx_routingPlan_getNumEntries(const apx_routingPlan_t *self)
+{
+   if (self != 0)
+   {
+      return self->numEntries;
+   }
+   return 0u;
+}
+
+/**
+ * Sorts writes by destination and merges writes to the same destination that overlap or touch into a single write.
+ * Returns the number of writes remaining in the array after merging.
+ */
+uint32_t apx_routingPlan_coalesceWrites(apx_routingWrite_t *writes, uint32_t numWrites)
+{
+   uint32_t i;
+   uint32_t numMerged;
+   if ( (writes == 0) || (numWrites == 0u) )
+   {
+      return 0u;
+   }
+   if (numWrites > 1u)
+   {
+      qsort(writes, numWrites, sizeof(apx_routingWrite_t), apx_routingPlan_compareWrites);
+   }
+   numMerged = 1u;
+   for (i = 1u; i < numWrites; i++)
+   {
+      apx_routingWrite_t *last = &writes[numMerged - 1];
+      if ( (writes[i].destNodeInstance == last->destNodeInstance) && (writes[i].destOffset <= (last->destOffset + last->len)) )
+      {
+         uint32_t endOffset = writes[i].destOffset + writes[i].len;
+         //The merged write can still be sent straight from the routed data when both writes keep the same distance between source and destination
+         if ( (last->srcOffset != APX_ROUTING_WRITE_NO_SRC_OFFSET) &&
+              ( (writes[i].srcOffset == APX_ROUTING_WRITE_NO_SRC_OFFSET) || (writes[i].srcOffset < last->srcOffset) ||
+                ( (writes[i].srcOffset - last->srcOffset) != (writes[i].destOffset - last->destOffset) ) ) )
+         {
+            last->srcOffset = APX_ROUTING_WRITE_NO_SRC_OFFSET;
+         }
+         if (endOffset > (last->destOffset + last->len))
+         {
+            last->len = endOffset - last->destOffset;
+         }
+      }
+      else
+      {
+         writes[numMerged++] = writes[i];
+      }
+   }
+   return numMerged;
+}
+
+//////////////////////////////////////////////////////////////////////////////
+// PRIVATE FUNCTIONS
+//////////////////////////////////////////////////////////////////////////////
+/**
+ * Data can only be routed between ports sharing the same layout. A queued provide port only feeds queued require ports of the same queue length.
+ * A dynamic array provide port only feeds dynamic array require ports with the same length header.
+ */
+static bool apx_routingPlan_isRoutable(const apx_portDataProps_t *providePortDataProps, const apx_portDataProps_t *requirePortDataProps)
+{
+   assert(providePortDataProps != 0);
+   if (apx_portDataProps_isPlainOldData(requirePortDataProps))
+   {
+      return apx_portDataProps_isPlainOldData(providePortDataProps);
+   }
+   if (requirePortDataProps->isDynamicArray && (!apx_portDataProps_isQueued(requirePortDataProps)) )
+   {
+      return ( providePortDataProps->isDynamicArray && (!apx_portDataProps_isQueued(providePortDataProps)) &&
+               (providePortDataProps->dynLenType == requirePortDataProps->dynLenType) &&
+               (providePortDataProps->arrayElementSize == requirePortDataProps->arrayElementSize) )? true : false;
+   }
+   if (apx_portDataProps_isQueued(requirePortDataProps) && (!requirePortDataProps->isDynamicArray))
+   {
+      return ( (providePortDataProps->queLenType == requirePortDataProps->queLenType) &&
+               (providePortDataProps->maxQueLen == requirePortDataProps->maxQueLen) &&
+               (providePortDataProps->elementSize == requirePortDataProps->elementSize) )? true : false;
+   }
+   return false;
+}
+
+static int apx_routingPlan_compareWrites(const void *a, const void *b)
+{
+   const apx_routingWrite_t *lhs = (const apx_routingWrite_t*) a;
+   const apx_routingWrite_t *rhs = (const apx_routingWrite_t*) b;
+   if (lhs->destNodeInstance != rhs->destNodeInstance)
+   {
+      return ( (uintptr_t) lhs->destNodeInstance < (uintptr_t) rhs->destNodeInstance)? -1 : 1;
+   }
+   if (lhs->destOffset != rhs->destOffset)
+   {
+      return (lhs->destOffset < rhs->destOffset)? -1 : 1;
+   }
+   return 0;
+}
@@ -0,0 +1,404 @@
+/*****************************************************************************
+* \file      apx_signatureTable.c
+* \author    Conny Gustafsson
+* \date      2026-10-18
+* \brief     Interns port signature strings as compact integer IDs
+*
+* Copyright (c) 2026 Conny Gustafsson
+* Permission is hereby granted, free of charge, to any person obtaining a copy of
+* this software and associated documentation files (the "Software"), to deal in
+* the Software without restriction, including without limitation the rights to
+* use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+* the Software, and to permit persons to whom the Software is furnished to do so,
+* subject to the following conditions:
+
+* The above copyright notice and this permission notice shall be included in all
+* copies or substantial portions of the Software.
+
+* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+* IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+* FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+* COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+* IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+* CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+*
+******************************************************************************/
+//////////////////////////////////////////////////////////////////////////////
+// INCLUDES
+//////////////////////////////////////////////////////////////////////////////
+#include <stdlib.h>
+#include <string.h>
+#include <assert.h>
+#include "apx_signatureTable.h"
+#ifdef MEM_LEAK_CHECK
+#include "CMemLeak.h"
+#endif
+
+//////////////////////////////////////////////////////////////////////////////
+// PRIVATE CONSTANTS AND DATA TYPES
+//////////////////////////////////////////////////////////////////////////////
+#define INITIAL_NUM_BUCKETS 64u
+#define INITIAL_CAPACITY 32u
+#define FNV_OFFSET_BASIS_64 0xcbf29ce484222325ull
+#define FNV_PRIME_64 0x100000001b3ull
+
+//////////////////////////////////////////////////////////////////////////////
+// PRIVATE FUNCTION PROTOTYPES
+//////////////////////////////////////////////////////////////////////////////
+static apx_signatureId_t apx_signatureTable_lookup(apx_signatureTable_t *self, const char *signature, uint64_t hash, uint32_t *freeBucket);
+static apx_error_t apx_signatureTable_rehash(apx_signatureTable_t *self, uint32_t numBuckets);
+static apx_error_t apx_signatureTable_reserve(apx_signatureTable_t *self, uint32_t capacity);
+static void apx_signatureTable_removeFromBuckets(apx_signatureTable_t *self, apx_signatureId_t signatureId);
+
+//////////////////////////////////////////////////////////////////////////////
+// PRIVATE VARIABLES
+//////////////////////////////////////////////////////////////////////////////
+
+//////////////////////////////////////////////////////////////////////////////
+// PUBLIC FUNCTIONS
+//////////////////////////////////////////////////////////////////////////////
+void apx_signatureTable_create(apx_signatureTable_t *self)
+{
+   if (self != 0)
+   {
+      memset(self, 0, sizeof(apx_signatureTable_t));
+   }
+}
+
+void apx_signatureTable_destroy(apx_signatureTable_t *self)
+{
+   if (self != 0)
+   {
+      uint32_t i;
+      for (i = 0u; i < self->numIds; i++)
+      {
+         if (self->signatures[i] != 0)
+         {
+            free(self->signatures[i]);
+         }
+      }
+      if (self->signatures != 0)
+      {
+         free(self->signatures);
+      }
+      if (self->hashes != 0)
+      {
+         free(self->hashes);
+      }
+      if (self->refCounts != 0)
+      {
+         free(self->refCounts);
+      }
+      if (self->freeIds != 0)
+      {
+         free(self->freeIds);
+      }
+      if (self->buckets != 0)
+      {
+         free(self->buckets);
+      }
+      memset(self, 0, sizeof(apx_signatureTable_t));
+   }
+}
+
+apx_signatureTable_t *apx_signatureTable_new(void)
+{
+   apx_signatureTable_t *self = (apx_signatureTable_t*) malloc(sizeof(apx_signatureTable_t));
+   if (self != 0)
+   {
+      apx_signatureTable_create(self);
+   }
+   return self;
+}
+
+void apx_signatureTable_delete(apx_signatureTable_t *self)
+{
+   if (self != 0)
+   {
+      apx_signatureTable_destroy(self);
+      free(self);
+   }
+}
+
+/**
+ * Returns the ID of signature in signatureId, adding signature to the table if it is not already in it.
+ * Takes a new reference to the signature which must later be given back using apx_signatureTable_release.
+ */
+apx_error_t apx_signatureTable_intern(apx_signatureTable_t *self, const char *signature, apx_signatureId_t *signatureId)
+{
+   if ( (self != 0) && (signature != 0) && (signatureId != 0) )
+   {
+      uint64_t hash = apx_signatureTable_hash(signature);
+      uint32_t freeBucket = 0u;
+      apx_signatureId_t id = APX_INVALID_SIGNATURE_ID;
+      if (self->numBuckets > 0u)
+      {
+         id = apx_signatureTable_lookup(self, signature, hash, &freeBucket);
+      }
+      if (id == APX_INVALID_SIGNATURE_ID)
+      {
+         apx_error_t rc;
+         size_t signatureSize;
+         char *signatureCopy;
+         //Keep the load factor at or below 50% to keep probe sequences short
+         if ( (self->numSignatures + 1u) * 2u > self->numBuckets )
+         {
+            rc = apx_signatureTable_rehash(self, (self->numBuckets == 0u)? INITIAL_NUM_BUCKETS : self->numBuckets * 2u);
+            if (rc != APX_NO_ERROR)
+            {
+               return rc;
+            }
+            (void) apx_signatureTable_lookup(self, signature, hash, &freeBucket);
+         }
+         if ( (self->numFreeIds == 0u) && (self->numIds == self->capacity) )
+         {
+            rc = apx_signatureTable_reserve(self, (self->capacity == 0u)? INITIAL_CAPACITY : self->capacity * 2u);
+            if (rc != APX_NO_ERROR)
+            {
+               return rc;
+            }
+         }
+         signatureSize = strlen(signature) + 1u;
+         signatureCopy = (char*) malloc(signatureSize);
+         if (signatureCopy == 0)
+         {
+            return APX_MEM_ERROR;
+         }
+         memcpy(signatureCopy, signature, signatureSize);
+         id = (self->numFreeIds > 0u)? self->freeIds[--self->numFreeIds] : self->numIds++;
+         self->numSignatures++;
+         self->signatures[id] = signatureCopy;
+         self->hashes[id] = hash;
+         self->refCounts[id] = 0u;
+         self->buckets[freeBucket] = id + 1u;
+         self->stringBytes += signatureSize;
+      }
+      self->refCounts[id]++;
+      *signatureId = id;
+      return APX_NO_ERROR;
+   }
+   return APX_INVALID_ARGUMENT_ERROR;
+}
+
+/**
+ * Gives back a reference taken by apx_signatureTable_intern. The signature is removed from the table when its last reference is released.
+ */
+void apx_signatureTable_release(apx_signatureTable_t *self, apx_signatureId_t signatureId)
+{
+   if ( (self != 0) && (signatureId < self->numIds) && (self->signatures[signatureId] != 0) )
+   {
+      assert(self->refCounts[signatureId] > 0u);
+      if (--self->refCounts[signatureId] == 0u)
+      {
+         apx_signatureTable_removeFromBuckets(self, signatureId);
+         self->stringBytes -= strlen(self->signatures[signatureId]) + 1u;
+         free(self->signatures[signatureId]);
+         self->signatures[signatureId] = (char*) 0;
+         self->freeIds[self->numFreeIds++] = signatureId;
+         self->numSignatures--;
+      }
+   }
+}
+
+/**
+ * Returns the ID of signature or APX_INVALID_SIGNATURE_ID if signature has not been interned
+ */
+apx_signatureId_t apx_signatureTable_find(apx_signatureTable_t *self, const char *signature)
+{
+   if ( (self != 0) && (signature != 0) && (self->numBuckets > 0u) )
+   {
+      uint32_t freeBucket;
+      return apx_signatureTable_lookup(self, signature, apx_signatureTable_hash(signature), &freeBucket);
+   }
+   return APX_INVALID_SIGNATURE_ID;
+}
+
+const char *apx_signatureTable_getSignature(const apx_signatureTable_t *self, apx_signatureId_t signatureId)
+{
+   if ( (self != 0) && (signatureId < self->numIds) )
+   {
+      return self->signatures[signatureId];
+   }
+   return (const char*) 0;
+}
+
+int32_t apx_signatureTable_length(const apx_signatureTable_t *self)
+{
+   if (self != 0)
+   {
+      return (int32_t) self->numSignatures;
+   }
+   return -1;
+}
+
+void apx_signatureTable_getStats(const apx_signatureTable_t *self, apx_signatureTableStats_t *stats)
+{
+   if ( (self != 0) && (stats != 0) )
+   {
+      stats->numSignatures = self->numSignatures;
+      stats->numBuckets = self->numBuckets;
+      stats->memoryUsage = sizeof(apx_signatureTable_t) + self->stringBytes +
+            (self->numBuckets * sizeof(uint32_t)) +
+            (self->capacity * (sizeof(char*) + sizeof(uint64_t) + sizeof(uint32_t) + sizeof(apx_signatureId_t)));
+      stats->numLookups = self->numLookups;
+      stats->numProbes = self->numProbes;
+      stats->numStringCompares = self->numStringCompares;
+   }
+}
+
+/**
+ * 64-bit FNV-1a followed by the MurmurHash3 finalizer, which spreads short and similar signatures over all bits
+ */
+uint64_t apx_signatureTable_hash(const char *signature)
+{
+   uint64_t hash = FNV_OFFSET_BASIS_64;
+   const uint8_t *p = (const uint8_t*) signature;
+   while (*p != 0u)
+   {
+      hash ^= (uint64_t) *p++;
+      hash *= FNV_PRIME_64;
+   }
+   hash ^= hash >> 33;
+   hash *= 0xff51afd7ed558ccdull;
+   hash ^= hash >> 33;
+   hash *= 0xc4ceb9fe1a85ec53ull;
+   hash ^= hash >> 33;
+   return hash;
+}
+
+//////////////////////////////////////////////////////////////////////////////
+// PRIVATE FUNCTIONS
+//////////////////////////////////////////////////////////////////////////////
+
+/**
+ * Returns the ID of signature. When not found, APX_INVALID_SIGNATURE_ID is returned and freeBucket is set to the
+ * bucket where signature should be inserted.
+ */
+static apx_signatureId_t apx_signatureTable_lookup(apx_signatureTable_t *self, const char *signature, uint64_t hash, uint32_t *freeBucket)
+{
+   uint32_t mask = self->numBuckets - 1u;
+   uint32_t i = (uint32_t) hash & mask;
+   assert(self->numBuckets > 0u);
+   self->numLookups++;
+   for (;;)
+   {
+      uint32_t value = self->buckets[i];
+      self->numProbes++;
+      if (value == 0u)
+      {
+         *freeBucket = i;
+         return APX_INVALID_SIGNATURE_ID;
+      }
+      if (self->hashes[value - 1u] == hash)
+      {
+         self->numStringCompares++;
+         if (strcmp(self->signatures[value - 1u], signature) == 0)
+         {
+            return value - 1u;
+         }
+      }
+      i = (i + 1u) & mask;
+   }
+}
+
+static apx_error_t apx_signatureTable_rehash(apx_signatureTable_t *self, uint32_t numBuckets)
+{
+   uint32_t mask = numBuckets - 1u;
+   uint32_t id;
+   uint32_t *buckets = (uint32_t*) malloc(numBuckets * sizeof(uint32_t));
+   if (buckets == 0)
+   {
+      return APX_MEM_ERROR;
+   }
+   memset(buckets, 0, numBuckets * sizeof(uint32_t));
+   for (id = 0u; id < self->numIds; id++)
+   {
+      uint32_t i;
+      if (self->signatures[id] == 0)
+      {
+         continue;
+      }
+      i = (uint32_t) self->hashes[id] & mask;
+      while (buckets[i] != 0u)
+      {
+         i = (i + 1u) & mask;
+      }
+      buckets[i] = id + 1u;
+   }
+   if (self->buckets != 0)
+   {
+      free(self->buckets);
+   }
+   self->buckets = buckets;
+   self->numBuckets = numBuckets;
+   return APX_NO_ERROR;
+}
+
+static apx_error_t apx_signatureTable_reserve(apx_signatureTable_t *self, uint32_t capacity)
+{
+   char **signatures;
+   uint64_t *hashes;
+   uint32_t *refCounts;
+   apx_signatureId_t *freeIds;
+   signatures = (char**) realloc(self->signatures, capacity * sizeof(char*));
+   if (signatures == 0)
+   {
+      return APX_MEM_ERROR;
+   }
+   self->signatures = signatures;
+   hashes = (uint64_t*) realloc(self->hashes, capacity * sizeof(uint64_t));
+   if (hashes == 0)
+   {
+      return APX_MEM_ERROR;
+   }
+   self->hashes = hashes;
+   refCounts = (uint32_t*) realloc(self->refCounts, capacity * sizeof(uint32_t));
+   if (refCounts == 0)
+   {
+      return APX_MEM_ERROR;
+   }
+   self->refCounts = refCounts;
+   freeIds = (apx_signatureId_t*) realloc(self->freeIds, capacity * sizeof(apx_signatureId_t));
+   if (freeIds == 0)
+   {
+      return APX_MEM_ERROR;
+   }
+   self->freeIds = freeIds;
+   self->capacity = capacity;
+   return APX_NO_ERROR;
+}
+
+/**
+ * Backward shift deletion: entries following the removed one in the same probe sequence are moved back,
+ * which keeps lookups correct without leaving tombstones behind.
+ */
+static void apx_signatureTable_removeFromBuckets(apx_signatureTable_t *self, apx_signatureId_t signatureId)
+{
+   uint32_t mask = self->numBuckets - 1u;
+   uint32_t i = (uint32_t) self->hashes[signatureId] & mask;
+   uint32_t j;
+   while (self->buckets[i] != signatureId + 1u)
+   {
+      assert(self->buckets[i] != 0u);
+      i = (i + 1u) & mask;
+   }
+   self->buckets[i] = 0u;
+   j = i;
+   for (;;)
+   {
+      uint32_t home;
+      j = (j + 1u) & mask;
+      if (self->buckets[j] == 0u)
+      {
+         break;
+      }
+      home = (uint32_t) self->hashes[self->buckets[j] - 1u] & mask;
+      //Move the entry at j into the hole at i unless its home bucket lies cyclically in (i, j]
+      if ( ( (j - home) & mask ) >= ( (j - i) & mask ) )
+      {
+         self->buckets[i] = self->buckets[j];
+         self->buckets[j] = 0u;
+         i = j;
+      }
+   }
+}
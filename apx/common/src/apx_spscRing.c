@@ -0,0 +1,250 @@
+/*****************************************************************************
+* \file      apx_spscRing.c
+* \author    Conny Gustafsson
+* \date      2026-10-18
+* \brief     Bounded lock-free single-producer/single-consumer ring buffer
+*
+* Copyright (c) 2026 Conny Gustafsson
+* Permission is hereby granted, free of charge, to any person obtaining a copy of
+* this software and associated documentation files (the "Software"), to deal in
+* the Software without restriction, including without limitation the rights to
+* use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+* the Software, and to permit persons to whom the Software is furnished to do so,
+* subject to the following conditions:
+
+* The above copyright notice and this permission notice shall be included in all
+* copies or substantial portions of the Software.
+
+* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+* IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+* FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+* COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+* IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+* CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+*
+******************************************************************************/
+//////////////////////////////////////////////////////////////////////////////
+// INCLUDES
+//////////////////////////////////////////////////////////////////////////////
+#include <malloc.h>
+#include <string.h>
+#include <assert.h>
+#include "apx_spscRing.h"
+#include "apx_atomic.h"
+#ifdef MEM_LEAK_CHECK
+#include "CMemLeak.h"
+#endif
+
+//////////////////////////////////////////////////////////////////////////////
+// PRIVATE CONSTANTS AND DATA TYPES
+//////////////////////////////////////////////////////////////////////////////
+#define MAX_NUM_SLOTS 0x40000000u
+
+//////////////////////////////////////////////////////////////////////////////
+// PRIVATE FUNCTION PROTOTYPES
+//////////////////////////////////////////////////////////////////////////////
+static void apx_spscRing_copyIn(apx_spscRing_t *self, uint32_t pos, const uint8_t *src, uint32_t numElems);
+static void apx_spscRing_copyOut(apx_spscRing_t *self, uint32_t pos, uint8_t *dest, uint32_t numElems);
+
+//////////////////////////////////////////////////////////////////////////////
+// PRIVATE VARIABLES
+//////////////////////////////////////////////////////////////////////////////
+
+//////////////////////////////////////////////////////////////////////////////
+// PUBLIC FUNCTIONS
+//////////////////////////////////////////////////////////////////////////////
+/**
+ * Creates a ring for elements of size elemSize. The capacity is minNumElems rounded up to the nearest power of two.
+ */
+apx_error_t apx_spscRing_create(apx_spscRing_t *self, uint32_t elemSize, uint32_t minNumElems)
+{
+   if ( (self != 0) && (elemSize > 0u) && (minNumElems > 0u) && (minNumElems <= MAX_NUM_SLOTS) )
+   {
+      uint32_t numSlots = 1u;
+      while (numSlots < minNumElems)
+      {
+         numSlots <<= 1;
+      }
+      memset(self, 0, sizeof(apx_spscRing_t));
+      self->elemSize = elemSize;
+      self->numSlots = numSlots;
+      self->mask = numSlots - 1u;
+      self->elements = (uint8_t*) malloc( (size_t) elemSize * numSlots);
+      if (self->elements == 0)
+      {
+         return APX_MEM_ERROR;
+      }
+      return APX_NO_ERROR;
+   }
+   return APX_INVALID_ARGUMENT_ERROR;
+}
+
+void apx_spscRing_destroy(apx_spscRing_t *self)
+{
+   if ( (self != 0) && (self->elements != 0) )
+   {
+      free(self->elements);
+      self->elements = (uint8_t*) 0;
+   }
+}
+
+apx_spscRing_t *apx_spscRing_new(uint32_t elemSize, uint32_t minNumElems)
+{
+   apx_spscRing_t *self = (apx_spscRing_t*) malloc(sizeof(apx_spscRing_t));
+   if (self != 0)
+   {
+      apx_error_t result = apx_spscRing_create(self, elemSize, minNumElems);
+      if (result != APX_NO_ERROR)
+      {
+         free(self);
+         self = (apx_spscRing_t*) 0;
+      }
+   }
+   return self;
+}
+
+void apx_spscRing_delete(apx_spscRing_t *self)
+{
+   if (self != 0)
+   {
+      apx_spscRing_destroy(self);
+      free(self);
+   }
+}
+
+/**
+ * Copies elem into the ring. Must only be called from the producer thread.
+ * Returns APX_BUFFER_FULL_ERROR when all slots are in use.
+ */
+apx_error_t apx_spscRing_push(apx_spscRing_t *self, const void *elem)
+{
+   if ( (self != 0) && (elem != 0) )
+   {
+      uint32_t writePos = self->writePos;
+      if ( (writePos - apx_atomic_load32(&self->readPos)) >= self->numSlots)
+      {
+         return APX_BUFFER_FULL_ERROR;
+      }
+      memcpy(self->elements + ( (size_t) (writePos & self->mask) * self->elemSize), elem, self->elemSize);
+      apx_atomic_store32(&self->writePos, writePos + 1u);
+      return APX_NO_ERROR;
+   }
+   return APX_INVALID_ARGUMENT_ERROR;
+}
+
+/**
+ * Copies up to numElems back-to-back elements from elems into the ring. Must only be called from the producer thread.
+ * Returns number of elements actually copied, which is less than numElems when the ring runs full.
+ */
+uint32_t apx_spscRing_pushMany(apx_spscRing_t *self, const uint8_t *elems, uint32_t numElems)
+{
+   if ( (self != 0) && (elems != 0) )
+   {
+      uint32_t writePos = self->writePos;
+      uint32_t numFree = self->numSlots - (writePos - apx_atomic_load32(&self->readPos));
+      if (numElems > numFree)
+      {
+         numElems = numFree;
+      }
+      if (numElems > 0u)
+      {
+         apx_spscRing_copyIn(self, writePos, elems, numElems);
+         apx_atomic_store32(&self->writePos, writePos + numElems);
+      }
+      return numElems;
+   }
+   return 0u;
+}
+
+/**
+ * Removes up to maxNumElems of the oldest elements from the ring and copies them back-to-back into dest.
+ * Must only be called from the consumer thread. Returns number of elements copied (0 when the ring is empty).
+ */
+uint32_t apx_spscRing_read(apx_spscRing_t *self, uint8_t *dest, uint32_t maxNumElems)
+{
+   if ( (self != 0) && (dest != 0) )
+   {
+      uint32_t readPos = self->readPos;
+      uint32_t numElems = apx_atomic_load32(&self->writePos) - readPos;
+      if (numElems > maxNumElems)
+      {
+         numElems = maxNumElems;
+      }
+      if (numElems > 0u)
+      {
+         apx_spscRing_copyOut(self, readPos, dest, numElems);
+         apx_atomic_store32(&self->readPos, readPos + numElems);
+      }
+      return numElems;
+   }
+   return 0u;
+}
+
+/**
+ * Returns number of elements currently in the ring. The value is only a snapshot when the other side is active.
+ */
+uint32_t apx_spscRing_length(apx_spscRing_t *self)
+{
+   if (self != 0)
+   {
+      uint32_t readPos = apx_atomic_load32(&self->readPos);
+      uint32_t writePos = apx_atomic_load32(&self->writePos);
+      uint32_t length = writePos - readPos;
+      return (length > self->numSlots)? self->numSlots : length;
+   }
+   return 0u;
+}
+
+uint32_t apx_spscRing_capacity(const apx_spscRing_t *self)
+{
+   if (self != 0)
+   {
+      return self->numSlots;
+   }
+   return 0u;
+}
+
+uint32_t apx_spscRing_elementSize(const apx_spscRing_t *self)
+{
+   if (self != 0)
+   {
+      return self->elemSize;
+   }
+   return 0u;
+}
+
+//////////////////////////////////////////////////////////////////////////////
+// PRIVATE FUNCTIONS
+//////////////////////////////////////////////////////////////////////////////
+/**
+ * Copies numElems elements into the ring starting at pos, wrapping around the end of the buffer if needed.
+ */
+static void apx_spscRing_copyIn(apx_spscRing_t *self, uint32_t pos, const uint8_t *src, uint32_t numElems)
+{
+   uint32_t index = pos & self->mask;
+   uint32_t numFirst = self->numSlots - index;
+   if (numFirst > numElems)
+   {
+      numFirst = numElems;
+   }
+   memcpy(self->elements + ( (size_t) index * self->elemSize), src, (size_t) numFirst * self->elemSize);
+   if (numFirst < numElems)
+   {
+      memcpy(self->elements, src + ( (size_t) numFirst * self->elemSize), (size_t) (numElems - numFirst) * self->elemSize);
+   }
+}
+
+static void apx_spscRing_copyOut(apx_spscRing_t *self, uint32_t pos, uint8_t *dest, uint32_t numElems)
+{
+   uint32_t index = pos & self->mask;
+   uint32_t numFirst = self->numSlots - index;
+   if (numFirst > numElems)
+   {
+      numFirst = numElems;
+   }
+   memcpy(dest, self->elements + ( (size_t) index * self->elemSize), (size_t) numFirst * self->elemSize);
+   if (numFirst < numElems)
+   {
+      memcpy(dest + ( (size_t) numFirst * self->elemSize), self->elements, (size_t) (numElems - numFirst) * self->elemSize);
+   }
+}
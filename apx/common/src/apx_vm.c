@@ -40,6 +40,14 @@
 //////////////////////////////////////////////////////////////////////////////
 // PRIVATE CONSTANTS AND DATA TYPES
 //////////////////////////////////////////////////////////////////////////////
+typedef struct apx_vmNativeState_tag
+{
+   const apx_vmNativeLayout_t *layout;
+   uint8_t *nativeData; //only read from when executing a pack program
+   uint8_t *pNext; //only read from when executing an unpack program
+   uint8_t *pEnd;
+   uint32_t elementIndex;
+} apx_vmNativeState_t;
 
 //////////////////////////////////////////////////////////////////////////////
 // PRIVATE FUNCTION PROTOTYPES
@@ -50,6 +58,9 @@ static apx_error_t apx_vm_executePackInstruction(apx_vm_t *self, uint8_t variant
 static apx_error_t apx_vm_executeUnpackInstruction(apx_vm_t *self, uint8_t variant);
 static apx_error_t apx_vm_executeArrayInstruction(apx_vm_t *self, uint8_t variant, bool isDynamicArray);
 static apx_error_t apx_vm_executeDataControlInstruction(apx_vm_t *self, uint8_t variant, bool isLastElement);
+static apx_error_t apx_vm_execNativeProg(apx_vm_t *self, apx_vmNativeState_t *state);
+static apx_error_t apx_vm_executeNativeInstruction(apx_vm_t *self, apx_vmNativeState_t *state, uint8_t variant);
+static apx_error_t apx_vm_execCopyPlan(const apx_copyPlan_t *plan, uint8_t *data, apx_size_t dataSize, uint8_t *nativeData, const apx_vmNativeLayout_t *layout, bool isPack);
 //////////////////////////////////////////////////////////////////////////////
 // PRIVATE VARIABLES
 //////////////////////////////////////////////////////////////////////////////
@@ -238,6 +249,64 @@ apx_error_t apx_vm_writeNullValue(apx_vm_t *self)
    return APX_INVALID_ARGUMENT_ERROR;
 }
 
+/**
+ * Executes the selected pack program directly on a native C struct described by layout.
+ * Unlike apx_vm_packValue this performs no heap allocations.
+ * Dynamic arrays and arrays of records are not supported in native mode.
+ */
+apx_error_t apx_vm_packNative(apx_vm_t *self, uint8_t *buffer, apx_size_t bufSize, const void *nativeData, const apx_vmNativeLayout_t *layout)
+{
+   if ( (self != 0) && (buffer != 0) && (nativeData != 0) && (layout != 0) )
+   {
+      apx_vmNativeState_t state;
+      self->progNext = self->progBegin + APX_VM_HEADER_SIZE;
+      if ( (self->progBegin == 0) || (self->progNext >= self->progEnd) || (self->progType != APX_VM_HEADER_PACK_PROG))
+      {
+         return APX_INVALID_PROGRAM_ERROR;
+      }
+      if (bufSize < self->progDataSize)
+      {
+         return APX_BUFFER_BOUNDARY_ERROR;
+      }
+      state.layout = layout;
+      state.nativeData = (uint8_t*) nativeData;
+      state.pNext = buffer;
+      state.pEnd = buffer + bufSize;
+      state.elementIndex = 0u;
+      return apx_vm_execNativeProg(self, &state);
+   }
+   return APX_INVALID_ARGUMENT_ERROR;
+}
+
+/**
+ * Executes the selected unpack program directly into a native C struct described by layout.
+ * Unlike apx_vm_unpackValue this performs no heap allocations.
+ * Dynamic arrays and arrays of records are not supported in native mode.
+ */
+apx_error_t apx_vm_unpackNative(apx_vm_t *self, const uint8_t *buffer, apx_size_t bufSize, void *nativeData, const apx_vmNativeLayout_t *layout)
+{
+   if ( (self != 0) && (buffer != 0) && (nativeData != 0) && (layout != 0) )
+   {
+      apx_vmNativeState_t state;
+      self->progNext = self->progBegin + APX_VM_HEADER_SIZE;
+      if ( (self->progBegin == 0) || (self->progNext >= self->progEnd) || (self->progType != APX_VM_HEADER_UNPACK_PROG))
+      {
+         return APX_INVALID_PROGRAM_ERROR;
+      }
+      if (bufSize < self->progDataSize)
+      {
+         return APX_BUFFER_BOUNDARY_ERROR;
+      }
+      state.layout = layout;
+      state.nativeData = (uint8_t*) nativeData;
+      state.pNext = (uint8_t*) buffer;
+      state.pEnd = state.pNext + bufSize;
+      state.elementIndex = 0u;
+      return apx_vm_execNativeProg(self, &state);
+   }
+   return APX_INVALID_ARGUMENT_ERROR;
+}
+
 #ifdef UNIT_TEST
 apx_size_t apx_vm_getBytesWritten(apx_vm_t *self)
 {
@@ -286,13 +355,83 @@ apx_error_t apx_vm_decodeProgramHeader(const adt_bytes_t *program, uint8_t *majo
    return APX_INVALID_ARGUMENT_ERROR;
 }
 
+/**
+ * Returns the data size from the program header. dataFlags (optional) gets APX_VM_HEADER_FLAG_DYNAMIC when the
+ * program describes a dynamic array at top level, see apx_vm_decodeDynArrayProps.
+ */
 apx_error_t apx_vm_decodeProgramDataProps(const adt_bytes_t *program, apx_size_t *dataSize, uint8_t *dataFlags)
 {
    uint8_t majorVersion;
    uint8_t minorVersion;
    uint8_t progType;
-   (void) dataFlags;
-   return apx_vm_decodeProgramHeader(program, &majorVersion, &minorVersion, &progType, dataSize);
+   apx_error_t rc = apx_vm_decodeProgramHeader(program, &majorVersion, &minorVersion, &progType, dataSize);
+   if ( (rc == APX_NO_ERROR) && (dataFlags != 0) )
+   {
+      apx_dynLenType_t dynLenType;
+      uint32_t maxArrayLen;
+      *dataFlags = 0u;
+      if (apx_vm_decodeDynArrayProps(program, &dynLenType, &maxArrayLen) == APX_NO_ERROR)
+      {
+         *dataFlags |= APX_VM_HEADER_FLAG_DYNAMIC;
+      }
+   }
+   return rc;
+}
+
+/**
+ * Decodes the array length header of a program whose data is a dynamic array at top level (e.g. "C[4096*]" or "{...}[10*]").
+ * Data of such a program is the array length followed by the used elements, all bytes after the used elements are unused.
+ * Returns APX_UNSUPPORTED_ERROR for all other programs, including programs where the dynamic array is inside a record.
+ */
+apx_error_t apx_vm_decodeDynArrayProps(const adt_bytes_t *program, apx_dynLenType_t *dynLenType, uint32_t *maxArrayLen)
+{
+   if ( (program != 0) && (dynLenType != 0) && (maxArrayLen != 0) )
+   {
+      const uint8_t *code = adt_bytes_constData(program);
+      int32_t length = adt_bytes_length(program);
+      uint8_t opcode = 0u;
+      uint8_t variant = 0u;
+      uint8_t flags = 0u;
+      uint8_t lenSize = 0u;
+      if (length < (int32_t) (APX_VM_HEADER_SIZE + APX_VM_INSTRUCTION_SIZE * 2u))
+      {
+         return APX_UNSUPPORTED_ERROR;
+      }
+      (void) apx_vm_decodeInstruction(code[APX_VM_HEADER_SIZE], &opcode, &variant, &flags);
+      if ( ( (opcode != APX_OPCODE_PACK) && (opcode != APX_OPCODE_UNPACK) ) || (flags != APX_ARRAY_FLAG) )
+      {
+         return APX_UNSUPPORTED_ERROR;
+      }
+      (void) apx_vm_decodeInstruction(code[APX_VM_HEADER_SIZE + APX_VM_INSTRUCTION_SIZE], &opcode, &variant, &flags);
+      if ( (opcode != APX_OPCODE_ARRAY) || (flags != APX_DYN_ARRAY_FLAG) )
+      {
+         return APX_UNSUPPORTED_ERROR;
+      }
+      switch(variant)
+      {
+      case APX_VARIANT_U8:
+         *dynLenType = APX_DYN_LEN_U8;
+         lenSize = UINT8_SIZE;
+         break;
+      case APX_VARIANT_U16:
+         *dynLenType = APX_DYN_LEN_U16;
+         lenSize = UINT16_SIZE;
+         break;
+      case APX_VARIANT_U32:
+         *dynLenType = APX_DYN_LEN_U32;
+         lenSize = UINT32_SIZE;
+         break;
+      default:
+         return APX_INVALID_INSTRUCTION_ERROR;
+      }
+      if (length < (int32_t) (APX_VM_HEADER_SIZE + APX_VM_INSTRUCTION_SIZE * 2u + lenSize))
+      {
+         return APX_INVALID_INSTRUCTION_ERROR;
+      }
+      *maxArrayLen = unpackLE(&code[APX_VM_HEADER_SIZE + APX_VM_INSTRUCTION_SIZE * 2u], lenSize);
+      return APX_NO_ERROR;
+   }
+   return APX_INVALID_ARGUMENT_ERROR;
 }
 
 apx_error_t apx_vm_decodeInstruction(uint8_t instruction, uint8_t *opcode, uint8_t *variant, uint8_t *flags)
@@ -307,6 +446,39 @@ apx_error_t apx_vm_decodeInstruction(uint8_t instruction, uint8_t *opcode, uint8
    return APX_INVALID_ARGUMENT_ERROR;
 }
 
+/**
+ * Executes a copy plan (see apx_compiler_lowerToCopyPlan) produced from a pack program.
+ * Gives the same result as apx_vm_packNative but without decoding any instructions.
+ */
+apx_error_t apx_vm_packCopyPlan(const apx_copyPlan_t *plan, uint8_t *buffer, apx_size_t bufSize, const void *nativeData, const apx_vmNativeLayout_t *layout)
+{
+   if ( (plan != 0) && (buffer != 0) && (nativeData != 0) && (layout != 0) )
+   {
+      if (plan->progType != APX_VM_HEADER_PACK_PROG)
+      {
+         return APX_INVALID_PROGRAM_ERROR;
+      }
+      return apx_vm_execCopyPlan(plan, buffer, bufSize, (uint8_t*) nativeData, layout, true);
+   }
+   return APX_INVALID_ARGUMENT_ERROR;
+}
+
+/**
+ * Executes a copy plan (see apx_compiler_lowerToCopyPlan) produced from an unpack program.
+ * Gives the same result as apx_vm_unpackNative but without decoding any instructions.
+ */
+apx_error_t apx_vm_unpackCopyPlan(const apx_copyPlan_t *plan, const uint8_t *buffer, apx_size_t bufSize, void *nativeData, const apx_vmNativeLayout_t *layout)
+{
+   if ( (plan != 0) && (buffer != 0) && (nativeData != 0) && (layout != 0) )
+   {
+      if (plan->progType != APX_VM_HEADER_UNPACK_PROG)
+      {
+         return APX_INVALID_PROGRAM_ERROR;
+      }
+      return apx_vm_execCopyPlan(plan, (uint8_t*) buffer, bufSize, (uint8_t*) nativeData, layout, false);
+   }
+   return APX_INVALID_ARGUMENT_ERROR;
+}
 
 //////////////////////////////////////////////////////////////////////////////
 // PRIVATE FUNCTIONS
@@ -600,3 +772,275 @@ static apx_error_t apx_vm_executeDataControlInstruction(apx_vm_t *self, uint8_t
    }
    return retval;
 }
+
+/**
+ * Native execution mode. Record instructions carry no data of their own and record select instructions are skipped
+ * since the layout table is positional. Each remaining pack/unpack instruction consumes one layout element.
+ */
+static apx_error_t apx_vm_execNativeProg(apx_vm_t *self, apx_vmNativeState_t *state)
+{
+   const uint8_t expectedOpcode = (self->progType == APX_VM_HEADER_PACK_PROG)? APX_OPCODE_PACK : APX_OPCODE_UNPACK;
+   while(self->progNext < self->progEnd)
+   {
+      apx_error_t rc = APX_NO_ERROR;
+      uint8_t opcode, variant, flags;
+      uint8_t instruction = *self->progNext++;
+
+      (void) apx_vm_decodeInstruction(instruction, &opcode, &variant, &flags);
+      if (opcode == APX_OPCODE_DATA_CTRL)
+      {
+         const uint8_t *pNullTerminator;
+         if (variant != APX_VARIANT_RECORD_SELECT)
+         {
+            return APX_INVALID_INSTRUCTION_ERROR;
+         }
+         pNullTerminator = (const uint8_t*) memchr(self->progNext, 0, (size_t) (self->progEnd - self->progNext));
+         if ( (pNullTerminator == 0) || (pNullTerminator == self->progNext) )
+         {
+            return APX_INVALID_NAME_ERROR;
+         }
+         self->progNext = pNullTerminator + 1;
+      }
+      else if (opcode == expectedOpcode)
+      {
+         apx_vm_prepareForPackUnpackInstruction(self);
+         if (flags & APX_ARRAY_FLAG)
+         {
+            uint8_t opcode2, variant2, flags2;
+            if (self->progNext >= self->progEnd)
+            {
+               return APX_INVALID_PROGRAM_ERROR;
+            }
+            instruction = *self->progNext++;
+            (void) apx_vm_decodeInstruction(instruction, &opcode2, &variant2, &flags2);
+            if (opcode2 != APX_OPCODE_ARRAY)
+            {
+               return APX_INVALID_INSTRUCTION_ERROR;
+            }
+            rc = apx_vm_executeArrayInstruction(self, variant2, (flags2 & APX_DYN_ARRAY_FLAG) != 0);
+            if (rc != APX_NO_ERROR)
+            {
+               return rc;
+            }
+         }
+         if (variant == APX_VARIANT_RECORD)
+         {
+            if (self->maxArrayLen > 0u)
+            {
+               return APX_NOT_IMPLEMENTED_ERROR;
+            }
+         }
+         else
+         {
+            rc = apx_vm_executeNativeInstruction(self, state, variant);
+         }
+      }
+      else
+      {
+         rc = APX_INVALID_STATE_ERROR;
+      }
+      if (rc != APX_NO_ERROR)
+      {
+         return rc;
+      }
+   }
+   if (state->elementIndex != state->layout->numElements)
+   {
+      return APX_LENGTH_ERROR;
+   }
+   return APX_NO_ERROR;
+}
+
+static apx_error_t apx_vm_executeNativeInstruction(apx_vm_t *self, apx_vmNativeState_t *state, uint8_t variant)
+{
+   const apx_vmNativeElement_t *element;
+   const bool isPack = (self->progType == APX_VM_HEADER_PACK_PROG);
+   uint8_t elemSize;
+   uint32_t arrayLen;
+   apx_size_t dataLen;
+   uint8_t *pNative;
+   if (self->dynLenType != APX_DYN_LEN_NONE)
+   {
+      return APX_NOT_IMPLEMENTED_ERROR;
+   }
+   switch(variant)
+   {
+   case APX_VARIANT_U8:
+   case APX_VARIANT_S8:
+   case APX_VARIANT_STR:
+      elemSize = UINT8_SIZE;
+      break;
+   case APX_VARIANT_U16:
+   case APX_VARIANT_S16:
+      elemSize = UINT16_SIZE;
+      break;
+   case APX_VARIANT_U32:
+   case APX_VARIANT_S32:
+      elemSize = UINT32_SIZE;
+      break;
+   default:
+      return APX_NOT_IMPLEMENTED_ERROR;
+   }
+   if (state->elementIndex >= state->layout->numElements)
+   {
+      return APX_LENGTH_ERROR;
+   }
+   element = &state->layout->elements[state->elementIndex++];
+   arrayLen = (self->maxArrayLen > 0u)? self->maxArrayLen : 1u;
+   dataLen = elemSize * arrayLen;
+   if (element->size != dataLen)
+   {
+      return APX_LENGTH_ERROR;
+   }
+   if (state->pNext + dataLen > state->pEnd)
+   {
+      return APX_BUFFER_BOUNDARY_ERROR;
+   }
+   pNative = state->nativeData + element->offset;
+   if (variant == APX_VARIANT_STR)
+   {
+      if (isPack)
+      {
+         //Same as apx_vmSerializer_packFixedStr: unused bytes after the string are zero-filled
+         const uint8_t *pNullTerminator = (const uint8_t*) memchr(pNative, 0, dataLen);
+         apx_size_t strLen = (pNullTerminator != 0)? (apx_size_t) (pNullTerminator - pNative) : dataLen;
+         memcpy(state->pNext, pNative, strLen);
+         memset(state->pNext + strLen, 0, dataLen - strLen);
+      }
+      else
+      {
+         memcpy(pNative, state->pNext, dataLen);
+      }
+   }
+   else if (elemSize == UINT8_SIZE)
+   {
+      if (isPack)
+      {
+         memcpy(state->pNext, pNative, dataLen);
+      }
+      else
+      {
+         memcpy(pNative, state->pNext, dataLen);
+      }
+   }
+   else
+   {
+      uint32_t i;
+      for (i = 0u; i < arrayLen; i++)
+      {
+         uint8_t *pData = state->pNext + (i * elemSize);
+         uint8_t *pValue = pNative + (i * elemSize);
+         if (elemSize == UINT16_SIZE)
+         {
+            uint16_t u16Value;
+            if (isPack)
+            {
+               memcpy(&u16Value, pValue, UINT16_SIZE);
+               packLE(pData, (uint32_t) u16Value, UINT16_SIZE);
+            }
+            else
+            {
+               u16Value = (uint16_t) unpackLE(pData, UINT16_SIZE);
+               memcpy(pValue, &u16Value, UINT16_SIZE);
+            }
+         }
+         else
+         {
+            uint32_t u32Value;
+            if (isPack)
+            {
+               memcpy(&u32Value, pValue, UINT32_SIZE);
+               packLE(pData, u32Value, UINT32_SIZE);
+            }
+            else
+            {
+               u32Value = (uint32_t) unpackLE(pData, UINT32_SIZE);
+               memcpy(pValue, &u32Value, UINT32_SIZE);
+            }
+         }
+      }
+   }
+   state->pNext += dataLen;
+   return APX_NO_ERROR;
+}
+
+static apx_error_t apx_vm_execCopyPlan(const apx_copyPlan_t *plan, uint8_t *data, apx_size_t dataSize, uint8_t *nativeData, const apx_vmNativeLayout_t *layout, bool isPack)
+{
+   uint32_t runIndex;
+   if (dataSize < plan->dataSize)
+   {
+      return APX_BUFFER_BOUNDARY_ERROR;
+   }
+   if (layout->numElements != plan->numRuns)
+   {
+      return APX_LENGTH_ERROR;
+   }
+   for (runIndex = 0u; runIndex < plan->numRuns; runIndex++)
+   {
+      const apx_copyRun_t *run = &plan->runs[runIndex];
+      const apx_vmNativeElement_t *element = &layout->elements[run->elementIndex];
+      apx_size_t runLen = run->width * run->count;
+      uint8_t *pData = data + run->dataOffset;
+      uint8_t *pNative = nativeData + element->offset;
+      if (element->size != runLen)
+      {
+         return APX_LENGTH_ERROR;
+      }
+      if ( (isPack) && (run->flags & APX_COPY_RUN_FLAG_STRING) )
+      {
+         const uint8_t *pNullTerminator = (const uint8_t*) memchr(pNative, 0, runLen);
+         apx_size_t strLen = (pNullTerminator != 0)? (apx_size_t) (pNullTerminator - pNative) : runLen;
+         memcpy(pData, pNative, strLen);
+         memset(pData + strLen, 0, runLen - strLen);
+      }
+      else if (run->flags & APX_COPY_RUN_FLAG_MEMCPY)
+      {
+         if (isPack)
+         {
+            memcpy(pData, pNative, runLen);
+         }
+         else
+         {
+            memcpy(pNative, pData, runLen);
+         }
+      }
+      else
+      {
+         uint32_t i;
+         for (i = 0u; i < run->count; i++)
+         {
+            if (run->width == UINT16_SIZE)
+            {
+               uint16_t u16Value;
+               if (isPack)
+               {
+                  memcpy(&u16Value, pNative, UINT16_SIZE);
+                  packLE(pData, (uint32_t) u16Value, UINT16_SIZE);
+               }
+               else
+               {
+                  u16Value = (uint16_t) unpackLE(pData, UINT16_SIZE);
+                  memcpy(pNative, &u16Value, UINT16_SIZE);
+               }
+            }
+            else
+            {
+               uint32_t u32Value;
+               if (isPack)
+               {
+                  memcpy(&u32Value, pNative, UINT32_SIZE);
+                  packLE(pData, u32Value, UINT32_SIZE);
+               }
+               else
+               {
+                  u32Value = (uint32_t) unpackLE(pData, UINT32_SIZE);
+                  memcpy(pNative, &u32Value, UINT32_SIZE);
+               }
+            }
+            pData += run->width;
+            pNative += run->width;
+         }
+      }
+   }
+   return APX_NO_ERROR;
+}
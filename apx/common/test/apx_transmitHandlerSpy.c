@@ -110,6 +110,38 @@ int32_t apx_transmitHandlerSpy_send(void *arg, int32_t offset, int32_t msgLen)
    return -1;
 }
 
+int32_t apx_transmitHandlerSpy_sendFramed(void *arg, const uint8_t *data, int32_t dataLen)
+{
+   apx_transmitHandlerSpy_t* self = (apx_transmitHandlerSpy_t*) arg;
+   if ( (self != 0) && (data != 0) && (dataLen >= 0) )
+   {
+      adt_bytearray_t *buf = adt_bytearray_new(ADT_BYTE_ARRAY_DEFAULT_GROW_SIZE);
+      adt_bytearray_append(buf, data, (uint32_t) dataLen);
+      adt_ary_push(self->transmitted, buf);
+      return dataLen;
+   }
+   return -1;
+}
+
+int32_t apx_transmitHandlerSpy_sendGather(void *arg, const apx_transmitSegment_t *segments, int32_t numSegments)
+{
+   apx_transmitHandlerSpy_t* self = (apx_transmitHandlerSpy_t*) arg;
+   if ( (self != 0) && (segments != 0) && (numSegments >= 0) )
+   {
+      int32_t i;
+      int32_t totalLen = 0;
+      adt_bytearray_t *buf = adt_bytearray_new(ADT_BYTE_ARRAY_DEFAULT_GROW_SIZE);
+      for (i = 0; i < numSegments; i++)
+      {
+         adt_bytearray_append(buf, segments[i].data, (uint32_t) segments[i].dataLen);
+         totalLen += segments[i].dataLen;
+      }
+      adt_ary_push(self->transmitted, buf);
+      return totalLen;
+   }
+   return -1;
+}
+
 
 
 //////////////////////////////////////////////////////////////////////////////
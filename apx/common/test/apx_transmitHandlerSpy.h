@@ -54,5 +54,7 @@ adt_bytearray_t *apx_transmitHandlerSpy_next(apx_transmitHandlerSpy_t *self);
 
 uint8_t* apx_transmitHandlerSpy_getSendBuffer(void *arg, int32_t msgLen);
 int32_t apx_transmitHandlerSpy_send(void *arg, int32_t offset, int32_t msgLen);
+int32_t apx_transmitHandlerSpy_sendFramed(void *arg, const uint8_t *data, int32_t dataLen);
+int32_t apx_transmitHandlerSpy_sendGather(void *arg, const apx_transmitSegment_t *segments, int32_t numSegments);
 
 #endif //TRANSMIT_HANDLER_SPY_H
@@ -13,17 +13,26 @@ CuSuite* testSuite_remotefile(void);
 CuSuite* testSuite_apx_allocator(void);
 CuSuite* testsuite_apx_attributesParser(void);
 CuSuite* testSuite_apx_bytePortMap(void);
+CuSuite* testSuite_apx_byteRangeSet(void);
 CuSuite* testSuite_apx_compiler(void);
 CuSuite* testSuite_apx_dataElement(void);
 CuSuite* testsuite_apx_dataSignature(void);
 CuSuite* testsuite_apx_datatype(void);
 CuSuite* testSuite_apx_eventLoop(void);
+CuSuite* testSuite_apx_executor(void);
+CuSuite* testSuite_apx_mpscQueue(void);
+CuSuite* testSuite_apx_spscRing(void);
+CuSuite* testSuite_apx_portQueue(void);
+CuSuite* testSuite_apx_payload(void);
 CuSuite* testSuite_apx_file2(void);
+CuSuite* testSuite_apx_fileCache(void);
 CuSuite* testSuite_apx_fileManagerShared(void);
 CuSuite* testSuite_apx_fileManagerWorker(void);
 CuSuite* testSuite_apx_fileManagerReceiver(void);
 CuSuite* testSuite_apx_fileManager(void);
 CuSuite* testSuite_apx_fileMap(void);
+CuSuite* testSuite_apx_latencyStats(void);
+CuSuite* testSuite_apx_lz(void);
 CuSuite* testSuite_apx_node(void);
 CuSuite* testSuite_apx_nodeData2(void);
 CuSuite* testSuite_apx_nodeManager(void);
@@ -34,6 +43,9 @@ CuSuite* testsuite_apx_port(void);
 CuSuite* testSuite_apx_portConnectorChangeEntry(void);
 CuSuite* testSuite_apx_portConnectorChangeTable(void);
 CuSuite* testSuite_apx_portSignatureMap(void);
+CuSuite* testSuite_apx_routingPlan(void);
+CuSuite* testSuite_apx_sha256(void);
+CuSuite* testSuite_apx_signatureTable(void);
 CuSuite* testSuite_apx_vm(void);
 CuSuite* testSuite_apx_vmSerializer(void);
 CuSuite* testSuite_apx_vmDeserializer(void);
@@ -49,6 +61,7 @@ CuSuite* testSuite_apx_dataRouting(void);
 CuSuite* testSuite_apx_serverSocketConnection(void);
 CuSuite* testsuite_apx_socketServerExtension(void);
 CuSuite* testsuite_apx_serverTextLogExtension(void);
+CuSuite* testSuite_apx_serverStats(void);
 
 /** APX Client **/
 CuSuite* testSuite_apx_client_socketConnection(void);
@@ -66,11 +79,17 @@ void RunAllTests(void)
    CuSuiteAddSuite(suite, testSuite_apx_allocator());
    CuSuiteAddSuite(suite, testsuite_apx_attributesParser());
    CuSuiteAddSuite(suite, testSuite_apx_bytePortMap());
+   CuSuiteAddSuite(suite, testSuite_apx_byteRangeSet());
    CuSuiteAddSuite(suite, testSuite_apx_compiler());
    CuSuiteAddSuite(suite, testSuite_apx_dataElement());
    CuSuiteAddSuite(suite, testsuite_apx_dataSignature());
    CuSuiteAddSuite(suite, testsuite_apx_datatype());
    CuSuiteAddSuite(suite, testSuite_apx_eventLoop());
+   CuSuiteAddSuite(suite, testSuite_apx_executor());
+   CuSuiteAddSuite(suite, testSuite_apx_mpscQueue());
+   CuSuiteAddSuite(suite, testSuite_apx_spscRing());
+   CuSuiteAddSuite(suite, testSuite_apx_portQueue());
+   CuSuiteAddSuite(suite, testSuite_apx_payload());
 
    CuSuiteAddSuite(suite, testSuite_apx_node());
    CuSuiteAddSuite(suite, testSuite_apx_nodeData2());
@@ -84,7 +103,10 @@ void RunAllTests(void)
 
 
    CuSuiteAddSuite(suite, testSuite_apx_file2());
+   CuSuiteAddSuite(suite, testSuite_apx_fileCache());
    CuSuiteAddSuite(suite, testSuite_apx_fileMap());
+   CuSuiteAddSuite(suite, testSuite_apx_latencyStats());
+   CuSuiteAddSuite(suite, testSuite_apx_lz());
    CuSuiteAddSuite(suite, testSuite_apx_vmSerializer());
    CuSuiteAddSuite(suite, testSuite_apx_vmDeserializer());
 
@@ -98,6 +120,9 @@ void RunAllTests(void)
    CuSuiteAddSuite(suite, testSuite_apx_portConnectorChangeEntry());
    CuSuiteAddSuite(suite, testSuite_apx_portConnectorChangeTable());
    CuSuiteAddSuite(suite, testSuite_apx_portSignatureMap());
+   CuSuiteAddSuite(suite, testSuite_apx_routingPlan());
+   CuSuiteAddSuite(suite, testSuite_apx_sha256());
+   CuSuiteAddSuite(suite, testSuite_apx_signatureTable());
 
    //Util
    CuSuiteAddSuite(suite, testSuite_apx_util());
@@ -120,6 +145,7 @@ void RunAllTests(void)
 
 // APX Server Extensions
    CuSuiteAddSuite(suite, testsuite_apx_socketServerExtension());
+   CuSuiteAddSuite(suite, testSuite_apx_serverStats());
 /*
    CuSuiteAddSuite(suite, testsuite_apx_serverTextLogExtension());
 */
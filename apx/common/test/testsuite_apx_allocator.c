@@ -22,6 +22,8 @@
 // LOCAL FUNCTION PROTOTYPES
 //////////////////////////////////////////////////////////////////////////////
 static void test_apx_allocator_create(CuTest* tc);
+static void test_apx_allocator_reuseFreedBlocks(CuTest* tc);
+static void test_apx_allocator_largeObjects(CuTest* tc);
 
 //////////////////////////////////////////////////////////////////////////////
 // GLOBAL VARIABLES
@@ -42,6 +44,8 @@ CuSuite* testSuite_apx_allocator(void)
    CuSuite* suite = CuSuiteNew();
 
    SUITE_ADD_TEST(suite, test_apx_allocator_create);
+   SUITE_ADD_TEST(suite, test_apx_allocator_reuseFreedBlocks);
+   SUITE_ADD_TEST(suite, test_apx_allocator_largeObjects);
 
    return suite;
 }
@@ -58,8 +62,8 @@ static void test_apx_allocator_create(CuTest* tc)
    uint8_t *data4;
    uint8_t *data128;
    apx_allocator_t allocator;
-   apx_allocator_create(&allocator,100);
-   apx_allocator_start(&allocator);
+   apx_allocatorStats_t stats;
+   CuAssertIntEquals(tc, APX_NO_ERROR, apx_allocator_create(&allocator));
    data1 = apx_allocator_alloc(&allocator,1);
    CuAssertPtrNotNull(tc,data1);
    data2 = apx_allocator_alloc(&allocator,2);
@@ -73,10 +77,61 @@ static void test_apx_allocator_create(CuTest* tc)
    apx_allocator_free(&allocator,data2, 2);
    apx_allocator_free(&allocator,data3, 3);
    apx_allocator_free(&allocator,data4, 4);
+   apx_allocator_getStats(&allocator, &stats);
+   CuAssertUIntEquals(tc, 138u, stats.liveBytes);
    apx_allocator_free(&allocator,data128, 128);
-   CuAssertIntEquals(tc, 5, apx_allocator_numPendingMessages(&allocator));
-   apx_allocator_processAll(&allocator);
-   apx_allocator_stop(&allocator);
+   apx_allocator_getStats(&allocator, &stats);
+   CuAssertUIntEquals(tc, 5u, stats.numAllocs);
+   CuAssertUIntEquals(tc, 0u, stats.numCacheHits);
+   CuAssertUIntEquals(tc, 0u, stats.liveBytes);
+   CuAssertUIntEquals(tc, 138u, stats.highWaterMark);
+   apx_allocator_destroy(&allocator);
+}
+
+static void test_apx_allocator_reuseFreedBlocks(CuTest* tc)
+{
+   uint8_t *data1;
+   uint8_t *data2;
+   uint8_t *data3;
+   apx_allocator_t allocator;
+   apx_allocatorStats_t stats;
+   CuAssertIntEquals(tc, APX_NO_ERROR, apx_allocator_create(&allocator));
+   data1 = apx_allocator_alloc(&allocator, 20);
+   data2 = apx_allocator_alloc(&allocator, 32);
+   CuAssertPtrNotNull(tc, data1);
+   CuAssertPtrNotNull(tc, data2);
+   CuAssertTrue(tc, data1 != data2);
+   apx_allocator_free(&allocator, data1, 20);
+   //any size in the same size class reuses the freed block
+   data3 = apx_allocator_alloc(&allocator, 17);
+   CuAssertPtrEquals(tc, data1, data3);
+   apx_allocator_getStats(&allocator, &stats);
+   CuAssertUIntEquals(tc, 3u, stats.numAllocs);
+   CuAssertUIntEquals(tc, 1u, stats.numCacheHits);
+   CuAssertUIntEquals(tc, 49u, stats.liveBytes);
+   CuAssertUIntEquals(tc, 52u, stats.highWaterMark);
+   CuAssertUIntEquals(tc, APX_ALLOCATOR_SLAB_SIZE, stats.reservedBytes);
+   apx_allocator_free(&allocator, data2, 32);
+   apx_allocator_free(&allocator, data3, 17);
+   apx_allocator_destroy(&allocator);
+}
+
+static void test_apx_allocator_largeObjects(CuTest* tc)
+{
+   uint8_t *data;
+   apx_allocator_t allocator;
+   apx_allocatorStats_t stats;
+   CuAssertIntEquals(tc, APX_NO_ERROR, apx_allocator_create(&allocator));
+   data = apx_allocator_alloc(&allocator, APX_ALLOCATOR_MAX_BLOCK_SIZE + 1u);
+   CuAssertPtrNotNull(tc, data);
+   apx_allocator_getStats(&allocator, &stats);
+   CuAssertUIntEquals(tc, 1u, stats.numAllocs);
+   CuAssertUIntEquals(tc, 1u, stats.numLargeAllocs);
+   CuAssertUIntEquals(tc, 0u, stats.reservedBytes);
+   CuAssertUIntEquals(tc, APX_ALLOCATOR_MAX_BLOCK_SIZE + 1u, stats.liveBytes);
+   apx_allocator_free(&allocator, data, APX_ALLOCATOR_MAX_BLOCK_SIZE + 1u);
+   apx_allocator_getStats(&allocator, &stats);
+   CuAssertUIntEquals(tc, 0u, stats.liveBytes);
    apx_allocator_destroy(&allocator);
 }
 
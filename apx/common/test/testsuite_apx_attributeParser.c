@@ -27,6 +27,7 @@ static void test_apx_attributeParser_parseInitValueArrayOfUnsignedInt(CuTest* tc
 static void test_apx_attributeParser_parseInitValueString(CuTest* tc);
 static void test_apx_attributeParser_parseSingleAttribute(CuTest* tc);
 static void test_apx_attributeParser_parseQueueLength(CuTest* tc);
+static void test_apx_attributeParser_parseEventAttribute(CuTest* tc);
 
 //////////////////////////////////////////////////////////////////////////////
 // GLOBAL VARIABLES
@@ -53,6 +54,7 @@ CuSuite* testsuite_apx_attributesParser(void)
    SUITE_ADD_TEST(suite, test_apx_attributeParser_parseInitValueString);
    SUITE_ADD_TEST(suite, test_apx_attributeParser_parseSingleAttribute);
    SUITE_ADD_TEST(suite, test_apx_attributeParser_parseQueueLength);
+   SUITE_ADD_TEST(suite, test_apx_attributeParser_parseEventAttribute);
 
    return suite;
 }
@@ -809,3 +811,46 @@ static void test_apx_attributeParser_parseInitValueString(CuTest* tc)
 
    apx_attributeParser_destroy(&parser);
 }
+
+static void test_apx_attributeParser_parseEventAttribute(CuTest* tc)
+{
+   const char *test_data1 = "=0, E";
+   const char *test_data2 = "E";
+   const char *test_data = 0;
+   const uint8_t *pBegin = 0;
+   const uint8_t *pEnd = 0;
+   const uint8_t *pResult = 0;
+   int32_t lastError;
+   const uint8_t *pErrorNext;
+   apx_attributeParser_t parser;
+   apx_portAttributes_t attr;
+
+   apx_attributeParser_create(&parser);
+
+   test_data = test_data1;
+   apx_portAttributes_create(&attr, test_data);
+   pBegin = (const uint8_t*)test_data, pEnd = pBegin+strlen(test_data);
+   CuAssertTrue(tc, attr.isEvent == false);
+   pResult = apx_attributeParser_parse(&parser, pBegin, pEnd, &attr);
+   CuAssertConstPtrEquals(tc, pEnd, pResult);
+   CuAssertPtrNotNull(tc, attr.initValue);
+   CuAssertTrue(tc, attr.isEvent == true);
+   CuAssertTrue(tc, attr.isQueued == false);
+   CuAssertTrue(tc, attr.isParameter == false);
+   apx_portAttributes_destroy(&attr);
+
+   //E is not part of APX/1.2
+   apx_attributeParser_setVersion(&parser, 1, 2);
+   test_data = test_data2;
+   apx_portAttributes_create(&attr, test_data);
+   pBegin = (const uint8_t*)test_data, pEnd = pBegin+strlen(test_data);
+   pResult = apx_attributeParser_parse(&parser, pBegin, pEnd, &attr);
+   CuAssertConstPtrEquals(tc, 0, pResult);
+   lastError = apx_attributeParser_getLastError(&parser, &pErrorNext);
+   CuAssertIntEquals(tc, APX_INVALID_ATTRIBUTE_ERROR, lastError);
+   CuAssertConstPtrEquals(tc, pBegin, pErrorNext);
+   CuAssertTrue(tc, attr.isEvent == false);
+   apx_portAttributes_destroy(&attr);
+
+   apx_attributeParser_destroy(&parser);
+}
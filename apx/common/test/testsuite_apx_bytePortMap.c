@@ -45,6 +45,8 @@
 //////////////////////////////////////////////////////////////////////////////
 static void test_apx_bytePortMap_createClientBytePortMap(CuTest* tc);
 static void test_apx_bytePortMap_createServerBytePortMap(CuTest* tc);
+static void test_apx_bytePortMap_lookupFromDataProps(CuTest* tc);
+static void test_apx_bytePortMap_lookupManyPorts(CuTest* tc);
 
 //////////////////////////////////////////////////////////////////////////////
 // PRIVATE VARIABLES
@@ -59,6 +61,8 @@ CuSuite* testSuite_apx_bytePortMap(void)
 
 //   SUITE_ADD_TEST(suite, test_apx_bytePortMap_createClientBytePortMap);
 //   SUITE_ADD_TEST(suite, test_apx_bytePortMap_createServerBytePortMap);
+   SUITE_ADD_TEST(suite, test_apx_bytePortMap_lookupFromDataProps);
+   SUITE_ADD_TEST(suite, test_apx_bytePortMap_lookupManyPorts);
 
    return suite;
 }
@@ -133,4 +137,54 @@ static void test_apx_bytePortMap_createServerBytePortMap(CuTest* tc)
 
 }
 
+static void test_apx_bytePortMap_lookupFromDataProps(CuTest* tc)
+{
+   apx_portDataProps_t props[4];
+   apx_bytePortMap_t bytePortMap;
+   int32_t i;
+   apx_portId_t expected[32] =
+   {     0, 0, 0, 0, 0, 0, 0, 0,
+         1,
+         2, 2,
+         3, 3, 3, 3, 3, 3, 3, 3, 3, 3,
+         3, 3, 3, 3, 3, 3, 3, 3, 3, 3, 3
+   };
+   apx_portDataProps_create(&props[0], APX_PROVIDE_PORT, 0, 0, 8);
+   apx_portDataProps_create(&props[1], APX_PROVIDE_PORT, 1, 8, 1);
+   apx_portDataProps_create(&props[2], APX_PROVIDE_PORT, 2, 9, 2);
+   apx_portDataProps_create(&props[3], APX_PROVIDE_PORT, 3, 11, 21);
+   CuAssertIntEquals(tc, APX_NO_ERROR, apx_bytePortMap_create(&bytePortMap, &props[0], 4));
+   CuAssertUIntEquals(tc, 32, apx_bytePortMap_length(&bytePortMap));
+   for(i=0;i<32;i++)
+   {
+      char msg[ERROR_SIZE];
+      sprintf(msg, "i=%d",i);
+      CuAssertIntEquals_Msg(tc, msg, expected[i], apx_bytePortMap_lookup(&bytePortMap, i));
+   }
+   CuAssertIntEquals(tc, -1, apx_bytePortMap_lookup(&bytePortMap, -1));
+   CuAssertIntEquals(tc, -1, apx_bytePortMap_lookup(&bytePortMap, 32));
+   apx_bytePortMap_destroy(&bytePortMap);
+}
 
+static void test_apx_bytePortMap_lookupManyPorts(CuTest* tc)
+{
+   apx_portDataProps_t props[100];
+   apx_bytePortMap_t bytePortMap;
+   apx_portId_t portId;
+   apx_offset_t offset = 0;
+   for (portId = 0; portId < 100; portId++)
+   {
+      apx_size_t dataSize = (apx_size_t) (portId % 7) * 50u + 1u; //spans several map blocks
+      apx_portDataProps_create(&props[portId], APX_PROVIDE_PORT, portId, offset, dataSize);
+      offset += (apx_offset_t) dataSize;
+   }
+   CuAssertIntEquals(tc, APX_NO_ERROR, apx_bytePortMap_create(&bytePortMap, &props[0], 100));
+   CuAssertUIntEquals(tc, offset, apx_bytePortMap_length(&bytePortMap));
+   CuAssertIntEquals(tc, -1, apx_bytePortMap_lookup(&bytePortMap, offset));
+   for (portId = 0; portId < 100; portId++)
+   {
+      CuAssertIntEquals(tc, portId, apx_bytePortMap_lookup(&bytePortMap, props[portId].offset));
+      CuAssertIntEquals(tc, portId, apx_bytePortMap_lookup(&bytePortMap, props[portId].offset + (apx_offset_t) props[portId].dataSize - 1));
+   }
+   apx_bytePortMap_destroy(&bytePortMap);
+}
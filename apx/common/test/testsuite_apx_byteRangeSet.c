@@ -0,0 +1,153 @@
+/*****************************************************************************
+* \file      testsuite_apx_byteRangeSet.c
+* \author    Conny Gustafsson
+* \date      2026-10-18
+* \brief     Unit tests for apx_byteRangeSet
+*
+* Copyright (c) 2026 Conny Gustafsson
+* Permission is hereby granted, free of charge, to any person obtaining a copy of
+* this software and associated documentation files (the "Software"), to deal in
+* the Software without restriction, including without limitation the rights to
+* use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+* the Software, and to permit persons to whom the Software is furnished to do so,
+* subject to the following conditions:
+
+* The above copyright notice and this permission notice shall be included in all
+* copies or substantial portions of the Software.
+
+* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+* IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+* FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+* COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+* IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+* CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+*
+******************************************************************************/
+//////////////////////////////////////////////////////////////////////////////
+// INCLUDES
+//////////////////////////////////////////////////////////////////////////////
+#include <stddef.h>
+#include <stdio.h>
+#include "CuTest.h"
+#include "apx_byteRangeSet.h"
+#ifdef MEM_LEAK_CHECK
+#include "CMemLeak.h"
+#endif
+
+//////////////////////////////////////////////////////////////////////////////
+// PRIVATE CONSTANTS AND DATA TYPES
+//////////////////////////////////////////////////////////////////////////////
+
+//////////////////////////////////////////////////////////////////////////////
+// PRIVATE FUNCTION PROTOTYPES
+//////////////////////////////////////////////////////////////////////////////
+static void test_apx_byteRangeSet_insertDisjoint(CuTest* tc);
+static void test_apx_byteRangeSet_mergeAdjacent(CuTest* tc);
+static void test_apx_byteRangeSet_mergeWithGap(CuTest* tc);
+static void test_apx_byteRangeSet_mergeSpanningMany(CuTest* tc);
+
+//////////////////////////////////////////////////////////////////////////////
+// PRIVATE VARIABLES
+//////////////////////////////////////////////////////////////////////////////
+
+//////////////////////////////////////////////////////////////////////////////
+// PUBLIC FUNCTIONS
+//////////////////////////////////////////////////////////////////////////////
+CuSuite* testSuite_apx_byteRangeSet(void)
+{
+   CuSuite* suite = CuSuiteNew();
+
+   SUITE_ADD_TEST(suite, test_apx_byteRangeSet_insertDisjoint);
+   SUITE_ADD_TEST(suite, test_apx_byteRangeSet_mergeAdjacent);
+   SUITE_ADD_TEST(suite, test_apx_byteRangeSet_mergeWithGap);
+   SUITE_ADD_TEST(suite, test_apx_byteRangeSet_mergeSpanningMany);
+
+   return suite;
+}
+
+//////////////////////////////////////////////////////////////////////////////
+// PRIVATE FUNCTIONS
+//////////////////////////////////////////////////////////////////////////////
+static void test_apx_byteRangeSet_insertDisjoint(CuTest* tc)
+{
+   apx_byteRangeSet_t rangeSet;
+   const apx_byteRange_t *range;
+   apx_byteRangeSet_create(&rangeSet, 0u);
+   CuAssertIntEquals(tc, APX_NO_ERROR, apx_byteRangeSet_insert(&rangeSet, 20u, 4u));
+   CuAssertIntEquals(tc, APX_NO_ERROR, apx_byteRangeSet_insert(&rangeSet, 0u, 2u));
+   CuAssertIntEquals(tc, APX_NO_ERROR, apx_byteRangeSet_insert(&rangeSet, 10u, 1u));
+   CuAssertIntEquals(tc, APX_INVALID_ARGUMENT_ERROR, apx_byteRangeSet_insert(&rangeSet, 30u, 0u));
+   CuAssertUIntEquals(tc, 3u, apx_byteRangeSet_length(&rangeSet));
+   range = apx_byteRangeSet_get(&rangeSet, 0u);
+   CuAssertUIntEquals(tc, 0u, range->offset);
+   CuAssertUIntEquals(tc, 2u, range->len);
+   range = apx_byteRangeSet_get(&rangeSet, 1u);
+   CuAssertUIntEquals(tc, 10u, range->offset);
+   CuAssertUIntEquals(tc, 1u, range->len);
+   range = apx_byteRangeSet_get(&rangeSet, 2u);
+   CuAssertUIntEquals(tc, 20u, range->offset);
+   CuAssertUIntEquals(tc, 4u, range->len);
+   CuAssertPtrEquals(tc, 0, (void*) apx_byteRangeSet_get(&rangeSet, 3u));
+   apx_byteRangeSet_clear(&rangeSet);
+   CuAssertUIntEquals(tc, 0u, apx_byteRangeSet_length(&rangeSet));
+   apx_byteRangeSet_destroy(&rangeSet);
+}
+
+static void test_apx_byteRangeSet_mergeAdjacent(CuTest* tc)
+{
+   apx_byteRangeSet_t rangeSet;
+   const apx_byteRange_t *range;
+   apx_byteRangeSet_create(&rangeSet, 0u);
+   CuAssertIntEquals(tc, APX_NO_ERROR, apx_byteRangeSet_insert(&rangeSet, 0u, 1u));
+   CuAssertIntEquals(tc, APX_NO_ERROR, apx_byteRangeSet_insert(&rangeSet, 1u, 2u));
+   CuAssertIntEquals(tc, APX_NO_ERROR, apx_byteRangeSet_insert(&rangeSet, 3u, 4u));
+   CuAssertIntEquals(tc, APX_NO_ERROR, apx_byteRangeSet_insert(&rangeSet, 2u, 1u));
+   CuAssertUIntEquals(tc, 1u, apx_byteRangeSet_length(&rangeSet));
+   range = apx_byteRangeSet_get(&rangeSet, 0u);
+   CuAssertUIntEquals(tc, 0u, range->offset);
+   CuAssertUIntEquals(tc, 7u, range->len);
+   CuAssertIntEquals(tc, APX_NO_ERROR, apx_byteRangeSet_insert(&rangeSet, 8u, 1u));
+   CuAssertUIntEquals(tc, 2u, apx_byteRangeSet_length(&rangeSet));
+   apx_byteRangeSet_destroy(&rangeSet);
+}
+
+static void test_apx_byteRangeSet_mergeWithGap(CuTest* tc)
+{
+   apx_byteRangeSet_t *rangeSet = apx_byteRangeSet_new(4u);
+   const apx_byteRange_t *range;
+   CuAssertPtrNotNull(tc, rangeSet);
+   CuAssertIntEquals(tc, APX_NO_ERROR, apx_byteRangeSet_insert(rangeSet, 0u, 2u));
+   CuAssertIntEquals(tc, APX_NO_ERROR, apx_byteRangeSet_insert(rangeSet, 6u, 2u));
+   CuAssertUIntEquals(tc, 1u, apx_byteRangeSet_length(rangeSet));
+   CuAssertIntEquals(tc, APX_NO_ERROR, apx_byteRangeSet_insert(rangeSet, 13u, 1u));
+   CuAssertUIntEquals(tc, 2u, apx_byteRangeSet_length(rangeSet));
+   range = apx_byteRangeSet_get(rangeSet, 0u);
+   CuAssertUIntEquals(tc, 0u, range->offset);
+   CuAssertUIntEquals(tc, 8u, range->len);
+   range = apx_byteRangeSet_get(rangeSet, 1u);
+   CuAssertUIntEquals(tc, 13u, range->offset);
+   CuAssertUIntEquals(tc, 1u, range->len);
+   apx_byteRangeSet_delete(rangeSet);
+}
+
+static void test_apx_byteRangeSet_mergeSpanningMany(CuTest* tc)
+{
+   apx_byteRangeSet_t rangeSet;
+   const apx_byteRange_t *range;
+   uint32_t i;
+   apx_byteRangeSet_create(&rangeSet, 0u);
+   for (i = 0u; i < 100u; i++)
+   {
+      CuAssertIntEquals(tc, APX_NO_ERROR, apx_byteRangeSet_insert(&rangeSet, i * 4u, 2u));
+   }
+   CuAssertUIntEquals(tc, 100u, apx_byteRangeSet_length(&rangeSet));
+   CuAssertIntEquals(tc, APX_NO_ERROR, apx_byteRangeSet_insert(&rangeSet, 9u, 40u));
+   CuAssertUIntEquals(tc, 90u, apx_byteRangeSet_length(&rangeSet));
+   range = apx_byteRangeSet_get(&rangeSet, 2u);
+   CuAssertUIntEquals(tc, 8u, range->offset);
+   CuAssertUIntEquals(tc, 42u, range->len);
+   range = apx_byteRangeSet_get(&rangeSet, 3u);
+   CuAssertUIntEquals(tc, 52u, range->offset);
+   CuAssertUIntEquals(tc, 2u, range->len);
+   apx_byteRangeSet_destroy(&rangeSet);
+}
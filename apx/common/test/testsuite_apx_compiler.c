@@ -89,6 +89,8 @@ static void test_apx_compiler_compileUnpackDataElement_U8DynArrayU8(CuTest* tc);
 static void test_apx_compiler_compileUnpackDataElement_U8DynArrayU16(CuTest* tc);
 static void test_apx_compiler_compileUnpackDataElement_U8DynArrayU32(CuTest* tc);
 static void test_apx_compiler_compileUnpackDataElement_RecordContainingU16AndU8Value(CuTest* tc);
+static void test_apx_compiler_lowerToCopyPlan_flatRecord(CuTest* tc);
+static void test_apx_compiler_lowerToCopyPlan_dynamicArray(CuTest* tc);
 
 
 
@@ -144,6 +146,8 @@ CuSuite* testSuite_apx_compiler(void)
    SUITE_ADD_TEST(suite, test_apx_compiler_compileUnpackDataElement_U8DynArrayU16);
    SUITE_ADD_TEST(suite, test_apx_compiler_compileUnpackDataElement_U8DynArrayU32);
    SUITE_ADD_TEST(suite, test_apx_compiler_compileUnpackDataElement_RecordContainingU16AndU8Value);
+   SUITE_ADD_TEST(suite, test_apx_compiler_lowerToCopyPlan_flatRecord);
+   SUITE_ADD_TEST(suite, test_apx_compiler_lowerToCopyPlan_dynamicArray);
 
 
    return suite;
@@ -1019,3 +1023,78 @@ static void test_apx_compiler_compileUnpackDataElement_RecordContainingU16AndU8V
    adt_bytearray_delete(program);
 
 }
+
+static void test_apx_compiler_lowerToCopyPlan_flatRecord(CuTest* tc)
+{
+   apx_compiler_t *compiler;
+   apx_dataElement_t *rootElem;
+   apx_dataElement_t *childElem;
+   adt_bytearray_t *program = adt_bytearray_new(APX_PROGRAM_GROW_SIZE);
+   adt_bytes_t *storedProgram;
+   apx_copyPlan_t *plan = (apx_copyPlan_t*) 0;
+   const apx_copyRun_t *run;
+
+   //DSG: {"DTCId"S"FTB"C"Values"L[4]}
+   compiler = apx_compiler_new();
+   rootElem = apx_dataElement_new(APX_BASE_TYPE_RECORD, 0);
+   apx_dataElement_appendChild(rootElem, apx_dataElement_new(APX_BASE_TYPE_UINT16, "DTCId"));
+   apx_dataElement_appendChild(rootElem, apx_dataElement_new(APX_BASE_TYPE_UINT8, "FTB"));
+   childElem = apx_dataElement_new(APX_BASE_TYPE_UINT32, "Values");
+   apx_dataElement_setArrayLen(childElem, 4);
+   apx_dataElement_appendChild(rootElem, childElem);
+
+   CuAssertIntEquals(tc, APX_NO_ERROR, apx_compiler_begin_packProgram(compiler, program));
+   CuAssertIntEquals(tc, APX_NO_ERROR, apx_compiler_compilePackDataElement(compiler, rootElem));
+   apx_compiler_end(compiler);
+   storedProgram = adt_bytearray_bytes(program);
+   CuAssertIntEquals(tc, APX_NO_ERROR, apx_compiler_lowerToCopyPlan(storedProgram, &plan));
+   CuAssertPtrNotNull(tc, plan);
+   CuAssertUIntEquals(tc, 3, apx_copyPlan_length(plan));
+   CuAssertUIntEquals(tc, UINT16_SIZE+UINT8_SIZE+UINT32_SIZE*4, apx_copyPlan_getDataSize(plan));
+   run = apx_copyPlan_getRun(plan, 0);
+   CuAssertUIntEquals(tc, 0, run->dataOffset);
+   CuAssertUIntEquals(tc, UINT16_SIZE, run->width);
+   CuAssertUIntEquals(tc, 1, run->count);
+   run = apx_copyPlan_getRun(plan, 1);
+   CuAssertUIntEquals(tc, 2, run->dataOffset);
+   CuAssertUIntEquals(tc, UINT8_SIZE, run->width);
+   CuAssertTrue(tc, (run->flags & APX_COPY_RUN_FLAG_MEMCPY) != 0);
+   run = apx_copyPlan_getRun(plan, 2);
+   CuAssertUIntEquals(tc, 3, run->dataOffset);
+   CuAssertUIntEquals(tc, UINT32_SIZE, run->width);
+   CuAssertUIntEquals(tc, 4, run->count);
+   CuAssertPtrEquals(tc, 0, (void*) apx_copyPlan_getRun(plan, 3));
+
+   apx_copyPlan_delete(plan);
+   adt_bytes_delete(storedProgram);
+   apx_compiler_delete(compiler);
+   apx_dataElement_delete(rootElem);
+   adt_bytearray_delete(program);
+}
+
+static void test_apx_compiler_lowerToCopyPlan_dynamicArray(CuTest* tc)
+{
+   apx_compiler_t *compiler;
+   apx_dataElement_t *rootElem;
+   adt_bytearray_t *program = adt_bytearray_new(APX_PROGRAM_GROW_SIZE);
+   adt_bytes_t *storedProgram;
+   apx_copyPlan_t *plan = (apx_copyPlan_t*) 0;
+
+   //DSG: C[10*]
+   compiler = apx_compiler_new();
+   rootElem = apx_dataElement_new(APX_BASE_TYPE_UINT8, 0);
+   apx_dataElement_setArrayLen(rootElem, 10);
+   apx_dataElement_setDynamicArray(rootElem);
+
+   CuAssertIntEquals(tc, APX_NO_ERROR, apx_compiler_begin_unpackProgram(compiler, program));
+   CuAssertIntEquals(tc, APX_NO_ERROR, apx_compiler_compileUnpackDataElement(compiler, rootElem));
+   apx_compiler_end(compiler);
+   storedProgram = adt_bytearray_bytes(program);
+   CuAssertIntEquals(tc, APX_UNSUPPORTED_ERROR, apx_compiler_lowerToCopyPlan(storedProgram, &plan));
+   CuAssertPtrEquals(tc, 0, plan);
+
+   adt_bytes_delete(storedProgram);
+   apx_compiler_delete(compiler);
+   apx_dataElement_delete(rootElem);
+   adt_bytearray_delete(program);
+}
@@ -75,7 +75,7 @@ static void test_apx_connectionBase_alloc(CuTest* tc)
    int i;
    apx_connectionBase_create(&connection, APX_SERVER_MODE, NULL);
    //allocate small objects
-   for(i=1;i<SOA_SMALL_OBJECT_MAX_SIZE;i++)
+   for(i=1;i<=APX_ALLOCATOR_MAX_BLOCK_SIZE;i++)
    {
       char msg[20];
       size = i;
@@ -83,7 +83,6 @@ static void test_apx_connectionBase_alloc(CuTest* tc)
       sprintf(msg, "size=%d", i);
       CuAssertPtrNotNullMsg(tc, msg, ptr);
       apx_connectionBase_free(&connection, ptr, size);
-      apx_allocator_processAll(&connection.allocator);
    }
    //allocate some large objects
    size = 100;
@@ -98,7 +97,6 @@ static void test_apx_connectionBase_alloc(CuTest* tc)
    ptr = apx_connectionBase_alloc(&connection, size);
    CuAssertPtrNotNull(tc, ptr);
    apx_connectionBase_free(&connection, ptr, size);
-   apx_allocator_processAll(&connection.allocator);
 
    apx_connectionBase_destroy(&connection);
 }
@@ -28,6 +28,7 @@
 //////////////////////////////////////////////////////////////////////////////
 #include <stddef.h>
 #include <stdio.h>
+#include <string.h>
 #include <assert.h>
 #include "CuTest.h"
 #include "apx_eventLoop.h"
@@ -46,6 +47,8 @@
 //////////////////////////////////////////////////////////////////////////////
 static void test_apx_eventLoop_connected_event(CuTest* tc);
 static void test_apx_eventLoop_disconnected_event(CuTest* tc);
+static void test_apx_eventLoop_full_queue_does_not_drop_events(CuTest* tc);
+static void mock_countEvents(void *arg, apx_event_t *event);
 
 /*
 static void mockHandlerReset(void);
@@ -57,6 +60,8 @@ static void mock_onDisconnected(void *arg, struct apx_fileManager_tag *fileManag
 //////////////////////////////////////////////////////////////////////////////
 static uint32_t m_onConnectedCount;
 static uint32_t m_onDisconnectedCount;
+static uint32_t m_numEventsProcessed;
+static bool m_isEventOrderCorrect;
 
 //////////////////////////////////////////////////////////////////////////////
 // PUBLIC FUNCTIONS
@@ -67,6 +72,7 @@ CuSuite* testSuite_apx_eventLoop(void)
 
    SUITE_ADD_TEST(suite, test_apx_eventLoop_connected_event);
    SUITE_ADD_TEST(suite, test_apx_eventLoop_disconnected_event);
+   SUITE_ADD_TEST(suite, test_apx_eventLoop_full_queue_does_not_drop_events);
 
    return suite;
 }
@@ -109,6 +115,41 @@ static void test_apx_eventLoop_disconnected_event(CuTest* tc)
    apx_eventLoop_delete(loop);
 }
 
+static void test_apx_eventLoop_full_queue_does_not_drop_events(CuTest* tc)
+{
+   uint32_t i;
+   uint32_t numEvents;
+   apx_eventLoop_t *loop = apx_eventLoop_new();
+   CuAssertPtrNotNull(tc, loop);
+   numEvents = apx_mpscQueue_capacity(&loop->pendingEvents) + 10u;
+   for (i = 0u; i < numEvents; i++)
+   {
+      apx_event_t event;
+      memset(&event, 0, sizeof(event));
+      event.evType = APX_EVENT_NODE_COMPLETE;
+      event.evData4 = i;
+      apx_eventLoop_append(loop, &event);
+   }
+   CuAssertUIntEquals(tc, numEvents, apx_eventLoop_numPendingEvents(loop));
+   m_numEventsProcessed = 0u;
+   m_isEventOrderCorrect = true;
+   apx_eventLoop_runAll(loop, mock_countEvents, (void*) 0);
+   CuAssertUIntEquals(tc, numEvents, m_numEventsProcessed);
+   CuAssertTrue(tc, m_isEventOrderCorrect);
+   CuAssertUIntEquals(tc, 0u, apx_eventLoop_numPendingEvents(loop));
+   apx_eventLoop_delete(loop);
+}
+
+static void mock_countEvents(void *arg, apx_event_t *event)
+{
+   (void) arg;
+   if (event->evData4 != m_numEventsProcessed)
+   {
+      m_isEventOrderCorrect = false;
+   }
+   m_numEventsProcessed++;
+}
+
 /*
 static void mockHandlerReset(void)
 {
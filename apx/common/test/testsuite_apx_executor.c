@@ -0,0 +1,193 @@
+/*****************************************************************************
+* \file      testsuite_apx_executor.c
+* \author    Conny Gustafsson
+* \date      2026-10-18
+* \brief     Unit tests for apx_executor
+*
+* Copyright (c) 2026 Conny Gustafsson
+* Permission is hereby granted, free of charge, to any person obtaining a copy of
+* this software and associated documentation files (the "Software"), to deal in
+* the Software without restriction, including without limitation the rights to
+* use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+* the Software, and to permit persons to whom the Software is furnished to do so,
+* subject to the following conditions:
+
+* The above copyright notice and this permission notice shall be included in all
+* copies or substantial portions of the Software.
+
+* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+* IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+* FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+* COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+* IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+* CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+*
+******************************************************************************/
+//////////////////////////////////////////////////////////////////////////////
+// INCLUDES
+//////////////////////////////////////////////////////////////////////////////
+#include <stddef.h>
+#include <stdio.h>
+#include <string.h>
+#include "CuTest.h"
+#include "apx_executor.h"
+#include "apx_eventLoop.h"
+#ifdef MEM_LEAK_CHECK
+#include "CMemLeak.h"
+#endif
+
+//////////////////////////////////////////////////////////////////////////////
+// PRIVATE CONSTANTS AND DATA TYPES
+//////////////////////////////////////////////////////////////////////////////
+typedef struct taskSpy_tag
+{
+   int32_t numRuns;
+   int32_t numRunsWithMoreWork; //task reports more work until numRuns reaches this value
+} taskSpy_t;
+
+//////////////////////////////////////////////////////////////////////////////
+// PRIVATE FUNCTION PROTOTYPES
+//////////////////////////////////////////////////////////////////////////////
+static void test_apx_executor_create(CuTest* tc);
+static void test_apx_executor_scheduleQueuedTaskOnlyOnce(CuTest* tc);
+static void test_apx_executor_requeueTaskWithMoreWork(CuTest* tc);
+static void test_apx_executor_cancelQueuedTask(CuTest* tc);
+static void test_apx_executor_runEventLoop(CuTest* tc);
+static bool taskSpy_run(void *arg);
+static void eventSpy_handler(void *arg, apx_event_t *event);
+
+//////////////////////////////////////////////////////////////////////////////
+// PRIVATE VARIABLES
+//////////////////////////////////////////////////////////////////////////////
+
+//////////////////////////////////////////////////////////////////////////////
+// PUBLIC FUNCTIONS
+//////////////////////////////////////////////////////////////////////////////
+CuSuite* testSuite_apx_executor(void)
+{
+   CuSuite* suite = CuSuiteNew();
+
+   SUITE_ADD_TEST(suite, test_apx_executor_create);
+   SUITE_ADD_TEST(suite, test_apx_executor_scheduleQueuedTaskOnlyOnce);
+   SUITE_ADD_TEST(suite, test_apx_executor_requeueTaskWithMoreWork);
+   SUITE_ADD_TEST(suite, test_apx_executor_cancelQueuedTask);
+   SUITE_ADD_TEST(suite, test_apx_executor_runEventLoop);
+
+   return suite;
+}
+
+//////////////////////////////////////////////////////////////////////////////
+// PRIVATE FUNCTIONS
+//////////////////////////////////////////////////////////////////////////////
+static void test_apx_executor_create(CuTest* tc)
+{
+   apx_executor_t executor;
+   CuAssertIntEquals(tc, APX_INVALID_ARGUMENT_ERROR, apx_executor_create(&executor, 0u));
+   CuAssertIntEquals(tc, APX_NO_ERROR, apx_executor_create(&executor, 4u));
+   CuAssertUIntEquals(tc, 4u, apx_executor_getNumThreads(&executor));
+   CuAssertTrue(tc, !apx_executor_run(&executor));
+   apx_executor_destroy(&executor);
+}
+
+static void test_apx_executor_scheduleQueuedTaskOnlyOnce(CuTest* tc)
+{
+   apx_executor_t executor;
+   apx_executorTask_t task;
+   taskSpy_t spy = {0, 0};
+   CuAssertIntEquals(tc, APX_NO_ERROR, apx_executor_create(&executor, 1u));
+   apx_executorTask_create(&task, taskSpy_run, &spy);
+   apx_executor_schedule(&executor, &task);
+   apx_executor_schedule(&executor, &task);
+   CuAssertTrue(tc, apx_executor_run(&executor));
+   CuAssertIntEquals(tc, 1, spy.numRuns);
+   CuAssertTrue(tc, !apx_executor_run(&executor));
+   CuAssertUIntEquals(tc, 1u, apx_executor_getNumTaskRuns(&executor));
+   apx_executor_destroy(&executor);
+}
+
+static void test_apx_executor_requeueTaskWithMoreWork(CuTest* tc)
+{
+   apx_executor_t executor;
+   apx_executorTask_t task1;
+   apx_executorTask_t task2;
+   taskSpy_t spy1 = {0, 2};
+   taskSpy_t spy2 = {0, 0};
+   CuAssertIntEquals(tc, APX_NO_ERROR, apx_executor_create(&executor, 1u));
+   apx_executorTask_create(&task1, taskSpy_run, &spy1);
+   apx_executorTask_create(&task2, taskSpy_run, &spy2);
+   apx_executor_schedule(&executor, &task1);
+   apx_executor_schedule(&executor, &task2);
+   //task1 must yield to task2 before running again
+   CuAssertTrue(tc, apx_executor_run(&executor));
+   CuAssertIntEquals(tc, 1, spy1.numRuns);
+   CuAssertTrue(tc, apx_executor_run(&executor));
+   CuAssertIntEquals(tc, 1, spy2.numRuns);
+   CuAssertTrue(tc, apx_executor_run(&executor));
+   CuAssertIntEquals(tc, 2, spy1.numRuns);
+   CuAssertTrue(tc, apx_executor_run(&executor));
+   CuAssertIntEquals(tc, 3, spy1.numRuns);
+   CuAssertTrue(tc, !apx_executor_run(&executor));
+   apx_executor_destroy(&executor);
+}
+
+static void test_apx_executor_cancelQueuedTask(CuTest* tc)
+{
+   apx_executor_t executor;
+   apx_executorTask_t task1;
+   apx_executorTask_t task2;
+   taskSpy_t spy1 = {0, 0};
+   taskSpy_t spy2 = {0, 0};
+   CuAssertIntEquals(tc, APX_NO_ERROR, apx_executor_create(&executor, 1u));
+   apx_executorTask_create(&task1, taskSpy_run, &spy1);
+   apx_executorTask_create(&task2, taskSpy_run, &spy2);
+   apx_executor_schedule(&executor, &task1);
+   apx_executor_schedule(&executor, &task2);
+   apx_executor_cancel(&executor, &task1);
+   apx_executor_schedule(&executor, &task1); //has no effect on a cancelled task
+   CuAssertTrue(tc, apx_executor_run(&executor));
+   CuAssertTrue(tc, !apx_executor_run(&executor));
+   CuAssertIntEquals(tc, 0, spy1.numRuns);
+   CuAssertIntEquals(tc, 1, spy2.numRuns);
+   apx_executor_destroy(&executor);
+}
+
+static void test_apx_executor_runEventLoop(CuTest* tc)
+{
+   apx_executor_t executor;
+   apx_eventLoop_t eventLoop;
+   apx_event_t event;
+   int32_t numEvents = 0;
+   int32_t i;
+   CuAssertIntEquals(tc, APX_NO_ERROR, apx_executor_create(&executor, 1u));
+   CuAssertIntEquals(tc, APX_NO_ERROR, apx_eventLoop_create(&eventLoop));
+   apx_eventLoop_attachExecutor(&eventLoop, &executor, eventSpy_handler, &numEvents);
+   memset(&event, 0, sizeof(event));
+   for (i = 0; i < APX_EXECUTOR_MAX_WORK_PER_TASK + 1; i++)
+   {
+      apx_eventLoop_append(&eventLoop, &event);
+   }
+   CuAssertTrue(tc, apx_executor_run(&executor));
+   CuAssertIntEquals(tc, APX_EXECUTOR_MAX_WORK_PER_TASK, numEvents);
+   CuAssertTrue(tc, apx_executor_run(&executor));
+   CuAssertIntEquals(tc, APX_EXECUTOR_MAX_WORK_PER_TASK + 1, numEvents);
+   CuAssertTrue(tc, !apx_executor_run(&executor));
+   apx_eventLoop_detachExecutor(&eventLoop);
+   apx_eventLoop_append(&eventLoop, &event);
+   CuAssertTrue(tc, !apx_executor_run(&executor));
+   apx_eventLoop_destroy(&eventLoop);
+   apx_executor_destroy(&executor);
+}
+
+static bool taskSpy_run(void *arg)
+{
+   taskSpy_t *spy = (taskSpy_t*) arg;
+   spy->numRuns++;
+   return (spy->numRuns <= spy->numRunsWithMoreWork)? true : false;
+}
+
+static void eventSpy_handler(void *arg, apx_event_t *event)
+{
+   int32_t *numEvents = (int32_t*) arg;
+   (void) event;
+   (*numEvents)++;
+}
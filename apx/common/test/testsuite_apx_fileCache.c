@@ -0,0 +1,191 @@
+/*****************************************************************************
+* \file      testsuite_apx_fileCache.c
+* \author    Conny Gustafsson
+* \date      2026-10-18
+* \brief     Unit tests for apx_fileCache
+*
+* Copyright (c) 2026 Conny Gustafsson
+* Permission is hereby granted, free of charge, to any person obtaining a copy of
+* this software and associated documentation files (the "Software"), to deal in
+* the Software without restriction, including without limitation the rights to
+* use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+* the Software, and to permit persons to whom the Software is furnished to do so,
+* subject to the following conditions:
+
+* The above copyright notice and this permission notice shall be included in all
+* copies or substantial portions of the Software.
+
+* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+* IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+* FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+* COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+* IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+* CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+*
+******************************************************************************/
+//////////////////////////////////////////////////////////////////////////////
+// INCLUDES
+//////////////////////////////////////////////////////////////////////////////
+#include <stddef.h>
+#include <stdio.h>
+#include <string.h>
+#include "CuTest.h"
+#include "apx_fileCache.h"
+#ifdef MEM_LEAK_CHECK
+#include "CMemLeak.h"
+#endif
+
+//////////////////////////////////////////////////////////////////////////////
+// PRIVATE CONSTANTS AND DATA TYPES
+//////////////////////////////////////////////////////////////////////////////
+
+//////////////////////////////////////////////////////////////////////////////
+// PRIVATE FUNCTION PROTOTYPES
+//////////////////////////////////////////////////////////////////////////////
+static void test_apx_fileCache_findReturnsSharedNodeInfo(CuTest* tc);
+static void test_apx_fileCache_fullCacheIgnoresNewEntries(CuTest* tc);
+static void test_apx_fileCache_fullCacheEvictsLeastRecentlyUsed(CuTest* tc);
+
+//////////////////////////////////////////////////////////////////////////////
+// PRIVATE VARIABLES
+//////////////////////////////////////////////////////////////////////////////
+static const char *m_apx_definition1 = "APX/1.2\n"
+      "N\"TestNode1\"\n"
+      "P\"VehicleSpeed\"S:=65535\n"
+      "\n";
+
+static const char *m_apx_definition2 = "APX/1.2\n"
+      "N\"TestNode2\"\n"
+      "R\"VehicleSpeed\"S:=65535\n"
+      "\n";
+
+static const char *m_apx_definition3 = "APX/1.2\n"
+      "N\"TestNode3\"\n"
+      "P\"EngineSpeed\"S:=65535\n"
+      "\n";
+
+//////////////////////////////////////////////////////////////////////////////
+// PUBLIC FUNCTIONS
+//////////////////////////////////////////////////////////////////////////////
+CuSuite* testSuite_apx_fileCache(void)
+{
+   CuSuite* suite = CuSuiteNew();
+
+   SUITE_ADD_TEST(suite, test_apx_fileCache_findReturnsSharedNodeInfo);
+   SUITE_ADD_TEST(suite, test_apx_fileCache_fullCacheIgnoresNewEntries);
+   SUITE_ADD_TEST(suite, test_apx_fileCache_fullCacheEvictsLeastRecentlyUsed);
+
+   return suite;
+}
+
+//////////////////////////////////////////////////////////////////////////////
+// PRIVATE FUNCTIONS
+//////////////////////////////////////////////////////////////////////////////
+static void test_apx_fileCache_findReturnsSharedNodeInfo(CuTest* tc)
+{
+   apx_fileCache_t cache;
+   apx_fileCacheStats_t stats;
+   apx_nodeInfo_t *nodeInfo;
+   apx_nodeInfo_t *cachedNodeInfo;
+   uint8_t digest[APX_SHA256_DIGEST_SIZE];
+
+   apx_fileCache_create(&cache, 4u);
+   nodeInfo = apx_nodeInfo_make_from_cstr(m_apx_definition1, APX_SERVER_MODE);
+   CuAssertPtrNotNull(tc, nodeInfo);
+   apx_sha256_calc( (const uint8_t*) m_apx_definition1, (uint32_t) strlen(m_apx_definition1), &digest[0]);
+   CuAssertPtrEquals(tc, 0, apx_fileCache_findNodeInfo(&cache, &digest[0]));
+   CuAssertIntEquals(tc, APX_NO_ERROR, apx_fileCache_insertNodeInfo(&cache, &digest[0], nodeInfo));
+   CuAssertUIntEquals(tc, 2u, nodeInfo->refCount);
+   apx_nodeInfo_release(nodeInfo); //cache now holds the only reference
+
+   cachedNodeInfo = apx_fileCache_findNodeInfo(&cache, &digest[0]);
+   CuAssertPtrEquals(tc, nodeInfo, cachedNodeInfo);
+   CuAssertUIntEquals(tc, 2u, cachedNodeInfo->refCount);
+   CuAssertStrEquals(tc, "TestNode1", apx_nodeInfo_getName(cachedNodeInfo));
+   apx_nodeInfo_release(cachedNodeInfo);
+
+   apx_fileCache_getStats(&cache, &stats);
+   CuAssertUIntEquals(tc, 1u, stats.numHits);
+   CuAssertUIntEquals(tc, 1u, stats.numMisses);
+   CuAssertUIntEquals(tc, 1u, stats.numEntries);
+   apx_fileCache_destroy(&cache);
+}
+
+static void test_apx_fileCache_fullCacheIgnoresNewEntries(CuTest* tc)
+{
+   apx_fileCache_t cache;
+   apx_fileCacheStats_t stats;
+   apx_nodeInfo_t *nodeInfo1;
+   apx_nodeInfo_t *nodeInfo2;
+   uint8_t digest1[APX_SHA256_DIGEST_SIZE];
+   uint8_t digest2[APX_SHA256_DIGEST_SIZE];
+
+   apx_fileCache_create(&cache, 1u);
+   nodeInfo1 = apx_nodeInfo_make_from_cstr(m_apx_definition1, APX_SERVER_MODE);
+   nodeInfo2 = apx_nodeInfo_make_from_cstr(m_apx_definition2, APX_SERVER_MODE);
+   CuAssertPtrNotNull(tc, nodeInfo1);
+   CuAssertPtrNotNull(tc, nodeInfo2);
+   apx_sha256_calc( (const uint8_t*) m_apx_definition1, (uint32_t) strlen(m_apx_definition1), &digest1[0]);
+   apx_sha256_calc( (const uint8_t*) m_apx_definition2, (uint32_t) strlen(m_apx_definition2), &digest2[0]);
+   CuAssertIntEquals(tc, APX_NO_ERROR, apx_fileCache_insertNodeInfo(&cache, &digest1[0], nodeInfo1));
+   CuAssertIntEquals(tc, APX_NO_ERROR, apx_fileCache_insertNodeInfo(&cache, &digest2[0], nodeInfo2));
+   CuAssertUIntEquals(tc, 2u, nodeInfo1->refCount);
+   CuAssertUIntEquals(tc, 1u, nodeInfo2->refCount);
+   CuAssertPtrEquals(tc, 0, apx_fileCache_findNodeInfo(&cache, &digest2[0]));
+   apx_fileCache_getStats(&cache, &stats);
+   CuAssertUIntEquals(tc, 1u, stats.numEntries);
+
+   apx_nodeInfo_release(nodeInfo1);
+   apx_nodeInfo_release(nodeInfo2);
+   apx_fileCache_destroy(&cache);
+}
+
+static void test_apx_fileCache_fullCacheEvictsLeastRecentlyUsed(CuTest* tc)
+{
+   apx_fileCache_t cache;
+   apx_fileCacheStats_t stats;
+   apx_nodeInfo_t *nodeInfo1;
+   apx_nodeInfo_t *nodeInfo2;
+   apx_nodeInfo_t *nodeInfo3;
+   apx_nodeInfo_t *cachedNodeInfo;
+   uint8_t digest1[APX_SHA256_DIGEST_SIZE];
+   uint8_t digest2[APX_SHA256_DIGEST_SIZE];
+   uint8_t digest3[APX_SHA256_DIGEST_SIZE];
+
+   apx_fileCache_create(&cache, 2u);
+   nodeInfo1 = apx_nodeInfo_make_from_cstr(m_apx_definition1, APX_SERVER_MODE);
+   nodeInfo2 = apx_nodeInfo_make_from_cstr(m_apx_definition2, APX_SERVER_MODE);
+   nodeInfo3 = apx_nodeInfo_make_from_cstr(m_apx_definition3, APX_SERVER_MODE);
+   CuAssertPtrNotNull(tc, nodeInfo1);
+   CuAssertPtrNotNull(tc, nodeInfo2);
+   CuAssertPtrNotNull(tc, nodeInfo3);
+   apx_sha256_calc( (const uint8_t*) m_apx_definition1, (uint32_t) strlen(m_apx_definition1), &digest1[0]);
+   apx_sha256_calc( (const uint8_t*) m_apx_definition2, (uint32_t) strlen(m_apx_definition2), &digest2[0]);
+   apx_sha256_calc( (const uint8_t*) m_apx_definition3, (uint32_t) strlen(m_apx_definition3), &digest3[0]);
+   CuAssertIntEquals(tc, APX_NO_ERROR, apx_fileCache_insertNodeInfo(&cache, &digest1[0], nodeInfo1));
+   CuAssertIntEquals(tc, APX_NO_ERROR, apx_fileCache_insertNodeInfo(&cache, &digest2[0], nodeInfo2));
+   apx_nodeInfo_release(nodeInfo1);
+   apx_nodeInfo_release(nodeInfo2);
+
+   //Touch nodeInfo1, making nodeInfo2 the least recently used entry
+   cachedNodeInfo = apx_fileCache_findNodeInfo(&cache, &digest1[0]);
+   CuAssertPtrEquals(tc, nodeInfo1, cachedNodeInfo);
+   apx_nodeInfo_release(cachedNodeInfo);
+
+   CuAssertIntEquals(tc, APX_NO_ERROR, apx_fileCache_insertNodeInfo(&cache, &digest3[0], nodeInfo3));
+   CuAssertUIntEquals(tc, 2u, nodeInfo3->refCount);
+   CuAssertPtrEquals(tc, 0, apx_fileCache_findNodeInfo(&cache, &digest2[0]));
+   cachedNodeInfo = apx_fileCache_findNodeInfo(&cache, &digest1[0]);
+   CuAssertPtrEquals(tc, nodeInfo1, cachedNodeInfo);
+   apx_nodeInfo_release(cachedNodeInfo);
+   cachedNodeInfo = apx_fileCache_findNodeInfo(&cache, &digest3[0]);
+   CuAssertPtrEquals(tc, nodeInfo3, cachedNodeInfo);
+   apx_nodeInfo_release(cachedNodeInfo);
+
+   apx_fileCache_getStats(&cache, &stats);
+   CuAssertUIntEquals(tc, 2u, stats.numEntries);
+   CuAssertUIntEquals(tc, 1u, stats.numEvictions);
+
+   apx_nodeInfo_release(nodeInfo3);
+   apx_fileCache_destroy(&cache);
+}
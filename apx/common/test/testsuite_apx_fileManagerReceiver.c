@@ -33,6 +33,7 @@
 #include <string.h>
 #include "CuTest.h"
 #include "apx_fileManagerReceiver.h"
+#include "apx_lz.h"
 #ifdef MEM_LEAK_CHECK
 #include "CMemLeak.h"
 #endif
@@ -57,6 +58,9 @@ static void test_apx_fileManagerReceiver_nonFragmentedWrite(CuTest* tc);
 static void test_apx_fileManagerReceiver_128fragmentedWrites(CuTest* tc);
 static void test_apx_fileManagerReceiver_3fragmentedWrites(CuTest* tc);
 static void test_apx_fileManagerReceiver_fragmentedWriteAtWrongAddress(CuTest* tc);
+static void test_apx_fileManagerReceiver_interleavedWrite(CuTest* tc);
+static void test_apx_fileManagerReceiver_compressedFragmentedWrites(CuTest* tc);
+static void test_apx_fileManagerReceiver_truncatedCompressedWrite(CuTest* tc);
 
 
 
@@ -75,6 +79,9 @@ CuSuite* testSuite_apx_fileManagerReceiver(void)
    SUITE_ADD_TEST(suite, test_apx_fileManagerReceiver_128fragmentedWrites);
    SUITE_ADD_TEST(suite, test_apx_fileManagerReceiver_3fragmentedWrites);
    SUITE_ADD_TEST(suite, test_apx_fileManagerReceiver_fragmentedWriteAtWrongAddress);
+   SUITE_ADD_TEST(suite, test_apx_fileManagerReceiver_interleavedWrite);
+   SUITE_ADD_TEST(suite, test_apx_fileManagerReceiver_compressedFragmentedWrites);
+   SUITE_ADD_TEST(suite, test_apx_fileManagerReceiver_truncatedCompressedWrite);
 
    return suite;
 }
@@ -330,3 +337,117 @@ static void test_apx_fileManagerReceiver_fragmentedWriteAtWrongAddress(CuTest* t
    apx_fileManagerReceiver_destroy(&recvr);
 
 }
+
+static void test_apx_fileManagerReceiver_interleavedWrite(CuTest* tc)
+{
+   apx_fileManagerReceiver_t recvr;
+   uint8_t data[MEDIUM_DATA_SIZE];
+   int32_t i;
+   uint32_t startAddress = 0x10000;
+   const uint32_t writeSize = 32;
+   apx_fileManagerReception_t reception;
+
+   //prepare
+   apx_fileManagerReceiver_create(&recvr);
+   CuAssertIntEquals(tc, APX_NO_ERROR, apx_fileManagerReceiver_reserve(&recvr, MEDIUM_DATA_SIZE));
+   for (i=0; i<MEDIUM_DATA_SIZE; i++)
+   {
+      data[i] = i;
+   }
+   CuAssertTrue(tc, !apx_fileManagerReceiver_isInterleavedWrite(&recvr, 0x100, false));
+
+   //act
+   CuAssertIntEquals(tc, APX_NO_ERROR, apx_fileManagerReceiver_write(&recvr, startAddress, &data[0], writeSize, true));
+   //complete writes at other addresses are interleaved, the continuation of the ongoing write is not
+   CuAssertTrue(tc, apx_fileManagerReceiver_isInterleavedWrite(&recvr, 0x100, false));
+   CuAssertTrue(tc, apx_fileManagerReceiver_isInterleavedWrite(&recvr, RMF_CMD_START_ADDR, false));
+   CuAssertTrue(tc, !apx_fileManagerReceiver_isInterleavedWrite(&recvr, startAddress + writeSize, false));
+   CuAssertTrue(tc, !apx_fileManagerReceiver_isInterleavedWrite(&recvr, startAddress + writeSize, true));
+   CuAssertTrue(tc, !apx_fileManagerReceiver_isInterleavedWrite(&recvr, 0x100, true));
+   CuAssertIntEquals(tc, APX_NO_ERROR, apx_fileManagerReceiver_write(&recvr, startAddress + writeSize, &data[writeSize], writeSize, false));
+   CuAssertIntEquals(tc, APX_NO_ERROR, apx_fileManagerReceiver_checkComplete(&recvr, &reception));
+   CuAssertUIntEquals(tc, startAddress, reception.startAddress);
+   CuAssertUIntEquals(tc, writeSize*2, reception.msgSize);
+   CuAssertTrue(tc, !apx_fileManagerReceiver_isInterleavedWrite(&recvr, 0x100, false));
+
+   //clean
+   apx_fileManagerReceiver_destroy(&recvr);
+}
+
+static void test_apx_fileManagerReceiver_compressedFragmentedWrites(CuTest* tc)
+{
+   apx_fileManagerReceiver_t recvr;
+   uint8_t data[LARGE_DATA_SIZE];
+   uint8_t compressed[LARGE_DATA_SIZE];
+   apx_size_t compressedSize = 0u;
+   int32_t i;
+   uint32_t startAddress = 0x10000;
+   uint32_t writeOffset = 0u;
+   const uint32_t writeSize = 7u;
+   apx_fileManagerReception_t reception;
+
+   //prepare
+   apx_fileManagerReceiver_create(&recvr);
+   for (i=0; i<LARGE_DATA_SIZE; i++)
+   {
+      data[i] = (uint8_t) (i % 10);
+   }
+   CuAssertIntEquals(tc, APX_NO_ERROR, apx_lz_compress(data, LARGE_DATA_SIZE, compressed, sizeof(compressed), &compressedSize));
+   CuAssertTrue(tc, compressedSize > (writeSize * 2));
+
+   //act
+   CuAssertIntEquals(tc, APX_NO_ERROR, apx_fileManagerReceiver_startDecompression(&recvr, LARGE_DATA_SIZE));
+   CuAssertUIntEquals(tc, LARGE_DATA_SIZE, recvr.receiveBufSize);
+   while (writeOffset + writeSize < compressedSize)
+   {
+      CuAssertIntEquals(tc, APX_NO_ERROR, apx_fileManagerReceiver_write(&recvr, startAddress + writeOffset, &compressed[writeOffset], writeSize, true));
+      writeOffset += writeSize;
+      //Addresses of the ongoing write refer to the compressed data
+      CuAssertTrue(tc, !apx_fileManagerReceiver_isInterleavedWrite(&recvr, startAddress + writeOffset, false));
+      CuAssertTrue(tc, apx_fileManagerReceiver_isInterleavedWrite(&recvr, startAddress + recvr.receiveBufPos, false));
+      CuAssertIntEquals(tc, APX_DATA_NOT_COMPLETE_ERROR, apx_fileManagerReceiver_checkComplete(&recvr, &reception));
+   }
+   CuAssertIntEquals(tc, APX_NO_ERROR, apx_fileManagerReceiver_write(&recvr, startAddress + writeOffset, &compressed[writeOffset], compressedSize - writeOffset, false));
+   CuAssertIntEquals(tc, APX_NO_ERROR, apx_fileManagerReceiver_checkComplete(&recvr, &reception));
+
+   //verify
+   CuAssertUIntEquals(tc, startAddress, reception.startAddress);
+   CuAssertUIntEquals(tc, LARGE_DATA_SIZE, reception.msgSize);
+   CuAssertIntEquals(tc, 0, memcmp(reception.msgBuf, data, LARGE_DATA_SIZE));
+   CuAssertTrue(tc, !recvr.isCompressedWrite);
+
+   //Next write is not compressed
+   CuAssertIntEquals(tc, APX_NO_ERROR, apx_fileManagerReceiver_write(&recvr, startAddress, &data[0], SMALL_DATA_SIZE, false));
+   CuAssertIntEquals(tc, APX_NO_ERROR, apx_fileManagerReceiver_checkComplete(&recvr, &reception));
+   CuAssertUIntEquals(tc, SMALL_DATA_SIZE, reception.msgSize);
+
+   //clean
+   apx_fileManagerReceiver_destroy(&recvr);
+}
+
+static void test_apx_fileManagerReceiver_truncatedCompressedWrite(CuTest* tc)
+{
+   apx_fileManagerReceiver_t recvr;
+   uint8_t data[MEDIUM_DATA_SIZE];
+   uint8_t compressed[LARGE_DATA_SIZE];
+   apx_size_t compressedSize = 0u;
+   apx_fileManagerReception_t reception;
+   uint32_t startAddress = 0x10000;
+
+   //prepare
+   apx_fileManagerReceiver_create(&recvr);
+   memset(data, 0x55, sizeof(data));
+   CuAssertIntEquals(tc, APX_NO_ERROR, apx_lz_compress(data, MEDIUM_DATA_SIZE, compressed, sizeof(compressed), &compressedSize));
+
+   //act
+   CuAssertIntEquals(tc, APX_NO_ERROR, apx_fileManagerReceiver_startDecompression(&recvr, MEDIUM_DATA_SIZE));
+   CuAssertIntEquals(tc, APX_DECOMPRESSION_ERROR, apx_fileManagerReceiver_write(&recvr, startAddress, &compressed[0], compressedSize - 1u, false));
+
+   //verify that the receiver is ready for a new write
+   CuAssertUIntEquals(tc, RMF_INVALID_ADDRESS, recvr.startAddress);
+   CuAssertTrue(tc, !recvr.isCompressedWrite);
+   CuAssertIntEquals(tc, APX_INVALID_ADDRESS_ERROR, apx_fileManagerReceiver_checkComplete(&recvr, &reception));
+
+   //clean
+   apx_fileManagerReceiver_destroy(&recvr);
+}
@@ -11,8 +11,10 @@
 #include "apx_fileManagerWorker.h"
 #include "apx_fileMap.h"
 #include "rmf.h"
+#include "numheader.h"
 #include "apx_file.h"
 #include "adt_bytearray.h"
+#include "apx_transmitHandlerSpy.h"
 #ifdef MEM_LEAK_CHECK
 #include "CMemLeak.h"
 #endif
@@ -27,11 +29,31 @@ typedef struct fileManagerRemoteSpy_tag
    void *arg;
    apx_file_t file;
 }fileManagerRemoteSpy_t;
+
+typedef struct conflationSpy_tag
+{
+   uint8_t data[16];
+   apx_byteRangeSet_t dirtyRanges;
+   int32_t numTakeCalls;
+   int32_t numMarkDirtyCalls;
+}conflationSpy_t;
 //////////////////////////////////////////////////////////////////////////////
 // LOCAL FUNCTION PROTOTYPES
 //////////////////////////////////////////////////////////////////////////////
 
 static void test_apx_fileManagerWorker_create(CuTest* tc);
+static void test_apx_fileManagerWorker_batchDynamicData(CuTest* tc);
+static void test_apx_fileManagerWorker_sendDynamicDataWithoutBatchSupport(CuTest* tc);
+static void test_apx_fileManagerWorker_sendSharedPayload(CuTest* tc);
+static void test_apx_fileManagerWorker_sendConflatedData(CuTest* tc);
+static void test_apx_fileManagerWorker_unsentConflatedRangesAreMarkedDirty(CuTest* tc);
+static void test_apx_fileManagerWorker_fragmentLargeWrite(CuTest* tc);
+static void test_apx_fileManagerWorker_largeWriteIsNotFragmentedByDefault(CuTest* tc);
+static int32_t unpackTransmission(adt_bytearray_t *transmitted, rmf_msg_t *msgs, int32_t maxNumMsgs);
+static apx_error_t conflationSpy_takeDirtyRanges(void *arg, apx_file_t *file, apx_byteRangeSet_t *ranges);
+static apx_error_t conflationSpy_readData(void *arg, apx_file_t *file, uint32_t offset, uint8_t *dest, uint32_t len);
+static apx_error_t conflationSpy_markDirty(void *arg, apx_file_t *file, uint32_t offset, uint32_t len);
+static uint8_t* limitedSendBuffer_getSendBuffer(void *arg, int32_t msgLen);
 //static void test_apx_fileManagerWorker_processFileInfo(CuTest* tc);
 //static void test_apx_fileManagerWorker_processFileOpenRequest(CuTest* tc);
 //static void test_apx_fileManagerWorker_serializeFileInfo(CuTest *tc);
@@ -39,7 +61,7 @@ static void test_apx_fileManagerWorker_create(CuTest* tc);
 //////////////////////////////////////////////////////////////////////////////
 // LOCAL VARIABLES
 //////////////////////////////////////////////////////////////////////////////
-
+static int32_t m_numSendBuffersLeft = -1;
 
 //////////////////////////////////////////////////////////////////////////////
 // GLOBAL FUNCTIONS
@@ -51,6 +73,13 @@ CuSuite* testSuite_apx_fileManagerWorker(void)
    CuSuite* suite = CuSuiteNew();
 
    SUITE_ADD_TEST(suite, test_apx_fileManagerWorker_create);
+   SUITE_ADD_TEST(suite, test_apx_fileManagerWorker_batchDynamicData);
+   SUITE_ADD_TEST(suite, test_apx_fileManagerWorker_sendDynamicDataWithoutBatchSupport);
+   SUITE_ADD_TEST(suite, test_apx_fileManagerWorker_sendSharedPayload);
+   SUITE_ADD_TEST(suite, test_apx_fileManagerWorker_sendConflatedData);
+   SUITE_ADD_TEST(suite, test_apx_fileManagerWorker_unsentConflatedRangesAreMarkedDirty);
+   SUITE_ADD_TEST(suite, test_apx_fileManagerWorker_fragmentLargeWrite);
+   SUITE_ADD_TEST(suite, test_apx_fileManagerWorker_largeWriteIsNotFragmentedByDefault);
    //SUITE_ADD_TEST(suite, test_apx_fileManagerWorker_processFileInfo);
    //SUITE_ADD_TEST(suite, test_apx_fileManagerWorker_processFileOpenRequest);
 //   SUITE_ADD_TEST(suite, test_apx_fileManagerWorker_serializeFileInfo);
@@ -72,6 +101,597 @@ static void test_apx_fileManagerWorker_create(CuTest* tc)
    apx_fileManagerShared_destroy(&shared);
 }
 
+static void test_apx_fileManagerWorker_batchDynamicData(CuTest* tc)
+{
+   apx_fileManagerWorker_t worker;
+   apx_fileManagerShared_t shared;
+   apx_transmitHandlerSpy_t spy;
+   apx_transmitHandler_t handler;
+   apx_fileManagerWorkerStats_t stats;
+   adt_bytearray_t *transmitted;
+   const uint8_t *data;
+   uint8_t data1[3] = {0x11, 0x12, 0x13};
+   uint8_t data2[1] = {0x21};
+   uint8_t data3[2] = {0x31, 0x32};
+   uint8_t expected[32];
+   int32_t pos = 0;
+
+   apx_transmitHandlerSpy_create(&spy);
+   memset(&handler, 0, sizeof(handler));
+   handler.arg = &spy;
+   handler.getSendBuffer = apx_transmitHandlerSpy_getSendBuffer;
+   handler.send = apx_transmitHandlerSpy_send;
+   handler.sendFramed = apx_transmitHandlerSpy_sendFramed;
+   CuAssertIntEquals(tc, APX_NO_ERROR, apx_fileManagerShared_create(&shared));
+   CuAssertIntEquals(tc, APX_NO_ERROR, apx_fileManagerWorker_create(&worker, &shared, APX_CLIENT_MODE));
+   apx_fileManagerWorker_setNumHeaderSize(&worker, 32u);
+   apx_fileManagerWorker_setTransmitHandler(&worker, &handler);
+   apx_fileManagerShared_connect(&shared);
+
+   CuAssertIntEquals(tc, APX_NO_ERROR, apx_fileManagerWorker_sendDynamicData(&worker, 0u, sizeof(data1), &data1[0]));
+   CuAssertIntEquals(tc, APX_NO_ERROR, apx_fileManagerWorker_sendDynamicData(&worker, 3u, sizeof(data2), &data2[0]));
+   CuAssertIntEquals(tc, APX_NO_ERROR, apx_fileManagerWorker_sendDynamicData(&worker, 8u, sizeof(data3), &data3[0]));
+   CuAssertIntEquals(tc, 3, apx_fileManagerWorker_numPendingMessages(&worker));
+   CuAssertTrue(tc, apx_fileManagerWorker_run(&worker));
+   CuAssertIntEquals(tc, 0, apx_fileManagerWorker_numPendingMessages(&worker));
+   CuAssertIntEquals(tc, 1, apx_transmitHandlerSpy_length(&spy));
+
+   expected[pos++] = (uint8_t) (RMF_LOW_ADDRESS_SIZE + sizeof(data1));
+   pos += rmf_packHeader(&expected[pos], sizeof(expected)-pos, 0u, false);
+   memcpy(&expected[pos], &data1[0], sizeof(data1)); pos += sizeof(data1);
+   expected[pos++] = (uint8_t) (RMF_LOW_ADDRESS_SIZE + sizeof(data2));
+   pos += rmf_packHeader(&expected[pos], sizeof(expected)-pos, 3u, false);
+   memcpy(&expected[pos], &data2[0], sizeof(data2)); pos += sizeof(data2);
+   expected[pos++] = (uint8_t) (RMF_LOW_ADDRESS_SIZE + sizeof(data3));
+   pos += rmf_packHeader(&expected[pos], sizeof(expected)-pos, 8u, false);
+   memcpy(&expected[pos], &data3[0], sizeof(data3)); pos += sizeof(data3);
+
+   transmitted = apx_transmitHandlerSpy_next(&spy);
+   CuAssertPtrNotNull(tc, transmitted);
+   CuAssertIntEquals(tc, pos, (int) adt_bytearray_length(transmitted));
+   data = adt_bytearray_data(transmitted);
+   CuAssertIntEquals(tc, 0, memcmp(&expected[0], data, pos));
+   adt_bytearray_delete(transmitted);
+
+   apx_fileManagerWorker_getStats(&worker, &stats);
+   CuAssertUIntEquals(tc, 3u, stats.numMessagesSent);
+   CuAssertUIntEquals(tc, 1u, stats.numTransmitCalls);
+   CuAssertUIntEquals(tc, pos, (uint32_t) stats.numBytesSent);
+
+   apx_fileManagerWorker_destroy(&worker);
+   apx_fileManagerShared_destroy(&shared);
+   apx_transmitHandlerSpy_destroy(&spy);
+}
+
+static void test_apx_fileManagerWorker_sendDynamicDataWithoutBatchSupport(CuTest* tc)
+{
+   apx_fileManagerWorker_t worker;
+   apx_fileManagerShared_t shared;
+   apx_transmitHandlerSpy_t spy;
+   apx_transmitHandler_t handler;
+   apx_fileManagerWorkerStats_t stats;
+   uint8_t data1[3] = {0x11, 0x12, 0x13};
+   uint8_t data2[1] = {0x21};
+   int32_t i;
+
+   apx_transmitHandlerSpy_create(&spy);
+   memset(&handler, 0, sizeof(handler));
+   handler.arg = &spy;
+   handler.getSendBuffer = apx_transmitHandlerSpy_getSendBuffer;
+   handler.send = apx_transmitHandlerSpy_send;
+   CuAssertIntEquals(tc, APX_NO_ERROR, apx_fileManagerShared_create(&shared));
+   CuAssertIntEquals(tc, APX_NO_ERROR, apx_fileManagerWorker_create(&worker, &shared, APX_CLIENT_MODE));
+   apx_fileManagerWorker_setNumHeaderSize(&worker, 32u);
+   apx_fileManagerWorker_setTransmitHandler(&worker, &handler);
+   apx_fileManagerShared_connect(&shared);
+
+   CuAssertIntEquals(tc, APX_NO_ERROR, apx_fileManagerWorker_sendDynamicData(&worker, 0u, sizeof(data1), &data1[0]));
+   CuAssertIntEquals(tc, APX_NO_ERROR, apx_fileManagerWorker_sendDynamicData(&worker, 3u, sizeof(data2), &data2[0]));
+   CuAssertTrue(tc, apx_fileManagerWorker_run(&worker));
+   CuAssertIntEquals(tc, 1, apx_transmitHandlerSpy_length(&spy));
+   CuAssertTrue(tc, apx_fileManagerWorker_run(&worker));
+   CuAssertIntEquals(tc, 2, apx_transmitHandlerSpy_length(&spy));
+   for (i = 0; i < 2; i++)
+   {
+      adt_bytearray_t *transmitted = apx_transmitHandlerSpy_next(&spy);
+      CuAssertPtrNotNull(tc, transmitted);
+      adt_bytearray_delete(transmitted);
+   }
+   apx_fileManagerWorker_getStats(&worker, &stats);
+   CuAssertUIntEquals(tc, 2u, stats.numMessagesSent);
+   CuAssertUIntEquals(tc, 2u, stats.numTransmitCalls);
+
+   apx_fileManagerWorker_destroy(&worker);
+   apx_fileManagerShared_destroy(&shared);
+   apx_transmitHandlerSpy_destroy(&spy);
+}
+
+static void test_apx_fileManagerWorker_sendSharedPayload(CuTest* tc)
+{
+   apx_fileManagerWorker_t worker;
+   apx_fileManagerShared_t shared;
+   apx_transmitHandlerSpy_t spy;
+   apx_transmitHandler_t handler;
+   apx_fileManagerWorkerStats_t stats;
+   apx_payload_t *payload;
+   adt_bytearray_t *transmitted;
+   const uint8_t *data;
+   uint8_t *payloadData;
+   uint8_t header[8];
+   int32_t headerLen;
+   uint32_t i;
+   const uint32_t largeLen = (uint32_t) APX_WORKER_GATHER_THRESHOLD;
+
+   payloadData = (uint8_t*) malloc(largeLen + 4u);
+   CuAssertPtrNotNull(tc, payloadData);
+   for (i = 0u; i < largeLen + 4u; i++)
+   {
+      payloadData[i] = (uint8_t) i;
+   }
+   payload = apx_payload_new(payloadData, largeLen + 4u);
+   CuAssertPtrNotNull(tc, payload);
+
+   apx_transmitHandlerSpy_create(&spy);
+   memset(&handler, 0, sizeof(handler));
+   handler.arg = &spy;
+   handler.getSendBuffer = apx_transmitHandlerSpy_getSendBuffer;
+   handler.send = apx_transmitHandlerSpy_send;
+   handler.sendFramed = apx_transmitHandlerSpy_sendFramed;
+   handler.sendGather = apx_transmitHandlerSpy_sendGather;
+   CuAssertIntEquals(tc, APX_NO_ERROR, apx_fileManagerShared_create(&shared));
+   CuAssertIntEquals(tc, APX_NO_ERROR, apx_fileManagerWorker_create(&worker, &shared, APX_SERVER_MODE));
+   apx_fileManagerWorker_setNumHeaderSize(&worker, 32u);
+   apx_fileManagerWorker_setTransmitHandler(&worker, &handler);
+   apx_fileManagerShared_connect(&shared);
+
+   //small write is copied into the batch, large write is transmitted from the payload itself in the same call
+   CuAssertIntEquals(tc, APX_NO_ERROR, apx_fileManagerWorker_sendPayload(&worker, 0u, payload, 1u, 2u));
+   CuAssertIntEquals(tc, APX_NO_ERROR, apx_fileManagerWorker_sendPayload(&worker, 4u, payload, 4u, largeLen));
+   CuAssertUIntEquals(tc, 3u, apx_payload_getRefCount(payload));
+   CuAssertIntEquals(tc, APX_INVALID_ARGUMENT_ERROR, apx_fileManagerWorker_sendPayload(&worker, 4u, payload, 5u, largeLen));
+   CuAssertUIntEquals(tc, 3u, apx_payload_getRefCount(payload));
+   CuAssertTrue(tc, apx_fileManagerWorker_run(&worker));
+   CuAssertUIntEquals(tc, 1u, apx_payload_getRefCount(payload));
+   CuAssertIntEquals(tc, 1, apx_transmitHandlerSpy_length(&spy));
+
+   transmitted = apx_transmitHandlerSpy_next(&spy);
+   CuAssertPtrNotNull(tc, transmitted);
+   data = adt_bytearray_data(transmitted);
+   headerLen = numheader_encode32(&header[0], (int32_t) sizeof(header), RMF_LOW_ADDRESS_SIZE + largeLen);
+   headerLen += rmf_packHeader(&header[headerLen], (int32_t) sizeof(header) - headerLen, 4u, false);
+   CuAssertIntEquals(tc, 1 + RMF_LOW_ADDRESS_SIZE + 2 + headerLen + (int) largeLen, (int) adt_bytearray_length(transmitted));
+   CuAssertUIntEquals(tc, RMF_LOW_ADDRESS_SIZE + 2, data[0]);
+   CuAssertUIntEquals(tc, 1u, data[1 + RMF_LOW_ADDRESS_SIZE]);
+   CuAssertUIntEquals(tc, 2u, data[2 + RMF_LOW_ADDRESS_SIZE]);
+   data += 1 + RMF_LOW_ADDRESS_SIZE + 2;
+   CuAssertIntEquals(tc, 0, memcmp(&header[0], data, headerLen));
+   CuAssertIntEquals(tc, 0, memcmp(&payloadData[4], &data[headerLen], largeLen));
+   adt_bytearray_delete(transmitted);
+
+   apx_fileManagerWorker_getStats(&worker, &stats);
+   CuAssertUIntEquals(tc, 2u, stats.numMessagesSent);
+   CuAssertUIntEquals(tc, 1u, stats.numTransmitCalls);
+   CuAssertUIntEquals(tc, 1u, stats.numGatherCalls);
+
+   //Messages still in the queue release their payload reference when the worker is destroyed
+   CuAssertIntEquals(tc, APX_NO_ERROR, apx_fileManagerWorker_sendPayload(&worker, 0u, payload, 0u, 2u));
+   CuAssertUIntEquals(tc, 2u, apx_payload_getRefCount(payload));
+   apx_fileManagerWorker_destroy(&worker);
+   CuAssertUIntEquals(tc, 1u, apx_payload_getRefCount(payload));
+   apx_payload_release(payload);
+   apx_fileManagerShared_destroy(&shared);
+   apx_transmitHandlerSpy_destroy(&spy);
+   free(payloadData);
+}
+
+static void test_apx_fileManagerWorker_sendConflatedData(CuTest* tc)
+{
+   apx_fileManagerWorker_t worker;
+   apx_fileManagerShared_t shared;
+   apx_transmitHandlerSpy_t spy;
+   apx_transmitHandler_t handler;
+   apx_fileConflationHandler_t conflationHandler;
+   conflationSpy_t conflationSpy;
+   apx_fileInfo_t info;
+   apx_file_t *file;
+   adt_bytearray_t *transmitted;
+   const uint8_t *data;
+   uint8_t expected[32];
+   uint32_t address;
+   int32_t pos = 0;
+
+   memset(&conflationSpy.data[0], 0, sizeof(conflationSpy.data));
+   apx_byteRangeSet_create(&conflationSpy.dirtyRanges, 0u);
+   conflationSpy.numTakeCalls = 0;
+   conflationSpy.numMarkDirtyCalls = 0;
+   conflationHandler.arg = &conflationSpy;
+   conflationHandler.takeDirtyRanges = conflationSpy_takeDirtyRanges;
+   conflationHandler.readData = conflationSpy_readData;
+   conflationHandler.markDirty = conflationSpy_markDirty;
+   apx_transmitHandlerSpy_create(&spy);
+   memset(&handler, 0, sizeof(handler));
+   handler.arg = &spy;
+   handler.getSendBuffer = apx_transmitHandlerSpy_getSendBuffer;
+   handler.send = apx_transmitHandlerSpy_send;
+   handler.sendFramed = apx_transmitHandlerSpy_sendFramed;
+   CuAssertIntEquals(tc, APX_NO_ERROR, apx_fileManagerShared_create(&shared));
+   CuAssertIntEquals(tc, APX_NO_ERROR, apx_fileManagerWorker_create(&worker, &shared, APX_SERVER_MODE));
+   apx_fileManagerWorker_setNumHeaderSize(&worker, 32u);
+   apx_fileManagerWorker_setTransmitHandler(&worker, &handler);
+   apx_fileInfo_create(&info, RMF_INVALID_ADDRESS, (uint32_t) sizeof(conflationSpy.data), "test.in", RMF_FILE_TYPE_FIXED, RMF_DIGEST_TYPE_NONE, NULL);
+   file = apx_fileManagerShared_createLocalFile(&shared, &info);
+   CuAssertPtrNotNull(tc, file);
+   address = apx_file_getStartAddress(file);
+   apx_fileManagerShared_connect(&shared);
+
+   //Three writes while the worker is busy, the first value of the range at offset 0 is overwritten before being sent
+   conflationSpy.data[0] = 0x11;
+   conflationSpy.data[1] = 0x12;
+   CuAssertIntEquals(tc, APX_NO_ERROR, apx_byteRangeSet_insert(&conflationSpy.dirtyRanges, 0u, 2u));
+   CuAssertIntEquals(tc, APX_NO_ERROR, apx_fileManagerWorker_sendConflatedData(&worker, address, &conflationHandler));
+   conflationSpy.data[8] = 0x31;
+   CuAssertIntEquals(tc, APX_NO_ERROR, apx_byteRangeSet_insert(&conflationSpy.dirtyRanges, 8u, 1u));
+   conflationSpy.data[1] = 0x22;
+   CuAssertIntEquals(tc, APX_NO_ERROR, apx_byteRangeSet_insert(&conflationSpy.dirtyRanges, 0u, 2u));
+   CuAssertIntEquals(tc, 1, apx_fileManagerWorker_numPendingMessages(&worker));
+   CuAssertTrue(tc, apx_fileManagerWorker_run(&worker));
+   CuAssertIntEquals(tc, 1, conflationSpy.numTakeCalls);
+   CuAssertIntEquals(tc, 1, apx_transmitHandlerSpy_length(&spy));
+
+   expected[pos++] = (uint8_t) (RMF_LOW_ADDRESS_SIZE + 2);
+   pos += rmf_packHeader(&expected[pos], sizeof(expected)-pos, address, false);
+   expected[pos++] = 0x11;
+   expected[pos++] = 0x22;
+   expected[pos++] = (uint8_t) (RMF_LOW_ADDRESS_SIZE + 1);
+   pos += rmf_packHeader(&expected[pos], sizeof(expected)-pos, address + 8u, false);
+   expected[pos++] = 0x31;
+   transmitted = apx_transmitHandlerSpy_next(&spy);
+   CuAssertPtrNotNull(tc, transmitted);
+   CuAssertIntEquals(tc, pos, (int) adt_bytearray_length(transmitted));
+   data = adt_bytearray_data(transmitted);
+   CuAssertIntEquals(tc, 0, memcmp(&expected[0], data, pos));
+   adt_bytearray_delete(transmitted);
+
+   //Nothing is sent when all dirty ranges were already taken
+   CuAssertIntEquals(tc, APX_NO_ERROR, apx_fileManagerWorker_sendConflatedData(&worker, address, &conflationHandler));
+   CuAssertTrue(tc, apx_fileManagerWorker_run(&worker));
+   CuAssertIntEquals(tc, 2, conflationSpy.numTakeCalls);
+   CuAssertIntEquals(tc, 0, apx_transmitHandlerSpy_length(&spy));
+
+   apx_fileManagerWorker_destroy(&worker);
+   apx_fileManagerShared_destroy(&shared);
+   apx_transmitHandlerSpy_destroy(&spy);
+   apx_fileInfo_destroy(&info);
+   apx_byteRangeSet_destroy(&conflationSpy.dirtyRanges);
+}
+
+/**
+ * The transmit handler runs out of buffers after the first of three dirty ranges.
+ * The two ranges not sent must be given back to the file owner.
+ */
+static void test_apx_fileManagerWorker_unsentConflatedRangesAreMarkedDirty(CuTest* tc)
+{
+   apx_fileManagerWorker_t worker;
+   apx_fileManagerShared_t shared;
+   apx_transmitHandlerSpy_t spy;
+   apx_transmitHandler_t handler;
+   apx_fileConflationHandler_t conflationHandler;
+   conflationSpy_t conflationSpy;
+   apx_fileInfo_t info;
+   apx_file_t *file;
+   adt_bytearray_t *transmitted;
+   const apx_byteRange_t *range;
+   uint32_t address;
+
+   memset(&conflationSpy.data[0], 0, sizeof(conflationSpy.data));
+   apx_byteRangeSet_create(&conflationSpy.dirtyRanges, 0u);
+   conflationSpy.numTakeCalls = 0;
+   conflationSpy.numMarkDirtyCalls = 0;
+   conflationHandler.arg = &conflationSpy;
+   conflationHandler.takeDirtyRanges = conflationSpy_takeDirtyRanges;
+   conflationHandler.readData = conflationSpy_readData;
+   conflationHandler.markDirty = conflationSpy_markDirty;
+   apx_transmitHandlerSpy_create(&spy);
+   memset(&handler, 0, sizeof(handler));
+   handler.arg = &spy;
+   handler.getSendBuffer = limitedSendBuffer_getSendBuffer;
+   handler.send = apx_transmitHandlerSpy_send;
+   CuAssertIntEquals(tc, APX_NO_ERROR, apx_fileManagerShared_create(&shared));
+   CuAssertIntEquals(tc, APX_NO_ERROR, apx_fileManagerWorker_create(&worker, &shared, APX_SERVER_MODE));
+   apx_fileManagerWorker_setTransmitHandler(&worker, &handler);
+   apx_fileInfo_create(&info, RMF_INVALID_ADDRESS, (uint32_t) sizeof(conflationSpy.data), "test.in", RMF_FILE_TYPE_FIXED, RMF_DIGEST_TYPE_NONE, NULL);
+   file = apx_fileManagerShared_createLocalFile(&shared, &info);
+   CuAssertPtrNotNull(tc, file);
+   address = apx_file_getStartAddress(file);
+   apx_fileManagerShared_connect(&shared);
+
+   //Only the first range can be sent
+   CuAssertIntEquals(tc, APX_NO_ERROR, apx_byteRangeSet_insert(&conflationSpy.dirtyRanges, 0u, 2u));
+   CuAssertIntEquals(tc, APX_NO_ERROR, apx_byteRangeSet_insert(&conflationSpy.dirtyRanges, 8u, 1u));
+   CuAssertIntEquals(tc, APX_NO_ERROR, apx_byteRangeSet_insert(&conflationSpy.dirtyRanges, 12u, 4u));
+   m_numSendBuffersLeft = 1;
+   CuAssertIntEquals(tc, APX_NO_ERROR, apx_fileManagerWorker_sendConflatedData(&worker, address, &conflationHandler));
+   CuAssertTrue(tc, apx_fileManagerWorker_run(&worker));
+   CuAssertIntEquals(tc, 1, conflationSpy.numTakeCalls);
+   CuAssertIntEquals(tc, 1, apx_transmitHandlerSpy_length(&spy));
+   transmitted = apx_transmitHandlerSpy_next(&spy);
+   CuAssertPtrNotNull(tc, transmitted);
+   CuAssertIntEquals(tc, RMF_LOW_ADDRESS_SIZE + 2, (int) adt_bytearray_length(transmitted));
+   adt_bytearray_delete(transmitted);
+
+   //The remaining ranges are dirty again
+   CuAssertIntEquals(tc, 2, conflationSpy.numMarkDirtyCalls);
+   CuAssertUIntEquals(tc, 2u, apx_byteRangeSet_length(&conflationSpy.dirtyRanges));
+   range = apx_byteRangeSet_get(&conflationSpy.dirtyRanges, 0u);
+   CuAssertUIntEquals(tc, 8u, range->offset);
+   CuAssertUIntEquals(tc, 1u, range->len);
+   range = apx_byteRangeSet_get(&conflationSpy.dirtyRanges, 1u);
+   CuAssertUIntEquals(tc, 12u, range->offset);
+   CuAssertUIntEquals(tc, 4u, range->len);
+
+   //They go out with the next transfer
+   m_numSendBuffersLeft = -1;
+   CuAssertIntEquals(tc, APX_NO_ERROR, apx_fileManagerWorker_sendConflatedData(&worker, address, &conflationHandler));
+   CuAssertTrue(tc, apx_fileManagerWorker_run(&worker));
+   CuAssertIntEquals(tc, 2, conflationSpy.numTakeCalls);
+   CuAssertIntEquals(tc, 2, apx_transmitHandlerSpy_length(&spy));
+   CuAssertUIntEquals(tc, 0u, apx_byteRangeSet_length(&conflationSpy.dirtyRanges));
+
+   apx_fileManagerWorker_destroy(&worker);
+   apx_fileManagerShared_destroy(&shared);
+   apx_transmitHandlerSpy_destroy(&spy);
+   apx_fileInfo_destroy(&info);
+   apx_byteRangeSet_destroy(&conflationSpy.dirtyRanges);
+}
+
+/**
+ * Verifies that a large write is transmitted in fragments and that small writes posted during the upload
+ * only have to wait for the fragment currently being transmitted
+ */
+static void test_apx_fileManagerWorker_fragmentLargeWrite(CuTest* tc)
+{
+   apx_fileManagerWorker_t worker;
+   apx_fileManagerShared_t shared;
+   apx_transmitHandlerSpy_t spy;
+   apx_transmitHandler_t handler;
+   apx_fileManagerWorkerStats_t stats;
+   adt_bytearray_t *transmitted;
+   rmf_msg_t msgs[4];
+   uint8_t *bulkData;
+   uint8_t smallData[2] = {0x55, 0x66};
+   const uint32_t bulkSize = 3u*APX_WORKER_FRAGMENT_SIZE + 100u;
+   const uint32_t smallAddress = bulkSize + 1000u;
+   uint32_t i;
+
+   bulkData = (uint8_t*) malloc(bulkSize);
+   CuAssertPtrNotNull(tc, bulkData);
+   for (i = 0u; i < bulkSize; i++)
+   {
+      bulkData[i] = (uint8_t) i;
+   }
+   apx_transmitHandlerSpy_create(&spy);
+   memset(&handler, 0, sizeof(handler));
+   handler.arg = &spy;
+   handler.getSendBuffer = apx_transmitHandlerSpy_getSendBuffer;
+   handler.send = apx_transmitHandlerSpy_send;
+   handler.sendFramed = apx_transmitHandlerSpy_sendFramed;
+   CuAssertIntEquals(tc, APX_NO_ERROR, apx_fileManagerShared_create(&shared));
+   CuAssertIntEquals(tc, APX_NO_ERROR, apx_fileManagerWorker_create(&worker, &shared, APX_CLIENT_MODE));
+   apx_fileManagerWorker_setNumHeaderSize(&worker, 32u);
+   apx_fileManagerWorker_setTransmitHandler(&worker, &handler);
+   apx_fileManagerWorker_setFragmentSize(&worker, APX_WORKER_FRAGMENT_SIZE);
+   apx_fileManagerShared_connect(&shared);
+
+   //Only the first fragment goes out in the first round
+   CuAssertIntEquals(tc, APX_NO_ERROR, apx_fileManagerWorker_sendDynamicData(&worker, 0u, bulkSize, bulkData));
+   CuAssertTrue(tc, apx_fileManagerWorker_run(&worker));
+   CuAssertUIntEquals(tc, 1u, apx_fileManagerWorker_numBulkTransfers(&worker));
+   CuAssertIntEquals(tc, 1, apx_transmitHandlerSpy_length(&spy));
+   transmitted = apx_transmitHandlerSpy_next(&spy);
+   CuAssertIntEquals(tc, 1, unpackTransmission(transmitted, &msgs[0], 4));
+   CuAssertUIntEquals(tc, 0u, msgs[0].address);
+   CuAssertIntEquals(tc, APX_WORKER_FRAGMENT_SIZE, msgs[0].dataLen);
+   CuAssertTrue(tc, msgs[0].more_bit);
+   CuAssertIntEquals(tc, 0, memcmp(&bulkData[0], msgs[0].data, APX_WORKER_FRAGMENT_SIZE));
+   adt_bytearray_delete(transmitted);
+
+   //A small write posted during the upload is transmitted ahead of the next fragment
+   CuAssertIntEquals(tc, APX_NO_ERROR, apx_fileManagerWorker_sendDynamicData(&worker, smallAddress, sizeof(smallData), &smallData[0]));
+   CuAssertTrue(tc, apx_fileManagerWorker_run(&worker));
+   CuAssertIntEquals(tc, 1, apx_transmitHandlerSpy_length(&spy));
+   transmitted = apx_transmitHandlerSpy_next(&spy);
+   CuAssertIntEquals(tc, 2, unpackTransmission(transmitted, &msgs[0], 4));
+   CuAssertUIntEquals(tc, smallAddress, msgs[0].address);
+   CuAssertIntEquals(tc, (int) sizeof(smallData), msgs[0].dataLen);
+   CuAssertTrue(tc, !msgs[0].more_bit);
+   CuAssertUIntEquals(tc, APX_WORKER_FRAGMENT_SIZE, msgs[1].address);
+   CuAssertIntEquals(tc, APX_WORKER_FRAGMENT_SIZE, msgs[1].dataLen);
+   CuAssertTrue(tc, msgs[1].more_bit);
+   adt_bytearray_delete(transmitted);
+
+   //Remaining fragments, the last one clears the more bit
+   CuAssertTrue(tc, apx_fileManagerWorker_run(&worker));
+   CuAssertTrue(tc, apx_fileManagerWorker_run(&worker));
+   CuAssertUIntEquals(tc, 0u, apx_fileManagerWorker_numBulkTransfers(&worker));
+   CuAssertIntEquals(tc, 2, apx_transmitHandlerSpy_length(&spy));
+   transmitted = apx_transmitHandlerSpy_next(&spy);
+   CuAssertIntEquals(tc, 1, unpackTransmission(transmitted, &msgs[0], 4));
+   CuAssertUIntEquals(tc, 2u*APX_WORKER_FRAGMENT_SIZE, msgs[0].address);
+   CuAssertTrue(tc, msgs[0].more_bit);
+   adt_bytearray_delete(transmitted);
+   transmitted = apx_transmitHandlerSpy_next(&spy);
+   CuAssertIntEquals(tc, 1, unpackTransmission(transmitted, &msgs[0], 4));
+   CuAssertUIntEquals(tc, 3u*APX_WORKER_FRAGMENT_SIZE, msgs[0].address);
+   CuAssertIntEquals(tc, 100, msgs[0].dataLen);
+   CuAssertTrue(tc, !msgs[0].more_bit);
+   CuAssertIntEquals(tc, 0, memcmp(&bulkData[3u*APX_WORKER_FRAGMENT_SIZE], msgs[0].data, 100));
+   adt_bytearray_delete(transmitted);
+
+   //A write overlapping the unsent part of an upload must not be overtaken by older data
+   CuAssertIntEquals(tc, APX_NO_ERROR, apx_fileManagerWorker_sendDynamicData(&worker, 0u, bulkSize, bulkData));
+   CuAssertTrue(tc, apx_fileManagerWorker_run(&worker));
+   adt_bytearray_delete(apx_transmitHandlerSpy_next(&spy));
+   CuAssertIntEquals(tc, APX_NO_ERROR, apx_fileManagerWorker_sendDynamicData(&worker, 2u*APX_WORKER_FRAGMENT_SIZE, sizeof(smallData), &smallData[0]));
+   CuAssertTrue(tc, apx_fileManagerWorker_run(&worker));
+   CuAssertUIntEquals(tc, 0u, apx_fileManagerWorker_numBulkTransfers(&worker));
+   CuAssertTrue(tc, apx_transmitHandlerSpy_length(&spy) > 0);
+   transmitted = 0;
+   while (apx_transmitHandlerSpy_length(&spy) > 0)
+   {
+      if (transmitted != 0)
+      {
+         adt_bytearray_delete(transmitted);
+      }
+      transmitted = apx_transmitHandlerSpy_next(&spy);
+   }
+   i = (uint32_t) unpackTransmission(transmitted, &msgs[0], 4);
+   CuAssertTrue(tc, i > 0u);
+   CuAssertUIntEquals(tc, 2u*APX_WORKER_FRAGMENT_SIZE, msgs[i-1u].address);
+   CuAssertIntEquals(tc, (int) sizeof(smallData), msgs[i-1u].dataLen);
+   adt_bytearray_delete(transmitted);
+
+   apx_fileManagerWorker_getStats(&worker, &stats);
+   CuAssertUIntEquals(tc, 8u, stats.numFragmentsSent);
+
+   apx_fileManagerWorker_destroy(&worker);
+   apx_fileManagerShared_destroy(&shared);
+   apx_transmitHandlerSpy_destroy(&spy);
+   free(bulkData);
+}
+
+/**
+ * Peers which have not announced Fragment-Interleave in their greeting receive large writes in one message
+ */
+static void test_apx_fileManagerWorker_largeWriteIsNotFragmentedByDefault(CuTest* tc)
+{
+   apx_fileManagerWorker_t worker;
+   apx_fileManagerShared_t shared;
+   apx_transmitHandlerSpy_t spy;
+   apx_transmitHandler_t handler;
+   apx_fileManagerWorkerStats_t stats;
+   adt_bytearray_t *transmitted;
+   rmf_msg_t msgs[1];
+   uint8_t *bulkData;
+   const uint32_t bulkSize = 3u*APX_WORKER_FRAGMENT_SIZE + 100u;
+   uint32_t i;
+
+   bulkData = (uint8_t*) malloc(bulkSize);
+   CuAssertPtrNotNull(tc, bulkData);
+   for (i = 0u; i < bulkSize; i++)
+   {
+      bulkData[i] = (uint8_t) i;
+   }
+   apx_transmitHandlerSpy_create(&spy);
+   memset(&handler, 0, sizeof(handler));
+   handler.arg = &spy;
+   handler.getSendBuffer = apx_transmitHandlerSpy_getSendBuffer;
+   handler.send = apx_transmitHandlerSpy_send;
+   handler.sendFramed = apx_transmitHandlerSpy_sendFramed;
+   CuAssertIntEquals(tc, APX_NO_ERROR, apx_fileManagerShared_create(&shared));
+   CuAssertIntEquals(tc, APX_NO_ERROR, apx_fileManagerWorker_create(&worker, &shared, APX_SERVER_MODE));
+   apx_fileManagerWorker_setNumHeaderSize(&worker, 32u);
+   apx_fileManagerWorker_setTransmitHandler(&worker, &handler);
+   apx_fileManagerShared_connect(&shared);
+
+   CuAssertIntEquals(tc, APX_NO_ERROR, apx_fileManagerWorker_sendDynamicData(&worker, 0u, bulkSize, bulkData));
+   CuAssertTrue(tc, apx_fileManagerWorker_run(&worker));
+   CuAssertUIntEquals(tc, 0u, apx_fileManagerWorker_numBulkTransfers(&worker));
+   CuAssertIntEquals(tc, 1, apx_transmitHandlerSpy_length(&spy));
+   transmitted = apx_transmitHandlerSpy_next(&spy);
+   //Too large for the batch buffer, transmitted on its own without numHeader
+   CuAssertIntEquals(tc, (int32_t) adt_bytearray_length(transmitted), rmf_unpackMsg(adt_bytearray_data(transmitted), (int32_t) adt_bytearray_length(transmitted), &msgs[0]));
+   CuAssertUIntEquals(tc, 0u, msgs[0].address);
+   CuAssertIntEquals(tc, (int) bulkSize, msgs[0].dataLen);
+   CuAssertTrue(tc, !msgs[0].more_bit);
+   CuAssertIntEquals(tc, 0, memcmp(bulkData, msgs[0].data, bulkSize));
+   adt_bytearray_delete(transmitted);
+
+   apx_fileManagerWorker_getStats(&worker, &stats);
+   CuAssertUIntEquals(tc, 0u, stats.numFragmentsSent);
+
+   apx_fileManagerWorker_destroy(&worker);
+   apx_fileManagerShared_destroy(&shared);
+   apx_transmitHandlerSpy_destroy(&spy);
+   free(bulkData);
+}
+
+/**
+ * Splits a batched transmission into its RMF messages
+ */
+static int32_t unpackTransmission(adt_bytearray_t *transmitted, rmf_msg_t *msgs, int32_t maxNumMsgs)
+{
+   int32_t numMsgs = 0;
+   const uint8_t *pNext = adt_bytearray_data(transmitted);
+   const uint8_t *pEnd = pNext + adt_bytearray_length(transmitted);
+   while ( (pNext < pEnd) && (numMsgs < maxNumMsgs) )
+   {
+      uint32_t msgLen;
+      const uint8_t *pResult = numheader_decode32(pNext, pEnd, &msgLen);
+      if ( (pResult == 0) || (pResult == pNext) || (pResult + msgLen > pEnd) )
+      {
+         return -1;
+      }
+      if (rmf_unpackMsg(pResult, (int32_t) msgLen, &msgs[numMsgs]) <= 0)
+      {
+         return -1;
+      }
+      numMsgs++;
+      pNext = pResult + msgLen;
+   }
+   return numMsgs;
+}
+
+static apx_error_t conflationSpy_takeDirtyRanges(void *arg, apx_file_t *file, apx_byteRangeSet_t *ranges)
+{
+   conflationSpy_t *self = (conflationSpy_t*) arg;
+   uint32_t i;
+   (void) file;
+   self->numTakeCalls++;
+   for (i = 0u; i < apx_byteRangeSet_length(&self->dirtyRanges); i++)
+   {
+      const apx_byteRange_t *range = apx_byteRangeSet_get(&self->dirtyRanges, i);
+      apx_error_t rc = apx_byteRangeSet_insert(ranges, range->offset, range->len);
+      if (rc != APX_NO_ERROR)
+      {
+         return rc;
+      }
+   }
+   apx_byteRangeSet_clear(&self->dirtyRanges);
+   return APX_NO_ERROR;
+}
+
+static apx_error_t conflationSpy_readData(void *arg, apx_file_t *file, uint32_t offset, uint8_t *dest, uint32_t len)
+{
+   conflationSpy_t *self = (conflationSpy_t*) arg;
+   (void) file;
+   memcpy(dest, &self->data[offset], len);
+   return APX_NO_ERROR;
+}
+
+static apx_error_t conflationSpy_markDirty(void *arg, apx_file_t *file, uint32_t offset, uint32_t len)
+{
+   conflationSpy_t *self = (conflationSpy_t*) arg;
+   (void) file;
+   self->numMarkDirtyCalls++;
+   return apx_byteRangeSet_insert(&self->dirtyRanges, offset, len);
+}
+
+/**
+ * Hands out at most m_numSendBuffersLeft buffers (no limit when negative)
+ */
+static uint8_t* limitedSendBuffer_getSendBuffer(void *arg, int32_t msgLen)
+{
+   if (m_numSendBuffersLeft == 0)
+   {
+      return (uint8_t*) 0;
+   }
+   if (m_numSendBuffersLeft > 0)
+   {
+      m_numSendBuffersLeft--;
+   }
+   return apx_transmitHandlerSpy_getSendBuffer(arg, msgLen);
+}
+
 /*
 static void test_apx_fileManagerWorker_processFileInfo(CuTest* tc)
 {
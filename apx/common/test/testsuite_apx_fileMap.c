@@ -25,6 +25,9 @@ static void test_apx_fileMap_createRemoteDefinitionFile(CuTest* tc);
 static void test_apx_fileMap_autoInsert(CuTest* tc);
 static void test_apx_fileMap_manualInsert(CuTest* tc);
 static void test_apx_fileMap_makeFileInfoArray(CuTest* tc);
+static void test_apx_fileMap_findByAddress(CuTest* tc);
+static void test_apx_fileMap_rejectOverlappingFiles(CuTest* tc);
+static void test_apx_fileMap_removeFile(CuTest* tc);
 
 //////////////////////////////////////////////////////////////////////////////
 // GLOBAL VARIABLES
@@ -49,6 +52,9 @@ CuSuite* testSuite_apx_fileMap(void)
    SUITE_ADD_TEST(suite, test_apx_fileMap_autoInsert);
    SUITE_ADD_TEST(suite, test_apx_fileMap_manualInsert);
    SUITE_ADD_TEST(suite, test_apx_fileMap_makeFileInfoArray);
+   SUITE_ADD_TEST(suite, test_apx_fileMap_findByAddress);
+   SUITE_ADD_TEST(suite, test_apx_fileMap_rejectOverlappingFiles);
+   SUITE_ADD_TEST(suite, test_apx_fileMap_removeFile);
 
    return suite;
 }
@@ -248,3 +254,90 @@ static void test_apx_fileMap_makeFileInfoArray(CuTest* tc)
 
 }
 
+static void test_apx_fileMap_findByAddress(CuTest* tc)
+{
+   apx_fileMap_t fileMap;
+   apx_file_t *files[3];
+   apx_fileInfo_t fileInfo;
+   uint32_t i;
+   const char *names[3] = {"file1.out", "file2.out", "file3.out"};
+   const uint32_t addresses[3] = {0u, 1024u, 4096u};
+
+   apx_fileMap_create(&fileMap);
+   for (i = 0u; i < 3u; i++)
+   {
+      CuAssertUIntEquals(tc, APX_NO_ERROR, apx_fileInfo_create(&fileInfo, addresses[2u-i], 100, names[2u-i], RMF_FILE_TYPE_FIXED, RMF_DIGEST_TYPE_NONE, NULL));
+      files[2u-i] = apx_file_new(&fileInfo);
+      CuAssertIntEquals(tc, 0, apx_fileMap_insertFile(&fileMap, files[2u-i]));
+      apx_fileInfo_destroy(&fileInfo);
+   }
+   CuAssertPtrEquals(tc, files[0], apx_fileMap_findByAddress(&fileMap, 0u));
+   CuAssertPtrEquals(tc, files[0], apx_fileMap_findByAddress(&fileMap, 99u));
+   CuAssertPtrEquals(tc, 0, apx_fileMap_findByAddress(&fileMap, 100u));
+   CuAssertPtrEquals(tc, 0, apx_fileMap_findByAddress(&fileMap, 1023u));
+   CuAssertPtrEquals(tc, files[1], apx_fileMap_findByAddress(&fileMap, 1024u));
+   CuAssertPtrEquals(tc, files[1], apx_fileMap_findByAddress(&fileMap, 1123u));
+   CuAssertPtrEquals(tc, files[2], apx_fileMap_findByAddress(&fileMap, 4096u));
+   CuAssertPtrEquals(tc, files[0], apx_fileMap_findByAddress(&fileMap, 50u));
+   CuAssertPtrEquals(tc, 0, apx_fileMap_findByAddress(&fileMap, 4196u));
+   apx_fileMap_destroy(&fileMap);
+}
+
+static void test_apx_fileMap_rejectOverlappingFiles(CuTest* tc)
+{
+   apx_fileMap_t fileMap;
+   apx_file_t *file;
+   apx_fileInfo_t fileInfo;
+
+   apx_fileMap_create(&fileMap);
+   CuAssertUIntEquals(tc, APX_NO_ERROR, apx_fileInfo_create(&fileInfo, 1000, 100, "file1.out", RMF_FILE_TYPE_FIXED, RMF_DIGEST_TYPE_NONE, NULL));
+   CuAssertIntEquals(tc, 0, apx_fileMap_insertFile(&fileMap, apx_file_new(&fileInfo)));
+   apx_fileInfo_destroy(&fileInfo);
+
+   //overlaps end of file1, inserted after it
+   CuAssertUIntEquals(tc, APX_NO_ERROR, apx_fileInfo_create(&fileInfo, 1099, 10, "file2.out", RMF_FILE_TYPE_FIXED, RMF_DIGEST_TYPE_NONE, NULL));
+   file = apx_file_new(&fileInfo);
+   CuAssertIntEquals(tc, -1, apx_fileMap_insertFile(&fileMap, file));
+   apx_file_delete(file);
+   apx_fileInfo_destroy(&fileInfo);
+
+   //overlaps start of file1, inserted before it
+   CuAssertUIntEquals(tc, APX_NO_ERROR, apx_fileInfo_create(&fileInfo, 990, 11, "file3.out", RMF_FILE_TYPE_FIXED, RMF_DIGEST_TYPE_NONE, NULL));
+   file = apx_file_new(&fileInfo);
+   CuAssertIntEquals(tc, -1, apx_fileMap_insertFile(&fileMap, file));
+   apx_file_delete(file);
+   apx_fileInfo_destroy(&fileInfo);
+
+   //fits exactly before file1
+   CuAssertUIntEquals(tc, APX_NO_ERROR, apx_fileInfo_create(&fileInfo, 990, 10, "file4.out", RMF_FILE_TYPE_FIXED, RMF_DIGEST_TYPE_NONE, NULL));
+   CuAssertIntEquals(tc, 0, apx_fileMap_insertFile(&fileMap, apx_file_new(&fileInfo)));
+   apx_fileInfo_destroy(&fileInfo);
+   CuAssertIntEquals(tc, 2, apx_fileMap_length(&fileMap));
+   apx_fileMap_destroy(&fileMap);
+}
+
+static void test_apx_fileMap_removeFile(CuTest* tc)
+{
+   apx_fileMap_t fileMap;
+   apx_file_t *file1;
+   apx_file_t *file2;
+   apx_fileInfo_t fileInfo;
+
+   apx_fileMap_create(&fileMap);
+   CuAssertUIntEquals(tc, APX_NO_ERROR, apx_fileInfo_create(&fileInfo, RMF_INVALID_ADDRESS, 100, "file1.out", RMF_FILE_TYPE_FIXED, RMF_DIGEST_TYPE_NONE, NULL));
+   file1 = apx_file_new(&fileInfo);
+   apx_fileInfo_destroy(&fileInfo);
+   CuAssertUIntEquals(tc, APX_NO_ERROR, apx_fileInfo_create(&fileInfo, RMF_INVALID_ADDRESS, 100, "file2.out", RMF_FILE_TYPE_FIXED, RMF_DIGEST_TYPE_NONE, NULL));
+   file2 = apx_file_new(&fileInfo);
+   apx_fileInfo_destroy(&fileInfo);
+   CuAssertIntEquals(tc, 0, apx_fileMap_insertFile(&fileMap, file1));
+   CuAssertIntEquals(tc, 0, apx_fileMap_insertFile(&fileMap, file2));
+   CuAssertUIntEquals(tc, 1024, file2->fileInfo.address);
+
+   CuAssertIntEquals(tc, 0, apx_fileMap_removeFile(&fileMap, file1));
+   CuAssertPtrEquals(tc, 0, apx_fileMap_findByAddress(&fileMap, 0u));
+   CuAssertPtrEquals(tc, file2, apx_fileMap_findByAddress(&fileMap, 1024u));
+   CuAssertIntEquals(tc, 1, apx_fileMap_length(&fileMap));
+   apx_file_delete(file1);
+   apx_fileMap_destroy(&fileMap);
+}
@@ -0,0 +1,147 @@
+/*****************************************************************************
+* \file      testsuite_apx_latencyStats.c
+* \author    Conny Gustafsson
+* \date      2026-10-18
+* \brief     Unit tests for apx_latencyStats
+*
+* Copyright (c) 2026 Conny Gustafsson
+* Permission is hereby granted, free of charge, to any person obtaining a copy of
+* this software and associated documentation files (the "Software"), to deal in
+* the Software without restriction, including without limitation the rights to
+* use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+* the Software, and to permit persons to whom the Software is furnished to do so,
+* subject to the following conditions:
+
+* The above copyright notice and this permission notice shall be included in all
+* copies or substantial portions of the Software.
+
+* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+* IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+* FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+* COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+* IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+* CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+*
+******************************************************************************/
+//////////////////////////////////////////////////////////////////////////////
+// INCLUDES
+//////////////////////////////////////////////////////////////////////////////
+#include <stddef.h>
+#include <stdio.h>
+#include <string.h>
+#include "CuTest.h"
+#include "apx_latencyStats.h"
+#ifdef MEM_LEAK_CHECK
+#include "CMemLeak.h"
+#endif
+
+//////////////////////////////////////////////////////////////////////////////
+// PRIVATE CONSTANTS AND DATA TYPES
+//////////////////////////////////////////////////////////////////////////////
+
+//////////////////////////////////////////////////////////////////////////////
+// PRIVATE FUNCTION PROTOTYPES
+//////////////////////////////////////////////////////////////////////////////
+static void test_apx_latencyStats_emptySummary(CuTest* tc);
+static void test_apx_latencyStats_minAvgMax(CuTest* tc);
+static void test_apx_latencyStats_p99(CuTest* tc);
+static void test_apx_latencyStats_windowDropsOldSamples(CuTest* tc);
+
+//////////////////////////////////////////////////////////////////////////////
+// PRIVATE VARIABLES
+//////////////////////////////////////////////////////////////////////////////
+
+//////////////////////////////////////////////////////////////////////////////
+// PUBLIC FUNCTIONS
+//////////////////////////////////////////////////////////////////////////////
+CuSuite* testSuite_apx_latencyStats(void)
+{
+   CuSuite* suite = CuSuiteNew();
+
+   SUITE_ADD_TEST(suite, test_apx_latencyStats_emptySummary);
+   SUITE_ADD_TEST(suite, test_apx_latencyStats_minAvgMax);
+   SUITE_ADD_TEST(suite, test_apx_latencyStats_p99);
+   SUITE_ADD_TEST(suite, test_apx_latencyStats_windowDropsOldSamples);
+
+   return suite;
+}
+
+//////////////////////////////////////////////////////////////////////////////
+// PRIVATE FUNCTIONS
+//////////////////////////////////////////////////////////////////////////////
+static void test_apx_latencyStats_emptySummary(CuTest* tc)
+{
+   apx_latencyStats_t stats;
+   apx_latencySummary_t summary;
+   apx_latencyStats_create(&stats);
+   apx_latencyStats_getSummary(&stats, &summary);
+   CuAssertUIntEquals(tc, 0u, summary.numSamples);
+   CuAssertUIntEquals(tc, 0u, summary.totalSamples);
+   CuAssertUIntEquals(tc, 0u, summary.minRttUs);
+   CuAssertUIntEquals(tc, 0u, summary.avgRttUs);
+   CuAssertUIntEquals(tc, 0u, summary.p99RttUs);
+   CuAssertUIntEquals(tc, 0u, summary.maxRttUs);
+   apx_latencyStats_destroy(&stats);
+}
+
+static void test_apx_latencyStats_minAvgMax(CuTest* tc)
+{
+   apx_latencyStats_t stats;
+   apx_latencySummary_t summary;
+   apx_latencyStats_create(&stats);
+   apx_latencyStats_addSample(&stats, 300u);
+   apx_latencyStats_addSample(&stats, 100u);
+   apx_latencyStats_addSample(&stats, 200u);
+   apx_latencyStats_getSummary(&stats, &summary);
+   CuAssertUIntEquals(tc, 3u, summary.numSamples);
+   CuAssertUIntEquals(tc, 3u, summary.totalSamples);
+   CuAssertUIntEquals(tc, 200u, summary.lastRttUs);
+   CuAssertUIntEquals(tc, 100u, summary.minRttUs);
+   CuAssertUIntEquals(tc, 200u, summary.avgRttUs);
+   CuAssertUIntEquals(tc, 300u, summary.maxRttUs);
+   CuAssertUIntEquals(tc, 300u, summary.p99RttUs);
+   CuAssertUIntEquals(tc, 100u, summary.oneWayDelayUs);
+   apx_latencyStats_destroy(&stats);
+}
+
+static void test_apx_latencyStats_p99(CuTest* tc)
+{
+   apx_latencyStats_t stats;
+   apx_latencySummary_t summary;
+   uint32_t i;
+   apx_latencyStats_create(&stats);
+   //100 samples: 1..100 in reverse order, p99 by nearest rank is 99
+   for (i = 100u; i > 0u; i--)
+   {
+      apx_latencyStats_addSample(&stats, i);
+   }
+   apx_latencyStats_getSummary(&stats, &summary);
+   CuAssertUIntEquals(tc, 100u, summary.numSamples);
+   CuAssertUIntEquals(tc, 1u, summary.minRttUs);
+   CuAssertUIntEquals(tc, 99u, summary.p99RttUs);
+   CuAssertUIntEquals(tc, 100u, summary.maxRttUs);
+   CuAssertUIntEquals(tc, 50u, summary.avgRttUs);
+   apx_latencyStats_destroy(&stats);
+}
+
+static void test_apx_latencyStats_windowDropsOldSamples(CuTest* tc)
+{
+   apx_latencyStats_t stats;
+   apx_latencySummary_t summary;
+   uint32_t i;
+   apx_latencyStats_create(&stats);
+   apx_latencyStats_addSample(&stats, 1000000u);
+   for (i = 0u; i < APX_LATENCY_STATS_WINDOW_SIZE; i++)
+   {
+      apx_latencyStats_addSample(&stats, 10u);
+   }
+   apx_latencyStats_getSummary(&stats, &summary);
+   CuAssertUIntEquals(tc, APX_LATENCY_STATS_WINDOW_SIZE, summary.numSamples);
+   CuAssertUIntEquals(tc, APX_LATENCY_STATS_WINDOW_SIZE + 1u, summary.totalSamples);
+   CuAssertUIntEquals(tc, 10u, summary.maxRttUs);
+   CuAssertUIntEquals(tc, 10u, summary.avgRttUs);
+   apx_latencyStats_reset(&stats);
+   apx_latencyStats_getSummary(&stats, &summary);
+   CuAssertUIntEquals(tc, 0u, summary.totalSamples);
+   apx_latencyStats_destroy(&stats);
+}
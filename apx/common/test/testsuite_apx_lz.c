@@ -0,0 +1,217 @@
+/*****************************************************************************
+* \file      testsuite_apx_lz.c
+* \author    Conny Gustafsson
+* \date      2026-10-18
+* \brief     Unit Tests for apx_lz
+*
+* Copyright (c) 2026 Conny Gustafsson
+* Permission is hereby granted, free of charge, to any person obtaining a copy of
+* this software and associated documentation files (the "Software"), to deal in
+* the Software without restriction, including without limitation the rights to
+* use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+* the Software, and to permit persons to whom the Software is furnished to do so,
+* subject to the following conditions:
+
+* The above copyright notice and this permission notice shall be included in all
+* copies or substantial portions of the Software.
+
+* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+* IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+* FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+* COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+* IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+* CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+*
+******************************************************************************/
+//////////////////////////////////////////////////////////////////////////////
+// INCLUDES
+//////////////////////////////////////////////////////////////////////////////
+#include <stddef.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "CuTest.h"
+#include "apx_lz.h"
+#ifdef MEM_LEAK_CHECK
+#include "CMemLeak.h"
+#endif
+
+//////////////////////////////////////////////////////////////////////////////
+// PRIVATE CONSTANTS AND DATA TYPES
+//////////////////////////////////////////////////////////////////////////////
+#define DEFINITION_TEXT_SIZE 4096u
+
+//////////////////////////////////////////////////////////////////////////////
+// PRIVATE FUNCTION PROTOTYPES
+//////////////////////////////////////////////////////////////////////////////
+static void test_apx_lz_compressEmptyBlock(CuTest* tc);
+static void test_apx_lz_compressShortBlockAsLiterals(CuTest* tc);
+static void test_apx_lz_compressRunOfSameByte(CuTest* tc);
+static void test_apx_lz_compressDefinitionText(CuTest* tc);
+static void test_apx_lz_compressIncompressibleData(CuTest* tc);
+static void test_apx_lz_decodeOneByteAtATime(CuTest* tc);
+static void test_apx_lz_decodeInvalidOffset(CuTest* tc);
+static void test_apx_lz_decodeTooLongOutput(CuTest* tc);
+static apx_size_t fillDefinitionText(char *text, apx_size_t maxLen);
+
+//////////////////////////////////////////////////////////////////////////////
+// PRIVATE VARIABLES
+//////////////////////////////////////////////////////////////////////////////
+
+//////////////////////////////////////////////////////////////////////////////
+// PUBLIC FUNCTIONS
+//////////////////////////////////////////////////////////////////////////////
+CuSuite* testSuite_apx_lz(void)
+{
+   CuSuite* suite = CuSuiteNew();
+
+   SUITE_ADD_TEST(suite, test_apx_lz_compressEmptyBlock);
+   SUITE_ADD_TEST(suite, test_apx_lz_compressShortBlockAsLiterals);
+   SUITE_ADD_TEST(suite, test_apx_lz_compressRunOfSameByte);
+   SUITE_ADD_TEST(suite, test_apx_lz_compressDefinitionText);
+   SUITE_ADD_TEST(suite, test_apx_lz_compressIncompressibleData);
+   SUITE_ADD_TEST(suite, test_apx_lz_decodeOneByteAtATime);
+   SUITE_ADD_TEST(suite, test_apx_lz_decodeInvalidOffset);
+   SUITE_ADD_TEST(suite, test_apx_lz_decodeTooLongOutput);
+
+   return suite;
+}
+
+//////////////////////////////////////////////////////////////////////////////
+// PRIVATE FUNCTIONS
+//////////////////////////////////////////////////////////////////////////////
+static void test_apx_lz_compressEmptyBlock(CuTest* tc)
+{
+   const uint8_t src[1] = {0};
+   uint8_t buf[16];
+   apx_size_t len = 0u;
+   CuAssertIntEquals(tc, APX_NO_ERROR, apx_lz_compress(src, 0u, buf, sizeof(buf), &len));
+   CuAssertUIntEquals(tc, 1u, len);
+   CuAssertUIntEquals(tc, 0x00, buf[0]);
+   CuAssertIntEquals(tc, APX_NO_ERROR, apx_lz_decompress(buf, len, (uint8_t*) 0, 0u));
+}
+
+static void test_apx_lz_compressShortBlockAsLiterals(CuTest* tc)
+{
+   const uint8_t src[8] = {'A', 'A', 'A', 'A', 'A', 'A', 'A', 'A'};
+   uint8_t buf[16];
+   uint8_t result[8];
+   apx_size_t len = 0u;
+   CuAssertIntEquals(tc, APX_NO_ERROR, apx_lz_compress(src, sizeof(src), buf, sizeof(buf), &len));
+   CuAssertUIntEquals(tc, 9u, len);
+   CuAssertUIntEquals(tc, 0x80, buf[0]);
+   CuAssertIntEquals(tc, 0, memcmp(&buf[1], src, sizeof(src)));
+   CuAssertIntEquals(tc, APX_NO_ERROR, apx_lz_decompress(buf, len, result, sizeof(result)));
+   CuAssertIntEquals(tc, 0, memcmp(result, src, sizeof(src)));
+}
+
+static void test_apx_lz_compressRunOfSameByte(CuTest* tc)
+{
+   const uint8_t expected[10] = {0x1A, 'a', 0x01, 0x00, 0x50, 'a', 'a', 'a', 'a', 'a'};
+   uint8_t src[20];
+   uint8_t buf[32];
+   uint8_t result[20];
+   apx_size_t len = 0u;
+   memset(src, 'a', sizeof(src));
+   CuAssertIntEquals(tc, APX_NO_ERROR, apx_lz_compress(src, sizeof(src), buf, sizeof(buf), &len));
+   CuAssertUIntEquals(tc, sizeof(expected), len);
+   CuAssertIntEquals(tc, 0, memcmp(buf, expected, sizeof(expected)));
+   CuAssertIntEquals(tc, APX_NO_ERROR, apx_lz_decompress(buf, len, result, sizeof(result)));
+   CuAssertIntEquals(tc, 0, memcmp(result, src, sizeof(src)));
+}
+
+static void test_apx_lz_compressDefinitionText(CuTest* tc)
+{
+   char *text = (char*) malloc(DEFINITION_TEXT_SIZE);
+   uint8_t *compressed = (uint8_t*) malloc(apx_lz_compressBound(DEFINITION_TEXT_SIZE));
+   uint8_t *result = (uint8_t*) malloc(DEFINITION_TEXT_SIZE);
+   apx_size_t textLen;
+   apx_size_t len = 0u;
+   textLen = fillDefinitionText(text, DEFINITION_TEXT_SIZE);
+   CuAssertIntEquals(tc, APX_NO_ERROR, apx_lz_compress((const uint8_t*) text, textLen, compressed, apx_lz_compressBound(textLen), &len));
+   CuAssertTrue(tc, len < (textLen / 2u));
+   CuAssertIntEquals(tc, APX_NO_ERROR, apx_lz_decompress(compressed, len, result, textLen));
+   CuAssertIntEquals(tc, 0, memcmp(result, text, textLen));
+   //Wrong uncompressed size must be detected
+   CuAssertIntEquals(tc, APX_DECOMPRESSION_ERROR, apx_lz_decompress(compressed, len, result, textLen - 1u));
+   CuAssertIntEquals(tc, APX_DECOMPRESSION_ERROR, apx_lz_decompress(compressed, len - 1u, result, textLen));
+   free(text);
+   free(compressed);
+   free(result);
+}
+
+static void test_apx_lz_compressIncompressibleData(CuTest* tc)
+{
+   uint8_t src[256];
+   uint8_t buf[512];
+   uint8_t result[256];
+   apx_size_t len = 0u;
+   uint32_t i;
+   uint32_t state = 12345u;
+   for (i = 0u; i < sizeof(src); i++)
+   {
+      state = state * 1103515245u + 12345u;
+      src[i] = (uint8_t) (state >> 16);
+   }
+   CuAssertIntEquals(tc, APX_BUFFER_FULL_ERROR, apx_lz_compress(src, sizeof(src), buf, sizeof(src), &len));
+   CuAssertIntEquals(tc, APX_NO_ERROR, apx_lz_compress(src, sizeof(src), buf, apx_lz_compressBound(sizeof(src)), &len));
+   CuAssertTrue(tc, len <= apx_lz_compressBound(sizeof(src)));
+   CuAssertIntEquals(tc, APX_NO_ERROR, apx_lz_decompress(buf, len, result, sizeof(result)));
+   CuAssertIntEquals(tc, 0, memcmp(result, src, sizeof(src)));
+}
+
+static void test_apx_lz_decodeOneByteAtATime(CuTest* tc)
+{
+   char *text = (char*) malloc(DEFINITION_TEXT_SIZE);
+   uint8_t *compressed = (uint8_t*) malloc(apx_lz_compressBound(DEFINITION_TEXT_SIZE));
+   uint8_t *result = (uint8_t*) malloc(DEFINITION_TEXT_SIZE);
+   apx_lzDecoder_t decoder;
+   apx_size_t textLen;
+   apx_size_t len = 0u;
+   apx_size_t i;
+   textLen = fillDefinitionText(text, DEFINITION_TEXT_SIZE);
+   CuAssertIntEquals(tc, APX_NO_ERROR, apx_lz_compress((const uint8_t*) text, textLen, compressed, apx_lz_compressBound(textLen), &len));
+   apx_lzDecoder_create(&decoder, result, textLen);
+   for (i = 0u; i < len; i++)
+   {
+      CuAssertTrue(tc, !apx_lzDecoder_isComplete(&decoder));
+      CuAssertIntEquals(tc, APX_NO_ERROR, apx_lzDecoder_write(&decoder, &compressed[i], 1u));
+   }
+   CuAssertTrue(tc, apx_lzDecoder_isComplete(&decoder));
+   CuAssertUIntEquals(tc, textLen, apx_lzDecoder_getSize(&decoder));
+   CuAssertIntEquals(tc, 0, memcmp(result, text, textLen));
+   //Data after end of block is an error
+   CuAssertIntEquals(tc, APX_DECOMPRESSION_ERROR, apx_lzDecoder_write(&decoder, &compressed[0], 1u));
+   free(text);
+   free(compressed);
+   free(result);
+}
+
+static void test_apx_lz_decodeInvalidOffset(CuTest* tc)
+{
+   const uint8_t offsetZero[9] = {0x10, 'a', 0x00, 0x00, 0x50, 'a', 'a', 'a', 'a'};
+   const uint8_t offsetBeforeStart[9] = {0x10, 'a', 0x02, 0x00, 0x50, 'a', 'a', 'a', 'a'};
+   uint8_t result[32];
+   CuAssertIntEquals(tc, APX_DECOMPRESSION_ERROR, apx_lz_decompress(offsetZero, sizeof(offsetZero), result, 10u));
+   CuAssertIntEquals(tc, APX_DECOMPRESSION_ERROR, apx_lz_decompress(offsetBeforeStart, sizeof(offsetBeforeStart), result, 10u));
+}
+
+static void test_apx_lz_decodeTooLongOutput(CuTest* tc)
+{
+   const uint8_t literals[6] = {0x50, 'a', 'b', 'c', 'd', 'e'};
+   uint8_t result[4];
+   CuAssertIntEquals(tc, APX_DECOMPRESSION_ERROR, apx_lz_decompress(literals, sizeof(literals), result, sizeof(result)));
+}
+
+static apx_size_t fillDefinitionText(char *text, apx_size_t maxLen)
+{
+   apx_size_t len;
+   uint32_t i = 0u;
+   len = (apx_size_t) sprintf(text, "APX/1.2\nN\"TestNode\"\n");
+   while (len + 64u < maxLen)
+   {
+      len += (apx_size_t) sprintf(&text[len], "P\"ProvideSignal%u\"C(0,%u):=%u\n", (unsigned int) i, (unsigned int) (i % 7u) + 1u, (unsigned int) (i % 3u));
+      i++;
+   }
+   return len;
+}
@@ -0,0 +1,202 @@
+/*****************************************************************************
+* \file      testsuite_apx_mpscQueue.c
+* \author    Conny Gustafsson
+* \date      2026-10-18
+* \brief     Unit tests for apx_mpscQueue
+*
+* Copyright (c) 2026 Conny Gustafsson
+* Permission is hereby granted, free of charge, to any person obtaining a copy of
+* this software and associated documentation files (the "Software"), to deal in
+* the Software without restriction, including without limitation the rights to
+* use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+* the Software, and to permit persons to whom the Software is furnished to do so,
+* subject to the following conditions:
+
+* The above copyright notice and this permission notice shall be included in all
+* copies or substantial portions of the Software.
+
+* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+* IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+* FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+* COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+* IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+* CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+*
+******************************************************************************/
+//////////////////////////////////////////////////////////////////////////////
+// INCLUDES
+//////////////////////////////////////////////////////////////////////////////
+#include <stddef.h>
+#include <stdio.h>
+#include <string.h>
+#include "CuTest.h"
+#include "apx_mpscQueue.h"
+#ifdef MEM_LEAK_CHECK
+#include "CMemLeak.h"
+#endif
+
+//////////////////////////////////////////////////////////////////////////////
+// PRIVATE CONSTANTS AND DATA TYPES
+//////////////////////////////////////////////////////////////////////////////
+typedef struct testElem_tag
+{
+   uint32_t id;
+   void *ptr;
+   uint8_t data[5];
+} testElem_t;
+
+//////////////////////////////////////////////////////////////////////////////
+// PRIVATE FUNCTION PROTOTYPES
+//////////////////////////////////////////////////////////////////////////////
+static void test_apx_mpscQueue_create(CuTest* tc);
+static void test_apx_mpscQueue_pushPopInOrder(CuTest* tc);
+static void test_apx_mpscQueue_pushToFullQueue(CuTest* tc);
+static void test_apx_mpscQueue_wrapAround(CuTest* tc);
+static void test_apx_mpscQueue_waitReturnsWhenNotEmpty(CuTest* tc);
+static void test_apx_mpscQueue_waitAfterWakeup(CuTest* tc);
+static void test_apx_mpscQueue_waitWithTimeout(CuTest* tc);
+
+//////////////////////////////////////////////////////////////////////////////
+// PRIVATE VARIABLES
+//////////////////////////////////////////////////////////////////////////////
+
+//////////////////////////////////////////////////////////////////////////////
+// PUBLIC FUNCTIONS
+//////////////////////////////////////////////////////////////////////////////
+CuSuite* testSuite_apx_mpscQueue(void)
+{
+   CuSuite* suite = CuSuiteNew();
+
+   SUITE_ADD_TEST(suite, test_apx_mpscQueue_create);
+   SUITE_ADD_TEST(suite, test_apx_mpscQueue_pushPopInOrder);
+   SUITE_ADD_TEST(suite, test_apx_mpscQueue_pushToFullQueue);
+   SUITE_ADD_TEST(suite, test_apx_mpscQueue_wrapAround);
+   SUITE_ADD_TEST(suite, test_apx_mpscQueue_waitReturnsWhenNotEmpty);
+   SUITE_ADD_TEST(suite, test_apx_mpscQueue_waitAfterWakeup);
+   SUITE_ADD_TEST(suite, test_apx_mpscQueue_waitWithTimeout);
+
+   return suite;
+}
+
+//////////////////////////////////////////////////////////////////////////////
+// PRIVATE FUNCTIONS
+//////////////////////////////////////////////////////////////////////////////
+static void test_apx_mpscQueue_create(CuTest* tc)
+{
+   apx_mpscQueue_t queue;
+   apx_mpscQueue_t *queue2;
+   CuAssertIntEquals(tc, APX_INVALID_ARGUMENT_ERROR, apx_mpscQueue_create(&queue, 0u, 10u));
+   CuAssertIntEquals(tc, APX_INVALID_ARGUMENT_ERROR, apx_mpscQueue_create(&queue, 4u, 0u));
+   CuAssertIntEquals(tc, APX_NO_ERROR, apx_mpscQueue_create(&queue, (uint32_t) sizeof(testElem_t), 1000u));
+   CuAssertUIntEquals(tc, 1024u, apx_mpscQueue_capacity(&queue));
+   CuAssertUIntEquals(tc, 0u, apx_mpscQueue_length(&queue));
+   apx_mpscQueue_destroy(&queue);
+   queue2 = apx_mpscQueue_new(4u, 16u);
+   CuAssertPtrNotNull(tc, queue2);
+   CuAssertUIntEquals(tc, 16u, apx_mpscQueue_capacity(queue2));
+   apx_mpscQueue_delete(queue2);
+}
+
+static void test_apx_mpscQueue_pushPopInOrder(CuTest* tc)
+{
+   apx_mpscQueue_t queue;
+   testElem_t elem;
+   uint32_t i;
+   CuAssertIntEquals(tc, APX_NO_ERROR, apx_mpscQueue_create(&queue, (uint32_t) sizeof(testElem_t), 8u));
+   CuAssertTrue(tc, !apx_mpscQueue_pop(&queue, &elem));
+   for (i = 0u; i < 5u; i++)
+   {
+      memset(&elem, 0, sizeof(elem));
+      elem.id = i;
+      elem.ptr = &queue;
+      elem.data[4] = (uint8_t) (i + 10u);
+      CuAssertIntEquals(tc, APX_NO_ERROR, apx_mpscQueue_push(&queue, &elem));
+   }
+   CuAssertUIntEquals(tc, 5u, apx_mpscQueue_length(&queue));
+   for (i = 0u; i < 5u; i++)
+   {
+      CuAssertTrue(tc, apx_mpscQueue_pop(&queue, &elem));
+      CuAssertUIntEquals(tc, i, elem.id);
+      CuAssertPtrEquals(tc, &queue, elem.ptr);
+      CuAssertUIntEquals(tc, i + 10u, elem.data[4]);
+   }
+   CuAssertTrue(tc, !apx_mpscQueue_pop(&queue, &elem));
+   CuAssertUIntEquals(tc, 0u, apx_mpscQueue_length(&queue));
+   apx_mpscQueue_destroy(&queue);
+}
+
+static void test_apx_mpscQueue_pushToFullQueue(CuTest* tc)
+{
+   apx_mpscQueue_t queue;
+   uint32_t value;
+   CuAssertIntEquals(tc, APX_NO_ERROR, apx_mpscQueue_create(&queue, (uint32_t) sizeof(uint32_t), 4u));
+   for (value = 0u; value < 4u; value++)
+   {
+      CuAssertIntEquals(tc, APX_NO_ERROR, apx_mpscQueue_push(&queue, &value));
+   }
+   CuAssertIntEquals(tc, APX_BUFFER_FULL_ERROR, apx_mpscQueue_push(&queue, &value));
+   CuAssertUIntEquals(tc, 4u, apx_mpscQueue_length(&queue));
+   CuAssertTrue(tc, apx_mpscQueue_pop(&queue, &value));
+   CuAssertUIntEquals(tc, 0u, value);
+   value = 4u;
+   CuAssertIntEquals(tc, APX_NO_ERROR, apx_mpscQueue_push(&queue, &value));
+   apx_mpscQueue_destroy(&queue);
+}
+
+static void test_apx_mpscQueue_wrapAround(CuTest* tc)
+{
+   apx_mpscQueue_t queue;
+   uint32_t i;
+   uint32_t value;
+   CuAssertIntEquals(tc, APX_NO_ERROR, apx_mpscQueue_create(&queue, (uint32_t) sizeof(uint32_t), 4u));
+   for (i = 0u; i < 100u; i++)
+   {
+      value = i;
+      CuAssertIntEquals(tc, APX_NO_ERROR, apx_mpscQueue_push(&queue, &value));
+      value = i + 1000u;
+      CuAssertIntEquals(tc, APX_NO_ERROR, apx_mpscQueue_push(&queue, &value));
+      CuAssertTrue(tc, apx_mpscQueue_pop(&queue, &value));
+      CuAssertUIntEquals(tc, i, value);
+      CuAssertTrue(tc, apx_mpscQueue_pop(&queue, &value));
+      CuAssertUIntEquals(tc, i + 1000u, value);
+   }
+   CuAssertUIntEquals(tc, 0u, apx_mpscQueue_length(&queue));
+   apx_mpscQueue_destroy(&queue);
+}
+
+static void test_apx_mpscQueue_waitReturnsWhenNotEmpty(CuTest* tc)
+{
+   apx_mpscQueue_t queue;
+   uint32_t value = 1u;
+   CuAssertIntEquals(tc, APX_NO_ERROR, apx_mpscQueue_create(&queue, (uint32_t) sizeof(uint32_t), 4u));
+   CuAssertIntEquals(tc, APX_NO_ERROR, apx_mpscQueue_push(&queue, &value));
+   apx_mpscQueue_wait(&queue, APX_MPSC_QUEUE_WAIT_INFINITE);
+   CuAssertTrue(tc, apx_mpscQueue_pop(&queue, &value));
+   //producers do not touch the semaphore while the consumer is busy
+   CuAssertUIntEquals(tc, 0u, apx_mpscQueue_getNumWakeups(&queue));
+   apx_mpscQueue_destroy(&queue);
+}
+
+static void test_apx_mpscQueue_waitAfterWakeup(CuTest* tc)
+{
+   apx_mpscQueue_t queue;
+   CuAssertIntEquals(tc, APX_NO_ERROR, apx_mpscQueue_create(&queue, (uint32_t) sizeof(uint32_t), 4u));
+   apx_mpscQueue_wakeup(&queue);
+   apx_mpscQueue_wait(&queue, APX_MPSC_QUEUE_WAIT_INFINITE);
+   CuAssertUIntEquals(tc, 0u, apx_mpscQueue_length(&queue));
+   apx_mpscQueue_destroy(&queue);
+}
+
+static void test_apx_mpscQueue_waitWithTimeout(CuTest* tc)
+{
+   apx_mpscQueue_t queue;
+   uint32_t value = 7u;
+   CuAssertIntEquals(tc, APX_NO_ERROR, apx_mpscQueue_create(&queue, (uint32_t) sizeof(uint32_t), 4u));
+   apx_mpscQueue_wait(&queue, 10u);
+   apx_mpscQueue_wait(&queue, 0u);
+   CuAssertIntEquals(tc, APX_NO_ERROR, apx_mpscQueue_push(&queue, &value));
+   CuAssertTrue(tc, apx_mpscQueue_pop(&queue, &value));
+   CuAssertUIntEquals(tc, 7u, value);
+   CuAssertUIntEquals(tc, 0u, apx_mpscQueue_getNumWakeups(&queue));
+   apx_mpscQueue_destroy(&queue);
+}
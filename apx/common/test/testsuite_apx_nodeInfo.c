@@ -27,11 +27,13 @@
 // INCLUDES
 //////////////////////////////////////////////////////////////////////////////
 #include <assert.h>
+#include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
 #include "CuTest.h"
 #include "apx_nodeInfo.h"
 #include "apx_test_nodes.h"
+#include "pack.h"
 #ifdef MEM_LEAK_CHECK
 #include "CMemLeak.h"
 #endif
@@ -52,8 +54,11 @@ static void test_apx_nodeInfo_calcPortDataLen4(CuTest *tc);
 static void test_apx_nodeInfo_calcPortDataLen5(CuTest *tc);
 static void test_apx_nodeInfo_buildDerivedPortSignatures1(CuTest *tc);
 static void test_apx_nodeInfo_getClientPortNamesFromSignatures(CuTest *tc);
+static void test_apx_nodeInfo_findPortIdByNameInLargeNode(CuTest *tc);
 static void test_apx_nodeInfo_getRequirePortName(CuTest *tc);
 static void test_apx_nodeInfo_getProvidePortName(CuTest *tc);
+static void test_apx_nodeInfo_copyPlans(CuTest *tc);
+static void test_apx_nodeInfo_dynamicArrayUsedDataSize(CuTest *tc);
 
 //////////////////////////////////////////////////////////////////////////////
 // PRIVATE VARIABLES
@@ -75,8 +80,11 @@ CuSuite* testSuite_apx_nodeInfo(void)
    SUITE_ADD_TEST(suite, test_apx_nodeInfo_calcPortDataLen5);
    SUITE_ADD_TEST(suite, test_apx_nodeInfo_buildDerivedPortSignatures1);
    SUITE_ADD_TEST(suite, test_apx_nodeInfo_getClientPortNamesFromSignatures);
+   SUITE_ADD_TEST(suite, test_apx_nodeInfo_findPortIdByNameInLargeNode);
    SUITE_ADD_TEST(suite, test_apx_nodeInfo_getRequirePortName);
    SUITE_ADD_TEST(suite, test_apx_nodeInfo_getProvidePortName);
+   SUITE_ADD_TEST(suite, test_apx_nodeInfo_copyPlans);
+   SUITE_ADD_TEST(suite, test_apx_nodeInfo_dynamicArrayUsedDataSize);
 
    return suite;
 }
@@ -206,6 +214,44 @@ static void test_apx_nodeInfo_getClientPortNamesFromSignatures(CuTest *tc)
    apx_nodeInfo_delete(nodeInfo);
 }
 
+static void test_apx_nodeInfo_findPortIdByNameInLargeNode(CuTest *tc)
+{
+   const int32_t numPorts = 1000;
+   const size_t definitionSize = 64 + (numPorts * 2 * 32);
+   char *definition = (char*) malloc(definitionSize);
+   char *pNext = definition;
+   char name[32];
+   int32_t i;
+   apx_nodeInfo_t *nodeInfo;
+   CuAssertPtrNotNull(tc, definition);
+   pNext += sprintf(pNext, "APX/1.2\nN\"LargeNode\"\n");
+   for (i = 0; i < numPorts; i++)
+   {
+      pNext += sprintf(pNext, "P\"Provide%d\"C\n", (int) i);
+   }
+   for (i = 0; i < numPorts; i++)
+   {
+      pNext += sprintf(pNext, "R\"Require%d\"C:=0\n", (int) i);
+   }
+   //Same name as a provide port, the provide port is found first
+   pNext += sprintf(pNext, "R\"Provide7\"C:=0\n");
+   assert( (size_t) (pNext - definition) < definitionSize);
+   nodeInfo = apx_nodeInfo_make_from_cstr(definition, APX_CLIENT_MODE);
+   CuAssertPtrNotNull(tc, nodeInfo);
+   for (i = numPorts - 1; i >= 0; i--)
+   {
+      sprintf(name, "Provide%d", (int) i);
+      CuAssertUIntEquals(tc, APX_PORT_ID_PROVIDE_PORT | (apx_uniquePortId_t) i, apx_nodeInfo_findPortIdByName(nodeInfo, name));
+      sprintf(name, "Require%d", (int) i);
+      CuAssertUIntEquals(tc, (apx_uniquePortId_t) i, apx_nodeInfo_findPortIdByName(nodeInfo, name));
+   }
+   CuAssertUIntEquals(tc, APX_INVALID_PORT_ID, apx_nodeInfo_findPortIdByName(nodeInfo, "Provide"));
+   CuAssertUIntEquals(tc, APX_INVALID_PORT_ID, apx_nodeInfo_findPortIdByName(nodeInfo, "Provide10000"));
+   CuAssertUIntEquals(tc, APX_INVALID_PORT_ID, apx_nodeInfo_findPortIdByName(nodeInfo, ""));
+   apx_nodeInfo_delete(nodeInfo);
+   free(definition);
+}
+
 static void test_apx_nodeInfo_getRequirePortName(CuTest *tc)
 {
    adt_str_t *portName;
@@ -257,3 +303,96 @@ static void test_apx_nodeInfo_getProvidePortName(CuTest *tc)
 
    apx_nodeInfo_delete(nodeInfo);
 }
+
+static void test_apx_nodeInfo_copyPlans(CuTest *tc)
+{
+   const char *apx_node1 = "APX/1.2\n"
+   "N\"Node\"\n"
+   "P\"Flat\"{\"A\"S\"B\"C[4]}\n"
+   "P\"Dyn\"C[8*]\n"
+   "R\"Speed\"S\n";
+   const apx_copyPlan_t *plan;
+   const apx_copyRun_t *run;
+   apx_nodeInfo_t *nodeInfo = apx_nodeInfo_make_from_cstr(apx_node1, APX_CLIENT_MODE);
+   CuAssertPtrNotNull(tc, nodeInfo);
+   plan = apx_nodeInfo_getProvidePortPackPlan(nodeInfo, 0);
+   CuAssertPtrNotNull(tc, plan);
+   CuAssertUIntEquals(tc, 2, apx_copyPlan_length(plan));
+   CuAssertUIntEquals(tc, 6, apx_copyPlan_getDataSize(plan));
+   run = apx_copyPlan_getRun(plan, 1);
+   CuAssertPtrNotNull(tc, run);
+   CuAssertUIntEquals(tc, 2, run->dataOffset);
+   CuAssertUIntEquals(tc, 1, run->width);
+   CuAssertUIntEquals(tc, 4, run->count);
+   CuAssertPtrEquals(tc, 0, (void*) apx_nodeInfo_getProvidePortPackPlan(nodeInfo, 1));
+   plan = apx_nodeInfo_getRequirePortUnpackPlan(nodeInfo, 0);
+   CuAssertPtrNotNull(tc, plan);
+   CuAssertUIntEquals(tc, 1, apx_copyPlan_length(plan));
+   CuAssertPtrEquals(tc, 0, (void*) apx_nodeInfo_getRequirePortUnpackPlan(nodeInfo, 1));
+   apx_nodeInfo_delete(nodeInfo);
+
+   nodeInfo = apx_nodeInfo_make_from_cstr(apx_node1, APX_SERVER_MODE);
+   CuAssertPtrNotNull(tc, nodeInfo);
+   CuAssertPtrEquals(tc, 0, (void*) apx_nodeInfo_getProvidePortPackPlan(nodeInfo, 0));
+   apx_nodeInfo_delete(nodeInfo);
+}
+
+static void test_apx_nodeInfo_dynamicArrayUsedDataSize(CuTest *tc)
+{
+   const char *apx_node1 = "APX/1.2\n"
+   "N\"Node\"\n"
+   "P\"DynU8\"C[8*]\n"
+   "P\"DynU16\"S[300*]\n"
+   "P\"Fix\"C[4]\n";
+   uint8_t data[UINT16_SIZE + UINT16_SIZE*3u] = {0x03, 0x11, 0x22, 0x33, 0x44, 0x55, 0x66, 0x77};
+   uint8_t header[UINT32_SIZE] = {0u, 0u, 0u, 0u};
+   const apx_portDataProps_t *props;
+   apx_nodeInfo_t *nodeInfo = apx_nodeInfo_make_from_cstr(apx_node1, APX_CLIENT_MODE);
+   CuAssertPtrNotNull(tc, nodeInfo);
+
+   props = apx_nodeInfo_getProvidePortDataProps(nodeInfo, 0);
+   CuAssertPtrNotNull(tc, props);
+   CuAssertTrue(tc, props->isDynamicArray);
+   CuAssertIntEquals(tc, APX_DYN_LEN_U8, props->dynLenType);
+   CuAssertUIntEquals(tc, UINT8_SIZE + 8u, props->dataSize);
+   CuAssertUIntEquals(tc, UINT8_SIZE, props->arrayElementSize);
+   CuAssertUIntEquals(tc, UINT8_SIZE, apx_portDataProps_getDynLenSize(props));
+   CuAssertUIntEquals(tc, UINT8_SIZE + 3u, apx_portDataProps_getUsedDataSize(props, &data[0], sizeof(data)));
+   data[0] = 0u;
+   CuAssertUIntEquals(tc, UINT8_SIZE, apx_portDataProps_getUsedDataSize(props, &data[0], sizeof(data)));
+   data[0] = 8u;
+   CuAssertUIntEquals(tc, props->dataSize, apx_portDataProps_getUsedDataSize(props, &data[0], sizeof(data)));
+   //An array length larger than the maximum falls back to the full port size
+   data[0] = 9u;
+   CuAssertUIntEquals(tc, props->dataSize, apx_portDataProps_getUsedDataSize(props, &data[0], sizeof(data)));
+   //So does a write that does not include the length header
+   CuAssertUIntEquals(tc, props->dataSize, apx_portDataProps_getUsedDataSize(props, &data[0], 0u));
+
+   props = apx_nodeInfo_getProvidePortDataProps(nodeInfo, 1);
+   CuAssertPtrNotNull(tc, props);
+   CuAssertTrue(tc, props->isDynamicArray);
+   CuAssertIntEquals(tc, APX_DYN_LEN_U16, props->dynLenType);
+   CuAssertUIntEquals(tc, UINT16_SIZE + UINT16_SIZE*300u, props->dataSize);
+   CuAssertUIntEquals(tc, UINT16_SIZE, props->arrayElementSize);
+   packLE(&data[0], 3u, UINT16_SIZE);
+   CuAssertUIntEquals(tc, UINT16_SIZE + UINT16_SIZE*3u, apx_portDataProps_getUsedDataSize(props, &data[0], sizeof(data)));
+   packLE(&data[0], 301u, UINT16_SIZE);
+   CuAssertUIntEquals(tc, props->dataSize, apx_portDataProps_getUsedDataSize(props, &data[0], sizeof(data)));
+   CuAssertUIntEquals(tc, props->dataSize, apx_portDataProps_getUsedDataSize(props, &data[0], UINT8_SIZE));
+
+   props = apx_nodeInfo_getProvidePortDataProps(nodeInfo, 2);
+   CuAssertPtrNotNull(tc, props);
+   CuAssertTrue(tc, !props->isDynamicArray);
+   CuAssertUIntEquals(tc, 0u, apx_portDataProps_getDynLenSize(props));
+   CuAssertUIntEquals(tc, 4u, apx_portDataProps_getUsedDataSize(props, &data[0], 4u));
+   apx_nodeInfo_delete(nodeInfo);
+
+   packLE(&header[0], 5u, UINT32_SIZE);
+   CuAssertUIntEquals(tc, UINT32_SIZE + 5u*4u, apx_portDataProps_calcDynArrayDataSize(APX_DYN_LEN_U32, 4u, UINT32_SIZE + 10u*4u, &header[0], UINT32_SIZE));
+   packLE(&header[0], 11u, UINT32_SIZE);
+   CuAssertUIntEquals(tc, UINT32_SIZE + 10u*4u, apx_portDataProps_calcDynArrayDataSize(APX_DYN_LEN_U32, 4u, UINT32_SIZE + 10u*4u, &header[0], UINT32_SIZE));
+   packLE(&header[0], 0xFFFFFFFFu, UINT32_SIZE);
+   CuAssertUIntEquals(tc, UINT32_SIZE + 10u*4u, apx_portDataProps_calcDynArrayDataSize(APX_DYN_LEN_U32, 4u, UINT32_SIZE + 10u*4u, &header[0], UINT32_SIZE));
+   CuAssertUIntEquals(tc, 40u, apx_portDataProps_calcDynArrayDataSize(APX_DYN_LEN_NONE, 4u, 40u, &header[0], UINT32_SIZE));
+   CuAssertUIntEquals(tc, 40u, apx_portDataProps_calcDynArrayDataSize(APX_DYN_LEN_U32, 0u, 40u, &header[0], UINT32_SIZE));
+}
@@ -34,6 +34,7 @@
 #include "apx_nodeInstance.h"
 #include "apx_test_nodes.h"
 #include "rmf.h"
+#include "pack.h"
 #ifdef MEM_LEAK_CHECK
 #include "CMemLeak.h"
 #endif
@@ -50,6 +51,9 @@ static void test_apx_nodeInstance_manuallyCreateClientNodeUsingAPI(CuTest *tc);
 static void test_apx_nodeInstance_manuallyCreateServerNodeUsingAPI(CuTest *tc);
 static void test_apx_nodeInstance_buildPortReferences(CuTest *tc);
 static void test_apx_nodeInstance_buildConnectorTable(CuTest *tc);
+static void test_apx_nodeInstance_routeMultiPortWriteUsingRoutingPlan(CuTest *tc);
+static void test_apx_nodeInstance_routeDynamicArrayWriteUpToUsedLength(CuTest *tc);
+static apx_nodeInstance_t *create_server_node_instance(CuTest *tc, apx_parser_t *parser, const char *apx_text);
 
 //////////////////////////////////////////////////////////////////////////////
 // PRIVATE VARIABLES
@@ -66,6 +70,8 @@ CuSuite* testSuite_apx_nodeInstance(void)
    SUITE_ADD_TEST(suite, test_apx_nodeInstance_manuallyCreateServerNodeUsingAPI);
    SUITE_ADD_TEST(suite, test_apx_nodeInstance_buildPortReferences);
    SUITE_ADD_TEST(suite, test_apx_nodeInstance_buildConnectorTable);
+   SUITE_ADD_TEST(suite, test_apx_nodeInstance_routeMultiPortWriteUsingRoutingPlan);
+   SUITE_ADD_TEST(suite, test_apx_nodeInstance_routeDynamicArrayWriteUpToUsedLength);
 
    return suite;
 }
@@ -202,3 +208,145 @@ static void test_apx_nodeInstance_buildConnectorTable(CuTest *tc)
    apx_nodeInstance_delete(inst);
 
 }
+
+static void test_apx_nodeInstance_routeMultiPortWriteUsingRoutingPlan(CuTest *tc)
+{
+   const char *provide_text = "APX/1.2\n"
+         "N\"Provider\"\n"
+         "P\"A\"C:=0\n"
+         "P\"B\"S:=0\n"
+         "P\"C\"L:=0\n";
+   const char *require_text = "APX/1.2\n"
+         "N\"Requester\"\n"
+         "R\"C\"L:=0\n"
+         "R\"A\"C:=0\n";
+   const uint8_t writeData[7] = {0x11, 0x22, 0x33, 0x44, 0x55, 0x66, 0x77};
+   uint8_t requireData[5];
+   apx_nodeInstance_t *provideNode;
+   apx_nodeInstance_t *requireNode;
+   const apx_routingPlan_t *routingPlan;
+   apx_routingStats_t routingStats;
+   apx_parser_t *parser = apx_parser_new();
+
+   provideNode = create_server_node_instance(tc, parser, provide_text);
+   requireNode = create_server_node_instance(tc, parser, require_text);
+   CuAssertPtrEquals(tc, NULL, (void*) apx_nodeInstance_getRoutingPlan(provideNode));
+
+   apx_nodeInstance_lockPortConnectorTable(provideNode);
+   CuAssertIntEquals(tc, APX_NO_ERROR, apx_nodeInstance_insertProvidePortConnector(provideNode, 0, apx_nodeInstance_getRequirePortRef(requireNode, 1)));
+   CuAssertIntEquals(tc, APX_NO_ERROR, apx_nodeInstance_insertProvidePortConnector(provideNode, 2, apx_nodeInstance_getRequirePortRef(requireNode, 0)));
+   apx_nodeInstance_unlockPortConnectorTable(provideNode);
+   routingPlan = apx_nodeInstance_getRoutingPlan(provideNode);
+   CuAssertPtrNotNull(tc, routingPlan);
+   CuAssertUIntEquals(tc, 2u, apx_routingPlan_getNumPorts(routingPlan));
+   CuAssertUIntEquals(tc, 2u, apx_routingPlan_getNumEntries(routingPlan));
+   CuAssertUIntEquals(tc, 0u, apx_routingPlan_findFirstPort(routingPlan, 0u));
+   CuAssertUIntEquals(tc, 1u, apx_routingPlan_findFirstPort(routingPlan, 1u));
+   CuAssertUIntEquals(tc, 2u, apx_routingPlan_findFirstPort(routingPlan, 7u));
+
+   //A single write covering all three provide ports
+   CuAssertIntEquals(tc, APX_NO_ERROR, apx_nodeInstance_routeProvidePortDataToReceivers(provideNode, &writeData[0], 0u, sizeof(writeData)));
+   CuAssertIntEquals(tc, APX_NO_ERROR, apx_nodeInstance_readRequirePortData(requireNode, &requireData[0], 0u, sizeof(requireData)));
+   CuAssertUIntEquals(tc, 0x77665544, unpackLE(&requireData[0], UINT32_SIZE));
+   CuAssertUIntEquals(tc, 0x11, requireData[4]);
+   //Both ports are adjacent in the receiving node and are sent as a single write
+   apx_nodeInstance_getRoutingStats(provideNode, &routingStats);
+   CuAssertUIntEquals(tc, 2u, routingStats.numRoutedWrites);
+   CuAssertUIntEquals(tc, 1u, routingStats.numTransmittedWrites);
+   CuAssertUIntEquals(tc, 1u, routingStats.numSourceWrites);
+   CuAssertUIntEquals(tc, 7u, (uint32_t) routingStats.numSourceBytes);
+   CuAssertUIntEquals(tc, 5u, (uint32_t) routingStats.numRoutedBytes);
+   CuAssertUIntEquals(tc, 2u, routingStats.maxFanOut);
+
+   //Write to unconnected port is silently ignored
+   CuAssertIntEquals(tc, APX_NO_ERROR, apx_nodeInstance_routeProvidePortDataToReceivers(provideNode, &writeData[0], 1u, UINT16_SIZE));
+   apx_nodeInstance_getRoutingStats(provideNode, &routingStats);
+   CuAssertUIntEquals(tc, 2u, routingStats.numSourceWrites);
+   CuAssertUIntEquals(tc, 9u, (uint32_t) routingStats.numSourceBytes);
+   CuAssertUIntEquals(tc, 5u, (uint32_t) routingStats.numRoutedBytes);
+
+   //Writes outside of provide port data are rejected
+   CuAssertIntEquals(tc, APX_LENGTH_ERROR, apx_nodeInstance_routeProvidePortDataToReceivers(provideNode, &writeData[0], 6u, UINT16_SIZE));
+   CuAssertIntEquals(tc, APX_LENGTH_ERROR, apx_nodeInstance_routeProvidePortDataToReceivers(provideNode, &writeData[0], 0u, sizeof(writeData) + 1u));
+   CuAssertIntEquals(tc, APX_LENGTH_ERROR, apx_nodeInstance_routeProvidePortDataToReceivers(provideNode, &writeData[0], 0xFFFFFFFFu, UINT16_SIZE));
+   apx_nodeInstance_getRoutingStats(provideNode, &routingStats);
+   CuAssertUIntEquals(tc, 2u, routingStats.numSourceWrites);
+
+   apx_nodeInstance_lockPortConnectorTable(provideNode);
+   CuAssertIntEquals(tc, APX_NO_ERROR, apx_nodeInstance_removeProvidePortConnector(provideNode, 0, apx_nodeInstance_getRequirePortRef(requireNode, 1)));
+   apx_nodeInstance_unlockPortConnectorTable(provideNode);
+   routingPlan = apx_nodeInstance_getRoutingPlan(provideNode);
+   CuAssertPtrNotNull(tc, routingPlan);
+   CuAssertUIntEquals(tc, 1u, apx_routingPlan_getNumPorts(routingPlan));
+
+   apx_nodeInstance_clearConnectorTable(provideNode);
+   CuAssertPtrEquals(tc, NULL, (void*) apx_nodeInstance_getRoutingPlan(provideNode));
+
+   apx_parser_delete(parser);
+   apx_nodeInstance_delete(provideNode);
+   apx_nodeInstance_delete(requireNode);
+}
+
+static void test_apx_nodeInstance_routeDynamicArrayWriteUpToUsedLength(CuTest *tc)
+{
+   const char *provide_text = "APX/1.2\n"
+         "N\"Provider\"\n"
+         "P\"A\"C:=0\n"
+         "P\"Dyn\"C[8*]\n";
+   const char *require_text = "APX/1.2\n"
+         "N\"Requester\"\n"
+         "R\"Dyn\"C[8*]\n";
+   const uint8_t fullWrite[10] = {0x00, 0x09, 0xA1, 0xA2, 0xA3, 0xA4, 0xA5, 0xA6, 0xA7, 0xA8};
+   const uint8_t usedWrite[10] = {0x00, 0x03, 0x01, 0x02, 0x03, 0xB4, 0xB5, 0xB6, 0xB7, 0xB8};
+   const uint8_t expectedData[9] = {0x03, 0x01, 0x02, 0x03, 0xA4, 0xA5, 0xA6, 0xA7, 0xA8};
+   uint8_t requireData[9];
+   apx_nodeInstance_t *provideNode;
+   apx_nodeInstance_t *requireNode;
+   apx_routingStats_t routingStats;
+   apx_parser_t *parser = apx_parser_new();
+
+   provideNode = create_server_node_instance(tc, parser, provide_text);
+   requireNode = create_server_node_instance(tc, parser, require_text);
+   apx_nodeInstance_lockPortConnectorTable(provideNode);
+   CuAssertIntEquals(tc, APX_NO_ERROR, apx_nodeInstance_insertProvidePortConnector(provideNode, 1, apx_nodeInstance_getRequirePortRef(requireNode, 0)));
+   apx_nodeInstance_unlockPortConnectorTable(provideNode);
+   CuAssertPtrNotNull(tc, (void*) apx_nodeInstance_getRoutingPlan(provideNode));
+
+   //An array length larger than the maximum can't be trusted, the whole port is routed
+   CuAssertIntEquals(tc, APX_NO_ERROR, apx_nodeInstance_routeProvidePortDataToReceivers(provideNode, &fullWrite[0], 0u, sizeof(fullWrite)));
+   CuAssertIntEquals(tc, APX_NO_ERROR, apx_nodeInstance_readRequirePortData(requireNode, &requireData[0], 0u, sizeof(requireData)));
+   CuAssertIntEquals(tc, 0, memcmp(&fullWrite[1], &requireData[0], sizeof(requireData)));
+   apx_nodeInstance_getRoutingStats(provideNode, &routingStats);
+   CuAssertUIntEquals(tc, 9u, (uint32_t) routingStats.numRoutedBytes);
+
+   //Only the array length and the three used elements are routed, the unused part of the receiver is left as is
+   CuAssertIntEquals(tc, APX_NO_ERROR, apx_nodeInstance_routeProvidePortDataToReceivers(provideNode, &usedWrite[0], 0u, sizeof(usedWrite)));
+   CuAssertIntEquals(tc, APX_NO_ERROR, apx_nodeInstance_readRequirePortData(requireNode, &requireData[0], 0u, sizeof(requireData)));
+   CuAssertIntEquals(tc, 0, memcmp(&expectedData[0], &requireData[0], sizeof(requireData)));
+   apx_nodeInstance_getRoutingStats(provideNode, &routingStats);
+   CuAssertUIntEquals(tc, 2u, routingStats.numSourceWrites);
+   CuAssertUIntEquals(tc, 20u, (uint32_t) routingStats.numSourceBytes);
+   CuAssertUIntEquals(tc, 13u, (uint32_t) routingStats.numRoutedBytes);
+
+   apx_nodeInstance_clearConnectorTable(provideNode);
+   apx_parser_delete(parser);
+   apx_nodeInstance_delete(provideNode);
+   apx_nodeInstance_delete(requireNode);
+}
+
+static apx_nodeInstance_t *create_server_node_instance(CuTest *tc, apx_parser_t *parser, const char *apx_text)
+{
+   apx_programType_t errProgramType;
+   apx_uniquePortId_t errPortId;
+   apx_size_t apx_len = (apx_size_t) strlen(apx_text);
+   apx_nodeInstance_t *inst = apx_nodeInstance_new(APX_SERVER_MODE);
+   CuAssertPtrNotNull(tc, inst);
+   CuAssertIntEquals(tc, APX_NO_ERROR, apx_nodeInstance_createDefinitionBuffer(inst, apx_len));
+   CuAssertIntEquals(tc, APX_NO_ERROR, apx_nodeInstance_writeDefinitionData(inst, (const uint8_t*) apx_text, 0u, apx_len));
+   CuAssertIntEquals(tc, APX_NO_ERROR, apx_nodeInstance_parseDefinition(inst, parser));
+   CuAssertIntEquals(tc, APX_NO_ERROR, apx_nodeInstance_buildNodeInfo(inst, &errProgramType, &errPortId));
+   CuAssertIntEquals(tc, APX_NO_ERROR, apx_nodeInstance_createPortDataBuffers(inst));
+   CuAssertIntEquals(tc, APX_NO_ERROR, apx_nodeInstance_buildPortRefs(inst));
+   CuAssertIntEquals(tc, APX_NO_ERROR, apx_nodeInstance_buildConnectorTable(inst));
+   return inst;
+}
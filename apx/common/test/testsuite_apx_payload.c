@@ -0,0 +1,94 @@
+/*****************************************************************************
+* \file      testsuite_apx_payload.c
+* \author    Conny Gustafsson
+* \date      2026-10-18
+* \brief     Unit tests for apx_payload
+*
+* Copyright (c) 2026 Conny Gustafsson
+* Permission is hereby granted, free of charge, to any person obtaining a copy of
+* this software and associated documentation files (the "Software"), to deal in
+* the Software without restriction, including without limitation the rights to
+* use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+* the Software, and to permit persons to whom the Software is furnished to do so,
+* subject to the following conditions:
+
+* The above copyright notice and this permission notice shall be included in all
+* copies or substantial portions of the Software.
+
+* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+* IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+* FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+* COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+* IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+* CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+*
+******************************************************************************/
+//////////////////////////////////////////////////////////////////////////////
+// INCLUDES
+//////////////////////////////////////////////////////////////////////////////
+#include <stddef.h>
+#include <stdio.h>
+#include <string.h>
+#include "CuTest.h"
+#include "apx_payload.h"
+#ifdef MEM_LEAK_CHECK
+#include "CMemLeak.h"
+#endif
+
+//////////////////////////////////////////////////////////////////////////////
+// PRIVATE CONSTANTS AND DATA TYPES
+//////////////////////////////////////////////////////////////////////////////
+
+//////////////////////////////////////////////////////////////////////////////
+// PRIVATE FUNCTION PROTOTYPES
+//////////////////////////////////////////////////////////////////////////////
+static void test_apx_payload_new(CuTest* tc);
+static void test_apx_payload_retainRelease(CuTest* tc);
+
+//////////////////////////////////////////////////////////////////////////////
+// PRIVATE VARIABLES
+//////////////////////////////////////////////////////////////////////////////
+
+//////////////////////////////////////////////////////////////////////////////
+// PUBLIC FUNCTIONS
+//////////////////////////////////////////////////////////////////////////////
+CuSuite* testSuite_apx_payload(void)
+{
+   CuSuite* suite = CuSuiteNew();
+
+   SUITE_ADD_TEST(suite, test_apx_payload_new);
+   SUITE_ADD_TEST(suite, test_apx_payload_retainRelease);
+
+   return suite;
+}
+
+//////////////////////////////////////////////////////////////////////////////
+// PRIVATE FUNCTIONS
+//////////////////////////////////////////////////////////////////////////////
+static void test_apx_payload_new(CuTest* tc)
+{
+   uint8_t data[4] = {0x01, 0x02, 0x03, 0x04};
+   apx_payload_t *payload = apx_payload_new(&data[0], sizeof(data));
+   CuAssertPtrNotNull(tc, payload);
+   data[0] = 0xFF; //payload owns a copy of data
+   CuAssertUIntEquals(tc, sizeof(data), apx_payload_getDataLen(payload));
+   CuAssertUIntEquals(tc, 1u, apx_payload_getRefCount(payload));
+   CuAssertUIntEquals(tc, 0x01, apx_payload_getData(payload)[0]);
+   CuAssertUIntEquals(tc, 0x04, apx_payload_getData(payload)[3]);
+   apx_payload_release(payload);
+   CuAssertPtrEquals(tc, 0, apx_payload_new( (const uint8_t*) 0, 4u));
+}
+
+static void test_apx_payload_retainRelease(CuTest* tc)
+{
+   uint8_t data[2] = {0x12, 0x34};
+   apx_payload_t *payload = apx_payload_new(&data[0], sizeof(data));
+   CuAssertPtrNotNull(tc, payload);
+   apx_payload_retain(payload);
+   apx_payload_retain(payload);
+   CuAssertUIntEquals(tc, 3u, apx_payload_getRefCount(payload));
+   apx_payload_release(payload);
+   apx_payload_release(payload);
+   CuAssertUIntEquals(tc, 1u, apx_payload_getRefCount(payload));
+   apx_payload_release(payload);
+}
@@ -0,0 +1,318 @@
+/*****************************************************************************
+* \file      testsuite_apx_portQueue.c
+* \author    Conny Gustafsson
+* \date      2026-10-18
+* \brief     Unit tests for apx_portQueue
+*
+* Copyright (c) 2026 Conny Gustafsson
+* Permission is hereby granted, free of charge, to any person obtaining a copy of
+* this software and associated documentation files (the "Software"), to deal in
+* the Software without restriction, including without limitation the rights to
+* use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+* the Software, and to permit persons to whom the Software is furnished to do so,
+* subject to the following conditions:
+
+* The above copyright notice and this permission notice shall be included in all
+* copies or substantial portions of the Software.
+
+* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+* IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+* FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+* COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+* IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+* CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+*
+******************************************************************************/
+//////////////////////////////////////////////////////////////////////////////
+// INCLUDES
+//////////////////////////////////////////////////////////////////////////////
+#include <stddef.h>
+#include <stdio.h>
+#include <string.h>
+#include "CuTest.h"
+#include "apx_portQueue.h"
+#include "apx_atomic.h"
+#include "osmacro.h"
+#ifdef MEM_LEAK_CHECK
+#include "CMemLeak.h"
+#endif
+
+//////////////////////////////////////////////////////////////////////////////
+// PRIVATE CONSTANTS AND DATA TYPES
+//////////////////////////////////////////////////////////////////////////////
+#define NUM_CONCURRENT_WRITERS 2
+#define NUM_ELEMENTS_PER_WRITER 2000u
+
+typedef struct queueWriter_tag
+{
+   apx_portQueue_t *queue;
+   uint16_t writerBit; //element value is writerBit | sequence number
+   apx_error_t lastError;
+} queueWriter_t;
+
+typedef struct queueReader_tag
+{
+   apx_portQueue_t *queue;
+   volatile uint32_t *totalRead; //shared by all readers
+   uint16_t lastSequence[NUM_CONCURRENT_WRITERS];
+   uint32_t numOutOfOrder;
+} queueReader_t;
+
+//////////////////////////////////////////////////////////////////////////////
+// PRIVATE FUNCTION PROTOTYPES
+//////////////////////////////////////////////////////////////////////////////
+static void test_apx_portQueue_create(CuTest* tc);
+static void test_apx_portQueue_packTransferLimitedByQueueLength(CuTest* tc);
+static void test_apx_portQueue_unpackTransfer(CuTest* tc);
+static void test_apx_portQueue_dropWhenFull(CuTest* tc);
+static void test_apx_portQueue_requestTransferOnlyOnce(CuTest* tc);
+static void test_apx_portQueue_concurrentWritersAndReaders(CuTest* tc);
+static THREAD_PROTO(queueWriterThread, arg);
+static THREAD_PROTO(queueReaderThread, arg);
+static void queueReader_run(queueReader_t *reader);
+
+//////////////////////////////////////////////////////////////////////////////
+// PRIVATE VARIABLES
+//////////////////////////////////////////////////////////////////////////////
+
+//////////////////////////////////////////////////////////////////////////////
+// PUBLIC FUNCTIONS
+//////////////////////////////////////////////////////////////////////////////
+CuSuite* testSuite_apx_portQueue(void)
+{
+   CuSuite* suite = CuSuiteNew();
+
+   SUITE_ADD_TEST(suite, test_apx_portQueue_create);
+   SUITE_ADD_TEST(suite, test_apx_portQueue_packTransferLimitedByQueueLength);
+   SUITE_ADD_TEST(suite, test_apx_portQueue_unpackTransfer);
+   SUITE_ADD_TEST(suite, test_apx_portQueue_dropWhenFull);
+   SUITE_ADD_TEST(suite, test_apx_portQueue_requestTransferOnlyOnce);
+   SUITE_ADD_TEST(suite, test_apx_portQueue_concurrentWritersAndReaders);
+
+   return suite;
+}
+
+//////////////////////////////////////////////////////////////////////////////
+// PRIVATE FUNCTIONS
+//////////////////////////////////////////////////////////////////////////////
+static void test_apx_portQueue_create(CuTest* tc)
+{
+   apx_portDataProps_t props;
+   apx_portQueue_t queue;
+   apx_portDataProps_create(&props, APX_PROVIDE_PORT, 0, 0u, UINT16_SIZE);
+   CuAssertIntEquals(tc, APX_INVALID_ARGUMENT_ERROR, apx_portQueue_create(&queue, &props, 4u));
+   apx_portDataProps_setQueued(&props, 10u);
+   CuAssertUIntEquals(tc, APX_QUE_LEN_U8, props.queLenType);
+   CuAssertUIntEquals(tc, UINT16_SIZE, props.elementSize);
+   CuAssertUIntEquals(tc, UINT8_SIZE + 10u * UINT16_SIZE, props.dataSize);
+   CuAssertIntEquals(tc, APX_NO_ERROR, apx_portQueue_create(&queue, &props, 4u));
+   CuAssertUIntEquals(tc, 64u, apx_portQueue_capacity(&queue));
+   CuAssertUIntEquals(tc, UINT16_SIZE, apx_portQueue_elementSize(&queue));
+   CuAssertUIntEquals(tc, 0u, apx_portQueue_getTransferSize(&queue));
+   apx_portQueue_destroy(&queue);
+   apx_portDataProps_setQueued(&props, 300u);
+   CuAssertUIntEquals(tc, APX_QUE_LEN_U16, props.queLenType);
+   CuAssertUIntEquals(tc, UINT16_SIZE + 300u * UINT16_SIZE, props.dataSize);
+}
+
+static void test_apx_portQueue_packTransferLimitedByQueueLength(CuTest* tc)
+{
+   apx_portDataProps_t props;
+   apx_portQueue_t queue;
+   uint8_t buf[1 + 3 * 2];
+   uint16_t value;
+   apx_portDataProps_create(&props, APX_PROVIDE_PORT, 0, 0u, UINT16_SIZE);
+   apx_portDataProps_setQueued(&props, 3u);
+   CuAssertIntEquals(tc, APX_NO_ERROR, apx_portQueue_create(&queue, &props, 4u));
+   for (value = 1u; value <= 5u; value++)
+   {
+      uint8_t element[UINT16_SIZE] = {(uint8_t) value, 0u};
+      CuAssertIntEquals(tc, APX_NO_ERROR, apx_portQueue_push(&queue, element));
+   }
+   CuAssertUIntEquals(tc, 7u, apx_portQueue_getTransferSize(&queue));
+   CuAssertUIntEquals(tc, 7u, apx_portQueue_packTransfer(&queue, buf, sizeof(buf)));
+   CuAssertUIntEquals(tc, 3u, buf[0]);
+   CuAssertUIntEquals(tc, 1u, buf[1]);
+   CuAssertUIntEquals(tc, 2u, buf[3]);
+   CuAssertUIntEquals(tc, 3u, buf[5]);
+   //remaining elements go out with the next transfer
+   CuAssertUIntEquals(tc, 5u, apx_portQueue_getTransferSize(&queue));
+   //a smaller destination buffer limits the number of elements
+   CuAssertUIntEquals(tc, 3u, apx_portQueue_packTransfer(&queue, buf, 4u));
+   CuAssertUIntEquals(tc, 1u, buf[0]);
+   CuAssertUIntEquals(tc, 4u, buf[1]);
+   CuAssertUIntEquals(tc, 3u, apx_portQueue_packTransfer(&queue, buf, sizeof(buf)));
+   CuAssertUIntEquals(tc, 5u, buf[1]);
+   CuAssertUIntEquals(tc, 0u, apx_portQueue_getTransferSize(&queue));
+   apx_portQueue_destroy(&queue);
+}
+
+static void test_apx_portQueue_unpackTransfer(CuTest* tc)
+{
+   apx_portDataProps_t props;
+   apx_portQueue_t queue;
+   const uint8_t transfer[] = {2u, 0x11, 0x22, 0x33, 0x44};
+   const uint8_t tooLong[] = {3u, 0x11, 0x22, 0x33, 0x44};
+   uint8_t buf[8];
+   apx_portDataProps_create(&props, APX_REQUIRE_PORT, 0, 0u, UINT16_SIZE);
+   apx_portDataProps_setQueued(&props, 4u);
+   CuAssertIntEquals(tc, APX_NO_ERROR, apx_portQueue_create(&queue, &props, 1u));
+   CuAssertIntEquals(tc, APX_LENGTH_ERROR, apx_portQueue_unpackTransfer(&queue, tooLong, sizeof(tooLong)));
+   CuAssertIntEquals(tc, APX_NO_ERROR, apx_portQueue_unpackTransfer(&queue, transfer, sizeof(transfer)));
+   CuAssertUIntEquals(tc, 2u, apx_portQueue_length(&queue));
+   CuAssertUIntEquals(tc, 2u, apx_portQueue_read(&queue, buf, 4u));
+   CuAssertUIntEquals(tc, 0x11, buf[0]);
+   CuAssertUIntEquals(tc, 0x44, buf[3]);
+   apx_portQueue_destroy(&queue);
+}
+
+static void test_apx_portQueue_dropWhenFull(CuTest* tc)
+{
+   apx_portDataProps_t props;
+   apx_portQueue_t queue;
+   const uint8_t transfer[] = {3u, 1u, 2u, 3u};
+   uint8_t element = 0u;
+   apx_portDataProps_create(&props, APX_REQUIRE_PORT, 0, 0u, UINT8_SIZE);
+   apx_portDataProps_setQueued(&props, 4u);
+   CuAssertIntEquals(tc, APX_NO_ERROR, apx_portQueue_create(&queue, &props, 1u));
+   CuAssertIntEquals(tc, APX_NO_ERROR, apx_portQueue_push(&queue, &element));
+   CuAssertIntEquals(tc, APX_NO_ERROR, apx_portQueue_push(&queue, &element));
+   CuAssertIntEquals(tc, APX_NO_ERROR, apx_portQueue_unpackTransfer(&queue, transfer, sizeof(transfer)));
+   CuAssertUIntEquals(tc, 4u, apx_portQueue_length(&queue));
+   CuAssertUIntEquals(tc, 1u, apx_portQueue_getNumDroppedElements(&queue));
+   CuAssertIntEquals(tc, APX_QUEUE_FULL_ERROR, apx_portQueue_push(&queue, &element));
+   CuAssertUIntEquals(tc, 2u, apx_portQueue_getNumDroppedElements(&queue));
+   apx_portQueue_destroy(&queue);
+}
+
+static void test_apx_portQueue_requestTransferOnlyOnce(CuTest* tc)
+{
+   apx_portDataProps_t props;
+   apx_portQueue_t *queue;
+   apx_portDataProps_create(&props, APX_PROVIDE_PORT, 0, 0u, UINT32_SIZE);
+   apx_portDataProps_setQueued(&props, 2u);
+   queue = apx_portQueue_new(&props, 2u);
+   CuAssertPtrNotNull(tc, queue);
+   CuAssertTrue(tc, apx_portQueue_requestTransfer(queue));
+   CuAssertTrue(tc, !apx_portQueue_requestTransfer(queue));
+   apx_portQueue_completeTransfer(queue);
+   CuAssertTrue(tc, apx_portQueue_requestTransfer(queue));
+   apx_portQueue_delete(queue);
+}
+
+/**
+ * Two threads push into the same queue while two threads drain it. Every element must be read exactly once
+ * and the elements of each writer must come out in the order they were pushed.
+ */
+static void test_apx_portQueue_concurrentWritersAndReaders(CuTest* tc)
+{
+   apx_portDataProps_t props;
+   apx_portQueue_t queue;
+   queueWriter_t writers[NUM_CONCURRENT_WRITERS];
+   queueReader_t readers[2];
+   THREAD_T writerThreads[NUM_CONCURRENT_WRITERS];
+   THREAD_T readerThread;
+   volatile uint32_t totalRead = 0u;
+   int32_t i;
+#ifdef _WIN32
+   unsigned int threadId;
+#endif
+   apx_portDataProps_create(&props, APX_PROVIDE_PORT, 0, 0u, UINT16_SIZE);
+   apx_portDataProps_setQueued(&props, 1000u);
+   CuAssertIntEquals(tc, APX_NO_ERROR, apx_portQueue_create(&queue, &props, 4u));
+   CuAssertTrue(tc, apx_portQueue_capacity(&queue) >= NUM_CONCURRENT_WRITERS * NUM_ELEMENTS_PER_WRITER);
+   memset(readers, 0, sizeof(readers));
+   for (i = 0; i < 2; i++)
+   {
+      readers[i].queue = &queue;
+      readers[i].totalRead = &totalRead;
+   }
+#ifdef _WIN32
+   THREAD_CREATE(readerThread, queueReaderThread, &readers[1], threadId);
+#else
+   CuAssertIntEquals(tc, 0, THREAD_CREATE(readerThread, queueReaderThread, &readers[1]));
+#endif
+   for (i = 0; i < NUM_CONCURRENT_WRITERS; i++)
+   {
+      writers[i].queue = &queue;
+      writers[i].writerBit = (uint16_t) (i << 15);
+      writers[i].lastError = APX_NO_ERROR;
+#ifdef _WIN32
+      THREAD_CREATE(writerThreads[i], queueWriterThread, &writers[i], threadId);
+#else
+      CuAssertIntEquals(tc, 0, THREAD_CREATE(writerThreads[i], queueWriterThread, &writers[i]));
+#endif
+   }
+   queueReader_run(&readers[0]);
+   for (i = 0; i < NUM_CONCURRENT_WRITERS; i++)
+   {
+      THREAD_JOIN(writerThreads[i]);
+      CuAssertIntEquals(tc, APX_NO_ERROR, writers[i].lastError);
+   }
+   THREAD_JOIN(readerThread);
+   CuAssertUIntEquals(tc, NUM_CONCURRENT_WRITERS * NUM_ELEMENTS_PER_WRITER, totalRead);
+   CuAssertUIntEquals(tc, 0u, apx_portQueue_length(&queue));
+   CuAssertUIntEquals(tc, 0u, apx_portQueue_getNumDroppedElements(&queue));
+   for (i = 0; i < 2; i++)
+   {
+      CuAssertUIntEquals(tc, 0u, readers[i].numOutOfOrder);
+   }
+   apx_portQueue_destroy(&queue);
+}
+
+static THREAD_PROTO(queueWriterThread, arg)
+{
+   queueWriter_t *writer = (queueWriter_t*) arg;
+   uint16_t sequence;
+   for (sequence = 1u; sequence <= NUM_ELEMENTS_PER_WRITER; sequence++)
+   {
+      uint8_t element[UINT16_SIZE];
+      uint16_t value = (uint16_t) (writer->writerBit | sequence);
+      element[0] = (uint8_t) value;
+      element[1] = (uint8_t) (value >> 8);
+      if (apx_portQueue_push(writer->queue, element) != APX_NO_ERROR)
+      {
+         writer->lastError = APX_QUEUE_FULL_ERROR;
+      }
+   }
+   THREAD_RETURN(0);
+}
+
+static THREAD_PROTO(queueReaderThread, arg)
+{
+   queueReader_run((queueReader_t*) arg);
+   THREAD_RETURN(0);
+}
+
+/**
+ * Reads small batches until all writers are drained. Sequence numbers of one writer must increase within each batch
+ * and from one batch to the next (a reader never sees an element after a younger one from the same writer).
+ */
+static void queueReader_run(queueReader_t *reader)
+{
+   while (apx_atomic_load32(reader->totalRead) < NUM_CONCURRENT_WRITERS * NUM_ELEMENTS_PER_WRITER)
+   {
+      uint8_t buf[UINT16_SIZE * 8];
+      uint32_t numElements = apx_portQueue_read(reader->queue, buf, 8u);
+      uint32_t i;
+      for (i = 0u; i < numElements; i++)
+      {
+         uint16_t value = (uint16_t) (buf[i * UINT16_SIZE] | (buf[i * UINT16_SIZE + 1] << 8));
+         uint16_t writerIndex = (uint16_t) (value >> 15);
+         uint16_t sequence = (uint16_t) (value & 0x7FFFu);
+         if (sequence <= reader->lastSequence[writerIndex])
+         {
+            reader->numOutOfOrder++;
+         }
+         reader->lastSequence[writerIndex] = sequence;
+      }
+      if (numElements > 0u)
+      {
+         (void) apx_atomic_add32(reader->totalRead, numElements);
+      }
+      else
+      {
+         SLEEP(0);
+      }
+   }
+}
@@ -65,6 +65,7 @@ static void test_apx_portSignatureMap_connectingRequrePortWhenProvidePortsIsAvai
 static void test_apx_portSignatureMap_disconnectingRequirePortWhenConnectedToProvidePort(CuTest* tc);
 static void test_apx_portSignatureMap_disconnectingProvidePortWhenConnectedToRequireProvidePort(CuTest* tc);
 static void test_apx_portSignatureMap_disconnectingProvidePortWhenNotConnectedToAnything(CuTest* tc);
+static void test_apx_portSignatureMap_connectedPortsShareSignatureId(CuTest* tc);
 
 
 
@@ -85,6 +86,7 @@ CuSuite* testSuite_apx_portSignatureMap(void)
    SUITE_ADD_TEST(suite, test_apx_portSignatureMap_disconnectingRequirePortWhenConnectedToProvidePort);
    SUITE_ADD_TEST(suite, test_apx_portSignatureMap_disconnectingProvidePortWhenConnectedToRequireProvidePort);
    SUITE_ADD_TEST(suite, test_apx_portSignatureMap_disconnectingProvidePortWhenNotConnectedToAnything);
+   SUITE_ADD_TEST(suite, test_apx_portSignatureMap_connectedPortsShareSignatureId);
 
 
    return suite;
@@ -469,3 +471,51 @@ static void test_apx_portSignatureMap_disconnectingProvidePortWhenNotConnectedTo
    apx_portSignatureMap_delete(map);
    apx_nodeManager_delete(nodeManager);
 }
+
+static void test_apx_portSignatureMap_connectedPortsShareSignatureId(CuTest* tc)
+{
+   apx_nodeManager_t *nodeManager;
+   apx_nodeInstance_t *nodeInstance1;
+   apx_nodeInstance_t *nodeInstance3;
+   apx_portSignatureMap_t *map;
+   apx_portRef_t *requirePortRef;
+   apx_portRef_t *providePortRef;
+   apx_signatureTableStats_t stats;
+
+   nodeManager = apx_nodeManager_new(APX_SERVER_MODE, false);
+   CuAssertPtrNotNull(tc, nodeManager);
+   map = apx_portSignatureMap_new();
+   CuAssertPtrNotNull(tc, map);
+
+   CuAssertIntEquals(tc, APX_NO_ERROR, apx_nodeManager_buildNode_cstr(nodeManager, m_node_text1));
+   nodeInstance1 = apx_nodeManager_getLastAttached(nodeManager);
+   CuAssertIntEquals(tc, APX_NO_ERROR, apx_nodeManager_buildNode_cstr(nodeManager, m_node_text3));
+   nodeInstance3 = apx_nodeManager_getLastAttached(nodeManager);
+   requirePortRef = apx_nodeInstance_getRequirePortRef(nodeInstance1, 0);
+   providePortRef = apx_nodeInstance_getProvidePortRef(nodeInstance3, 0);
+   CuAssertUIntEquals(tc, APX_INVALID_SIGNATURE_ID, requirePortRef->signatureId);
+
+   CuAssertIntEquals(tc, APX_NO_ERROR, apx_portSignatureMap_connectRequirePorts(map, nodeInstance1));
+   CuAssertIntEquals(tc, APX_NO_ERROR, apx_portSignatureMap_connectProvidePorts(map, nodeInstance3));
+   CuAssertUIntEquals(tc, 0u, requirePortRef->signatureId);
+   CuAssertUIntEquals(tc, 0u, providePortRef->signatureId);
+   CuAssertPtrEquals(tc, apx_portSignatureMap_find(map, "\"VehicleSpeed\"S"), apx_portSignatureMap_findById(map, 0u));
+
+   //Disconnecting uses the stored ID, no more signature lookups are made
+   apx_portSignatureMap_getSignatureTableStats(map, &stats);
+   CuAssertUIntEquals(tc, 1u, stats.numSignatures);
+   CuAssertUIntEquals(tc, 3u, stats.numLookups);
+   CuAssertIntEquals(tc, APX_NO_ERROR, apx_portSignatureMap_disconnectRequirePorts(map, nodeInstance1));
+   CuAssertIntEquals(tc, APX_NO_ERROR, apx_portSignatureMap_disconnectProvidePorts(map, nodeInstance3));
+   apx_portSignatureMap_getSignatureTableStats(map, &stats);
+   CuAssertUIntEquals(tc, 3u, stats.numLookups);
+   CuAssertIntEquals(tc, 0, apx_portSignatureMap_length(map));
+   CuAssertPtrEquals(tc, 0, apx_portSignatureMap_findById(map, 0u));
+   //Signature string is freed once the last port using it is gone
+   CuAssertUIntEquals(tc, 0u, stats.numSignatures);
+   CuAssertUIntEquals(tc, APX_INVALID_SIGNATURE_ID, requirePortRef->signatureId);
+   CuAssertUIntEquals(tc, APX_INVALID_SIGNATURE_ID, providePortRef->signatureId);
+
+   apx_portSignatureMap_delete(map);
+   apx_nodeManager_delete(nodeManager);
+}
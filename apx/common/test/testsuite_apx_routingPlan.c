@@ -0,0 +1,127 @@
+/*****************************************************************************
+* \file      testsuite_apx_routingPlan.c
+* \author    Conny Gustafsson
+* \date      2026-10-18
+* \brief     Unit tests for apx_routingPlan
+*
+* Copyright (c) 2026 Conny Gustafsson
+* Permission is hereby granted, free of charge, to any person obtaining a copy of
+* this software and associated documentation files (the "Software"), to deal in
+* the Software without restriction, including without limitation the rights to
+* use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+* the Software, and to permit persons to whom the Software is furnished to do so,
+* subject to the following conditions:
+
+* The above copyright notice and this permission notice shall be included in all
+* copies or substantial portions of the Software.
+
+* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+* IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+* FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+* COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+* IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+* CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+*
+******************************************************************************/
+//////////////////////////////////////////////////////////////////////////////
+// INCLUDES
+//////////////////////////////////////////////////////////////////////////////
+#include <stddef.h>
+#include <stdio.h>
+#include "CuTest.h"
+#include "apx_routingPlan.h"
+#ifdef MEM_LEAK_CHECK
+#include "CMemLeak.h"
+#endif
+
+//////////////////////////////////////////////////////////////////////////////
+// PRIVATE CONSTANTS AND DATA TYPES
+//////////////////////////////////////////////////////////////////////////////
+
+//////////////////////////////////////////////////////////////////////////////
+// PRIVATE FUNCTION PROTOTYPES
+//////////////////////////////////////////////////////////////////////////////
+static void test_apx_routingPlan_coalesceWritesToSameDestination(CuTest* tc);
+static void test_apx_routingPlan_coalesceWritesToDifferentDestinations(CuTest* tc);
+static void test_apx_routingPlan_coalesceWritesTracksSourceOffset(CuTest* tc);
+
+//////////////////////////////////////////////////////////////////////////////
+// PRIVATE VARIABLES
+//////////////////////////////////////////////////////////////////////////////
+
+//////////////////////////////////////////////////////////////////////////////
+// PUBLIC FUNCTIONS
+//////////////////////////////////////////////////////////////////////////////
+CuSuite* testSuite_apx_routingPlan(void)
+{
+   CuSuite* suite = CuSuiteNew();
+
+   SUITE_ADD_TEST(suite, test_apx_routingPlan_coalesceWritesToSameDestination);
+   SUITE_ADD_TEST(suite, test_apx_routingPlan_coalesceWritesToDifferentDestinations);
+   SUITE_ADD_TEST(suite, test_apx_routingPlan_coalesceWritesTracksSourceOffset);
+
+   return suite;
+}
+
+//////////////////////////////////////////////////////////////////////////////
+// PRIVATE FUNCTIONS
+//////////////////////////////////////////////////////////////////////////////
+static void test_apx_routingPlan_coalesceWritesToSameDestination(CuTest* tc)
+{
+   struct apx_nodeInstance_tag *dest = (struct apx_nodeInstance_tag*) 0x1000;
+   apx_routingWrite_t writes[5] = {
+         {dest, 8u, 4u},
+         {dest, 0u, 1u},
+         {dest, 1u, 2u},
+         {dest, 3u, 1u},
+         {dest, 20u, 2u}
+   };
+   CuAssertUIntEquals(tc, 3u, apx_routingPlan_coalesceWrites(&writes[0], 5u));
+   CuAssertUIntEquals(tc, 0u, writes[0].destOffset);
+   CuAssertUIntEquals(tc, 4u, writes[0].len);
+   CuAssertUIntEquals(tc, 8u, writes[1].destOffset);
+   CuAssertUIntEquals(tc, 4u, writes[1].len);
+   CuAssertUIntEquals(tc, 20u, writes[2].destOffset);
+   CuAssertUIntEquals(tc, 2u, writes[2].len);
+}
+
+static void test_apx_routingPlan_coalesceWritesToDifferentDestinations(CuTest* tc)
+{
+   struct apx_nodeInstance_tag *dest1 = (struct apx_nodeInstance_tag*) 0x1000;
+   struct apx_nodeInstance_tag *dest2 = (struct apx_nodeInstance_tag*) 0x2000;
+   apx_routingWrite_t writes[4] = {
+         {dest2, 2u, 2u},
+         {dest1, 0u, 2u},
+         {dest2, 0u, 2u},
+         {dest1, 2u, 2u}
+   };
+   CuAssertUIntEquals(tc, 2u, apx_routingPlan_coalesceWrites(&writes[0], 4u));
+   CuAssertPtrEquals(tc, dest1, writes[0].destNodeInstance);
+   CuAssertUIntEquals(tc, 0u, writes[0].destOffset);
+   CuAssertUIntEquals(tc, 4u, writes[0].len);
+   CuAssertPtrEquals(tc, dest2, writes[1].destNodeInstance);
+   CuAssertUIntEquals(tc, 0u, writes[1].destOffset);
+   CuAssertUIntEquals(tc, 4u, writes[1].len);
+   CuAssertUIntEquals(tc, 0u, apx_routingPlan_coalesceWrites(&writes[0], 0u));
+}
+
+static void test_apx_routingPlan_coalesceWritesTracksSourceOffset(CuTest* tc)
+{
+   struct apx_nodeInstance_tag *dest1 = (struct apx_nodeInstance_tag*) 0x1000;
+   struct apx_nodeInstance_tag *dest2 = (struct apx_nodeInstance_tag*) 0x2000;
+   apx_routingWrite_t writes[4] = {
+         {dest1, 12u, 2u, 2u}, //same distance between source and destination as the write below
+         {dest1, 10u, 2u, 0u},
+         {dest2, 0u, 2u, 2u}, //source order is reversed compared to destination
+         {dest2, 2u, 2u, 0u}
+   };
+   CuAssertUIntEquals(tc, 2u, apx_routingPlan_coalesceWrites(&writes[0], 4u));
+   CuAssertPtrEquals(tc, dest1, writes[0].destNodeInstance);
+   CuAssertUIntEquals(tc, 10u, writes[0].destOffset);
+   CuAssertUIntEquals(tc, 4u, writes[0].len);
+   CuAssertUIntEquals(tc, 0u, writes[0].srcOffset);
+   CuAssertPtrEquals(tc, dest2, writes[1].destNodeInstance);
+   CuAssertUIntEquals(tc, 0u, writes[1].destOffset);
+   CuAssertUIntEquals(tc, 4u, writes[1].len);
+   CuAssertUIntEquals(tc, APX_ROUTING_WRITE_NO_SRC_OFFSET, writes[1].srcOffset);
+}
@@ -0,0 +1,119 @@
+/*****************************************************************************
+* \file      testsuite_apx_sha256.c
+* \author    Conny Gustafsson
+* \date      2026-10-18
+* \brief     Unit tests for apx_sha256
+*
+* Copyright (c) 2026 Conny Gustafsson
+* Permission is hereby granted, free of charge, to any person obtaining a copy of
+* this software and associated documentation files (the "Software"), to deal in
+* the Software without restriction, including without limitation the rights to
+* use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+* the Software, and to permit persons to whom the Software is furnished to do so,
+* subject to the following conditions:
+
+* The above copyright notice and this permission notice shall be included in all
+* copies or substantial portions of the Software.
+
+* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+* IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+* FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+* COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+* IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+* CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+*
+******************************************************************************/
+//////////////////////////////////////////////////////////////////////////////
+// INCLUDES
+//////////////////////////////////////////////////////////////////////////////
+#include <stddef.h>
+#include <stdio.h>
+#include <string.h>
+#include "CuTest.h"
+#include "apx_sha256.h"
+#ifdef MEM_LEAK_CHECK
+#include "CMemLeak.h"
+#endif
+
+//////////////////////////////////////////////////////////////////////////////
+// PRIVATE CONSTANTS AND DATA TYPES
+//////////////////////////////////////////////////////////////////////////////
+
+//////////////////////////////////////////////////////////////////////////////
+// PRIVATE FUNCTION PROTOTYPES
+//////////////////////////////////////////////////////////////////////////////
+static void test_apx_sha256_emptyMessage(CuTest* tc);
+static void test_apx_sha256_shortMessage(CuTest* tc);
+static void test_apx_sha256_multiBlockMessage(CuTest* tc);
+static void test_apx_sha256_incrementalUpdate(CuTest* tc);
+
+//////////////////////////////////////////////////////////////////////////////
+// PRIVATE VARIABLES
+//////////////////////////////////////////////////////////////////////////////
+static const uint8_t m_digestEmpty[APX_SHA256_DIGEST_SIZE] = {
+   0xe3, 0xb0, 0xc4, 0x42, 0x98, 0xfc, 0x1c, 0x14, 0x9a, 0xfb, 0xf4, 0xc8, 0x99, 0x6f, 0xb9, 0x24,
+   0x27, 0xae, 0x41, 0xe4, 0x64, 0x9b, 0x93, 0x4c, 0xa4, 0x95, 0x99, 0x1b, 0x78, 0x52, 0xb8, 0x55
+};
+static const uint8_t m_digestAbc[APX_SHA256_DIGEST_SIZE] = {
+   0xba, 0x78, 0x16, 0xbf, 0x8f, 0x01, 0xcf, 0xea, 0x41, 0x41, 0x40, 0xde, 0x5d, 0xae, 0x22, 0x23,
+   0xb0, 0x03, 0x61, 0xa3, 0x96, 0x17, 0x7a, 0x9c, 0xb4, 0x10, 0xff, 0x61, 0xf2, 0x00, 0x15, 0xad
+};
+static const uint8_t m_digestTwoBlocks[APX_SHA256_DIGEST_SIZE] = {
+   0x24, 0x8d, 0x6a, 0x61, 0xd2, 0x06, 0x38, 0xb8, 0xe5, 0xc0, 0x26, 0x93, 0x0c, 0x3e, 0x60, 0x39,
+   0xa3, 0x3c, 0xe4, 0x59, 0x64, 0xff, 0x21, 0x67, 0xf6, 0xec, 0xed, 0xd4, 0x19, 0xdb, 0x06, 0xc1
+};
+static const char *m_twoBlockMessage = "abcdbcdecdefdefgefghfghighijhijkijkljklmklmnlmnomnopnopq";
+
+//////////////////////////////////////////////////////////////////////////////
+// PUBLIC FUNCTIONS
+//////////////////////////////////////////////////////////////////////////////
+CuSuite* testSuite_apx_sha256(void)
+{
+   CuSuite* suite = CuSuiteNew();
+
+   SUITE_ADD_TEST(suite, test_apx_sha256_emptyMessage);
+   SUITE_ADD_TEST(suite, test_apx_sha256_shortMessage);
+   SUITE_ADD_TEST(suite, test_apx_sha256_multiBlockMessage);
+   SUITE_ADD_TEST(suite, test_apx_sha256_incrementalUpdate);
+
+   return suite;
+}
+
+//////////////////////////////////////////////////////////////////////////////
+// PRIVATE FUNCTIONS
+//////////////////////////////////////////////////////////////////////////////
+static void test_apx_sha256_emptyMessage(CuTest* tc)
+{
+   uint8_t digest[APX_SHA256_DIGEST_SIZE];
+   apx_sha256_calc( (const uint8_t*) "", 0u, &digest[0]);
+   CuAssertIntEquals(tc, 0, memcmp(&m_digestEmpty[0], &digest[0], APX_SHA256_DIGEST_SIZE));
+}
+
+static void test_apx_sha256_shortMessage(CuTest* tc)
+{
+   uint8_t digest[APX_SHA256_DIGEST_SIZE];
+   apx_sha256_calc( (const uint8_t*) "abc", 3u, &digest[0]);
+   CuAssertIntEquals(tc, 0, memcmp(&m_digestAbc[0], &digest[0], APX_SHA256_DIGEST_SIZE));
+}
+
+static void test_apx_sha256_multiBlockMessage(CuTest* tc)
+{
+   uint8_t digest[APX_SHA256_DIGEST_SIZE];
+   apx_sha256_calc( (const uint8_t*) m_twoBlockMessage, (uint32_t) strlen(m_twoBlockMessage), &digest[0]);
+   CuAssertIntEquals(tc, 0, memcmp(&m_digestTwoBlocks[0], &digest[0], APX_SHA256_DIGEST_SIZE));
+}
+
+static void test_apx_sha256_incrementalUpdate(CuTest* tc)
+{
+   apx_sha256_t ctx;
+   uint8_t digest[APX_SHA256_DIGEST_SIZE];
+   uint32_t i;
+   uint32_t len = (uint32_t) strlen(m_twoBlockMessage);
+   apx_sha256_init(&ctx);
+   for (i = 0u; i < len; i++)
+   {
+      apx_sha256_update(&ctx, (const uint8_t*) &m_twoBlockMessage[i], 1u);
+   }
+   apx_sha256_final(&ctx, &digest[0]);
+   CuAssertIntEquals(tc, 0, memcmp(&m_digestTwoBlocks[0], &digest[0], APX_SHA256_DIGEST_SIZE));
+}
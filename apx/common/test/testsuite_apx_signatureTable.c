@@ -0,0 +1,189 @@
+/*****************************************************************************
+* \file      testsuite_apx_signatureTable.c
+* \author    Conny Gustafsson
+* \date      2026-10-18
+* \brief     Unit tests for apx_signatureTable
+*
+* Copyright (c) 2026 Conny Gustafsson
+* Permission is hereby granted, free of charge, to any person obtaining a copy of
+* this software and associated documentation files (the "Software"), to deal in
+* the Software without restriction, including without limitation the rights to
+* use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+* the Software, and to permit persons to whom the Software is furnished to do so,
+* subject to the following conditions:
+
+* The above copyright notice and this permission notice shall be included in all
+* copies or substantial portions of the Software.
+
+* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+* IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+* FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+* COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+* IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+* CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+*
+******************************************************************************/
+//////////////////////////////////////////////////////////////////////////////
+// INCLUDES
+//////////////////////////////////////////////////////////////////////////////
+#include <stddef.h>
+#include <stdio.h>
+#include <string.h>
+#include "CuTest.h"
+#include "apx_signatureTable.h"
+#ifdef MEM_LEAK_CHECK
+#include "CMemLeak.h"
+#endif
+
+//////////////////////////////////////////////////////////////////////////////
+// PRIVATE CONSTANTS AND DATA TYPES
+//////////////////////////////////////////////////////////////////////////////
+#define NUM_MANY_SIGNATURES 5000
+
+//////////////////////////////////////////////////////////////////////////////
+// PRIVATE FUNCTION PROTOTYPES
+//////////////////////////////////////////////////////////////////////////////
+static void test_apx_signatureTable_internSameSignatureTwice(CuTest* tc);
+static void test_apx_signatureTable_findUnknownSignature(CuTest* tc);
+static void test_apx_signatureTable_internManySignatures(CuTest* tc);
+static void test_apx_signatureTable_releaseLastReference(CuTest* tc);
+static void test_apx_signatureTable_releaseManySignatures(CuTest* tc);
+
+//////////////////////////////////////////////////////////////////////////////
+// PRIVATE VARIABLES
+//////////////////////////////////////////////////////////////////////////////
+
+//////////////////////////////////////////////////////////////////////////////
+// PUBLIC FUNCTIONS
+//////////////////////////////////////////////////////////////////////////////
+CuSuite* testSuite_apx_signatureTable(void)
+{
+   CuSuite* suite = CuSuiteNew();
+
+   SUITE_ADD_TEST(suite, test_apx_signatureTable_internSameSignatureTwice);
+   SUITE_ADD_TEST(suite, test_apx_signatureTable_findUnknownSignature);
+   SUITE_ADD_TEST(suite, test_apx_signatureTable_internManySignatures);
+   SUITE_ADD_TEST(suite, test_apx_signatureTable_releaseLastReference);
+   SUITE_ADD_TEST(suite, test_apx_signatureTable_releaseManySignatures);
+
+   return suite;
+}
+
+//////////////////////////////////////////////////////////////////////////////
+// PRIVATE FUNCTIONS
+//////////////////////////////////////////////////////////////////////////////
+static void test_apx_signatureTable_internSameSignatureTwice(CuTest* tc)
+{
+   apx_signatureTable_t table;
+   apx_signatureId_t id1 = APX_INVALID_SIGNATURE_ID;
+   apx_signatureId_t id2 = APX_INVALID_SIGNATURE_ID;
+   apx_signatureId_t id3 = APX_INVALID_SIGNATURE_ID;
+   apx_signatureTable_create(&table);
+   CuAssertIntEquals(tc, APX_NO_ERROR, apx_signatureTable_intern(&table, "\"VehicleSpeed\"S", &id1));
+   CuAssertIntEquals(tc, APX_NO_ERROR, apx_signatureTable_intern(&table, "\"EngineSpeed\"S", &id2));
+   CuAssertIntEquals(tc, APX_NO_ERROR, apx_signatureTable_intern(&table, "\"VehicleSpeed\"S", &id3));
+   CuAssertUIntEquals(tc, 0u, id1);
+   CuAssertUIntEquals(tc, 1u, id2);
+   CuAssertUIntEquals(tc, id1, id3);
+   CuAssertIntEquals(tc, 2, apx_signatureTable_length(&table));
+   CuAssertStrEquals(tc, "\"VehicleSpeed\"S", apx_signatureTable_getSignature(&table, id1));
+   CuAssertStrEquals(tc, "\"EngineSpeed\"S", apx_signatureTable_getSignature(&table, id2));
+   CuAssertPtrEquals(tc, 0, (void*) apx_signatureTable_getSignature(&table, 2u));
+   apx_signatureTable_destroy(&table);
+}
+
+static void test_apx_signatureTable_findUnknownSignature(CuTest* tc)
+{
+   apx_signatureTable_t table;
+   apx_signatureId_t id;
+   apx_signatureTable_create(&table);
+   CuAssertUIntEquals(tc, APX_INVALID_SIGNATURE_ID, apx_signatureTable_find(&table, "\"VehicleSpeed\"S"));
+   CuAssertIntEquals(tc, APX_NO_ERROR, apx_signatureTable_intern(&table, "\"VehicleSpeed\"S", &id));
+   CuAssertUIntEquals(tc, id, apx_signatureTable_find(&table, "\"VehicleSpeed\"S"));
+   CuAssertUIntEquals(tc, APX_INVALID_SIGNATURE_ID, apx_signatureTable_find(&table, "\"VehicleSpeed\"C"));
+   CuAssertIntEquals(tc, 1, apx_signatureTable_length(&table));
+   apx_signatureTable_destroy(&table);
+}
+
+static void test_apx_signatureTable_internManySignatures(CuTest* tc)
+{
+   apx_signatureTable_t table;
+   apx_signatureTableStats_t stats;
+   char signature[32];
+   int32_t i;
+   apx_signatureTable_create(&table);
+   for (i = 0; i < NUM_MANY_SIGNATURES; i++)
+   {
+      apx_signatureId_t id;
+      sprintf(signature, "\"Port%d\"S", (int) i);
+      CuAssertIntEquals(tc, APX_NO_ERROR, apx_signatureTable_intern(&table, signature, &id));
+      CuAssertUIntEquals(tc, (apx_signatureId_t) i, id);
+   }
+   for (i = 0; i < NUM_MANY_SIGNATURES; i++)
+   {
+      sprintf(signature, "\"Port%d\"S", (int) i);
+      CuAssertUIntEquals(tc, (apx_signatureId_t) i, apx_signatureTable_find(&table, signature));
+   }
+   apx_signatureTable_getStats(&table, &stats);
+   CuAssertUIntEquals(tc, NUM_MANY_SIGNATURES, stats.numSignatures);
+   CuAssertTrue(tc, stats.numBuckets >= 2u * NUM_MANY_SIGNATURES);
+   //Strings are only compared when the hash matches, which only happens for the signature being searched for
+   CuAssertUIntEquals(tc, NUM_MANY_SIGNATURES, stats.numStringCompares);
+   apx_signatureTable_destroy(&table);
+}
+
+static void test_apx_signatureTable_releaseLastReference(CuTest* tc)
+{
+   apx_signatureTable_t table;
+   apx_signatureTableStats_t stats;
+   apx_signatureId_t id1;
+   apx_signatureId_t id2;
+   apx_signatureId_t id3;
+   apx_signatureTable_create(&table);
+   CuAssertIntEquals(tc, APX_NO_ERROR, apx_signatureTable_intern(&table, "\"VehicleSpeed\"S", &id1));
+   CuAssertIntEquals(tc, APX_NO_ERROR, apx_signatureTable_intern(&table, "\"VehicleSpeed\"S", &id2));
+   CuAssertIntEquals(tc, APX_NO_ERROR, apx_signatureTable_intern(&table, "\"EngineSpeed\"S", &id3));
+   CuAssertUIntEquals(tc, id1, id2);
+   apx_signatureTable_release(&table, id1);
+   CuAssertStrEquals(tc, "\"VehicleSpeed\"S", apx_signatureTable_getSignature(&table, id1));
+   apx_signatureTable_release(&table, id2);
+   CuAssertPtrEquals(tc, 0, (void*) apx_signatureTable_getSignature(&table, id1));
+   CuAssertUIntEquals(tc, APX_INVALID_SIGNATURE_ID, apx_signatureTable_find(&table, "\"VehicleSpeed\"S"));
+   CuAssertUIntEquals(tc, id3, apx_signatureTable_find(&table, "\"EngineSpeed\"S"));
+   CuAssertIntEquals(tc, 1, apx_signatureTable_length(&table));
+   //Released ID is handed out to the next new signature
+   CuAssertIntEquals(tc, APX_NO_ERROR, apx_signatureTable_intern(&table, "\"WheelSpeed\"S", &id2));
+   CuAssertUIntEquals(tc, id1, id2);
+   apx_signatureTable_release(&table, id2);
+   apx_signatureTable_release(&table, id3);
+   apx_signatureTable_getStats(&table, &stats);
+   CuAssertUIntEquals(tc, 0u, stats.numSignatures);
+   apx_signatureTable_destroy(&table);
+}
+
+static void test_apx_signatureTable_releaseManySignatures(CuTest* tc)
+{
+   apx_signatureTable_t table;
+   char signature[32];
+   int32_t i;
+   apx_signatureTable_create(&table);
+   for (i = 0; i < NUM_MANY_SIGNATURES; i++)
+   {
+      apx_signatureId_t id;
+      sprintf(signature, "\"Port%d\"S", (int) i);
+      CuAssertIntEquals(tc, APX_NO_ERROR, apx_signatureTable_intern(&table, signature, &id));
+   }
+   //Release every other signature, the remaining ones must still be found through their (shifted) buckets
+   for (i = 0; i < NUM_MANY_SIGNATURES; i += 2)
+   {
+      apx_signatureTable_release(&table, (apx_signatureId_t) i);
+   }
+   CuAssertIntEquals(tc, NUM_MANY_SIGNATURES / 2, apx_signatureTable_length(&table));
+   for (i = 0; i < NUM_MANY_SIGNATURES; i++)
+   {
+      apx_signatureId_t expectedId = ( (i % 2) == 0)? APX_INVALID_SIGNATURE_ID : (apx_signatureId_t) i;
+      sprintf(signature, "\"Port%d\"S", (int) i);
+      CuAssertUIntEquals(tc, expectedId, apx_signatureTable_find(&table, signature));
+   }
+   apx_signatureTable_destroy(&table);
+}
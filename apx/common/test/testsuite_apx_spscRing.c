@@ -0,0 +1,156 @@
+/*****************************************************************************
+* \file      testsuite_apx_spscRing.c
+* \author    Conny Gustafsson
+* \date      2026-10-18
+* \brief     Unit tests for apx_spscRing
+*
+* Copyright (c) 2026 Conny Gustafsson
+* Permission is hereby granted, free of charge, to any person obtaining a copy of
+* this software and associated documentation files (the "Software"), to deal in
+* the Software without restriction, including without limitation the rights to
+* use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+* the Software, and to permit persons to whom the Software is furnished to do so,
+* subject to the following conditions:
+
+* The above copyright notice and this permission notice shall be included in all
+* copies or substantial portions of the Software.
+
+* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+* IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+* FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+* COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+* IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+* CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+*
+******************************************************************************/
+//////////////////////////////////////////////////////////////////////////////
+// INCLUDES
+//////////////////////////////////////////////////////////////////////////////
+#include <stddef.h>
+#include <stdio.h>
+#include <string.h>
+#include "CuTest.h"
+#include "apx_spscRing.h"
+#ifdef MEM_LEAK_CHECK
+#include "CMemLeak.h"
+#endif
+
+//////////////////////////////////////////////////////////////////////////////
+// PRIVATE CONSTANTS AND DATA TYPES
+//////////////////////////////////////////////////////////////////////////////
+
+//////////////////////////////////////////////////////////////////////////////
+// PRIVATE FUNCTION PROTOTYPES
+//////////////////////////////////////////////////////////////////////////////
+static void test_apx_spscRing_create(CuTest* tc);
+static void test_apx_spscRing_pushReadInOrder(CuTest* tc);
+static void test_apx_spscRing_pushToFullRing(CuTest* tc);
+static void test_apx_spscRing_pushManyAndReadBatchAcrossWrap(CuTest* tc);
+
+//////////////////////////////////////////////////////////////////////////////
+// PRIVATE VARIABLES
+//////////////////////////////////////////////////////////////////////////////
+
+//////////////////////////////////////////////////////////////////////////////
+// PUBLIC FUNCTIONS
+//////////////////////////////////////////////////////////////////////////////
+CuSuite* testSuite_apx_spscRing(void)
+{
+   CuSuite* suite = CuSuiteNew();
+
+   SUITE_ADD_TEST(suite, test_apx_spscRing_create);
+   SUITE_ADD_TEST(suite, test_apx_spscRing_pushReadInOrder);
+   SUITE_ADD_TEST(suite, test_apx_spscRing_pushToFullRing);
+   SUITE_ADD_TEST(suite, test_apx_spscRing_pushManyAndReadBatchAcrossWrap);
+
+   return suite;
+}
+
+//////////////////////////////////////////////////////////////////////////////
+// PRIVATE FUNCTIONS
+//////////////////////////////////////////////////////////////////////////////
+static void test_apx_spscRing_create(CuTest* tc)
+{
+   apx_spscRing_t ring;
+   apx_spscRing_t *ring2;
+   CuAssertIntEquals(tc, APX_INVALID_ARGUMENT_ERROR, apx_spscRing_create(&ring, 0u, 10u));
+   CuAssertIntEquals(tc, APX_INVALID_ARGUMENT_ERROR, apx_spscRing_create(&ring, 4u, 0u));
+   CuAssertIntEquals(tc, APX_NO_ERROR, apx_spscRing_create(&ring, 3u, 100u));
+   CuAssertUIntEquals(tc, 128u, apx_spscRing_capacity(&ring));
+   CuAssertUIntEquals(tc, 3u, apx_spscRing_elementSize(&ring));
+   CuAssertUIntEquals(tc, 0u, apx_spscRing_length(&ring));
+   apx_spscRing_destroy(&ring);
+   ring2 = apx_spscRing_new(4u, 16u);
+   CuAssertPtrNotNull(tc, ring2);
+   CuAssertUIntEquals(tc, 16u, apx_spscRing_capacity(ring2));
+   apx_spscRing_delete(ring2);
+}
+
+static void test_apx_spscRing_pushReadInOrder(CuTest* tc)
+{
+   apx_spscRing_t ring;
+   uint8_t elem[3];
+   uint8_t buf[3 * 8];
+   uint32_t i;
+   CuAssertIntEquals(tc, APX_NO_ERROR, apx_spscRing_create(&ring, 3u, 8u));
+   CuAssertUIntEquals(tc, 0u, apx_spscRing_read(&ring, buf, 8u));
+   for (i = 0u; i < 5u; i++)
+   {
+      elem[0] = (uint8_t) i;
+      elem[1] = (uint8_t) (i + 10u);
+      elem[2] = (uint8_t) (i + 20u);
+      CuAssertIntEquals(tc, APX_NO_ERROR, apx_spscRing_push(&ring, elem));
+   }
+   CuAssertUIntEquals(tc, 5u, apx_spscRing_length(&ring));
+   CuAssertUIntEquals(tc, 2u, apx_spscRing_read(&ring, buf, 2u));
+   CuAssertUIntEquals(tc, 0u, buf[0]);
+   CuAssertUIntEquals(tc, 11u, buf[4]);
+   CuAssertUIntEquals(tc, 3u, apx_spscRing_read(&ring, buf, 8u));
+   CuAssertUIntEquals(tc, 2u, buf[0]);
+   CuAssertUIntEquals(tc, 22u, buf[2]);
+   CuAssertUIntEquals(tc, 4u, buf[6]);
+   CuAssertUIntEquals(tc, 0u, apx_spscRing_length(&ring));
+   apx_spscRing_destroy(&ring);
+}
+
+static void test_apx_spscRing_pushToFullRing(CuTest* tc)
+{
+   apx_spscRing_t ring;
+   uint32_t value;
+   CuAssertIntEquals(tc, APX_NO_ERROR, apx_spscRing_create(&ring, (uint32_t) sizeof(uint32_t), 4u));
+   for (value = 0u; value < 4u; value++)
+   {
+      CuAssertIntEquals(tc, APX_NO_ERROR, apx_spscRing_push(&ring, &value));
+   }
+   CuAssertIntEquals(tc, APX_BUFFER_FULL_ERROR, apx_spscRing_push(&ring, &value));
+   CuAssertUIntEquals(tc, 4u, apx_spscRing_length(&ring));
+   CuAssertUIntEquals(tc, 1u, apx_spscRing_read(&ring, (uint8_t*) &value, 1u));
+   CuAssertUIntEquals(tc, 0u, value);
+   value = 4u;
+   CuAssertIntEquals(tc, APX_NO_ERROR, apx_spscRing_push(&ring, &value));
+   apx_spscRing_destroy(&ring);
+}
+
+static void test_apx_spscRing_pushManyAndReadBatchAcrossWrap(CuTest* tc)
+{
+   apx_spscRing_t ring;
+   uint16_t input[6] = {1u, 2u, 3u, 4u, 5u, 6u};
+   uint16_t output[8];
+   CuAssertIntEquals(tc, APX_NO_ERROR, apx_spscRing_create(&ring, (uint32_t) sizeof(uint16_t), 8u));
+   CuAssertUIntEquals(tc, 6u, apx_spscRing_pushMany(&ring, (const uint8_t*) input, 6u));
+   CuAssertUIntEquals(tc, 6u, apx_spscRing_read(&ring, (uint8_t*) output, 8u));
+   //the next batch starts at slot 6 and wraps around the end of the buffer
+   CuAssertUIntEquals(tc, 6u, apx_spscRing_pushMany(&ring, (const uint8_t*) input, 6u));
+   //only 2 more elements fit
+   CuAssertUIntEquals(tc, 2u, apx_spscRing_pushMany(&ring, (const uint8_t*) input, 6u));
+   CuAssertUIntEquals(tc, 8u, apx_spscRing_length(&ring));
+   memset(output, 0, sizeof(output));
+   CuAssertUIntEquals(tc, 8u, apx_spscRing_read(&ring, (uint8_t*) output, 8u));
+   CuAssertUIntEquals(tc, 1u, output[0]);
+   CuAssertUIntEquals(tc, 2u, output[1]);
+   CuAssertUIntEquals(tc, 3u, output[2]);
+   CuAssertUIntEquals(tc, 6u, output[5]);
+   CuAssertUIntEquals(tc, 1u, output[6]);
+   CuAssertUIntEquals(tc, 2u, output[7]);
+   apx_spscRing_destroy(&ring);
+}
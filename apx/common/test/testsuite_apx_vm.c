@@ -41,12 +41,20 @@
 //////////////////////////////////////////////////////////////////////////////
 // PRIVATE CONSTANTS AND DATA TYPES
 //////////////////////////////////////////////////////////////////////////////
+typedef struct native_test_record_tag
+{
+   uint16_t id;
+   uint8_t status;
+   int32_t values[2];
+   char name[8];
+} native_test_record_t;
 
 //////////////////////////////////////////////////////////////////////////////
 // PRIVATE FUNCTION PROTOTYPES
 //////////////////////////////////////////////////////////////////////////////
 static void test_apx_vm_create(CuTest* tc);
 static void test_apx_vm_decodeProgramHeader(CuTest* tc);
+static void test_apx_vm_decodeDynArrayProps(CuTest* tc);
 static void test_apx_vm_selectProgram(CuTest* tc);
 static void test_apx_vm_packU8(CuTest* tc);
 static void test_apx_vm_unpackU8(CuTest* tc);
@@ -66,10 +74,23 @@ static void test_apx_vm_packRecordContainingU16AndU8Value(CuTest* tc);
 static void test_apx_vm_unpackRecordContainingU16AndU8Value(CuTest* tc);
 static void test_apc_vm_packStringValue(CuTest* tc);
 static void test_apc_vm_unpackStringValue(CuTest* tc);
+static void test_apx_vm_packNativeRecord(CuTest* tc);
+static void test_apx_vm_unpackNativeRecord(CuTest* tc);
+static void test_apx_vm_packNativeWithInvalidLayout(CuTest* tc);
+static void test_apx_vm_packAndUnpackCopyPlan(CuTest* tc);
+static apx_dataElement_t* create_native_test_record(void);
 
 //////////////////////////////////////////////////////////////////////////////
 // PRIVATE VARIABLES
 //////////////////////////////////////////////////////////////////////////////
+static const apx_vmNativeElement_t m_native_test_record_elements[4] =
+{
+   APX_VM_NATIVE_ELEMENT(native_test_record_t, id),
+   APX_VM_NATIVE_ELEMENT(native_test_record_t, status),
+   APX_VM_NATIVE_ELEMENT(native_test_record_t, values),
+   APX_VM_NATIVE_ELEMENT(native_test_record_t, name)
+};
+static const apx_vmNativeLayout_t m_native_test_record_layout = {&m_native_test_record_elements[0], 4u};
 
 //////////////////////////////////////////////////////////////////////////////
 // PUBLIC FUNCTIONS
@@ -80,6 +101,7 @@ CuSuite* testSuite_apx_vm(void)
 
    SUITE_ADD_TEST(suite, test_apx_vm_create);
    SUITE_ADD_TEST(suite, test_apx_vm_decodeProgramHeader);
+   SUITE_ADD_TEST(suite, test_apx_vm_decodeDynArrayProps);
    SUITE_ADD_TEST(suite, test_apx_vm_selectProgram);
    SUITE_ADD_TEST(suite, test_apx_vm_packU8);
    SUITE_ADD_TEST(suite, test_apx_vm_unpackU8);
@@ -99,6 +121,10 @@ CuSuite* testSuite_apx_vm(void)
    SUITE_ADD_TEST(suite, test_apx_vm_unpackRecordContainingU16AndU8Value);
    SUITE_ADD_TEST(suite, test_apc_vm_packStringValue);
    SUITE_ADD_TEST(suite, test_apc_vm_unpackStringValue);
+   SUITE_ADD_TEST(suite, test_apx_vm_packNativeRecord);
+   SUITE_ADD_TEST(suite, test_apx_vm_unpackNativeRecord);
+   SUITE_ADD_TEST(suite, test_apx_vm_packNativeWithInvalidLayout);
+   SUITE_ADD_TEST(suite, test_apx_vm_packAndUnpackCopyPlan);
 
    return suite;
 }
@@ -138,6 +164,49 @@ static void test_apx_vm_decodeProgramHeader(CuTest* tc)
    adt_bytes_delete(storedProgram);
 }
 
+static void test_apx_vm_decodeDynArrayProps(CuTest* tc)
+{
+   apx_compiler_t *compiler = apx_compiler_new();
+   adt_bytearray_t *compiledProgram = adt_bytearray_new(APX_PROGRAM_GROW_SIZE);
+   apx_dataElement_t *dynArray = apx_dataElement_new(APX_BASE_TYPE_UINT16, NULL);
+   apx_dataElement_t *fixArray = apx_dataElement_new(APX_BASE_TYPE_UINT16, NULL);
+   adt_bytes_t *storedProgram;
+   apx_dynLenType_t dynLenType = APX_DYN_LEN_NONE;
+   uint32_t maxArrayLen = 0u;
+   apx_size_t dataSize = 0u;
+   uint8_t dataFlags = 0u;
+   apx_dataElement_setArrayLen(dynArray, 300);
+   apx_dataElement_setDynamicArray(dynArray);
+   apx_dataElement_setArrayLen(fixArray, 300);
+
+   CuAssertIntEquals(tc, APX_NO_ERROR, apx_compiler_begin_packProgram(compiler, compiledProgram));
+   CuAssertIntEquals(tc, APX_NO_ERROR, apx_compiler_compilePackDataElement(compiler, dynArray));
+   apx_compiler_end(compiler);
+   storedProgram = adt_bytearray_bytes(compiledProgram);
+   CuAssertIntEquals(tc, APX_NO_ERROR, apx_vm_decodeDynArrayProps(storedProgram, &dynLenType, &maxArrayLen));
+   CuAssertUIntEquals(tc, APX_DYN_LEN_U16, dynLenType);
+   CuAssertUIntEquals(tc, 300u, maxArrayLen);
+   CuAssertIntEquals(tc, APX_NO_ERROR, apx_vm_decodeProgramDataProps(storedProgram, &dataSize, &dataFlags));
+   CuAssertUIntEquals(tc, UINT16_SIZE + UINT16_SIZE * 300u, dataSize);
+   CuAssertUIntEquals(tc, APX_VM_HEADER_FLAG_DYNAMIC, dataFlags);
+   adt_bytes_delete(storedProgram);
+
+   adt_bytearray_clear(compiledProgram);
+   CuAssertIntEquals(tc, APX_NO_ERROR, apx_compiler_begin_packProgram(compiler, compiledProgram));
+   CuAssertIntEquals(tc, APX_NO_ERROR, apx_compiler_compilePackDataElement(compiler, fixArray));
+   apx_compiler_end(compiler);
+   storedProgram = adt_bytearray_bytes(compiledProgram);
+   CuAssertIntEquals(tc, APX_UNSUPPORTED_ERROR, apx_vm_decodeDynArrayProps(storedProgram, &dynLenType, &maxArrayLen));
+   CuAssertIntEquals(tc, APX_NO_ERROR, apx_vm_decodeProgramDataProps(storedProgram, &dataSize, &dataFlags));
+   CuAssertUIntEquals(tc, 0u, dataFlags);
+   adt_bytes_delete(storedProgram);
+
+   apx_compiler_delete(compiler);
+   adt_bytearray_delete(compiledProgram);
+   apx_dataElement_delete(dynArray);
+   apx_dataElement_delete(fixArray);
+}
+
 static void test_apx_vm_selectProgram(CuTest* tc)
 {
    apx_vm_t *vm = apx_vm_new();
@@ -839,3 +908,190 @@ static void test_apc_vm_unpackStringValue(CuTest* tc)
    apx_dataElement_delete(element);
    adt_bytes_delete(storedProgram);
 }
+
+static void test_apx_vm_packNativeRecord(CuTest* tc)
+{
+   adt_bytes_t *storedProgram;
+   apx_vm_t *vm = apx_vm_new();
+   adt_bytearray_t *compiledProgram = adt_bytearray_new(APX_PROGRAM_GROW_SIZE);
+   apx_dataElement_t *element;
+   apx_compiler_t *compiler = apx_compiler_new();
+   native_test_record_t nativeData;
+   uint8_t dataBuffer[UINT16_SIZE+UINT8_SIZE+UINT32_SIZE*2+8];
+
+   element = create_native_test_record();
+   CuAssertIntEquals(tc, APX_NO_ERROR, apx_compiler_begin_packProgram(compiler, compiledProgram));
+   CuAssertIntEquals(tc, APX_NO_ERROR, apx_compiler_compilePackDataElement(compiler, element));
+   apx_compiler_end(compiler);
+   apx_compiler_delete(compiler);
+   memset(&dataBuffer[0], 0xff, sizeof(dataBuffer));
+   memset(&nativeData, 0xff, sizeof(nativeData));
+   nativeData.id = 0x1234;
+   nativeData.status = 0x15;
+   nativeData.values[0] = -1;
+   nativeData.values[1] = 0x12345678;
+   strcpy(nativeData.name, "abc");
+   storedProgram = adt_bytearray_bytes(compiledProgram);
+   CuAssertUIntEquals(tc, APX_NO_ERROR, apx_vm_selectProgram(vm, storedProgram));
+   CuAssertIntEquals(tc, APX_NO_ERROR, apx_vm_packNative(vm, dataBuffer, (apx_size_t) sizeof(dataBuffer), &nativeData, &m_native_test_record_layout));
+   CuAssertUIntEquals(tc, 0x34, dataBuffer[0]);
+   CuAssertUIntEquals(tc, 0x12, dataBuffer[1]);
+   CuAssertUIntEquals(tc, 0x15, dataBuffer[2]);
+   CuAssertUIntEquals(tc, 0xff, dataBuffer[3]);
+   CuAssertUIntEquals(tc, 0xff, dataBuffer[4]);
+   CuAssertUIntEquals(tc, 0xff, dataBuffer[5]);
+   CuAssertUIntEquals(tc, 0xff, dataBuffer[6]);
+   CuAssertUIntEquals(tc, 0x78, dataBuffer[7]);
+   CuAssertUIntEquals(tc, 0x56, dataBuffer[8]);
+   CuAssertUIntEquals(tc, 0x34, dataBuffer[9]);
+   CuAssertUIntEquals(tc, 0x12, dataBuffer[10]);
+   CuAssertUIntEquals(tc, 'a', dataBuffer[11]);
+   CuAssertUIntEquals(tc, 'b', dataBuffer[12]);
+   CuAssertUIntEquals(tc, 'c', dataBuffer[13]);
+   CuAssertUIntEquals(tc, 0, dataBuffer[14]);
+   CuAssertUIntEquals(tc, 0, dataBuffer[18]);
+
+   apx_vm_delete(vm);
+   adt_bytearray_delete(compiledProgram);
+   apx_dataElement_delete(element);
+   adt_bytes_delete(storedProgram);
+}
+
+static void test_apx_vm_unpackNativeRecord(CuTest* tc)
+{
+   adt_bytes_t *storedProgram;
+   apx_vm_t *vm = apx_vm_new();
+   adt_bytearray_t *compiledProgram = adt_bytearray_new(APX_PROGRAM_GROW_SIZE);
+   apx_dataElement_t *element;
+   apx_compiler_t *compiler = apx_compiler_new();
+   native_test_record_t nativeData;
+   uint8_t dataBuffer[UINT16_SIZE+UINT8_SIZE+UINT32_SIZE*2+8] = {0x34, 0x12, 0x15, 0xfe, 0xff, 0xff, 0xff, 0x78, 0x56, 0x34, 0x12,
+                                                                   'T', 'e', 's', 't', 0, 0, 0, 0};
+
+   element = create_native_test_record();
+   CuAssertIntEquals(tc, APX_NO_ERROR, apx_compiler_begin_unpackProgram(compiler, compiledProgram));
+   CuAssertIntEquals(tc, APX_NO_ERROR, apx_compiler_compileUnpackDataElement(compiler, element));
+   apx_compiler_end(compiler);
+   apx_compiler_delete(compiler);
+   memset(&nativeData, 0, sizeof(nativeData));
+   storedProgram = adt_bytearray_bytes(compiledProgram);
+   CuAssertUIntEquals(tc, APX_NO_ERROR, apx_vm_selectProgram(vm, storedProgram));
+   CuAssertIntEquals(tc, APX_NO_ERROR, apx_vm_unpackNative(vm, dataBuffer, (apx_size_t) sizeof(dataBuffer), &nativeData, &m_native_test_record_layout));
+   CuAssertUIntEquals(tc, 0x1234, nativeData.id);
+   CuAssertUIntEquals(tc, 0x15, nativeData.status);
+   CuAssertIntEquals(tc, -2, nativeData.values[0]);
+   CuAssertIntEquals(tc, 0x12345678, nativeData.values[1]);
+   CuAssertStrEquals(tc, "Test", nativeData.name);
+
+   apx_vm_delete(vm);
+   adt_bytearray_delete(compiledProgram);
+   apx_dataElement_delete(element);
+   adt_bytes_delete(storedProgram);
+}
+
+static void test_apx_vm_packNativeWithInvalidLayout(CuTest* tc)
+{
+   adt_bytes_t *storedProgram;
+   apx_vm_t *vm = apx_vm_new();
+   adt_bytearray_t *compiledProgram = adt_bytearray_new(APX_PROGRAM_GROW_SIZE);
+   apx_dataElement_t *element;
+   apx_compiler_t *compiler = apx_compiler_new();
+   native_test_record_t nativeData;
+   uint8_t dataBuffer[UINT16_SIZE+UINT8_SIZE+UINT32_SIZE*2+8];
+   apx_vmNativeLayout_t layout;
+
+   element = create_native_test_record();
+   CuAssertIntEquals(tc, APX_NO_ERROR, apx_compiler_begin_packProgram(compiler, compiledProgram));
+   CuAssertIntEquals(tc, APX_NO_ERROR, apx_compiler_compilePackDataElement(compiler, element));
+   apx_compiler_end(compiler);
+   apx_compiler_delete(compiler);
+   memset(&nativeData, 0, sizeof(nativeData));
+   storedProgram = adt_bytearray_bytes(compiledProgram);
+   CuAssertUIntEquals(tc, APX_NO_ERROR, apx_vm_selectProgram(vm, storedProgram));
+   layout.elements = &m_native_test_record_elements[0];
+   layout.numElements = 3u;
+   CuAssertIntEquals(tc, APX_LENGTH_ERROR, apx_vm_packNative(vm, dataBuffer, (apx_size_t) sizeof(dataBuffer), &nativeData, &layout));
+   layout.elements = &m_native_test_record_elements[1];
+   CuAssertIntEquals(tc, APX_LENGTH_ERROR, apx_vm_packNative(vm, dataBuffer, (apx_size_t) sizeof(dataBuffer), &nativeData, &layout));
+   CuAssertIntEquals(tc, APX_BUFFER_BOUNDARY_ERROR, apx_vm_packNative(vm, dataBuffer, (apx_size_t) sizeof(dataBuffer) - 1u, &nativeData, &m_native_test_record_layout));
+
+   apx_vm_delete(vm);
+   adt_bytearray_delete(compiledProgram);
+   apx_dataElement_delete(element);
+   adt_bytes_delete(storedProgram);
+}
+
+static void test_apx_vm_packAndUnpackCopyPlan(CuTest* tc)
+{
+   adt_bytes_t *packProgram;
+   adt_bytes_t *unpackProgram;
+   apx_vm_t *vm = apx_vm_new();
+   adt_bytearray_t *compiledProgram = adt_bytearray_new(APX_PROGRAM_GROW_SIZE);
+   apx_dataElement_t *element;
+   apx_compiler_t *compiler = apx_compiler_new();
+   apx_copyPlan_t *packPlan = (apx_copyPlan_t*) 0;
+   apx_copyPlan_t *unpackPlan = (apx_copyPlan_t*) 0;
+   native_test_record_t nativeData;
+   native_test_record_t nativeResult;
+   uint8_t expected[UINT16_SIZE+UINT8_SIZE+UINT32_SIZE*2+8];
+   uint8_t dataBuffer[UINT16_SIZE+UINT8_SIZE+UINT32_SIZE*2+8];
+
+   element = create_native_test_record();
+   CuAssertIntEquals(tc, APX_NO_ERROR, apx_compiler_begin_packProgram(compiler, compiledProgram));
+   CuAssertIntEquals(tc, APX_NO_ERROR, apx_compiler_compilePackDataElement(compiler, element));
+   apx_compiler_end(compiler);
+   packProgram = adt_bytearray_bytes(compiledProgram);
+   adt_bytearray_clear(compiledProgram);
+   CuAssertIntEquals(tc, APX_NO_ERROR, apx_compiler_begin_unpackProgram(compiler, compiledProgram));
+   CuAssertIntEquals(tc, APX_NO_ERROR, apx_compiler_compileUnpackDataElement(compiler, element));
+   apx_compiler_end(compiler);
+   unpackProgram = adt_bytearray_bytes(compiledProgram);
+   apx_compiler_delete(compiler);
+   CuAssertIntEquals(tc, APX_NO_ERROR, apx_compiler_lowerToCopyPlan(packProgram, &packPlan));
+   CuAssertIntEquals(tc, APX_NO_ERROR, apx_compiler_lowerToCopyPlan(unpackProgram, &unpackPlan));
+
+   memset(&nativeData, 0xff, sizeof(nativeData));
+   nativeData.id = 0xABCD;
+   nativeData.status = 7;
+   nativeData.values[0] = -100000;
+   nativeData.values[1] = 100000;
+   strcpy(nativeData.name, "Hello");
+   CuAssertUIntEquals(tc, APX_NO_ERROR, apx_vm_selectProgram(vm, packProgram));
+   CuAssertIntEquals(tc, APX_NO_ERROR, apx_vm_packNative(vm, expected, (apx_size_t) sizeof(expected), &nativeData, &m_native_test_record_layout));
+   memset(&dataBuffer[0], 0xff, sizeof(dataBuffer));
+   CuAssertIntEquals(tc, APX_NO_ERROR, apx_vm_packCopyPlan(packPlan, dataBuffer, (apx_size_t) sizeof(dataBuffer), &nativeData, &m_native_test_record_layout));
+   CuAssertIntEquals(tc, 0, memcmp(expected, dataBuffer, sizeof(dataBuffer)));
+   CuAssertIntEquals(tc, APX_INVALID_PROGRAM_ERROR, apx_vm_packCopyPlan(unpackPlan, dataBuffer, (apx_size_t) sizeof(dataBuffer), &nativeData, &m_native_test_record_layout));
+
+   memset(&nativeResult, 0, sizeof(nativeResult));
+   CuAssertIntEquals(tc, APX_NO_ERROR, apx_vm_unpackCopyPlan(unpackPlan, dataBuffer, (apx_size_t) sizeof(dataBuffer), &nativeResult, &m_native_test_record_layout));
+   CuAssertUIntEquals(tc, 0xABCD, nativeResult.id);
+   CuAssertUIntEquals(tc, 7, nativeResult.status);
+   CuAssertIntEquals(tc, -100000, nativeResult.values[0]);
+   CuAssertIntEquals(tc, 100000, nativeResult.values[1]);
+   CuAssertStrEquals(tc, "Hello", nativeResult.name);
+
+   apx_vm_delete(vm);
+   apx_copyPlan_delete(packPlan);
+   apx_copyPlan_delete(unpackPlan);
+   adt_bytearray_delete(compiledProgram);
+   apx_dataElement_delete(element);
+   adt_bytes_delete(packProgram);
+   adt_bytes_delete(unpackProgram);
+}
+
+static apx_dataElement_t* create_native_test_record(void)
+{
+   apx_dataElement_t *element;
+   apx_dataElement_t *childElement;
+   element = apx_dataElement_new(APX_BASE_TYPE_RECORD, 0);
+   apx_dataElement_appendChild(element, apx_dataElement_new(APX_BASE_TYPE_UINT16, "Id"));
+   apx_dataElement_appendChild(element, apx_dataElement_new(APX_BASE_TYPE_UINT8, "Status"));
+   childElement = apx_dataElement_new(APX_BASE_TYPE_SINT32, "Values");
+   apx_dataElement_setArrayLen(childElement, 2);
+   apx_dataElement_appendChild(element, childElement);
+   childElement = apx_dataElement_new(APX_BASE_TYPE_STRING, "Name");
+   apx_dataElement_setArrayLen(childElement, 8);
+   apx_dataElement_appendChild(element, childElement);
+   return element;
+}
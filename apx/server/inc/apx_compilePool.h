@@ -0,0 +1,107 @@
+/*****************************************************************************
+* \file      apx_compilePool.h
+* \author    Conny Gustafsson
+* \date      2026-10-18
+* \brief     Bounded thread pool for parsing and compiling node definitions
+*
+* Copyright (c) 2026 Conny Gustafsson
+* Permission is hereby granted, free of charge, to any person obtaining a copy of
+* this software and associated documentation files (the "Software"), to deal in
+* the Software without restriction, including without limitation the rights to
+* use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+* the Software, and to permit persons to whom the Software is furnished to do so,
+* subject to the following conditions:
+
+* The above copyright notice and this permission notice shall be included in all
+* copies or substantial portions of the Software.
+
+* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+* IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+* FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+* COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+* IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+* CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+*
+******************************************************************************/
+#ifndef APX_COMPILE_POOL_H
+#define APX_COMPILE_POOL_H
+
+//////////////////////////////////////////////////////////////////////////////
+// INCLUDES
+//////////////////////////////////////////////////////////////////////////////
+#include "apx_types.h"
+#include "apx_error.h"
+#include "apx_executor.h"
+#include "apx_nodeInstance.h"
+
+//////////////////////////////////////////////////////////////////////////////
+// PUBLIC CONSTANTS AND DATA TYPES
+//////////////////////////////////////////////////////////////////////////////
+struct apx_compileJob_tag;
+struct apx_compilePool_tag;
+
+//Called from a pool thread once the job has finished. The job must later be given back using apx_compilePool_releaseJob.
+typedef void (apx_compileJobCompleteFunc)(void *arg, struct apx_compileJob_tag *job);
+
+typedef struct apx_compileJob_tag
+{
+   apx_executorTask_t task;
+   struct apx_compilePool_tag *pool;
+   apx_nodeInstance_t *nodeInstance; //weak reference, must outlive the job
+   apx_compileJobCompleteFunc *onComplete;
+   void *arg; //user argument for onComplete
+   struct apx_compileJob_tag *nextPending; //not used by the pool, lets the submitter keep a list of its jobs without allocating
+   apx_error_t result;
+   bool isStarted; //protected by pool lock
+   uint64_t submitTimeUs;
+   uint32_t queueTimeUs; //time spent waiting for a free thread
+   uint32_t compileTimeUs; //time spent parsing and compiling
+} apx_compileJob_t;
+
+typedef struct apx_compilePoolStats_tag
+{
+   uint32_t queueDepth; //jobs submitted but not yet picked up by a thread
+   uint32_t maxQueueDepth;
+   uint32_t numRunning;
+   uint32_t numCompleted;
+   uint32_t numFailed;
+   uint32_t numRejected; //submissions refused because maxPendingJobs was reached
+   uint64_t totalCompileTimeUs;
+   uint32_t maxCompileTimeUs;
+   uint64_t totalQueueTimeUs;
+} apx_compilePoolStats_t;
+
+/**
+ * Parses node definitions and compiles their pack/unpack programs on a fixed set of threads.
+ * Each job works on a single nodeInstance using its own parser and compiler, which means no
+ * state is shared between concurrently running jobs.
+ */
+typedef struct apx_compilePool_tag
+{
+   apx_executor_t executor;
+   SPINLOCK_T lock; //protects numPendingJobs and stats
+   uint32_t maxPendingJobs; //queued + running
+   uint32_t numPendingJobs;
+   apx_compilePoolStats_t stats;
+} apx_compilePool_t;
+
+//////////////////////////////////////////////////////////////////////////////
+// PUBLIC FUNCTION PROTOTYPES
+//////////////////////////////////////////////////////////////////////////////
+apx_error_t apx_compilePool_create(apx_compilePool_t *self, uint32_t numThreads, uint32_t maxPendingJobs);
+void apx_compilePool_destroy(apx_compilePool_t *self);
+apx_compilePool_t *apx_compilePool_new(uint32_t numThreads, uint32_t maxPendingJobs);
+void apx_compilePool_delete(apx_compilePool_t *self);
+apx_error_t apx_compilePool_start(apx_compilePool_t *self);
+void apx_compilePool_stop(apx_compilePool_t *self);
+apx_compileJob_t *apx_compilePool_createJob(apx_compilePool_t *self, apx_nodeInstance_t *nodeInstance, apx_compileJobCompleteFunc *onComplete, void *arg, apx_error_t *errorCode);
+void apx_compilePool_scheduleJob(apx_compilePool_t *self, apx_compileJob_t *job);
+apx_compileJob_t *apx_compilePool_submit(apx_compilePool_t *self, apx_nodeInstance_t *nodeInstance, apx_compileJobCompleteFunc *onComplete, void *arg, apx_error_t *errorCode);
+void apx_compilePool_releaseJob(apx_compilePool_t *self, apx_compileJob_t *job);
+void apx_compilePool_getStats(apx_compilePool_t *self, apx_compilePoolStats_t *stats);
+
+#ifdef UNIT_TEST
+bool apx_compilePool_run(apx_compilePool_t *self);
+#endif
+
+#endif //APX_COMPILE_POOL_H
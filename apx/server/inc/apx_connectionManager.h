@@ -54,6 +54,7 @@ typedef struct apx_connectionManager_tag
    adt_list_t inactiveConnections; //These are connections waiting to be cleaned up
    uint32_t nextConnectionId;
    uint32_t numConnections;
+   uint32_t numVisitors; //number of ongoing apx_connectionManager_visitActiveConnections calls. Connections are not deleted while non-zero.
    THREAD_T cleanupThread; //garbage collector thread
    bool cleanupThreadRunning; //when false it's time do shut down
    bool cleanupThreadValid; //true if cleanupThread is a valid variable
@@ -62,6 +63,10 @@ typedef struct apx_connectionManager_tag
 #endif
 } apx_connectionManager_t;
 
+//Called once for each connection that was active when the visit started. The connection manager lock is not held during the call,
+//the connection is however guaranteed not to be deleted until the visit is complete.
+typedef void (apx_connectionVisitorFunc_t)(void *arg, apx_serverConnectionBase_t *connection);
+
 //////////////////////////////////////////////////////////////////////////////
 // PUBLIC FUNCTION PROTOTYPES
 //////////////////////////////////////////////////////////////////////////////
@@ -73,6 +78,8 @@ void apx_connectionManager_attach(apx_connectionManager_t *self, apx_serverConne
 void apx_connectionManager_detach(apx_connectionManager_t *self, apx_serverConnectionBase_t *connection);
 apx_serverConnectionBase_t* apx_connectionManager_getLastConnection(apx_connectionManager_t *self);
 uint32_t apx_connectionManager_getNumConnections(apx_connectionManager_t *self);
+void apx_connectionManager_getAllocatorStats(apx_connectionManager_t *self, apx_allocatorStats_t *stats);
+void apx_connectionManager_visitActiveConnections(apx_connectionManager_t *self, apx_connectionVisitorFunc_t *visitor, void *arg);
 #ifdef UNIT_TEST
 void apx_connectionManager_run(apx_connectionManager_t *self);
 #endif
@@ -18,6 +18,9 @@
 #include "apx_eventListener.h"
 #include "apx_connectionManager.h"
 #include "apx_eventLoop.h"
+#include "apx_executor.h"
+#include "apx_fileCache.h"
+#include "apx_compilePool.h"
 #include "apx_nodeInstance.h"
 #include "soa.h"
 #include "adt_str.h"
@@ -28,7 +31,11 @@
 //////////////////////////////////////////////////////////////////////////////
 // CONSTANTS AND DATA TYPES
 //////////////////////////////////////////////////////////////////////////////
-
+typedef enum apx_serverExecutionModel_tag
+{
+   APX_SERVER_THREAD_PER_CONNECTION, //each connection starts its own event handler and transmit threads (default)
+   APX_SERVER_WORKER_POOL            //all connections share a fixed pool of executor threads
+} apx_serverExecutionModel_t;
 
 typedef struct apx_server_tag
 {
@@ -47,6 +54,11 @@ typedef struct apx_server_tag
                        //synchronize data routing execution as well as
                        //controlling access to the global portSignatureMap.
    SPINLOCK_T eventListenerLock; //Used to protect access to serverEventListeners
+   apx_serverExecutionModel_t executionModel;
+   apx_executor_t *executor; //worker pool shared by all connections in APX_SERVER_WORKER_POOL mode (strong reference)
+   bool isConflationEnabled; //applied to each new connection, see apx_connectionBase_setConflationEnabled
+   apx_fileCache_t nodeInfoCache; //nodeInfo objects of previously seen definition files, shared by all connections
+   apx_compilePool_t *compilePool; //optional background compilation of definition files (strong reference). NULL compiles on the connection thread.
 #ifdef _MSC_VER
    unsigned int threadId;
 #endif
@@ -66,12 +78,25 @@ apx_server_t *apx_server_new(void);
 void apx_server_delete(apx_server_t *self);
 void apx_server_start(apx_server_t *self);
 void apx_server_stop(apx_server_t *self);
+apx_error_t apx_server_setExecutionModel(apx_server_t *self, apx_serverExecutionModel_t executionModel, uint32_t numWorkerThreads);
+apx_serverExecutionModel_t apx_server_getExecutionModel(const apx_server_t *self);
+void apx_server_setConflationEnabled(apx_server_t *self, bool enabled);
+bool apx_server_isConflationEnabled(const apx_server_t *self);
+void apx_server_getAllocatorStats(apx_server_t *self, apx_allocatorStats_t *stats);
+void apx_server_visitConnections(apx_server_t *self, apx_connectionVisitorFunc_t *visitor, void *arg);
+apx_fileCache_t *apx_server_getNodeInfoCache(apx_server_t *self);
+void apx_server_getNodeInfoCacheStats(apx_server_t *self, apx_fileCacheStats_t *stats);
+apx_error_t apx_server_setCompileThreads(apx_server_t *self, uint32_t numThreads);
+apx_compilePool_t *apx_server_getCompilePool(apx_server_t *self);
+void apx_server_getCompilePoolStats(apx_server_t *self, apx_compilePoolStats_t *stats);
+void apx_server_getSignatureTableStats(apx_server_t *self, apx_signatureTableStats_t *stats);
 void* apx_server_registerEventListener(apx_server_t *self, apx_serverEventListener_t *eventListener);
 void apx_server_unregisterEventListener(apx_server_t *self, void *handle);
 void apx_server_acceptConnection(apx_server_t *self, apx_serverConnectionBase_t *serverConnection);
 void apx_server_detachConnection(apx_server_t *self, apx_serverConnectionBase_t *serverConnection);
 apx_error_t apx_server_addExtension(apx_server_t *self, const char *name, apx_serverExtensionHandler_t *handler, dtl_dv_t *config);
 void apx_server_logEvent(apx_server_t *self, apx_logLevel_t level, const char *label, const char *msg);
+void apx_server_connectionLatencyNotify(apx_server_t *self, apx_serverConnectionBase_t *serverConnection);
 void apx_server_takeGlobalLock(apx_server_t *self);
 void apx_server_releaseGlobalLock(apx_server_t *self);
 apx_error_t apx_server_connectNodeInstanceProvidePorts(apx_server_t *self, apx_nodeInstance_t *nodeInstance);
@@ -46,6 +46,7 @@
 // PUBLIC CONSTANTS AND DATA TYPES
 //////////////////////////////////////////////////////////////////////////////
 struct apx_server_tag;
+struct apx_compileJob_tag;
 
 typedef struct apx_serverConnectionBase_tag
 {
@@ -54,6 +55,8 @@ typedef struct apx_serverConnectionBase_tag
    bool isGreetingParsed;
    bool isActive;
    adt_str_t *tag; //optional tag
+   struct apx_compileJob_tag *pendingCompileJobs; //strong references to jobs submitted to the server compile pool, linked through nextPending
+   SPINLOCK_T compileJobLock; //protects pendingCompileJobs
 }apx_serverConnectionBase_t;
 
 //////////////////////////////////////////////////////////////////////////////
@@ -75,6 +78,8 @@ void apx_serverConnectionBase_close(apx_serverConnectionBase_t *self);
 
 uint32_t apx_serverConnectionBase_getTotalPortReferences(apx_serverConnectionBase_t *self);
 struct apx_server_tag* apx_serverConnectionBase_getServer(apx_serverConnectionBase_t *self);
+apx_error_t apx_serverConnectionBase_sendPing(apx_serverConnectionBase_t *self);
+void apx_serverConnectionBase_getLatencySummary(apx_serverConnectionBase_t *self, apx_latencySummary_t *summary);
 //void* apx_serverConnectionBase_registerNodeDataEventListener(apx_serverConnectionBase_t *self, apx_nodeDataEventListener_t *listener);
 //void apx_serverConnectionBase_unregisterNodeDataEventListener(apx_serverConnectionBase_t *self, void *handle);
 
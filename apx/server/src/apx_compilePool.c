@@ -0,0 +1,339 @@
+/*****************************************************************************
+* \file      apx_compilePool.c
+* \author    Conny Gustafsson
+* \date      2026-10-18
+* \brief     Bounded thread pool for parsing and compiling node definitions
+*
+* Copyright (c) 2026 Conny Gustafsson
+* Permission is hereby granted, free of charge, to any person obtaining a copy of
+* this software and associated documentation files (the "Software"), to deal in
+* the Software without restriction, including without limitation the rights to
+* use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+* the Software, and to permit persons to whom the Software is furnished to do so,
+* subject to the following conditions:
+
+* The above copyright notice and this permission notice shall be included in all
+* copies or substantial portions of the Software.
+
+* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+* IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+* FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+* COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+* IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+* CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+*
+******************************************************************************/
+//////////////////////////////////////////////////////////////////////////////
+// INCLUDES
+//////////////////////////////////////////////////////////////////////////////
+#include <stdlib.h>
+#include <string.h>
+#include <assert.h>
+#ifndef _MSC_VER
+#include <time.h>
+#endif
+#include "apx_compilePool.h"
+#include "apx_parser.h"
+#ifdef MEM_LEAK_CHECK
+#include "CMemLeak.h"
+#endif
+
+//////////////////////////////////////////////////////////////////////////////
+// PRIVATE CONSTANTS AND DATA TYPES
+//////////////////////////////////////////////////////////////////////////////
+
+//////////////////////////////////////////////////////////////////////////////
+// PRIVATE FUNCTION PROTOTYPES
+//////////////////////////////////////////////////////////////////////////////
+static bool apx_compilePool_runJob(void *arg);
+static apx_error_t apx_compilePool_compile(apx_nodeInstance_t *nodeInstance);
+static uint64_t apx_compilePool_getTimeUs(void);
+
+//////////////////////////////////////////////////////////////////////////////
+// PRIVATE VARIABLES
+//////////////////////////////////////////////////////////////////////////////
+
+//////////////////////////////////////////////////////////////////////////////
+// PUBLIC FUNCTIONS
+//////////////////////////////////////////////////////////////////////////////
+apx_error_t apx_compilePool_create(apx_compilePool_t *self, uint32_t numThreads, uint32_t maxPendingJobs)
+{
+   if ( (self != 0) && (numThreads > 0u) && (maxPendingJobs > 0u) )
+   {
+      apx_error_t rc = apx_executor_create(&self->executor, numThreads);
+      if (rc != APX_NO_ERROR)
+      {
+         return rc;
+      }
+      SPINLOCK_INIT(self->lock);
+      self->maxPendingJobs = maxPendingJobs;
+      self->numPendingJobs = 0u;
+      memset(&self->stats, 0, sizeof(self->stats));
+      return APX_NO_ERROR;
+   }
+   return APX_INVALID_ARGUMENT_ERROR;
+}
+
+void apx_compilePool_destroy(apx_compilePool_t *self)
+{
+   if (self != 0)
+   {
+      apx_executor_destroy(&self->executor);
+      SPINLOCK_DESTROY(self->lock);
+   }
+}
+
+apx_compilePool_t *apx_compilePool_new(uint32_t numThreads, uint32_t maxPendingJobs)
+{
+   apx_compilePool_t *self = (apx_compilePool_t*) malloc(sizeof(apx_compilePool_t));
+   if (self != 0)
+   {
+      apx_error_t result = apx_compilePool_create(self, numThreads, maxPendingJobs);
+      if (result != APX_NO_ERROR)
+      {
+         free(self);
+         self = (apx_compilePool_t*) 0;
+      }
+   }
+   return self;
+}
+
+void apx_compilePool_delete(apx_compilePool_t *self)
+{
+   if (self != 0)
+   {
+      apx_compilePool_destroy(self);
+      free(self);
+   }
+}
+
+apx_error_t apx_compilePool_start(apx_compilePool_t *self)
+{
+   if (self != 0)
+   {
+      return apx_executor_start(&self->executor);
+   }
+   return APX_INVALID_ARGUMENT_ERROR;
+}
+
+void apx_compilePool_stop(apx_compilePool_t *self)
+{
+   if (self != 0)
+   {
+      apx_executor_stop(&self->executor);
+   }
+}
+
+/**
+ * Queues parsing and compilation of the definition stored in nodeInstance.
+ * Returns NULL and sets errorCode to APX_BUFFER_FULL_ERROR when maxPendingJobs has been reached, the caller is then
+ * expected to compile the node on its own thread.
+ */
+apx_compileJob_t *apx_compilePool_submit(apx_compilePool_t *self, apx_nodeInstance_t *nodeInstance, apx_compileJobCompleteFunc *onComplete, void *arg, apx_error_t *errorCode)
+{
+   apx_compileJob_t *job = apx_compilePool_createJob(self, nodeInstance, onComplete, arg, errorCode);
+   if (job != 0)
+   {
+      apx_compilePool_scheduleJob(self, job);
+   }
+   return job;
+}
+
+/**
+ * First half of apx_compilePool_submit. Allocates the job and reserves room for it in the pool without scheduling it,
+ * which lets the caller register the job before onComplete can possibly be called.
+ * A job that is never scheduled must be given back using apx_compilePool_releaseJob.
+ */
+apx_compileJob_t *apx_compilePool_createJob(apx_compilePool_t *self, apx_nodeInstance_t *nodeInstance, apx_compileJobCompleteFunc *onComplete, void *arg, apx_error_t *errorCode)
+{
+   apx_error_t rc = APX_INVALID_ARGUMENT_ERROR;
+   apx_compileJob_t *job = (apx_compileJob_t*) 0;
+   if ( (self != 0) && (nodeInstance != 0) && (onComplete != 0) )
+   {
+      bool isFull;
+      SPINLOCK_ENTER(self->lock);
+      isFull = (self->numPendingJobs >= self->maxPendingJobs)? true : false;
+      if (isFull)
+      {
+         self->stats.numRejected++;
+      }
+      else
+      {
+         self->numPendingJobs++;
+      }
+      SPINLOCK_LEAVE(self->lock);
+      if (isFull)
+      {
+         rc = APX_BUFFER_FULL_ERROR;
+      }
+      else
+      {
+         job = (apx_compileJob_t*) malloc(sizeof(apx_compileJob_t));
+         if (job == 0)
+         {
+            SPINLOCK_ENTER(self->lock);
+            self->numPendingJobs--;
+            SPINLOCK_LEAVE(self->lock);
+            rc = APX_MEM_ERROR;
+         }
+         else
+         {
+            apx_executorTask_create(&job->task, apx_compilePool_runJob, (void*) job);
+            job->pool = self;
+            job->nodeInstance = nodeInstance;
+            job->onComplete = onComplete;
+            job->arg = arg;
+            job->nextPending = (apx_compileJob_t*) 0;
+            job->result = APX_NO_ERROR;
+            job->isStarted = false;
+            job->submitTimeUs = 0u;
+            job->queueTimeUs = 0u;
+            job->compileTimeUs = 0u;
+            SPINLOCK_ENTER(self->lock);
+            self->stats.queueDepth++;
+            if (self->stats.queueDepth > self->stats.maxQueueDepth)
+            {
+               self->stats.maxQueueDepth = self->stats.queueDepth;
+            }
+            SPINLOCK_LEAVE(self->lock);
+            rc = APX_NO_ERROR;
+         }
+      }
+   }
+   if (errorCode != 0)
+   {
+      *errorCode = rc;
+   }
+   return job;
+}
+
+void apx_compilePool_scheduleJob(apx_compilePool_t *self, apx_compileJob_t *job)
+{
+   if ( (self != 0) && (job != 0) )
+   {
+      job->submitTimeUs = apx_compilePool_getTimeUs();
+      apx_executor_schedule(&self->executor, &job->task);
+   }
+}
+
+/**
+ * Frees job. If the job is still queued it is cancelled, if it is running this waits for it to finish.
+ */
+void apx_compilePool_releaseJob(apx_compilePool_t *self, apx_compileJob_t *job)
+{
+   if ( (self != 0) && (job != 0) )
+   {
+      apx_executor_cancel(&self->executor, &job->task);
+      SPINLOCK_ENTER(self->lock);
+      if (job->isStarted == false)
+      {
+         assert(self->stats.queueDepth > 0u);
+         self->stats.queueDepth--;
+         self->numPendingJobs--;
+      }
+      SPINLOCK_LEAVE(self->lock);
+      free(job);
+   }
+}
+
+void apx_compilePool_getStats(apx_compilePool_t *self, apx_compilePoolStats_t *stats)
+{
+   if ( (self != 0) && (stats != 0) )
+   {
+      SPINLOCK_ENTER(self->lock);
+      *stats = self->stats;
+      SPINLOCK_LEAVE(self->lock);
+   }
+}
+
+#ifdef UNIT_TEST
+/**
+ * Runs the first queued job on the calling thread. Returns false when no job was queued.
+ */
+bool apx_compilePool_run(apx_compilePool_t *self)
+{
+   if (self != 0)
+   {
+      return apx_executor_run(&self->executor);
+   }
+   return false;
+}
+#endif
+
+//////////////////////////////////////////////////////////////////////////////
+// PRIVATE FUNCTIONS
+//////////////////////////////////////////////////////////////////////////////
+static bool apx_compilePool_runJob(void *arg)
+{
+   apx_compileJob_t *job = (apx_compileJob_t*) arg;
+   apx_compilePool_t *self;
+   uint64_t startTime;
+   assert(job != 0);
+   self = job->pool;
+   startTime = apx_compilePool_getTimeUs();
+   job->queueTimeUs = (uint32_t) (startTime - job->submitTimeUs);
+   SPINLOCK_ENTER(self->lock);
+   job->isStarted = true;
+   self->stats.queueDepth--;
+   self->stats.numRunning++;
+   SPINLOCK_LEAVE(self->lock);
+
+   job->result = apx_compilePool_compile(job->nodeInstance);
+   job->compileTimeUs = (uint32_t) (apx_compilePool_getTimeUs() - startTime);
+
+   SPINLOCK_ENTER(self->lock);
+   self->numPendingJobs--;
+   self->stats.numRunning--;
+   if (job->result == APX_NO_ERROR)
+   {
+      self->stats.numCompleted++;
+   }
+   else
+   {
+      self->stats.numFailed++;
+   }
+   self->stats.totalCompileTimeUs += job->compileTimeUs;
+   self->stats.totalQueueTimeUs += job->queueTimeUs;
+   if (job->compileTimeUs > self->stats.maxCompileTimeUs)
+   {
+      self->stats.maxCompileTimeUs = job->compileTimeUs;
+   }
+   SPINLOCK_LEAVE(self->lock);
+   job->onComplete(job->arg, job);
+   return false;
+}
+
+/**
+ * Same steps as the inline path in apx_serverConnectionBase, but with a parser owned by this call
+ */
+static apx_error_t apx_compilePool_compile(apx_nodeInstance_t *nodeInstance)
+{
+   apx_parser_t parser;
+   apx_error_t rc;
+   apx_parser_create(&parser);
+   rc = apx_nodeInstance_parseDefinition(nodeInstance, &parser);
+   apx_parser_destroy(&parser);
+   if (rc == APX_NO_ERROR)
+   {
+      apx_programType_t errProgramType;
+      apx_uniquePortId_t errPortId;
+      rc = apx_nodeInstance_buildNodeInfo(nodeInstance, &errProgramType, &errPortId);
+      apx_nodeInstance_cleanParseTree(nodeInstance);
+   }
+   return rc;
+}
+
+static uint64_t apx_compilePool_getTimeUs(void)
+{
+#ifdef _MSC_VER
+   LARGE_INTEGER frequency;
+   LARGE_INTEGER counter;
+   QueryPerformanceFrequency(&frequency);
+   QueryPerformanceCounter(&counter);
+   return (uint64_t) ( (counter.QuadPart * 1000000) / frequency.QuadPart );
+#else
+   struct timespec ts;
+   clock_gettime(CLOCK_MONOTONIC, &ts);
+   return ( (uint64_t) ts.tv_sec * 1000000u) + ( (uint64_t) ts.tv_nsec / 1000u);
+#endif
+}
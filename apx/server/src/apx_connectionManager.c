@@ -27,7 +27,9 @@
 // INCLUDES
 //////////////////////////////////////////////////////////////////////////////
 #include <stdio.h>
+#include <stdlib.h>
 #include <errno.h>
+#include <string.h>
 #include "apx_connectionManager.h"
 #ifdef _WIN32
 #include <process.h>
@@ -47,6 +49,9 @@
 static uint32_t apx_connectionManager_generateConnectionId(apx_connectionManager_t *self);
 THREAD_PROTO(cleanupTask, arg);
 static void apx_connectionManager_cleanupTask_run(apx_connectionManager_t *self, int32_t numInactiveConnections);
+static void apx_connectionManager_pingActiveConnections(apx_connectionManager_t *self);
+static void apx_connectionManager_pingConnection(void *arg, apx_serverConnectionBase_t *connection);
+static void apx_connectionManager_addAllocatorStats(void *arg, apx_serverConnectionBase_t *connection);
 
 //////////////////////////////////////////////////////////////////////////////
 // PRIVATE VARIABLES
@@ -65,6 +70,7 @@ void apx_connectionManager_create(apx_connectionManager_t *self)
       adt_u32Set_create(&self->connectionIdSet);
       self->nextConnectionId = 0u;
       self->numConnections = 0u;
+      self->numVisitors = 0u;
       self->cleanupThreadRunning = false;
       self->cleanupThreadValid = false;
    }
@@ -170,6 +176,76 @@ uint32_t apx_connectionManager_getNumConnections(apx_connectionManager_t *self)
    return 0;
 }
 
+/**
+ * Sums up allocator statistics from all active connections.
+ * Each connection's allocator lock is taken outside the manager lock, see apx_connectionManager_visitActiveConnections.
+ */
+void apx_connectionManager_getAllocatorStats(apx_connectionManager_t *self, apx_allocatorStats_t *stats)
+{
+   if ( (self != 0) && (stats != 0) )
+   {
+      memset(stats, 0, sizeof(apx_allocatorStats_t));
+      apx_connectionManager_visitActiveConnections(self, apx_connectionManager_addAllocatorStats, (void*) stats);
+   }
+}
+
+/**
+ * The active connections are copied while holding the lock, visitor is then called after the lock has been released.
+ * Connections detached in the meantime stay alive since the cleanup task does not delete connections while numVisitors is non-zero.
+ */
+void apx_connectionManager_visitActiveConnections(apx_connectionManager_t *self, apx_connectionVisitorFunc_t *visitor, void *arg)
+{
+   if ( (self != 0) && (visitor != 0) )
+   {
+      apx_serverConnectionBase_t **connections = (apx_serverConnectionBase_t**) 0;
+      int32_t numConnections = 0;
+      int32_t capacity = 0;
+      int32_t i;
+      for(;;)
+      {
+         adt_list_elem_t *it;
+         SPINLOCK_ENTER(self->lock);
+         numConnections = adt_list_length(&self->activeConnections);
+         if (numConnections <= capacity)
+         {
+            i = 0;
+            it = adt_list_iter_first(&self->activeConnections);
+            while(it != 0)
+            {
+               connections[i++] = (apx_serverConnectionBase_t*) it->pItem;
+               it = adt_list_iter_next(it);
+            }
+            self->numVisitors++;
+            SPINLOCK_LEAVE(self->lock);
+            break;
+         }
+         SPINLOCK_LEAVE(self->lock);
+         //Grow the array outside the lock and try again
+         if (connections != 0)
+         {
+            free(connections);
+         }
+         capacity = numConnections + 8;
+         connections = (apx_serverConnectionBase_t**) malloc(capacity * sizeof(apx_serverConnectionBase_t*));
+         if (connections == 0)
+         {
+            return;
+         }
+      }
+      for (i = 0; i < numConnections; i++)
+      {
+         visitor(arg, connections[i]);
+      }
+      SPINLOCK_ENTER(self->lock);
+      self->numVisitors--;
+      SPINLOCK_LEAVE(self->lock);
+      if (connections != 0)
+      {
+         free(connections);
+      }
+   }
+}
+
 
 #ifdef UNIT_TEST
 #define APX_SERVER_RUN_CYCLES 10
@@ -246,6 +322,7 @@ THREAD_PROTO(cleanupTask,arg)
    apx_connectionManager_t *self = (apx_connectionManager_t*) arg;
    if(self != 0)
    {
+      uint32_t msSinceLastPing = 0u;
       while(1)
       {
          bool isRunning;
@@ -266,6 +343,15 @@ THREAD_PROTO(cleanupTask,arg)
 #if (APX_DEBUG_ENABLE)
          //printf("[CONNECTION-MANAGER] Done running cleanupTask\n");
 #endif
+         if (APX_SERVER_PING_INTERVAL_MS > 0)
+         {
+            msSinceLastPing += CLEANUP_WAIT_TIME;
+            if (msSinceLastPing >= (uint32_t) APX_SERVER_PING_INTERVAL_MS)
+            {
+               msSinceLastPing = 0u;
+               apx_connectionManager_pingActiveConnections(self);
+            }
+         }
       }
    }
    THREAD_RETURN(0);
@@ -281,7 +367,8 @@ static void apx_connectionManager_cleanupTask_run(apx_connectionManager_t *self,
       SPINLOCK_ENTER(self->lock);
       adt_list_elem_t *iter = adt_list_iter_first(&self->inactiveConnections);
       apx_serverConnectionBase_t *serverConnection = (apx_serverConnectionBase_t*) iter->pItem;
-      if ( (apx_connectionBase_getNumPendingWorkerMessages(&serverConnection->base) == 0u) && (apx_connectionBase_getNumPendingEvents(&serverConnection->base) == 0u))
+      //While a visit is ongoing the visitor may still be using the connection, retry on the next cleanup cycle
+      if ( (self->numVisitors == 0u) && (apx_connectionBase_getNumPendingWorkerMessages(&serverConnection->base) == 0u) && (apx_connectionBase_getNumPendingEvents(&serverConnection->base) == 0u))
       {
 #if (APX_DEBUG_ENABLE)
          printf("[CONNECTION-MANAGER] Cleaning up %d\n", (int) serverConnection->base.connectionId);
@@ -298,5 +385,28 @@ static void apx_connectionManager_cleanupTask_run(apx_connectionManager_t *self,
    }
 }
 
+/**
+ * Called by cleanupTask thread every APX_SERVER_PING_INTERVAL_MS. Connections that haven't sent their greeting yet are skipped.
+ * Pings are sent outside the manager lock, see apx_connectionManager_visitActiveConnections.
+ */
+static void apx_connectionManager_pingActiveConnections(apx_connectionManager_t *self)
+{
+   apx_connectionManager_visitActiveConnections(self, apx_connectionManager_pingConnection, (void*) 0);
+}
 
+static void apx_connectionManager_pingConnection(void *arg, apx_serverConnectionBase_t *connection)
+{
+   (void) arg;
+   if (connection->isGreetingParsed)
+   {
+      (void) apx_serverConnectionBase_sendPing(connection);
+   }
+}
 
+static void apx_connectionManager_addAllocatorStats(void *arg, apx_serverConnectionBase_t *connection)
+{
+   apx_allocatorStats_t *stats = (apx_allocatorStats_t*) arg;
+   apx_allocatorStats_t connectionStats;
+   apx_connectionBase_getAllocatorStats(&connection->base, &connectionStats);
+   apx_allocatorStats_add(stats, &connectionStats);
+}
@@ -66,6 +66,11 @@ void apx_server_create(apx_server_t *self)
       MUTEX_INIT(self->eventLoopLock);
       MUTEX_INIT(self->globalLock);
       SPINLOCK_INIT(self->eventListenerLock);
+      self->executionModel = APX_SERVER_THREAD_PER_CONNECTION;
+      self->executor = (apx_executor_t*) 0;
+      self->isConflationEnabled = (APX_CONFLATION_ENABLE_DEFAULT != 0)? true : false;
+      apx_fileCache_create(&self->nodeInfoCache, APX_SERVER_NODE_INFO_CACHE_SIZE);
+      self->compilePool = (apx_compilePool_t*) 0;
 #ifdef _MSC_VER
       self->threadId = 0u;
 #endif
@@ -87,6 +92,17 @@ void apx_server_destroy(apx_server_t *self)
       apx_connectionManager_destroy(&self->connectionManager);
       apx_portSignatureMap_destroy(&self->portSignatureMap);
       MUTEX_UNLOCK(self->globalLock);
+      if (self->executor != 0)
+      {
+         apx_executor_delete(self->executor);
+         self->executor = (apx_executor_t*) 0;
+      }
+      if (self->compilePool != 0)
+      {
+         apx_compilePool_delete(self->compilePool);
+         self->compilePool = (apx_compilePool_t*) 0;
+      }
+      apx_fileCache_destroy(&self->nodeInfoCache);
       apx_eventLoop_destroy(&self->eventLoop);
       MUTEX_DESTROY(self->eventLoopLock);
       MUTEX_DESTROY(self->globalLock);
@@ -120,6 +136,22 @@ void apx_server_start(apx_server_t *self)
    {
       apx_server_initExtensions(self);
 #ifndef UNIT_TEST
+      if (self->executor != 0)
+      {
+         apx_error_t rc = apx_executor_start(self->executor);
+         if (rc != APX_NO_ERROR)
+         {
+            printf("[SERVER] Failed to start worker pool (%d)\n", (int) rc);
+         }
+      }
+      if (self->compilePool != 0)
+      {
+         apx_error_t rc = apx_compilePool_start(self->compilePool);
+         if (rc != APX_NO_ERROR)
+         {
+            printf("[SERVER] Failed to start compile pool (%d)\n", (int) rc);
+         }
+      }
       apx_connectionManager_start(&self->connectionManager);
       if (self->isEventThreadValid == false)
       {
@@ -138,6 +170,14 @@ void apx_server_stop(apx_server_t *self)
       apx_connectionManager_stop(&self->connectionManager);
 #endif
       apx_server_shutdownExtensions(self);
+      if (self->executor != 0)
+      {
+         apx_executor_stop(self->executor);
+      }
+      if (self->compilePool != 0)
+      {
+         apx_compilePool_stop(self->compilePool);
+      }
 #ifndef UNIT_TEST
       apx_eventLoop_exit(&self->eventLoop);
       if (self->isEventThreadValid)
@@ -152,6 +192,185 @@ void apx_server_stop(apx_server_t *self)
 
 
 
+/**
+ * Selects how server connections are run. Must be called before apx_server_start.
+ * numWorkerThreads is only used by APX_SERVER_WORKER_POOL, 0 selects APX_SERVER_DEFAULT_WORKER_THREADS.
+ */
+apx_error_t apx_server_setExecutionModel(apx_server_t *self, apx_serverExecutionModel_t executionModel, uint32_t numWorkerThreads)
+{
+   if (self != 0)
+   {
+      if (apx_connectionManager_getNumConnections(&self->connectionManager) > 0u)
+      {
+         return APX_INVALID_STATE_ERROR;
+      }
+      if (self->executor != 0)
+      {
+         apx_executor_delete(self->executor);
+         self->executor = (apx_executor_t*) 0;
+      }
+      if (executionModel == APX_SERVER_WORKER_POOL)
+      {
+         self->executor = apx_executor_new( (numWorkerThreads > 0u)? numWorkerThreads : APX_SERVER_DEFAULT_WORKER_THREADS);
+         if (self->executor == 0)
+         {
+            self->executionModel = APX_SERVER_THREAD_PER_CONNECTION;
+            return APX_MEM_ERROR;
+         }
+      }
+      else if (executionModel != APX_SERVER_THREAD_PER_CONNECTION)
+      {
+         return APX_INVALID_ARGUMENT_ERROR;
+      }
+      self->executionModel = executionModel;
+      return APX_NO_ERROR;
+   }
+   return APX_INVALID_ARGUMENT_ERROR;
+}
+
+apx_serverExecutionModel_t apx_server_getExecutionModel(const apx_server_t *self)
+{
+   if (self != 0)
+   {
+      return self->executionModel;
+   }
+   return APX_SERVER_THREAD_PER_CONNECTION;
+}
+
+/**
+ * Enables last-value-wins transmission of require port data for connections accepted after this call.
+ */
+void apx_server_setConflationEnabled(apx_server_t *self, bool enabled)
+{
+   if (self != 0)
+   {
+      self->isConflationEnabled = enabled;
+   }
+}
+
+bool apx_server_isConflationEnabled(const apx_server_t *self)
+{
+   if (self != 0)
+   {
+      return self->isConflationEnabled;
+   }
+   return false;
+}
+
+/**
+ * Returns memory allocator statistics summed over all active connections.
+ * The cache hit rate is numCacheHits / numAllocs.
+ */
+void apx_server_getAllocatorStats(apx_server_t *self, apx_allocatorStats_t *stats)
+{
+   if ( (self != 0) && (stats != 0) )
+   {
+      apx_connectionManager_getAllocatorStats(&self->connectionManager, stats);
+   }
+}
+
+/**
+ * Calls visitor for each active connection, see apx_connectionVisitorFunc_t for restrictions.
+ */
+void apx_server_visitConnections(apx_server_t *self, apx_connectionVisitorFunc_t *visitor, void *arg)
+{
+   if (self != 0)
+   {
+      apx_connectionManager_visitActiveConnections(&self->connectionManager, visitor, arg);
+   }
+}
+
+/**
+ * Returns the cache of compiled node definitions, or NULL when the cache is disabled
+ */
+apx_fileCache_t *apx_server_getNodeInfoCache(apx_server_t *self)
+{
+   if ( (self != 0) && (APX_SERVER_NODE_INFO_CACHE_SIZE > 0) )
+   {
+      return &self->nodeInfoCache;
+   }
+   return (apx_fileCache_t*) 0;
+}
+
+void apx_server_getNodeInfoCacheStats(apx_server_t *self, apx_fileCacheStats_t *stats)
+{
+   if ( (self != 0) && (stats != 0) )
+   {
+      apx_fileCache_getStats(&self->nodeInfoCache, stats);
+   }
+}
+
+/**
+ * Moves parsing and compilation of received definition files to a pool of numThreads background threads.
+ * 0 disables the pool, definitions are then compiled on the thread of the connection that received them.
+ * Must be called before apx_server_start.
+ */
+apx_error_t apx_server_setCompileThreads(apx_server_t *self, uint32_t numThreads)
+{
+   if (self != 0)
+   {
+      if (apx_connectionManager_getNumConnections(&self->connectionManager) > 0u)
+      {
+         return APX_INVALID_STATE_ERROR;
+      }
+      if (self->compilePool != 0)
+      {
+         apx_compilePool_delete(self->compilePool);
+         self->compilePool = (apx_compilePool_t*) 0;
+      }
+      if (numThreads > 0u)
+      {
+         self->compilePool = apx_compilePool_new(numThreads, APX_SERVER_COMPILE_POOL_MAX_PENDING);
+         if (self->compilePool == 0)
+         {
+            return APX_MEM_ERROR;
+         }
+      }
+      return APX_NO_ERROR;
+   }
+   return APX_INVALID_ARGUMENT_ERROR;
+}
+
+apx_compilePool_t *apx_server_getCompilePool(apx_server_t *self)
+{
+   if (self != 0)
+   {
+      return self->compilePool;
+   }
+   return (apx_compilePool_t*) 0;
+}
+
+/**
+ * Returns queue depth and compile time statistics of the compile pool. All values are zero when the pool is disabled.
+ */
+void apx_server_getCompilePoolStats(apx_server_t *self, apx_compilePoolStats_t *stats)
+{
+   if ( (self != 0) && (stats != 0) )
+   {
+      if (self->compilePool != 0)
+      {
+         apx_compilePool_getStats(self->compilePool, stats);
+      }
+      else
+      {
+         memset(stats, 0, sizeof(apx_compilePoolStats_t));
+      }
+   }
+}
+
+/**
+ * Returns the size of the interned port signature table and the number of hash probes and string compares spent on lookups
+ */
+void apx_server_getSignatureTableStats(apx_server_t *self, apx_signatureTableStats_t *stats)
+{
+   if ( (self != 0) && (stats != 0) )
+   {
+      MUTEX_LOCK(self->globalLock);
+      apx_portSignatureMap_getSignatureTableStats(&self->portSignatureMap, stats);
+      MUTEX_UNLOCK(self->globalLock);
+   }
+}
+
 void* apx_server_registerEventListener(apx_server_t *self, apx_serverEventListener_t *eventListener)
 {
    if ( (self != 0) && (eventListener != 0))
@@ -257,6 +476,32 @@ void apx_server_logEvent(apx_server_t *self, apx_logLevel_t level, const char *l
    }
 }
 
+/**
+ * Called from the event handler of serverConnection after a new round-trip sample was recorded.
+ * Listeners receive a snapshot of the connection's latency statistics.
+ */
+void apx_server_connectionLatencyNotify(apx_server_t *self, apx_serverConnectionBase_t *serverConnection)
+{
+   if ( (self != 0) && (serverConnection != 0) )
+   {
+      apx_latencySummary_t summary;
+      adt_list_elem_t *iter;
+      apx_serverConnectionBase_getLatencySummary(serverConnection, &summary);
+      SPINLOCK_ENTER(self->eventListenerLock);
+      iter = adt_list_iter_first(&self->serverEventListeners);
+      while(iter != 0)
+      {
+         apx_serverEventListener_t *listener = (apx_serverEventListener_t*) iter->pItem;
+         if ( (listener != 0) && (listener->connectionLatency1 != 0) )
+         {
+            listener->connectionLatency1(listener->arg, serverConnection, &summary);
+         }
+         iter = adt_list_iter_next(iter);
+      }
+      SPINLOCK_LEAVE(self->eventListenerLock);
+   }
+}
+
 /**
  * Acquires the server global lock
  */
@@ -517,6 +762,11 @@ static void apx_server_attach_and_start_connection(apx_server_t *self, apx_serve
       apx_connectionManager_attach(&self->connectionManager, newConnection);
       apx_serverConnectionBase_setServer(newConnection, self);
       apx_server_triggerConnectedEvent(self, newConnection);
+      if (self->executor != 0)
+      {
+         apx_connectionBase_setExecutor(&newConnection->base, self->executor);
+      }
+      apx_connectionBase_setConflationEnabled(&newConnection->base, self->isConflationEnabled);
       apx_connectionBase_start(&newConnection->base);
    }
    else
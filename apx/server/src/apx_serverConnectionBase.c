@@ -57,11 +57,19 @@
 // PRIVATE FUNCTION PROTOTYPES
 //////////////////////////////////////////////////////////////////////////////
 static void apx_serverConnectionBase_parseGreeting(apx_serverConnectionBase_t *self, const uint8_t *msgBuf, int32_t msgLen);
+static void apx_serverConnectionBase_parseGreetingLine(apx_serverConnectionBase_t *self, const char *line);
 static uint8_t apx_serverConnectionBase_parseMessage(apx_serverConnectionBase_t *self, const uint8_t *dataBuf, uint32_t dataLen, uint32_t *parseLen);
 static void apx_serverConnectionBase_fileInfoNotifyImpl(void *arg, const apx_fileInfo_t *fileInfo);
 static apx_error_t apx_serverConnectionBase_processNewDefinitionFile(apx_serverConnectionBase_t *self, const apx_fileInfo_t *fileInfo);
 static void apx_serverConnectionBase_processNewOutPortDataFile(apx_serverConnectionBase_t *self, const apx_fileInfo_t *fileInfo);
 static void apx_serverConnectionBase_definitionDataWriteNotify(apx_serverConnectionBase_t *self, apx_nodeInstance_t *nodeInstance, uint32_t offset, uint32_t len);
+static apx_error_t apx_serverConnectionBase_buildNodeInfo(apx_serverConnectionBase_t *self, apx_nodeInstance_t *nodeInstance);
+static bool apx_serverConnectionBase_submitCompileJob(apx_serverConnectionBase_t *self, apx_nodeInstance_t *nodeInstance);
+static void apx_serverConnectionBase_compileJobComplete(void *arg, apx_compileJob_t *job);
+static void apx_serverConnectionBase_compileCompleteNotify(apx_serverConnectionBase_t *self, apx_compileJob_t *job);
+static void apx_serverConnectionBase_releasePendingCompileJobs(apx_serverConnectionBase_t *self);
+static void apx_serverConnectionBase_insertIntoNodeInfoCache(apx_serverConnectionBase_t *self, apx_nodeInstance_t *nodeInstance);
+static void apx_serverConnectionBase_completeNodeInstance(apx_serverConnectionBase_t *self, apx_nodeInstance_t *nodeInstance);
 static apx_error_t apx_serverConnectionBase_providePortDataWriteNotify(apx_serverConnectionBase_t *self, apx_nodeInstance_t *nodeInstance, uint32_t offset, const uint8_t *data, uint32_t len);
 static apx_error_t apx_serverConnectionBase_openOutPortDataFileIfExists(apx_serverConnectionBase_t *self, apx_nodeInstance_t *nodeInstance);
 static apx_error_t  apx_serverConnectionBase_createRequirePortDataFileIfNeeded(apx_serverConnectionBase_t *self, apx_nodeInstance_t *nodeInstance);
@@ -102,6 +110,8 @@ apx_error_t apx_serverConnectionBase_create(apx_serverConnectionBase_t *self, ap
       self->server = (apx_server_t*) 0;
       self->isGreetingParsed = false;
       self->isActive = false;
+      self->pendingCompileJobs = (apx_compileJob_t*) 0;
+      SPINLOCK_INIT(self->compileJobLock);
       apx_connectionBase_setEventHandler(&self->base, apx_serverConnectionBase_defaultEventHandler, (void*) self);
       return result;
    }
@@ -112,7 +122,9 @@ void apx_serverConnectionBase_destroy(apx_serverConnectionBase_t *self)
 {
    if (self != 0)
    {
+      apx_serverConnectionBase_releasePendingCompileJobs(self);
       apx_connectionBase_destroy(&self->base);
+      SPINLOCK_DESTROY(self->compileJobLock);
    }
 }
 
@@ -201,6 +213,15 @@ void apx_serverConnectionBase_defaultEventHandler(void *arg, apx_event_t *event)
             apx_fileInfo_delete(fileInfo);
          }
          break;
+      case APX_EVENT_NODE_COMPILE_COMPLETE:
+         apx_serverConnectionBase_compileCompleteNotify(self, (apx_compileJob_t*) event->evData1);
+         break;
+      case APX_EVENT_CONNECTION_LATENCY:
+         if (self->server != 0)
+         {
+            apx_server_connectionLatencyNotify(self->server, self);
+         }
+         break;
 /*
       case APX_EVENT_REQUIRE_PORT_CONNECT:
          nodeData = (apx_nodeData_t*) event->evData1;
@@ -327,6 +348,23 @@ struct apx_server_tag* apx_serverConnectionBase_getServer(apx_serverConnectionBa
    return (apx_server_t*) 0;
 }
 
+apx_error_t apx_serverConnectionBase_sendPing(apx_serverConnectionBase_t *self)
+{
+   if (self != 0)
+   {
+      return apx_connectionBase_sendPing(&self->base);
+   }
+   return APX_INVALID_ARGUMENT_ERROR;
+}
+
+void apx_serverConnectionBase_getLatencySummary(apx_serverConnectionBase_t *self, apx_latencySummary_t *summary)
+{
+   if (self != 0)
+   {
+      apx_connectionBase_getLatencySummary(&self->base, summary);
+   }
+}
+
 /*** UNIT TEST API ***/
 
 #ifdef UNIT_TEST
@@ -366,13 +404,13 @@ static void apx_serverConnectionBase_parseGreeting(apx_serverConnectionBase_t *s
          }
          else
          {
-            //TODO: parse greeting line
             if (lengthOfLine<MAX_HEADER_LEN)
             {
                char tmp[MAX_HEADER_LEN+1];
                memcpy(tmp,pMark,lengthOfLine);
                tmp[lengthOfLine]=0;
                //printf("\tgreeting-line: '%s'\n",tmp);
+               apx_serverConnectionBase_parseGreetingLine(self, tmp);
             }
          }
       }
@@ -383,6 +421,36 @@ static void apx_serverConnectionBase_parseGreeting(apx_serverConnectionBase_t *s
    }
 }
 
+/**
+ * Unknown header lines are ignored
+ */
+static void apx_serverConnectionBase_parseGreetingLine(apx_serverConnectionBase_t *self, const char *line)
+{
+   const size_t compressionHdrLen = strlen(RMF_COMPRESSION_HDR);
+   const size_t fragmentHdrLen = strlen(RMF_FRAGMENT_INTERLEAVE_HDR);
+   if (strncmp(line, RMF_COMPRESSION_HDR, compressionHdrLen) == 0)
+   {
+      const char *value = line + compressionHdrLen;
+      while (*value == ' ')
+      {
+         value++;
+      }
+      if (strcmp(value, RMF_COMPRESSION_LZ4_NAME) == 0)
+      {
+         apx_connectionBase_setCompressionType(&self->base, RMF_COMPRESSION_LZ4);
+      }
+   }
+   else if (strncmp(line, RMF_FRAGMENT_INTERLEAVE_HDR, fragmentHdrLen) == 0)
+   {
+      const char *value = line + fragmentHdrLen;
+      while (*value == ' ')
+      {
+         value++;
+      }
+      apx_connectionBase_setFragmentInterleaveEnabled(&self->base, (strcmp(value, "1") == 0)? true : false);
+   }
+}
+
 /**
  * a message consists of a message length (1 or 4 bytes) packed as binary integer (big endian). Then follows the message data followed by a new message length header etc.
  */
@@ -458,7 +526,8 @@ static void apx_serverConnectionBase_fileInfoNotifyImpl(void *arg, const apx_fil
 
 static apx_error_t apx_serverConnectionBase_processNewDefinitionFile(apx_serverConnectionBase_t *self, const apx_fileInfo_t *fileInfo)
 {
-   if ( (fileInfo->fileType == RMF_FILE_TYPE_FIXED) && ( (fileInfo->address & RMF_REMOTE_ADDRESS_BIT) != 0))
+   if ( ( (fileInfo->fileType == RMF_FILE_TYPE_FIXED) || (fileInfo->fileType == RMF_FILE_TYPE_COMPRESSED_FIXED) ) &&
+        ( (fileInfo->address & RMF_REMOTE_ADDRESS_BIT) != 0))
    {
       apx_error_t retval = APX_NO_ERROR;
       char *nodeName = apx_fileInfo_getBaseName(fileInfo);
@@ -479,7 +548,7 @@ static apx_error_t apx_serverConnectionBase_processNewDefinitionFile(apx_serverC
                nodeData = apx_nodeInstance_getNodeData(nodeInstance);
                if (nodeData != 0)
                {
-                  retval = apx_nodeInstance_createDefinitionBuffer(nodeInstance, fileInfo->length);
+                  retval = apx_nodeInstance_createDefinitionBuffer(nodeInstance, fileInfo->uncompressedLength);
                   if (retval == APX_NO_ERROR)
                   {
                      apx_file_t *remoteFile = apx_fileManager_findFileByAddress(&self->base.fileManager, fileInfo->address);
@@ -505,31 +574,58 @@ static apx_error_t apx_serverConnectionBase_processNewDefinitionFile(apx_serverC
 
 static void apx_serverConnectionBase_definitionDataWriteNotify(apx_serverConnectionBase_t *self, apx_nodeInstance_t *nodeInstance, uint32_t offset, uint32_t len)
 {
-   apx_programType_t errProgramType;
-   apx_uniquePortId_t errPortId;
-   apx_portCount_t numProvidePorts;
    apx_error_t rc;
-#if APX_DEBUG_ENABLE
-   printf("Calling APX parser\n");
-#endif
-   rc = apx_nodeManager_parseDefinition(&self->base.nodeManager, nodeInstance);
-   if (rc != APX_NO_ERROR )
+   apx_fileCache_t *nodeInfoCache = (self->server != 0)? apx_server_getNodeInfoCache(self->server) : (apx_fileCache_t*) 0;
+   apx_nodeData_t *nodeData = apx_nodeInstance_getNodeData(nodeInstance);
+   apx_nodeInfo_t *cachedNodeInfo = (apx_nodeInfo_t*) 0;
+   assert(nodeData != 0);
+   if (nodeInfoCache != 0)
    {
-      printf("APX file parse failure (%d)\n", (int) rc);
-      ///TODO: send error code back to client
-      return;
+      rc = apx_nodeData_calcDefinitionChecksum(nodeData);
+      if (rc == APX_NO_ERROR)
+      {
+         cachedNodeInfo = apx_fileCache_findNodeInfo(nodeInfoCache, apx_nodeData_getDefinitionChecksumData(nodeData));
+      }
    }
-   rc = apx_nodeInstance_buildNodeInfo(nodeInstance, &errProgramType, &errPortId);
-   if (rc != APX_NO_ERROR)
+   if (cachedNodeInfo != 0)
    {
-      printf("APX build node info failure (%d)\n", (int) rc);
-      ///TODO: send error code back to client
-      return;
+      //Identical definition has been seen before, skip parsing and compilation
+      rc = apx_nodeInstance_attachNodeInfo(nodeInstance, cachedNodeInfo);
+      apx_nodeInfo_release(cachedNodeInfo);
+      if (rc != APX_NO_ERROR)
+      {
+         printf("APX attach node info failure (%d)\n", (int) rc);
+         return;
+      }
+   }
+   else
+   {
+      if (apx_serverConnectionBase_submitCompileJob(self, nodeInstance))
+      {
+         //Processing continues in apx_serverConnectionBase_compileCompleteNotify
+         return;
+      }
+      rc = apx_serverConnectionBase_buildNodeInfo(self, nodeInstance);
+      if (rc != APX_NO_ERROR)
+      {
+         ///TODO: send error code back to client
+         return;
+      }
+      apx_serverConnectionBase_insertIntoNodeInfoCache(self, nodeInstance);
    }
-   apx_nodeInstance_cleanParseTree(nodeInstance);
 #if APX_DEBUG_ENABLE
    printf("%s.apx: Parse Success (%d bytes)\n", apx_nodeInstance_getName(nodeInstance), len);
 #endif
+   apx_serverConnectionBase_completeNodeInstance(self, nodeInstance);
+}
+
+/**
+ * Creates port data buffers, port references and connector tables once nodeInstance has a nodeInfo
+ */
+static void apx_serverConnectionBase_completeNodeInstance(apx_serverConnectionBase_t *self, apx_nodeInstance_t *nodeInstance)
+{
+   apx_portCount_t numProvidePorts;
+   apx_error_t rc;
    rc = apx_nodeInstance_createPortDataBuffers(nodeInstance);
    if (rc != APX_NO_ERROR)
    {
@@ -569,6 +665,145 @@ static void apx_serverConnectionBase_definitionDataWriteNotify(apx_serverConnect
    }
 }
 
+/**
+ * Parses the definition data of nodeInstance and compiles its port programs
+ */
+static apx_error_t apx_serverConnectionBase_buildNodeInfo(apx_serverConnectionBase_t *self, apx_nodeInstance_t *nodeInstance)
+{
+   apx_programType_t errProgramType;
+   apx_uniquePortId_t errPortId;
+   apx_error_t rc;
+#if APX_DEBUG_ENABLE
+   printf("Calling APX parser\n");
+#endif
+   rc = apx_nodeManager_parseDefinition(&self->base.nodeManager, nodeInstance);
+   if (rc != APX_NO_ERROR )
+   {
+      printf("APX file parse failure (%d)\n", (int) rc);
+      return rc;
+   }
+   rc = apx_nodeInstance_buildNodeInfo(nodeInstance, &errProgramType, &errPortId);
+   if (rc != APX_NO_ERROR)
+   {
+      printf("APX build node info failure (%d)\n", (int) rc);
+      return rc;
+   }
+   apx_nodeInstance_cleanParseTree(nodeInstance);
+   return APX_NO_ERROR;
+}
+
+/**
+ * Hands nodeInstance over to the server compile pool. Returns false when there is no pool or it is full,
+ * the caller then compiles the node on the current thread.
+ */
+static bool apx_serverConnectionBase_submitCompileJob(apx_serverConnectionBase_t *self, apx_nodeInstance_t *nodeInstance)
+{
+   apx_compilePool_t *compilePool = (self->server != 0)? apx_server_getCompilePool(self->server) : (apx_compilePool_t*) 0;
+   if (compilePool != 0)
+   {
+      apx_error_t rc;
+      apx_compileJob_t *job = apx_compilePool_createJob(compilePool, nodeInstance, apx_serverConnectionBase_compileJobComplete, (void*) self, &rc);
+      if (job == 0)
+      {
+         return false;
+      }
+      //The job is added to the list before it is scheduled so that it is known when its completion event is processed
+      SPINLOCK_ENTER(self->compileJobLock);
+      job->nextPending = self->pendingCompileJobs;
+      self->pendingCompileJobs = job;
+      SPINLOCK_LEAVE(self->compileJobLock);
+      apx_compilePool_scheduleJob(compilePool, job);
+      return true;
+   }
+   return false;
+}
+
+/**
+ * Called from a compile pool thread. Moves the job over to the event handler thread of this connection.
+ */
+static void apx_serverConnectionBase_compileJobComplete(void *arg, apx_compileJob_t *job)
+{
+   apx_serverConnectionBase_t *self = (apx_serverConnectionBase_t*) arg;
+   apx_event_t event;
+   memset(&event, 0, APX_EVENT_SIZE);
+   event.evType = APX_EVENT_NODE_COMPILE_COMPLETE;
+   event.evData1 = (void*) job;
+   apx_connectionBase_emitGenericEvent(&self->base, &event);
+}
+
+static void apx_serverConnectionBase_compileCompleteNotify(apx_serverConnectionBase_t *self, apx_compileJob_t *job)
+{
+   bool isPending = false;
+   apx_compileJob_t **ppJob;
+   apx_nodeInstance_t *nodeInstance;
+   SPINLOCK_ENTER(self->compileJobLock);
+   for (ppJob = &self->pendingCompileJobs; *ppJob != 0; ppJob = &(*ppJob)->nextPending)
+   {
+      if (*ppJob == job)
+      {
+         *ppJob = job->nextPending;
+         isPending = true;
+         break;
+      }
+   }
+   SPINLOCK_LEAVE(self->compileJobLock);
+   if (!isPending)
+   {
+      return;
+   }
+   nodeInstance = job->nodeInstance;
+   if (job->result == APX_NO_ERROR)
+   {
+      char msg[APX_MAX_LOG_LEN];
+      sprintf(msg, "%.200s.apx compiled in %u us (queued %u us)", apx_nodeInstance_getName(nodeInstance), (unsigned int) job->compileTimeUs, (unsigned int) job->queueTimeUs);
+      apx_server_logEvent(self->server, APX_LOG_LEVEL_DEBUG, "compile", msg);
+      apx_serverConnectionBase_insertIntoNodeInfoCache(self, nodeInstance);
+      apx_serverConnectionBase_completeNodeInstance(self, nodeInstance);
+   }
+   else
+   {
+      char msg[APX_MAX_LOG_LEN];
+      //nodeInfo (and thereby the node name) is not available when compilation fails
+      sprintf(msg, "Node definition failed to compile (error %d)", (int) job->result);
+      apx_server_logEvent(self->server, APX_LOG_LEVEL_ERROR, "compile", msg);
+      ///TODO: send error code back to client
+   }
+   apx_compilePool_releaseJob(job->pool, job);
+}
+
+/**
+ * Cancels queued jobs and waits for running jobs to finish. Must be called before the event loop is destroyed.
+ */
+static void apx_serverConnectionBase_releasePendingCompileJobs(apx_serverConnectionBase_t *self)
+{
+   for(;;)
+   {
+      apx_compileJob_t *job;
+      SPINLOCK_ENTER(self->compileJobLock);
+      job = self->pendingCompileJobs;
+      if (job != 0)
+      {
+         self->pendingCompileJobs = job->nextPending;
+      }
+      SPINLOCK_LEAVE(self->compileJobLock);
+      if (job == 0)
+      {
+         break;
+      }
+      apx_compilePool_releaseJob(job->pool, job);
+   }
+}
+
+static void apx_serverConnectionBase_insertIntoNodeInfoCache(apx_serverConnectionBase_t *self, apx_nodeInstance_t *nodeInstance)
+{
+   apx_fileCache_t *nodeInfoCache = (self->server != 0)? apx_server_getNodeInfoCache(self->server) : (apx_fileCache_t*) 0;
+   apx_nodeData_t *nodeData = apx_nodeInstance_getNodeData(nodeInstance);
+   if ( (nodeInfoCache != 0) && (apx_nodeData_getDefinitionChecksumType(nodeData) == APX_CHECKSUM_SHA256) )
+   {
+      (void) apx_fileCache_insertNodeInfo(nodeInfoCache, apx_nodeData_getDefinitionChecksumData(nodeData), apx_nodeInstance_getNodeInfo(nodeInstance));
+   }
+}
+
 static apx_error_t apx_serverConnectionBase_providePortDataWriteNotify(apx_serverConnectionBase_t *self, apx_nodeInstance_t *nodeInstance, uint32_t offset, const uint8_t *data, uint32_t len)
 {
    apx_error_t rc;
@@ -35,6 +35,8 @@
 #include "CuTest.h"
 #include "apx_server.h"
 #include "apx_serverTestConnection.h"
+#include "apx_client.h"
+#include "apx_clientTestConnection.h"
 #include "apx_connectionEventSpy.h"
 #include "apx_transmitHandlerSpy.h"
 #include "apx_nodeManager.h"
@@ -47,6 +49,9 @@
 //////////////////////////////////////////////////////////////////////////////
 // CONSTANTS AND DATA TYPES
 //////////////////////////////////////////////////////////////////////////////
+#define NUM_QUEUED_ROUNDS 5
+#define NUM_QUEUED_ELEMENTS_PER_ROUND 10 //more than the queue length, each round needs several transfers
+#define MAX_PUMP_ITERATIONS 100
 
 //////////////////////////////////////////////////////////////////////////////
 // LOCAL FUNCTION PROTOTYPES
@@ -60,6 +65,9 @@ static void test_connectors_nodeWithRequirePortIsConnectedAfterNodeWithProvidePo
 static void test_connectors_nodeWithProvidePortIsConnectedAfterMultipleRequireNodesAreWaiting(CuTest* tc);
 static void test_connectors_nodeWithProvidePortIsDisconnectedFromMultipleRequireNodes(CuTest* tc);
 static void test_connectors_nodeWithRequirePortIsDisconnectedFromProviderNodeInDifferentApxConnection(CuTest* tc);
+static void test_conflation_eventPortIsNotConflated(CuTest* tc);
+static void test_queuedPort_elementsRoutedFromClientToClientInOrder(CuTest* tc);
+static void pumpMessages(CuTest* tc, apx_client_t **clients, apx_clientTestConnection_t **clientConnections, apx_serverTestConnection_t **serverConnections, int32_t numClients);
 
 
 //////////////////////////////////////////////////////////////////////////////
@@ -81,6 +89,28 @@ static const char *m_apx_definition3 = "APX/1.2\n"
       "R\"VehicleSpeed\"S:=65535\n"
       "\n";
 
+static const char *m_apx_definition4 = "APX/1.3\n"
+      "N\"TestNode4\"\n"
+      "P\"Event\"C:=0\n"
+      "P\"Status\"C:=0\n"
+      "\n";
+
+static const char *m_apx_definition5 = "APX/1.3\n"
+      "N\"TestNode5\"\n"
+      "R\"Event\"C:=0, E\n"
+      "R\"Status\"C:=0\n"
+      "\n";
+
+static const char *m_apx_definition6 = "APX/1.2\n"
+      "N\"QueueProducer\"\n"
+      "P\"Events\"C:Q[4]\n"
+      "\n";
+
+static const char *m_apx_definition7 = "APX/1.2\n"
+      "N\"QueueConsumer\"\n"
+      "R\"Events\"C:Q[4]\n"
+      "\n";
+
 //////////////////////////////////////////////////////////////////////////////
 // GLOBAL FUNCTIONS
 //////////////////////////////////////////////////////////////////////////////
@@ -96,6 +126,8 @@ CuSuite* testSuite_apx_dataRouting(void)
    SUITE_ADD_TEST(suite, test_connectors_nodeWithProvidePortIsConnectedAfterMultipleRequireNodesAreWaiting);
    SUITE_ADD_TEST(suite, test_connectors_nodeWithProvidePortIsDisconnectedFromMultipleRequireNodes);
    SUITE_ADD_TEST(suite, test_connectors_nodeWithRequirePortIsDisconnectedFromProviderNodeInDifferentApxConnection);
+   SUITE_ADD_TEST(suite, test_conflation_eventPortIsNotConflated);
+   SUITE_ADD_TEST(suite, test_queuedPort_elementsRoutedFromClientToClientInOrder);
 
    return suite;
 }
@@ -980,3 +1012,250 @@ static void test_connectors_nodeWithRequirePortIsDisconnectedFromProviderNodeInD
    apx_serverTestConnection_runEventLoop(connection2);
    apx_server_delete(server);
 }
+
+/**
+ * On a conflating connection, three writes to TestNode5.Status result in a single transfer of the latest value
+ * while every write to TestNode5.Event (which has the E attribute) is transferred.
+ */
+static void test_conflation_eventPortIsNotConflated(CuTest* tc)
+{
+   apx_serverTestConnection_t *connection;
+   rmf_fileInfo_t fileInfo;
+   uint8_t *buffer;
+   apx_server_t *server;
+   apx_size_t definitionLen;
+   apx_nodeInstance_t *nodeInstance5;
+   const apx_portDataProps_t *props;
+   uint8_t rawProvidePortData[UINT8_SIZE*2];
+   uint8_t eventValues[3];
+   int32_t numEventValues = 0;
+   int32_t numStatusValues = 0;
+   uint8_t lastStatusValue = 0u;
+   int32_t i;
+
+   //Init
+   server = apx_server_new();
+   connection = apx_serverTestConnection_new();
+   apx_server_acceptConnection(server, (apx_serverConnectionBase_t*) connection);
+   apx_connectionBase_setConflationEnabled((apx_connectionBase_t*) connection, true);
+   apx_serverTestConnection_onProtocolHeaderReceived(connection);
+   apx_serverTestConnection_runEventLoop(connection);
+
+   //Client sends TestNode4 (provider)
+   definitionLen = strlen(m_apx_definition4);
+   rmf_fileInfo_create(&fileInfo, "TestNode4.apx", APX_ADDRESS_DEFINITION_START, definitionLen, RMF_FILE_TYPE_FIXED);
+   apx_serverTestConnection_onFileInfoMsgReceived(connection, &fileInfo);
+   rmf_fileInfo_create(&fileInfo, "TestNode4.out", 0u, UINT8_SIZE*2, RMF_FILE_TYPE_FIXED);
+   apx_serverTestConnection_onFileInfoMsgReceived(connection, &fileInfo);
+   apx_serverTestConnection_runEventLoop(connection);
+   buffer = (uint8_t*) malloc(RMF_HIGH_ADDRESS_SIZE+definitionLen);
+   assert(buffer != 0);
+   CuAssertIntEquals(tc, RMF_HIGH_ADDRESS_SIZE, rmf_packHeader(&buffer[0], RMF_HIGH_ADDRESS_SIZE, APX_ADDRESS_DEFINITION_START, false));
+   memcpy(&buffer[RMF_HIGH_ADDRESS_SIZE], &m_apx_definition4[0], definitionLen);
+   CuAssertIntEquals(tc, APX_NO_ERROR, apx_serverTestConnection_onSerializedMsgReceived(connection, buffer, RMF_HIGH_ADDRESS_SIZE+definitionLen));
+   apx_serverTestConnection_runEventLoop(connection);
+   free(buffer);
+
+   //Client sends TestNode5 (receiver)
+   definitionLen = strlen(m_apx_definition5);
+   rmf_fileInfo_create(&fileInfo, "TestNode5.apx", APX_ADDRESS_DEFINITION_START+APX_ADDRESS_DEFINITION_BOUNDARY, definitionLen, RMF_FILE_TYPE_FIXED);
+   apx_serverTestConnection_onFileInfoMsgReceived(connection, &fileInfo);
+   apx_serverTestConnection_runEventLoop(connection);
+   buffer = (uint8_t*) malloc(RMF_HIGH_ADDRESS_SIZE+definitionLen);
+   assert(buffer != 0);
+   CuAssertIntEquals(tc, RMF_HIGH_ADDRESS_SIZE, rmf_packHeader(&buffer[0], RMF_HIGH_ADDRESS_SIZE, APX_ADDRESS_DEFINITION_START+APX_ADDRESS_DEFINITION_BOUNDARY, false));
+   memcpy(&buffer[RMF_HIGH_ADDRESS_SIZE], &m_apx_definition5[0], definitionLen);
+   CuAssertIntEquals(tc, APX_NO_ERROR, apx_serverTestConnection_onSerializedMsgReceived(connection, buffer, RMF_HIGH_ADDRESS_SIZE+definitionLen));
+   apx_serverTestConnection_runEventLoop(connection);
+   free(buffer);
+   nodeInstance5 = apx_serverTestConnection_findNodeInstance(connection, "TestNode5");
+   CuAssertPtrNotNull(tc, nodeInstance5);
+   props = apx_nodeInfo_getRequirePortDataProps(apx_nodeInstane_getNodeInfo(nodeInstance5), 0);
+   CuAssertPtrNotNull(tc, props);
+   CuAssertTrue(tc, !apx_portDataProps_isConflatable(props));
+   props = apx_nodeInfo_getRequirePortDataProps(apx_nodeInstane_getNodeInfo(nodeInstance5), 1);
+   CuAssertPtrNotNull(tc, props);
+   CuAssertTrue(tc, apx_portDataProps_isConflatable(props));
+
+   //Client sends fileOpen("TestNode5.in")
+   CuAssertIntEquals(tc, APX_NO_ERROR, apx_serverTestConnection_onFileOpenMsgReceived(connection, 0u));
+   apx_serverTestConnection_runEventLoop(connection);
+   apx_serverTestConnection_clearTransmitLogMsg(connection);
+
+   //TestNode4 writes both ports three times before the worker gets to run
+   buffer = (uint8_t*) malloc(RMF_LOW_ADDRESS_SIZE+UINT8_SIZE*2);
+   assert(buffer != 0);
+   for (i = 1; i <= 3; i++)
+   {
+      rawProvidePortData[0] = (uint8_t) i; //Event
+      rawProvidePortData[1] = (uint8_t) (i * 10); //Status
+      CuAssertIntEquals(tc, RMF_LOW_ADDRESS_SIZE, rmf_packHeader(&buffer[0], RMF_LOW_ADDRESS_SIZE, 0u, false));
+      memcpy(&buffer[RMF_LOW_ADDRESS_SIZE], &rawProvidePortData[0], UINT8_SIZE*2);
+      CuAssertIntEquals(tc, APX_NO_ERROR, apx_serverTestConnection_onSerializedMsgReceived(connection, buffer, RMF_LOW_ADDRESS_SIZE+UINT8_SIZE*2));
+   }
+   free(buffer);
+   apx_serverTestConnection_runEventLoop(connection);
+
+   //Verify transmitted data of TestNode5.in
+   for (i = 0; i < apx_serverTestConnection_getTransmitLogLen(connection); i++)
+   {
+      adt_bytearray_t *transmittedMsg = apx_serverTestConnection_getTransmitLogMsg(connection, i);
+      const uint8_t *transmittedBytes = adt_bytearray_data(transmittedMsg);
+      uint32_t msgLen = adt_bytearray_length(transmittedMsg);
+      uint32_t address = rmf_unpackAddress(transmittedBytes, RMF_LOW_ADDRESS_SIZE);
+      uint32_t j;
+      for (j = 0u; j < msgLen - RMF_LOW_ADDRESS_SIZE; j++)
+      {
+         if (address + j == 0u)
+         {
+            CuAssertTrue(tc, numEventValues < 3);
+            eventValues[numEventValues++] = transmittedBytes[RMF_LOW_ADDRESS_SIZE + j];
+         }
+         else if (address + j == 1u)
+         {
+            numStatusValues++;
+            lastStatusValue = transmittedBytes[RMF_LOW_ADDRESS_SIZE + j];
+         }
+      }
+   }
+   CuAssertIntEquals(tc, 3, numEventValues);
+   CuAssertUIntEquals(tc, 1, eventValues[0]);
+   CuAssertUIntEquals(tc, 2, eventValues[1]);
+   CuAssertUIntEquals(tc, 3, eventValues[2]);
+   CuAssertIntEquals(tc, 1, numStatusValues);
+   CuAssertUIntEquals(tc, 30, lastStatusValue);
+
+   //Cleanup
+   apx_serverTestConnection_runEventLoop(connection);
+   apx_server_delete(server);
+}
+
+/**
+ * Two clients, each on its own server connection. The producer writes more elements than fit into one transfer,
+ * the consumer must receive every one of them exactly once and in the order they were written.
+ */
+static void test_queuedPort_elementsRoutedFromClientToClientInOrder(CuTest* tc)
+{
+   apx_server_t *server;
+   apx_client_t *clients[2];
+   apx_clientTestConnection_t *clientConnections[2];
+   apx_serverTestConnection_t *serverConnections[2];
+   void *producerHandle;
+   void *consumerHandle;
+   uint8_t received[NUM_QUEUED_ROUNDS * NUM_QUEUED_ELEMENTS_PER_ROUND];
+   int32_t numReceived = 0;
+   int32_t round;
+   int32_t i;
+
+   //Init
+   server = apx_server_new();
+   for (i = 0; i < 2; i++)
+   {
+      clients[i] = apx_client_new();
+      CuAssertPtrNotNull(tc, clients[i]);
+      CuAssertIntEquals(tc, APX_NO_ERROR, apx_client_buildNode_cstr(clients[i], (i == 0)? m_apx_definition6 : m_apx_definition7));
+      clientConnections[i] = apx_clientTestConnection_new();
+      CuAssertPtrNotNull(tc, clientConnections[i]);
+      apx_client_attachConnection(clients[i], (apx_clientConnectionBase_t*) clientConnections[i]);
+      serverConnections[i] = apx_serverTestConnection_new();
+      CuAssertPtrNotNull(tc, serverConnections[i]);
+      apx_server_acceptConnection(server, (apx_serverConnectionBase_t*) serverConnections[i]);
+   }
+   producerHandle = apx_client_getPortHandle(clients[0], "QueueProducer", "Events");
+   CuAssertPtrNotNull(tc, producerHandle);
+   consumerHandle = apx_client_getPortHandle(clients[1], "QueueConsumer", "Events");
+   CuAssertPtrNotNull(tc, consumerHandle);
+
+   //Protocol header exchange is done out of band, everything after it goes through the serialized message path
+   for (i = 0; i < 2; i++)
+   {
+      apx_clientTestConnection_connect(clientConnections[i]);
+      apx_clientTestConnection_clearTransmitLog(clientConnections[i]);
+      apx_serverTestConnection_onProtocolHeaderReceived(serverConnections[i]);
+      apx_serverTestConnection_runEventLoop(serverConnections[i]);
+      apx_serverTestConnection_clearTransmitLogMsg(serverConnections[i]);
+      apx_clientTestConnection_headerAccepted(clientConnections[i]);
+   }
+   pumpMessages(tc, clients, clientConnections, serverConnections, 2);
+   CuAssertPtrNotNull(tc, apx_serverTestConnection_findNodeInstance(serverConnections[0], "QueueProducer"));
+   CuAssertPtrNotNull(tc, apx_serverTestConnection_findNodeInstance(serverConnections[1], "QueueConsumer"));
+
+   //Producer writes a burst of elements per round, consumer drains its queue after each round
+   for (round = 0; round < NUM_QUEUED_ROUNDS; round++)
+   {
+      int32_t numRead;
+      for (i = 1; i <= NUM_QUEUED_ELEMENTS_PER_ROUND; i++)
+      {
+         CuAssertIntEquals(tc, APX_NO_ERROR, apx_client_writePortData_u8(clients[0], producerHandle, (uint8_t) (round * NUM_QUEUED_ELEMENTS_PER_ROUND + i)));
+      }
+      pumpMessages(tc, clients, clientConnections, serverConnections, 2);
+      numRead = apx_client_readQueuedPortData(clients[1], consumerHandle, &received[numReceived], (int32_t) sizeof(received) - numReceived);
+      CuAssertIntEquals(tc, NUM_QUEUED_ELEMENTS_PER_ROUND, numRead);
+      numReceived += numRead;
+   }
+
+   //Verify that nothing was lost, duplicated or reordered
+   CuAssertIntEquals(tc, NUM_QUEUED_ROUNDS * NUM_QUEUED_ELEMENTS_PER_ROUND, numReceived);
+   for (i = 0; i < numReceived; i++)
+   {
+      CuAssertUIntEquals(tc, (uint8_t) (i + 1), received[i]);
+   }
+   CuAssertIntEquals(tc, 0, apx_client_readQueuedPortData(clients[1], consumerHandle, &received[0], 1));
+
+   //Cleanup
+   for (i = 0; i < 2; i++)
+   {
+      apx_serverTestConnection_runEventLoop(serverConnections[i]);
+      apx_client_run(clients[i]);
+   }
+   apx_server_delete(server);
+   for (i = 0; i < 2; i++)
+   {
+      apx_client_delete(clients[i]);
+   }
+}
+
+/**
+ * Moves messages client i -> server connection i and server connection i -> client i until no side has anything left to send.
+ */
+static void pumpMessages(CuTest* tc, apx_client_t **clients, apx_clientTestConnection_t **clientConnections, apx_serverTestConnection_t **serverConnections, int32_t numClients)
+{
+   int32_t iteration;
+   for (iteration = 0; iteration < MAX_PUMP_ITERATIONS; iteration++)
+   {
+      int32_t numMessages = 0;
+      int32_t i;
+      for (i = 0; i < numClients; i++)
+      {
+         int32_t j;
+         apx_client_run(clients[i]);
+         for (j = 0; j < apx_clientTestConnection_getTransmitLogLen(clientConnections[i]); j++)
+         {
+            adt_bytearray_t *msg = apx_clientTestConnection_getTransmitLogMsg(clientConnections[i], j);
+            CuAssertIntEquals(tc, APX_NO_ERROR, apx_serverTestConnection_onSerializedMsgReceived(serverConnections[i], adt_bytearray_data(msg), (int32_t) adt_bytearray_length(msg)));
+            numMessages++;
+         }
+         apx_clientTestConnection_clearTransmitLog(clientConnections[i]);
+      }
+      for (i = 0; i < numClients; i++)
+      {
+         apx_serverTestConnection_runEventLoop(serverConnections[i]);
+      }
+      for (i = 0; i < numClients; i++)
+      {
+         int32_t j;
+         for (j = 0; j < apx_serverTestConnection_getTransmitLogLen(serverConnections[i]); j++)
+         {
+            adt_bytearray_t *msg = apx_serverTestConnection_getTransmitLogMsg(serverConnections[i], j);
+            CuAssertIntEquals(tc, APX_NO_ERROR, apx_clientTestConnection_onSerializedMsgReceived(clientConnections[i], adt_bytearray_data(msg), (int32_t) adt_bytearray_length(msg)));
+            numMessages++;
+         }
+         apx_serverTestConnection_clearTransmitLogMsg(serverConnections[i]);
+      }
+      if (numMessages == 0)
+      {
+         return;
+      }
+   }
+   CuFail(tc, "messages are still being exchanged after MAX_PUMP_ITERATIONS");
+}
@@ -68,6 +68,13 @@ static void test_serverProcessesDefinitionAfterClientWritesDefinitionData(CuTest
 static void test_serverCreatesOutPortDataBuffersAfterProcessingNodeDefinition(CuTest* tc);
 static void test_serverDetectsOutPortDataFileAfterProcessingNodeDefinition(CuTest* tc);
 static void test_clientWritesToProvidePortDataFileAfterServerHasOpenedIt(CuTest* tc);
+static void test_reconnectingNodeReusesCachedNodeInfo(CuTest* tc);
+static void test_definitionIsCompiledOnCompilePool(CuTest* tc);
+static void test_pingRequestIsEchoedBack(CuTest* tc);
+static void test_pingResponseUpdatesLatencyStatistics(CuTest* tc);
+static void test_fragmentInterleaveIsNegotiatedInGreeting(CuTest* tc);
+static void sendDefinitionFile(CuTest* tc, apx_serverTestConnection_t *connection, const char *fileName, const char *definition);
+static void latencySpy_onConnectionLatency(void *arg, apx_serverConnectionBase_t *connection, const apx_latencySummary_t *summary);
 
 
 
@@ -92,6 +99,11 @@ CuSuite* testSuite_apx_serverConnection(void)
    SUITE_ADD_TEST(suite, test_serverCreatesOutPortDataBuffersAfterProcessingNodeDefinition);
    SUITE_ADD_TEST(suite, test_serverDetectsOutPortDataFileAfterProcessingNodeDefinition);
    SUITE_ADD_TEST(suite, test_clientWritesToProvidePortDataFileAfterServerHasOpenedIt);
+   SUITE_ADD_TEST(suite, test_reconnectingNodeReusesCachedNodeInfo);
+   SUITE_ADD_TEST(suite, test_definitionIsCompiledOnCompilePool);
+   SUITE_ADD_TEST(suite, test_pingRequestIsEchoedBack);
+   SUITE_ADD_TEST(suite, test_pingResponseUpdatesLatencyStatistics);
+   SUITE_ADD_TEST(suite, test_fragmentInterleaveIsNegotiatedInGreeting);
 
    return suite;
 }
@@ -415,3 +427,210 @@ static void test_clientWritesToProvidePortDataFileAfterServerHasOpenedIt(CuTest*
    apx_server_delete(server);
    free(buffer);
 }
+
+static void test_reconnectingNodeReusesCachedNodeInfo(CuTest* tc)
+{
+   apx_server_t *server;
+   apx_serverTestConnection_t *connection1;
+   apx_serverTestConnection_t *connection2;
+   apx_nodeInstance_t *nodeInstance1;
+   apx_nodeInstance_t *nodeInstance2;
+   apx_fileCacheStats_t stats;
+
+   server = apx_server_new();
+   connection1 = apx_serverTestConnection_new();
+   connection2 = apx_serverTestConnection_new();
+   apx_server_acceptConnection(server, (apx_serverConnectionBase_t*) connection1);
+   apx_server_acceptConnection(server, (apx_serverConnectionBase_t*) connection2);
+
+   sendDefinitionFile(tc, connection1, "TestNode.apx", m_apx_definition1);
+   apx_server_getNodeInfoCacheStats(server, &stats);
+   CuAssertUIntEquals(tc, 0u, stats.numHits);
+   CuAssertUIntEquals(tc, 1u, stats.numMisses);
+   CuAssertUIntEquals(tc, 1u, stats.numEntries);
+
+   //Same definition arriving on another connection is not parsed again
+   sendDefinitionFile(tc, connection2, "TestNode.apx", m_apx_definition1);
+   apx_server_getNodeInfoCacheStats(server, &stats);
+   CuAssertUIntEquals(tc, 1u, stats.numHits);
+   CuAssertUIntEquals(tc, 1u, stats.numMisses);
+   CuAssertUIntEquals(tc, 1u, stats.numEntries);
+
+   nodeInstance1 = apx_serverTestConnection_findNodeInstance(connection1, "TestNode");
+   nodeInstance2 = apx_serverTestConnection_findNodeInstance(connection2, "TestNode");
+   CuAssertPtrNotNull(tc, nodeInstance1);
+   CuAssertPtrNotNull(tc, nodeInstance2);
+   CuAssertPtrNotNull(tc, apx_nodeInstance_getNodeInfo(nodeInstance1));
+   CuAssertPtrEquals(tc, apx_nodeInstance_getNodeInfo(nodeInstance1), apx_nodeInstance_getNodeInfo(nodeInstance2));
+   CuAssertPtrEquals(tc, 0, apx_nodeInstance_getParseTree(nodeInstance2));
+   CuAssertUIntEquals(tc, UINT16_SIZE, apx_nodeData_getProvidePortDataLen(apx_nodeInstance_getNodeData(nodeInstance2)));
+
+   apx_server_delete(server);
+}
+
+static void test_definitionIsCompiledOnCompilePool(CuTest* tc)
+{
+   apx_server_t *server;
+   apx_serverTestConnection_t *connection;
+   apx_nodeInstance_t *nodeInstance;
+   apx_compilePoolStats_t stats;
+
+   server = apx_server_new();
+   CuAssertIntEquals(tc, APX_NO_ERROR, apx_server_setCompileThreads(server, 1u));
+   connection = apx_serverTestConnection_new();
+   apx_server_acceptConnection(server, (apx_serverConnectionBase_t*) connection);
+
+   sendDefinitionFile(tc, connection, "TestNode.apx", m_apx_definition1);
+   nodeInstance = apx_serverTestConnection_findNodeInstance(connection, "TestNode");
+   CuAssertPtrNotNull(tc, nodeInstance);
+   CuAssertPtrEquals(tc, 0, apx_nodeInstance_getNodeInfo(nodeInstance));
+   apx_server_getCompilePoolStats(server, &stats);
+   CuAssertUIntEquals(tc, 1u, stats.queueDepth);
+   CuAssertUIntEquals(tc, 0u, stats.numCompleted);
+
+   CuAssertTrue(tc, !apx_compilePool_run(apx_server_getCompilePool(server)));
+   apx_server_getCompilePoolStats(server, &stats);
+   CuAssertUIntEquals(tc, 0u, stats.queueDepth);
+   CuAssertUIntEquals(tc, 1u, stats.maxQueueDepth);
+   CuAssertUIntEquals(tc, 1u, stats.numCompleted);
+   CuAssertUIntEquals(tc, 0u, stats.numFailed);
+   //Node is completed on the connection event thread
+   CuAssertUIntEquals(tc, 0u, apx_nodeData_getProvidePortDataLen(apx_nodeInstance_getNodeData(nodeInstance)));
+   apx_serverTestConnection_runEventLoop(connection);
+   CuAssertPtrNotNull(tc, apx_nodeInstance_getNodeInfo(nodeInstance));
+   CuAssertPtrEquals(tc, 0, apx_nodeInstance_getParseTree(nodeInstance));
+   CuAssertUIntEquals(tc, UINT16_SIZE, apx_nodeData_getProvidePortDataLen(apx_nodeInstance_getNodeData(nodeInstance)));
+
+   apx_server_delete(server);
+}
+
+static void test_pingRequestIsEchoedBack(CuTest* tc)
+{
+   apx_serverTestConnection_t connection;
+   uint8_t buffer[RMF_HIGH_ADDRESS_SIZE + RMF_CMD_PING_LEN];
+   adt_bytearray_t *transmittedMsg;
+   rmf_cmdPing_t request;
+   rmf_cmdPing_t response;
+   const uint8_t *data;
+
+   apx_serverTestConnection_create(&connection);
+   apx_serverTestConnection_start(&connection);
+   request.sequence = 17u;
+   request.timestamp = 0x0000001122334455ull;
+   CuAssertIntEquals(tc, RMF_HIGH_ADDRESS_SIZE, rmf_packHeader(&buffer[0], RMF_HIGH_ADDRESS_SIZE, RMF_CMD_START_ADDR, false));
+   CuAssertIntEquals(tc, RMF_CMD_PING_LEN, rmf_serialize_cmdPing(&buffer[RMF_HIGH_ADDRESS_SIZE], RMF_CMD_PING_LEN, RMF_CMD_PING_RQST, &request));
+   CuAssertIntEquals(tc, APX_NO_ERROR, apx_serverTestConnection_onSerializedMsgReceived(&connection, buffer, (int32_t) sizeof(buffer)));
+   apx_serverTestConnection_runEventLoop(&connection);
+   CuAssertIntEquals(tc, 1, apx_serverTestConnection_getTransmitLogLen(&connection));
+   transmittedMsg = apx_serverTestConnection_getTransmitLogMsg(&connection, 0);
+   CuAssertIntEquals(tc, RMF_HIGH_ADDRESS_SIZE + RMF_CMD_PING_LEN, adt_bytearray_length(transmittedMsg));
+   data = adt_bytearray_data(transmittedMsg) + RMF_HIGH_ADDRESS_SIZE;
+   CuAssertUIntEquals(tc, RMF_CMD_PING_RSP, unpackLE(data, RMF_CMD_TYPE_LEN));
+   CuAssertIntEquals(tc, RMF_CMD_PING_LEN - RMF_CMD_TYPE_LEN, rmf_deserialize_cmdPing(data + RMF_CMD_TYPE_LEN, RMF_CMD_PING_LEN - RMF_CMD_TYPE_LEN, &response));
+   CuAssertUIntEquals(tc, request.sequence, response.sequence);
+   CuAssertTrue(tc, request.timestamp == response.timestamp);
+   apx_serverTestConnection_destroy(&connection);
+}
+
+static void test_pingResponseUpdatesLatencyStatistics(CuTest* tc)
+{
+   apx_server_t *server;
+   apx_serverTestConnection_t *connection;
+   apx_serverEventListener_t listener;
+   apx_latencySummary_t summary;
+   adt_bytearray_t *transmittedMsg;
+   uint8_t *data;
+   int32_t msgLen;
+   int32_t numCalls = 0;
+
+   server = apx_server_new();
+   memset(&listener, 0, sizeof(listener));
+   listener.arg = (void*) &numCalls;
+   listener.connectionLatency1 = latencySpy_onConnectionLatency;
+   apx_server_registerEventListener(server, &listener);
+   connection = apx_serverTestConnection_new();
+   apx_server_acceptConnection(server, (apx_serverConnectionBase_t*) connection);
+   apx_serverTestConnection_onProtocolHeaderReceived(connection);
+   apx_serverTestConnection_runEventLoop(connection);
+   apx_serverTestConnection_clearTransmitLogMsg(connection);
+
+   CuAssertIntEquals(tc, APX_NO_ERROR, apx_serverConnectionBase_sendPing(&connection->base));
+   apx_serverTestConnection_runEventLoop(connection);
+   CuAssertIntEquals(tc, 1, apx_serverTestConnection_getTransmitLogLen(connection));
+   transmittedMsg = apx_serverTestConnection_getTransmitLogMsg(connection, 0);
+   msgLen = (int32_t) adt_bytearray_length(transmittedMsg);
+   CuAssertIntEquals(tc, RMF_HIGH_ADDRESS_SIZE + RMF_CMD_PING_LEN, msgLen);
+   data = adt_bytearray_data(transmittedMsg);
+   CuAssertUIntEquals(tc, RMF_CMD_PING_RQST, unpackLE(data + RMF_HIGH_ADDRESS_SIZE, RMF_CMD_TYPE_LEN));
+   apx_serverConnectionBase_getLatencySummary(&connection->base, &summary);
+   CuAssertUIntEquals(tc, 0u, summary.numSamples);
+
+   //Let the remote side echo the request back to us
+   packLE(data + RMF_HIGH_ADDRESS_SIZE, RMF_CMD_PING_RSP, RMF_CMD_TYPE_LEN);
+   CuAssertIntEquals(tc, APX_NO_ERROR, apx_serverTestConnection_onSerializedMsgReceived(connection, data, msgLen));
+   apx_serverConnectionBase_getLatencySummary(&connection->base, &summary);
+   CuAssertUIntEquals(tc, 1u, summary.numSamples);
+   CuAssertTrue(tc, summary.minRttUs <= summary.maxRttUs);
+   CuAssertIntEquals(tc, 0, numCalls);
+   apx_serverTestConnection_runEventLoop(connection);
+   CuAssertIntEquals(tc, 1, numCalls);
+
+   apx_server_delete(server);
+}
+
+/**
+ * Large writes towards a client are only fragmented when the client announced Fragment-Interleave in its greeting
+ */
+static void test_fragmentInterleaveIsNegotiatedInGreeting(CuTest* tc)
+{
+   const char *greetings[2] = {"RMFP/1.0\nNumHeader-Format:32\n\n", "RMFP/1.0\nNumHeader-Format:32\nFragment-Interleave:1\n\n"};
+   const uint32_t expectedFragmentSize[2] = {0u, APX_WORKER_FRAGMENT_SIZE};
+   int32_t i;
+   for (i = 0; i < 2; i++)
+   {
+      apx_serverTestConnection_t connection;
+      uint8_t buffer[RMF_GREETING_MAX_LEN + 4];
+      uint32_t greetingLen = (uint32_t) strlen(greetings[i]);
+      int32_t headerLen;
+      uint32_t parseLen = 0u;
+      apx_serverTestConnection_create(&connection);
+      CuAssertUIntEquals(tc, 0u, connection.base.base.fileManager.worker.fragmentSize);
+      headerLen = numheader_encode32(&buffer[0], (int32_t) sizeof(buffer), greetingLen);
+      CuAssertIntEquals(tc, 1, headerLen);
+      memcpy(&buffer[headerLen], greetings[i], greetingLen);
+      CuAssertIntEquals(tc, 0, apx_serverConnectionBase_dataReceived(&connection.base, &buffer[0], (uint32_t) headerLen + greetingLen, &parseLen));
+      CuAssertUIntEquals(tc, (uint32_t) headerLen + greetingLen, parseLen);
+      CuAssertTrue(tc, connection.base.isGreetingParsed);
+      CuAssertUIntEquals(tc, expectedFragmentSize[i], connection.base.base.fileManager.worker.fragmentSize);
+      apx_serverTestConnection_destroy(&connection);
+   }
+}
+
+static void latencySpy_onConnectionLatency(void *arg, apx_serverConnectionBase_t *connection, const apx_latencySummary_t *summary)
+{
+   int32_t *numCalls = (int32_t*) arg;
+   (void) connection;
+   if (summary->numSamples > 0u)
+   {
+      (*numCalls)++;
+   }
+}
+
+static void sendDefinitionFile(CuTest* tc, apx_serverTestConnection_t *connection, const char *fileName, const char *definition)
+{
+   rmf_fileInfo_t fileInfo;
+   uint8_t *buffer;
+   apx_size_t definitionLen = (apx_size_t) strlen(definition);
+
+   apx_serverTestConnection_onProtocolHeaderReceived(connection);
+   rmf_fileInfo_create(&fileInfo, fileName, APX_ADDRESS_DEFINITION_START, definitionLen, RMF_FILE_TYPE_FIXED);
+   CuAssertIntEquals(tc, APX_NO_ERROR, apx_serverTestConnection_onFileInfoMsgReceived(connection, &fileInfo));
+   apx_serverTestConnection_runEventLoop(connection);
+   buffer = (uint8_t*) malloc(RMF_HIGH_ADDRESS_SIZE + definitionLen);
+   CuAssertPtrNotNull(tc, buffer);
+   CuAssertIntEquals(tc, RMF_HIGH_ADDRESS_SIZE, rmf_packHeader(&buffer[0], RMF_HIGH_ADDRESS_SIZE, APX_ADDRESS_DEFINITION_START, false));
+   memcpy(&buffer[RMF_HIGH_ADDRESS_SIZE], definition, definitionLen);
+   CuAssertIntEquals(tc, APX_NO_ERROR, apx_serverTestConnection_onSerializedMsgReceived(connection, buffer, RMF_HIGH_ADDRESS_SIZE + definitionLen));
+   apx_serverTestConnection_runEventLoop(connection);
+   free(buffer);
+}
@@ -86,6 +86,8 @@ static apx_error_t apx_serverSocketConnection_fillTransmitHandler(apx_serverSock
 static apx_error_t apx_serverSocketConnection_vfillTransmitHandler(void *arg, apx_transmitHandler_t *handler);
 static uint8_t *apx_serverSocketConnection_getSendBuffer(void *arg, int32_t msgLen);
 static int32_t apx_serverSocketConnection_send(void *arg, int32_t offset, int32_t msgLen);
+static int32_t apx_serverSocketConnection_sendFramed(void *arg, const uint8_t *data, int32_t dataLen);
+static int32_t apx_serverSocketConnection_sendGather(void *arg, const apx_transmitSegment_t *segments, int32_t numSegments);
 static int8_t apx_serverSocketConnection_data(void *arg, const uint8_t *dataBuf, uint32_t dataLen, uint32_t *parseLen);
 static void apx_serverSocketConnection_disconnected(void *arg);
 
@@ -209,6 +211,8 @@ static apx_error_t apx_serverSocketConnection_fillTransmitHandler(apx_serverSock
       handler->send = apx_serverSocketConnection_send;
       handler->getSendAvail = 0;
       handler->getSendBuffer = apx_serverSocketConnection_getSendBuffer;
+      handler->sendFramed = apx_serverSocketConnection_sendFramed;
+      handler->sendGather = apx_serverSocketConnection_sendGather;
       return APX_NO_ERROR;
    }
    return APX_INVALID_ARGUMENT_ERROR;
@@ -292,6 +296,67 @@ static int32_t apx_serverSocketConnection_send(void *arg, int32_t offset, int32_
    return -1;
 }
 
+static int32_t apx_serverSocketConnection_sendFramed(void *arg, const uint8_t *data, int32_t dataLen)
+{
+   apx_serverSocketConnection_t *self = (apx_serverSocketConnection_t*) arg;
+   if ( (self != 0) && (data != 0) && (dataLen >= 0) )
+   {
+#if APX_DEBUG_ENABLE
+      printf("[SERVER-SOCKET] Sending %d bytes (batch)\n", (int)dataLen);
+#endif
+      if (SOCKET_SEND(self->socketObject, data, dataLen) != 0)
+      {
+         return -1;
+      }
+      return dataLen;
+   }
+   return -1;
+}
+
+/**
+ * The socket layer has no vectored send. Segments are instead collected in sendBuffer and handed to the socket in a single call.
+ * This is safe since the connection's worker is the only thread that uses sendBuffer.
+ */
+static int32_t apx_serverSocketConnection_sendGather(void *arg, const apx_transmitSegment_t *segments, int32_t numSegments)
+{
+   apx_serverSocketConnection_t *self = (apx_serverSocketConnection_t*) arg;
+   if ( (self != 0) && (segments != 0) && (numSegments >= 0) )
+   {
+      int32_t i;
+      int32_t totalLen = 0;
+      uint8_t *sendBuffer;
+      for (i = 0; i < numSegments; i++)
+      {
+         if ( (segments[i].data == 0) || (segments[i].dataLen < 0) )
+         {
+            return -1;
+         }
+         totalLen += segments[i].dataLen;
+      }
+      if ( ((int32_t) adt_bytearray_length(&self->sendBuffer) < totalLen) &&
+           (adt_bytearray_resize(&self->sendBuffer, (uint32_t) totalLen) != 0) )
+      {
+         return -1;
+      }
+      sendBuffer = adt_bytearray_data(&self->sendBuffer);
+      totalLen = 0;
+      for (i = 0; i < numSegments; i++)
+      {
+         memcpy(&sendBuffer[totalLen], segments[i].data, (size_t) segments[i].dataLen);
+         totalLen += segments[i].dataLen;
+      }
+#if APX_DEBUG_ENABLE
+      printf("[SERVER-SOCKET] Sending %d bytes (%d segments)\n", (int)totalLen, (int)numSegments);
+#endif
+      if (SOCKET_SEND(self->socketObject, sendBuffer, totalLen) != 0)
+      {
+         return -1;
+      }
+      return totalLen;
+   }
+   return -1;
+}
+
 static int8_t apx_serverSocketConnection_data(void *arg, const uint8_t *dataBuf, uint32_t dataLen, uint32_t *parseLen)
 {
    apx_serverSocketConnection_t *self = (apx_serverSocketConnection_t*) arg;
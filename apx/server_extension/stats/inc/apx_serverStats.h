@@ -0,0 +1,126 @@
+/*****************************************************************************
+* \file      apx_serverStats.h
+* \author    Conny Gustafsson
+* \date      2026-10-18
+* \brief     Periodic snapshots of server throughput counters
+*
+* Copyright (c) 2026 Conny Gustafsson
+* Permission is hereby granted, free of charge, to any person obtaining a copy of
+* this software and associated documentation files (the "Software"), to deal in
+* the Software without restriction, including without limitation the rights to
+* use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+* the Software, and to permit persons to whom the Software is furnished to do so,
+* subject to the following conditions:
+
+* The above copyright notice and this permission notice shall be included in all
+* copies or substantial portions of the Software.
+
+* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+* IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+* FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+* COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+* IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+* CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+*
+******************************************************************************/
+#ifndef APX_SERVER_STATS_H
+#define APX_SERVER_STATS_H
+
+//////////////////////////////////////////////////////////////////////////////
+// INCLUDES
+//////////////////////////////////////////////////////////////////////////////
+#include <stdint.h>
+#include <stdbool.h>
+#include "apx_error.h"
+#include "apx_connectionBase.h"
+#include "apx_routingPlan.h"
+#include "adt_ary.h"
+#include "adt_list.h"
+#include "adt_str.h"
+#include "osmacro.h"
+#if !defined(_WIN32) && !defined(UNIT_TEST)
+#include "msocket.h"
+#include "msocket_server.h"
+#endif
+
+//////////////////////////////////////////////////////////////////////////////
+// PUBLIC CONSTANTS AND DATA TYPES
+//////////////////////////////////////////////////////////////////////////////
+//forward declarations
+struct apx_server_tag;
+
+#define APX_SERVER_STATS_LABEL "STATS"
+#define APX_SERVER_STATS_DEFAULT_INTERVAL_MS 1000u
+#define APX_SERVER_STATS_MIN_INTERVAL_MS 100u
+
+typedef struct apx_serverStatsNode_tag
+{
+   char *name;
+   apx_routingStats_t routingStats;
+} apx_serverStatsNode_t;
+
+typedef struct apx_serverStatsConnection_tag
+{
+   apx_connectionStats_t stats;
+   adt_ary_t nodes; //strong references to apx_serverStatsNode_t
+} apx_serverStatsConnection_t;
+
+/**
+ * Copy of all server counters taken at timestampUs. Rates are calculated by comparing two snapshots.
+ */
+typedef struct apx_serverStatsSnapshot_tag
+{
+   uint64_t timestampUs;
+   adt_ary_t connections; //strong references to apx_serverStatsConnection_t
+} apx_serverStatsSnapshot_t;
+
+typedef struct apx_serverStats_tag
+{
+   struct apx_server_tag *server; //weak reference
+   apx_serverStatsSnapshot_t *previous; //last published snapshot
+   adt_list_t subscribers; //strong references to apx_serverStatsSubscriber_t
+   SPINLOCK_T lock; //protects subscribers and isPublishThreadRunning
+   uint32_t intervalMs;
+   bool isLogEnabled; //snapshots are sent as server log events (picked up by the textlog extension)
+   bool isStdoutEnabled;
+   THREAD_T publishThread;
+   bool isPublishThreadRunning;
+   bool isPublishThreadValid;
+#if !defined(_WIN32) && !defined(UNIT_TEST)
+   msocket_server_t unixServer; //local socket where each connected subscriber receives one JSON snapshot per line
+   bool isUnixServerStarted;
+#endif
+#ifdef _MSC_VER
+   unsigned int threadId;
+#endif
+} apx_serverStats_t;
+
+//////////////////////////////////////////////////////////////////////////////
+// PUBLIC FUNCTION PROTOTYPES
+//////////////////////////////////////////////////////////////////////////////
+void apx_serverStatsNode_delete(apx_serverStatsNode_t *self);
+void apx_serverStatsNode_vdelete(void *arg);
+void apx_serverStatsConnection_delete(apx_serverStatsConnection_t *self);
+void apx_serverStatsConnection_vdelete(void *arg);
+void apx_serverStatsSnapshot_create(apx_serverStatsSnapshot_t *self);
+void apx_serverStatsSnapshot_destroy(apx_serverStatsSnapshot_t *self);
+apx_serverStatsSnapshot_t *apx_serverStatsSnapshot_new(void);
+void apx_serverStatsSnapshot_delete(apx_serverStatsSnapshot_t *self);
+apx_error_t apx_serverStatsSnapshot_collect(apx_serverStatsSnapshot_t *self, struct apx_server_tag *server);
+apx_error_t apx_serverStatsSnapshot_toJson(const apx_serverStatsSnapshot_t *self, const apx_serverStatsSnapshot_t *previous, adt_str_t *json);
+
+void apx_serverStats_create(apx_serverStats_t *self, struct apx_server_tag *server);
+void apx_serverStats_destroy(apx_serverStats_t *self);
+apx_serverStats_t *apx_serverStats_new(struct apx_server_tag *server);
+void apx_serverStats_delete(apx_serverStats_t *self);
+void apx_serverStats_setInterval(apx_serverStats_t *self, uint32_t intervalMs);
+void apx_serverStats_enableLog(apx_serverStats_t *self);
+void apx_serverStats_enableStdout(apx_serverStats_t *self);
+#if !defined(_WIN32) && !defined(UNIT_TEST)
+void apx_serverStats_startUnixServer(apx_serverStats_t *self, const char *filePath);
+#endif
+apx_error_t apx_serverStats_publish(apx_serverStats_t *self);
+void apx_serverStats_start(apx_serverStats_t *self);
+void apx_serverStats_stop(apx_serverStats_t *self);
+
+#endif //APX_SERVER_STATS_H
@@ -0,0 +1,721 @@
+/*****************************************************************************
+* \file      apx_serverStats.c
+* \author    Conny Gustafsson
+* \date      2026-10-18
+* \brief     Periodic snapshots of server throughput counters
+*
+* Copyright (c) 2026 Conny Gustafsson
+* Permission is hereby granted, free of charge, to any person obtaining a copy of
+* this software and associated documentation files (the "Software"), to deal in
+* the Software without restriction, including without limitation the rights to
+* use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+* the Software, and to permit persons to whom the Software is furnished to do so,
+* subject to the following conditions:
+
+* The above copyright notice and this permission notice shall be included in all
+* copies or substantial portions of the Software.
+
+* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+* IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+* FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+* COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+* IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+* CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+*
+******************************************************************************/
+//////////////////////////////////////////////////////////////////////////////
+// INCLUDES
+//////////////////////////////////////////////////////////////////////////////
+#include <malloc.h>
+#include <string.h>
+#include <stdio.h>
+#include <assert.h>
+#ifdef _WIN32
+#include <process.h>
+#endif
+#include "apx_serverStats.h"
+#include "apx_server.h"
+#include "apx_serverConnectionBase.h"
+#include "apx_nodeInstance.h"
+#include "apx_latencyStats.h"
+#ifdef MEM_LEAK_CHECK
+#include "CMemLeak.h"
+#endif
+
+//////////////////////////////////////////////////////////////////////////////
+// PRIVATE CONSTANTS AND DATA TYPES
+//////////////////////////////////////////////////////////////////////////////
+#ifdef _MSC_VER
+#define STRDUP _strdup
+#else
+#define STRDUP strdup
+#endif
+
+#define PUBLISH_POLL_TIME 100 //how often (ms) the publish thread checks if it's time to stop
+#define JSON_BUF_SIZE 512
+
+typedef struct apx_serverStatsCollector_tag
+{
+   apx_serverStatsSnapshot_t *snapshot;
+   apx_error_t result;
+} apx_serverStatsCollector_t;
+
+#if !defined(_WIN32) && !defined(UNIT_TEST)
+typedef struct apx_serverStatsSubscriber_tag
+{
+   apx_serverStats_t *parent;
+   msocket_t *socketObject;
+   bool isConnected; //protected by parent->lock
+} apx_serverStatsSubscriber_t;
+#endif
+
+//////////////////////////////////////////////////////////////////////////////
+// PRIVATE FUNCTION PROTOTYPES
+//////////////////////////////////////////////////////////////////////////////
+static void apx_serverStatsSnapshot_visitConnection(void *arg, apx_serverConnectionBase_t *connection);
+static apx_serverStatsConnection_t *apx_serverStatsSnapshot_findConnection(const apx_serverStatsSnapshot_t *self, uint32_t connectionId);
+static apx_serverStatsNode_t *apx_serverStatsConnection_findNode(const apx_serverStatsConnection_t *self, const char *name);
+static uint64_t apx_serverStats_calcRate(uint64_t current, uint64_t previous, uint64_t elapsedUs);
+static void apx_serverStats_appendConnectionJson(adt_str_t *json, const apx_serverStatsConnection_t *connection, const apx_serverStatsConnection_t *previous, uint64_t elapsedUs);
+static void apx_serverStats_appendNodeJson(adt_str_t *json, const apx_serverStatsNode_t *node, const apx_serverStatsNode_t *previous, uint64_t elapsedUs);
+THREAD_PROTO(publishTask, arg);
+#if !defined(_WIN32) && !defined(UNIT_TEST)
+static void apx_serverStats_unixAccept(void *arg, struct msocket_server_tag *srv, msocket_t *sock);
+static int8_t apx_serverStats_subscriberData(void *arg, const uint8_t *dataBuf, uint32_t dataLen, uint32_t *parseLen);
+static void apx_serverStats_subscriberDisconnected(void *arg);
+static void apx_serverStats_sendToSubscribers(apx_serverStats_t *self, const char *data, uint32_t dataLen);
+static void apx_serverStats_stopUnixServer(apx_serverStats_t *self);
+#endif
+
+//////////////////////////////////////////////////////////////////////////////
+// PRIVATE VARIABLES
+//////////////////////////////////////////////////////////////////////////////
+
+//////////////////////////////////////////////////////////////////////////////
+// PUBLIC FUNCTIONS
+//////////////////////////////////////////////////////////////////////////////
+
+void apx_serverStatsNode_delete(apx_serverStatsNode_t *self)
+{
+   if (self != 0)
+   {
+      if (self->name != 0)
+      {
+         free(self->name);
+      }
+      free(self);
+   }
+}
+
+void apx_serverStatsNode_vdelete(void *arg)
+{
+   apx_serverStatsNode_delete((apx_serverStatsNode_t*) arg);
+}
+
+void apx_serverStatsConnection_delete(apx_serverStatsConnection_t *self)
+{
+   if (self != 0)
+   {
+      adt_ary_destroy(&self->nodes);
+      free(self);
+   }
+}
+
+void apx_serverStatsConnection_vdelete(void *arg)
+{
+   apx_serverStatsConnection_delete((apx_serverStatsConnection_t*) arg);
+}
+
+void apx_serverStatsSnapshot_create(apx_serverStatsSnapshot_t *self)
+{
+   if (self != 0)
+   {
+      self->timestampUs = 0u;
+      adt_ary_create(&self->connections, apx_serverStatsConnection_vdelete);
+   }
+}
+
+void apx_serverStatsSnapshot_destroy(apx_serverStatsSnapshot_t *self)
+{
+   if (self != 0)
+   {
+      adt_ary_destroy(&self->connections);
+   }
+}
+
+apx_serverStatsSnapshot_t *apx_serverStatsSnapshot_new(void)
+{
+   apx_serverStatsSnapshot_t *self = (apx_serverStatsSnapshot_t*) malloc(sizeof(apx_serverStatsSnapshot_t));
+   if (self != 0)
+   {
+      apx_serverStatsSnapshot_create(self);
+   }
+   return self;
+}
+
+void apx_serverStatsSnapshot_delete(apx_serverStatsSnapshot_t *self)
+{
+   if (self != 0)
+   {
+      apx_serverStatsSnapshot_destroy(self);
+      free(self);
+   }
+}
+
+/**
+ * Copies the counters of all active connections (and their nodes) into the snapshot.
+ * The connection manager lock is only held while copying, all formatting is done later from the copy.
+ */
+apx_error_t apx_serverStatsSnapshot_collect(apx_serverStatsSnapshot_t *self, struct apx_server_tag *server)
+{
+   if ( (self != 0) && (server != 0) )
+   {
+      apx_serverStatsCollector_t collector;
+      collector.snapshot = self;
+      collector.result = APX_NO_ERROR;
+      self->timestampUs = apx_latencyStats_timestampUs();
+      apx_server_visitConnections(server, apx_serverStatsSnapshot_visitConnection, (void*) &collector);
+      return collector.result;
+   }
+   return APX_INVALID_ARGUMENT_ERROR;
+}
+
+/**
+ * Formats the snapshot as a single line JSON object.
+ * When previous is given, per second rates are calculated from the difference between the two snapshots.
+ */
+apx_error_t apx_serverStatsSnapshot_toJson(const apx_serverStatsSnapshot_t *self, const apx_serverStatsSnapshot_t *previous, adt_str_t *json)
+{
+   if ( (self != 0) && (json != 0) )
+   {
+      char buf[JSON_BUF_SIZE];
+      int32_t i;
+      int32_t numConnections = adt_ary_length(&self->connections);
+      uint64_t elapsedUs = 0u;
+      if ( (previous != 0) && (self->timestampUs > previous->timestampUs) )
+      {
+         elapsedUs = self->timestampUs - previous->timestampUs;
+      }
+      sprintf(buf, "{\"timestampUs\":%llu,\"intervalUs\":%llu,\"numConnections\":%d,\"connections\":[",
+            (unsigned long long) self->timestampUs, (unsigned long long) elapsedUs, (int) numConnections);
+      adt_str_append_cstr(json, buf);
+      for (i = 0; i < numConnections; i++)
+      {
+         const apx_serverStatsConnection_t *connection = (const apx_serverStatsConnection_t*) adt_ary_value(&self->connections, i);
+         const apx_serverStatsConnection_t *previousConnection = (const apx_serverStatsConnection_t*) 0;
+         if (previous != 0)
+         {
+            previousConnection = apx_serverStatsSnapshot_findConnection(previous, connection->stats.connectionId);
+         }
+         if (i > 0)
+         {
+            adt_str_append_cstr(json, ",");
+         }
+         apx_serverStats_appendConnectionJson(json, connection, previousConnection, elapsedUs);
+      }
+      adt_str_append_cstr(json, "]}");
+      return APX_NO_ERROR;
+   }
+   return APX_INVALID_ARGUMENT_ERROR;
+}
+
+void apx_serverStats_create(apx_serverStats_t *self, struct apx_server_tag *server)
+{
+   if (self != 0)
+   {
+      self->server = server;
+      self->previous = (apx_serverStatsSnapshot_t*) 0;
+      adt_list_create(&self->subscribers, (void (*)(void*)) 0);
+      SPINLOCK_INIT(self->lock);
+      self->intervalMs = APX_SERVER_STATS_DEFAULT_INTERVAL_MS;
+      self->isLogEnabled = false;
+      self->isStdoutEnabled = false;
+      self->isPublishThreadRunning = false;
+      self->isPublishThreadValid = false;
+#if !defined(_WIN32) && !defined(UNIT_TEST)
+      self->isUnixServerStarted = false;
+#endif
+   }
+}
+
+void apx_serverStats_destroy(apx_serverStats_t *self)
+{
+   if (self != 0)
+   {
+      apx_serverStats_stop(self);
+#if !defined(_WIN32) && !defined(UNIT_TEST)
+      apx_serverStats_stopUnixServer(self);
+#endif
+      adt_list_destroy(&self->subscribers);
+      SPINLOCK_DESTROY(self->lock);
+      if (self->previous != 0)
+      {
+         apx_serverStatsSnapshot_delete(self->previous);
+      }
+   }
+}
+
+apx_serverStats_t *apx_serverStats_new(struct apx_server_tag *server)
+{
+   apx_serverStats_t *self = (apx_serverStats_t*) malloc(sizeof(apx_serverStats_t));
+   if (self != 0)
+   {
+      apx_serverStats_create(self, server);
+   }
+   return self;
+}
+
+void apx_serverStats_delete(apx_serverStats_t *self)
+{
+   if (self != 0)
+   {
+      apx_serverStats_destroy(self);
+      free(self);
+   }
+}
+
+void apx_serverStats_setInterval(apx_serverStats_t *self, uint32_t intervalMs)
+{
+   if (self != 0)
+   {
+      self->intervalMs = (intervalMs < APX_SERVER_STATS_MIN_INTERVAL_MS)? APX_SERVER_STATS_MIN_INTERVAL_MS : intervalMs;
+   }
+}
+
+void apx_serverStats_enableLog(apx_serverStats_t *self)
+{
+   if (self != 0)
+   {
+      self->isLogEnabled = true;
+   }
+}
+
+void apx_serverStats_enableStdout(apx_serverStats_t *self)
+{
+   if (self != 0)
+   {
+      self->isStdoutEnabled = true;
+   }
+}
+
+#if !defined(_WIN32) && !defined(UNIT_TEST)
+void apx_serverStats_startUnixServer(apx_serverStats_t *self, const char *filePath)
+{
+   if ( (self != 0) && (filePath != 0) && (self->isUnixServerStarted == false) )
+   {
+      msocket_handler_t serverHandler;
+      memset(&serverHandler, 0, sizeof(serverHandler));
+      serverHandler.tcp_accept = apx_serverStats_unixAccept;
+      msocket_server_create(&self->unixServer, AF_LOCAL, NULL);
+      msocket_server_disable_cleanup(&self->unixServer); //subscribers are deleted by the publish thread
+      msocket_server_sethandler(&self->unixServer, &serverHandler, self);
+      msocket_server_unix_start(&self->unixServer, filePath);
+      self->isUnixServerStarted = true;
+      printf("Publishing statistics on UNIX socket %s\n", filePath);
+   }
+}
+#endif
+
+/**
+ * Takes a new snapshot and sends it to all enabled outputs. Called periodically by the publish thread.
+ */
+apx_error_t apx_serverStats_publish(apx_serverStats_t *self)
+{
+   if (self != 0)
+   {
+      apx_error_t result;
+      adt_str_t *json;
+      apx_serverStatsSnapshot_t *snapshot = apx_serverStatsSnapshot_new();
+      if (snapshot == 0)
+      {
+         return APX_MEM_ERROR;
+      }
+      result = apx_serverStatsSnapshot_collect(snapshot, self->server);
+      if (result != APX_NO_ERROR)
+      {
+         apx_serverStatsSnapshot_delete(snapshot);
+         return result;
+      }
+      json = adt_str_new();
+      if (json == 0)
+      {
+         apx_serverStatsSnapshot_delete(snapshot);
+         return APX_MEM_ERROR;
+      }
+      result = apx_serverStatsSnapshot_toJson(snapshot, self->previous, json);
+      if (result == APX_NO_ERROR)
+      {
+         if (self->isLogEnabled)
+         {
+            apx_server_logEvent(self->server, APX_LOG_LEVEL_INFO, APX_SERVER_STATS_LABEL, adt_str_cstr(json));
+         }
+         if (self->isStdoutEnabled)
+         {
+            printf("%s\n", adt_str_cstr(json));
+         }
+#if !defined(_WIN32) && !defined(UNIT_TEST)
+         if (self->isUnixServerStarted)
+         {
+            adt_str_append_cstr(json, "\n");
+            apx_serverStats_sendToSubscribers(self, adt_str_cstr(json), (uint32_t) adt_str_length(json));
+         }
+#endif
+      }
+      adt_str_delete(json);
+      if (self->previous != 0)
+      {
+         apx_serverStatsSnapshot_delete(self->previous);
+      }
+      self->previous = snapshot;
+      return result;
+   }
+   return APX_INVALID_ARGUMENT_ERROR;
+}
+
+void apx_serverStats_start(apx_serverStats_t *self)
+{
+   if ( (self != 0) && (self->isPublishThreadValid == false) )
+   {
+      self->isPublishThreadRunning = true;
+      self->isPublishThreadValid = true;
+#ifdef _WIN32
+      THREAD_CREATE(self->publishThread, publishTask, (void*) self, self->threadId);
+#else
+      THREAD_CREATE(self->publishThread, publishTask, (void*) self);
+#endif
+   }
+}
+
+void apx_serverStats_stop(apx_serverStats_t *self)
+{
+   if ( (self != 0) && (self->isPublishThreadValid == true) )
+   {
+#ifndef _WIN32
+      void *result;
+#endif
+      SPINLOCK_ENTER(self->lock);
+      self->isPublishThreadRunning = false;
+      SPINLOCK_LEAVE(self->lock);
+#ifdef _WIN32
+      WaitForSingleObject( self->publishThread, INFINITE );
+      CloseHandle( self->publishThread );
+#else
+      pthread_join(self->publishThread, &result);
+#endif
+      self->isPublishThreadValid = false;
+   }
+}
+
+//////////////////////////////////////////////////////////////////////////////
+// PRIVATE FUNCTIONS
+//////////////////////////////////////////////////////////////////////////////
+
+/**
+ * Called from apx_server_visitConnections without holding the connection manager lock. Only copies counters, no formatting is done here.
+ */
+static void apx_serverStatsSnapshot_visitConnection(void *arg, apx_serverConnectionBase_t *connection)
+{
+   apx_serverStatsCollector_t *collector = (apx_serverStatsCollector_t*) arg;
+   apx_serverStatsConnection_t *connectionStats;
+   adt_ary_t nodeInstances;
+   int32_t numNodes;
+   int32_t i;
+   if (collector->result != APX_NO_ERROR)
+   {
+      return;
+   }
+   connectionStats = (apx_serverStatsConnection_t*) malloc(sizeof(apx_serverStatsConnection_t));
+   if (connectionStats == 0)
+   {
+      collector->result = APX_MEM_ERROR;
+      return;
+   }
+   adt_ary_create(&connectionStats->nodes, apx_serverStatsNode_vdelete);
+   apx_connectionBase_getStats(&connection->base, &connectionStats->stats);
+   adt_ary_push(&collector->snapshot->connections, connectionStats);
+   adt_ary_create(&nodeInstances, (void (*)(void*)) 0);
+   numNodes = apx_nodeManager_values(&connection->base.nodeManager, &nodeInstances);
+   for (i = 0; i < numNodes; i++)
+   {
+      apx_nodeInstance_t *nodeInstance = (apx_nodeInstance_t*) adt_ary_value(&nodeInstances, i);
+      const char *name = apx_nodeInstance_getName(nodeInstance);
+      apx_serverStatsNode_t *nodeStats;
+      if (name == 0)
+      {
+         continue; //definition not yet parsed
+      }
+      nodeStats = (apx_serverStatsNode_t*) malloc(sizeof(apx_serverStatsNode_t));
+      if (nodeStats == 0)
+      {
+         collector->result = APX_MEM_ERROR;
+         break;
+      }
+      nodeStats->name = STRDUP(name);
+      if (nodeStats->name == 0)
+      {
+         free(nodeStats);
+         collector->result = APX_MEM_ERROR;
+         break;
+      }
+      apx_nodeInstance_getRoutingStats(nodeInstance, &nodeStats->routingStats);
+      adt_ary_push(&connectionStats->nodes, nodeStats);
+   }
+   adt_ary_destroy(&nodeInstances);
+}
+
+static apx_serverStatsConnection_t *apx_serverStatsSnapshot_findConnection(const apx_serverStatsSnapshot_t *self, uint32_t connectionId)
+{
+   int32_t i;
+   int32_t numConnections = adt_ary_length(&self->connections);
+   for (i = 0; i < numConnections; i++)
+   {
+      apx_serverStatsConnection_t *connection = (apx_serverStatsConnection_t*) adt_ary_value(&self->connections, i);
+      if (connection->stats.connectionId == connectionId)
+      {
+         return connection;
+      }
+   }
+   return (apx_serverStatsConnection_t*) 0;
+}
+
+static apx_serverStatsNode_t *apx_serverStatsConnection_findNode(const apx_serverStatsConnection_t *self, const char *name)
+{
+   int32_t i;
+   int32_t numNodes = adt_ary_length(&self->nodes);
+   for (i = 0; i < numNodes; i++)
+   {
+      apx_serverStatsNode_t *node = (apx_serverStatsNode_t*) adt_ary_value(&self->nodes, i);
+      if (strcmp(node->name, name) == 0)
+      {
+         return node;
+      }
+   }
+   return (apx_serverStatsNode_t*) 0;
+}
+
+/**
+ * Returns the number of events per second. Counters that went backwards (connection ID reused by a new connection) give 0.
+ */
+static uint64_t apx_serverStats_calcRate(uint64_t current, uint64_t previous, uint64_t elapsedUs)
+{
+   if ( (elapsedUs == 0u) || (current < previous) )
+   {
+      return 0u;
+   }
+   return ((current - previous) * 1000000u) / elapsedUs;
+}
+
+static void apx_serverStats_appendConnectionJson(adt_str_t *json, const apx_serverStatsConnection_t *connection, const apx_serverStatsConnection_t *previous, uint64_t elapsedUs)
+{
+   char buf[JSON_BUF_SIZE];
+   const apx_connectionStats_t *stats = &connection->stats;
+   uint64_t rxBytesPerSec = 0u;
+   uint64_t rxMessagesPerSec = 0u;
+   uint64_t txBytesPerSec = 0u;
+   uint64_t txMessagesPerSec = 0u;
+   int32_t i;
+   int32_t numNodes = adt_ary_length(&connection->nodes);
+   if (previous != 0)
+   {
+      rxBytesPerSec = apx_serverStats_calcRate(stats->totalBytesReceived, previous->stats.totalBytesReceived, elapsedUs);
+      rxMessagesPerSec = apx_serverStats_calcRate(stats->totalMessagesReceived, previous->stats.totalMessagesReceived, elapsedUs);
+      txBytesPerSec = apx_serverStats_calcRate(stats->workerStats.numBytesSent, previous->stats.workerStats.numBytesSent, elapsedUs);
+      txMessagesPerSec = apx_serverStats_calcRate(stats->workerStats.numMessagesSent, previous->stats.workerStats.numMessagesSent, elapsedUs);
+   }
+   sprintf(buf, "{\"id\":%u,\"rxBytes\":%u,\"rxMessages\":%u,\"rxBytesPerSec\":%llu,\"rxMessagesPerSec\":%llu,"
+         "\"txBytes\":%llu,\"txMessages\":%u,\"txBytesPerSec\":%llu,\"txMessagesPerSec\":%llu,\"txCalls\":%u,",
+         (unsigned int) stats->connectionId, (unsigned int) stats->totalBytesReceived, (unsigned int) stats->totalMessagesReceived,
+         (unsigned long long) rxBytesPerSec, (unsigned long long) rxMessagesPerSec,
+         (unsigned long long) stats->workerStats.numBytesSent, (unsigned int) stats->workerStats.numMessagesSent,
+         (unsigned long long) txBytesPerSec, (unsigned long long) txMessagesPerSec, (unsigned int) stats->workerStats.numTransmitCalls);
+   adt_str_append_cstr(json, buf);
+   sprintf(buf, "\"pendingWorkerMessages\":%u,\"pendingEvents\":%u,\"allocLiveBytes\":%u,\"allocHighWaterMark\":%u,\"allocReservedBytes\":%u,"
+         "\"rttAvgUs\":%u,\"rttP99Us\":%u,\"rttMaxUs\":%u,\"numNodes\":%d,\"nodes\":[",
+         (unsigned int) stats->numPendingWorkerMessages, (unsigned int) stats->numPendingEvents,
+         (unsigned int) stats->allocatorStats.liveBytes, (unsigned int) stats->allocatorStats.highWaterMark, (unsigned int) stats->allocatorStats.reservedBytes,
+         (unsigned int) stats->latency.avgRttUs, (unsigned int) stats->latency.p99RttUs, (unsigned int) stats->latency.maxRttUs, (int) numNodes);
+   adt_str_append_cstr(json, buf);
+   for (i = 0; i < numNodes; i++)
+   {
+      const apx_serverStatsNode_t *node = (const apx_serverStatsNode_t*) adt_ary_value(&connection->nodes, i);
+      const apx_serverStatsNode_t *previousNode = (const apx_serverStatsNode_t*) 0;
+      if (previous != 0)
+      {
+         previousNode = apx_serverStatsConnection_findNode(previous, node->name);
+      }
+      if (i > 0)
+      {
+         adt_str_append_cstr(json, ",");
+      }
+      apx_serverStats_appendNodeJson(json, node, previousNode, elapsedUs);
+   }
+   adt_str_append_cstr(json, "]}");
+}
+
+/**
+ * Node names are APX identifiers and never need escaping
+ */
+static void apx_serverStats_appendNodeJson(adt_str_t *json, const apx_serverStatsNode_t *node, const apx_serverStatsNode_t *previous, uint64_t elapsedUs)
+{
+   char buf[JSON_BUF_SIZE];
+   const apx_routingStats_t *stats = &node->routingStats;
+   uint64_t writesPerSec = 0u;
+   uint64_t routedBytesPerSec = 0u;
+   if (previous != 0)
+   {
+      writesPerSec = apx_serverStats_calcRate(stats->numSourceWrites, previous->routingStats.numSourceWrites, elapsedUs);
+      routedBytesPerSec = apx_serverStats_calcRate(stats->numRoutedBytes, previous->routingStats.numRoutedBytes, elapsedUs);
+   }
+   adt_str_append_cstr(json, "{\"name\":\"");
+   adt_str_append_cstr(json, node->name);
+   sprintf(buf, "\",\"writes\":%u,\"writeBytes\":%llu,\"writesPerSec\":%llu,\"routedWrites\":%u,\"routedBytes\":%llu,\"routedBytesPerSec\":%llu,"
+         "\"transmittedWrites\":%u,\"maxFanOut\":%u}",
+         (unsigned int) stats->numSourceWrites, (unsigned long long) stats->numSourceBytes, (unsigned long long) writesPerSec,
+         (unsigned int) stats->numRoutedWrites, (unsigned long long) stats->numRoutedBytes, (unsigned long long) routedBytesPerSec,
+         (unsigned int) stats->numTransmittedWrites, (unsigned int) stats->maxFanOut);
+   adt_str_append_cstr(json, buf);
+}
+
+THREAD_PROTO(publishTask,arg)
+{
+   apx_serverStats_t *self = (apx_serverStats_t*) arg;
+   if (self != 0)
+   {
+      uint32_t msSinceLastPublish = 0u;
+      while(1)
+      {
+         bool isRunning;
+         SLEEP(PUBLISH_POLL_TIME);
+         SPINLOCK_ENTER(self->lock);
+         isRunning = self->isPublishThreadRunning;
+         SPINLOCK_LEAVE(self->lock);
+         if (isRunning == false)
+         {
+            break;
+         }
+         msSinceLastPublish += PUBLISH_POLL_TIME;
+         if (msSinceLastPublish >= self->intervalMs)
+         {
+            msSinceLastPublish = 0u;
+            (void) apx_serverStats_publish(self);
+         }
+      }
+   }
+   THREAD_RETURN(0);
+}
+
+#if !defined(_WIN32) && !defined(UNIT_TEST)
+static void apx_serverStats_unixAccept(void *arg, struct msocket_server_tag *srv, msocket_t *sock)
+{
+   apx_serverStats_t *self = (apx_serverStats_t*) arg;
+   if (self != 0)
+   {
+      msocket_handler_t handlerTable;
+      apx_serverStatsSubscriber_t *subscriber = (apx_serverStatsSubscriber_t*) malloc(sizeof(apx_serverStatsSubscriber_t));
+      if (subscriber == 0)
+      {
+         msocket_delete(sock);
+         return;
+      }
+      subscriber->parent = self;
+      subscriber->socketObject = sock;
+      subscriber->isConnected = true;
+      memset(&handlerTable, 0, sizeof(handlerTable));
+      handlerTable.tcp_data = apx_serverStats_subscriberData;
+      handlerTable.tcp_disconnected = apx_serverStats_subscriberDisconnected;
+      msocket_sethandler(sock, &handlerTable, subscriber);
+      SPINLOCK_ENTER(self->lock);
+      adt_list_insert(&self->subscribers, subscriber);
+      SPINLOCK_LEAVE(self->lock);
+      msocket_start_io(sock);
+   }
+}
+
+/**
+ * Subscribers are not expected to send anything, whatever they send is discarded
+ */
+static int8_t apx_serverStats_subscriberData(void *arg, const uint8_t *dataBuf, uint32_t dataLen, uint32_t *parseLen)
+{
+   (void) arg;
+   (void) dataBuf;
+   *parseLen = dataLen;
+   return 0;
+}
+
+static void apx_serverStats_subscriberDisconnected(void *arg)
+{
+   apx_serverStatsSubscriber_t *subscriber = (apx_serverStatsSubscriber_t*) arg;
+   if (subscriber != 0)
+   {
+      SPINLOCK_ENTER(subscriber->parent->lock);
+      subscriber->isConnected = false;
+      SPINLOCK_LEAVE(subscriber->parent->lock);
+   }
+}
+
+/**
+ * Sends data to all connected subscribers. Disconnected subscribers are removed and deleted.
+ * Subscribers are only deleted from this function (or from destroy) which makes it safe to send without holding the lock.
+ */
+static void apx_serverStats_sendToSubscribers(apx_serverStats_t *self, const char *data, uint32_t dataLen)
+{
+   adt_ary_t connected;
+   adt_ary_t disconnected;
+   adt_list_elem_t *iter;
+   int32_t i;
+   adt_ary_create(&connected, (void (*)(void*)) 0);
+   adt_ary_create(&disconnected, (void (*)(void*)) 0);
+   SPINLOCK_ENTER(self->lock);
+   iter = adt_list_iter_first(&self->subscribers);
+   while (iter != 0)
+   {
+      apx_serverStatsSubscriber_t *subscriber = (apx_serverStatsSubscriber_t*) iter->pItem;
+      adt_list_elem_t *next = adt_list_iter_next(iter);
+      if (subscriber->isConnected)
+      {
+         adt_ary_push(&connected, subscriber);
+      }
+      else
+      {
+         adt_list_erase(&self->subscribers, iter);
+         adt_ary_push(&disconnected, subscriber);
+      }
+      iter = next;
+   }
+   SPINLOCK_LEAVE(self->lock);
+   for (i = 0; i < adt_ary_length(&connected); i++)
+   {
+      apx_serverStatsSubscriber_t *subscriber = (apx_serverStatsSubscriber_t*) adt_ary_value(&connected, i);
+      msocket_send(subscriber->socketObject, data, dataLen);
+   }
+   for (i = 0; i < adt_ary_length(&disconnected); i++)
+   {
+      apx_serverStatsSubscriber_t *subscriber = (apx_serverStatsSubscriber_t*) adt_ary_value(&disconnected, i);
+      msocket_delete(subscriber->socketObject);
+      free(subscriber);
+   }
+   adt_ary_destroy(&connected);
+   adt_ary_destroy(&disconnected);
+}
+
+static void apx_serverStats_stopUnixServer(apx_serverStats_t *self)
+{
+   adt_list_elem_t *iter;
+   if (self->isUnixServerStarted)
+   {
+      msocket_server_destroy(&self->unixServer);
+      self->isUnixServerStarted = false;
+   }
+   iter = adt_list_iter_first(&self->subscribers);
+   while (iter != 0)
+   {
+      apx_serverStatsSubscriber_t *subscriber = (apx_serverStatsSubscriber_t*) iter->pItem;
+      msocket_close(subscriber->socketObject);
+      msocket_delete(subscriber->socketObject);
+      free(subscriber);
+      iter = adt_list_iter_next(iter);
+   }
+   adt_list_clear(&self->subscribers);
+}
+#endif
+
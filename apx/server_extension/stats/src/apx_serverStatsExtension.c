@@ -0,0 +1,158 @@
+/*****************************************************************************
+* \file      apx_serverStatsExtension.c
+* \author    Conny Gustafsson
+* \date      2026-10-18
+* \brief     Server extension publishing throughput statistics
+*
+* Copyright (c) 2026 Conny Gustafsson
+* Permission is hereby granted, free of charge, to any person obtaining a copy of
+* this software and associated documentation files (the "Software"), to deal in
+* the Software without restriction, including without limitation the rights to
+* use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+* the Software, and to permit persons to whom the Software is furnished to do so,
+* subject to the following conditions:
+
+* The above copyright notice and this permission notice shall be included in all
+* copies or substantial portions of the Software.
+
+* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+* IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+* FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+* COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+* IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+* CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+*
+******************************************************************************/
+//////////////////////////////////////////////////////////////////////////////
+// INCLUDES
+//////////////////////////////////////////////////////////////////////////////
+#include <string.h>
+#include "apx_serverStatsExtension.h"
+#include "apx_serverStats.h"
+#include "apx_server.h"
+#ifdef MEM_LEAK_CHECK
+#include "CMemLeak.h"
+#endif
+
+//////////////////////////////////////////////////////////////////////////////
+// PRIVATE CONSTANTS AND DATA TYPES
+//////////////////////////////////////////////////////////////////////////////
+
+//////////////////////////////////////////////////////////////////////////////
+// PRIVATE FUNCTION PROTOTYPES
+//////////////////////////////////////////////////////////////////////////////
+static apx_error_t apx_serverStatsExtension_init(struct apx_server_tag *apx_server, dtl_dv_t *config);
+static void apx_serverStatsExtension_shutdown(void);
+static apx_error_t apx_serverStatsExtension_configure(apx_serverStats_t *instance, dtl_hv_t *cfg);
+
+//////////////////////////////////////////////////////////////////////////////
+// PRIVATE VARIABLES
+//////////////////////////////////////////////////////////////////////////////
+static apx_serverStats_t *m_instance = (apx_serverStats_t*) 0; //singleton
+
+//////////////////////////////////////////////////////////////////////////////
+// PUBLIC FUNCTIONS
+//////////////////////////////////////////////////////////////////////////////
+apx_error_t apx_serverStatsExtension_register(struct apx_server_tag *apx_server, dtl_dv_t *config)
+{
+   if ( (config != 0) && (dtl_dv_type(config) == DTL_DV_HASH))
+   {
+      dtl_sv_t *extensionEnabled;
+      dtl_hv_t *cfg = (dtl_hv_t*) config;
+      extensionEnabled = (dtl_sv_t*) dtl_hv_get_cstr(cfg, "extension-enabled");
+      if ( (extensionEnabled != 0) && (dtl_sv_to_bool(extensionEnabled)))
+      {
+         apx_serverExtensionHandler_t handler = {apx_serverStatsExtension_init, apx_serverStatsExtension_shutdown};
+         return apx_server_addExtension(apx_server, "STATS", &handler, config);
+      }
+   }
+   return APX_NO_ERROR;
+}
+
+//////////////////////////////////////////////////////////////////////////////
+// PRIVATE FUNCTIONS
+//////////////////////////////////////////////////////////////////////////////
+static apx_error_t apx_serverStatsExtension_init(struct apx_server_tag *apx_server, dtl_dv_t *config)
+{
+   if (m_instance == 0)
+   {
+      apx_error_t result = APX_NO_ERROR;
+      m_instance = apx_serverStats_new(apx_server);
+      if (m_instance == 0)
+      {
+         return APX_MEM_ERROR;
+      }
+      if (config != 0)
+      {
+         if (dtl_dv_type(config) == DTL_DV_HASH)
+         {
+            result = apx_serverStatsExtension_configure(m_instance, (dtl_hv_t*) config);
+         }
+         else
+         {
+            result = APX_DV_TYPE_ERROR;
+         }
+      }
+      if (result == APX_NO_ERROR)
+      {
+         apx_serverStats_start(m_instance);
+      }
+      return result;
+   }
+   return APX_NO_ERROR;
+}
+
+static void apx_serverStatsExtension_shutdown(void)
+{
+   if (m_instance != 0)
+   {
+      apx_serverStats_stop(m_instance);
+      apx_serverStats_delete(m_instance);
+      m_instance = (apx_serverStats_t*) 0;
+   }
+}
+
+static apx_error_t apx_serverStatsExtension_configure(apx_serverStats_t *instance, dtl_hv_t *cfg)
+{
+   dtl_sv_t *svInterval;
+   dtl_sv_t *svLogEnabled;
+   dtl_sv_t *svStdoutEnabled;
+#if !defined(_WIN32) && !defined(UNIT_TEST)
+   dtl_sv_t *svUnixFile;
+#endif
+   bool conversionOk;
+   svInterval = (dtl_sv_t*) dtl_hv_get_cstr(cfg, "interval-ms");
+   svLogEnabled = (dtl_sv_t*) dtl_hv_get_cstr(cfg, "log-enabled");
+   svStdoutEnabled = (dtl_sv_t*) dtl_hv_get_cstr(cfg, "stdout-enabled");
+#if !defined(_WIN32) && !defined(UNIT_TEST)
+   svUnixFile = (dtl_sv_t*) dtl_hv_get_cstr(cfg, "unix-file");
+#endif
+   if (svInterval != 0)
+   {
+      uint32_t intervalMs = dtl_sv_to_u32(svInterval, &conversionOk);
+      if (conversionOk)
+      {
+         apx_serverStats_setInterval(instance, intervalMs);
+      }
+   }
+   if ( (svLogEnabled != 0) && (dtl_sv_to_bool(svLogEnabled) != false) )
+   {
+      apx_serverStats_enableLog(instance);
+   }
+   if ( (svStdoutEnabled != 0) && (dtl_sv_to_bool(svStdoutEnabled) != false) )
+   {
+      apx_serverStats_enableStdout(instance);
+   }
+#if !defined(_WIN32) && !defined(UNIT_TEST)
+   if (svUnixFile != 0)
+   {
+      const char *unixFilePath = dtl_sv_to_cstr(svUnixFile);
+      if (strlen(unixFilePath) > 0)
+      {
+         apx_serverStats_startUnixServer(instance, unixFilePath);
+      }
+   }
+#endif
+   return APX_NO_ERROR;
+}
+
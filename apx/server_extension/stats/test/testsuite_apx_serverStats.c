@@ -0,0 +1,214 @@
+/*****************************************************************************
+* \file      testsuite_apx_serverStats.c
+* \author    Conny Gustafsson
+* \date      2026-10-18
+* \brief     Unit tests for apx_serverStats
+*
+* Copyright (c) 2026 Conny Gustafsson
+* Permission is hereby granted, free of charge, to any person obtaining a copy of
+* this software and associated documentation files (the "Software"), to deal in
+* the Software without restriction, including without limitation the rights to
+* use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+* the Software, and to permit persons to whom the Software is furnished to do so,
+* subject to the following conditions:
+
+* The above copyright notice and this permission notice shall be included in all
+* copies or substantial portions of the Software.
+
+* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+* IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+* FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+* COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+* IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+* CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+*
+******************************************************************************/
+//////////////////////////////////////////////////////////////////////////////
+// INCLUDES
+//////////////////////////////////////////////////////////////////////////////
+#include <stdio.h>
+#include <string.h>
+#include <malloc.h>
+#include <assert.h>
+#include "CuTest.h"
+#include "apx_server.h"
+#include "apx_serverTestConnection.h"
+#include "apx_serverStats.h"
+#include "apx_serverStatsExtension.h"
+#ifdef MEM_LEAK_CHECK
+#include "CMemLeak.h"
+#endif
+
+//////////////////////////////////////////////////////////////////////////////
+// PRIVATE CONSTANTS AND DATA TYPES
+//////////////////////////////////////////////////////////////////////////////
+
+//////////////////////////////////////////////////////////////////////////////
+// PRIVATE FUNCTION PROTOTYPES
+//////////////////////////////////////////////////////////////////////////////
+static void test_apx_serverStats_collectConnectionAndNodeCounters(CuTest* tc);
+static void test_apx_serverStats_jsonContainsRates(CuTest* tc);
+static void test_apx_serverStats_publishKeepsPreviousSnapshot(CuTest* tc);
+static void test_apx_serverStatsExtension_disabledByDefault(CuTest* tc);
+static apx_serverStatsConnection_t *create_connection_stats(uint32_t connectionId, uint32_t bytesReceived, uint32_t messagesReceived, const char *nodeName, uint32_t numSourceWrites);
+
+//////////////////////////////////////////////////////////////////////////////
+// PRIVATE VARIABLES
+//////////////////////////////////////////////////////////////////////////////
+static const char *m_apx_definition1 = "APX/1.2\n"
+      "N\"TestNode1\"\n"
+      "P\"VehicleSpeed\"S:=65535\n"
+      "\n";
+
+//////////////////////////////////////////////////////////////////////////////
+// PUBLIC FUNCTIONS
+//////////////////////////////////////////////////////////////////////////////
+CuSuite* testSuite_apx_serverStats(void)
+{
+   CuSuite* suite = CuSuiteNew();
+   SUITE_ADD_TEST(suite, test_apx_serverStats_collectConnectionAndNodeCounters);
+   SUITE_ADD_TEST(suite, test_apx_serverStats_jsonContainsRates);
+   SUITE_ADD_TEST(suite, test_apx_serverStats_publishKeepsPreviousSnapshot);
+   SUITE_ADD_TEST(suite, test_apx_serverStatsExtension_disabledByDefault);
+   return suite;
+}
+
+//////////////////////////////////////////////////////////////////////////////
+// PRIVATE FUNCTIONS
+//////////////////////////////////////////////////////////////////////////////
+static void test_apx_serverStats_collectConnectionAndNodeCounters(CuTest* tc)
+{
+   apx_server_t *server;
+   apx_serverTestConnection_t *connection;
+   apx_serverStatsSnapshot_t snapshot;
+   apx_serverStatsConnection_t *connectionStats;
+   apx_serverStatsNode_t *nodeStats;
+   rmf_fileInfo_t fileInfo;
+   apx_size_t definitionLen;
+   uint8_t *buffer;
+
+   server = apx_server_new();
+   connection = apx_serverTestConnection_new();
+   apx_server_acceptConnection(server, (apx_serverConnectionBase_t*) connection);
+   apx_serverTestConnection_onProtocolHeaderReceived(connection);
+   apx_serverTestConnection_runEventLoop(connection);
+
+   definitionLen = strlen(m_apx_definition1);
+   rmf_fileInfo_create(&fileInfo, "TestNode1.apx", APX_ADDRESS_DEFINITION_START, definitionLen, RMF_FILE_TYPE_FIXED);
+   apx_serverTestConnection_onFileInfoMsgReceived(connection, &fileInfo);
+   apx_serverTestConnection_runEventLoop(connection);
+   buffer = (uint8_t*) malloc(RMF_HIGH_ADDRESS_SIZE+definitionLen);
+   assert(buffer != 0);
+   CuAssertIntEquals(tc, RMF_HIGH_ADDRESS_SIZE, rmf_packHeader(&buffer[0], RMF_HIGH_ADDRESS_SIZE, APX_ADDRESS_DEFINITION_START, false));
+   memcpy(&buffer[RMF_HIGH_ADDRESS_SIZE], &m_apx_definition1[0], definitionLen);
+   CuAssertIntEquals(tc, APX_NO_ERROR, apx_serverTestConnection_onSerializedMsgReceived(connection, buffer, RMF_HIGH_ADDRESS_SIZE+definitionLen));
+   apx_serverTestConnection_runEventLoop(connection);
+
+   apx_serverStatsSnapshot_create(&snapshot);
+   CuAssertIntEquals(tc, APX_NO_ERROR, apx_serverStatsSnapshot_collect(&snapshot, server));
+   CuAssertTrue(tc, snapshot.timestampUs > 0u);
+   CuAssertIntEquals(tc, 1, adt_ary_length(&snapshot.connections));
+   connectionStats = (apx_serverStatsConnection_t*) adt_ary_value(&snapshot.connections, 0);
+   CuAssertUIntEquals(tc, apx_connectionBase_getConnectionId(&connection->base.base), connectionStats->stats.connectionId);
+   CuAssertUIntEquals(tc, 1u, connectionStats->stats.totalMessagesReceived);
+   CuAssertIntEquals(tc, 1, connectionStats->stats.numNodes);
+   CuAssertIntEquals(tc, 1, adt_ary_length(&connectionStats->nodes));
+   nodeStats = (apx_serverStatsNode_t*) adt_ary_value(&connectionStats->nodes, 0);
+   CuAssertStrEquals(tc, "TestNode1", nodeStats->name);
+   CuAssertUIntEquals(tc, 0u, nodeStats->routingStats.numSourceWrites);
+
+   apx_serverStatsSnapshot_destroy(&snapshot);
+   free(buffer);
+   apx_server_delete(server);
+}
+
+static void test_apx_serverStats_jsonContainsRates(CuTest* tc)
+{
+   apx_serverStatsSnapshot_t previous;
+   apx_serverStatsSnapshot_t current;
+   adt_str_t *json;
+   const char *cstr;
+
+   apx_serverStatsSnapshot_create(&previous);
+   apx_serverStatsSnapshot_create(&current);
+   previous.timestampUs = 1000000u;
+   current.timestampUs = 3000000u; //two seconds later
+   adt_ary_push(&previous.connections, create_connection_stats(7u, 1000u, 10u, "Provider", 20u));
+   adt_ary_push(&current.connections, create_connection_stats(7u, 5000u, 50u, "Provider", 220u));
+
+   //First snapshot has nothing to compare with
+   json = adt_str_new();
+   CuAssertIntEquals(tc, APX_NO_ERROR, apx_serverStatsSnapshot_toJson(&previous, NULL, json));
+   cstr = adt_str_cstr(json);
+   CuAssertPtrNotNull(tc, strstr(cstr, "\"numConnections\":1"));
+   CuAssertPtrNotNull(tc, strstr(cstr, "\"id\":7,\"rxBytes\":1000,\"rxMessages\":10,\"rxBytesPerSec\":0,\"rxMessagesPerSec\":0"));
+   adt_str_delete(json);
+
+   json = adt_str_new();
+   CuAssertIntEquals(tc, APX_NO_ERROR, apx_serverStatsSnapshot_toJson(&current, &previous, json));
+   cstr = adt_str_cstr(json);
+   CuAssertPtrNotNull(tc, strstr(cstr, "{\"timestampUs\":3000000,\"intervalUs\":2000000,"));
+   CuAssertPtrNotNull(tc, strstr(cstr, "\"rxBytes\":5000,\"rxMessages\":50,\"rxBytesPerSec\":2000,\"rxMessagesPerSec\":20"));
+   CuAssertPtrNotNull(tc, strstr(cstr, "\"nodes\":[{\"name\":\"Provider\",\"writes\":220,"));
+   CuAssertPtrNotNull(tc, strstr(cstr, "\"writesPerSec\":100,"));
+   CuAssertTrue(tc, cstr[strlen(cstr)-1] == '}');
+   adt_str_delete(json);
+
+   apx_serverStatsSnapshot_destroy(&previous);
+   apx_serverStatsSnapshot_destroy(&current);
+}
+
+static void test_apx_serverStats_publishKeepsPreviousSnapshot(CuTest* tc)
+{
+   apx_server_t *server;
+   apx_serverStats_t *stats;
+   apx_serverStatsSnapshot_t *first;
+
+   server = apx_server_new();
+   stats = apx_serverStats_new(server);
+   CuAssertPtrNotNull(tc, stats);
+   CuAssertPtrEquals(tc, NULL, stats->previous);
+   CuAssertIntEquals(tc, APX_NO_ERROR, apx_serverStats_publish(stats));
+   first = stats->previous;
+   CuAssertPtrNotNull(tc, first);
+   CuAssertIntEquals(tc, 0, adt_ary_length(&first->connections));
+   CuAssertIntEquals(tc, APX_NO_ERROR, apx_serverStats_publish(stats));
+   CuAssertPtrNotNull(tc, stats->previous);
+   CuAssertTrue(tc, stats->previous->timestampUs >= first->timestampUs);
+   apx_serverStats_setInterval(stats, 10u);
+   CuAssertUIntEquals(tc, APX_SERVER_STATS_MIN_INTERVAL_MS, stats->intervalMs);
+
+   apx_serverStats_delete(stats);
+   apx_server_delete(server);
+}
+
+static void test_apx_serverStatsExtension_disabledByDefault(CuTest* tc)
+{
+   apx_server_t apx_server;
+   apx_server_create(&apx_server);
+   CuAssertIntEquals(tc, APX_NO_ERROR, apx_serverStatsExtension_register(&apx_server, (dtl_dv_t*) 0));
+   apx_server_start(&apx_server);
+   apx_server_run(&apx_server);
+   apx_server_destroy(&apx_server);
+}
+
+static apx_serverStatsConnection_t *create_connection_stats(uint32_t connectionId, uint32_t bytesReceived, uint32_t messagesReceived, const char *nodeName, uint32_t numSourceWrites)
+{
+   apx_serverStatsConnection_t *connection = (apx_serverStatsConnection_t*) malloc(sizeof(apx_serverStatsConnection_t));
+   apx_serverStatsNode_t *node = (apx_serverStatsNode_t*) malloc(sizeof(apx_serverStatsNode_t));
+   assert( (connection != 0) && (node != 0) );
+   memset(connection, 0, sizeof(apx_serverStatsConnection_t));
+   memset(node, 0, sizeof(apx_serverStatsNode_t));
+   adt_ary_create(&connection->nodes, apx_serverStatsNode_vdelete);
+   connection->stats.connectionId = connectionId;
+   connection->stats.totalBytesReceived = bytesReceived;
+   connection->stats.totalMessagesReceived = messagesReceived;
+   connection->stats.numNodes = 1;
+   node->name = (char*) malloc(strlen(nodeName)+1);
+   assert(node->name != 0);
+   strcpy(node->name, nodeName);
+   node->routingStats.numSourceWrites = numSourceWrites;
+   adt_ary_push(&connection->nodes, node);
+   return connection;
+}
+
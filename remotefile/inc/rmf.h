@@ -46,8 +46,12 @@
 #define RMF_CMD_FILE_OPEN_LEN (RMF_CMD_TYPE_LEN+RMF_CMD_ADDRESS_LEN)
 #define RMF_CMD_ACK_LEN RMF_CMD_TYPE_LEN
 #define RMF_ERROR_INVALID_READ_HANDLER_LEN (RMF_CMD_TYPE_LEN+RMF_CMD_ADDRESS_LEN)
-#define RMF_CMD_FILE_COMPRESS_INFO_LEN (RMF_CMD_TYPE_LEN+4)
+#define RMF_CMD_FILE_COMPRESS_INFO_LEN (RMF_CMD_TYPE_LEN+RMF_CMD_ADDRESS_LEN+2+2+4) //16 bytes total
 #define RMF_ERROR_CODE_BASE_LEN (RMF_CMD_TYPE_LEN+4)
+#define RMF_CMD_HEARTBEAT_LEN RMF_CMD_TYPE_LEN
+#define RMF_CMD_PING_SEQUENCE_LEN 4u
+#define RMF_CMD_PING_TIMESTAMP_LEN 8u
+#define RMF_CMD_PING_LEN (RMF_CMD_TYPE_LEN+RMF_CMD_PING_SEQUENCE_LEN+RMF_CMD_PING_TIMESTAMP_LEN)
 
 #define RMF_CMD_ACK                    (uint32_t) 0u  //command successful
 #define RMF_CMD_NACK                   (uint32_t) 1u  //negative response
@@ -89,6 +93,12 @@
 #define RMF_GREETING_MAX_LEN 127
 #define RMF_GREETING_START "RMFP/1.0\n"
 #define RMF_NUMHEADER_FORMAT_HDR "NumHeader-Format:"
+#define RMF_COMPRESSION_HDR "Compression:"
+#define RMF_FRAGMENT_INTERLEAVE_HDR "Fragment-Interleave:" //value 1 means the sender accepts complete writes arriving in between the fragments of a larger write
+
+#define RMF_COMPRESSION_NONE           0u
+#define RMF_COMPRESSION_LZ4            1u //LZ4 block format (single block, no frame header)
+#define RMF_COMPRESSION_LZ4_NAME       "lz4"
 
 
 
@@ -113,6 +123,27 @@ typedef struct rmf_cmdCloseFile_tag
    uint32_t address;
 } rmf_cmdCloseFile_t;
 
+/**
+ * Payload of RMF_CMD_PING_RQST and RMF_CMD_PING_RSP.
+ * The timestamp is taken by the requester (microseconds, requester's own monotonic clock) and is echoed back unmodified in the response.
+ */
+typedef struct rmf_cmdPing_tag
+{
+   uint32_t sequence;
+   uint64_t timestamp;
+} rmf_cmdPing_t;
+
+/**
+ * Payload of RMF_CMD_COMPRESS_INFO. Sent directly after the RMF_CMD_FILE_INFO of a RMF_FILE_TYPE_COMPRESSED_FIXED file.
+ * The length attribute of the file info is the compressed length.
+ */
+typedef struct rmf_cmdCompressInfo_tag
+{
+   uint32_t address;
+   uint16_t compressionType;
+   uint32_t uncompressedLength;
+} rmf_cmdCompressInfo_t;
+
 typedef struct rmf_fileInfo_tag
 {
    uint32_t address;
@@ -146,6 +177,11 @@ int32_t rmf_serialize_cmdCloseFile(uint8_t *buf, int32_t bufLen, rmf_cmdCloseFil
 int32_t rmf_deserialize_cmdCloseFile(const uint8_t *buf, int32_t bufLen, rmf_cmdCloseFile_t *cmdCloseFile);
 int32_t rmf_deserialize_cmdType(const uint8_t *buf, int32_t bufLen, uint32_t *cmdType);
 int32_t rmf_serialize_acknowledge(uint8_t *buf, int32_t bufLen);
+int32_t rmf_serialize_cmdHeartbeat(uint8_t *buf, int32_t bufLen, uint32_t cmdType);
+int32_t rmf_serialize_cmdPing(uint8_t *buf, int32_t bufLen, uint32_t cmdType, const rmf_cmdPing_t *cmdPing);
+int32_t rmf_deserialize_cmdPing(const uint8_t *buf, int32_t bufLen, rmf_cmdPing_t *cmdPing);
+int32_t rmf_serialize_cmdCompressInfo(uint8_t *buf, int32_t bufLen, const rmf_cmdCompressInfo_t *cmdCompressInfo);
+int32_t rmf_deserialize_cmdCompressInfo(const uint8_t *buf, int32_t bufLen, rmf_cmdCompressInfo_t *cmdCompressInfo);
 
 /* rmf_fileInfo_t API */
 int8_t rmf_fileInfo_create(rmf_fileInfo_t *self, const char *name, uint32_t startAddress, uint32_t length, uint16_t fileType);
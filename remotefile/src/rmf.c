@@ -455,6 +455,132 @@ int32_t rmf_serialize_acknowledge(uint8_t *buf, int32_t bufLen)
      return -1;
 }
 
+/**
+ * cmdType must be RMF_CMD_HEARTBEAT_RQST or RMF_CMD_HEARTBEAT_RSP.
+ * On failure: returns 0 if buffer is too small, -1 on any other error
+ * On success: returns number of bytes written to buffer
+ */
+int32_t rmf_serialize_cmdHeartbeat(uint8_t *buf, int32_t bufLen, uint32_t cmdType)
+{
+   if ( (buf != 0) && ( (cmdType == RMF_CMD_HEARTBEAT_RQST) || (cmdType == RMF_CMD_HEARTBEAT_RSP) ) )
+   {
+      if ((uint32_t) bufLen < RMF_CMD_HEARTBEAT_LEN )
+      {
+         return 0; //buffer too small
+      }
+      packLE(buf, cmdType, (uint8_t) RMF_CMD_TYPE_LEN);
+      return RMF_CMD_HEARTBEAT_LEN;
+   }
+   return -1;
+}
+
+/**
+ * cmdType must be RMF_CMD_PING_RQST or RMF_CMD_PING_RSP. The 64-bit timestamp is packed as two little-endian 32-bit words, low word first.
+ * On failure: returns 0 if buffer is too small, -1 on any other error
+ * On success: returns number of bytes written to buffer
+ */
+int32_t rmf_serialize_cmdPing(uint8_t *buf, int32_t bufLen, uint32_t cmdType, const rmf_cmdPing_t *cmdPing)
+{
+   if ( (buf != 0) && (cmdPing != 0) && ( (cmdType == RMF_CMD_PING_RQST) || (cmdType == RMF_CMD_PING_RSP) ) )
+   {
+      uint8_t *p = buf;
+      if ((uint32_t) bufLen < RMF_CMD_PING_LEN )
+      {
+         return 0; //buffer too small
+      }
+      packLE(p, cmdType, (uint8_t) RMF_CMD_TYPE_LEN);
+      p+=RMF_CMD_TYPE_LEN;
+      packLE(p, cmdPing->sequence, (uint8_t) RMF_CMD_PING_SEQUENCE_LEN);
+      p+=RMF_CMD_PING_SEQUENCE_LEN;
+      packLE(p, (uint32_t) (cmdPing->timestamp & 0xFFFFFFFFu), (uint8_t) sizeof(uint32_t));
+      p+=sizeof(uint32_t);
+      packLE(p, (uint32_t) (cmdPing->timestamp >> 32), (uint8_t) sizeof(uint32_t));
+      return RMF_CMD_PING_LEN;
+   }
+   return -1;
+}
+
+/**
+ * Parses a ping request or response. buf points to the byte following cmdType.
+ * On failure: returns 0 if buffer is too small, -1 on any other error
+ * On success: returns number of bytes parsed from buffer
+ */
+int32_t rmf_deserialize_cmdPing(const uint8_t *buf, int32_t bufLen, rmf_cmdPing_t *cmdPing)
+{
+   if ( (buf != 0) && (cmdPing != 0) )
+   {
+      const uint8_t *p = buf;
+      uint32_t totalLen = RMF_CMD_PING_SEQUENCE_LEN + RMF_CMD_PING_TIMESTAMP_LEN;
+      uint32_t timestampLow;
+      uint32_t timestampHigh;
+      if ((uint32_t) bufLen < totalLen )
+      {
+         return 0; //buffer too small
+      }
+      cmdPing->sequence = unpackLE(p, (uint8_t) RMF_CMD_PING_SEQUENCE_LEN);
+      p+=RMF_CMD_PING_SEQUENCE_LEN;
+      timestampLow = unpackLE(p, (uint8_t) sizeof(uint32_t));
+      p+=sizeof(uint32_t);
+      timestampHigh = unpackLE(p, (uint8_t) sizeof(uint32_t));
+      cmdPing->timestamp = ( (uint64_t) timestampHigh << 32) | (uint64_t) timestampLow;
+      return (int32_t) totalLen;
+   }
+   return -1;
+}
+
+/**
+ * Serializes RMF_CMD_COMPRESS_INFO (including its cmdType).
+ * On failure: returns 0 if buffer is too small, -1 on any other error
+ * On success: returns number of bytes written to buffer
+ */
+int32_t rmf_serialize_cmdCompressInfo(uint8_t *buf, int32_t bufLen, const rmf_cmdCompressInfo_t *cmdCompressInfo)
+{
+   if ( (buf != 0) && (cmdCompressInfo != 0) )
+   {
+      uint8_t *p = buf;
+      if ((uint32_t) bufLen < RMF_CMD_FILE_COMPRESS_INFO_LEN )
+      {
+         return 0; //buffer too small
+      }
+      packLE(p, RMF_CMD_COMPRESS_INFO, (uint8_t) RMF_CMD_TYPE_LEN);
+      p+=RMF_CMD_TYPE_LEN;
+      packLE(p, cmdCompressInfo->address, (uint8_t) RMF_CMD_ADDRESS_LEN);
+      p+=RMF_CMD_ADDRESS_LEN;
+      packLE(p, cmdCompressInfo->compressionType, (uint8_t) sizeof(uint16_t));
+      p+=sizeof(uint16_t);
+      packLE(p, 0u, (uint8_t) sizeof(uint16_t)); //reserved
+      p+=sizeof(uint16_t);
+      packLE(p, cmdCompressInfo->uncompressedLength, (uint8_t) sizeof(uint32_t));
+      return RMF_CMD_FILE_COMPRESS_INFO_LEN;
+   }
+   return -1;
+}
+
+/**
+ * Parses RMF_CMD_COMPRESS_INFO. buf points to the byte following cmdType.
+ * On failure: returns 0 if buffer is too small, -1 on any other error
+ * On success: returns number of bytes parsed from buffer
+ */
+int32_t rmf_deserialize_cmdCompressInfo(const uint8_t *buf, int32_t bufLen, rmf_cmdCompressInfo_t *cmdCompressInfo)
+{
+   if ( (buf != 0) && (cmdCompressInfo != 0) )
+   {
+      const uint8_t *p = buf;
+      uint32_t totalLen = RMF_CMD_FILE_COMPRESS_INFO_LEN - RMF_CMD_TYPE_LEN;
+      if ((uint32_t) bufLen < totalLen )
+      {
+         return 0; //buffer too small
+      }
+      cmdCompressInfo->address = unpackLE(p, (uint8_t) RMF_CMD_ADDRESS_LEN);
+      p+=RMF_CMD_ADDRESS_LEN;
+      cmdCompressInfo->compressionType = (uint16_t) unpackLE(p, (uint8_t) sizeof(uint16_t));
+      p+=sizeof(uint16_t)*2u; //skip reserved field
+      cmdCompressInfo->uncompressedLength = unpackLE(p, (uint8_t) sizeof(uint32_t));
+      return (int32_t) totalLen;
+   }
+   return -1;
+}
+
 //////////////////////////////////////////////////////////////////////////////
 // LOCAL FUNCTIONS
 //////////////////////////////////////////////////////////////////////////////
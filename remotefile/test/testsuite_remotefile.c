@@ -24,6 +24,9 @@
 static void test_rmf_cmdFileInfo_serialize(CuTest* tc);
 static void test_rmf_cmdOpenFile_serialize(CuTest* tc);
 static void test_rmf_cmdCloseFile_serialize(CuTest* tc);
+static void test_rmf_cmdPing_serialize(CuTest* tc);
+static void test_rmf_cmdHeartbeat_serialize(CuTest* tc);
+static void test_rmf_cmdCompressInfo_serialize(CuTest* tc);
 
 //////////////////////////////////////////////////////////////////////////////
 // GLOBAL VARIABLES
@@ -46,6 +49,9 @@ CuSuite* testSuite_remotefile(void)
    SUITE_ADD_TEST(suite, test_rmf_cmdFileInfo_serialize);
    SUITE_ADD_TEST(suite, test_rmf_cmdOpenFile_serialize);
    SUITE_ADD_TEST(suite, test_rmf_cmdCloseFile_serialize);
+   SUITE_ADD_TEST(suite, test_rmf_cmdPing_serialize);
+   SUITE_ADD_TEST(suite, test_rmf_cmdHeartbeat_serialize);
+   SUITE_ADD_TEST(suite, test_rmf_cmdCompressInfo_serialize);
 
    return suite;
 }
@@ -129,3 +135,75 @@ static void test_rmf_cmdCloseFile_serialize(CuTest* tc)
    CuAssertIntEquals(tc, RMF_CMD_ADDRESS_LEN, result);
    CuAssertUIntEquals(tc, cmd.address, cmd2.address);
 }
+
+static void test_rmf_cmdPing_serialize(CuTest* tc)
+{
+   uint8_t buf[RMF_MAX_CMD_BUF_SIZE];
+   uint8_t *p;
+   int32_t bufLen = (int32_t) sizeof(buf);
+   rmf_cmdPing_t cmd;
+   rmf_cmdPing_t cmd2;
+   int32_t result;
+   cmd.sequence = 1234u;
+   cmd.timestamp = 0x0123456789ABCDEFull;
+
+   result = rmf_serialize_cmdPing(buf, bufLen, RMF_CMD_PING_RQST, &cmd);
+   CuAssertIntEquals(tc, RMF_CMD_PING_LEN, result);
+   p=buf;
+   CuAssertUIntEquals(tc, RMF_CMD_PING_RQST, unpackLE(p,4)); p+=4;
+   CuAssertUIntEquals(tc, cmd.sequence, unpackLE(p,4)); p+=4;
+   CuAssertUIntEquals(tc, 0x89ABCDEFu, unpackLE(p,4)); p+=4;
+   CuAssertUIntEquals(tc, 0x01234567u, unpackLE(p,4)); p+=4;
+   result = rmf_deserialize_cmdPing(buf + RMF_CMD_TYPE_LEN, result - RMF_CMD_TYPE_LEN, &cmd2);
+   CuAssertIntEquals(tc, RMF_CMD_PING_LEN - RMF_CMD_TYPE_LEN, result);
+   CuAssertUIntEquals(tc, cmd.sequence, cmd2.sequence);
+   CuAssertTrue(tc, cmd.timestamp == cmd2.timestamp);
+
+   CuAssertIntEquals(tc, RMF_CMD_PING_LEN, rmf_serialize_cmdPing(buf, bufLen, RMF_CMD_PING_RSP, &cmd));
+   CuAssertUIntEquals(tc, RMF_CMD_PING_RSP, unpackLE(buf,4));
+   CuAssertIntEquals(tc, 0, rmf_serialize_cmdPing(buf, RMF_CMD_PING_LEN - 1, RMF_CMD_PING_RQST, &cmd));
+   CuAssertIntEquals(tc, -1, rmf_serialize_cmdPing(buf, bufLen, RMF_CMD_FILE_OPEN, &cmd));
+   CuAssertIntEquals(tc, 0, rmf_deserialize_cmdPing(buf + RMF_CMD_TYPE_LEN, RMF_CMD_PING_LEN - RMF_CMD_TYPE_LEN - 1, &cmd2));
+}
+
+static void test_rmf_cmdHeartbeat_serialize(CuTest* tc)
+{
+   uint8_t buf[RMF_MAX_CMD_BUF_SIZE];
+   int32_t bufLen = (int32_t) sizeof(buf);
+   CuAssertIntEquals(tc, RMF_CMD_HEARTBEAT_LEN, rmf_serialize_cmdHeartbeat(buf, bufLen, RMF_CMD_HEARTBEAT_RQST));
+   CuAssertUIntEquals(tc, RMF_CMD_HEARTBEAT_RQST, unpackLE(buf,4));
+   CuAssertIntEquals(tc, RMF_CMD_HEARTBEAT_LEN, rmf_serialize_cmdHeartbeat(buf, bufLen, RMF_CMD_HEARTBEAT_RSP));
+   CuAssertUIntEquals(tc, RMF_CMD_HEARTBEAT_RSP, unpackLE(buf,4));
+   CuAssertIntEquals(tc, 0, rmf_serialize_cmdHeartbeat(buf, RMF_CMD_HEARTBEAT_LEN - 1, RMF_CMD_HEARTBEAT_RQST));
+   CuAssertIntEquals(tc, -1, rmf_serialize_cmdHeartbeat(buf, bufLen, RMF_CMD_PING_RQST));
+}
+
+static void test_rmf_cmdCompressInfo_serialize(CuTest* tc)
+{
+   uint8_t buf[RMF_MAX_CMD_BUF_SIZE];
+   uint8_t *p;
+   int32_t bufLen = (int32_t) sizeof(buf);
+   rmf_cmdCompressInfo_t cmd;
+   rmf_cmdCompressInfo_t cmd2;
+   int32_t result;
+   cmd.address = 0x4000000u;
+   cmd.compressionType = RMF_COMPRESSION_LZ4;
+   cmd.uncompressedLength = 123456u;
+
+   result = rmf_serialize_cmdCompressInfo(buf, bufLen, &cmd);
+   CuAssertIntEquals(tc, RMF_CMD_FILE_COMPRESS_INFO_LEN, result);
+   p=buf;
+   CuAssertUIntEquals(tc, RMF_CMD_COMPRESS_INFO, unpackLE(p,4)); p+=4;
+   CuAssertUIntEquals(tc, cmd.address, unpackLE(p,4)); p+=4;
+   CuAssertUIntEquals(tc, RMF_COMPRESSION_LZ4, unpackLE(p,2)); p+=2;
+   CuAssertUIntEquals(tc, 0u, unpackLE(p,2)); p+=2;
+   CuAssertUIntEquals(tc, cmd.uncompressedLength, unpackLE(p,4)); p+=4;
+   result = rmf_deserialize_cmdCompressInfo(buf + RMF_CMD_TYPE_LEN, result - RMF_CMD_TYPE_LEN, &cmd2);
+   CuAssertIntEquals(tc, RMF_CMD_FILE_COMPRESS_INFO_LEN - RMF_CMD_TYPE_LEN, result);
+   CuAssertUIntEquals(tc, cmd.address, cmd2.address);
+   CuAssertUIntEquals(tc, cmd.compressionType, cmd2.compressionType);
+   CuAssertUIntEquals(tc, cmd.uncompressedLength, cmd2.uncompressedLength);
+
+   CuAssertIntEquals(tc, 0, rmf_serialize_cmdCompressInfo(buf, RMF_CMD_FILE_COMPRESS_INFO_LEN - 1, &cmd));
+   CuAssertIntEquals(tc, 0, rmf_deserialize_cmdCompressInfo(buf + RMF_CMD_TYPE_LEN, RMF_CMD_FILE_COMPRESS_INFO_LEN - RMF_CMD_TYPE_LEN - 1, &cmd2));
+}